@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLEBENCHCENT_
+#define H_BLEBENCHCENT_
+
+#include "log/log.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct log blebench_log;
+
+/* blebenchcent uses the first "peruser" log module. */
+#define BLEBENCH_LOG_MODULE  (LOG_MODULE_PERUSER + 0)
+
+/* Convenience macro for logging to the blebench module. */
+#define BLEBENCH_LOG(lvl, ...) \
+    LOG_ ## lvl(&blebench_log, BLEBENCH_LOG_MODULE, __VA_ARGS__)
+
+/* Device name the streamer advertises; keep in sync with blebenchprph. */
+#define BLEBENCH_DEVICE_NAME        "nimble-blebench"
+
+/* Notification payload header: sequence number + tx cputime timestamp. */
+#define BLEBENCH_PKT_HDR_LEN        8
+
+/* Power-of-two latency histogram; bucket i counts samples in
+ * [2^i, 2^(i+1)) microseconds, with the last bucket open-ended.
+ */
+#define BLEBENCH_HIST_BUCKETS       18
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,628 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "bsp/bsp.h"
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "console/console.h"
+
+/* BLE */
+#include "nimble/ble.h"
+#include "host/ble_hs.h"
+#include "services/gap/ble_svc_gap.h"
+
+/* Application-specified header. */
+#include "blebenchcent.h"
+
+/** Log data. */
+struct log blebench_log;
+
+/** blebenchcent task settings. */
+#define BLEBENCH_TASK_PRIO          1
+#define BLEBENCH_STACK_SIZE         (OS_STACK_ALIGN(336))
+
+struct os_eventq blebench_evq;
+struct os_task blebench_task;
+bssnz_t os_stack_t blebench_stack[BLEBENCH_STACK_SIZE];
+
+/** Our global device address (public) */
+uint8_t g_dev_addr[BLE_DEV_ADDR_LEN] = {0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d};
+
+/** Our random address (in case we need it) */
+uint8_t g_random_addr[BLE_DEV_ADDR_LEN];
+
+/* ab4b1e10-37a8-43d6-9a87-0cc526d46b28 */
+static const uint8_t blebench_svc_uuid[16] = {
+    0x28, 0x6b, 0xd4, 0x26, 0xc5, 0x0c, 0x87, 0x9a,
+    0xd6, 0x43, 0xa8, 0x37, 0x10, 0x1e, 0x4b, 0xab
+};
+
+/* ab4b1e11-37a8-43d6-9a87-0cc526d46b28 */
+static const uint8_t blebench_chr_stream_uuid[16] = {
+    0x28, 0x6b, 0xd4, 0x26, 0xc5, 0x0c, 0x87, 0x9a,
+    0xd6, 0x43, 0xa8, 0x37, 0x11, 0x1e, 0x4b, 0xab
+};
+
+/** Discovered handles on the streamer. */
+static uint16_t blebench_conn_handle = BLE_HS_CONN_HANDLE_NONE;
+static uint16_t blebench_svc_start_handle;
+static uint16_t blebench_svc_end_handle;
+static uint16_t blebench_chr_val_handle;
+static uint16_t blebench_cccd_handle;
+
+/** Benchmark state; reset when the subscription write completes. */
+static uint32_t blebench_rx_pkts;
+static uint32_t blebench_rx_bytes;
+static uint32_t blebench_rx_bytes_prev;
+static uint32_t blebench_gap_pkts;
+static uint32_t blebench_next_seq;
+static uint32_t blebench_last_rx_time;
+static uint8_t blebench_last_rx_valid;
+static int blebench_msys_min;
+static uint32_t blebench_itvl_hist[BLEBENCH_HIST_BUCKETS];
+
+static struct os_callout blebench_report_co;
+
+static int blebench_gap_event(struct ble_gap_event *event, void *arg);
+
+/**
+ * Adds a sample to a power-of-two latency histogram; bucket i counts
+ * samples in [2^i, 2^(i+1)) microseconds.
+ */
+static void
+blebench_hist_add(uint32_t *hist, uint32_t usecs)
+{
+    int i;
+
+    for (i = 0;
+         i < BLEBENCH_HIST_BUCKETS - 1 && usecs >= (1UL << (i + 1));
+         i++) {
+    }
+    hist[i]++;
+}
+
+static void
+blebench_hist_print(const char *type, const uint32_t *hist)
+{
+    int i;
+
+    console_printf("bench-hist: role=cent type=%s unit=log2us counts=", type);
+    for (i = 0; i < BLEBENCH_HIST_BUCKETS; i++) {
+        console_printf("%s%lu", i == 0 ? "" : ",", (unsigned long)hist[i]);
+    }
+    console_printf("\n");
+}
+
+static void
+blebench_stats_reset(void)
+{
+    blebench_rx_pkts = 0;
+    blebench_rx_bytes = 0;
+    blebench_rx_bytes_prev = 0;
+    blebench_gap_pkts = 0;
+    blebench_next_seq = 0;
+    blebench_last_rx_valid = 0;
+    blebench_msys_min = os_msys_num_free();
+    memset(blebench_itvl_hist, 0, sizeof blebench_itvl_hist);
+}
+
+/**
+ * Emits one machine-readable statistics record per report interval.
+ * Goodput is computed over the bytes received since the previous report.
+ */
+static void
+blebench_report_ev(struct os_event *ev)
+{
+    struct ble_gap_conn_desc desc;
+    uint32_t goodput_bps;
+    uint16_t conn_itvl;
+    uint16_t mtu;
+    int rc;
+
+    if (blebench_conn_handle != BLE_HS_CONN_HANDLE_NONE) {
+        mtu = ble_att_mtu(blebench_conn_handle);
+        rc = ble_gap_conn_find(blebench_conn_handle, &desc);
+        conn_itvl = rc == 0 ? desc.conn_itvl : 0;
+    } else {
+        mtu = 0;
+        conn_itvl = 0;
+    }
+
+    goodput_bps = (blebench_rx_bytes - blebench_rx_bytes_prev) * 8 /
+                  MYNEWT_VAL(BLEBENCH_REPORT_ITVL_SECS);
+    blebench_rx_bytes_prev = blebench_rx_bytes;
+
+    console_printf("bench: role=cent t=%lu mtu=%u itvl=%u rx_pkts=%lu "
+                   "rx_bytes=%lu goodput_bps=%lu gap_pkts=%lu msys_min=%d\n",
+                   (unsigned long)(os_time_get() / OS_TICKS_PER_SEC),
+                   mtu, conn_itvl,
+                   (unsigned long)blebench_rx_pkts,
+                   (unsigned long)blebench_rx_bytes,
+                   (unsigned long)goodput_bps,
+                   (unsigned long)blebench_gap_pkts,
+                   blebench_msys_min);
+    blebench_hist_print("interarrival", blebench_itvl_hist);
+
+    os_callout_reset(&blebench_report_co,
+                     MYNEWT_VAL(BLEBENCH_REPORT_ITVL_SECS) *
+                     OS_TICKS_PER_SEC);
+}
+
+/**
+ * Accounts for one received stream notification: goodput bytes, sequence
+ * gaps, and the packet inter-arrival time histogram.  The tx timestamp in
+ * the payload is only meaningful when both sides share a clock (e.g. two
+ * sim processes); inter-arrival jitter is the portable latency signal, so
+ * that is what gets binned here.
+ */
+static void
+blebench_rx(struct os_mbuf *om)
+{
+    uint8_t hdr[BLEBENCH_PKT_HDR_LEN];
+    uint32_t now;
+    uint32_t seq;
+    uint16_t pktlen;
+    int msys;
+    int rc;
+
+    pktlen = OS_MBUF_PKTLEN(om);
+    blebench_rx_pkts++;
+    blebench_rx_bytes += pktlen;
+
+    rc = os_mbuf_copydata(om, 0, sizeof hdr, hdr);
+    if (rc == 0) {
+        seq = le32toh(hdr);
+        if (seq > blebench_next_seq) {
+            blebench_gap_pkts += seq - blebench_next_seq;
+        }
+        blebench_next_seq = seq + 1;
+    }
+
+    now = os_cputime_get32();
+    if (blebench_last_rx_valid) {
+        blebench_hist_add(blebench_itvl_hist,
+                          os_cputime_ticks_to_usecs(now -
+                                                    blebench_last_rx_time));
+    }
+    blebench_last_rx_time = now;
+    blebench_last_rx_valid = 1;
+
+    msys = os_msys_num_free();
+    if (msys < blebench_msys_min) {
+        blebench_msys_min = msys;
+    }
+}
+
+/**
+ * Application callback.  Called when the CCCD write enabling notifications
+ * has completed; the streamer starts pumping as soon as this lands.
+ */
+static int
+blebench_on_subscribe(uint16_t conn_handle,
+                      const struct ble_gatt_error *error,
+                      struct ble_gatt_attr *attr, void *arg)
+{
+    BLEBENCH_LOG(INFO, "subscribe complete; status=%d\n", error->status);
+    if (error->status != 0) {
+        ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+        return 0;
+    }
+
+    blebench_stats_reset();
+    return 0;
+}
+
+static void
+blebench_subscribe(void)
+{
+    uint8_t value[2];
+    int rc;
+
+    /* A central enables notifications by writing two bytes (1, 0) to the
+     * characteristic's client-characteristic-configuration-descriptor.
+     */
+    value[0] = 1;
+    value[1] = 0;
+    rc = ble_gattc_write_flat(blebench_conn_handle, blebench_cccd_handle,
+                              value, sizeof value, blebench_on_subscribe,
+                              NULL);
+    if (rc != 0) {
+        BLEBENCH_LOG(ERROR, "Error: Failed to subscribe; rc=%d\n", rc);
+        ble_gap_terminate(blebench_conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+    }
+}
+
+static int
+blebench_on_disc_dsc(uint16_t conn_handle, const struct ble_gatt_error *error,
+                     uint16_t chr_def_handle, const struct ble_gatt_dsc *dsc,
+                     void *arg)
+{
+    switch (error->status) {
+    case 0:
+        if (ble_uuid_128_to_16(dsc->uuid128) == BLE_GATT_DSC_CLT_CFG_UUID16) {
+            blebench_cccd_handle = dsc->handle;
+        }
+        return 0;
+
+    case BLE_HS_EDONE:
+        if (blebench_cccd_handle == 0) {
+            BLEBENCH_LOG(ERROR, "Error: Streamer lacks a CCCD\n");
+            ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+            return 0;
+        }
+        blebench_subscribe();
+        return 0;
+
+    default:
+        BLEBENCH_LOG(ERROR, "Error: Descriptor discovery failed; status=%d\n",
+                     error->status);
+        ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+        return 0;
+    }
+}
+
+static int
+blebench_on_disc_chr(uint16_t conn_handle, const struct ble_gatt_error *error,
+                     const struct ble_gatt_chr *chr, void *arg)
+{
+    int rc;
+
+    switch (error->status) {
+    case 0:
+        if (memcmp(chr->uuid128, blebench_chr_stream_uuid, 16) == 0) {
+            blebench_chr_val_handle = chr->val_handle;
+        }
+        return 0;
+
+    case BLE_HS_EDONE:
+        if (blebench_chr_val_handle == 0) {
+            BLEBENCH_LOG(ERROR, "Error: Streamer lacks the stream "
+                                "characteristic\n");
+            ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+            return 0;
+        }
+        rc = ble_gattc_disc_all_dscs(conn_handle, blebench_chr_val_handle,
+                                     blebench_svc_end_handle,
+                                     blebench_on_disc_dsc, NULL);
+        if (rc != 0) {
+            BLEBENCH_LOG(ERROR, "Error: Failed to discover descriptors; "
+                                "rc=%d\n", rc);
+            ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+        }
+        return 0;
+
+    default:
+        BLEBENCH_LOG(ERROR, "Error: Characteristic discovery failed; "
+                            "status=%d\n", error->status);
+        ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+        return 0;
+    }
+}
+
+static int
+blebench_on_disc_svc(uint16_t conn_handle, const struct ble_gatt_error *error,
+                     const struct ble_gatt_svc *service, void *arg)
+{
+    int rc;
+
+    switch (error->status) {
+    case 0:
+        blebench_svc_start_handle = service->start_handle;
+        blebench_svc_end_handle = service->end_handle;
+        return 0;
+
+    case BLE_HS_EDONE:
+        if (blebench_svc_start_handle == 0) {
+            BLEBENCH_LOG(ERROR, "Error: Streamer lacks the benchmark "
+                                "service\n");
+            ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+            return 0;
+        }
+        rc = ble_gattc_disc_all_chrs(conn_handle, blebench_svc_start_handle,
+                                     blebench_svc_end_handle,
+                                     blebench_on_disc_chr, NULL);
+        if (rc != 0) {
+            BLEBENCH_LOG(ERROR, "Error: Failed to discover characteristics; "
+                                "rc=%d\n", rc);
+            ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+        }
+        return 0;
+
+    default:
+        BLEBENCH_LOG(ERROR, "Error: Service discovery failed; status=%d\n",
+                     error->status);
+        ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+        return 0;
+    }
+}
+
+static int
+blebench_on_mtu(uint16_t conn_handle, const struct ble_gatt_error *error,
+                uint16_t mtu, void *arg)
+{
+    BLEBENCH_LOG(INFO, "mtu exchange complete; status=%d mtu=%d\n",
+                 error->status, mtu);
+    return 0;
+}
+
+/**
+ * Kicks off the setup sequence against a newly connected streamer: MTU
+ * exchange, optional connection parameter update, then discovery of the
+ * stream characteristic's CCCD.
+ */
+static void
+blebench_setup_peer(void)
+{
+    struct ble_gap_upd_params params;
+    int rc;
+
+    if (MYNEWT_VAL(BLEBENCH_MTU) != 0) {
+        rc = ble_gattc_exchange_mtu(blebench_conn_handle, blebench_on_mtu,
+                                    NULL);
+        if (rc != 0) {
+            BLEBENCH_LOG(ERROR, "Error: Failed to exchange mtu; rc=%d\n", rc);
+        }
+    }
+
+    if (MYNEWT_VAL(BLEBENCH_CONN_ITVL) != 0) {
+        memset(&params, 0, sizeof params);
+        params.itvl_min = MYNEWT_VAL(BLEBENCH_CONN_ITVL);
+        params.itvl_max = MYNEWT_VAL(BLEBENCH_CONN_ITVL);
+        params.supervision_timeout = BLE_GAP_INITIAL_SUPERVISION_TIMEOUT;
+        rc = ble_gap_update_params(blebench_conn_handle, &params);
+        if (rc != 0) {
+            BLEBENCH_LOG(ERROR, "Error: Failed to update conn params; "
+                                "rc=%d\n", rc);
+        }
+    }
+
+    blebench_svc_start_handle = 0;
+    blebench_svc_end_handle = 0;
+    blebench_chr_val_handle = 0;
+    blebench_cccd_handle = 0;
+    rc = ble_gattc_disc_svc_by_uuid(blebench_conn_handle, blebench_svc_uuid,
+                                    blebench_on_disc_svc, NULL);
+    if (rc != 0) {
+        BLEBENCH_LOG(ERROR, "Error: Failed to discover services; rc=%d\n",
+                     rc);
+        ble_gap_terminate(blebench_conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+    }
+}
+
+/**
+ * Initiates the GAP general discovery procedure.
+ */
+static void
+blebench_scan(void)
+{
+    struct ble_gap_disc_params disc_params;
+    int rc;
+
+    /* Tell the controller to filter duplicates; we don't want to process
+     * repeated advertisements from the same device.
+     */
+    disc_params.filter_duplicates = 1;
+
+    /* Perform a passive scan.  I.e., don't send follow-up scan requests to
+     * each advertiser.
+     */
+    disc_params.passive = 1;
+
+    /* Use defaults for the rest of the parameters. */
+    disc_params.itvl = 0;
+    disc_params.window = 0;
+    disc_params.filter_policy = 0;
+    disc_params.limited = 0;
+
+    rc = ble_gap_disc(BLE_ADDR_TYPE_PUBLIC, BLE_HS_FOREVER, &disc_params,
+                      blebench_gap_event, NULL);
+    if (rc != 0) {
+        BLEBENCH_LOG(ERROR, "Error initiating GAP discovery procedure; "
+                            "rc=%d\n", rc);
+    }
+}
+
+/**
+ * Indicates whether the specified advertisement comes from the benchmark
+ * streamer.  The streamer is identified by its complete device name.
+ */
+static int
+blebench_should_connect(const struct ble_gap_disc_desc *disc)
+{
+    if (disc->event_type != BLE_HCI_ADV_RPT_EVTYPE_ADV_IND &&
+        disc->event_type != BLE_HCI_ADV_RPT_EVTYPE_DIR_IND) {
+
+        return 0;
+    }
+
+    if (!disc->fields->name_is_complete ||
+        disc->fields->name_len != strlen(BLEBENCH_DEVICE_NAME) ||
+        memcmp(disc->fields->name, BLEBENCH_DEVICE_NAME,
+               disc->fields->name_len) != 0) {
+
+        return 0;
+    }
+
+    return 1;
+}
+
+static void
+blebench_connect_if_streamer(const struct ble_gap_disc_desc *disc)
+{
+    int rc;
+
+    if (!blebench_should_connect(disc)) {
+        return;
+    }
+
+    /* Scanning must be stopped before a connection can be initiated. */
+    rc = ble_gap_disc_cancel();
+    if (rc != 0) {
+        BLEBENCH_LOG(DEBUG, "Failed to cancel scan; rc=%d\n", rc);
+        return;
+    }
+
+    rc = ble_gap_connect(BLE_ADDR_TYPE_PUBLIC, disc->addr_type, disc->addr,
+                         30000, NULL, blebench_gap_event, NULL);
+    if (rc != 0) {
+        BLEBENCH_LOG(ERROR, "Error: Failed to connect to streamer; rc=%d\n",
+                     rc);
+        return;
+    }
+}
+
+/**
+ * The nimble host executes this callback when a GAP event occurs.
+ */
+static int
+blebench_gap_event(struct ble_gap_event *event, void *arg)
+{
+    switch (event->type) {
+    case BLE_GAP_EVENT_DISC:
+        /* Try to connect to the advertiser if it is the streamer. */
+        blebench_connect_if_streamer(&event->disc);
+        return 0;
+
+    case BLE_GAP_EVENT_CONNECT:
+        if (event->connect.status == 0) {
+            BLEBENCH_LOG(INFO, "connection established\n");
+            blebench_conn_handle = event->connect.conn_handle;
+            blebench_setup_peer();
+        } else {
+            /* Connection attempt failed; resume scanning. */
+            BLEBENCH_LOG(ERROR, "Error: Connection failed; status=%d\n",
+                         event->connect.status);
+            blebench_scan();
+        }
+        return 0;
+
+    case BLE_GAP_EVENT_DISCONNECT:
+        BLEBENCH_LOG(INFO, "disconnect; reason=%d\n",
+                     event->disconnect.reason);
+        blebench_conn_handle = BLE_HS_CONN_HANDLE_NONE;
+
+        /* Resume scanning. */
+        blebench_scan();
+        return 0;
+
+    case BLE_GAP_EVENT_NOTIFY_RX:
+        blebench_rx(event->notify_rx.om);
+        return 0;
+
+    case BLE_GAP_EVENT_MTU:
+        BLEBENCH_LOG(INFO, "mtu update event; conn_handle=%d mtu=%d\n",
+                     event->mtu.conn_handle, event->mtu.value);
+        return 0;
+
+    default:
+        return 0;
+    }
+}
+
+static void
+blebench_on_reset(int reason)
+{
+    BLEBENCH_LOG(ERROR, "Resetting state; reason=%d\n", reason);
+}
+
+static void
+blebench_on_sync(void)
+{
+    /* Begin scanning for the streamer. */
+    blebench_scan();
+}
+
+/**
+ * Event loop for the main blebenchcent task.
+ */
+static void
+blebench_task_handler(void *unused)
+{
+    while (1) {
+        os_eventq_run(&blebench_evq);
+    }
+}
+
+/**
+ * main
+ *
+ * The main function for the project. This function initializes the os, calls
+ * init_tasks to initialize tasks (and possibly other objects), then starts the
+ * OS. We should not return from os start.
+ *
+ * @return int NOTE: this function should never return!
+ */
+int
+main(void)
+{
+    int rc;
+
+    /* Initialize OS */
+    sysinit();
+
+    /* Initialize the blebench log. */
+    log_register("blebench", &blebench_log, &log_console_handler, NULL,
+                 LOG_SYSLEVEL);
+
+    /* Initialize the eventq for the application task. */
+    os_eventq_init(&blebench_evq);
+
+    /* Create the blebenchcent task.  All application logic and NimBLE host
+     * operations are performed in this task.
+     */
+    os_task_init(&blebench_task, "blebench", blebench_task_handler,
+                 NULL, BLEBENCH_TASK_PRIO, OS_WAIT_FOREVER,
+                 blebench_stack, BLEBENCH_STACK_SIZE);
+
+    os_callout_init(&blebench_report_co, &blebench_evq,
+                    blebench_report_ev, NULL);
+    os_callout_reset(&blebench_report_co,
+                     MYNEWT_VAL(BLEBENCH_REPORT_ITVL_SECS) *
+                     OS_TICKS_PER_SEC);
+
+    /* Configure the host. */
+    log_register("ble_hs", &ble_hs_log, &log_console_handler, NULL,
+                 LOG_SYSLEVEL);
+    ble_hs_cfg.reset_cb = blebench_on_reset;
+    ble_hs_cfg.sync_cb = blebench_on_sync;
+
+    if (MYNEWT_VAL(BLEBENCH_MTU) != 0) {
+        rc = ble_att_set_preferred_mtu(MYNEWT_VAL(BLEBENCH_MTU));
+        assert(rc == 0);
+    }
+
+    /* Set the default device name. */
+    rc = ble_svc_gap_device_name_set("nimble-blebenchcent");
+    assert(rc == 0);
+
+    /* Set the default eventq for packages that lack a dedicated task. */
+    os_eventq_dflt_set(&blebench_evq);
+
+    /* Start the OS */
+    os_start();
+
+    /* os start should never return. If it does, this should be an error */
+    assert(0);
+
+    return 0;
+}
@@ -0,0 +1,496 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "bsp/bsp.h"
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "console/console.h"
+
+/* BLE */
+#include "nimble/ble.h"
+#include "host/ble_hs.h"
+#include "services/gap/ble_svc_gap.h"
+
+/* Application-specified header. */
+#include "blebenchprph.h"
+
+/** Log data. */
+struct log blebench_log;
+
+/** blebenchprph task settings. */
+#define BLEBENCH_TASK_PRIO          1
+#define BLEBENCH_STACK_SIZE         (OS_STACK_ALIGN(336))
+
+/* ATT notification opcode + attribute handle. */
+#define BLEBENCH_NOTIFY_OVERHEAD    3
+
+struct os_eventq blebench_evq;
+struct os_task blebench_task;
+bssnz_t os_stack_t blebench_stack[BLEBENCH_STACK_SIZE];
+
+/** Our global device address (public) */
+uint8_t g_dev_addr[BLE_DEV_ADDR_LEN] = {0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b};
+
+/** Our random address (in case we need it) */
+uint8_t g_random_addr[BLE_DEV_ADDR_LEN];
+
+/* ab4b1e10-37a8-43d6-9a87-0cc526d46b28 */
+static const uint8_t blebench_svc_uuid[16] = {
+    0x28, 0x6b, 0xd4, 0x26, 0xc5, 0x0c, 0x87, 0x9a,
+    0xd6, 0x43, 0xa8, 0x37, 0x10, 0x1e, 0x4b, 0xab
+};
+
+/* ab4b1e11-37a8-43d6-9a87-0cc526d46b28 */
+static const uint8_t blebench_chr_stream_uuid[16] = {
+    0x28, 0x6b, 0xd4, 0x26, 0xc5, 0x0c, 0x87, 0x9a,
+    0xd6, 0x43, 0xa8, 0x37, 0x11, 0x1e, 0x4b, 0xab
+};
+
+/** Benchmark state; reset each time the central (re)subscribes. */
+static uint16_t blebench_conn_handle = BLE_HS_CONN_HANDLE_NONE;
+static uint16_t blebench_stream_val_handle;
+static uint8_t blebench_streaming;
+static uint32_t blebench_seq;
+static uint32_t blebench_tx_pkts;
+static uint32_t blebench_tx_bytes;
+static uint32_t blebench_nomem;
+static int blebench_msys_min;
+static uint32_t blebench_send_hist[BLEBENCH_HIST_BUCKETS];
+static uint8_t blebench_payload[BLE_ATT_MTU_MAX - BLEBENCH_NOTIFY_OVERHEAD];
+
+static void blebench_pump(struct os_event *ev);
+
+static struct os_event blebench_pump_ev = {
+    .ev_cb = blebench_pump,
+};
+
+/* Fires one tick after the mbuf pools run dry; re-posts the pump. */
+static struct os_callout blebench_retry_co;
+static struct os_callout blebench_report_co;
+
+static int blebench_gap_event(struct ble_gap_event *event, void *arg);
+
+static int
+blebench_chr_access(uint16_t conn_handle, uint16_t attr_handle,
+                    struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    uint8_t buf[4];
+    int rc;
+
+    /* The stream characteristic is notification driven; a plain read just
+     * reports the current sequence number.
+     */
+    assert(ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR);
+    htole32(buf, blebench_seq);
+    rc = os_mbuf_append(ctxt->om, buf, sizeof buf);
+    return rc == 0 ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
+static const struct ble_gatt_svc_def blebench_svcs[] = {
+    {
+        /*** Benchmark stream service. */
+        .type = BLE_GATT_SVC_TYPE_PRIMARY,
+        .uuid128 = blebench_svc_uuid,
+        .characteristics = (struct ble_gatt_chr_def[]) { {
+            /*** Characteristic: notification stream. */
+            .uuid128 = blebench_chr_stream_uuid,
+            .access_cb = blebench_chr_access,
+            .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+        }, {
+            0, /* No more characteristics in this service. */
+        } },
+    },
+
+    {
+        0, /* No more services. */
+    },
+};
+
+/**
+ * Adds a sample to a power-of-two latency histogram; bucket i counts
+ * samples in [2^i, 2^(i+1)) microseconds.
+ */
+static void
+blebench_hist_add(uint32_t *hist, uint32_t usecs)
+{
+    int i;
+
+    for (i = 0;
+         i < BLEBENCH_HIST_BUCKETS - 1 && usecs >= (1UL << (i + 1));
+         i++) {
+    }
+    hist[i]++;
+}
+
+static void
+blebench_hist_print(const char *type, const uint32_t *hist)
+{
+    int i;
+
+    console_printf("bench-hist: role=prph type=%s unit=log2us counts=", type);
+    for (i = 0; i < BLEBENCH_HIST_BUCKETS; i++) {
+        console_printf("%s%lu", i == 0 ? "" : ",", (unsigned long)hist[i]);
+    }
+    console_printf("\n");
+}
+
+static void
+blebench_stats_reset(void)
+{
+    blebench_seq = 0;
+    blebench_tx_pkts = 0;
+    blebench_tx_bytes = 0;
+    blebench_nomem = 0;
+    blebench_msys_min = os_msys_num_free();
+    memset(blebench_send_hist, 0, sizeof blebench_send_hist);
+}
+
+/**
+ * Sends a burst of notifications and re-posts itself, yielding to the rest
+ * of the event queue between bursts.  When the mbuf pools run dry the pump
+ * backs off for one tick instead; the ATT-layer fragmenter draining into
+ * the controller is what frees the blocks again.
+ */
+static void
+blebench_pump(struct os_event *ev)
+{
+    struct os_mbuf *om;
+    uint32_t start;
+    uint16_t mtu;
+    uint16_t len;
+    int msys;
+    int i;
+    int rc;
+
+    if (!blebench_streaming) {
+        return;
+    }
+
+    mtu = ble_att_mtu(blebench_conn_handle);
+    if (mtu == 0) {
+        return;
+    }
+
+    len = mtu - BLEBENCH_NOTIFY_OVERHEAD;
+    if (MYNEWT_VAL(BLEBENCH_PAYLOAD_LEN) != 0 &&
+        len > MYNEWT_VAL(BLEBENCH_PAYLOAD_LEN)) {
+
+        len = MYNEWT_VAL(BLEBENCH_PAYLOAD_LEN);
+    }
+    if (len < BLEBENCH_PKT_HDR_LEN) {
+        len = BLEBENCH_PKT_HDR_LEN;
+    }
+
+    for (i = 0; i < MYNEWT_VAL(BLEBENCH_BURST); i++) {
+        htole32(blebench_payload, blebench_seq);
+        htole32(blebench_payload + 4, os_cputime_get32());
+
+        om = ble_hs_mbuf_from_flat(blebench_payload, len);
+        if (om == NULL) {
+            blebench_nomem++;
+            os_callout_reset(&blebench_retry_co, 1);
+            return;
+        }
+
+        start = os_cputime_get32();
+        rc = ble_gattc_notify_custom(blebench_conn_handle,
+                                     blebench_stream_val_handle, om);
+        if (rc != 0) {
+            /* The mbuf was consumed regardless of the result. */
+            blebench_nomem++;
+            os_callout_reset(&blebench_retry_co, 1);
+            return;
+        }
+        blebench_hist_add(blebench_send_hist,
+                          os_cputime_ticks_to_usecs(os_cputime_get32() -
+                                                    start));
+
+        blebench_seq++;
+        blebench_tx_pkts++;
+        blebench_tx_bytes += len;
+    }
+
+    msys = os_msys_num_free();
+    if (msys < blebench_msys_min) {
+        blebench_msys_min = msys;
+    }
+
+    os_eventq_put(&blebench_evq, &blebench_pump_ev);
+}
+
+static void
+blebench_retry_ev(struct os_event *ev)
+{
+    blebench_pump(ev);
+}
+
+/**
+ * Emits one machine-readable statistics record per report interval.
+ */
+static void
+blebench_report_ev(struct os_event *ev)
+{
+    uint16_t mtu;
+
+    mtu = blebench_conn_handle == BLE_HS_CONN_HANDLE_NONE ?
+          0 : ble_att_mtu(blebench_conn_handle);
+
+    console_printf("bench: role=prph t=%lu streaming=%d mtu=%u "
+                   "tx_pkts=%lu tx_bytes=%lu nomem=%lu msys_min=%d\n",
+                   (unsigned long)(os_time_get() / OS_TICKS_PER_SEC),
+                   blebench_streaming, mtu,
+                   (unsigned long)blebench_tx_pkts,
+                   (unsigned long)blebench_tx_bytes,
+                   (unsigned long)blebench_nomem,
+                   blebench_msys_min);
+    blebench_hist_print("send", blebench_send_hist);
+
+    os_callout_reset(&blebench_report_co,
+                     MYNEWT_VAL(BLEBENCH_REPORT_ITVL_SECS) *
+                     OS_TICKS_PER_SEC);
+}
+
+/**
+ * Enables advertising with the following parameters:
+ *     o General discoverable mode.
+ *     o Undirected connectable mode.
+ */
+static void
+blebench_advertise(void)
+{
+    struct ble_gap_adv_params adv_params;
+    struct ble_hs_adv_fields fields;
+    const char *name;
+    int rc;
+
+    memset(&fields, 0, sizeof fields);
+
+    fields.flags_is_present = 1;
+    fields.flags = 0;
+
+    /* The central identifies us by the complete device name. */
+    name = ble_svc_gap_device_name();
+    fields.name = (uint8_t *)name;
+    fields.name_len = strlen(name);
+    fields.name_is_complete = 1;
+
+    rc = ble_gap_adv_set_fields(&fields);
+    if (rc != 0) {
+        BLEBENCH_LOG(ERROR, "error setting advertisement data; rc=%d\n", rc);
+        return;
+    }
+
+    /* Begin advertising. */
+    memset(&adv_params, 0, sizeof adv_params);
+    adv_params.conn_mode = BLE_GAP_CONN_MODE_UND;
+    adv_params.disc_mode = BLE_GAP_DISC_MODE_GEN;
+    rc = ble_gap_adv_start(BLE_ADDR_TYPE_PUBLIC, 0, NULL, BLE_HS_FOREVER,
+                           &adv_params, blebench_gap_event, NULL);
+    if (rc != 0) {
+        BLEBENCH_LOG(ERROR, "error enabling advertisement; rc=%d\n", rc);
+        return;
+    }
+}
+
+/**
+ * The nimble host executes this callback when a GAP event occurs.
+ */
+static int
+blebench_gap_event(struct ble_gap_event *event, void *arg)
+{
+    struct ble_gap_conn_desc desc;
+    int rc;
+
+    switch (event->type) {
+    case BLE_GAP_EVENT_CONNECT:
+        BLEBENCH_LOG(INFO, "connection %s; status=%d\n",
+                     event->connect.status == 0 ? "established" : "failed",
+                     event->connect.status);
+        if (event->connect.status == 0) {
+            blebench_conn_handle = event->connect.conn_handle;
+        } else {
+            /* Connection failed; resume advertising. */
+            blebench_advertise();
+        }
+        return 0;
+
+    case BLE_GAP_EVENT_DISCONNECT:
+        BLEBENCH_LOG(INFO, "disconnect; reason=%d\n",
+                     event->disconnect.reason);
+        blebench_conn_handle = BLE_HS_CONN_HANDLE_NONE;
+        blebench_streaming = 0;
+
+        /* Connection terminated; resume advertising. */
+        blebench_advertise();
+        return 0;
+
+    case BLE_GAP_EVENT_CONN_UPDATE:
+        rc = ble_gap_conn_find(event->conn_update.conn_handle, &desc);
+        assert(rc == 0);
+        BLEBENCH_LOG(INFO, "connection updated; status=%d itvl=%d\n",
+                     event->conn_update.status, desc.conn_itvl);
+        return 0;
+
+    case BLE_GAP_EVENT_SUBSCRIBE:
+        if (event->subscribe.attr_handle != blebench_stream_val_handle) {
+            return 0;
+        }
+        BLEBENCH_LOG(INFO, "stream subscription; curn=%d\n",
+                     event->subscribe.cur_notify);
+        blebench_streaming = event->subscribe.cur_notify;
+        if (blebench_streaming) {
+            /* New run; start the stats and the pump from scratch. */
+            blebench_stats_reset();
+            os_eventq_put(&blebench_evq, &blebench_pump_ev);
+        }
+        return 0;
+
+    case BLE_GAP_EVENT_MTU:
+        BLEBENCH_LOG(INFO, "mtu update event; conn_handle=%d mtu=%d\n",
+                     event->mtu.conn_handle, event->mtu.value);
+        return 0;
+    }
+
+    return 0;
+}
+
+static void
+blebench_on_reset(int reason)
+{
+    BLEBENCH_LOG(ERROR, "Resetting state; reason=%d\n", reason);
+}
+
+static void
+blebench_on_sync(void)
+{
+    /* Begin advertising. */
+    blebench_advertise();
+}
+
+static void
+blebench_gatt_register_cb(struct ble_gatt_register_ctxt *ctxt, void *arg)
+{
+    /* Remember the stream characteristic's value handle; notifications are
+     * sent straight to it.
+     */
+    if (ctxt->op == BLE_GATT_REGISTER_OP_CHR &&
+        memcmp(ctxt->chr.chr_def->uuid128, blebench_chr_stream_uuid,
+               16) == 0) {
+
+        blebench_stream_val_handle = ctxt->chr.val_handle;
+    }
+}
+
+static int
+blebench_gatt_init(void)
+{
+    int rc;
+
+    rc = ble_gatts_count_cfg(blebench_svcs);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = ble_gatts_add_svcs(blebench_svcs);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+
+/**
+ * Event loop for the main blebenchprph task.
+ */
+static void
+blebench_task_handler(void *unused)
+{
+    while (1) {
+        os_eventq_run(&blebench_evq);
+    }
+}
+
+/**
+ * main
+ *
+ * The main function for the project. This function initializes the os, calls
+ * init_tasks to initialize tasks (and possibly other objects), then starts the
+ * OS. We should not return from os start.
+ *
+ * @return int NOTE: this function should never return!
+ */
+int
+main(void)
+{
+    int rc;
+
+    /* Initialize OS */
+    sysinit();
+
+    /* Initialize the blebench log. */
+    log_register("blebench", &blebench_log, &log_console_handler, NULL,
+                 LOG_SYSLEVEL);
+
+    /* Initialize eventq */
+    os_eventq_init(&blebench_evq);
+
+    /* Create the blebenchprph task.  All application logic and NimBLE host
+     * operations are performed in this task.
+     */
+    os_task_init(&blebench_task, "blebench", blebench_task_handler,
+                 NULL, BLEBENCH_TASK_PRIO, OS_WAIT_FOREVER,
+                 blebench_stack, BLEBENCH_STACK_SIZE);
+
+    os_callout_init(&blebench_retry_co, &blebench_evq,
+                    blebench_retry_ev, NULL);
+    os_callout_init(&blebench_report_co, &blebench_evq,
+                    blebench_report_ev, NULL);
+    os_callout_reset(&blebench_report_co,
+                     MYNEWT_VAL(BLEBENCH_REPORT_ITVL_SECS) *
+                     OS_TICKS_PER_SEC);
+
+    /* Initialize the NimBLE host configuration. */
+    log_register("ble_hs", &ble_hs_log, &log_console_handler, NULL,
+                 LOG_SYSLEVEL);
+    ble_hs_cfg.reset_cb = blebench_on_reset;
+    ble_hs_cfg.sync_cb = blebench_on_sync;
+    ble_hs_cfg.gatts_register_cb = blebench_gatt_register_cb;
+
+    rc = blebench_gatt_init();
+    assert(rc == 0);
+
+    /* Set the default device name. */
+    rc = ble_svc_gap_device_name_set(BLEBENCH_DEVICE_NAME);
+    assert(rc == 0);
+
+    /* Set the default eventq for packages that lack a dedicated task. */
+    os_eventq_dflt_set(&blebench_evq);
+
+    /* Start the OS */
+    os_start();
+
+    /* os start should never return. If it does, this should be an error */
+    assert(0);
+
+    return 0;
+}
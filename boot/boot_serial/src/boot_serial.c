@@ -22,6 +22,7 @@
 #include <ctype.h>
 #include <stdio.h>
 
+#include "syscfg/syscfg.h"
 #include "sysflash/sysflash.h"
 
 #include <bsp/bsp.h>
@@ -54,6 +55,21 @@ static uint32_t curr_off;
 static uint32_t img_size;
 static struct nmgr_hdr *bs_hdr;
 
+#if MYNEWT_VAL(BOOT_SERIAL_BULK)
+/*
+ * Bulk transfer mode.  Upload frames are staged in RAM and only
+ * acknowledged - and written to flash, as one operation - when the
+ * client closes a window by sending a CRC16 over the staged bytes.
+ * curr_off only ever advances by whole verified windows, so a client
+ * recovers from any failure by rewinding to the acknowledged offset.
+ */
+static uint8_t *bs_bulk_buf;
+static uint16_t bs_bulk_fsz;        /* granted frame payload size */
+static uint8_t bs_bulk_win;         /* granted frames per window */
+static uint32_t bs_bulk_staged;     /* bytes staged since last ack */
+static uint8_t bs_bulk_active;
+#endif
+
 static char bs_obuf[BOOT_SERIAL_OUT_MAX];
 
 static int bs_cbor_writer(struct cbor_encoder_writer *, const char *data,
@@ -151,6 +167,79 @@ bs_list(char *buf, int len)
     boot_serial_output();
 }
 
+#if MYNEWT_VAL(BOOT_SERIAL_BULK)
+/*
+ * Bulk mode negotiation.  The client proposes frame and window sizes;
+ * we grant at most what we were built to stage and reply with the
+ * granted values.  Image data then flows through the regular upload
+ * op, windowed as negotiated.
+ */
+static void
+bs_bulk_start(char *buf, int len)
+{
+    CborParser parser;
+    struct cbor_buf_reader reader;
+    struct CborValue value;
+    long long unsigned int fsz = MYNEWT_VAL(BOOT_SERIAL_BULK_FRAME_SZ);
+    long long unsigned int win = MYNEWT_VAL(BOOT_SERIAL_BULK_WIN);
+    const struct cbor_attr_t attr[3] = {
+        [0] = {
+            .attribute = "fsz",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &fsz,
+            .nodefault = true
+        },
+        [1] = {
+            .attribute = "win",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &win,
+            .nodefault = true
+        }
+    };
+    int rc;
+
+    cbor_buf_reader_init(&reader, (uint8_t *)buf, len);
+    cbor_parser_init(&reader.r, 0, &parser, &value);
+    rc = cbor_read_object(&value, attr);
+    if (rc) {
+        rc = MGMT_ERR_EINVAL;
+        goto out;
+    }
+    if (fsz > MYNEWT_VAL(BOOT_SERIAL_BULK_FRAME_SZ)) {
+        fsz = MYNEWT_VAL(BOOT_SERIAL_BULK_FRAME_SZ);
+    }
+    if (win > MYNEWT_VAL(BOOT_SERIAL_BULK_WIN)) {
+        win = MYNEWT_VAL(BOOT_SERIAL_BULK_WIN);
+    }
+    if (!bs_bulk_buf) {
+        bs_bulk_buf = os_malloc(MYNEWT_VAL(BOOT_SERIAL_BULK_FRAME_SZ) *
+          MYNEWT_VAL(BOOT_SERIAL_BULK_WIN));
+        if (!bs_bulk_buf) {
+            rc = MGMT_ERR_ENOMEM;
+            goto out;
+        }
+    }
+    bs_bulk_fsz = fsz;
+    bs_bulk_win = win;
+    bs_bulk_staged = 0;
+    bs_bulk_active = 1;
+    rc = 0;
+
+out:
+    cbor_encoder_create_map(&bs_root, &bs_rsp, CborIndefiniteLength);
+    cbor_encode_text_stringz(&bs_rsp, "rc");
+    cbor_encode_int(&bs_rsp, rc);
+    if (rc == 0) {
+        cbor_encode_text_stringz(&bs_rsp, "fsz");
+        cbor_encode_uint(&bs_rsp, fsz);
+        cbor_encode_text_stringz(&bs_rsp, "win");
+        cbor_encode_uint(&bs_rsp, win);
+    }
+    cbor_encoder_close_container(&bs_root, &bs_rsp);
+    boot_serial_output();
+}
+#endif
+
 /*
  * Image upload request.
  */
@@ -164,13 +253,24 @@ bs_upload(char *buf, int len)
     long long unsigned int off = UINT_MAX;
     size_t img_blen = 0;
     long long unsigned int data_len = UINT_MAX;
-    const struct cbor_attr_t attr[4] = {
+#if MYNEWT_VAL(BOOT_SERIAL_BULK)
+    long long unsigned int wcrc = UINT_MAX;
+    uint16_t crc;
+#endif
+    const struct cbor_attr_t attr[5] = {
         [0] = {
             .attribute = "data",
             .type = CborAttrByteStringType,
+#if MYNEWT_VAL(BOOT_SERIAL_BULK)
+            /* In bulk mode, decode straight into the staging buffer. */
+            .addr.bytestring.data = bs_bulk_active ?
+              bs_bulk_buf + bs_bulk_staged : img_data,
+            .len = bs_bulk_active ? bs_bulk_fsz : sizeof(img_data),
+#else
             .addr.bytestring.data = img_data,
-            .addr.bytestring.len = &img_blen,
-            .len = sizeof(img_data)
+            .len = sizeof(img_data),
+#endif
+            .addr.bytestring.len = &img_blen
         },
         [1] = {
             .attribute = "off",
@@ -183,7 +283,15 @@ bs_upload(char *buf, int len)
             .type = CborAttrUnsignedIntegerType,
             .addr.uinteger = &data_len,
             .nodefault = true
+        },
+#if MYNEWT_VAL(BOOT_SERIAL_BULK)
+        [3] = {
+            .attribute = "crc",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &wcrc,
+            .nodefault = true
         }
+#endif
     };
     const struct flash_area *fap = NULL;
     int rc;
@@ -206,6 +314,9 @@ bs_upload(char *buf, int len)
 
     if (off == 0) {
         curr_off = 0;
+#if MYNEWT_VAL(BOOT_SERIAL_BULK)
+        bs_bulk_staged = 0;
+#endif
         if (data_len > fap->fa_size) {
             rc = MGMT_ERR_EINVAL;
             goto out;
@@ -217,6 +328,43 @@ bs_upload(char *buf, int len)
         }
         img_size = data_len;
     }
+#if MYNEWT_VAL(BOOT_SERIAL_BULK)
+    if (bs_bulk_active) {
+        if (off != curr_off + bs_bulk_staged) {
+            /* Drop the staged window; the ack rewinds the client to
+             * the last verified offset.
+             */
+            bs_bulk_staged = 0;
+            rc = 0;
+            goto out;
+        }
+        bs_bulk_staged += img_blen;
+        if (wcrc == UINT_MAX &&
+            curr_off + bs_bulk_staged < img_size &&
+            bs_bulk_staged + bs_bulk_fsz <=
+              (uint32_t)bs_bulk_fsz * bs_bulk_win) {
+            /* Mid-window; no response until the client closes it. */
+            flash_area_close(fap);
+            return;
+        }
+        crc = crc16_ccitt(CRC16_INITIAL_CRC, bs_bulk_buf, bs_bulk_staged);
+        if (wcrc == UINT_MAX || crc != (uint16_t)wcrc) {
+            /* Missing or bad window CRC; rewind. */
+            bs_bulk_staged = 0;
+            rc = 0;
+            goto out;
+        }
+        /* Whole window verified; one large sequential flash write. */
+        rc = flash_area_write(fap, curr_off, bs_bulk_buf, bs_bulk_staged);
+        if (rc) {
+            rc = MGMT_ERR_EINVAL;
+            goto out;
+        }
+        curr_off += bs_bulk_staged;
+        bs_bulk_staged = 0;
+        goto out;
+    }
+#endif
     if (off != curr_off) {
         rc = 0;
         goto out;
@@ -303,6 +451,11 @@ boot_serial_input(char *buf, int len)
         case IMGMGR_NMGR_OP_UPLOAD:
             bs_upload(buf, len);
             break;
+#if MYNEWT_VAL(BOOT_SERIAL_BULK)
+        case IMGMGR_NMGR_OP_BULK:
+            bs_bulk_start(buf, len);
+            break;
+#endif
         default:
             break;
         }
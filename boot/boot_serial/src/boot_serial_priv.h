@@ -36,6 +36,7 @@ extern "C" {
 /*
  * From newtmgr.h
  */
+#define MGMT_ERR_ENOMEM         2
 #define MGMT_ERR_EINVAL         3
 
 #define NMGR_OP_READ            0
@@ -64,6 +65,12 @@ struct nmgr_hdr {
 #define IMGMGR_NMGR_OP_STATE            0
 #define IMGMGR_NMGR_OP_UPLOAD           1
 
+/*
+ * Bootloader-private; not part of the imgmgr group proper.  Negotiates
+ * bulk transfer mode for the recovery upload.
+ */
+#define IMGMGR_NMGR_OP_BULK             8
+
 
 void boot_serial_input(char *buf, int len);
 
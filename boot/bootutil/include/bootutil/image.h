@@ -86,6 +86,8 @@ int bootutil_img_validate(struct image_header *hdr,
                           const struct flash_area *fap,
                           uint8_t *tmp_buf, uint32_t tmp_buf_sz,
                           uint8_t *seed, int seed_len, uint8_t *out_hash);
+int bootutil_img_find_sha256(struct image_header *hdr,
+                             const struct flash_area *fap, uint8_t *hash);
 
 #ifdef __cplusplus
 }
@@ -35,6 +35,52 @@
 
 #include "bootutil_priv.h"
 
+#if MYNEWT_VAL(BOOTUTIL_HAL_HASH)
+#include "hal/hal_hash.h"
+
+/*
+ * Compute SHA256 over the image using the MCU hash engine.
+ */
+static int
+bootutil_img_hash(struct image_header *hdr, const struct flash_area *fap,
+                  uint8_t *tmp_buf, uint32_t tmp_buf_sz,
+                  uint8_t *hash_result, uint8_t *seed, int seed_len)
+{
+    uint32_t blk_sz;
+    uint32_t size;
+    uint32_t off;
+    int rc;
+
+    rc = hal_hash_sha256_start();
+    if (rc) {
+        return rc;
+    }
+
+    /* in some cases (split image) the hash is seeded with data from
+     * the loader image */
+    if(seed && (seed_len > 0)) {
+        hal_hash_sha256_update(seed, seed_len);
+    }
+
+    /*
+     * Hash is computed over image header and image itself. No TLV is
+     * included ATM.
+     */
+    size = hdr->ih_img_size + hdr->ih_hdr_size;
+    for (off = 0; off < size; off += blk_sz) {
+        blk_sz = size - off;
+        if (blk_sz > tmp_buf_sz) {
+            blk_sz = tmp_buf_sz;
+        }
+        rc = flash_area_read(fap, off, tmp_buf, blk_sz);
+        if (rc) {
+            return rc;
+        }
+        hal_hash_sha256_update(tmp_buf, blk_sz);
+    }
+    return hal_hash_sha256_finish(hash_result);
+}
+#else
 /*
  * Compute SHA256 over the image.
  */
@@ -80,6 +126,122 @@ bootutil_img_hash(struct image_header *hdr, const struct flash_area *fap,
 
     return 0;
 }
+#endif
+
+/*
+ * Read the image's stored SHA256 TLV into 'hash'.
+ */
+int
+bootutil_img_find_sha256(struct image_header *hdr, const struct flash_area *fap,
+                         uint8_t *hash)
+{
+    struct image_tlv tlv;
+    uint32_t off;
+    uint32_t size;
+    int rc;
+
+    off = hdr->ih_img_size + hdr->ih_hdr_size;
+    size = off + hdr->ih_tlv_size;
+    for (; off < size; off += sizeof(tlv) + tlv.it_len) {
+        rc = flash_area_read(fap, off, &tlv, sizeof tlv);
+        if (rc) {
+            return rc;
+        }
+        if (tlv.it_type == IMAGE_TLV_SHA256) {
+            if (tlv.it_len != 32) {
+                return -1;
+            }
+            return flash_area_read(fap, off + sizeof(tlv), hash, 32);
+        }
+    }
+    return -1;
+}
+
+#if MYNEWT_VAL(BOOTUTIL_VERIFIED_MARKER)
+#define BOOT_VER_MARKER_MAGIC   0x3d6f9c52
+
+/*
+ * Written just below the image trailer once an image has fully
+ * validated.  On later boots, an intact marker whose hash matches the
+ * image's SHA256 TLV lets validation skip the full re-hash.  Uploading
+ * a new image erases the slot, which clears the marker.
+ */
+struct boot_ver_marker {
+    uint32_t vm_magic;
+    uint8_t vm_hash[32];
+    uint32_t vm_pad;            /* keeps the write a multiple of 8 */
+};
+
+static uint32_t
+boot_ver_marker_off(const struct flash_area *fap)
+{
+    uint32_t off;
+
+    off = fap->fa_size - boot_trailer_sz(flash_area_align(fap)) -
+      sizeof(struct boot_ver_marker);
+    return off & ~((uint32_t)flash_area_align(fap) - 1);
+}
+
+/*
+ * Returns 0, with the image's stored hash in 'hash', when a valid
+ * marker covers this image; the caller may then skip the full re-hash.
+ */
+static int
+boot_ver_marker_check(struct image_header *hdr, const struct flash_area *fap,
+                      uint8_t *hash)
+{
+    struct boot_ver_marker vm;
+    int rc;
+
+    if (hdr->ih_hdr_size + hdr->ih_img_size + hdr->ih_tlv_size >
+        boot_ver_marker_off(fap)) {
+        /* Image extends over the marker location. */
+        return -1;
+    }
+    rc = flash_area_read(fap, boot_ver_marker_off(fap), &vm, sizeof(vm));
+    if (rc || vm.vm_magic != BOOT_VER_MARKER_MAGIC) {
+        return -1;
+    }
+    rc = bootutil_img_find_sha256(hdr, fap, hash);
+    if (rc) {
+        return -1;
+    }
+    if (memcmp(hash, vm.vm_hash, sizeof(vm.vm_hash))) {
+        return -1;
+    }
+    return 0;
+}
+
+static void
+boot_ver_marker_write(struct image_header *hdr, const struct flash_area *fap,
+                      uint8_t *hash)
+{
+    struct boot_ver_marker vm;
+    uint32_t off;
+    int i;
+
+    off = boot_ver_marker_off(fap);
+    if (hdr->ih_hdr_size + hdr->ih_img_size + hdr->ih_tlv_size > off) {
+        return;
+    }
+    /*
+     * Only write onto erased bytes; no erase cycle is spent on the
+     * marker.
+     */
+    if (flash_area_read(fap, off, &vm, sizeof(vm))) {
+        return;
+    }
+    for (i = 0; i < sizeof(vm); i++) {
+        if (((uint8_t *)&vm)[i] != 0xff) {
+            return;
+        }
+    }
+    vm.vm_magic = BOOT_VER_MARKER_MAGIC;
+    memcpy(vm.vm_hash, hash, sizeof(vm.vm_hash));
+    vm.vm_pad = 0xffffffff;
+    flash_area_write(fap, off, &vm, sizeof(vm));
+}
+#endif
 
 /*
  * Verify the integrity of the image.
@@ -116,6 +278,19 @@ bootutil_img_validate(struct image_header *hdr, const struct flash_area *fap,
         return -1;
     }
 
+#if MYNEWT_VAL(BOOTUTIL_VERIFIED_MARKER)
+    /*
+     * A seeded hash covers loader data as well; the marker only speaks
+     * for the image itself.
+     */
+    if (seed == NULL && boot_ver_marker_check(hdr, fap, hash) == 0) {
+        if (out_hash) {
+            memcpy(out_hash, hash, 32);
+        }
+        return 0;
+    }
+#endif
+
     rc = bootutil_img_hash(hdr, fap, tmp_buf, tmp_buf_sz, hash,
                            seed, seed_len);
     if (rc) {
@@ -195,6 +370,11 @@ bootutil_img_validate(struct image_header *hdr, const struct flash_area *fap,
     if (rc) {
         return -1;
     }
+#endif
+#if MYNEWT_VAL(BOOTUTIL_VERIFIED_MARKER)
+    if (seed == NULL) {
+        boot_ver_marker_write(hdr, fap, hash);
+    }
 #endif
     return 0;
 }
@@ -34,6 +34,10 @@
 #include "bootutil/bootutil.h"
 #include "bootutil/image.h"
 #include "bootutil_priv.h"
+#if MYNEWT_VAL(BOOTUTIL_ASYNC_COPY)
+#include "os/os.h"
+#include "hal/hal_flash_async.h"
+#endif
 
 #define BOOT_MAX_IMG_SECTORS        120
 
@@ -667,6 +671,21 @@ done:
     return rc;
 }
 
+#if MYNEWT_VAL(BOOTUTIL_ASYNC_COPY)
+/* Counts free copy buffers; released from the flash worker task. */
+static struct os_sem boot_copy_sem;
+static volatile int boot_copy_werr;
+
+static void
+boot_copy_write_done(int rc, void *arg)
+{
+    if (rc != 0) {
+        boot_copy_werr = rc;
+    }
+    os_sem_release(&boot_copy_sem);
+}
+#endif
+
 /**
  * Copies the contents of one flash region to another.  You must erase the
  * destination region prior to calling this function.
@@ -691,7 +710,18 @@ boot_copy_area(int flash_area_id_src, int flash_area_id_dst,
     int chunk_sz;
     int rc;
 
-    static uint8_t buf[1024];
+#if MYNEWT_VAL(BOOTUTIL_ASYNC_COPY)
+    /*
+     * Two chunk buffers; while one is being programmed by the flash
+     * worker, the next is read from the source area.
+     */
+    static uint8_t buf[2][MYNEWT_VAL(BOOTUTIL_COPY_CHUNK_SZ)];
+    uint8_t *cbuf = buf[0];
+    int idx;
+#else
+    static uint8_t buf[MYNEWT_VAL(BOOTUTIL_COPY_CHUNK_SZ)];
+    uint8_t *cbuf = buf;
+#endif
 
     fap_src = NULL;
     fap_dst = NULL;
@@ -708,21 +738,80 @@ boot_copy_area(int flash_area_id_src, int flash_area_id_dst,
         goto done;
     }
 
+#if MYNEWT_VAL(BOOTUTIL_ASYNC_COPY)
+    /*
+     * The flash op queue is drained by a task; it can only overlap
+     * reads with writes once the scheduler is running (split images,
+     * swaps driven from the application).  The cold bootloader falls
+     * through to the synchronous loop below.
+     */
+    if (os_started()) {
+        os_sem_init(&boot_copy_sem, 2);
+        boot_copy_werr = 0;
+        idx = 0;
+        bytes_copied = 0;
+        while (bytes_copied < sz) {
+            if (sz - bytes_copied > sizeof(buf[0])) {
+                chunk_sz = sizeof(buf[0]);
+            } else {
+                chunk_sz = sz - bytes_copied;
+            }
+
+            /*
+             * Writes complete in submission order, so the buffer used
+             * two chunks ago is free once the semaphore is available.
+             */
+            os_sem_pend(&boot_copy_sem, OS_TIMEOUT_NEVER);
+            rc = flash_area_read(fap_src, off_src + bytes_copied,
+              buf[idx & 1], chunk_sz);
+            if (rc != 0) {
+                hal_flash_async_flush(OS_WAIT_FOREVER);
+                rc = BOOT_EFLASH;
+                goto done;
+            }
+            rc = hal_flash_async_write(fap_dst->fa_device_id,
+              fap_dst->fa_off + off_dst + bytes_copied, buf[idx & 1],
+              chunk_sz, boot_copy_write_done, NULL);
+            if (rc != 0) {
+                /* Queue full; write in place. */
+                rc = flash_area_write(fap_dst, off_dst + bytes_copied,
+                  buf[idx & 1], chunk_sz);
+                os_sem_release(&boot_copy_sem);
+                if (rc != 0) {
+                    hal_flash_async_flush(OS_WAIT_FOREVER);
+                    rc = BOOT_EFLASH;
+                    goto done;
+                }
+            }
+
+            idx++;
+            bytes_copied += chunk_sz;
+        }
+        hal_flash_async_flush(OS_WAIT_FOREVER);
+        if (boot_copy_werr) {
+            rc = BOOT_EFLASH;
+            goto done;
+        }
+        rc = 0;
+        goto done;
+    }
+#endif
+
     bytes_copied = 0;
     while (bytes_copied < sz) {
-        if (sz - bytes_copied > sizeof buf) {
-            chunk_sz = sizeof buf;
+        if (sz - bytes_copied > MYNEWT_VAL(BOOTUTIL_COPY_CHUNK_SZ)) {
+            chunk_sz = MYNEWT_VAL(BOOTUTIL_COPY_CHUNK_SZ);
         } else {
             chunk_sz = sz - bytes_copied;
         }
 
-        rc = flash_area_read(fap_src, off_src + bytes_copied, buf, chunk_sz);
+        rc = flash_area_read(fap_src, off_src + bytes_copied, cbuf, chunk_sz);
         if (rc != 0) {
             rc = BOOT_EFLASH;
             goto done;
         }
 
-        rc = flash_area_write(fap_dst, off_dst + bytes_copied, buf, chunk_sz);
+        rc = flash_area_write(fap_dst, off_dst + bytes_copied, cbuf, chunk_sz);
         if (rc != 0) {
             rc = BOOT_EFLASH;
             goto done;
@@ -18,6 +18,8 @@
  */
 
 #include <assert.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
 #include "defs/error.h"
 #include "bootutil/bootutil.h"
 #include "bootutil/image.h"
@@ -25,6 +27,15 @@
 #include "split/split.h"
 #include "split_priv.h"
 
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+#include "flash_map/flash_map.h"
+#endif
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "stats/stats.h"
+#endif
+
 #define LOADER_IMAGE_SLOT   0
 #define SPLIT_IMAGE_SLOT    1
 #define SPLIT_TOTAL_IMAGES  2
@@ -32,6 +43,24 @@
 static int8_t split_mode_cur;
 static int8_t split_app_active;
 
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+STATS_SECT_START(split_boot_stats)
+    STATS_SECT_ENTRY(vcache_hits)
+    STATS_SECT_ENTRY(vcache_misses)
+    STATS_SECT_ENTRY(vcache_us)
+    STATS_SECT_ENTRY(validate_us)
+STATS_SECT_END
+
+static STATS_SECT_DECL(split_boot_stats) split_boot_stats;
+
+STATS_NAME_START(split_boot_stats)
+    STATS_NAME(split_boot_stats, vcache_hits)
+    STATS_NAME(split_boot_stats, vcache_misses)
+    STATS_NAME(split_boot_stats, vcache_us)
+    STATS_NAME(split_boot_stats, validate_us)
+STATS_NAME_END(split_boot_stats)
+#endif
+
 void
 split_app_init(void)
 {
@@ -39,6 +68,15 @@ split_app_init(void)
 
     rc = split_conf_init();
     assert(rc == 0);
+
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+    rc = stats_init_and_reg(STATS_HDR(split_boot_stats),
+                            STATS_SIZE_INIT_PARMS(split_boot_stats,
+                                                  STATS_SIZE_32),
+                            STATS_NAME_INIT_PARMS(split_boot_stats),
+                            "split_boot");
+    assert(rc == 0);
+#endif
 }
 
 split_status_t
@@ -93,6 +131,64 @@ split_mode_set(split_mode_t split_mode)
     return 0;
 }
 
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+/*
+ * Reads the stored SHA256 TLV of the image in 'slot' without hashing
+ * anything.  When 'entry_val' is non-NULL, also computes the app entry
+ * address the way split_go() does.
+ */
+static int
+split_vcache_slot_hash(int slot, uint8_t *hash, uint32_t *entry_val)
+{
+    const struct flash_area *fap;
+    struct image_header hdr;
+    int rc;
+
+    rc = flash_area_open(flash_area_id_from_image_slot(slot), &fap);
+    if (rc != 0) {
+        return rc;
+    }
+    rc = flash_area_read(fap, 0, &hdr, sizeof(hdr));
+    if (rc == 0 && hdr.ih_magic != IMAGE_MAGIC) {
+        rc = -1;
+    }
+    if (rc == 0) {
+        rc = bootutil_img_find_sha256(&hdr, fap, hash);
+    }
+    if (rc == 0 && entry_val != NULL) {
+        *entry_val = fap->fa_off + hdr.ih_hdr_size;
+    }
+    flash_area_close(fap);
+    return rc;
+}
+
+/*
+ * Fast path: when the images' stored hashes match the cached,
+ * previously-validated pair, the app boots without re-hashing either
+ * image.
+ */
+static int
+split_vcache_go(void **entry)
+{
+    uint8_t cached[SPLIT_VCACHE_SZ];
+    uint8_t cur[SPLIT_VCACHE_SZ];
+    uint32_t entry_val;
+
+    if (split_vcache_get(cached) != 0) {
+        return -1;
+    }
+    if (split_vcache_slot_hash(LOADER_IMAGE_SLOT, cur, NULL) != 0 ||
+        split_vcache_slot_hash(SPLIT_IMAGE_SLOT, cur + 32, &entry_val) != 0) {
+        return -1;
+    }
+    if (memcmp(cached, cur, sizeof(cur))) {
+        return -1;
+    }
+    *entry = (void *)entry_val;
+    return 0;
+}
+#endif
+
 /**
  * This validates and provides the loader image data
  *
@@ -104,6 +200,12 @@ split_app_go(void **entry, int toboot)
     split_mode_t split_mode;
     int run_app;
     int rc;
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+    uint8_t pair[SPLIT_VCACHE_SZ];
+#endif
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+    uint32_t ts;
+#endif
 
     if (toboot) {
         split_mode = split_mode_get();
@@ -143,10 +245,49 @@ split_app_go(void **entry, int toboot)
         }
     }
 
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+    ts = os_cputime_get32();
+#endif
+    rc = split_vcache_go(entry);
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+    STATS_INCN(split_boot_stats, vcache_us,
+               os_cputime_ticks_to_usecs(os_cputime_get32() - ts));
+#endif
+    if (rc == 0) {
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+        STATS_INC(split_boot_stats, vcache_hits);
+#endif
+        return 0;
+    }
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+    STATS_INC(split_boot_stats, vcache_misses);
+#endif
+#endif
+
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+    ts = os_cputime_get32();
+#endif
     rc = split_go(LOADER_IMAGE_SLOT, SPLIT_IMAGE_SLOT, entry);
+#if MYNEWT_VAL(SPLIT_BOOT_STATS)
+    STATS_INCN(split_boot_stats, validate_us,
+               os_cputime_ticks_to_usecs(os_cputime_get32() - ts));
+#endif
     if (rc != 0) {
         /* Images don't match; clear split status. */
         split_write_split(SPLIT_MODE_LOADER);
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+        split_write_vcache(NULL);
+    } else {
+        /*
+         * The TLVs were just checked against the computed hashes;
+         * cache the pair so the next boot skips the re-hash.
+         */
+        if (split_vcache_slot_hash(LOADER_IMAGE_SLOT, pair, NULL) == 0 &&
+            split_vcache_slot_hash(SPLIT_IMAGE_SLOT, pair + 32, NULL) == 0) {
+            split_write_vcache(pair);
+        }
+#endif
     }
 
     return rc;
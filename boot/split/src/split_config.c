@@ -28,6 +28,11 @@
 #define SPLIT_IMAGE_SLOT    1
 #define SPLIT_TOTAL_IMAGES  2
 
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+static uint8_t split_vcache[SPLIT_VCACHE_SZ];
+static uint8_t split_vcache_set;
+#endif
+
 static char *split_conf_get(int argc, char **argv, char *buf, int max_len);
 static int split_conf_set(int argc, char **argv, char *val);
 static int split_conf_commit(void);
@@ -62,6 +67,15 @@ split_conf_get(int argc, char **argv, char *buf, int max_len)
             split_mode = split_mode_get();
             return conf_str_from_value(CONF_INT8, &split_mode, buf, max_len);
         }
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+        if (!strcmp(argv[0], "vhash")) {
+            if (!split_vcache_set) {
+                return NULL;
+            }
+            return conf_str_from_bytes(split_vcache, sizeof(split_vcache),
+                                       buf, max_len);
+        }
+#endif
     }
     return NULL;
 }
@@ -86,6 +100,24 @@ split_conf_set(int argc, char **argv, char *val)
 
             return 0;
         }
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+        if (!strcmp(argv[0], "vhash")) {
+            int len;
+
+            if (!val) {
+                split_vcache_set = 0;
+                return 0;
+            }
+            len = sizeof(split_vcache);
+            rc = conf_bytes_from_str(val, split_vcache, &len);
+            if (rc != 0 || len != sizeof(split_vcache)) {
+                split_vcache_set = 0;
+                return -1;
+            }
+            split_vcache_set = 1;
+            return 0;
+        }
+#endif
     }
     return -1;
 }
@@ -105,6 +137,15 @@ split_conf_export(void (*func)(char *name, char *val), enum conf_export_tgt tgt)
     split_mode = split_mode_get();
     conf_str_from_value(CONF_INT8, &split_mode, buf, sizeof(buf));
     func("split/status", buf);
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+    if (split_vcache_set) {
+        char vbuf[CONF_STR_FROM_BYTES_LEN(SPLIT_VCACHE_SZ)];
+
+        conf_str_from_bytes(split_vcache, sizeof(split_vcache), vbuf,
+                            sizeof(vbuf));
+        func("split/vhash", vbuf);
+    }
+#endif
     return 0;
 }
 
@@ -124,3 +165,40 @@ split_write_split(split_mode_t split_mode)
     }
     return conf_save_one("split/status", str);
 }
+
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+int
+split_vcache_get(uint8_t *pair)
+{
+    if (!split_vcache_set) {
+        return -1;
+    }
+    memcpy(pair, split_vcache, sizeof(split_vcache));
+    return 0;
+}
+
+int
+split_write_vcache(const uint8_t *pair)
+{
+    char str[CONF_STR_FROM_BYTES_LEN(SPLIT_VCACHE_SZ)];
+
+    if (!pair) {
+        if (!split_vcache_set) {
+            return 0;
+        }
+        split_vcache_set = 0;
+        return conf_save_one("split/vhash", NULL);
+    }
+    if (split_vcache_set && !memcmp(pair, split_vcache, sizeof(split_vcache))) {
+        return 0;
+    }
+    memcpy(split_vcache, pair, sizeof(split_vcache));
+    split_vcache_set = 1;
+
+    if (!conf_str_from_bytes(split_vcache, sizeof(split_vcache), str,
+                             sizeof(str))) {
+        return -1;
+    }
+    return conf_save_one("split/vhash", str);
+}
+#endif
@@ -20,6 +20,7 @@
 #ifndef SPLIT_PRIV_H
 #define SPLIT_PRIV_H
 
+#include "syscfg/syscfg.h"
 #include "bootutil/bootutil.h"
 
 #ifdef __cplusplus
@@ -30,6 +31,14 @@ int split_conf_init(void);
 int split_nmgr_register(void);
 int split_read_split(split_mode_t *split);
 
+#if MYNEWT_VAL(SPLIT_VALIDATION_CACHE)
+/* Loader hash followed by app hash. */
+#define SPLIT_VCACHE_SZ     64
+
+int split_vcache_get(uint8_t *pair);
+int split_write_vcache(const uint8_t *pair);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
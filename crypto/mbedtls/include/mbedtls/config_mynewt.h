@@ -28,10 +28,83 @@
 #ifndef MBEDTLS_CONFIG_MYNEWT_H
 #define MBEDTLS_CONFIG_MYNEWT_H
 
+#include "syscfg/syscfg.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if MYNEWT_VAL(MBEDTLS_MN_MEMPOOL)
+/* All allocations routed through the os_mempool backend in mn_tls.c. */
+#define MBEDTLS_PLATFORM_MEMORY
+#endif
+
+#if MYNEWT_VAL(MBEDTLS_MN_TLS_PROFILE_MIN)
+/*
+ * Trimmed TLS 1.2 client profile: a single ECDHE-ECDSA AES-GCM suite
+ * over the NIST P-256/P-384 curves, with small I/O buffers.  Cuts the
+ * code for RSA, DHM, the legacy ciphers and the pre-1.2 protocol
+ * versions, and shrinks the dominant per-connection allocations (the
+ * two record buffers) from 16 KB each to MBEDTLS_MN_TLS_CONTENT_LEN.
+ * The server must support max_fragment_length or keep its records
+ * within the configured content length.
+ */
+#define MBEDTLS_SSL_MAX_CONTENT_LEN MYNEWT_VAL(MBEDTLS_MN_TLS_CONTENT_LEN)
+#define MBEDTLS_SSL_CIPHERSUITES                        \
+    MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,    \
+    MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384
+
+#undef MBEDTLS_SSL_SRV_C
+#undef MBEDTLS_SSL_PROTO_SSL3
+#undef MBEDTLS_SSL_PROTO_TLS1
+#undef MBEDTLS_SSL_PROTO_TLS1_1
+#undef MBEDTLS_SSL_PROTO_DTLS
+#undef MBEDTLS_SSL_DTLS_ANTI_REPLAY
+#undef MBEDTLS_SSL_DTLS_HELLO_VERIFY
+#undef MBEDTLS_SSL_DTLS_CLIENT_PORT_REUSE
+#undef MBEDTLS_SSL_DTLS_BADMAC_LIMIT
+#undef MBEDTLS_SSL_COOKIE_C
+#undef MBEDTLS_SSL_RENEGOTIATION
+#undef MBEDTLS_SSL_CBC_RECORD_SPLITTING
+
+#undef MBEDTLS_KEY_EXCHANGE_PSK_ENABLED
+#undef MBEDTLS_KEY_EXCHANGE_DHE_PSK_ENABLED
+#undef MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED
+#undef MBEDTLS_KEY_EXCHANGE_RSA_PSK_ENABLED
+#undef MBEDTLS_KEY_EXCHANGE_RSA_ENABLED
+#undef MBEDTLS_KEY_EXCHANGE_DHE_RSA_ENABLED
+#undef MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED
+#undef MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED
+#undef MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED
+
+#undef MBEDTLS_RSA_C
+#undef MBEDTLS_PKCS1_V15
+#undef MBEDTLS_PKCS1_V21
+#undef MBEDTLS_X509_RSASSA_PSS_SUPPORT
+#undef MBEDTLS_DHM_C
+#undef MBEDTLS_GENPRIME
+#undef MBEDTLS_ARC4_C
+#undef MBEDTLS_BLOWFISH_C
+#undef MBEDTLS_CAMELLIA_C
+#undef MBEDTLS_DES_C
+#undef MBEDTLS_XTEA_C
+#undef MBEDTLS_RIPEMD160_C
+
+#undef MBEDTLS_ECP_DP_SECP192R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP224R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP521R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP192K1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP224K1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP256K1_ENABLED
+#undef MBEDTLS_ECP_DP_BP256R1_ENABLED
+#undef MBEDTLS_ECP_DP_BP384R1_ENABLED
+#undef MBEDTLS_ECP_DP_BP512R1_ENABLED
+#undef MBEDTLS_ECP_DP_CURVE25519_ENABLED
+
+#define MBEDTLS_ECP_MAX_BITS    384
+#define MBEDTLS_MPI_MAX_SIZE    48
+#endif /* MBEDTLS_MN_TLS_PROFILE_MIN */
+
 #undef MBEDTLS_HAVE_TIME /* we have no time.h */
 #undef MBEDTLS_HAVE_TIME_DATE
 #define MBEDTLS_PLATFORM_PRINTF_ALT	console_print
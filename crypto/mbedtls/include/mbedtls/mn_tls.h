@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef MN_TLS_H
+#define MN_TLS_H
+
+#include "mbedtls/ssl.h"
+#include "mbedtls/ecp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Mynewt glue for mbedTLS: a config-store backed session cache
+ * (MBEDTLS_MN_SESS_CACHE), a background ECDHE precompute pool
+ * (MBEDTLS_ECDH_PRECOMPUTE) and an os_mempool allocation backend
+ * (MBEDTLS_MN_MEMPOOL, wired up automatically at init; no API).
+ */
+
+/**
+ * Saves the established session of 'ssl' for later resumption and
+ * persists it in the config store.  Call after a successful handshake.
+ *
+ * @return 0 on success, nonzero on failure.
+ */
+int mn_tls_sess_save(const mbedtls_ssl_context *ssl);
+
+/**
+ * Arms 'ssl' with the cached session so the next handshake is
+ * abbreviated.  Call after mbedtls_ssl_setup(), before the handshake.
+ *
+ * @return 0 on success, nonzero if no session is cached.
+ */
+int mn_tls_sess_restore(mbedtls_ssl_context *ssl);
+
+/**
+ * Drops the cached session, in RAM and in the config store.
+ */
+void mn_tls_sess_clear(void);
+
+/**
+ * Starts the ECDH precompute task.  'f_rng'/'p_rng' are the RNG the
+ * application also hands to the TLS stack.
+ *
+ * @return 0 on success, nonzero on failure.
+ */
+int mn_tls_ecdh_start(int (*f_rng)(void *, unsigned char *, size_t),
+                      void *p_rng);
+
+/**
+ * Takes a precomputed keypair for curve 'gid' from the pool.  Called
+ * by mbedtls_ecdh_gen_public(); not normally used directly.
+ *
+ * @return 0 on success, nonzero if the pool is empty or serves a
+ *         different curve.
+ */
+int mn_tls_ecdh_take(mbedtls_ecp_group_id gid, mbedtls_mpi *d,
+                     mbedtls_ecp_point *Q);
+
+void mn_tls_pkg_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MN_TLS_H */
@@ -38,6 +38,11 @@
 
 #include <string.h>
 
+#include "syscfg/syscfg.h"
+#if MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE)
+#include "mbedtls/mn_tls.h"
+#endif
+
 /*
  * Generate public key: simple wrapper around mbedtls_ecp_gen_keypair
  */
@@ -45,6 +50,10 @@ int mbedtls_ecdh_gen_public( mbedtls_ecp_group *grp, mbedtls_mpi *d, mbedtls_ecp
                      int (*f_rng)(void *, unsigned char *, size_t),
                      void *p_rng )
 {
+#if MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE)
+    if( mn_tls_ecdh_take( grp->id, d, Q ) == 0 )
+        return( 0 );
+#endif
     return mbedtls_ecp_gen_keypair( grp, d, Q, f_rng, p_rng );
 }
 
@@ -0,0 +1,448 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+#include "mbedtls/mn_tls.h"
+
+#if MYNEWT_VAL(MBEDTLS_MN_SESS_CACHE)
+#include "config/config.h"
+#endif
+#if MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE)
+#include "os/os.h"
+#endif
+#if MYNEWT_VAL(MBEDTLS_MN_MEMPOOL)
+#include <assert.h>
+#include "os/os.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/ssl_internal.h"
+#endif
+
+#if MYNEWT_VAL(MBEDTLS_MN_MEMPOOL)
+/*
+ * os_mempool backend for mbedtls_calloc()/mbedtls_free(), replacing
+ * heap allocation with three fixed size classes: small covers bignum
+ * limbs, points and cipher contexts; medium covers handshake state and
+ * X.509 parsing (certificate DER images are the largest customers);
+ * large is sized exactly for the per-connection record buffers.  An
+ * exhausted class falls through to the next larger one, and frees are
+ * routed back by block address, so a borrowed larger block is returned
+ * correctly.  Allocation failure is reported to mbedTLS as NULL, which
+ * it propagates as MBEDTLS_ERR_*_ALLOC_FAILED.
+ */
+#define MN_TLS_MEM_SMALL_SZ     MYNEWT_VAL(MBEDTLS_MN_MEMPOOL_SMALL_SZ)
+#define MN_TLS_MEM_MED_SZ       MYNEWT_VAL(MBEDTLS_MN_MEMPOOL_MED_SZ)
+#define MN_TLS_MEM_LARGE_SZ     MBEDTLS_SSL_BUFFER_LEN
+
+static struct os_mempool mn_tls_mem_small;
+static struct os_mempool mn_tls_mem_med;
+static struct os_mempool mn_tls_mem_large;
+
+static os_membuf_t mn_tls_mem_small_buf[
+    OS_MEMPOOL_SIZE(MYNEWT_VAL(MBEDTLS_MN_MEMPOOL_SMALL_COUNT),
+                    MN_TLS_MEM_SMALL_SZ)];
+static os_membuf_t mn_tls_mem_med_buf[
+    OS_MEMPOOL_SIZE(MYNEWT_VAL(MBEDTLS_MN_MEMPOOL_MED_COUNT),
+                    MN_TLS_MEM_MED_SZ)];
+static os_membuf_t mn_tls_mem_large_buf[
+    OS_MEMPOOL_SIZE(MYNEWT_VAL(MBEDTLS_MN_MEMPOOL_LARGE_COUNT),
+                    MN_TLS_MEM_LARGE_SZ)];
+
+static void *
+mn_tls_mem_calloc(size_t n, size_t size)
+{
+    size_t total;
+    void *blk;
+
+    if (size != 0 && n > MN_TLS_MEM_LARGE_SZ / size) {
+        return NULL;
+    }
+    total = n * size;
+
+    blk = NULL;
+    if (total <= MN_TLS_MEM_SMALL_SZ) {
+        blk = os_memblock_get(&mn_tls_mem_small);
+    }
+    if (blk == NULL && total <= MN_TLS_MEM_MED_SZ) {
+        blk = os_memblock_get(&mn_tls_mem_med);
+    }
+    if (blk == NULL) {
+        blk = os_memblock_get(&mn_tls_mem_large);
+    }
+    if (blk != NULL) {
+        memset(blk, 0, total);
+    }
+    return blk;
+}
+
+static void
+mn_tls_mem_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    if (os_memblock_from(&mn_tls_mem_small, ptr)) {
+        os_memblock_put(&mn_tls_mem_small, ptr);
+    } else if (os_memblock_from(&mn_tls_mem_med, ptr)) {
+        os_memblock_put(&mn_tls_mem_med, ptr);
+    } else {
+        assert(os_memblock_from(&mn_tls_mem_large, ptr));
+        os_memblock_put(&mn_tls_mem_large, ptr);
+    }
+}
+
+static void
+mn_tls_mem_init(void)
+{
+    int rc;
+
+    rc = os_mempool_init(&mn_tls_mem_small,
+                         MYNEWT_VAL(MBEDTLS_MN_MEMPOOL_SMALL_COUNT),
+                         MN_TLS_MEM_SMALL_SZ, mn_tls_mem_small_buf,
+                         "mbedtls_small");
+    assert(rc == 0);
+    rc = os_mempool_init(&mn_tls_mem_med,
+                         MYNEWT_VAL(MBEDTLS_MN_MEMPOOL_MED_COUNT),
+                         MN_TLS_MEM_MED_SZ, mn_tls_mem_med_buf,
+                         "mbedtls_med");
+    assert(rc == 0);
+    rc = os_mempool_init(&mn_tls_mem_large,
+                         MYNEWT_VAL(MBEDTLS_MN_MEMPOOL_LARGE_COUNT),
+                         MN_TLS_MEM_LARGE_SZ, mn_tls_mem_large_buf,
+                         "mbedtls_large");
+    assert(rc == 0);
+
+    mbedtls_platform_set_calloc_free(mn_tls_mem_calloc, mn_tls_mem_free);
+}
+#endif /* MBEDTLS_MN_MEMPOOL */
+
+#if MYNEWT_VAL(MBEDTLS_MN_SESS_CACHE)
+/*
+ * Flat image of the resumable parts of an mbedtls_ssl_session; the
+ * ticket, when present, follows the struct.
+ */
+struct mn_tls_sess {
+    int32_t ciphersuite;
+    uint32_t verify_result;
+    uint32_t ticket_lifetime;
+    uint16_t ticket_len;
+    uint8_t compression;
+    uint8_t id_len;
+    uint8_t id[32];
+    uint8_t master[48];
+};
+
+static uint8_t mn_tls_sess_buf[sizeof(struct mn_tls_sess) +
+                               MYNEWT_VAL(MBEDTLS_MN_SESS_TICKET_MAX)];
+static uint16_t mn_tls_sess_len;
+
+static char *mn_tls_conf_get(int argc, char **argv, char *buf, int max_len);
+static int mn_tls_conf_set(int argc, char **argv, char *val);
+static int mn_tls_conf_commit(void);
+static int mn_tls_conf_export(void (*func)(char *name, char *val),
+  enum conf_export_tgt tgt);
+
+static struct conf_handler mn_tls_conf_handler = {
+    .ch_name = "mn_tls",
+    .ch_get = mn_tls_conf_get,
+    .ch_set = mn_tls_conf_set,
+    .ch_commit = mn_tls_conf_commit,
+    .ch_export = mn_tls_conf_export
+};
+
+static char *
+mn_tls_conf_get(int argc, char **argv, char *buf, int max_len)
+{
+    if (argc == 1 && !strcmp(argv[0], "sess")) {
+        if (!mn_tls_sess_len) {
+            return NULL;
+        }
+        return conf_str_from_bytes(mn_tls_sess_buf, mn_tls_sess_len,
+                                   buf, max_len);
+    }
+    return NULL;
+}
+
+static int
+mn_tls_conf_set(int argc, char **argv, char *val)
+{
+    int len;
+    int rc;
+
+    if (argc == 1 && !strcmp(argv[0], "sess")) {
+        if (!val) {
+            mn_tls_sess_len = 0;
+            return 0;
+        }
+        len = sizeof(mn_tls_sess_buf);
+        rc = conf_bytes_from_str(val, mn_tls_sess_buf, &len);
+        if (rc != 0 || len < sizeof(struct mn_tls_sess)) {
+            mn_tls_sess_len = 0;
+            return -1;
+        }
+        mn_tls_sess_len = len;
+        return 0;
+    }
+    return -1;
+}
+
+static int
+mn_tls_conf_commit(void)
+{
+    return 0;
+}
+
+static int
+mn_tls_conf_export(void (*func)(char *name, char *val),
+  enum conf_export_tgt tgt)
+{
+    char buf[CONF_STR_FROM_BYTES_LEN(sizeof(mn_tls_sess_buf))];
+
+    if (mn_tls_sess_len) {
+        conf_str_from_bytes(mn_tls_sess_buf, mn_tls_sess_len, buf,
+                            sizeof(buf));
+        func("mn_tls/sess", buf);
+    }
+    return 0;
+}
+
+int
+mn_tls_sess_save(const mbedtls_ssl_context *ssl)
+{
+    char str[CONF_STR_FROM_BYTES_LEN(sizeof(mn_tls_sess_buf))];
+    struct mn_tls_sess *ms;
+    mbedtls_ssl_session sess;
+    int rc;
+
+    mbedtls_ssl_session_init(&sess);
+    rc = mbedtls_ssl_get_session(ssl, &sess);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ms = (struct mn_tls_sess *)mn_tls_sess_buf;
+    memset(ms, 0, sizeof(*ms));
+    ms->ciphersuite = sess.ciphersuite;
+    ms->verify_result = sess.verify_result;
+    ms->compression = sess.compression;
+    ms->id_len = sess.id_len;
+    memcpy(ms->id, sess.id, sizeof(ms->id));
+    memcpy(ms->master, sess.master, sizeof(ms->master));
+    mn_tls_sess_len = sizeof(*ms);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+    if (sess.ticket &&
+        sess.ticket_len <= MYNEWT_VAL(MBEDTLS_MN_SESS_TICKET_MAX)) {
+        ms->ticket_len = sess.ticket_len;
+        ms->ticket_lifetime = sess.ticket_lifetime;
+        memcpy(mn_tls_sess_buf + sizeof(*ms), sess.ticket, sess.ticket_len);
+        mn_tls_sess_len += sess.ticket_len;
+    }
+#endif
+    mbedtls_ssl_session_free(&sess);
+
+    if (!conf_str_from_bytes(mn_tls_sess_buf, mn_tls_sess_len, str,
+                             sizeof(str))) {
+        return -1;
+    }
+    return conf_save_one("mn_tls/sess", str);
+}
+
+int
+mn_tls_sess_restore(mbedtls_ssl_context *ssl)
+{
+    struct mn_tls_sess *ms;
+    mbedtls_ssl_session sess;
+
+    if (mn_tls_sess_len < sizeof(*ms)) {
+        return -1;
+    }
+    ms = (struct mn_tls_sess *)mn_tls_sess_buf;
+    if (mn_tls_sess_len != sizeof(*ms) + ms->ticket_len) {
+        return -1;
+    }
+
+    /*
+     * mbedtls_ssl_set_session() deep-copies the session, so the
+     * temporary may point straight into the cache buffer.
+     */
+    mbedtls_ssl_session_init(&sess);
+    sess.ciphersuite = ms->ciphersuite;
+    sess.verify_result = ms->verify_result;
+    sess.compression = ms->compression;
+    sess.id_len = ms->id_len;
+    memcpy(sess.id, ms->id, sizeof(sess.id));
+    memcpy(sess.master, ms->master, sizeof(sess.master));
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+    if (ms->ticket_len) {
+        sess.ticket = mn_tls_sess_buf + sizeof(*ms);
+        sess.ticket_len = ms->ticket_len;
+        sess.ticket_lifetime = ms->ticket_lifetime;
+    }
+#endif
+    return mbedtls_ssl_set_session(ssl, &sess);
+}
+
+void
+mn_tls_sess_clear(void)
+{
+    if (mn_tls_sess_len) {
+        mn_tls_sess_len = 0;
+        conf_save_one("mn_tls/sess", NULL);
+    }
+}
+#endif /* MBEDTLS_MN_SESS_CACHE */
+
+#if MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE)
+static struct {
+    mbedtls_mpi d;
+    mbedtls_ecp_point Q;
+    uint8_t full;
+} mn_ecdh_pool[MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE_POOL)];
+
+static mbedtls_ecp_group mn_ecdh_grp;
+static int (*mn_ecdh_f_rng)(void *, unsigned char *, size_t);
+static void *mn_ecdh_p_rng;
+static uint8_t mn_ecdh_running;
+
+static struct os_mutex mn_ecdh_mtx;
+static struct os_sem mn_ecdh_refill;
+static struct os_task mn_ecdh_task;
+static os_stack_t mn_ecdh_stack[
+    OS_STACK_ALIGN(MYNEWT_VAL(MBEDTLS_ECDH_STACK_SIZE))];
+
+static void
+mn_tls_ecdh_worker(void *arg)
+{
+    int i;
+
+    while (1) {
+        os_sem_pend(&mn_ecdh_refill, OS_TIMEOUT_NEVER);
+
+        os_mutex_pend(&mn_ecdh_mtx, OS_TIMEOUT_NEVER);
+        for (i = 0; i < MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE_POOL); i++) {
+            if (!mn_ecdh_pool[i].full) {
+                break;
+            }
+        }
+        os_mutex_release(&mn_ecdh_mtx);
+        if (i >= MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE_POOL)) {
+            continue;
+        }
+
+        /*
+         * Only this task writes non-full slots, so the scalar
+         * multiplication runs without holding the pool mutex.
+         */
+        if (mbedtls_ecp_gen_keypair(&mn_ecdh_grp, &mn_ecdh_pool[i].d,
+                                    &mn_ecdh_pool[i].Q, mn_ecdh_f_rng,
+                                    mn_ecdh_p_rng) != 0) {
+            continue;
+        }
+
+        os_mutex_pend(&mn_ecdh_mtx, OS_TIMEOUT_NEVER);
+        mn_ecdh_pool[i].full = 1;
+        os_mutex_release(&mn_ecdh_mtx);
+    }
+}
+
+int
+mn_tls_ecdh_start(int (*f_rng)(void *, unsigned char *, size_t), void *p_rng)
+{
+    int i;
+    int rc;
+
+    if (mn_ecdh_running) {
+        return 0;
+    }
+
+    mbedtls_ecp_group_init(&mn_ecdh_grp);
+    rc = mbedtls_ecp_group_load(&mn_ecdh_grp,
+                                MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE_CURVE));
+    if (rc != 0) {
+        return rc;
+    }
+    for (i = 0; i < MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE_POOL); i++) {
+        mbedtls_mpi_init(&mn_ecdh_pool[i].d);
+        mbedtls_ecp_point_init(&mn_ecdh_pool[i].Q);
+    }
+    mn_ecdh_f_rng = f_rng;
+    mn_ecdh_p_rng = p_rng;
+
+    os_mutex_init(&mn_ecdh_mtx);
+    os_sem_init(&mn_ecdh_refill, MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE_POOL));
+    rc = os_task_init(&mn_ecdh_task, "tls_ecdh", mn_tls_ecdh_worker, NULL,
+                      MYNEWT_VAL(MBEDTLS_ECDH_TASK_PRIO), OS_WAIT_FOREVER,
+                      mn_ecdh_stack,
+                      OS_STACK_ALIGN(MYNEWT_VAL(MBEDTLS_ECDH_STACK_SIZE)));
+    if (rc != 0) {
+        return rc;
+    }
+    mn_ecdh_running = 1;
+    return 0;
+}
+
+int
+mn_tls_ecdh_take(mbedtls_ecp_group_id gid, mbedtls_mpi *d,
+                 mbedtls_ecp_point *Q)
+{
+    int i;
+    int rc;
+
+    if (!mn_ecdh_running || gid != mn_ecdh_grp.id || !os_started()) {
+        return -1;
+    }
+
+    rc = -1;
+    os_mutex_pend(&mn_ecdh_mtx, OS_TIMEOUT_NEVER);
+    for (i = 0; i < MYNEWT_VAL(MBEDTLS_ECDH_PRECOMPUTE_POOL); i++) {
+        if (!mn_ecdh_pool[i].full) {
+            continue;
+        }
+        if (mbedtls_mpi_copy(d, &mn_ecdh_pool[i].d) != 0 ||
+            mbedtls_ecp_copy(Q, &mn_ecdh_pool[i].Q) != 0) {
+            break;
+        }
+        mbedtls_mpi_free(&mn_ecdh_pool[i].d);
+        mbedtls_ecp_point_free(&mn_ecdh_pool[i].Q);
+        mbedtls_mpi_init(&mn_ecdh_pool[i].d);
+        mbedtls_ecp_point_init(&mn_ecdh_pool[i].Q);
+        mn_ecdh_pool[i].full = 0;
+        rc = 0;
+        break;
+    }
+    os_mutex_release(&mn_ecdh_mtx);
+
+    if (rc == 0) {
+        os_sem_release(&mn_ecdh_refill);
+    }
+    return rc;
+}
+#endif /* MBEDTLS_ECDH_PRECOMPUTE */
+
+void
+mn_tls_pkg_init(void)
+{
+#if MYNEWT_VAL(MBEDTLS_MN_MEMPOOL)
+    mn_tls_mem_init();
+#endif
+#if MYNEWT_VAL(MBEDTLS_MN_SESS_CACHE)
+    conf_register(&mn_tls_conf_handler);
+#endif
+}
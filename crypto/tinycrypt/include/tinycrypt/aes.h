@@ -95,6 +95,23 @@ int32_t tc_aes_encrypt(uint8_t *out,
 		       const uint8_t *in,
 		       const TCAesKeySched_t s);
 
+/**
+ *  @brief AES-128 Encryption of consecutive blocks
+ *  Encrypts blocks consecutive 16 byte blocks from in into out under
+ *              key schedule s
+ *  @note Hands the whole run to a hardware AES engine in one call when
+ *              one is configured; otherwise encrypts block by block
+ *  @return  returns TC_SUCCESS (1)
+ *           returns TC_FAIL (0) if: out == NULL or in == NULL or s == NULL
+ *  @param out IN/OUT -- buffer to receive the ciphertext blocks; may
+ *              equal in
+ *  @param in IN -- the plaintext blocks to encrypt
+ *  @param blocks IN -- number of 16 byte blocks
+ *  @param s IN -- initialized AES key schedule
+ */
+int32_t tc_aes_encrypt_multi(uint8_t *out, const uint8_t *in, uint32_t blocks,
+			     const TCAesKeySched_t s);
+
 /**
  *  @brief Set the AES-128 decryption key
  *  Uses key k to initialize s
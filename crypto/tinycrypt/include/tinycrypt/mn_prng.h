@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __MN_PRNG_H__
+#define __MN_PRNG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+/*
+ * Mynewt glue around tinycrypt's HMAC-PRNG, enabled with the
+ * TINYCRYPT_HMAC_PRNG_TRNG syscfg setting.  The PRNG is seeded and
+ * reseeded from the hal_trng entropy cache, which gathers entropy
+ * from the TRNG interrupt ahead of demand, so generating key material
+ * never stalls on the peripheral's generation time.
+ */
+
+/**
+ * Seeds the package PRNG from the hal_trng entropy cache.  Call once
+ * after hal_trng_init(); 'personalization' should be device-unique
+ * data (e.g. the device address) and must be non-NULL.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int mn_prng_init(const uint8_t *personalization, uint16_t plen);
+
+/**
+ * Fills 'out' with 'len' bytes of PRNG output, transparently
+ * reseeding from the entropy cache when tinycrypt asks for it.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int mn_prng_generate(uint8_t *out, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MN_PRNG_H__ */
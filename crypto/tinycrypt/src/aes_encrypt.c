@@ -34,6 +34,11 @@
 #include <tinycrypt/utils.h>
 #include <tinycrypt/constants.h>
 
+#include <syscfg/syscfg.h>
+#if MYNEWT_VAL(TINYCRYPT_AES_HAL)
+#include <hal/hal_crypto.h>
+#endif
+
 static const uint8_t sbox[256] = {
 	0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b,
 	0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0,
@@ -67,6 +72,33 @@ static inline uint32_t rotword(uint32_t a)
 #define subbyte(a, o)(sbox[((a) >> (o))&0xff] << (o))
 #define subword(a)(subbyte(a, 24)|subbyte(a, 16)|subbyte(a, 8)|subbyte(a, 0))
 
+#if MYNEWT_VAL(TINYCRYPT_AES_HAL)
+/* Schedule whose key is currently loaded in the AES engine. */
+static TCAesKeySched_t tc_aes_hal_sched;
+
+static int32_t tc_aes_hal_load(const TCAesKeySched_t s)
+{
+	uint8_t key[HAL_AES_KEY_128_LEN];
+	uint32_t i;
+
+	if (s == tc_aes_hal_sched) {
+		return TC_SUCCESS;
+	}
+	/* The first round key is the raw key. */
+	for (i = 0; i < Nk; ++i) {
+		key[Nb*i] = (uint8_t)(s->words[i] >> 24);
+		key[Nb*i+1] = (uint8_t)(s->words[i] >> 16);
+		key[Nb*i+2] = (uint8_t)(s->words[i] >> 8);
+		key[Nb*i+3] = (uint8_t)(s->words[i]);
+	}
+	if (hal_aes_set_key(key, sizeof(key)) != 0) {
+		return TC_FAIL;
+	}
+	tc_aes_hal_sched = s;
+	return TC_SUCCESS;
+}
+#endif
+
 int32_t tc_aes128_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k)
 {
 	const uint32_t rconst[11] = {
@@ -82,6 +114,13 @@ int32_t tc_aes128_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k)
 		return TC_FAIL;
 	}
 
+#if MYNEWT_VAL(TINYCRYPT_AES_HAL)
+	/* The key behind this schedule is changing. */
+	if (s == tc_aes_hal_sched) {
+		tc_aes_hal_sched = (TCAesKeySched_t) 0;
+	}
+#endif
+
 	for (i = 0; i < Nk; ++i) {
 		s->words[i] = (k[Nb*i]<<24) | (k[Nb*i+1]<<16) |
 			      (k[Nb*i+2]<<8) | (k[Nb*i+3]);
@@ -168,6 +207,16 @@ int32_t tc_aes_encrypt(uint8_t *out, const uint8_t *in, const TCAesKeySched_t s)
 		return TC_FAIL;
 	}
 
+#if MYNEWT_VAL(TINYCRYPT_AES_HAL)
+	if (tc_aes_hal_load(s) == TC_SUCCESS) {
+		if (hal_aes_ecb_encrypt(in, out, 1) == 0) {
+			return TC_SUCCESS;
+		}
+		/* Engine balked; fall back to the software rounds. */
+		tc_aes_hal_sched = (TCAesKeySched_t) 0;
+	}
+#endif
+
 	(void)_copy(state, sizeof(state), in, sizeof(state));
 	add_round_key(state, s->words);
 
@@ -189,3 +238,32 @@ int32_t tc_aes_encrypt(uint8_t *out, const uint8_t *in, const TCAesKeySched_t s)
 
 	return TC_SUCCESS;
 }
+
+int32_t tc_aes_encrypt_multi(uint8_t *out, const uint8_t *in, uint32_t blocks,
+			     const TCAesKeySched_t s)
+{
+	uint32_t i;
+
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    s == (TCAesKeySched_t) 0) {
+		return TC_FAIL;
+	}
+
+#if MYNEWT_VAL(TINYCRYPT_AES_HAL)
+	if (tc_aes_hal_load(s) == TC_SUCCESS) {
+		if (hal_aes_ecb_encrypt(in, out, blocks) == 0) {
+			return TC_SUCCESS;
+		}
+		tc_aes_hal_sched = (TCAesKeySched_t) 0;
+	}
+#endif
+
+	for (i = 0; i < blocks; ++i) {
+		if (!tc_aes_encrypt(out + i*TC_AES_BLOCK_SIZE,
+				    in + i*TC_AES_BLOCK_SIZE, s)) {
+			return TC_FAIL;
+		}
+	}
+	return TC_SUCCESS;
+}
@@ -90,14 +90,19 @@ static void ccm_cbc_mac(uint8_t *T, const uint8_t *data, uint32_t dlen,
  * encryption). Besides, it is assumed that the counter is stored in the last
  * 2 bytes of the nonce.
  */
+/* counter blocks batched per tc_aes_encrypt_multi() call */
+#define CCM_CTR_BATCH 4
+
 static int32_t ccm_ctr_mode(uint8_t *out, uint32_t outlen, const uint8_t *in,
 			     uint32_t inlen, uint8_t *ctr, const TCAesKeySched_t sched)
 {
 
-	uint8_t buffer[TC_AES_BLOCK_SIZE];
+	uint8_t buffer[TC_AES_BLOCK_SIZE * CCM_CTR_BATCH];
 	uint8_t nonce[TC_AES_BLOCK_SIZE];
 	uint16_t block_num;
+	uint32_t blocks;
 	uint32_t i;
+	uint32_t n;
 
 	/* input sanity check: */
 	if (out == (uint8_t *) 0 ||
@@ -115,17 +120,30 @@ static int32_t ccm_ctr_mode(uint8_t *out, uint32_t outlen, const uint8_t *in,
 
 	/* select the last 2 bytes of the nonce to be incremented */
 	block_num = (uint16_t) ((nonce[14] << 8)|(nonce[15]));
-	for (i = 0; i < inlen; ++i) {
-		if ((i % (TC_AES_BLOCK_SIZE)) == 0) {
+	i = 0;
+	while (i < inlen) {
+		/* stage a batch of counter blocks, encrypt them in one go */
+		blocks = ((inlen - i) + TC_AES_BLOCK_SIZE - 1) /
+			 TC_AES_BLOCK_SIZE;
+		if (blocks > CCM_CTR_BATCH) {
+			blocks = CCM_CTR_BATCH;
+		}
+		for (n = 0; n < blocks; ++n) {
 			block_num++;
 			nonce[14] = (uint8_t)(block_num >> 8);
 			nonce[15] = (uint8_t)(block_num);
-			if (!tc_aes_encrypt(buffer, nonce, sched)) {
-				return TC_FAIL;
-			}
+			(void) _copy(&buffer[n * TC_AES_BLOCK_SIZE],
+				     TC_AES_BLOCK_SIZE, nonce,
+				     TC_AES_BLOCK_SIZE);
+		}
+		if (!tc_aes_encrypt_multi(buffer, buffer, blocks, sched)) {
+			return TC_FAIL;
 		}
 		/* update the output */
-		*out++ = buffer[i % (TC_AES_BLOCK_SIZE)] ^ *in++;
+		for (n = 0; n < blocks * TC_AES_BLOCK_SIZE && i < inlen;
+		     ++n, ++i) {
+			*out++ = buffer[n] ^ *in++;
+		}
 	}
 
 	/* update the counter */
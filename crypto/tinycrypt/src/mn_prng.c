@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(TINYCRYPT_HMAC_PRNG_TRNG)
+
+#include <string.h>
+#include "hal/hal_trng.h"
+#include "tinycrypt/constants.h"
+#include "tinycrypt/hmac_prng.h"
+#include "tinycrypt/mn_prng.h"
+
+static struct tc_hmac_prng_struct mn_prng;
+static uint8_t mn_prng_ready;
+
+static int
+mn_prng_reseed(void)
+{
+    uint8_t seed[32];
+    int32_t rc;
+
+    /*
+     * The cache normally holds more than a seed's worth of entropy,
+     * so this does not spin on the peripheral.
+     */
+    hal_trng_read_blocking(seed, sizeof(seed));
+    rc = tc_hmac_prng_reseed(&mn_prng, seed, sizeof(seed), NULL, 0);
+    memset(seed, 0, sizeof(seed));
+
+    return (rc == TC_CRYPTO_SUCCESS) ? 0 : -1;
+}
+
+int
+mn_prng_init(const uint8_t *personalization, uint16_t plen)
+{
+    if (tc_hmac_prng_init(&mn_prng, personalization, plen) !=
+        TC_CRYPTO_SUCCESS) {
+        return -1;
+    }
+    if (mn_prng_reseed() != 0) {
+        return -1;
+    }
+    mn_prng_ready = 1;
+    return 0;
+}
+
+int
+mn_prng_generate(uint8_t *out, uint16_t len)
+{
+    int32_t rc;
+
+    if (!mn_prng_ready) {
+        return -1;
+    }
+    rc = tc_hmac_prng_generate(out, len, &mn_prng);
+    if (rc == TC_HMAC_PRNG_RESEED_REQ) {
+        if (mn_prng_reseed() != 0) {
+            return -1;
+        }
+        rc = tc_hmac_prng_generate(out, len, &mn_prng);
+    }
+
+    return (rc == TC_CRYPTO_SUCCESS) ? 0 : -1;
+}
+
+#endif /* TINYCRYPT_HMAC_PRNG_TRNG */
@@ -48,15 +48,28 @@
 static const char base64_chars[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-static int
-pos(char c)
-{
-    const char *p;
-    for (p = base64_chars; *p; p++)
-        if (*p == c)
-            return p - base64_chars;
-    return -1;
-}
+/*
+ * Reverse mapping of base64_chars; -1 marks characters outside the
+ * alphabet.  Indexed directly by input byte so decode needs no search.
+ */
+static const int8_t base64_rev[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
 
 int
 base64_encode(const void *data, int size, char *s, uint8_t should_pad)
@@ -73,6 +86,19 @@ base64_encode(const void *data, int size, char *s, uint8_t should_pad)
     q = (const unsigned char *) data;
     last = NULL;
     i = 0;
+
+    /* fast path: full 3-byte quanta, no per-byte end-of-input checks */
+    while (i + 3 <= size) {
+        c = (q[i] << 16) | (q[i + 1] << 8) | q[i + 2];
+        i += 3;
+        p[0] = base64_chars[(c >> 18) & 0x3f];
+        p[1] = base64_chars[(c >> 12) & 0x3f];
+        p[2] = base64_chars[(c >> 6) & 0x3f];
+        p[3] = base64_chars[c & 0x3f];
+        last = p;
+        p += 4;
+    }
+
     while (i < size) {
         c = q[i++];
         c *= 256;
@@ -128,9 +154,11 @@ static unsigned int
 token_decode(const char *token)
 {
     int i;
+    int d;
     unsigned int val = 0;
     int marker = 0;
-    if (strlen(token) < 4)
+    if (token[0] == '\0' || token[1] == '\0' || token[2] == '\0' ||
+        token[3] == '\0')
         return DECODE_ERROR;
     for (i = 0; i < 4; i++) {
         val *= 64;
@@ -138,8 +166,12 @@ token_decode(const char *token)
             marker++;
         else if (marker > 0)
             return DECODE_ERROR;
-        else
-            val += pos(token[i]);
+        else {
+            d = base64_rev[(unsigned char) token[i]];
+            if (d < 0)
+                return DECODE_ERROR;
+            val += d;
+        }
     }
     if (marker > 2)
         return DECODE_ERROR;
@@ -151,10 +183,39 @@ base64_decode(const char *str, void *data)
 {
     const char *p;
     unsigned char *q;
+    uint32_t val;
+    int d0;
+    int d1;
+    int d2;
+    int d3;
 
     q = data;
-    for (p = str; *p && (*p == '=' || strchr(base64_chars, *p)); p += 4) {
-        unsigned int val = token_decode(p);
+    p = str;
+
+    /*
+     * Fast path: whole quanta of alphabet characters decode as one
+     * 32-bit word; a single sign check validates all four lookups.
+     * Padding, a terminator or a stray character drops to the slow
+     * loop below.
+     */
+    while (p[0] && p[1] && p[2] && p[3]) {
+        d0 = base64_rev[(unsigned char) p[0]];
+        d1 = base64_rev[(unsigned char) p[1]];
+        d2 = base64_rev[(unsigned char) p[2]];
+        d3 = base64_rev[(unsigned char) p[3]];
+        if ((d0 | d1 | d2 | d3) < 0) {
+            break;
+        }
+        val = ((uint32_t) d0 << 18) | ((uint32_t) d1 << 12) |
+              ((uint32_t) d2 << 6) | (uint32_t) d3;
+        *q++ = (val >> 16) & 0xff;
+        *q++ = (val >> 8) & 0xff;
+        *q++ = val & 0xff;
+        p += 4;
+    }
+
+    for (; *p && (*p == '=' || base64_rev[(unsigned char) *p] >= 0); p += 4) {
+        val = token_decode(p);
         unsigned int marker = (val >> 24) & 0xff;
         if (val == DECODE_ERROR)
             return -1;
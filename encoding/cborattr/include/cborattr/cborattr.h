@@ -118,9 +118,41 @@ struct cbor_attr_t {
     bool nodefault;
 };
 
+/*
+ * Precompiled dispatch table over a cbor_attr_t array.  Building it once
+ * sorts the attribute keys and caches their lengths, so per-message key
+ * lookup is a binary search instead of a strlen/memcmp against every
+ * attribute.  Intended for schemas that are decoded repeatedly, e.g. the
+ * management command handlers.
+ */
+struct cbor_attr_dispatch_entry {
+    const struct cbor_attr_t *attr;
+    uint16_t key_len;
+};
+
+struct cbor_attr_dispatch {
+    const struct cbor_attr_t *attrs;
+    struct cbor_attr_dispatch_entry *entries;
+    int count;
+};
+
 int cbor_read_object(struct CborValue *, const struct cbor_attr_t *);
 int cbor_read_array(struct CborParser *, const struct cbor_array_t *);
 
+/*
+ * Compiles 'attrs' into 'cd', filling the caller-provided 'entries' array
+ * (one slot per attribute, excluding the terminator).  Returns 0 on
+ * success; nonzero if the array has more attributes than 'max_entries'.
+ */
+int cbor_attr_dispatch_build(struct cbor_attr_dispatch *cd,
+                             const struct cbor_attr_t *attrs,
+                             struct cbor_attr_dispatch_entry *entries,
+                             int max_entries);
+
+/* Same as cbor_read_object, but resolves keys through a compiled table. */
+int cbor_read_object_dispatch(struct CborValue *,
+                              const struct cbor_attr_dispatch *);
+
 
 #ifdef __cplusplus
 }
@@ -17,6 +17,8 @@
  * under the License.
  */
 
+#include <string.h>
+
 #include <cborattr/cborattr.h>
 #include <tinycbor/cbor.h>
 
@@ -123,9 +125,104 @@ cbor_target_address(const struct cbor_attr_t *cursor,
     return targetaddr;
 }
 
+/*
+ * Orders dispatch entries by key length first, then by contents, so a
+ * lookup can binary search using the already-known length of the
+ * incoming key.
+ */
+static int
+cbor_attr_dispatch_cmp(const struct cbor_attr_dispatch_entry *e,
+                       const char *key, size_t len)
+{
+    if (e->key_len != len) {
+        return e->key_len < len ? -1 : 1;
+    }
+    return memcmp(e->attr->attribute, key, len);
+}
+
+int
+cbor_attr_dispatch_build(struct cbor_attr_dispatch *cd,
+                         const struct cbor_attr_t *attrs,
+                         struct cbor_attr_dispatch_entry *entries,
+                         int max_entries)
+{
+    const struct cbor_attr_t *cursor;
+    struct cbor_attr_dispatch_entry ent;
+    int cnt;
+    int i;
+
+    cnt = 0;
+    for (cursor = attrs; cursor->attribute != NULL; cursor++) {
+        if (cnt >= max_entries) {
+            return -1;
+        }
+        ent.attr = cursor;
+        ent.key_len = strlen(cursor->attribute);
+
+        /* insertion sort; schema tables are small and built once */
+        for (i = cnt; i > 0; i--) {
+            if (cbor_attr_dispatch_cmp(&entries[i - 1], cursor->attribute,
+                                       ent.key_len) <= 0) {
+                break;
+            }
+            entries[i] = entries[i - 1];
+        }
+        entries[i] = ent;
+        cnt++;
+    }
+    cd->attrs = attrs;
+    cd->entries = entries;
+    cd->count = cnt;
+    return 0;
+}
+
+/*
+ * Binary search for 'key'; on a key match, scans the run of entries with
+ * the same key for one whose attribute type matches the incoming value,
+ * mirroring the linear lookup's first-match-by-type behavior.
+ */
+static const struct cbor_attr_t *
+cbor_attr_dispatch_find(const struct cbor_attr_dispatch *cd,
+                        const char *key, size_t len, CborType type)
+{
+    const struct cbor_attr_dispatch_entry *entries;
+    int lo;
+    int hi;
+    int mid;
+    int rc;
+
+    entries = cd->entries;
+    lo = 0;
+    hi = cd->count - 1;
+    while (lo <= hi) {
+        mid = (lo + hi) / 2;
+        rc = cbor_attr_dispatch_cmp(&entries[mid], key, len);
+        if (rc == 0) {
+            while (mid > 0 &&
+                   cbor_attr_dispatch_cmp(&entries[mid - 1], key, len) == 0) {
+                mid--;
+            }
+            for (; mid < cd->count &&
+                   cbor_attr_dispatch_cmp(&entries[mid], key, len) == 0;
+                 mid++) {
+                if (valid_attr_type(type, entries[mid].attr->type)) {
+                    return entries[mid].attr;
+                }
+            }
+            return NULL;
+        } else if (rc < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return NULL;
+}
+
 static int
 cbor_internal_read_object(CborValue *root_value,
                           const struct cbor_attr_t *attrs,
+                          const struct cbor_attr_dispatch *cd,
                           const struct cbor_array_t *parent,
                           int offset) {
     const struct cbor_attr_t *cursor;
@@ -200,15 +297,22 @@ cbor_internal_read_object(CborValue *root_value,
         }
 
         /* find this attribute in our list */
-        for (cursor = attrs; cursor->attribute != NULL; cursor++) {
-            if ( valid_attr_type(type, cursor->type) &&
-                (memcmp(cursor->attribute, attrbuf, len) == 0 )) {
-                break;
+        if (cd != NULL) {
+            cursor = cbor_attr_dispatch_find(cd, attrbuf, len, type);
+        } else {
+            for (cursor = attrs; cursor->attribute != NULL; cursor++) {
+                if ( valid_attr_type(type, cursor->type) &&
+                    (memcmp(cursor->attribute, attrbuf, len) == 0 )) {
+                    break;
+                }
+            }
+            if (cursor->attribute == NULL) {
+                cursor = NULL;
             }
         }
 
         /* we found a match */
-        if ( cursor->attribute != NULL ) {
+        if ( cursor != NULL ) {
            lptr = cbor_target_address(cursor, parent, offset);
             switch (cursor->type) {
                 case CborAttrNullType:
@@ -262,6 +366,16 @@ cbor_read_object(struct CborValue *value, const struct cbor_attr_t *attrs)
 {
     int st;
 
-    st = cbor_internal_read_object(value, attrs, NULL, 0);
+    st = cbor_internal_read_object(value, attrs, NULL, NULL, 0);
+    return st;
+}
+
+int
+cbor_read_object_dispatch(struct CborValue *value,
+                          const struct cbor_attr_dispatch *cd)
+{
+    int st;
+
+    st = cbor_internal_read_object(value, cd->attrs, cd, NULL, 0);
     return st;
 }
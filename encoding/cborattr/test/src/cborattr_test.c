@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "cborattr_test.h"
+
+/*
+ * Same shape as an imgmgr image upload request: a few short integer keys
+ * plus a data chunk, with the keys in the order newtmgr emits them.
+ */
+int
+cborattr_test_encode_upload_req(uint8_t *buf, int buf_sz)
+{
+    struct CborBufWriter writer;
+    CborEncoder enc;
+    CborEncoder map;
+    uint8_t data[64];
+    uint8_t sha[32];
+    CborError g_err = CborNoError;
+
+    memset(data, 0xa5, sizeof(data));
+    memset(sha, 0x5a, sizeof(sha));
+
+    cbor_buf_writer_init(&writer, buf, buf_sz);
+    cbor_encoder_init(&enc, &writer.enc, 0);
+
+    g_err |= cbor_encoder_create_map(&enc, &map, 5);
+    g_err |= cbor_encode_text_stringz(&map, "sha");
+    g_err |= cbor_encode_byte_string(&map, sha, sizeof(sha));
+    g_err |= cbor_encode_text_stringz(&map, "off");
+    g_err |= cbor_encode_uint(&map, 4096);
+    g_err |= cbor_encode_text_stringz(&map, "len");
+    g_err |= cbor_encode_uint(&map, 65536);
+    g_err |= cbor_encode_text_stringz(&map, "data");
+    g_err |= cbor_encode_byte_string(&map, data, sizeof(data));
+    g_err |= cbor_encode_text_stringz(&map, "upgrade");
+    g_err |= cbor_encode_boolean(&map, true);
+    g_err |= cbor_encoder_close_container(&enc, &map);
+    if (g_err) {
+        return -1;
+    }
+    return cbor_buf_writer_buffer_size(&writer, buf);
+}
+
+TEST_CASE_DECL(cborattr_test_dispatch)
+TEST_CASE_DECL(cborattr_test_dispatch_bench)
+
+TEST_SUITE(cborattr_test_suite)
+{
+    cborattr_test_dispatch();
+    cborattr_test_dispatch_bench();
+}
+
+#if MYNEWT_VAL(SELFTEST)
+
+int
+main(int argc, char **argv)
+{
+    ts_config.ts_print_results = 1;
+    tu_init();
+
+    cborattr_test_suite();
+
+    return tu_any_failed;
+}
+
+#endif
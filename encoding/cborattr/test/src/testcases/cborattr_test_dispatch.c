@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "cborattr_test.h"
+
+/*
+ * Decoding through a compiled dispatch table must produce the same
+ * values as the plain linear lookup, and fill defaults for keys that
+ * are absent from the message.
+ */
+TEST_CASE(cborattr_test_dispatch)
+{
+    uint8_t msg[CBORATTR_TEST_MSG_SZ];
+    uint8_t data[128];
+    uint8_t sha[64];
+    size_t data_len;
+    size_t sha_len;
+    unsigned long long int off;
+    unsigned long long int size;
+    bool upgrade;
+    long long int missing;
+    struct cbor_attr_t attrs[] = {
+        [0] = {
+            .attribute = "off",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &off,
+            .nodefault = true
+        },
+        [1] = {
+            .attribute = "data",
+            .type = CborAttrByteStringType,
+            .addr.bytestring.data = data,
+            .addr.bytestring.len = &data_len,
+            .len = sizeof(data)
+        },
+        [2] = {
+            .attribute = "len",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &size,
+            .nodefault = true
+        },
+        [3] = {
+            .attribute = "sha",
+            .type = CborAttrByteStringType,
+            .addr.bytestring.data = sha,
+            .addr.bytestring.len = &sha_len,
+            .len = sizeof(sha)
+        },
+        [4] = {
+            .attribute = "upgrade",
+            .type = CborAttrBooleanType,
+            .addr.boolean = &upgrade,
+            .dflt.boolean = false
+        },
+        [5] = {
+            .attribute = "missing",
+            .type = CborAttrIntegerType,
+            .addr.integer = &missing,
+            .dflt.integer = -42
+        },
+        [6] = { 0 },
+    };
+    struct cbor_attr_dispatch_entry entries[8];
+    struct cbor_attr_dispatch cd;
+    struct cbor_buf_reader reader;
+    CborParser parser;
+    CborValue value;
+    int msg_len;
+    int rc;
+
+    msg_len = cborattr_test_encode_upload_req(msg, sizeof(msg));
+    TEST_ASSERT_FATAL(msg_len > 0);
+
+    rc = cbor_attr_dispatch_build(&cd, attrs, entries, 8);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cd.count == 6);
+
+    /* too few slots must be rejected, not truncated */
+    rc = cbor_attr_dispatch_build(&cd, attrs, entries, 5);
+    TEST_ASSERT(rc != 0);
+
+    rc = cbor_attr_dispatch_build(&cd, attrs, entries, 8);
+    TEST_ASSERT(rc == 0);
+
+    off = 0;
+    size = 0;
+    upgrade = false;
+    missing = 0;
+    data_len = 0;
+    sha_len = 0;
+
+    cbor_buf_reader_init(&reader, msg, msg_len);
+    rc = cbor_parser_init(&reader.r, 0, &parser, &value);
+    TEST_ASSERT(rc == 0);
+    rc = cbor_read_object_dispatch(&value, &cd);
+    TEST_ASSERT(rc == 0);
+
+    TEST_ASSERT(off == 4096);
+    TEST_ASSERT(size == 65536);
+    TEST_ASSERT(upgrade == true);
+    TEST_ASSERT(data_len == 64);
+    TEST_ASSERT(data[0] == 0xa5 && data[63] == 0xa5);
+    TEST_ASSERT(sha_len == 32);
+    TEST_ASSERT(sha[0] == 0x5a && sha[31] == 0x5a);
+    TEST_ASSERT(missing == -42);
+}
@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdio.h>
+#include <time.h>
+
+#include "cborattr_test.h"
+
+#define BENCH_ITERS     20000
+
+/*
+ * Decodes the imgmgr upload schema BENCH_ITERS times with the linear
+ * lookup and again through a compiled dispatch table, and reports both
+ * timings.  Only sanity of the results is asserted; the timing numbers
+ * are informational, as selftest hosts vary.
+ */
+TEST_CASE(cborattr_test_dispatch_bench)
+{
+    uint8_t msg[CBORATTR_TEST_MSG_SZ];
+    uint8_t data[128];
+    uint8_t sha[64];
+    size_t data_len;
+    size_t sha_len;
+    unsigned long long int off;
+    unsigned long long int size;
+    bool upgrade;
+    struct cbor_attr_t attrs[] = {
+        [0] = {
+            .attribute = "off",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &off,
+            .nodefault = true
+        },
+        [1] = {
+            .attribute = "data",
+            .type = CborAttrByteStringType,
+            .addr.bytestring.data = data,
+            .addr.bytestring.len = &data_len,
+            .len = sizeof(data)
+        },
+        [2] = {
+            .attribute = "len",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &size,
+            .nodefault = true
+        },
+        [3] = {
+            .attribute = "sha",
+            .type = CborAttrByteStringType,
+            .addr.bytestring.data = sha,
+            .addr.bytestring.len = &sha_len,
+            .len = sizeof(sha)
+        },
+        [4] = {
+            .attribute = "upgrade",
+            .type = CborAttrBooleanType,
+            .addr.boolean = &upgrade,
+            .dflt.boolean = false
+        },
+        [5] = { 0 },
+    };
+    struct cbor_attr_dispatch_entry entries[8];
+    struct cbor_attr_dispatch cd;
+    struct cbor_buf_reader reader;
+    CborParser parser;
+    CborValue value;
+    clock_t linear_t;
+    clock_t dispatch_t;
+    clock_t start;
+    int msg_len;
+    int rc;
+    int i;
+
+    msg_len = cborattr_test_encode_upload_req(msg, sizeof(msg));
+    TEST_ASSERT_FATAL(msg_len > 0);
+
+    rc = cbor_attr_dispatch_build(&cd, attrs, entries, 8);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    start = clock();
+    for (i = 0; i < BENCH_ITERS; i++) {
+        cbor_buf_reader_init(&reader, msg, msg_len);
+        rc = cbor_parser_init(&reader.r, 0, &parser, &value);
+        TEST_ASSERT_FATAL(rc == 0);
+        rc = cbor_read_object(&value, attrs);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+    linear_t = clock() - start;
+    TEST_ASSERT(off == 4096 && size == 65536 && data_len == 64);
+
+    start = clock();
+    for (i = 0; i < BENCH_ITERS; i++) {
+        cbor_buf_reader_init(&reader, msg, msg_len);
+        rc = cbor_parser_init(&reader.r, 0, &parser, &value);
+        TEST_ASSERT_FATAL(rc == 0);
+        rc = cbor_read_object_dispatch(&value, &cd);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+    dispatch_t = clock() - start;
+    TEST_ASSERT(off == 4096 && size == 65536 && data_len == 64);
+
+    printf("cborattr upload schema x%d: linear %lu ticks, dispatch %lu ticks\n",
+           BENCH_ITERS, (unsigned long)linear_t, (unsigned long)dispatch_t);
+}
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_CBORJSON_
+#define H_CBORJSON_
+
+#include "json/json.h"
+#include "tinycbor/cbor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Streaming transcoders between CBOR and JSON for gateway-mode devices
+ * bridging a CBOR-native device to JSON tooling.  Both directions
+ * translate parser events straight into the opposite encoder, so
+ * memory use is O(nesting depth) plus one bounded scalar buffer -
+ * no intermediate copy of the document is built.
+ *
+ * Mapping notes: CBOR byte strings become base64 JSON strings; integer
+ * map keys are stringified (JSON requires string keys); CBOR tags,
+ * half-floats and scalars longer than CBORJSON_VAL_MAX are rejected.
+ */
+
+#define CBORJSON_VAL_MAX        512
+
+#define CBORJSON_ERR_INVAL      1   /* malformed or untranslatable input */
+#define CBORJSON_ERR_TOODEEP    2   /* nesting exceeds max_depth */
+#define CBORJSON_ERR_TOOLONG    3   /* scalar exceeds CBORJSON_VAL_MAX */
+
+/**
+ * Transcodes the CBOR value at 'value' (and, for containers, all its
+ * contents) into JSON written through 'enc'.  On success, 'value' is
+ * advanced past the transcoded item.
+ *
+ * @param enc                   The JSON encoder to write through.
+ * @param value                 The CBOR value to transcode.
+ * @param max_depth             Maximum container nesting to accept.
+ *
+ * @return                      0 on success; CBORJSON_ERR_[...] code on
+ *                              failure.
+ */
+int cborjson_cbor_to_json(struct json_encoder *enc, CborValue *value,
+                          int max_depth);
+
+/**
+ * Parses one JSON value from 'jb' and encodes its CBOR equivalent into
+ * 'enc'.  Containers are encoded with indefinite length; numbers with
+ * a fraction or exponent become doubles.
+ *
+ * @param jb                    The JSON input to read from.
+ * @param enc                   The CBOR encoder to write into.
+ * @param max_depth             Maximum container nesting to accept.
+ *
+ * @return                      0 on success; CBORJSON_ERR_[...] code on
+ *                              failure.
+ */
+int cborjson_json_to_cbor(struct json_buffer *jb, CborEncoder *enc,
+                          int max_depth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
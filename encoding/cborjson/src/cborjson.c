@@ -0,0 +1,587 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base64/base64.h"
+#include "cborjson/cborjson.h"
+
+/*
+ * Byte strings are base64-encoded into the JSON stream in slices of
+ * this many raw bytes (a multiple of 3, so slices concatenate without
+ * padding in between; only the final slice is padded).
+ */
+#define CBORJSON_B64_CHUNK      48
+
+struct cborjson_ctx {
+    struct json_encoder *enc;
+    char buf[CBORJSON_VAL_MAX];
+};
+
+/**
+ * Writes a pre-rendered JSON token (number, true/false/null) at value
+ * position, with the same comma bookkeeping as json_encode_*().
+ */
+static void
+cborjson_raw(struct json_encoder *enc, char *tok, int len)
+{
+    if (enc->je_wr_commas) {
+        enc->je_write(enc->je_arg, ",", 1);
+        enc->je_wr_commas = 0;
+    }
+    enc->je_write(enc->je_arg, tok, len);
+    enc->je_wr_commas = 1;
+}
+
+static int
+cborjson_c2j_value(struct cborjson_ctx *cx, CborValue *it, int depth)
+{
+    struct json_encoder *enc = cx->enc;
+    char num[32];
+    CborValue next;
+    CborError err;
+    CborType type;
+    size_t len;
+    uint64_t u64;
+    int64_t i64;
+#if FLOAT_SUPPORT
+    double d;
+#endif
+    bool b;
+    int rc;
+    int nlen;
+
+    type = cbor_value_get_type(it);
+    switch (type) {
+    case CborIntegerType:
+        if (cbor_value_is_unsigned_integer(it)) {
+            cbor_value_get_uint64(it, &u64);
+            nlen = sprintf(num, "%llu", (unsigned long long)u64);
+        } else {
+            cbor_value_get_int64(it, &i64);
+            nlen = sprintf(num, "%lld", (long long)i64);
+        }
+        cborjson_raw(enc, num, nlen);
+        break;
+
+    case CborTextStringType:
+        len = sizeof(cx->buf);
+        err = cbor_value_copy_text_string(it, cx->buf, &len, &next);
+        if (err == CborErrorOutOfMemory) {
+            return CBORJSON_ERR_TOOLONG;
+        }
+        if (err != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        json_encode_string_start(enc);
+        json_encode_string_append(enc, cx->buf, len);
+        json_encode_string_finish(enc);
+        *it = next;
+        return 0;
+
+    case CborByteStringType: {
+        char b64[BASE64_ENCODE_SIZE(CBORJSON_B64_CHUNK)];
+        size_t off;
+        int blk;
+
+        len = sizeof(cx->buf);
+        err = cbor_value_copy_byte_string(it, (uint8_t *)cx->buf, &len,
+                                          &next);
+        if (err == CborErrorOutOfMemory) {
+            return CBORJSON_ERR_TOOLONG;
+        }
+        if (err != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        json_encode_string_start(enc);
+        for (off = 0; off < len; off += blk) {
+            blk = len - off;
+            if (blk > CBORJSON_B64_CHUNK) {
+                blk = CBORJSON_B64_CHUNK;
+            }
+            nlen = base64_encode(&cx->buf[off], blk, b64,
+                                 off + blk == len);
+            json_encode_string_append(enc, b64, nlen);
+        }
+        json_encode_string_finish(enc);
+        *it = next;
+        return 0;
+    }
+
+    case CborBooleanType:
+        cbor_value_get_boolean(it, &b);
+        if (b) {
+            cborjson_raw(enc, "true", 4);
+        } else {
+            cborjson_raw(enc, "false", 5);
+        }
+        break;
+
+    case CborNullType:
+    case CborUndefinedType:
+        cborjson_raw(enc, "null", 4);
+        break;
+
+#if FLOAT_SUPPORT
+    case CborFloatType:
+    case CborDoubleType:
+        cbor_value_get_double(it, &d);
+        nlen = sprintf(num, "%g", d);
+        cborjson_raw(enc, num, nlen);
+        break;
+#endif
+
+    case CborArrayType: {
+        CborValue sub;
+
+        if (depth <= 0) {
+            return CBORJSON_ERR_TOODEEP;
+        }
+        if (cbor_value_enter_container(it, &sub) != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        if (enc->je_wr_commas) {
+            enc->je_write(enc->je_arg, ",", 1);
+            enc->je_wr_commas = 0;
+        }
+        json_encode_array_start(enc);
+        while (!cbor_value_at_end(&sub)) {
+            rc = cborjson_c2j_value(cx, &sub, depth - 1);
+            if (rc != 0) {
+                return rc;
+            }
+        }
+        json_encode_array_finish(enc);
+        if (cbor_value_leave_container(it, &sub) != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        return 0;
+    }
+
+    case CborMapType: {
+        CborValue sub;
+
+        if (depth <= 0) {
+            return CBORJSON_ERR_TOODEEP;
+        }
+        if (cbor_value_enter_container(it, &sub) != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        json_encode_object_start(enc);
+        while (!cbor_value_at_end(&sub)) {
+            /* JSON keys must be strings; stringify integer keys. */
+            if (cbor_value_is_text_string(&sub)) {
+                len = sizeof(cx->buf);
+                err = cbor_value_copy_text_string(&sub, cx->buf, &len,
+                                                  &next);
+                if (err == CborErrorOutOfMemory) {
+                    return CBORJSON_ERR_TOOLONG;
+                }
+                if (err != CborNoError) {
+                    return CBORJSON_ERR_INVAL;
+                }
+                sub = next;
+            } else if (cbor_value_get_type(&sub) == CborIntegerType) {
+                cbor_value_get_int64(&sub, &i64);
+                sprintf(cx->buf, "%lld", (long long)i64);
+                if (cbor_value_advance(&sub) != CborNoError) {
+                    return CBORJSON_ERR_INVAL;
+                }
+            } else {
+                return CBORJSON_ERR_INVAL;
+            }
+            json_encode_object_key(enc, cx->buf);
+
+            rc = cborjson_c2j_value(cx, &sub, depth - 1);
+            if (rc != 0) {
+                return rc;
+            }
+        }
+        json_encode_object_finish(enc);
+        if (cbor_value_leave_container(it, &sub) != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        return 0;
+    }
+
+    default:
+        /* Tags, half-floats and simple values don't translate. */
+        return CBORJSON_ERR_INVAL;
+    }
+
+    if (cbor_value_advance(it) != CborNoError) {
+        return CBORJSON_ERR_INVAL;
+    }
+    return 0;
+}
+
+int
+cborjson_cbor_to_json(struct json_encoder *enc, CborValue *value,
+                      int max_depth)
+{
+    struct cborjson_ctx cx;
+
+    cx.enc = enc;
+    return cborjson_c2j_value(&cx, value, max_depth);
+}
+
+struct cborjson_in {
+    struct json_buffer *jb;
+    char un;            /* pushed-back character; 0 if none */
+    char buf[CBORJSON_VAL_MAX];
+};
+
+static char
+cborjson_in_next(struct cborjson_in *in)
+{
+    char c;
+
+    if (in->un != '\0') {
+        c = in->un;
+        in->un = '\0';
+        return c;
+    }
+    return in->jb->jb_read_next(in->jb);
+}
+
+static void
+cborjson_in_unget(struct cborjson_in *in, char c)
+{
+    in->un = c;
+}
+
+static char
+cborjson_in_next_nonws(struct cborjson_in *in)
+{
+    char c;
+
+    do {
+        c = cborjson_in_next(in);
+    } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+    return c;
+}
+
+static int
+cborjson_in_hex4(struct cborjson_in *in, uint32_t *out)
+{
+    uint32_t v;
+    char c;
+    int i;
+
+    v = 0;
+    for (i = 0; i < 4; i++) {
+        c = cborjson_in_next(in);
+        if (c >= '0' && c <= '9') {
+            v = (v << 4) | (c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            v = (v << 4) | (c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            v = (v << 4) | (c - 'A' + 10);
+        } else {
+            return CBORJSON_ERR_INVAL;
+        }
+    }
+    *out = v;
+    return 0;
+}
+
+/**
+ * Parses a JSON string body (opening quote already consumed) into
+ * in->buf, decoding escapes; \u escapes (including surrogate pairs)
+ * are re-encoded as UTF-8.
+ */
+static int
+cborjson_j2c_string(struct cborjson_in *in, size_t *out_len)
+{
+    uint32_t cp, lo;
+    size_t len;
+    char c;
+    int rc;
+
+    len = 0;
+    while (1) {
+        c = cborjson_in_next(in);
+        if (c == '"') {
+            break;
+        }
+        if (c == '\0') {
+            return CBORJSON_ERR_INVAL;
+        }
+        if (len + 4 > sizeof(in->buf)) {
+            return CBORJSON_ERR_TOOLONG;
+        }
+        if (c != '\\') {
+            in->buf[len++] = c;
+            continue;
+        }
+
+        c = cborjson_in_next(in);
+        switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+            in->buf[len++] = c;
+            break;
+        case 'b':
+            in->buf[len++] = '\b';
+            break;
+        case 'f':
+            in->buf[len++] = '\f';
+            break;
+        case 'n':
+            in->buf[len++] = '\n';
+            break;
+        case 'r':
+            in->buf[len++] = '\r';
+            break;
+        case 't':
+            in->buf[len++] = '\t';
+            break;
+        case 'u':
+            rc = cborjson_in_hex4(in, &cp);
+            if (rc != 0) {
+                return rc;
+            }
+            if (cp >= 0xdc00 && cp <= 0xdfff) {
+                /* Unpaired low surrogate. */
+                return CBORJSON_ERR_INVAL;
+            }
+            if (cp >= 0xd800 && cp <= 0xdbff) {
+                if (cborjson_in_next(in) != '\\' ||
+                    cborjson_in_next(in) != 'u') {
+                    return CBORJSON_ERR_INVAL;
+                }
+                rc = cborjson_in_hex4(in, &lo);
+                if (rc != 0) {
+                    return rc;
+                }
+                if (lo < 0xdc00 || lo > 0xdfff) {
+                    return CBORJSON_ERR_INVAL;
+                }
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+            }
+            if (cp < 0x80) {
+                in->buf[len++] = cp;
+            } else if (cp < 0x800) {
+                in->buf[len++] = 0xc0 | (cp >> 6);
+                in->buf[len++] = 0x80 | (cp & 0x3f);
+            } else if (cp < 0x10000) {
+                in->buf[len++] = 0xe0 | (cp >> 12);
+                in->buf[len++] = 0x80 | ((cp >> 6) & 0x3f);
+                in->buf[len++] = 0x80 | (cp & 0x3f);
+            } else {
+                in->buf[len++] = 0xf0 | (cp >> 18);
+                in->buf[len++] = 0x80 | ((cp >> 12) & 0x3f);
+                in->buf[len++] = 0x80 | ((cp >> 6) & 0x3f);
+                in->buf[len++] = 0x80 | (cp & 0x3f);
+            }
+            break;
+        default:
+            return CBORJSON_ERR_INVAL;
+        }
+    }
+
+    *out_len = len;
+    return 0;
+}
+
+static int
+cborjson_j2c_lit(struct cborjson_in *in, const char *rest)
+{
+    while (*rest != '\0') {
+        if (cborjson_in_next(in) != *rest++) {
+            return CBORJSON_ERR_INVAL;
+        }
+    }
+    return 0;
+}
+
+static int
+cborjson_j2c_value(struct cborjson_in *in, CborEncoder *enc, int depth)
+{
+    CborEncoder sub;
+    size_t len;
+    char num[32];
+    char *ep;
+    char c;
+    int is_real;
+    int nlen;
+    int rc;
+
+    c = cborjson_in_next_nonws(in);
+    switch (c) {
+    case '{':
+        if (depth <= 0) {
+            return CBORJSON_ERR_TOODEEP;
+        }
+        if (cbor_encoder_create_map(enc, &sub, CborIndefiniteLength) !=
+            CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        c = cborjson_in_next_nonws(in);
+        if (c != '}') {
+            while (1) {
+                if (c != '"') {
+                    return CBORJSON_ERR_INVAL;
+                }
+                rc = cborjson_j2c_string(in, &len);
+                if (rc != 0) {
+                    return rc;
+                }
+                if (cbor_encode_text_string(&sub, in->buf, len) !=
+                    CborNoError) {
+                    return CBORJSON_ERR_INVAL;
+                }
+                if (cborjson_in_next_nonws(in) != ':') {
+                    return CBORJSON_ERR_INVAL;
+                }
+                rc = cborjson_j2c_value(in, &sub, depth - 1);
+                if (rc != 0) {
+                    return rc;
+                }
+                c = cborjson_in_next_nonws(in);
+                if (c == '}') {
+                    break;
+                }
+                if (c != ',') {
+                    return CBORJSON_ERR_INVAL;
+                }
+                c = cborjson_in_next_nonws(in);
+            }
+        }
+        if (cbor_encoder_close_container(enc, &sub) != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        return 0;
+
+    case '[':
+        if (depth <= 0) {
+            return CBORJSON_ERR_TOODEEP;
+        }
+        if (cbor_encoder_create_array(enc, &sub, CborIndefiniteLength) !=
+            CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        c = cborjson_in_next_nonws(in);
+        if (c != ']') {
+            cborjson_in_unget(in, c);
+            while (1) {
+                rc = cborjson_j2c_value(in, &sub, depth - 1);
+                if (rc != 0) {
+                    return rc;
+                }
+                c = cborjson_in_next_nonws(in);
+                if (c == ']') {
+                    break;
+                }
+                if (c != ',') {
+                    return CBORJSON_ERR_INVAL;
+                }
+            }
+        }
+        if (cbor_encoder_close_container(enc, &sub) != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        return 0;
+
+    case '"':
+        rc = cborjson_j2c_string(in, &len);
+        if (rc != 0) {
+            return rc;
+        }
+        if (cbor_encode_text_string(enc, in->buf, len) != CborNoError) {
+            return CBORJSON_ERR_INVAL;
+        }
+        return 0;
+
+    case 't':
+        rc = cborjson_j2c_lit(in, "rue");
+        if (rc != 0) {
+            return rc;
+        }
+        cbor_encode_boolean(enc, true);
+        return 0;
+
+    case 'f':
+        rc = cborjson_j2c_lit(in, "alse");
+        if (rc != 0) {
+            return rc;
+        }
+        cbor_encode_boolean(enc, false);
+        return 0;
+
+    case 'n':
+        rc = cborjson_j2c_lit(in, "ull");
+        if (rc != 0) {
+            return rc;
+        }
+        cbor_encode_null(enc);
+        return 0;
+
+    default:
+        if (c != '-' && (c < '0' || c > '9')) {
+            return CBORJSON_ERR_INVAL;
+        }
+        nlen = 0;
+        is_real = 0;
+        while (1) {
+            if (nlen >= (int)sizeof(num) - 1) {
+                return CBORJSON_ERR_TOOLONG;
+            }
+            num[nlen++] = c;
+            c = cborjson_in_next(in);
+            if (c == '.' || c == 'e' || c == 'E') {
+                is_real = 1;
+            } else if (c != '-' && c != '+' && (c < '0' || c > '9')) {
+                break;
+            }
+        }
+        cborjson_in_unget(in, c);
+        num[nlen] = '\0';
+
+        if (is_real) {
+#if FLOAT_SUPPORT
+            cbor_encode_double(enc, strtod(num, &ep));
+#else
+            return CBORJSON_ERR_INVAL;
+#endif
+        } else if (num[0] == '-') {
+            cbor_encode_int(enc, strtoll(num, &ep, 10));
+        } else {
+            cbor_encode_uint(enc, strtoull(num, &ep, 10));
+        }
+        if (*ep != '\0') {
+            return CBORJSON_ERR_INVAL;
+        }
+        return 0;
+    }
+}
+
+int
+cborjson_json_to_cbor(struct json_buffer *jb, CborEncoder *enc,
+                      int max_depth)
+{
+    struct cborjson_in in;
+
+    in.jb = jb;
+    in.un = '\0';
+    return cborjson_j2c_value(&in, enc, max_depth);
+}
@@ -104,12 +104,25 @@ int json_encode_array_start(struct json_encoder *encoder);
 int json_encode_array_value(struct json_encoder *encoder, struct json_value *val);
 int json_encode_array_finish(struct json_encoder *encoder);
 
+/*
+ * Streaming string values.  A value too large to hold in memory can be
+ * encoded in pieces: write the key with json_encode_object_key(), then
+ * bracket any number of json_encode_string_append() calls with
+ * json_encode_string_start()/json_encode_string_finish().  Escaping is
+ * applied per chunk; only the encoder's fixed state is buffered.
+ */
+int json_encode_string_start(struct json_encoder *encoder);
+int json_encode_string_append(struct json_encoder *encoder, const char *data,
+        int len);
+int json_encode_string_finish(struct json_encoder *encoder);
+
 /* Json parser definitions */
 typedef enum {
     t_integer,
     t_uinteger,
     t_real,
     t_string,
+    t_string_stream,
     t_boolean,
     t_character,
     t_object,
@@ -124,6 +137,20 @@ struct json_enum_t {
     long long int value;
 };
 
+/*
+ * Sink for a t_string_stream attribute.  The parser hands the decoded
+ * (unescaped) value to jss_write in chunks as its internal buffer fills,
+ * so values larger than JSON_VAL_MAX are parsed in constant memory.
+ * A nonzero return aborts the parse with JSON_ERR_MISC.
+ */
+typedef int (*json_string_stream_write_t)(void *arg, const char *data,
+        int len);
+
+struct json_string_stream {
+    json_string_stream_write_t jss_write;
+    void *jss_arg;
+};
+
 struct json_array_t {
     json_type element_type;
     union {
@@ -162,6 +189,7 @@ struct json_attr_t {
         long long unsigned int *uinteger;
         double *real;
         char *string;
+        const struct json_string_stream *string_stream;
         bool *boolean;
         char *character;
         struct json_array_t array;
@@ -144,6 +144,25 @@ json_target_address(const struct json_attr_t *cursor,
     return targetaddr;
 }
 
+/*
+ * Hands the accumulated portion of a t_string_stream value to its sink
+ * and rewinds the value buffer.
+ */
+static int
+json_stream_flush(const struct json_attr_t *cursor, char *valbuf, char **pval)
+{
+    int len;
+
+    len = *pval - valbuf;
+    if (len > 0 &&
+        cursor->addr.string_stream->jss_write(
+            cursor->addr.string_stream->jss_arg, valbuf, len) != 0) {
+        return JSON_ERR_MISC;
+    }
+    *pval = valbuf;
+    return 0;
+}
+
 static int
 json_internal_read_object(struct json_buffer *jb,
                           const struct json_attr_t *attrs,
@@ -201,6 +220,7 @@ json_internal_read_object(struct json_buffer *jb,
                 case t_character:
                     lptr[0] = cursor->dflt.character;
                     break;
+                case t_string_stream: /* no storage to default */
                 case t_object:        /* silences a compiler warning */
                 case t_structobject:
                 case t_array:
@@ -255,6 +275,9 @@ json_internal_read_object(struct json_buffer *jb,
                 state = await_value;
                 if (cursor->type == t_string) {
                     maxlen = (int)cursor->len - 1;
+                } else if (cursor->type == t_string_stream) {
+                    /* never hit; the value is flushed as valbuf fills */
+                    maxlen = JSON_VAL_MAX;
                 } else if (cursor->type == t_check) {
                     maxlen = (int)strlen(cursor->dflt.check);
                 } else if (cursor->type == t_ignore) {
@@ -303,6 +326,12 @@ json_internal_read_object(struct json_buffer *jb,
                 /* don't update end here, leave at value start */
                 return JSON_ERR_NULLPTR;
             }
+            /* leave slack for the multi-byte appends in in_escape */
+            if (cursor->type == t_string_stream &&
+                pval >= valbuf + JSON_VAL_MAX - 8 &&
+                json_stream_flush(cursor, valbuf, &pval) != 0) {
+                return JSON_ERR_MISC;
+            }
             if (c == '\\') {
                 state = in_escape;
             } else if (c == '"') {
@@ -321,6 +350,11 @@ json_internal_read_object(struct json_buffer *jb,
                 /* don't update end here, leave at value start */
                 return JSON_ERR_NULLPTR;
             }
+            if (cursor->type == t_string_stream &&
+                pval >= valbuf + JSON_VAL_MAX - 8 &&
+                json_stream_flush(cursor, valbuf, &pval) != 0) {
+                return JSON_ERR_MISC;
+            }
             switch (c) {
             case 'b':
                 *pval++ = '\b';
@@ -382,7 +416,8 @@ json_internal_read_object(struct json_buffer *jb,
              */
             for (;;) {
                 int seeking = cursor->type;
-                if (value_quoted && (cursor->type == t_string)) {
+                if (value_quoted && (cursor->type == t_string ||
+                                     cursor->type == t_string_stream)) {
                     break;
                 }
                 if ((strcmp(valbuf, "true")==0 || strcmp(valbuf, "false")==0)
@@ -408,13 +443,17 @@ json_internal_read_object(struct json_buffer *jb,
                 ++cursor;
             }
             if (value_quoted
-                && (cursor->type != t_string && cursor->type != t_character
+                && (cursor->type != t_string
+                    && cursor->type != t_string_stream
+                    && cursor->type != t_character
                     && cursor->type != t_check && cursor->type != t_ignore
                     && cursor->map == 0)) {
                 return JSON_ERR_QNONSTRING;
             }
             if (!value_quoted
-                && (cursor->type == t_string || cursor->type == t_check
+                && (cursor->type == t_string
+                    || cursor->type == t_string_stream
+                    || cursor->type == t_check
                     || cursor->map != 0)) {
                 return JSON_ERR_NONQSTRING;
             }
@@ -428,6 +467,13 @@ json_internal_read_object(struct json_buffer *jb,
               foundit:
                 (void)snprintf(valbuf, sizeof(valbuf), "%lld", mp->value);
             }
+            if (cursor->type == t_string_stream) {
+                /* drop the terminating NUL, flush the final chunk */
+                pval--;
+                if (json_stream_flush(cursor, valbuf, &pval) != 0) {
+                    return JSON_ERR_MISC;
+                }
+            }
             lptr = json_target_address(cursor, parent, offset);
             if (lptr != NULL) {
                 switch (cursor->type) {
@@ -474,6 +520,7 @@ json_internal_read_object(struct json_buffer *jb,
                         lptr[0] = valbuf[0];
                     }
                     break;
+                case t_string_stream: /* flushed above */
                 case t_ignore:        /* silences a compiler warning */
                 case t_object:        /* silences a compiler warning */
                 case t_structobject:
@@ -635,6 +682,7 @@ json_read_array(struct json_buffer *jb, const struct json_array_t *arr)
                 jb->jb_read_prev(jb);
             }
             break;
+        case t_string_stream:
         case t_character:
         case t_array:
         case t_check:
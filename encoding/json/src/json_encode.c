@@ -35,6 +35,42 @@
     (__e)->je_write((__e)->je_arg, "]", sizeof("]")-1);
 
 
+/* writes string data, escaping as necessary */
+static void
+json_encode_string_data(struct json_encoder *encoder, const char *str, int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++) {
+        switch (str[i]) {
+            case '"':
+            case '/':
+            case '\\':
+                encoder->je_write(encoder->je_arg, "\\", sizeof("\\")-1);
+                encoder->je_write(encoder->je_arg, (char *) &str[i], 1);
+                break;
+            case '\t':
+                encoder->je_write(encoder->je_arg, "\\t", sizeof("\\t")-1);
+                break;
+            case '\r':
+                encoder->je_write(encoder->je_arg, "\\r", sizeof("\\r")-1);
+                break;
+            case '\n':
+                encoder->je_write(encoder->je_arg, "\\n", sizeof("\\n")-1);
+                break;
+            case '\f':
+                encoder->je_write(encoder->je_arg, "\\f", sizeof("\\f")-1);
+                break;
+            case '\b':
+                encoder->je_write(encoder->je_arg, "\\b", sizeof("\\b")-1);
+                break;
+            default:
+                encoder->je_write(encoder->je_arg, (char *) &str[i], 1);
+                break;
+        }
+    }
+}
+
 int
 json_encode_object_start(struct json_encoder *encoder)
 {
@@ -73,44 +109,7 @@ json_encode_value(struct json_encoder *encoder, struct json_value *jv)
             break;
         case JSON_VALUE_TYPE_STRING:
             encoder->je_write(encoder->je_arg, "\"", sizeof("\"")-1);
-            for (i = 0; i < jv->jv_len; i++) {
-                switch (jv->jv_val.str[i]) {
-                    case '"':
-                    case '/':
-                    case '\\':
-                        encoder->je_write(encoder->je_arg, "\\",
-                                sizeof("\\")-1);
-                        encoder->je_write(encoder->je_arg,
-                                (char *) &jv->jv_val.str[i], 1);
-
-                        break;
-                    case '\t':
-                        encoder->je_write(encoder->je_arg, "\\t",
-                                sizeof("\\t")-1);
-                        break;
-                    case '\r':
-                        encoder->je_write(encoder->je_arg, "\\r",
-                                sizeof("\\r")-1);
-                        break;
-                    case '\n':
-                        encoder->je_write(encoder->je_arg, "\\n",
-                                sizeof("\\n")-1);
-                        break;
-                    case '\f':
-                        encoder->je_write(encoder->je_arg, "\\f",
-                                sizeof("\\f")-1);
-                        break;
-                    case '\b':
-                        encoder->je_write(encoder->je_arg, "\\b",
-                                sizeof("\\b")-1);
-                        break;
-                   default:
-                        encoder->je_write(encoder->je_arg,
-                                (char *) &jv->jv_val.str[i], 1);
-                        break;
-                }
-
-            }
+            json_encode_string_data(encoder, jv->jv_val.str, jv->jv_len);
             encoder->je_write(encoder->je_arg, "\"", sizeof("\"")-1);
             break;
         case JSON_VALUE_TYPE_ARRAY:
@@ -246,3 +245,33 @@ json_encode_array_finish(struct json_encoder *encoder)
 
     return (0);
 }
+
+int
+json_encode_string_start(struct json_encoder *encoder)
+{
+    if (encoder->je_wr_commas) {
+        encoder->je_write(encoder->je_arg, ",", sizeof(",")-1);
+        encoder->je_wr_commas = 0;
+    }
+    encoder->je_write(encoder->je_arg, "\"", sizeof("\"")-1);
+
+    return (0);
+}
+
+int
+json_encode_string_append(struct json_encoder *encoder, const char *data,
+        int len)
+{
+    json_encode_string_data(encoder, data, len);
+
+    return (0);
+}
+
+int
+json_encode_string_finish(struct json_encoder *encoder)
+{
+    encoder->je_write(encoder->je_arg, "\"", sizeof("\"")-1);
+    encoder->je_wr_commas = 1;
+
+    return (0);
+}
@@ -23,10 +23,12 @@
 
 TEST_CASE_DECL(test_json_simple_encode);
 TEST_CASE_DECL(test_json_simple_decode);
+TEST_CASE_DECL(test_json_string_stream);
 
 TEST_SUITE(test_json_suite) {
     test_json_simple_encode();
     test_json_simple_decode();
+    test_json_string_stream();
 }
 
 #if MYNEWT_VAL(SELFTEST)
@@ -0,0 +1,112 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "test_json.h"
+
+/* value longer than JSON_VAL_MAX, to force mid-value flushes */
+#define STREAM_VAL_LEN     (JSON_VAL_MAX * 3)
+
+static char stream_enc_buf[STREAM_VAL_LEN * 2];
+static int stream_enc_off;
+
+static char stream_dec_buf[STREAM_VAL_LEN + 1];
+static int stream_dec_off;
+
+static int
+stream_enc_write(void *buf, char *data, int len)
+{
+    TEST_ASSERT_FATAL(stream_enc_off + len <= sizeof(stream_enc_buf));
+    memcpy(stream_enc_buf + stream_enc_off, data, len);
+    stream_enc_off += len;
+    return len;
+}
+
+static int
+stream_dec_write(void *arg, const char *data, int len)
+{
+    TEST_ASSERT_FATAL(stream_dec_off + len <= sizeof(stream_dec_buf));
+    memcpy(stream_dec_buf + stream_dec_off, data, len);
+    stream_dec_off += len;
+    return 0;
+}
+
+/*
+ * Encode a string value much longer than JSON_VAL_MAX in small chunks,
+ * then decode it back through a t_string_stream sink; neither direction
+ * may buffer the whole value.
+ */
+TEST_CASE(test_json_string_stream)
+{
+    char val[STREAM_VAL_LEN];
+    struct json_encoder encoder;
+    struct test_jbuf tjb;
+    struct json_string_stream stream = {
+        .jss_write = stream_dec_write,
+    };
+    const struct json_attr_t attrs[] = {
+        [0] = {
+            .attribute = "blob",
+            .type = t_string_stream,
+            .addr.string_stream = &stream,
+        },
+        [1] = { 0 },
+    };
+    int chunk;
+    int off;
+    int rc;
+    int i;
+
+    for (i = 0; i < STREAM_VAL_LEN; i++) {
+        /* include characters that need escaping */
+        val[i] = "abc\"\\\t\n0123456789"[i % 16];
+    }
+
+    memset(&encoder, 0, sizeof(encoder));
+    encoder.je_write = stream_enc_write;
+    stream_enc_off = 0;
+
+    rc = json_encode_object_start(&encoder);
+    TEST_ASSERT(rc == 0);
+    rc = json_encode_object_key(&encoder, "blob");
+    TEST_ASSERT(rc == 0);
+    rc = json_encode_string_start(&encoder);
+    TEST_ASSERT(rc == 0);
+    for (off = 0; off < STREAM_VAL_LEN; off += chunk) {
+        chunk = STREAM_VAL_LEN - off;
+        if (chunk > 100) {
+            chunk = 100;
+        }
+        rc = json_encode_string_append(&encoder, val + off, chunk);
+        TEST_ASSERT(rc == 0);
+    }
+    rc = json_encode_string_finish(&encoder);
+    TEST_ASSERT(rc == 0);
+    rc = json_encode_object_finish(&encoder);
+    TEST_ASSERT(rc == 0);
+
+    TEST_ASSERT_FATAL(stream_enc_off < sizeof(stream_enc_buf));
+    stream_enc_buf[stream_enc_off] = '\0';
+
+    stream_dec_off = 0;
+    test_buf_init(&tjb, stream_enc_buf);
+    rc = json_read_object(&tjb.json_buf, attrs);
+    TEST_ASSERT(rc == 0);
+
+    TEST_ASSERT(stream_dec_off == STREAM_VAL_LEN);
+    TEST_ASSERT(!memcmp(stream_dec_buf, val, STREAM_VAL_LEN));
+}
@@ -38,6 +38,17 @@ cbor_mbuf_reader_init(struct CborMbufReader *cb,
                         struct os_mbuf *m,
                         int intial_offset);
 
+/*
+ * Like cbor_mbuf_reader_init(), but caps the readable data at 'len'
+ * bytes; for decoding one of several concatenated messages in a single
+ * mbuf chain.
+ */
+void
+cbor_mbuf_reader_init_len(struct CborMbufReader *cb,
+                            struct os_mbuf *m,
+                            int intial_offset,
+                            int len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CBOR_SKELETON_H
+#define CBOR_SKELETON_H
+
+#include <tinycbor/cbor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Precompiled skeleton of a map with constant keys, for encoders that
+ * emit the same map structure for every entry of a response (e.g. the
+ * stats and log newtmgr handlers).  The map-open byte and the encoded
+ * key strings are computed once by cbor_skeleton_build(); streaming an
+ * entry then splices those constant bytes verbatim and encodes only
+ * the values, instead of re-encoding each key per entry.
+ */
+
+#define CBOR_SKELETON_MAX_KEYS  12
+
+struct cbor_skeleton {
+    const uint8_t *cs_buf;      /* encoded constant bytes */
+    uint8_t cs_nkeys;
+    /* Segment i ([cs_off[i], cs_off[i+1])) holds key i; segment 0 is
+     * preceded by the indefinite-length map-open byte.
+     */
+    uint16_t cs_off[CBOR_SKELETON_MAX_KEYS + 1];
+};
+
+/**
+ * Precompiles the constant bytes of a map with the given keys into
+ * caller-supplied storage; buf must stay valid for the skeleton's
+ * lifetime.  Requires 1 + nkeys * 2 bytes plus the total key length.
+ */
+CborError cbor_skeleton_build(struct cbor_skeleton *skel, uint8_t *buf,
+                              size_t buf_sz, const char * const *keys,
+                              unsigned int nkeys);
+
+/**
+ * Opens one map instance in the stream provided by encoder, splicing
+ * the map-open byte together with key 0; encode value 0 next.
+ */
+CborError cbor_skeleton_begin(CborEncoder *encoder, CborEncoder *mapEncoder,
+                              const struct cbor_skeleton *skel);
+
+/**
+ * Splices key idx (1 <= idx < nkeys); encode value idx next.  Keys
+ * must be emitted in order, one value after each.
+ */
+CborError cbor_skeleton_key(CborEncoder *mapEncoder,
+                            const struct cbor_skeleton *skel,
+                            unsigned int idx);
+
+/**
+ * Closes the map opened by cbor_skeleton_begin().
+ */
+CborError cbor_skeleton_end(CborEncoder *encoder, CborEncoder *mapEncoder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CBOR_SKELETON_H */
@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CBOR_STREAM_READER_H
+#define CBOR_STREAM_READER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <tinycbor/cbor.h>
+
+struct cbor_stream_reader;
+
+/*
+ * Called when the parser needs bytes beyond what has been fed so far.
+ * The callback blocks until more of the message is available, hands it
+ * over with cbor_stream_reader_feed(), and returns 0; nonzero aborts
+ * the decode.  cbor_stream_reader_feed() may consume only part of a
+ * fragment when the window is full; the callback keeps the remainder
+ * and offers it again on the next call.
+ */
+typedef int (cbor_stream_fill)(struct cbor_stream_reader *csr, void *arg);
+
+/*
+ * Decoder reader over a message that arrives in fragments.  Decoding
+ * starts as soon as the first fragment has been fed; the reader pulls
+ * further fragments through the fill callback as the parser advances,
+ * so only 'window_sz' bytes are buffered instead of the whole message.
+ * The window must be large enough for the largest single item the
+ * parser reads back (longest string plus header); older bytes are
+ * discarded as the window slides.  Reads outside the window, or a
+ * failing fill callback, set the sticky error flag, make the remaining
+ * reads return zero bytes, and must be checked with
+ * cbor_stream_reader_error() after the decode.
+ */
+struct cbor_stream_reader {
+    struct cbor_decoder_reader r;
+    uint8_t *window;
+    int window_sz;
+    int base;               /* stream offset of window[0] */
+    int len;                /* valid bytes in the window */
+    int need;               /* lowest offset the parser still reads */
+    cbor_stream_fill *fill;
+    void *fill_arg;
+    uint8_t error;
+};
+
+void cbor_stream_reader_init(struct cbor_stream_reader *csr, uint8_t *window,
+                             int window_sz, size_t message_size,
+                             cbor_stream_fill *fill, void *fill_arg);
+int cbor_stream_reader_feed(struct cbor_stream_reader *csr, const void *data,
+                            int len);
+
+static inline int
+cbor_stream_reader_error(const struct cbor_stream_reader *csr)
+{
+    return csr->error;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CBOR_STREAM_READER_H */
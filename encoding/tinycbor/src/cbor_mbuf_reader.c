@@ -89,3 +89,13 @@ cbor_mbuf_reader_init(struct CborMbufReader *cb, struct os_mbuf *m,
     cb->init_off = initial_offset;
     cb->r.message_size = hdr->omp_len - initial_offset;
 }
+
+void
+cbor_mbuf_reader_init_len(struct CborMbufReader *cb, struct os_mbuf *m,
+                            int initial_offset, int len)
+{
+    cbor_mbuf_reader_init(cb, m, initial_offset);
+    if (len < cb->r.message_size) {
+        cb->r.message_size = len;
+    }
+}
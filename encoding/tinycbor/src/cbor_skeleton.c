@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include <tinycbor/cbor.h>
+#include <tinycbor/cborconstants_p.h>
+#include <tinycbor/cbor_skeleton.h>
+
+CborError
+cbor_skeleton_build(struct cbor_skeleton *skel, uint8_t *buf, size_t buf_sz,
+                    const char * const *keys, unsigned int nkeys)
+{
+    size_t off;
+    size_t len;
+    unsigned int i;
+
+    if (nkeys == 0 || nkeys > CBOR_SKELETON_MAX_KEYS) {
+        return CborErrorIllegalType;
+    }
+
+    off = 0;
+    for (i = 0; i < nkeys; i++) {
+        skel->cs_off[i] = off;
+
+        len = strlen(keys[i]);
+        if (len >= Value8Bit) {
+            /* Key headers longer than one byte are not worth caching. */
+            return CborErrorIllegalType;
+        }
+        if (off + (i == 0) + 1 + len > buf_sz) {
+            return CborErrorOutOfMemory;
+        }
+
+        if (i == 0) {
+            buf[off++] = (MapType << MajorTypeShift) + IndefiniteLength;
+        }
+        buf[off++] = (TextStringType << MajorTypeShift) + len;
+        memcpy(&buf[off], keys[i], len);
+        off += len;
+    }
+    skel->cs_off[nkeys] = off;
+
+    skel->cs_buf = buf;
+    skel->cs_nkeys = nkeys;
+
+    return CborNoError;
+}
+
+CborError
+cbor_skeleton_begin(CborEncoder *encoder, CborEncoder *mapEncoder,
+                    const struct cbor_skeleton *skel)
+{
+    /* Equivalent of cbor_encoder_create_map(CborIndefiniteLength), but
+     * the map-open byte travels with the first key splice so the whole
+     * prefix is a single write.
+     */
+    mapEncoder->writer = encoder->writer;
+    mapEncoder->added = 0;
+    mapEncoder->flags = CborIteratorFlag_ContainerIsMap |
+                        CborIteratorFlag_UnknownLength;
+    ++encoder->added;
+
+    return cbor_encode_raw(mapEncoder, skel->cs_buf, skel->cs_off[1], 1);
+}
+
+CborError
+cbor_skeleton_key(CborEncoder *mapEncoder, const struct cbor_skeleton *skel,
+                  unsigned int idx)
+{
+    if (idx == 0 || idx >= skel->cs_nkeys) {
+        return CborErrorIllegalType;
+    }
+    return cbor_encode_raw(mapEncoder, skel->cs_buf + skel->cs_off[idx],
+                           skel->cs_off[idx + 1] - skel->cs_off[idx], 1);
+}
+
+CborError
+cbor_skeleton_end(CborEncoder *encoder, CborEncoder *mapEncoder)
+{
+    return cbor_encoder_close_container(encoder, mapEncoder);
+}
@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include <tinycbor/cbor_stream_reader.h>
+#include <tinycbor/compilersupport_p.h>
+
+int
+cbor_stream_reader_feed(struct cbor_stream_reader *csr, const void *data,
+                        int len)
+{
+    int drop;
+    int take;
+
+    /* Slide out bytes the parser has moved past; never bytes it still
+     * needs.
+     */
+    drop = csr->need - csr->base;
+    if (drop > csr->len) {
+        drop = csr->len;
+    }
+    if (drop > 0) {
+        memmove(csr->window, csr->window + drop, csr->len - drop);
+        csr->base += drop;
+        csr->len -= drop;
+    }
+    take = csr->window_sz - csr->len;
+    if (take > len) {
+        take = len;
+    }
+    memcpy(csr->window + csr->len, data, take);
+    csr->len += take;
+    return take;
+}
+
+/*
+ * Makes [offset, offset + n) resident in the window, pulling further
+ * fragments through the fill callback as needed.
+ */
+static int
+cbor_stream_ensure(struct cbor_stream_reader *csr, int offset, int n)
+{
+    int had;
+
+    if (offset > csr->need) {
+        csr->need = offset;
+    }
+    while (offset + n > csr->base + csr->len) {
+        had = csr->base + csr->len;
+        if (csr->error || !csr->fill ||
+            csr->fill(csr, csr->fill_arg) != 0 ||
+            csr->base + csr->len == had) {
+            csr->error = 1;
+            return -1;
+        }
+    }
+    if (offset < csr->base) {
+        /* Re-read of bytes the window already slid past. */
+        csr->error = 1;
+        return -1;
+    }
+    return 0;
+}
+
+static uint8_t
+cbor_stream_reader_get8(struct cbor_decoder_reader *d, int offset)
+{
+    struct cbor_stream_reader *csr = (struct cbor_stream_reader *) d;
+
+    if (cbor_stream_ensure(csr, offset, sizeof(uint8_t))) {
+        return 0;
+    }
+    return csr->window[offset - csr->base];
+}
+
+static uint16_t
+cbor_stream_reader_get16(struct cbor_decoder_reader *d, int offset)
+{
+    struct cbor_stream_reader *csr = (struct cbor_stream_reader *) d;
+    uint16_t val;
+
+    if (cbor_stream_ensure(csr, offset, sizeof(val))) {
+        return 0;
+    }
+    memcpy(&val, csr->window + (offset - csr->base), sizeof(val));
+    return cbor_ntohs(val);
+}
+
+static uint32_t
+cbor_stream_reader_get32(struct cbor_decoder_reader *d, int offset)
+{
+    struct cbor_stream_reader *csr = (struct cbor_stream_reader *) d;
+    uint32_t val;
+
+    if (cbor_stream_ensure(csr, offset, sizeof(val))) {
+        return 0;
+    }
+    memcpy(&val, csr->window + (offset - csr->base), sizeof(val));
+    return cbor_ntohl(val);
+}
+
+static uint64_t
+cbor_stream_reader_get64(struct cbor_decoder_reader *d, int offset)
+{
+    struct cbor_stream_reader *csr = (struct cbor_stream_reader *) d;
+    uint64_t val;
+
+    if (cbor_stream_ensure(csr, offset, sizeof(val))) {
+        return 0;
+    }
+    memcpy(&val, csr->window + (offset - csr->base), sizeof(val));
+    return cbor_ntohll(val);
+}
+
+static uintptr_t
+cbor_stream_reader_cmp(struct cbor_decoder_reader *d, char *dst,
+                       int src_offset, size_t len)
+{
+    struct cbor_stream_reader *csr = (struct cbor_stream_reader *) d;
+
+    if (cbor_stream_ensure(csr, src_offset, len)) {
+        return 1;
+    }
+    return memcmp(dst, csr->window + (src_offset - csr->base), len);
+}
+
+static uintptr_t
+cbor_stream_reader_cpy(struct cbor_decoder_reader *d, char *dst,
+                       int src_offset, size_t len)
+{
+    struct cbor_stream_reader *csr = (struct cbor_stream_reader *) d;
+
+    if (cbor_stream_ensure(csr, src_offset, len)) {
+        memset(dst, 0, len);
+        return (uintptr_t) dst;
+    }
+    memcpy(dst, csr->window + (src_offset - csr->base), len);
+    return (uintptr_t) dst;
+}
+
+void
+cbor_stream_reader_init(struct cbor_stream_reader *csr, uint8_t *window,
+                        int window_sz, size_t message_size,
+                        cbor_stream_fill *fill, void *fill_arg)
+{
+    csr->window = window;
+    csr->window_sz = window_sz;
+    csr->base = 0;
+    csr->len = 0;
+    csr->need = 0;
+    csr->fill = fill;
+    csr->fill_arg = fill_arg;
+    csr->error = 0;
+    csr->r.get8 = &cbor_stream_reader_get8;
+    csr->r.get16 = &cbor_stream_reader_get16;
+    csr->r.get32 = &cbor_stream_reader_get32;
+    csr->r.get64 = &cbor_stream_reader_get64;
+    csr->r.cmp = &cbor_stream_reader_cmp;
+    csr->r.cpy = &cbor_stream_reader_cpy;
+    csr->r.message_size = message_size;
+}
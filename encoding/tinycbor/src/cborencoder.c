@@ -417,6 +417,21 @@ CborError cbor_encode_text_string(CborEncoder *encoder, const char *string, size
     return encode_string(encoder, length, TextStringType << MajorTypeShift, string);
 }
 
+/**
+ * Appends \a len bytes of pre-encoded CBOR data \a data to the stream
+ * provided by \a encoder.  The bytes must form \a items complete CBOR items
+ * (keys and values count separately inside a map); the count keeps
+ * cbor_encoder_close_container_checked() working for the enclosing
+ * container.  No validation of the data is performed.
+ *
+ * \sa cbor_skeleton_build
+ */
+CborError cbor_encode_raw(CborEncoder *encoder, const void *data, size_t len, size_t items)
+{
+    encoder->added += items;
+    return append_to_buffer(encoder, data, len);
+}
+
 #ifdef __GNUC__
 __attribute__((noinline))
 #endif
@@ -29,6 +29,8 @@ extern "C" {
 #include <inttypes.h>
 #include <limits.h>
 
+#include "syscfg/syscfg.h"
+
 #include "flash_map/flash_map.h"
 
 #include "os/os_mutex.h"
@@ -46,6 +48,23 @@ struct fcb_entry {
     uint16_t fe_data_len;	/* size of data area */
 };
 
+#if MYNEWT_VAL(FCB_HDR_CACHE)
+/*
+ * Headers (offset and length) of validated elements from the most recently
+ * walked sector.  Elements are immutable until their sector is erased, so a
+ * cache hit fills in an fcb_entry without re-reading the header or
+ * re-checking the CRC from flash.  Invalidated when the sector is rotated
+ * away.
+ */
+struct fcb_hdr_cache {
+    struct flash_area *fhc_area;	/* cached sector; NULL if empty */
+    uint16_t fhc_cnt;			/* number of cached headers */
+    uint32_t fhc_elem_off[MYNEWT_VAL(FCB_HDR_CACHE_SIZE)];
+    uint32_t fhc_data_off[MYNEWT_VAL(FCB_HDR_CACHE_SIZE)];
+    uint16_t fhc_data_len[MYNEWT_VAL(FCB_HDR_CACHE_SIZE)];
+};
+#endif
+
 struct fcb {
     /* Caller of fcb_init fills this in */
     uint32_t f_magic;		/* As placed on the disk */
@@ -60,6 +79,12 @@ struct fcb {
     struct fcb_entry f_active;
     uint16_t f_active_id;
     uint8_t f_align;		/* writes to flash have to aligned to this */
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    struct fcb_sector_index *f_index; /* One per sector; lazily allocated */
+#endif
+#if MYNEWT_VAL(FCB_HDR_CACHE)
+    struct fcb_hdr_cache f_hdr_cache; /* Headers of last-walked sector */
+#endif
 };
 
 /*
@@ -76,12 +101,35 @@ struct fcb {
 
 int fcb_init(struct fcb *fcb);
 
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+/*
+ * One sample of the sparse timestamp index; see fl_ts_slots below.
+ */
+struct fcb_log_ts_slot {
+    int64_t lts_ts;
+    struct flash_area *lts_area;
+    uint32_t lts_elem_off;
+};
+#endif
+
 /*
  * fcb_log is needed as the number of entries in a log
  */
 struct fcb_log {
     struct fcb fl_fcb;
     uint8_t fl_entries;
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+    /*
+     * Sparse timestamp index consulted by log_walk_from_ts(): every
+     * fl_ts_stride-th appended entry's timestamp and flash location,
+     * oldest first.  When the slots fill up, every other sample is
+     * dropped and the stride doubles.
+     */
+    struct fcb_log_ts_slot fl_ts_slots[MYNEWT_VAL(LOG_FCB_TS_INDEX_SLOTS)];
+    uint16_t fl_ts_cnt;
+    uint16_t fl_ts_stride;	/* 0 until the first sample is taken */
+    uint16_t fl_ts_pending;	/* Appends until the next sample */
+#endif
 };
 
 int log_fcb_init(struct fcb_log *fcblog, struct fcb *fcb, uint16_t entries);
@@ -95,6 +143,18 @@ int log_fcb_init(struct fcb_log *fcblog, struct fcb *fcb, uint16_t entries);
 int fcb_append(struct fcb *, uint16_t len, struct fcb_entry *loc);
 int fcb_append_finish(struct fcb *, struct fcb_entry *append_loc);
 
+/*
+ * fcb_append_batch() reserves space for cnt elements with lengths lens[] in
+ * a single critical section and writes all of their headers, filling in
+ * locs[].  Write each element's contents as with fcb_append(), then call
+ * fcb_append_batch_finish() to seal every element of the batch.  The whole
+ * batch is placed in one sector; FCB_ERR_NOSPACE is returned if it cannot
+ * fit.
+ */
+int fcb_append_batch(struct fcb *, int cnt, const uint16_t *lens,
+  struct fcb_entry *locs);
+int fcb_append_batch_finish(struct fcb *, int cnt, struct fcb_entry *locs);
+
 /*
  * Walk over all log entries in FCB, or entries in a given flash_area.
  * cb gets called for every entry. If cb wants to stop the walk, it should
@@ -112,6 +172,15 @@ int fcb_getnext(struct fcb *, struct fcb_entry *loc);
  */
 int fcb_rotate(struct fcb *);
 
+#if MYNEWT_VAL(FCB_BG_ROTATE)
+/*
+ * Rotates from a background task when too few sectors are erased, so the
+ * writer never has to.  out_rotated, which may be null, is set to 1 if a
+ * sector was recycled.
+ */
+int fcb_rotate_step(struct fcb *fcb, int *out_rotated);
+#endif
+
 /*
  * Start using the scratch block.
  */
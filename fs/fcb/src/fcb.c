@@ -39,6 +39,11 @@ fcb_init(struct fcb *fcb)
         return FCB_ERR_ARGS;
     }
 
+#if MYNEWT_VAL(FCB_HDR_CACHE)
+    fcb->f_hdr_cache.fhc_area = NULL;
+    fcb->f_hdr_cache.fhc_cnt = 0;
+#endif
+
     /* Fill last used, first used */
     for (i = 0; i < fcb->f_sector_cnt; i++) {
         fap = &fcb->f_sectors[i];
@@ -218,6 +223,13 @@ fcb_offset_last_n(struct fcb *fcb, uint8_t entries, uint32_t *last_n_off)
     struct fcb_entry start;
     int i;
 
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    if (fcb_index_offset_last_n(fcb, entries, last_n_off) == 0) {
+        return 0;
+    }
+    /* No RAM for the index; fall back to walking every element. */
+#endif
+
     i = 0;
     memset(&loc, 0, sizeof(loc));
     while (!fcb_getnext(fcb, &loc)) {
@@ -122,6 +122,83 @@ err:
     return rc;
 }
 
+int
+fcb_append_batch(struct fcb *fcb, int cnt, const uint16_t *lens,
+  struct fcb_entry *locs)
+{
+    struct fcb_entry *active;
+    struct flash_area *fa;
+    uint8_t tmp_str[2];
+    uint32_t total;
+    int hdr_cnt;
+    int i;
+    int rc;
+
+    if (cnt <= 0) {
+        return FCB_ERR_ARGS;
+    }
+
+    /*
+     * Total flash footprint of the batch; the whole batch is placed in a
+     * single sector.
+     */
+    total = 0;
+    for (i = 0; i < cnt; i++) {
+        hdr_cnt = fcb_put_len(tmp_str, lens[i]);
+        if (hdr_cnt < 0) {
+            return hdr_cnt;
+        }
+        total += fcb_len_in_flash(fcb, hdr_cnt) +
+          fcb_len_in_flash(fcb, lens[i]) +
+          fcb_len_in_flash(fcb, FCB_CRC_SZ);
+    }
+
+    rc = os_mutex_pend(&fcb->f_mtx, OS_WAIT_FOREVER);
+    if (rc && rc != OS_NOT_STARTED) {
+        return FCB_ERR_ARGS;
+    }
+    active = &fcb->f_active;
+    if (active->fe_elem_off + total > active->fe_area->fa_size) {
+        fa = fcb_new_area(fcb, fcb->f_scratch_cnt);
+        if (!fa || (fa->fa_size < sizeof(struct fcb_disk_area) + total)) {
+            rc = FCB_ERR_NOSPACE;
+            goto err;
+        }
+        rc = fcb_sector_hdr_init(fcb, fa, fcb->f_active_id + 1);
+        if (rc) {
+            goto err;
+        }
+        fcb->f_active.fe_area = fa;
+        fcb->f_active.fe_elem_off = sizeof(struct fcb_disk_area);
+        fcb->f_active_id++;
+    }
+
+    for (i = 0; i < cnt; i++) {
+        hdr_cnt = fcb_put_len(tmp_str, lens[i]);
+        rc = flash_area_write(active->fe_area, active->fe_elem_off, tmp_str,
+          hdr_cnt);
+        if (rc) {
+            rc = FCB_ERR_FLASH;
+            goto err;
+        }
+        locs[i].fe_area = active->fe_area;
+        locs[i].fe_elem_off = active->fe_elem_off;
+        locs[i].fe_data_off = active->fe_elem_off +
+          fcb_len_in_flash(fcb, hdr_cnt);
+
+        active->fe_elem_off = locs[i].fe_data_off +
+          fcb_len_in_flash(fcb, lens[i]) +
+          fcb_len_in_flash(fcb, FCB_CRC_SZ);
+    }
+
+    os_mutex_release(&fcb->f_mtx);
+
+    return FCB_OK;
+err:
+    os_mutex_release(&fcb->f_mtx);
+    return rc;
+}
+
 int
 fcb_append_finish(struct fcb *fcb, struct fcb_entry *loc)
 {
@@ -141,3 +218,18 @@ fcb_append_finish(struct fcb *fcb, struct fcb_entry *loc)
     }
     return 0;
 }
+
+int
+fcb_append_batch_finish(struct fcb *fcb, int cnt, struct fcb_entry *locs)
+{
+    int i;
+    int rc;
+
+    for (i = 0; i < cnt; i++) {
+        rc = fcb_append_finish(fcb, &locs[i]);
+        if (rc) {
+            return rc;
+        }
+    }
+    return 0;
+}
@@ -22,6 +22,68 @@
 #include "fcb/fcb.h"
 #include "fcb_priv.h"
 
+#if MYNEWT_VAL(FCB_HDR_CACHE)
+/*
+ * Look the element up in the header cache.  Returns 0 and fills in the
+ * entry if its header was validated before; flash is not touched.
+ */
+static int
+fcb_hdr_cache_find(struct fcb *fcb, struct fcb_entry *loc)
+{
+    struct fcb_hdr_cache *fhc;
+    int i;
+
+    fhc = &fcb->f_hdr_cache;
+    if (fhc->fhc_area != loc->fe_area) {
+        return -1;
+    }
+    for (i = 0; i < fhc->fhc_cnt; i++) {
+        if (fhc->fhc_elem_off[i] == loc->fe_elem_off) {
+            loc->fe_data_off = fhc->fhc_data_off[i];
+            loc->fe_data_len = fhc->fhc_data_len[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Remember the header of a just-validated element.  The cache follows the
+ * walk: when a different sector is seen, the cache restarts there, so one
+ * sector's worth of headers is kept at a time.
+ */
+static void
+fcb_hdr_cache_add(struct fcb *fcb, struct fcb_entry *loc)
+{
+    struct fcb_hdr_cache *fhc;
+
+    fhc = &fcb->f_hdr_cache;
+    if (fhc->fhc_area != loc->fe_area) {
+        fhc->fhc_area = loc->fe_area;
+        fhc->fhc_cnt = 0;
+    }
+    if (fhc->fhc_cnt >= MYNEWT_VAL(FCB_HDR_CACHE_SIZE)) {
+        return;
+    }
+    fhc->fhc_elem_off[fhc->fhc_cnt] = loc->fe_elem_off;
+    fhc->fhc_data_off[fhc->fhc_cnt] = loc->fe_data_off;
+    fhc->fhc_data_len[fhc->fhc_cnt] = loc->fe_data_len;
+    fhc->fhc_cnt++;
+}
+
+/*
+ * Drop cached headers for a sector which is about to be erased.
+ */
+void
+fcb_hdr_cache_invalidate(struct fcb *fcb, struct flash_area *fap)
+{
+    if (fcb->f_hdr_cache.fhc_area == fap) {
+        fcb->f_hdr_cache.fhc_area = NULL;
+        fcb->f_hdr_cache.fhc_cnt = 0;
+    }
+}
+#endif
+
 /*
  * Given offset in flash area, fill in rest of the fcb_entry, and crc8 over
  * the data.
@@ -83,6 +145,12 @@ fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc)
     uint8_t fl_crc8;
     uint32_t off;
 
+#if MYNEWT_VAL(FCB_HDR_CACHE)
+    if (fcb_hdr_cache_find(fcb, loc) == 0) {
+        return 0;
+    }
+#endif
+
     rc = fcb_elem_crc8(fcb, loc, &crc8);
     if (rc) {
         return rc;
@@ -97,5 +165,8 @@ fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc)
     if (fl_crc8 != crc8) {
         return FCB_ERR_CRC;
     }
+#if MYNEWT_VAL(FCB_HDR_CACHE)
+    fcb_hdr_cache_add(fcb, loc);
+#endif
     return 0;
 }
@@ -0,0 +1,243 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "fcb/fcb.h"
+#include "fcb_priv.h"
+
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+
+#define FCB_INDEX_SLOTS		MYNEWT_VAL(FCB_SECTOR_INDEX_SLOTS)
+
+static struct fcb_sector_index *
+fcb_index_for_area(struct fcb *fcb, struct flash_area *fap)
+{
+    return &fcb->f_index[fap - fcb->f_sectors];
+}
+
+void
+fcb_index_invalidate(struct fcb *fcb, struct flash_area *fap)
+{
+    if (fcb->f_index) {
+        fcb_index_for_area(fcb, fap)->fsi_valid = 0;
+    }
+}
+
+/*
+ * Walks the sector starting from start_off and stores the offset of the
+ * skip-th valid element, stepping over elements with bad CRCs the way
+ * fcb_getnext_in_area() does.
+ */
+static int
+fcb_index_nth_elem(struct fcb *fcb, struct flash_area *fap,
+  uint32_t start_off, int skip, uint32_t *out_off)
+{
+    struct fcb_entry loc;
+    int rc;
+
+    loc.fe_area = fap;
+    loc.fe_elem_off = start_off;
+    while (1) {
+        rc = fcb_elem_info(fcb, &loc);
+        if (rc == 0) {
+            if (skip == 0) {
+                *out_off = loc.fe_elem_off;
+                return 0;
+            }
+            skip--;
+        } else if (rc != FCB_ERR_CRC) {
+            /*
+             * End of the used part of the sector.
+             */
+            return rc;
+        }
+        loc.fe_elem_off = loc.fe_data_off +
+          fcb_len_in_flash(fcb, loc.fe_data_len) +
+          fcb_len_in_flash(fcb, FCB_CRC_SZ);
+    }
+}
+
+/*
+ * Counts the valid elements in a sector.  Used for the active sector, which
+ * is still being appended to and therefore is never indexed.
+ */
+static int
+fcb_index_count_elems(struct fcb *fcb, struct flash_area *fap)
+{
+    struct fcb_entry loc;
+    int cnt;
+    int rc;
+
+    loc.fe_area = fap;
+    loc.fe_elem_off = sizeof(struct fcb_disk_area);
+    cnt = 0;
+    while (1) {
+        rc = fcb_elem_info(fcb, &loc);
+        if (rc == 0) {
+            cnt++;
+        } else if (rc != FCB_ERR_CRC) {
+            return cnt;
+        }
+        loc.fe_elem_off = loc.fe_data_off +
+          fcb_len_in_flash(fcb, loc.fe_data_len) +
+          fcb_len_in_flash(fcb, FCB_CRC_SZ);
+    }
+}
+
+/*
+ * Builds the index for a sector by walking it once.  Every element offset is
+ * recorded until the slots fill up; then every other sample is dropped and
+ * the sampling interval doubles, keeping RAM use constant regardless of how
+ * many elements the sector holds.
+ */
+static void
+fcb_index_build(struct fcb *fcb, struct flash_area *fap,
+  struct fcb_sector_index *idx)
+{
+    struct fcb_entry loc;
+    uint32_t slot;
+    uint32_t cnt;
+    int i;
+    int rc;
+
+    cnt = 0;
+    idx->fsi_stride_log2 = 0;
+
+    loc.fe_area = fap;
+    loc.fe_elem_off = sizeof(struct fcb_disk_area);
+    while (1) {
+        rc = fcb_elem_info(fcb, &loc);
+        if (rc == 0) {
+            if ((cnt & ((1 << idx->fsi_stride_log2) - 1)) == 0) {
+                slot = cnt >> idx->fsi_stride_log2;
+                if (slot == FCB_INDEX_SLOTS) {
+                    for (i = 0; i < FCB_INDEX_SLOTS / 2; i++) {
+                        idx->fsi_off[i] = idx->fsi_off[i * 2];
+                    }
+                    idx->fsi_stride_log2++;
+                    slot = cnt >> idx->fsi_stride_log2;
+                }
+                idx->fsi_off[slot] = loc.fe_elem_off;
+            }
+            cnt++;
+        } else if (rc != FCB_ERR_CRC) {
+            break;
+        }
+        loc.fe_elem_off = loc.fe_data_off +
+          fcb_len_in_flash(fcb, loc.fe_data_len) +
+          fcb_len_in_flash(fcb, FCB_CRC_SZ);
+    }
+    idx->fsi_elem_cnt = cnt;
+    idx->fsi_valid = 1;
+}
+
+/*
+ * Indexed version of fcb_offset_last_n().  Counts elements using the
+ * per-sector indexes (walking only the active sector), then jumps to the
+ * sampled offset nearest the target element and walks the remainder.
+ * Returns FCB_ERR_NOMEM if the index cannot be allocated; the caller falls
+ * back to the unindexed walk.
+ */
+int
+fcb_index_offset_last_n(struct fcb *fcb, uint8_t entries,
+  uint32_t *last_n_off)
+{
+    struct fcb_sector_index *idx;
+    struct flash_area *fap;
+    uint32_t total;
+    uint32_t target;
+    uint32_t cum;
+    uint32_t rel;
+    uint32_t slot;
+    int rc;
+
+    rc = os_mutex_pend(&fcb->f_mtx, OS_WAIT_FOREVER);
+    if (rc && rc != OS_NOT_STARTED) {
+        return FCB_ERR_ARGS;
+    }
+    if (!fcb->f_index) {
+        fcb->f_index = malloc(fcb->f_sector_cnt * sizeof(*fcb->f_index));
+        if (!fcb->f_index) {
+            rc = FCB_ERR_NOMEM;
+            goto out;
+        }
+        memset(fcb->f_index, 0,
+          fcb->f_sector_cnt * sizeof(*fcb->f_index));
+    }
+
+    /*
+     * Total up the element counts, building any missing sector indexes
+     * along the way.  The active sector is counted with a walk; it is the
+     * only sector which can still change.
+     */
+    total = 0;
+    fap = fcb->f_oldest;
+    while (fap != fcb->f_active.fe_area) {
+        idx = fcb_index_for_area(fcb, fap);
+        if (!idx->fsi_valid) {
+            fcb_index_build(fcb, fap, idx);
+        }
+        total += idx->fsi_elem_cnt;
+        fap = fcb_getnext_area(fcb, fap);
+    }
+    total += fcb_index_count_elems(fcb, fap);
+
+    if (total == 0) {
+        /*
+         * Empty fcb; like the unindexed walk, leave *last_n_off alone.
+         */
+        rc = 0;
+        goto out;
+    }
+
+    if (total + 1 > (uint32_t)entries) {
+        target = total + 1 - entries;
+    } else {
+        target = 0;
+    }
+    if (target > total - 1) {
+        target = total - 1;
+    }
+
+    cum = 0;
+    fap = fcb->f_oldest;
+    while (1) {
+        rel = target - cum;
+        if (fap == fcb->f_active.fe_area) {
+            rc = fcb_index_nth_elem(fcb, fap, sizeof(struct fcb_disk_area),
+              rel, last_n_off);
+            break;
+        }
+        idx = fcb_index_for_area(fcb, fap);
+        if (rel < idx->fsi_elem_cnt) {
+            slot = rel >> idx->fsi_stride_log2;
+            rc = fcb_index_nth_elem(fcb, fap, idx->fsi_off[slot],
+              rel - (slot << idx->fsi_stride_log2), last_n_off);
+            break;
+        }
+        cum += idx->fsi_elem_cnt;
+        fap = fcb_getnext_area(fcb, fap);
+    }
+out:
+    os_mutex_release(&fcb->f_mtx);
+    return rc;
+}
+
+#endif
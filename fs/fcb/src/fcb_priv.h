@@ -58,6 +58,29 @@ int fcb_sector_hdr_init(struct fcb *, struct flash_area *fap, uint16_t id);
 int fcb_sector_hdr_read(struct fcb *, struct flash_area *fap,
   struct fcb_disk_area *fdap);
 
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+/*
+ * Sampled element offsets for one sector.  Slot i holds the element offset
+ * of the (i << fsi_stride_log2)-th valid element in the sector.  Only built
+ * for sectors which are no longer appended to, so the contents stay valid
+ * until the sector is erased.
+ */
+struct fcb_sector_index {
+    uint32_t fsi_off[MYNEWT_VAL(FCB_SECTOR_INDEX_SLOTS)];
+    uint32_t fsi_elem_cnt;	/* valid elements in the sector */
+    uint8_t fsi_stride_log2;	/* offsets sampled every 2^n elements */
+    uint8_t fsi_valid;
+};
+
+int fcb_index_offset_last_n(struct fcb *fcb, uint8_t entries,
+  uint32_t *last_n_off);
+void fcb_index_invalidate(struct fcb *fcb, struct flash_area *fap);
+#endif
+
+#if MYNEWT_VAL(FCB_HDR_CACHE)
+void fcb_hdr_cache_invalidate(struct fcb *fcb, struct flash_area *fap);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,6 +36,12 @@ fcb_rotate(struct fcb *fcb)
         rc = FCB_ERR_FLASH;
         goto out;
     }
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    fcb_index_invalidate(fcb, fcb->f_oldest);
+#endif
+#if MYNEWT_VAL(FCB_HDR_CACHE)
+    fcb_hdr_cache_invalidate(fcb, fcb->f_oldest);
+#endif
     if (fcb->f_oldest == fcb->f_active.fe_area) {
         /*
          * Need to create a new active area, as we're wiping the current.
@@ -54,3 +60,34 @@ out:
     os_mutex_release(&fcb->f_mtx);
     return rc;
 }
+
+#if MYNEWT_VAL(FCB_BG_ROTATE)
+/*
+ * Rotates the oldest sector away if fewer than FCB_BG_ROTATE_WATERMARK
+ * sectors are erased and ready for use.  Intended to be called periodically
+ * from a low-priority task, so that in steady state the erase has already
+ * happened by the time the writer needs a fresh sector and fcb_append()
+ * never blocks on it.  At most one sector is erased per call.
+ */
+int
+fcb_rotate_step(struct fcb *fcb, int *out_rotated)
+{
+    int rc;
+
+    if (out_rotated) {
+        *out_rotated = 0;
+    }
+    if (fcb_free_sector_cnt(fcb) >= MYNEWT_VAL(FCB_BG_ROTATE_WATERMARK) ||
+        fcb_is_empty(fcb)) {
+        return 0;
+    }
+    rc = fcb_rotate(fcb);
+    if (rc) {
+        return rc;
+    }
+    if (out_rotated) {
+        *out_rotated = 1;
+    }
+    return 0;
+}
+#endif
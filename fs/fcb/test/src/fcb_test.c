@@ -158,6 +158,10 @@ TEST_CASE_DECL(fcb_test_append_fill)
 TEST_CASE_DECL(fcb_test_reset)
 TEST_CASE_DECL(fcb_test_rotate)
 TEST_CASE_DECL(fcb_test_multiple_scratch)
+TEST_CASE_DECL(fcb_test_offset_last_n)
+TEST_CASE_DECL(fcb_test_append_batch)
+TEST_CASE_DECL(fcb_test_rotate_step)
+TEST_CASE_DECL(fcb_test_hdr_cache)
 
 TEST_SUITE(fcb_test_all)
 {
@@ -188,6 +192,18 @@ TEST_SUITE(fcb_test_all)
 
     tu_case_set_pre_cb(fcb_tc_pretest, (void*)4);
     fcb_test_multiple_scratch();
+
+    tu_case_set_pre_cb(fcb_tc_pretest, (void*)2);
+    fcb_test_offset_last_n();
+
+    tu_case_set_pre_cb(fcb_tc_pretest, (void*)2);
+    fcb_test_append_batch();
+
+    tu_case_set_pre_cb(fcb_tc_pretest, (void*)2);
+    fcb_test_rotate_step();
+
+    tu_case_set_pre_cb(fcb_tc_pretest, (void*)2);
+    fcb_test_hdr_cache();
 }
 
 #if MYNEWT_VAL(SELFTEST)
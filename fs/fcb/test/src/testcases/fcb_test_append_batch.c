@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "fcb_test.h"
+
+#define FCB_TEST_BATCH_CNT	32
+
+TEST_CASE(fcb_test_append_batch)
+{
+    struct fcb *fcb;
+    struct fcb_entry locs[FCB_TEST_BATCH_CNT];
+    uint16_t lens[FCB_TEST_BATCH_CNT];
+    uint8_t test_data[FCB_TEST_BATCH_CNT];
+    int i;
+    int j;
+    int var_cnt;
+    int rc;
+
+    fcb = &test_fcb;
+
+    /*
+     * One batch reservation, then the data writes, then one vectored
+     * finish.
+     */
+    for (i = 0; i < FCB_TEST_BATCH_CNT; i++) {
+        lens[i] = i;
+    }
+    rc = fcb_append_batch(fcb, FCB_TEST_BATCH_CNT, lens, locs);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    for (i = 0; i < FCB_TEST_BATCH_CNT; i++) {
+        TEST_ASSERT(locs[i].fe_area == locs[0].fe_area);
+        for (j = 0; j < i; j++) {
+            test_data[j] = fcb_test_append_data(i, j);
+        }
+        rc = flash_area_write(locs[i].fe_area, locs[i].fe_data_off,
+          test_data, i);
+        TEST_ASSERT(rc == 0);
+    }
+
+    rc = fcb_append_batch_finish(fcb, FCB_TEST_BATCH_CNT, locs);
+    TEST_ASSERT(rc == 0);
+
+    var_cnt = 0;
+    rc = fcb_walk(fcb, 0, fcb_test_data_walk_cb, &var_cnt);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(var_cnt == FCB_TEST_BATCH_CNT);
+
+    /*
+     * A batch which cannot fit in a single sector is refused.
+     */
+    for (i = 0; i < FCB_TEST_BATCH_CNT; i++) {
+        lens[i] = 1024;
+    }
+    rc = fcb_append_batch(fcb, FCB_TEST_BATCH_CNT, lens, locs);
+    TEST_ASSERT(rc == FCB_ERR_NOSPACE);
+}
@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "fcb_test.h"
+
+static int
+fcb_test_hdr_cache_count(struct fcb *fcb)
+{
+    struct fcb_entry loc;
+    int cnt;
+
+    memset(&loc, 0, sizeof(loc));
+    cnt = 0;
+    while (fcb_getnext(fcb, &loc) == 0) {
+        cnt++;
+    }
+    return cnt;
+}
+
+TEST_CASE(fcb_test_hdr_cache)
+{
+    struct fcb *fcb;
+    struct fcb_entry loc;
+    uint8_t test_data[128];
+    int elem_cnt;
+    int i;
+    int rc;
+
+    fcb = &test_fcb;
+
+    elem_cnt = 8;
+    for (i = 0; i < elem_cnt; i++) {
+        rc = fcb_append(fcb, sizeof(test_data), &loc);
+        TEST_ASSERT_FATAL(rc == 0);
+        rc = flash_area_write(loc.fe_area, loc.fe_data_off, test_data,
+          sizeof(test_data));
+        TEST_ASSERT(rc == 0);
+        rc = fcb_append_finish(fcb, &loc);
+        TEST_ASSERT(rc == 0);
+    }
+
+    /*
+     * The first walk validates every element from flash and fills the
+     * header cache with the walked sector's headers.
+     */
+    TEST_ASSERT(fcb_test_hdr_cache_count(fcb) == elem_cnt);
+    TEST_ASSERT(fcb->f_hdr_cache.fhc_area == fcb->f_active.fe_area);
+    TEST_ASSERT(fcb->f_hdr_cache.fhc_cnt == elem_cnt);
+
+    /*
+     * A repeated walk is served from the cache and sees the same elements.
+     */
+    TEST_ASSERT(fcb_test_hdr_cache_count(fcb) == elem_cnt);
+    TEST_ASSERT(fcb->f_hdr_cache.fhc_cnt == elem_cnt);
+
+    /*
+     * Elements appended after the cache was built show up in the next walk
+     * and are added to the cache.
+     */
+    rc = fcb_append(fcb, sizeof(test_data), &loc);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = flash_area_write(loc.fe_area, loc.fe_data_off, test_data,
+      sizeof(test_data));
+    TEST_ASSERT(rc == 0);
+    rc = fcb_append_finish(fcb, &loc);
+    TEST_ASSERT(rc == 0);
+
+    TEST_ASSERT(fcb_test_hdr_cache_count(fcb) == elem_cnt + 1);
+    TEST_ASSERT(fcb->f_hdr_cache.fhc_cnt == elem_cnt + 1);
+
+    /*
+     * Rotating the cached sector away drops its cached headers.
+     */
+    rc = fcb_rotate(fcb);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(fcb->f_hdr_cache.fhc_area == NULL);
+    TEST_ASSERT(fcb->f_hdr_cache.fhc_cnt == 0);
+    TEST_ASSERT(fcb_test_hdr_cache_count(fcb) == 0);
+}
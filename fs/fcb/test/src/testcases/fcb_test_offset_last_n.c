@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "fcb_test.h"
+
+/*
+ * Enough 128 byte elements to spill from the first sector into the second,
+ * so that lookups cover both a closed sector and the active one.
+ */
+#define FCB_TEST_LAST_N_ELEMS	200
+
+TEST_CASE(fcb_test_offset_last_n)
+{
+    struct fcb *fcb;
+    struct fcb_entry loc;
+    uint8_t test_data[128];
+    uint32_t elem_offs[FCB_TEST_LAST_N_ELEMS];
+    uint32_t last_n_off;
+    int cnt;
+    int entries;
+    int rc;
+
+    fcb = &test_fcb;
+
+    for (cnt = 0; cnt < FCB_TEST_LAST_N_ELEMS; cnt++) {
+        rc = fcb_append(fcb, sizeof(test_data), &loc);
+        TEST_ASSERT(rc == 0);
+        rc = flash_area_write(loc.fe_area, loc.fe_data_off, test_data,
+          sizeof(test_data));
+        TEST_ASSERT(rc == 0);
+        rc = fcb_append_finish(fcb, &loc);
+        TEST_ASSERT(rc == 0);
+    }
+    TEST_ASSERT(fcb->f_active.fe_area != fcb->f_oldest);
+
+    /*
+     * Collect every element offset with a full walk for reference.
+     */
+    cnt = 0;
+    memset(&loc, 0, sizeof(loc));
+    while (!fcb_getnext(fcb, &loc)) {
+        TEST_ASSERT(cnt < FCB_TEST_LAST_N_ELEMS);
+        elem_offs[cnt++] = loc.fe_elem_off;
+    }
+    TEST_ASSERT(cnt == FCB_TEST_LAST_N_ELEMS);
+
+    for (entries = 2; entries < cnt; entries += 7) {
+        rc = fcb_offset_last_n(fcb, entries, &last_n_off);
+        TEST_ASSERT(rc == 0);
+        TEST_ASSERT(last_n_off == elem_offs[cnt - entries + 1]);
+    }
+
+    /*
+     * Asking for more entries than exist starts from the oldest element.
+     */
+    rc = fcb_offset_last_n(fcb, cnt + 10, &last_n_off);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(last_n_off == elem_offs[0]);
+
+    /*
+     * Rotating away the oldest sector must not leave stale results behind.
+     */
+    rc = fcb_rotate(fcb);
+    TEST_ASSERT(rc == 0);
+
+    cnt = 0;
+    memset(&loc, 0, sizeof(loc));
+    while (!fcb_getnext(fcb, &loc)) {
+        elem_offs[cnt++] = loc.fe_elem_off;
+    }
+    TEST_ASSERT(cnt > 2);
+
+    rc = fcb_offset_last_n(fcb, 2, &last_n_off);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(last_n_off == elem_offs[cnt - 1]);
+}
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "fcb_test.h"
+
+TEST_CASE(fcb_test_rotate_step)
+{
+    struct fcb *fcb;
+    struct fcb_entry loc;
+    uint8_t test_data[128];
+    int rotated;
+    int rc;
+
+    fcb = &test_fcb;
+
+    /*
+     * A sector is still free; the step has nothing to do.
+     */
+    rc = fcb_rotate_step(fcb, &rotated);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(rotated == 0);
+    TEST_ASSERT(fcb_free_sector_cnt(fcb) == 1);
+
+    /*
+     * Fill both sectors so the erased-sector reserve is exhausted.
+     */
+    while (1) {
+        rc = fcb_append(fcb, sizeof(test_data), &loc);
+        if (rc == FCB_ERR_NOSPACE) {
+            break;
+        }
+        TEST_ASSERT(rc == 0);
+        rc = flash_area_write(loc.fe_area, loc.fe_data_off, test_data,
+          sizeof(test_data));
+        TEST_ASSERT(rc == 0);
+        rc = fcb_append_finish(fcb, &loc);
+        TEST_ASSERT(rc == 0);
+    }
+    TEST_ASSERT(fcb_free_sector_cnt(fcb) == 0);
+
+    /*
+     * The step recycles the oldest sector, and appends work again without
+     * the append path having to rotate.
+     */
+    rc = fcb_rotate_step(fcb, &rotated);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(rotated == 1);
+    TEST_ASSERT(fcb_free_sector_cnt(fcb) == 1);
+
+    rc = fcb_rotate_step(fcb, &rotated);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(rotated == 0);
+
+    rc = fcb_append(fcb, sizeof(test_data), &loc);
+    TEST_ASSERT(rc == 0);
+    rc = flash_area_write(loc.fe_area, loc.fe_data_off, test_data,
+      sizeof(test_data));
+    TEST_ASSERT(rc == 0);
+    rc = fcb_append_finish(fcb, &loc);
+    TEST_ASSERT(rc == 0);
+}
@@ -23,6 +23,8 @@
 #include <stddef.h>
 #include <inttypes.h>
 
+#include "syscfg/syscfg.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -42,10 +44,44 @@ int fs_seek(struct fs_file *, uint32_t offset);
 uint32_t fs_getpos(const struct fs_file *);
 int fs_filelen(const struct fs_file *, uint32_t *out_len);
 
+/*
+ * Retrieves a pointer through which a contiguous extent of the file,
+ * starting at the specified offset, can be read in place.  The returned
+ * length may be shorter than requested by the caller's loop; call again
+ * at offset + *out_len for the next extent.  The pointer remains valid
+ * only until the file is written to or unlinked, or until the file system
+ * relocates the underlying data (e.g., garbage collection).  Returns
+ * FS_EUNSUPP if the file's storage is not memory mapped; the caller
+ * should then fall back to fs_read().
+ */
+int fs_mmap(struct fs_file *, uint32_t offset, const void **out_ptr,
+  uint32_t *out_len);
+
 int fs_unlink(const char *filename);
 int fs_rename(const char *from, const char *to);
 int fs_mkdir(const char *path);
 
+#if MYNEWT_VAL(FS_TXN)
+/*
+ * Multi-file transaction.  Files opened with fs_txn_open() are staged
+ * beside their targets and only replace them when fs_txn_commit() is
+ * called; a reset at any point leaves either all old or all new
+ * contents visible after fs_txn_recover() runs at mount time.
+ */
+struct fs_txn {
+    uint8_t ft_num_files;
+    char ft_paths[MYNEWT_VAL(FS_TXN_MAX_FILES)]
+                 [MYNEWT_VAL(FS_TXN_MAX_PATH) + 1];
+};
+
+int fs_txn_begin(struct fs_txn *txn);
+int fs_txn_open(struct fs_txn *txn, const char *filename,
+  struct fs_file **out_file);
+int fs_txn_commit(struct fs_txn *txn);
+int fs_txn_abort(struct fs_txn *txn);
+int fs_txn_recover(void);
+#endif
+
 int fs_opendir(const char *path, struct fs_dir **);
 int fs_readdir(struct fs_dir *, struct fs_dirent **);
 int fs_closedir(struct fs_dir *);
@@ -78,6 +114,7 @@ int fs_dirent_is_dir(const struct fs_dirent *);
 #define FS_EEXIST       11  /* File or directory already exists */
 #define FS_EACCESS      12  /* Operation prohibited by file open mode */
 #define FS_EUNINIT      13  /* File system not initialized */
+#define FS_EUNSUPP      14  /* Operation not supported */
 
 #ifdef __cplusplus
 }
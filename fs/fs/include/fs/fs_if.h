@@ -38,6 +38,8 @@ struct fs_ops {
     int (*f_seek)(struct fs_file *file, uint32_t offset);
     uint32_t (*f_getpos)(const struct fs_file *file);
     int (*f_filelen)(const struct fs_file *file, uint32_t *out_len);
+    int (*f_mmap)(struct fs_file *file, uint32_t offset,
+      const void **out_ptr, uint32_t *out_len);
 
     int (*f_unlink)(const char *filename);
     int (*f_rename)(const char *from, const char *to);
@@ -63,6 +63,16 @@ fs_filelen(const struct fs_file *file, uint32_t *out_len)
     return fs_root_ops->f_filelen(file, out_len);
 }
 
+int
+fs_mmap(struct fs_file *file, uint32_t offset, const void **out_ptr,
+  uint32_t *out_len)
+{
+    if (fs_root_ops->f_mmap == NULL) {
+        return FS_EUNSUPP;
+    }
+    return fs_root_ops->f_mmap(file, offset, out_ptr, out_len);
+}
+
 int
 fs_unlink(const char *filename)
 {
@@ -0,0 +1,270 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+#include "fs/fs.h"
+#include "fs_priv.h"
+
+#if MYNEWT_VAL(FS_TXN)
+
+/*
+ * Each file in a transaction is written to a staging file next to its
+ * target ("<target>.fstx").  fs_txn_commit() then writes a journal file
+ * listing the targets and renames every staging file into place; since
+ * the underlying file system overwrites a rename destination with a
+ * single metadata update, each individual rename is atomic, and the
+ * journal makes the set atomic: until the journal write completes, a
+ * reset leaves all the old files in place (fs_txn_recover() discards
+ * the staging files' journal and they get truncated by the next
+ * transaction); once it has completed, fs_txn_recover() replays any
+ * renames the reset interrupted.
+ *
+ * The journal holds a file count, a length-prefixed path per file and
+ * a trailing magic number, written with a single fs_write().  A journal
+ * without the trailing magic is an incomplete commit and is discarded.
+ */
+#define FS_TXN_JOURNAL_PATH     "/.fstxn"
+#define FS_TXN_STAGE_SUFFIX     ".fstx"
+#define FS_TXN_MAGIC            0x3c98f2b5
+
+#define FS_TXN_JOURNAL_MAX_LEN                                          \
+    (1 + MYNEWT_VAL(FS_TXN_MAX_FILES) *                                 \
+         (1 + MYNEWT_VAL(FS_TXN_MAX_PATH)) + sizeof (uint32_t))
+
+static void
+fs_txn_stage_path(const char *path, char *dst)
+{
+    strcpy(dst, path);
+    strcat(dst, FS_TXN_STAGE_SUFFIX);
+}
+
+int
+fs_txn_begin(struct fs_txn *txn)
+{
+    txn->ft_num_files = 0;
+    return FS_EOK;
+}
+
+/**
+ * Opens the staging file for one of a transaction's target files.  The
+ * caller writes the new contents through the returned handle and closes
+ * it before committing; the target file is untouched until then.
+ */
+int
+fs_txn_open(struct fs_txn *txn, const char *filename,
+  struct fs_file **out_file)
+{
+    char stage_path[MYNEWT_VAL(FS_TXN_MAX_PATH) +
+                    sizeof FS_TXN_STAGE_SUFFIX];
+    int rc;
+
+    if (txn->ft_num_files >= MYNEWT_VAL(FS_TXN_MAX_FILES)) {
+        return FS_ENOMEM;
+    }
+    if (strlen(filename) > MYNEWT_VAL(FS_TXN_MAX_PATH)) {
+        return FS_EINVAL;
+    }
+
+    fs_txn_stage_path(filename, stage_path);
+    rc = fs_open(stage_path, FS_ACCESS_WRITE | FS_ACCESS_TRUNCATE, out_file);
+    if (rc != 0) {
+        return rc;
+    }
+
+    strcpy(txn->ft_paths[txn->ft_num_files], filename);
+    txn->ft_num_files++;
+    return FS_EOK;
+}
+
+/**
+ * Atomically replaces all of a transaction's target files with their
+ * staged contents.  The journal write is the commit point; if this
+ * function fails after it, the journal is left behind and
+ * fs_txn_recover() finishes the renames on the next mount.
+ */
+int
+fs_txn_commit(struct fs_txn *txn)
+{
+    uint8_t buf[FS_TXN_JOURNAL_MAX_LEN];
+    char stage_path[MYNEWT_VAL(FS_TXN_MAX_PATH) +
+                    sizeof FS_TXN_STAGE_SUFFIX];
+    struct fs_file *file;
+    uint32_t magic;
+    int off;
+    int len;
+    int rc;
+    int i;
+
+    if (txn->ft_num_files == 0) {
+        return FS_EOK;
+    }
+
+    off = 0;
+    buf[off++] = txn->ft_num_files;
+    for (i = 0; i < txn->ft_num_files; i++) {
+        len = strlen(txn->ft_paths[i]);
+        buf[off++] = len;
+        memcpy(buf + off, txn->ft_paths[i], len);
+        off += len;
+    }
+    magic = FS_TXN_MAGIC;
+    memcpy(buf + off, &magic, sizeof magic);
+    off += sizeof magic;
+
+    rc = fs_open(FS_TXN_JOURNAL_PATH, FS_ACCESS_WRITE | FS_ACCESS_TRUNCATE,
+      &file);
+    if (rc != 0) {
+        return rc;
+    }
+    rc = fs_write(file, buf, off);
+    fs_close(file);
+    if (rc != 0) {
+        fs_unlink(FS_TXN_JOURNAL_PATH);
+        return rc;
+    }
+
+    for (i = 0; i < txn->ft_num_files; i++) {
+        fs_txn_stage_path(txn->ft_paths[i], stage_path);
+        rc = fs_rename(stage_path, txn->ft_paths[i]);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    txn->ft_num_files = 0;
+    return fs_unlink(FS_TXN_JOURNAL_PATH);
+}
+
+/**
+ * Discards a transaction's staged contents; the target files are left
+ * untouched.
+ */
+int
+fs_txn_abort(struct fs_txn *txn)
+{
+    char stage_path[MYNEWT_VAL(FS_TXN_MAX_PATH) +
+                    sizeof FS_TXN_STAGE_SUFFIX];
+    int i;
+
+    for (i = 0; i < txn->ft_num_files; i++) {
+        fs_txn_stage_path(txn->ft_paths[i], stage_path);
+        fs_unlink(stage_path);
+    }
+    txn->ft_num_files = 0;
+    return FS_EOK;
+}
+
+/**
+ * Completes or discards a transaction that a reset interrupted.  Called
+ * once after the file system has been mounted, before any transactions
+ * are started.
+ */
+int
+fs_txn_recover(void)
+{
+    uint8_t buf[FS_TXN_JOURNAL_MAX_LEN];
+    char stage_path[MYNEWT_VAL(FS_TXN_MAX_PATH) +
+                    sizeof FS_TXN_STAGE_SUFFIX];
+    char target[MYNEWT_VAL(FS_TXN_MAX_PATH) + 1];
+    struct fs_file *file;
+    uint32_t body_len;
+    uint32_t magic;
+    uint32_t len;
+    int committed;
+    int off;
+    int cnt;
+    int rc;
+    int n;
+    int i;
+
+    rc = fs_open(FS_TXN_JOURNAL_PATH, FS_ACCESS_READ, &file);
+    if (rc == FS_ENOENT) {
+        return FS_EOK;
+    }
+    if (rc != 0) {
+        return rc;
+    }
+    rc = fs_read(file, sizeof buf, buf, &len);
+    fs_close(file);
+    if (rc != 0) {
+        return rc;
+    }
+
+    committed = 0;
+    if (len >= 1 + sizeof magic) {
+        memcpy(&magic, buf + len - sizeof magic, sizeof magic);
+        if (magic == FS_TXN_MAGIC) {
+            body_len = len - sizeof magic;
+            cnt = buf[0];
+            off = 1;
+            for (i = 0; i < cnt; i++) {
+                if (off >= body_len) {
+                    break;
+                }
+                n = buf[off++];
+                if (n == 0 || n > MYNEWT_VAL(FS_TXN_MAX_PATH) ||
+                    off + n > body_len) {
+                    break;
+                }
+                off += n;
+            }
+            if (i == cnt && off == body_len) {
+                committed = 1;
+            }
+        }
+    }
+    if (!committed) {
+        /*
+         * The journal write did not complete, so the commit never
+         * happened and the old files are all intact; roll back.
+         */
+        return fs_unlink(FS_TXN_JOURNAL_PATH);
+    }
+
+    /* Roll forward; redo any renames the reset interrupted. */
+    cnt = buf[0];
+    off = 1;
+    for (i = 0; i < cnt; i++) {
+        n = buf[off++];
+        memcpy(target, buf + off, n);
+        target[n] = '\0';
+        off += n;
+
+        fs_txn_stage_path(target, stage_path);
+        rc = fs_open(stage_path, FS_ACCESS_READ, &file);
+        if (rc == FS_ENOENT) {
+            /* This file was already renamed before the reset. */
+            continue;
+        }
+        if (rc != 0) {
+            return rc;
+        }
+        fs_close(file);
+
+        rc = fs_rename(stage_path, target);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+    return fs_unlink(FS_TXN_JOURNAL_PATH);
+}
+
+#endif /* MYNEWT_VAL(FS_TXN) */
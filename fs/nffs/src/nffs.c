@@ -47,12 +47,24 @@ struct os_mempool nffs_inode_entry_pool;
 struct os_mempool nffs_block_entry_pool;
 struct os_mempool nffs_cache_inode_pool;
 struct os_mempool nffs_cache_block_pool;
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+struct os_mempool nffs_cache_data_pool;
+#endif
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+struct os_mempool nffs_write_buf_pool;
+#endif
 
 void *nffs_file_mem;
 void *nffs_inode_mem;
 void *nffs_block_entry_mem;
 void *nffs_cache_inode_mem;
 void *nffs_cache_block_mem;
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+void *nffs_cache_data_mem;
+#endif
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+void *nffs_write_buf_mem;
+#endif
 void *nffs_dir_mem;
 
 struct nffs_inode_entry *nffs_root_dir;
@@ -71,6 +83,8 @@ static int nffs_write(struct fs_file *fs_file, const void *data, int len);
 static int nffs_seek(struct fs_file *fs_file, uint32_t offset);
 static uint32_t nffs_getpos(const struct fs_file *fs_file);
 static int nffs_file_len(const struct fs_file *fs_file, uint32_t *out_len);
+static int nffs_mmap(struct fs_file *fs_file, uint32_t offset,
+  const void **out_ptr, uint32_t *out_len);
 static int nffs_unlink(const char *path);
 static int nffs_rename(const char *from, const char *to);
 static int nffs_mkdir(const char *path);
@@ -90,6 +104,7 @@ static const struct fs_ops nffs_ops = {
     .f_seek = nffs_seek,
     .f_getpos = nffs_getpos,
     .f_filelen = nffs_file_len,
+    .f_mmap = nffs_mmap,
 
     .f_unlink = nffs_unlink,
     .f_rename = nffs_rename,
@@ -299,6 +314,12 @@ nffs_file_len(const struct fs_file *fs_file, uint32_t *out_len)
 
     nffs_lock();
     rc = nffs_inode_data_len(file->nf_inode_entry, out_len);
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    /* The buffered tail counts toward the file's length. */
+    if (rc == 0) {
+        *out_len += file->nf_wb_len;
+    }
+#endif
     nffs_unlock();
 
     return rc;
@@ -330,6 +351,37 @@ nffs_read(struct fs_file *fs_file, uint32_t len, void *out_data,
     return rc;
 }
 
+/**
+ * Retrieves a pointer to a contiguous extent of the specified file's data,
+ * read in place from memory-mapped flash.  The extent spans at most one data
+ * block; the caller iterates by repeating the call at offset + *out_len.
+ * Returns FS_EUNSUPP if the underlying flash is not memory mapped; the caller
+ * should then fall back to nffs_read().  The pointer remains valid only until
+ * the file is written to or unlinked, or until garbage collection relocates
+ * the data.
+ *
+ * @param fs_file           The file to map.
+ * @param offset            The offset within the file to map from.
+ * @param out_ptr           On success, points to the file contents.
+ * @param out_len           On success, the number of contiguous bytes
+ *                              readable via *out_ptr.
+ *
+ * @return                  0 on success; nonzero on failure.
+ */
+static int
+nffs_mmap(struct fs_file *fs_file, uint32_t offset, const void **out_ptr,
+          uint32_t *out_len)
+{
+    int rc;
+    struct nffs_file *file = (struct nffs_file *)fs_file;
+
+    nffs_lock();
+    rc = nffs_file_mmap(file, offset, out_ptr, out_len);
+    nffs_unlock();
+
+    return rc;
+}
+
 /**
  * Writes the supplied data to the current offset of the specified file handle.
  *
@@ -657,6 +709,113 @@ nffs_detect(const struct nffs_area_desc *area_descs)
     return rc;
 }
 
+#if MYNEWT_VAL(NFFS_CHECKPOINT)
+/**
+ * Writes a checkpoint of the file system metadata to the scratch area.  A
+ * subsequent call to nffs_detect() restores the RAM representation from the
+ * checkpoint and replays only the objects written afterwards, instead of
+ * scanning the entire flash.  Garbage collection invalidates the
+ * checkpoint; call this again when the file system is quiescent, e.g., at
+ * clean shutdown.
+ *
+ * @return                  0 on success;
+ *                          FS_EUNINIT if the file system is not ready;
+ *                          other nonzero on failure.
+ */
+int
+nffs_checkpoint(void)
+{
+    int rc;
+
+    nffs_lock();
+    if (!nffs_misc_ready()) {
+        rc = FS_EUNINIT;
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+    } else if (nffs_gc_src_area() != -1) {
+        /* The scratch area is currently the garbage collection destination;
+         * a checkpoint cannot be written until the cycle completes.
+         */
+        rc = FS_EACCESS;
+#endif
+    } else {
+        rc = nffs_checkpoint_write();
+    }
+    nffs_unlock();
+
+    return rc;
+}
+#endif
+
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+/**
+ * Flushes the specified file's buffered appends to flash.  Data written
+ * through a file handle becomes durable only once its write-behind buffer
+ * fills to a whole block, the file is closed, or this function is called.
+ *
+ * @param fs_file           The file to synchronize.
+ *
+ * @return                  0 on success; nonzero on error.
+ */
+int
+nffs_sync(struct fs_file *fs_file)
+{
+    struct nffs_file *file;
+    int rc;
+
+    file = (struct nffs_file *)fs_file;
+
+    nffs_lock();
+    if (!nffs_misc_ready()) {
+        rc = FS_EUNINIT;
+    } else {
+        rc = nffs_write_flush(file);
+    }
+    nffs_unlock();
+
+    return rc;
+}
+#endif
+
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+/**
+ * Performs a bounded slice of garbage collection.  At most NFFS_GC_STEP_OBJS
+ * objects are migrated per call, so the time the file system stays locked is
+ * bounded regardless of area size.  Intended to be called repeatedly from a
+ * low-priority task.  A new collection cycle is begun only if an unfinished
+ * cycle exists or no area has NFFS_GC_WATERMARK bytes free.
+ *
+ * @param out_done          On success, 0 gets written here if more work
+ *                              remains; 1 if there is nothing left to do.
+ *                              Pass null if you do not need this information.
+ *
+ * @return                  0 on success; nonzero on error.
+ */
+int
+nffs_gc_step(int *out_done)
+{
+    int done;
+    int rc;
+
+    nffs_lock();
+    if (!nffs_misc_ready()) {
+        rc = FS_EUNINIT;
+        done = 1;
+    } else if (!nffs_gc_needed()) {
+        rc = 0;
+        done = 1;
+    } else {
+        rc = nffs_gc_slice(MYNEWT_VAL(NFFS_GC_STEP_OBJS), NULL, &done);
+    }
+    nffs_unlock();
+
+    if (out_done != NULL) {
+        *out_done = done;
+    }
+
+    return rc;
+}
+#endif
+
 /**
  * Initializes internal nffs memory and data structures.  This must be called
  * before any nffs operations are attempted.
@@ -721,6 +880,26 @@ nffs_init(void)
         return FS_ENOMEM;
     }
 
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+    free(nffs_cache_data_mem);
+    nffs_cache_data_mem = malloc(
+        OS_MEMPOOL_BYTES(MYNEWT_VAL(NFFS_CACHE_DATA),
+                         NFFS_BLOCK_MAX_DATA_SZ_MAX));
+    if (nffs_cache_data_mem == NULL) {
+        return FS_ENOMEM;
+    }
+#endif
+
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    free(nffs_write_buf_mem);
+    nffs_write_buf_mem = malloc(
+        OS_MEMPOOL_BYTES(MYNEWT_VAL(NFFS_WRITE_BUF),
+                         NFFS_BLOCK_MAX_DATA_SZ_MAX));
+    if (nffs_write_buf_mem == NULL) {
+        return FS_ENOMEM;
+    }
+#endif
+
     free(nffs_dir_mem);
     nffs_dir_mem = malloc(
         OS_MEMPOOL_BYTES(nffs_config.nc_num_dirs,
@@ -788,4 +967,14 @@ nffs_pkg_init(void)
         SYSINIT_PANIC();
         break;
     }
+
+#if MYNEWT_VAL(FS_TXN)
+    if (rc == 0) {
+        /* Complete or discard a multi-file transaction that a reset
+         * interrupted.
+         */
+        rc = fs_txn_recover();
+        SYSINIT_PANIC_ASSERT(rc == 0);
+    }
+#endif
 }
@@ -446,6 +446,30 @@ nffs_block_read_data(const struct nffs_block *block, uint16_t offset,
     return 0;
 }
 
+/**
+ * Retrieves a pointer through which a block's data can be read directly from
+ * memory-mapped flash.  Returns NULL if the underlying flash device is not
+ * memory mapped or the block has no data on flash yet.
+ */
+const void *
+nffs_block_mapped(const struct nffs_block *block, uint16_t offset,
+                  uint16_t length)
+{
+    uint32_t area_offset;
+    uint8_t area_idx;
+
+    if (nffs_block_is_dummy(block->nb_hash_entry)) {
+        return NULL;
+    }
+
+    nffs_flash_loc_expand(block->nb_hash_entry->nhe_flash_loc,
+                         &area_idx, &area_offset);
+    area_offset += sizeof (struct nffs_disk_block);
+    area_offset += offset;
+
+    return nffs_flash_mapped(area_idx, area_offset, length);
+}
+
 int
 nffs_block_is_dummy(struct nffs_hash_entry *entry)
 {
@@ -28,6 +28,74 @@ static struct nffs_cache_inode_list nffs_cache_inode_list =
 
 static void nffs_cache_reclaim_blocks(void);
 
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+/**
+ * Acquires a data buffer for caching block contents.  If the buffer pool is
+ * empty, the buffer belonging to the coldest buffered block is stolen.
+ * Returns null if no buffer could be obtained.
+ */
+static uint8_t *
+nffs_cache_data_acquire(const struct nffs_cache_block *for_block)
+{
+    struct nffs_cache_inode *cache_inode;
+    struct nffs_cache_block *cache_block;
+    uint8_t *buf;
+
+    buf = os_memblock_get(&nffs_cache_data_pool);
+    if (buf != NULL) {
+        return buf;
+    }
+
+    TAILQ_FOREACH_REVERSE(cache_inode, &nffs_cache_inode_list,
+                          nffs_cache_inode_list, nci_link) {
+        TAILQ_FOREACH(cache_block, &cache_inode->nci_block_list, ncb_link) {
+            if (cache_block->ncb_data != NULL && cache_block != for_block) {
+                buf = cache_block->ncb_data;
+                cache_block->ncb_data = NULL;
+                return buf;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void
+nffs_cache_data_release(struct nffs_cache_block *cache_block)
+{
+    if (cache_block->ncb_data != NULL) {
+        os_memblock_put(&nffs_cache_data_pool, cache_block->ncb_data);
+        cache_block->ncb_data = NULL;
+    }
+}
+
+/**
+ * Reads the full contents of the specified cached block into a data buffer.
+ * This is a best-effort operation; on failure, the block simply remains
+ * unbuffered and subsequent reads fall back to flash.
+ */
+static void
+nffs_cache_data_fill(struct nffs_cache_block *cache_block)
+{
+    uint8_t *buf;
+    int rc;
+
+    buf = nffs_cache_data_acquire(cache_block);
+    if (buf == NULL) {
+        return;
+    }
+
+    rc = nffs_block_read_data(&cache_block->ncb_block, 0,
+                              cache_block->ncb_block.nb_data_len, buf);
+    if (rc != 0) {
+        os_memblock_put(&nffs_cache_data_pool, buf);
+        return;
+    }
+
+    cache_block->ncb_data = buf;
+}
+#endif
+
 static struct nffs_cache_block *
 nffs_cache_block_alloc(void)
 {
@@ -45,6 +113,9 @@ static void
 nffs_cache_block_free(struct nffs_cache_block *entry)
 {
     if (entry != NULL) {
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+        nffs_cache_data_release(entry);
+#endif
         os_memblock_put(&nffs_cache_block_pool, entry);
     }
 }
@@ -496,6 +567,73 @@ nffs_cache_seek(struct nffs_cache_inode *cache_inode, uint32_t seek_offset,
     return 0;
 }
 
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+/**
+ * Reads data from the specified cached block, preferring the block's data
+ * buffer over flash.  When the owning inode is being read sequentially, the
+ * block's full contents are buffered on first access and the next cached
+ * block is prefetched, so a sequential stream of reads performs one flash
+ * access per block instead of one per read call.
+ *
+ * @param cache_inode           The cached inode that owns the block.
+ * @param cache_block           The cached block to read from.
+ * @param block_off             The offset within the block to read from.
+ * @param len                   The number of bytes to read.
+ * @param dst                   The destination buffer.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+nffs_cache_block_read_data(struct nffs_cache_inode *cache_inode,
+                           struct nffs_cache_block *cache_block,
+                           uint16_t block_off, uint16_t len, void *dst)
+{
+    struct nffs_cache_block *next_block;
+    int rc;
+
+    if (cache_block->ncb_data == NULL && cache_inode->nci_seq) {
+        nffs_cache_data_fill(cache_block);
+    }
+
+    if (cache_block->ncb_data != NULL) {
+        memcpy(dst, cache_block->ncb_data + block_off, len);
+    } else {
+        rc = nffs_block_read_data(&cache_block->ncb_block, block_off, len,
+                                  dst);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    /* Read ahead: buffer the contents of the following cached block so the
+     * next sequential read is serviced from RAM.
+     */
+    if (cache_inode->nci_seq) {
+        next_block = TAILQ_NEXT(cache_block, ncb_link);
+        if (next_block != NULL && next_block->ncb_data == NULL) {
+            nffs_cache_data_fill(next_block);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Frees the data buffers belonging to the specified inode's cached blocks.
+ * This must be called before existing block contents are overwritten; the
+ * cached block metadata remains valid.
+ */
+void
+nffs_cache_data_invalidate(struct nffs_cache_inode *cache_inode)
+{
+    struct nffs_cache_block *cache_block;
+
+    TAILQ_FOREACH(cache_block, &cache_inode->nci_block_list, ncb_link) {
+        nffs_cache_data_release(cache_block);
+    }
+}
+#endif
+
 /**
  * Frees all cached inodes and blocks.
  */
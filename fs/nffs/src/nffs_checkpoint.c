@@ -0,0 +1,604 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Metadata checkpointing.
+ *
+ * A checkpoint is a serialized copy of the in-RAM object table (hash
+ * entries, inode relationships and ID allocators), stored in the scratch
+ * area.  Restoring from a checkpoint replaces the full-flash object scan
+ * that nffs_restore_full() otherwise performs on mount: the RAM state is
+ * rebuilt from the checkpoint records, and only the objects written after
+ * the checkpoint was taken get replayed from each area's recorded write
+ * offset.
+ *
+ * Layout, immediately following the scratch area's header:
+ *
+ *     | marker | checkpoint header | area records | object records |
+ *
+ * The marker word is written first and the header (containing the magic
+ * number and CRC) last, so a write interrupted by a reset never yields a
+ * valid checkpoint, but always leaves the marker indicating that the
+ * scratch area is no longer erased.  Garbage collection reformats the
+ * scratch area before using it if the marker is set, which also
+ * invalidates the checkpoint; relocated objects make a checkpoint stale,
+ * and the per-area garbage collection sequence check at load time would
+ * reject it anyway.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "hal/hal_flash.h"
+#include "nffs/nffs.h"
+#include "nffs_priv.h"
+
+#if MYNEWT_VAL(NFFS_CHECKPOINT)
+
+/** The set of inode flags that a checkpointable entry may have. */
+#define NFFS_CHECKPOINT_OK_FLAGS    (NFFS_INODE_FLAG_INHASH |       \
+                                     NFFS_INODE_FLAG_INTREE)
+
+/**
+ * Writes a chunk of checkpoint data to the scratch area.  This bypasses
+ * nffs_flash_write() deliberately: the scratch area's write offset must
+ * remain untouched, and the checkpoint header gets written after the
+ * records that follow it.
+ */
+static int
+nffs_checkpoint_flash_write(uint32_t area_offset, const void *data,
+                            uint32_t len)
+{
+    const struct nffs_area *area;
+    int rc;
+
+    area = nffs_areas + nffs_scratch_area_idx;
+
+    if (area_offset + len > area->na_length) {
+        return FS_EOFFSET;
+    }
+
+    rc = hal_flash_write(area->na_flash_id, area->na_offset + area_offset,
+                         data, len);
+    if (rc != 0) {
+        return FS_EHW;
+    }
+
+    return 0;
+}
+
+/**
+ * Indicates whether the scratch area contains anything beyond its header.
+ *
+ * @param out_dirty             On success, 0 or 1 gets written here.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+nffs_checkpoint_scratch_dirty(int *out_dirty)
+{
+    uint32_t marker;
+    int rc;
+
+    rc = nffs_flash_read(nffs_scratch_area_idx, NFFS_CHECKPOINT_AREA_OFFSET,
+                         &marker, sizeof marker);
+    if (rc != 0) {
+        return rc;
+    }
+
+    *out_dirty = marker != 0xffffffff;
+    return 0;
+}
+
+/**
+ * Prepares the scratch area for use by garbage collection.  If the scratch
+ * area contains checkpoint data, it gets reformatted so that the area is
+ * fully erased.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+nffs_checkpoint_gc_prep(void)
+{
+    int dirty;
+    int rc;
+
+    rc = nffs_checkpoint_scratch_dirty(&dirty);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (dirty) {
+        rc = nffs_format_area(nffs_scratch_area_idx, 1);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Serializes the in-RAM file system state into a checkpoint in the scratch
+ * area.  Only a fully-consistent state can be checkpointed; the presence of
+ * any dummy or obsolete object causes this function to fail.
+ *
+ * @return                      0 on success;
+ *                              FS_EUNEXP if the RAM state is not clean;
+ *                              FS_EFULL if the checkpoint does not fit in
+ *                                  the scratch area;
+ *                              other nonzero on failure.
+ */
+int
+nffs_checkpoint_write(void)
+{
+    struct nffs_disk_checkpoint_area disk_cp_area;
+    struct nffs_disk_checkpoint_obj disk_obj;
+    struct nffs_disk_checkpoint disk_cp;
+    struct nffs_inode_entry *inode_entry;
+    struct nffs_hash_entry *entry;
+    struct nffs_hash_entry *next;
+    struct nffs_inode inode;
+    uint8_t area_map[NFFS_MAX_AREAS];
+    const struct nffs_area *area;
+    uint32_t num_objs;
+    uint32_t data_len;
+    uint32_t marker;
+    uint32_t off;
+    uint16_t crc;
+    uint16_t obj_len;
+    uint8_t num_areas;
+    int dirty;
+    int rc;
+    int i;
+
+    if (nffs_scratch_area_idx == NFFS_AREA_ID_NONE) {
+        return FS_ECORRUPT;
+    }
+
+    /* First pass: ensure the RAM state is clean and calculate the
+     * checkpoint size.
+     */
+    num_objs = 0;
+    data_len = 0;
+    NFFS_HASH_FOREACH(entry, i, next) {
+        if (nffs_hash_id_is_block(entry->nhe_id)) {
+            if (nffs_block_is_dummy(entry)) {
+                return FS_EUNEXP;
+            }
+            data_len += NFFS_CHECKPOINT_OBJ_BLOCK_SZ;
+        } else {
+            inode_entry = (struct nffs_inode_entry *)entry;
+            if ((inode_entry->nie_flags & ~NFFS_CHECKPOINT_OK_FLAGS) != 0) {
+                return FS_EUNEXP;
+            }
+            data_len += sizeof disk_obj;
+        }
+        num_objs++;
+    }
+
+    num_areas = 0;
+    for (i = 0; i < nffs_num_areas; i++) {
+        if (i != nffs_scratch_area_idx) {
+            area_map[i] = num_areas;
+            num_areas++;
+        }
+    }
+    data_len += num_areas * sizeof disk_cp_area;
+
+    area = nffs_areas + nffs_scratch_area_idx;
+    if (NFFS_CHECKPOINT_AREA_OFFSET + sizeof marker + sizeof disk_cp +
+        data_len > area->na_length) {
+
+        return FS_EFULL;
+    }
+
+    /* If the scratch area already contains a checkpoint, erase it. */
+    rc = nffs_checkpoint_scratch_dirty(&dirty);
+    if (rc != 0) {
+        return rc;
+    }
+    if (dirty) {
+        rc = nffs_format_area(nffs_scratch_area_idx, 1);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    /* Write the marker first; it renders the scratch area dirty before any
+     * other checkpoint data hits the flash.
+     */
+    marker = 0;
+    rc = nffs_checkpoint_flash_write(NFFS_CHECKPOINT_AREA_OFFSET, &marker,
+                                     sizeof marker);
+    if (rc != 0) {
+        return rc;
+    }
+
+    /* Write the area records. */
+    off = NFFS_CHECKPOINT_AREA_OFFSET + sizeof marker + sizeof disk_cp;
+    crc = 0;
+    for (i = 0; i < nffs_num_areas; i++) {
+        if (i == nffs_scratch_area_idx) {
+            continue;
+        }
+        area = nffs_areas + i;
+
+        memset(&disk_cp_area, 0, sizeof disk_cp_area);
+        disk_cp_area.nca_offset = area->na_offset;
+        disk_cp_area.nca_length = area->na_length;
+        disk_cp_area.nca_cur = area->na_cur;
+        disk_cp_area.nca_flash_id = area->na_flash_id;
+        disk_cp_area.nca_gc_seq = area->na_gc_seq;
+        disk_cp_area.nca_id = area->na_id;
+
+        rc = nffs_checkpoint_flash_write(off, &disk_cp_area,
+                                         sizeof disk_cp_area);
+        if (rc != 0) {
+            return rc;
+        }
+        crc = crc16_ccitt(crc, &disk_cp_area, sizeof disk_cp_area);
+        off += sizeof disk_cp_area;
+    }
+
+    /* Write one record per object in the hash table. */
+    NFFS_HASH_FOREACH(entry, i, next) {
+        memset(&disk_obj, 0, sizeof disk_obj);
+        disk_obj.nco_id = entry->nhe_id;
+        disk_obj.nco_flash_loc =
+            area_map[entry->nhe_flash_loc >> 24] << 24 |
+            (entry->nhe_flash_loc & 0x00ffffff);
+
+        if (nffs_hash_id_is_block(entry->nhe_id)) {
+            obj_len = NFFS_CHECKPOINT_OBJ_BLOCK_SZ;
+        } else {
+            inode_entry = (struct nffs_inode_entry *)entry;
+
+            rc = nffs_inode_from_entry(&inode, inode_entry);
+            if (rc != 0) {
+                return rc;
+            }
+            disk_obj.nco_parent_id = nffs_inode_parent_id(&inode);
+
+            if (nffs_hash_id_is_file(entry->nhe_id) &&
+                inode_entry->nie_last_block_entry != NULL) {
+
+                disk_obj.nco_lastblock_id =
+                    inode_entry->nie_last_block_entry->nhe_id;
+            } else {
+                disk_obj.nco_lastblock_id = NFFS_ID_NONE;
+            }
+
+            disk_obj.nco_refcnt = inode_entry->nie_refcnt;
+            disk_obj.nco_flags = inode_entry->nie_flags;
+            disk_obj.nco_blkcnt = inode_entry->nie_blkcnt;
+            obj_len = sizeof disk_obj;
+        }
+
+        rc = nffs_checkpoint_flash_write(off, &disk_obj, obj_len);
+        if (rc != 0) {
+            return rc;
+        }
+        crc = crc16_ccitt(crc, &disk_obj, obj_len);
+        off += obj_len;
+    }
+
+    /* Write the header last; an interrupted checkpoint write must never
+     * produce a valid magic number and CRC.
+     */
+    memset(&disk_cp, 0, sizeof disk_cp);
+    disk_cp.ncp_magic = NFFS_CHECKPOINT_MAGIC;
+    disk_cp.ncp_ver = NFFS_CHECKPOINT_VER;
+    disk_cp.ncp_num_areas = num_areas;
+    disk_cp.ncp_crc16 = crc;
+    disk_cp.ncp_data_len = data_len;
+    disk_cp.ncp_num_objs = num_objs;
+    disk_cp.ncp_next_file_id = nffs_hash_next_file_id;
+    disk_cp.ncp_next_dir_id = nffs_hash_next_dir_id;
+    disk_cp.ncp_next_block_id = nffs_hash_next_block_id;
+    disk_cp.ncp_block_data_len = nffs_block_max_data_sz;
+
+    rc = nffs_checkpoint_flash_write(NFFS_CHECKPOINT_AREA_OFFSET +
+                                     sizeof marker,
+                                     &disk_cp, sizeof disk_cp);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+
+/**
+ * Reads a single object record from a checkpoint and advances the supplied
+ * offset past it.
+ */
+static int
+nffs_checkpoint_read_obj(uint32_t *inout_off,
+                         struct nffs_disk_checkpoint_obj *out_disk_obj)
+{
+    uint16_t obj_len;
+    int rc;
+
+    rc = nffs_flash_read(nffs_scratch_area_idx, *inout_off, out_disk_obj,
+                         NFFS_CHECKPOINT_OBJ_BLOCK_SZ);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (nffs_hash_id_is_block(out_disk_obj->nco_id)) {
+        obj_len = NFFS_CHECKPOINT_OBJ_BLOCK_SZ;
+    } else {
+        rc = nffs_flash_read(nffs_scratch_area_idx, *inout_off,
+                             out_disk_obj, sizeof *out_disk_obj);
+        if (rc != 0) {
+            return rc;
+        }
+        obj_len = sizeof *out_disk_obj;
+    }
+
+    *inout_off += obj_len;
+    return 0;
+}
+
+/**
+ * Removes and frees every entry in the hash table.  Used to unwind a
+ * partially-loaded checkpoint so that the caller can fall back to a full
+ * restore.
+ */
+static void
+nffs_checkpoint_unload(void)
+{
+    struct nffs_hash_entry *entry;
+    struct nffs_hash_entry *next;
+    int i;
+
+    NFFS_HASH_FOREACH(entry, i, next) {
+        nffs_hash_remove(entry);
+        if (nffs_hash_id_is_block(entry->nhe_id)) {
+            nffs_block_entry_free(entry);
+        } else {
+            nffs_inode_entry_free((struct nffs_inode_entry *)entry);
+        }
+    }
+
+    nffs_root_dir = NULL;
+}
+
+/**
+ * Attempts to rebuild the RAM representation from a checkpoint in the
+ * scratch area.  The checkpoint is only used if its CRC is valid and its
+ * area records exactly match the set of detected areas; a mismatched
+ * garbage collection sequence number indicates that objects have moved
+ * since the checkpoint was taken.  On success, the tail of each area (the
+ * objects written after the checkpoint) has been replayed as well.
+ *
+ * On failure, the RAM representation is left empty, so the caller can
+ * proceed with a full restore.
+ *
+ * @param out_block_data_len    On success, the maximum block data size in
+ *                                  effect when the checkpoint was taken gets
+ *                                  written here.
+ *
+ * @return                      0 on success; nonzero if no usable
+ *                                  checkpoint is present.
+ */
+int
+nffs_checkpoint_load(uint16_t *out_block_data_len)
+{
+    struct nffs_disk_checkpoint_area disk_cp_area;
+    struct nffs_disk_checkpoint_obj disk_obj;
+    struct nffs_disk_checkpoint disk_cp;
+    struct nffs_inode_entry *inode_entry;
+    struct nffs_inode_entry *parent;
+    struct nffs_hash_entry *entry;
+    struct nffs_area *area;
+    uint8_t area_map[NFFS_MAX_AREAS];
+    uint8_t buf[32];
+    uint32_t records_off;
+    uint32_t chunk_len;
+    uint32_t remlen;
+    uint32_t off;
+    uint32_t end;
+    uint32_t n;
+    uint16_t crc;
+    uint8_t area_idx;
+    int found;
+    int rc;
+    int i;
+
+    rc = nffs_flash_read(nffs_scratch_area_idx,
+                         NFFS_CHECKPOINT_AREA_OFFSET + 4,
+                         &disk_cp, sizeof disk_cp);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (disk_cp.ncp_magic != NFFS_CHECKPOINT_MAGIC ||
+        disk_cp.ncp_ver != NFFS_CHECKPOINT_VER) {
+
+        return FS_EUNEXP;
+    }
+
+    if (disk_cp.ncp_num_areas != nffs_num_areas - 1) {
+        return FS_EUNEXP;
+    }
+
+    off = NFFS_CHECKPOINT_AREA_OFFSET + 4 + sizeof disk_cp;
+    end = off + disk_cp.ncp_data_len;
+    if (end > nffs_areas[nffs_scratch_area_idx].na_length) {
+        return FS_EUNEXP;
+    }
+
+    /* Verify the CRC before acting on any of the checkpoint contents. */
+    crc = 0;
+    remlen = disk_cp.ncp_data_len;
+    while (remlen > 0) {
+        chunk_len = remlen > sizeof buf ? sizeof buf : remlen;
+        rc = nffs_flash_read(nffs_scratch_area_idx, end - remlen, buf,
+                             chunk_len);
+        if (rc != 0) {
+            return rc;
+        }
+        crc = crc16_ccitt(crc, buf, chunk_len);
+        remlen -= chunk_len;
+    }
+    if (crc != disk_cp.ncp_crc16) {
+        return FS_ECORRUPT;
+    }
+
+    /* Match each area record against a detected area.  Any discrepancy
+     * means the checkpoint does not describe the current contents of the
+     * flash.
+     */
+    for (n = 0; n < disk_cp.ncp_num_areas; n++) {
+        rc = nffs_flash_read(nffs_scratch_area_idx, off, &disk_cp_area,
+                             sizeof disk_cp_area);
+        if (rc != 0) {
+            return rc;
+        }
+        off += sizeof disk_cp_area;
+
+        found = 0;
+        for (i = 0; i < nffs_num_areas; i++) {
+            area = nffs_areas + i;
+            if (i != nffs_scratch_area_idx &&
+                area->na_flash_id == disk_cp_area.nca_flash_id &&
+                area->na_offset == disk_cp_area.nca_offset) {
+
+                if (area->na_length != disk_cp_area.nca_length ||
+                    area->na_id != disk_cp_area.nca_id ||
+                    area->na_gc_seq != disk_cp_area.nca_gc_seq ||
+                    disk_cp_area.nca_cur > area->na_length) {
+
+                    return FS_EUNEXP;
+                }
+
+                area_map[n] = i;
+                area->na_cur = disk_cp_area.nca_cur;
+                found = 1;
+                break;
+            }
+        }
+        if (!found) {
+            return FS_EUNEXP;
+        }
+    }
+    records_off = off;
+
+    /* First pass: create a hash entry per object record. */
+    for (n = 0; n < disk_cp.ncp_num_objs; n++) {
+        if (off >= end) {
+            goto err;
+        }
+        rc = nffs_checkpoint_read_obj(&off, &disk_obj);
+        if (rc != 0) {
+            goto err;
+        }
+
+        area_idx = disk_obj.nco_flash_loc >> 24;
+        if (area_idx >= disk_cp.ncp_num_areas) {
+            goto err;
+        }
+
+        if (nffs_hash_id_is_block(disk_obj.nco_id)) {
+            entry = nffs_block_entry_alloc();
+        } else {
+            inode_entry = nffs_inode_entry_alloc();
+            entry = &inode_entry->nie_hash_entry;
+        }
+        if (entry == NULL) {
+            goto err;
+        }
+
+        entry->nhe_id = disk_obj.nco_id;
+        entry->nhe_flash_loc =
+            nffs_flash_loc(area_map[area_idx],
+                           disk_obj.nco_flash_loc & 0x00ffffff);
+        nffs_hash_insert(entry);
+
+        if (entry->nhe_id == NFFS_ID_ROOT_DIR) {
+            nffs_root_dir = (struct nffs_inode_entry *)entry;
+        }
+    }
+    if (off != end) {
+        goto err;
+    }
+
+    /* Second pass: rebuild the inode relationships. */
+    off = records_off;
+    for (n = 0; n < disk_cp.ncp_num_objs; n++) {
+        rc = nffs_checkpoint_read_obj(&off, &disk_obj);
+        if (rc != 0) {
+            goto err;
+        }
+        if (nffs_hash_id_is_block(disk_obj.nco_id)) {
+            continue;
+        }
+
+        inode_entry = nffs_hash_find_inode(disk_obj.nco_id);
+        assert(inode_entry != NULL);
+
+        if (disk_obj.nco_parent_id != NFFS_ID_NONE) {
+            parent = nffs_hash_find_inode(disk_obj.nco_parent_id);
+            if (parent == NULL) {
+                goto err;
+            }
+            rc = nffs_inode_add_child(parent, inode_entry);
+            if (rc != 0) {
+                goto err;
+            }
+        }
+
+        if (nffs_hash_id_is_file(disk_obj.nco_id) &&
+            disk_obj.nco_lastblock_id != NFFS_ID_NONE) {
+
+            inode_entry->nie_last_block_entry =
+                nffs_hash_find_block(disk_obj.nco_lastblock_id);
+            if (inode_entry->nie_last_block_entry == NULL) {
+                goto err;
+            }
+        }
+
+        inode_entry->nie_refcnt = disk_obj.nco_refcnt;
+        inode_entry->nie_blkcnt = disk_obj.nco_blkcnt;
+        inode_entry->nie_flags = disk_obj.nco_flags;
+    }
+
+    nffs_hash_next_file_id = disk_cp.ncp_next_file_id;
+    nffs_hash_next_dir_id = disk_cp.ncp_next_dir_id;
+    nffs_hash_next_block_id = disk_cp.ncp_next_block_id;
+    *out_block_data_len = disk_cp.ncp_block_data_len;
+
+    /* Replay the objects that were written after the checkpoint. */
+    for (i = 0; i < nffs_num_areas; i++) {
+        if (i != nffs_scratch_area_idx) {
+            rc = nffs_restore_area_tail(i, nffs_areas[i].na_cur);
+            if (rc != 0) {
+                goto err;
+            }
+        }
+    }
+
+    return 0;
+
+err:
+    nffs_checkpoint_unload();
+    return FS_ECORRUPT;
+}
+
+#endif /* MYNEWT_VAL(NFFS_CHECKPOINT) */
@@ -273,6 +273,11 @@ nffs_file_seek(struct nffs_file *file, uint32_t offset)
         return rc;
     }
 
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    /* The buffered tail counts toward the file's length. */
+    len += file->nf_wb_len;
+#endif
+
     if (offset > len) {
         return FS_EOFFSET;
     }
@@ -309,6 +314,14 @@ nffs_file_read(struct nffs_file *file, uint32_t len, void *out_data,
         return FS_EACCESS;
     }
 
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    /* Buffered appends must be on flash before they can be read back. */
+    rc = nffs_write_flush(file);
+    if (rc != 0) {
+        return rc;
+    }
+#endif
+
     rc = nffs_inode_read(file->nf_inode_entry, file->nf_offset, len, out_data,
                         &bytes_read);
     if (rc != 0) {
@@ -323,6 +336,50 @@ nffs_file_read(struct nffs_file *file, uint32_t len, void *out_data,
     return 0;
 }
 
+/**
+ * Retrieves a pointer to a contiguous extent of the specified file's data,
+ * read in place from memory-mapped flash.  The file's read offset is not
+ * affected; the caller passes an explicit offset and iterates by repeating
+ * the call at offset + *out_len.
+ *
+ * @param file              The file to map.
+ * @param offset            The offset within the file to map from.
+ * @param out_ptr           On success, points to the file contents.
+ * @param out_len           On success, the number of contiguous bytes
+ *                              readable via *out_ptr.
+ *
+ * @return                  0 on success;
+ *                          FS_EUNSUPP if the underlying flash is not memory
+ *                              mapped (fall back to nffs_file_read());
+ *                          other nonzero on failure.
+ */
+int
+nffs_file_mmap(struct nffs_file *file, uint32_t offset, const void **out_ptr,
+               uint32_t *out_len)
+{
+    if (!nffs_misc_ready()) {
+        return FS_EUNINIT;
+    }
+
+    if (!(file->nf_access_flags & FS_ACCESS_READ)) {
+        return FS_EACCESS;
+    }
+
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    {
+        int rc;
+
+        /* Buffered appends must be on flash before they can be read back. */
+        rc = nffs_write_flush(file);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+#endif
+
+    return nffs_inode_mmap(file->nf_inode_entry, offset, out_ptr, out_len);
+}
+
 /**
  * Closes the specified file and invalidates the file handle.  If the file has
  * already been unlinked, and this is the last open handle to the file, this
@@ -337,6 +394,26 @@ nffs_file_close(struct nffs_file *file)
 {
     int rc;
 
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    /* Flush buffered appends, unless the file has been unlinked; blocks
+     * appended to a deleted inode would just be orphaned.
+     */
+    if (file->nf_inode_entry->nie_hash_entry.nhe_flash_loc !=
+        NFFS_FLASH_LOC_NONE) {
+
+        rc = nffs_write_flush(file);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    if (file->nf_wb_buf != NULL) {
+        os_memblock_put(&nffs_write_buf_pool, file->nf_wb_buf);
+        file->nf_wb_buf = NULL;
+        file->nf_wb_len = 0;
+    }
+#endif
+
     rc = nffs_inode_dec_refcnt(file->nf_inode_entry);
     if (rc != 0) {
         return rc;
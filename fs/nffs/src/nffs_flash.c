@@ -64,6 +64,35 @@ nffs_flash_read(uint8_t area_idx, uint32_t area_offset, void *data,
     return 0;
 }
 
+/**
+ * Retrieves a pointer through which a chunk of flash can be read directly,
+ * bypassing the copy into RAM.
+ *
+ * @param area_idx              The index of the area to read from.
+ * @param area_offset           The offset within the area to read from.
+ * @param len                   The number of bytes that will be read.
+ *
+ * @return                      A pointer to the flash contents on success;
+ *                              NULL if the flash device is not memory mapped
+ *                                  or the address range is invalid.
+ */
+const void *
+nffs_flash_mapped(uint8_t area_idx, uint32_t area_offset, uint32_t len)
+{
+    const struct nffs_area *area;
+
+    assert(area_idx < nffs_num_areas);
+
+    area = nffs_areas + area_idx;
+
+    if (area_offset + len > area->na_length) {
+        return NULL;
+    }
+
+    return hal_flash_get_mapped(area->na_flash_id,
+                                area->na_offset + area_offset, len);
+}
+
 /**
  * Writes a chunk of data to flash.
  *
@@ -18,6 +18,7 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <string.h>
 #include "os/os_malloc.h"
 #include "testutil/testutil.h"
@@ -31,6 +32,89 @@
  */
 unsigned int nffs_gc_count;
 
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+/**
+ * State of the in-progress garbage collection cycle.  A cycle begun by an
+ * nffs_gc_step() slice persists across invocations; the blocking nffs_gc()
+ * resumes and completes it.
+ */
+static struct {
+    uint8_t ngi_active;         /* 1 if a cycle is in progress. */
+    uint8_t ngi_from_area_idx;  /* The area being collected. */
+    uint32_t ngi_bucket;        /* The next hash bucket to scan. */
+    uint8_t ngi_bg_cycles;      /* Cycles completed since the last write. */
+} nffs_gc_inc_state;
+
+/** The number of objects the current slice may still migrate. */
+static int nffs_gc_budget;
+
+/**
+ * Indicates which area is being emptied by the in-progress garbage
+ * collection cycle.  New data must not be written to this area; objects the
+ * scan has already passed would be lost when the area gets erased.
+ *
+ * @return                      The index of the source area, or -1 if no
+ *                                  cycle is in progress.
+ */
+int
+nffs_gc_src_area(void)
+{
+    if (nffs_gc_inc_state.ngi_active) {
+        return nffs_gc_inc_state.ngi_from_area_idx;
+    }
+
+    return -1;
+}
+
+/**
+ * Notes that flash space was just consumed.  New garbage may now exist, so
+ * background collection becomes worthwhile again.
+ */
+void
+nffs_gc_note_write(void)
+{
+    nffs_gc_inc_state.ngi_bg_cycles = 0;
+}
+
+/**
+ * Determines whether a garbage collection slice has work to do.  This is the
+ * case if a cycle is already in progress, or if the configured free-space
+ * watermark is unmet.
+ */
+int
+nffs_gc_needed(void)
+{
+    int i;
+
+    if (nffs_gc_inc_state.ngi_active) {
+        return 1;
+    }
+
+    if (MYNEWT_VAL(NFFS_GC_WATERMARK) == 0) {
+        return 0;
+    }
+
+    /* If every area has been collected since the last write and the
+     * watermark still isn't met, further cycles can't help; they would just
+     * wear the flash.
+     */
+    if (nffs_gc_inc_state.ngi_bg_cycles >= nffs_num_areas) {
+        return 0;
+    }
+
+    for (i = 0; i < nffs_num_areas; i++) {
+        if (i != nffs_scratch_area_idx &&
+            nffs_area_free_space(nffs_areas + i) >=
+                MYNEWT_VAL(NFFS_GC_WATERMARK)) {
+
+            return 0;
+        }
+    }
+
+    return 1;
+}
+#endif
+
 static int
 nffs_gc_copy_object(struct nffs_hash_entry *entry, uint16_t object_size,
                     uint8_t to_area_idx)
@@ -52,6 +136,10 @@ nffs_gc_copy_object(struct nffs_hash_entry *entry, uint16_t object_size,
 
     entry->nhe_flash_loc = nffs_flash_loc(to_area_idx, to_area_offset);
 
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+    nffs_gc_budget--;
+#endif
+
     return 0;
 }
 
@@ -226,6 +314,10 @@ nffs_gc_block_chain_collate(struct nffs_hash_entry *last_entry,
             last_block = block;
         }
         entry = block.nb_prev;
+
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+        nffs_gc_budget--;
+#endif
     }
 
     /* we had better have found the last block */
@@ -342,6 +434,16 @@ nffs_gc_inode_blocks(struct nffs_inode_entry *inode_entry,
     multiple_blocks = 0;
     entry = inode_entry->nie_last_block_entry;
     while (entry != NULL) {
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+        /* If the slice budget is exhausted, stop here.  Nothing has been
+         * accumulated that isn't already on flash; the next slice re-walks
+         * the chain and skips the blocks that were already migrated.
+         */
+        if (nffs_gc_budget <= 0) {
+            return 0;
+        }
+#endif
+
         rc = nffs_block_from_hash_entry(&block, entry);
         if (rc != 0) {
             return rc;
@@ -398,80 +500,70 @@ nffs_gc_inode_blocks(struct nffs_inode_entry *inode_entry,
 }
 
 /**
- * Triggers a garbage collection cycle.  This is implemented as follows:
- *
- *  (1) The non-scratch area with the lowest garbage collection sequence
- *      number is selected as the "source area."  If there are other areas
- *      with the same sequence number, the first one encountered is selected.
- *
- *  (2) The source area's ID is written to the scratch area's header,
- *      transforming it into a non-scratch ID.  The former scratch area is now
- *      known as the "destination area."
- *
- *  (3) The RAM representation is exhaustively searched for objects which are
- *      resident in the source area.  The copy is accomplished as follows:
- *
- *      For each inode:
- *          (a) If the inode is resident in the source area, copy the inode
- *              record to the destination area.
- *
- *          (b) Walk the inode's list of data blocks, starting with the last
- *              block in the file.  Each block that is resident in the source
- *              area is copied to the destination area.  If there is a run of
- *              two or more blocks that are resident in the source area, they
- *              are consolidated and copied to the destination area as a single
- *              new block.
- *
- *  (4) The source area is reformatted as a scratch sector (i.e., its header
- *      indicates an ID of 0xffff).  The area's garbage collection sequence
- *      number is incremented prior to rewriting the header.  This area is now
- *      the new scratch sector.
- *
- * NOTE:
- *     Garbage collection invalidates all cached data blocks.  Whenever this
- *     function is called, all existing nffs_cache_block pointers are rendered
- *     invalid.  If you maintain any such pointers, you need to reset them
- *     after calling this function.  Cached inodes are not invalidated by
- *     garbage collection.
- *
- *     If a parent function potentially calls this function, the caller of the
- *     parent function needs to explicitly check if garbage collection
- *     occurred.  This is done by inspecting the nffs_gc_count variable before
- *     and after calling the function.
- *
- * @param out_area_idx      On success, the ID of the cleaned up area gets
- *                              written here.  Pass null if you do not need
- *                              this information.
- *
- * @return                  0 on success; nonzero on error.
+ * Begins a garbage collection cycle: selects the source area and converts
+ * the scratch area into the destination area.
  */
-int
-nffs_gc(uint8_t *out_area_idx)
+static int
+nffs_gc_cycle_begin(uint8_t *out_from_area_idx)
 {
-    struct nffs_hash_entry *entry;
-    struct nffs_hash_entry *next;
-    struct nffs_area *from_area;
-    struct nffs_area *to_area;
-    struct nffs_inode_entry *inode_entry;
-    uint32_t area_offset;
     uint8_t from_area_idx;
-    uint8_t area_idx;
     int rc;
-    int i;
 
     from_area_idx = nffs_gc_select_area();
-    from_area = nffs_areas + from_area_idx;
-    to_area = nffs_areas + nffs_scratch_area_idx;
+
+#if MYNEWT_VAL(NFFS_CHECKPOINT)
+    /* If a checkpoint resides in the scratch area, erase it; garbage
+     * collection requires a fully erased destination area.
+     */
+    rc = nffs_checkpoint_gc_prep();
+    if (rc != 0) {
+        return rc;
+    }
+#endif
 
     rc = nffs_format_from_scratch_area(nffs_scratch_area_idx,
-                                       from_area->na_id);
+                                       nffs_areas[from_area_idx].na_id);
     if (rc != 0) {
         return rc;
     }
 
-    for (i = 0; i < NFFS_HASH_SIZE; i++) {
+    *out_from_area_idx = from_area_idx;
+
+    return 0;
+}
+
+/**
+ * Migrates objects out of the source area, starting at the specified hash
+ * bucket.  On return, *inout_bucket points to the bucket the next invocation
+ * should resume from; a value of NFFS_HASH_NUM_BUCKETS indicates the scan is
+ * complete.  When incremental collection is enabled, the scan stops once the
+ * slice budget is exhausted.
+ */
+static int
+nffs_gc_scan(uint8_t from_area_idx, int *inout_bucket)
+{
+    struct nffs_inode_entry *inode_entry;
+    struct nffs_hash_entry *entry;
+    struct nffs_hash_entry *next;
+    uint32_t area_offset;
+    uint8_t area_idx;
+    int rc;
+    int i;
+
+    for (i = *inout_bucket; i < (int)NFFS_HASH_NUM_BUCKETS; i++) {
         entry = SLIST_FIRST(nffs_hash + i);
         while (entry != NULL) {
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+            if (nffs_gc_budget <= 0) {
+                /* Slice budget exhausted.  Resume from the start of this
+                 * bucket; objects that have already been migrated are no
+                 * longer resident in the source area and get skipped.
+                 */
+                *inout_bucket = i;
+                return 0;
+            }
+#endif
+
             next = SLIST_NEXT(entry, nhe_next);
 
             if (nffs_hash_id_is_inode(entry->nhe_id)) {
@@ -503,10 +595,30 @@ nffs_gc(uint8_t *out_area_idx)
         }
     }
 
+    *inout_bucket = i;
+
+    return 0;
+}
+
+/**
+ * Completes a garbage collection cycle: turns the emptied source area into
+ * the new scratch area and refreshes the cache.
+ */
+static int
+nffs_gc_cycle_finish(uint8_t from_area_idx, uint8_t *out_area_idx)
+{
+    struct nffs_area *from_area;
+    int rc;
+
+    from_area = nffs_areas + from_area_idx;
+
+#if !MYNEWT_VAL(NFFS_GC_INCREMENTAL)
     /* The amount of written data should never increase as a result of a gc
-     * cycle.
+     * cycle.  (With incremental collection, writes interleaved with the scan
+     * may land in the destination area, so this does not hold.)
      */
-    assert(to_area->na_cur <= from_area->na_cur);
+    assert(nffs_areas[nffs_scratch_area_idx].na_cur <= from_area->na_cur);
+#endif
 
     /* Turn the source area into the new scratch area. */
     from_area->na_gc_seq++;
@@ -540,6 +652,147 @@ nffs_gc(uint8_t *out_area_idx)
     return 0;
 }
 
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+/**
+ * Performs one slice of garbage collection, migrating at most "budget"
+ * objects.  If no cycle is in progress, one is begun.  The cycle's state
+ * persists across invocations until the cycle completes.
+ *
+ * @param budget                The maximum number of objects to migrate;
+ *                                  pass a negative value for no limit.
+ * @param out_area_idx          On cycle completion, the ID of the cleaned up
+ *                                  area gets written here.  Pass null if you
+ *                                  do not need this information.
+ * @param out_done              On success, 0 gets written here if the cycle
+ *                                  is still in progress; 1 if it completed.
+ *
+ * @return                      0 on success; nonzero on error.
+ */
+int
+nffs_gc_slice(int budget, uint8_t *out_area_idx, int *out_done)
+{
+    int bucket;
+    int rc;
+
+    nffs_gc_budget = budget < 0 ? INT_MAX : budget;
+
+    if (!nffs_gc_inc_state.ngi_active) {
+        rc = nffs_gc_cycle_begin(&nffs_gc_inc_state.ngi_from_area_idx);
+        if (rc != 0) {
+            return rc;
+        }
+
+        nffs_gc_inc_state.ngi_active = 1;
+        nffs_gc_inc_state.ngi_bucket = 0;
+    }
+
+    bucket = nffs_gc_inc_state.ngi_bucket;
+    rc = nffs_gc_scan(nffs_gc_inc_state.ngi_from_area_idx, &bucket);
+    if (rc != 0) {
+        return rc;
+    }
+    nffs_gc_inc_state.ngi_bucket = bucket;
+
+    if (bucket < (int)NFFS_HASH_NUM_BUCKETS) {
+        *out_done = 0;
+        return 0;
+    }
+
+    rc = nffs_gc_cycle_finish(nffs_gc_inc_state.ngi_from_area_idx,
+                              out_area_idx);
+    if (rc != 0) {
+        return rc;
+    }
+
+    nffs_gc_inc_state.ngi_active = 0;
+    if (nffs_gc_inc_state.ngi_bg_cycles < nffs_num_areas) {
+        nffs_gc_inc_state.ngi_bg_cycles++;
+    }
+    *out_done = 1;
+
+    return 0;
+}
+#endif
+
+/**
+ * Triggers a garbage collection cycle.  This is implemented as follows:
+ *
+ *  (1) The non-scratch area with the lowest garbage collection sequence
+ *      number is selected as the "source area."  If there are other areas
+ *      with the same sequence number, the first one encountered is selected.
+ *
+ *  (2) The source area's ID is written to the scratch area's header,
+ *      transforming it into a non-scratch ID.  The former scratch area is now
+ *      known as the "destination area."
+ *
+ *  (3) The RAM representation is exhaustively searched for objects which are
+ *      resident in the source area.  The copy is accomplished as follows:
+ *
+ *      For each inode:
+ *          (a) If the inode is resident in the source area, copy the inode
+ *              record to the destination area.
+ *
+ *          (b) Walk the inode's list of data blocks, starting with the last
+ *              block in the file.  Each block that is resident in the source
+ *              area is copied to the destination area.  If there is a run of
+ *              two or more blocks that are resident in the source area, they
+ *              are consolidated and copied to the destination area as a single
+ *              new block.
+ *
+ *  (4) The source area is reformatted as a scratch sector (i.e., its header
+ *      indicates an ID of 0xffff).  The area's garbage collection sequence
+ *      number is incremented prior to rewriting the header.  This area is now
+ *      the new scratch sector.
+ *
+ * NOTE:
+ *     Garbage collection invalidates all cached data blocks.  Whenever this
+ *     function is called, all existing nffs_cache_block pointers are rendered
+ *     invalid.  If you maintain any such pointers, you need to reset them
+ *     after calling this function.  Cached inodes are not invalidated by
+ *     garbage collection.
+ *
+ *     If a parent function potentially calls this function, the caller of the
+ *     parent function needs to explicitly check if garbage collection
+ *     occurred.  This is done by inspecting the nffs_gc_count variable before
+ *     and after calling the function.
+ *
+ * @param out_area_idx      On success, the ID of the cleaned up area gets
+ *                              written here.  Pass null if you do not need
+ *                              this information.
+ *
+ * @return                  0 on success; nonzero on error.
+ */
+int
+nffs_gc(uint8_t *out_area_idx)
+{
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+    int done;
+
+    /* Resume and complete the in-progress cycle, if any; otherwise perform
+     * a full cycle.
+     */
+    return nffs_gc_slice(-1, out_area_idx, &done);
+#else
+    uint8_t from_area_idx;
+    int bucket;
+    int rc;
+
+    rc = nffs_gc_cycle_begin(&from_area_idx);
+    if (rc != 0) {
+        return rc;
+    }
+
+    bucket = 0;
+    rc = nffs_gc_scan(from_area_idx, &bucket);
+    if (rc != 0) {
+        return rc;
+    }
+    assert(bucket == (int)NFFS_HASH_NUM_BUCKETS);
+
+    return nffs_gc_cycle_finish(from_area_idx, out_area_idx);
+#endif
+}
+
 /**
  * Repeatedly performs garbage collection cycles until there is enough free
  * space to accommodate an object of the specified size.  If there still isn't
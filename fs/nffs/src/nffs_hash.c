@@ -25,6 +25,10 @@
 
 struct nffs_hash_list *nffs_hash;
 
+#if MYNEWT_VAL(NFFS_HASH_DYNAMIC)
+uint32_t nffs_hash_num_buckets;
+#endif
+
 uint32_t nffs_hash_next_dir_id;
 uint32_t nffs_hash_next_file_id;
 uint32_t nffs_hash_next_block_id;
@@ -56,7 +60,12 @@ nffs_hash_id_is_block(uint32_t id)
 static int
 nffs_hash_fn(uint32_t id)
 {
+#if MYNEWT_VAL(NFFS_HASH_DYNAMIC)
+    /* The bucket count is always a power of two. */
+    return id & (nffs_hash_num_buckets - 1);
+#else
     return id % NFFS_HASH_SIZE;
+#endif
 }
 
 static struct nffs_hash_entry *
@@ -197,16 +206,32 @@ nffs_hash_remove(struct nffs_hash_entry *entry)
 int
 nffs_hash_init(void)
 {
-    int i;
+    uint32_t i;
+
+#if MYNEWT_VAL(NFFS_HASH_DYNAMIC)
+    uint32_t capacity;
+
+    /* Size the bucket array so that the average chain length stays at or
+     * below NFFS_HASH_MAX_LOAD when the object pools are full.  The pools
+     * bound the total number of hash entries, so the table never needs to
+     * grow after this.
+     */
+    capacity = nffs_config.nc_num_inodes + nffs_config.nc_num_blocks;
+    nffs_hash_num_buckets = NFFS_HASH_SIZE;
+    while (nffs_hash_num_buckets * MYNEWT_VAL(NFFS_HASH_MAX_LOAD) <
+           capacity) {
+        nffs_hash_num_buckets <<= 1;
+    }
+#endif
 
     free(nffs_hash);
 
-    nffs_hash = malloc(NFFS_HASH_SIZE * sizeof *nffs_hash);
+    nffs_hash = malloc(NFFS_HASH_NUM_BUCKETS * sizeof *nffs_hash);
     if (nffs_hash == NULL) {
         return FS_ENOMEM;
     }
 
-    for (i = 0; i < NFFS_HASH_SIZE; i++) {
+    for (i = 0; i < NFFS_HASH_NUM_BUCKETS; i++) {
         SLIST_INIT(nffs_hash + i);
     }
 
@@ -1073,6 +1073,14 @@ nffs_inode_read(struct nffs_inode_entry *inode_entry, uint32_t offset,
         src_end = cache_inode->nci_file_size;
     }
 
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+    /* Only sequential streams get their block contents buffered; random
+     * access reads straight from flash.
+     */
+    cache_inode->nci_seq = offset == cache_inode->nci_seq_off;
+    cache_inode->nci_seq_off = src_end;
+#endif
+
     /* Initialize variables for the first iteration. */
     dst_off = src_end - offset;
     src_off = src_end;
@@ -1106,8 +1114,13 @@ nffs_inode_read(struct nffs_inode_entry *inode_entry, uint32_t offset,
         dst_off -= chunk_sz;
         src_off -= chunk_sz;
 
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+        rc = nffs_cache_block_read_data(cache_inode, cache_block, block_off,
+                                        chunk_sz, dptr + dst_off);
+#else
         rc = nffs_block_read_data(&cache_block->ncb_block, block_off, chunk_sz,
                                   dptr + dst_off);
+#endif
         if (rc != 0) {
             return rc;
         }
@@ -1122,6 +1135,61 @@ nffs_inode_read(struct nffs_inode_entry *inode_entry, uint32_t offset,
     return 0;
 }
 
+/**
+ * Retrieves a pointer to a contiguous extent of the specified file inode's
+ * data, read in place from memory-mapped flash.  The extent spans at most one
+ * data block; the caller iterates by repeating the call at
+ * offset + *out_len.
+ *
+ * @param inode_entry           The inode to map.
+ * @param offset                The offset within the file to map from.
+ * @param out_ptr               On success, points to the file contents.
+ * @param out_len               On success, the number of contiguous bytes
+ *                                  readable via *out_ptr.
+ *
+ * @return                      0 on success;
+ *                              FS_EOFFSET if the offset is beyond the end of
+ *                                  the file;
+ *                              FS_EUNSUPP if the underlying flash is not
+ *                                  memory mapped.
+ */
+int
+nffs_inode_mmap(struct nffs_inode_entry *inode_entry, uint32_t offset,
+                const void **out_ptr, uint32_t *out_len)
+{
+    struct nffs_cache_inode *cache_inode;
+    struct nffs_cache_block *cache_block;
+    const void *ptr;
+    uint16_t block_off;
+    int rc;
+
+    rc = nffs_cache_inode_ensure(&cache_inode, inode_entry);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (offset >= cache_inode->nci_file_size) {
+        return FS_EOFFSET;
+    }
+
+    rc = nffs_cache_seek(cache_inode, offset, &cache_block);
+    if (rc != 0) {
+        return rc;
+    }
+
+    block_off = offset - cache_block->ncb_file_offset;
+    ptr = nffs_block_mapped(&cache_block->ncb_block, block_off,
+                            cache_block->ncb_block.nb_data_len - block_off);
+    if (ptr == NULL) {
+        return FS_EUNSUPP;
+    }
+
+    *out_ptr = ptr;
+    *out_len = cache_block->ncb_block.nb_data_len - block_off;
+
+    return 0;
+}
+
 static int
 nffs_inode_unlink_from_ram_priv(struct nffs_inode *inode,
                                 int ignore_corruption,
@@ -217,9 +217,21 @@ nffs_misc_reserve_space(uint16_t space,
     /* Find the first area with sufficient free space. */
     for (i = 0; i < nffs_num_areas; i++) {
         if (i != nffs_scratch_area_idx) {
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+            /* The area being garbage collected must not receive new data;
+             * the scan may have already passed this point and the area gets
+             * erased when the cycle completes.
+             */
+            if (i == nffs_gc_src_area()) {
+                continue;
+            }
+#endif
             rc = nffs_misc_reserve_space_area(i, space, out_area_offset);
             if (rc == 0) {
                 *out_area_idx = i;
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+                nffs_gc_note_write();
+#endif
                 return 0;
             }
         }
@@ -241,6 +253,9 @@ nffs_misc_reserve_space(uint16_t space,
     assert(rc == 0);
 
     *out_area_idx = area_idx;
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+    nffs_gc_note_write();
+#endif
 
     return rc;
 }
@@ -364,6 +379,9 @@ nffs_misc_reset(void)
     int rc;
 
     nffs_cache_clear();
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+    nffs_path_cache_flush();
+#endif
 
     rc = os_mempool_init(&nffs_file_pool, nffs_config.nc_num_files,
                          sizeof (struct nffs_file), nffs_file_mem,
@@ -402,6 +420,26 @@ nffs_misc_reset(void)
         return FS_EOS;
     }
 
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+    rc = os_mempool_init(&nffs_cache_data_pool,
+                         MYNEWT_VAL(NFFS_CACHE_DATA),
+                         NFFS_BLOCK_MAX_DATA_SZ_MAX,
+                         nffs_cache_data_mem, "nffs_cache_data_pool");
+    if (rc != 0) {
+        return FS_EOS;
+    }
+#endif
+
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    rc = os_mempool_init(&nffs_write_buf_pool,
+                         MYNEWT_VAL(NFFS_WRITE_BUF),
+                         NFFS_BLOCK_MAX_DATA_SZ_MAX,
+                         nffs_write_buf_mem, "nffs_write_buf_pool");
+    if (rc != 0) {
+        return FS_EOS;
+    }
+#endif
+
     rc = os_mempool_init(&nffs_dir_pool,
                          nffs_config.nc_num_dirs,
                          sizeof (struct nffs_dir),
@@ -117,6 +117,15 @@ nffs_path_find(struct nffs_path_parser *parser,
     }
 
     inode_entry = NULL;
+
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+    if (parser->npp_token_type == NFFS_PATH_TOKEN_NONE &&
+        nffs_path_cache_find(parser, out_inode_entry, out_parent) == 0) {
+
+        return 0;
+    }
+#endif
+
     while (1) {
         parent = inode_entry;
         rc = nffs_path_parse_next(parser);
@@ -171,6 +180,11 @@ done:
     if (out_parent != NULL) {
         *out_parent = parent;
     }
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+    if (rc == 0) {
+        nffs_path_cache_add(parser->npp_path, inode_entry, parent);
+    }
+#endif
     return rc;
 }
 
@@ -219,6 +233,10 @@ nffs_path_unlink(const char *path)
         return rc;
     }
 
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+    nffs_path_cache_flush();
+#endif
+
     return 0;
 }
 
@@ -286,6 +304,9 @@ nffs_path_rename(const char *from, const char *to)
         if (rc != 0) {
             return rc;
         }
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+        nffs_path_cache_flush();
+#endif
         break;
 
     case FS_ENOENT:
@@ -305,6 +326,13 @@ nffs_path_rename(const char *from, const char *to)
         return rc;
     }
 
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+    /* A directory rename changes the path of every descendant, so drop
+     * everything.
+     */
+    nffs_path_cache_flush();
+#endif
+
     return 0;
 }
 
@@ -0,0 +1,143 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "nffs_priv.h"
+
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+
+/*
+ * Small LRU cache of fully-resolved paths, so repeated opens and stats of
+ * the same few files skip the component-by-component walk through the inode
+ * lists.  Only canonical paths ("/dir/file", no trailing slash) short enough
+ * to fit in an entry are cached.  Rename and unlink flush the whole cache;
+ * a rename of a directory silently changes the path of every descendant, so
+ * per-entry invalidation would not be safe.  All access occurs with the
+ * file system locked.
+ */
+
+static struct nffs_path_cache_entry
+    nffs_path_cache_entries[MYNEWT_VAL(NFFS_PATH_CACHE)];
+
+static struct nffs_path_cache_entry_list nffs_path_cache_list =
+    TAILQ_HEAD_INITIALIZER(nffs_path_cache_list);
+
+void
+nffs_path_cache_flush(void)
+{
+    struct nffs_path_cache_entry *entry;
+    int i;
+
+    TAILQ_INIT(&nffs_path_cache_list);
+    for (i = 0; i < MYNEWT_VAL(NFFS_PATH_CACHE); i++) {
+        entry = &nffs_path_cache_entries[i];
+        entry->npce_path[0] = '\0';
+        TAILQ_INSERT_TAIL(&nffs_path_cache_list, entry, npce_link);
+    }
+}
+
+static struct nffs_path_cache_entry *
+nffs_path_cache_entry_find(const char *path)
+{
+    struct nffs_path_cache_entry *entry;
+
+    TAILQ_FOREACH(entry, &nffs_path_cache_list, npce_link) {
+        if (entry->npce_path[0] != '\0' &&
+            strcmp(entry->npce_path, path) == 0) {
+
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Looks up the path being parsed in the cache.  On a hit, the output
+ * pointers are filled in and the parser is advanced to the state a full
+ * parse would have left it in (positioned at the leaf token), so callers
+ * which go on to use the parser see no difference.
+ *
+ * @return                      0 on a hit; FS_ENOENT on a miss.
+ */
+int
+nffs_path_cache_find(struct nffs_path_parser *parser,
+                     struct nffs_inode_entry **out_inode_entry,
+                     struct nffs_inode_entry **out_parent)
+{
+    struct nffs_path_cache_entry *entry;
+    const char *leaf;
+
+    entry = nffs_path_cache_entry_find(parser->npp_path);
+    if (entry == NULL) {
+        return FS_ENOENT;
+    }
+
+    /* Most recently used entry lives at the head. */
+    TAILQ_REMOVE(&nffs_path_cache_list, entry, npce_link);
+    TAILQ_INSERT_HEAD(&nffs_path_cache_list, entry, npce_link);
+
+    /* Cached paths are canonical, so the leaf follows the last slash. */
+    leaf = strrchr(entry->npce_path, '/') + 1;
+    parser->npp_token_type = NFFS_PATH_TOKEN_LEAF;
+    parser->npp_token = parser->npp_path + (leaf - entry->npce_path);
+    parser->npp_token_len = strlen(leaf);
+    parser->npp_off = entry->npce_path_len + 1;
+
+    *out_inode_entry = entry->npce_inode_entry;
+    if (out_parent != NULL) {
+        *out_parent = entry->npce_parent;
+    }
+
+    return 0;
+}
+
+/**
+ * Remembers a successfully-resolved path.  Paths which are not canonical or
+ * are too long to fit in a cache entry are silently not cached.
+ */
+void
+nffs_path_cache_add(const char *path, struct nffs_inode_entry *inode_entry,
+                    struct nffs_inode_entry *parent)
+{
+    struct nffs_path_cache_entry *entry;
+    int len;
+
+    len = strlen(path);
+    if (len < 2 || path[0] != '/' || path[len - 1] == '/' ||
+        len >= sizeof entry->npce_path) {
+
+        return;
+    }
+
+    entry = nffs_path_cache_entry_find(path);
+    if (entry == NULL) {
+        /* Evict the least recently used entry. */
+        entry = TAILQ_LAST(&nffs_path_cache_list, nffs_path_cache_entry_list);
+        memcpy(entry->npce_path, path, len + 1);
+        entry->npce_path_len = len;
+    }
+    entry->npce_inode_entry = inode_entry;
+    entry->npce_parent = parent;
+
+    TAILQ_REMOVE(&nffs_path_cache_list, entry, npce_link);
+    TAILQ_INSERT_HEAD(&nffs_path_cache_list, entry, npce_link);
+}
+
+#endif
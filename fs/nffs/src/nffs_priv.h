@@ -21,6 +21,7 @@
 #define H_NFFS_PRIV_
 
 #include <inttypes.h>
+#include "syscfg/syscfg.h"
 #include "log/log.h"
 #include "os/queue.h"
 #include "os/os_mempool.h"
@@ -35,6 +36,13 @@ extern "C" {
 
 #define NFFS_HASH_SIZE               256
 
+#if MYNEWT_VAL(NFFS_HASH_DYNAMIC)
+extern uint32_t nffs_hash_num_buckets;
+#define NFFS_HASH_NUM_BUCKETS        nffs_hash_num_buckets
+#else
+#define NFFS_HASH_NUM_BUCKETS        NFFS_HASH_SIZE
+#endif
+
 #define NFFS_ID_DIR_MIN              0
 #define NFFS_ID_DIR_MAX              0x10000000
 #define NFFS_ID_FILE_MIN             0x10000000
@@ -107,6 +115,59 @@ struct nffs_disk_block {
 
 #define NFFS_DISK_BLOCK_OFFSET_CRC  18
 
+#define NFFS_CHECKPOINT_MAGIC        0x3fc94ea6
+#define NFFS_CHECKPOINT_VER          0
+
+/* Flash offset, within the scratch area, of a metadata checkpoint.  The
+ * first word is a marker that gets written before anything else; a
+ * non-erased marker indicates that the scratch area is not fully erased,
+ * whether or not a complete checkpoint follows.
+ */
+#define NFFS_CHECKPOINT_AREA_OFFSET  (sizeof (struct nffs_disk_area))
+
+/** On-disk header of a metadata checkpoint; resides in the scratch area. */
+struct nffs_disk_checkpoint {
+    uint32_t ncp_magic;         /* NFFS_CHECKPOINT_MAGIC */
+    uint8_t ncp_ver;            /* Current checkpoint version: 0 */
+    uint8_t ncp_num_areas;      /* Number of area records that follow. */
+    uint16_t ncp_crc16;         /* Covers area records and object records. */
+    uint32_t ncp_data_len;      /* Total size of area and object records. */
+    uint32_t ncp_num_objs;      /* Number of object records. */
+    uint32_t ncp_next_file_id;
+    uint32_t ncp_next_dir_id;
+    uint32_t ncp_next_block_id;
+    uint16_t ncp_block_data_len; /* Max block data size at checkpoint time. */
+    uint16_t reserved16;
+};
+
+/** On-disk area record within a checkpoint. */
+struct nffs_disk_checkpoint_area {
+    uint32_t nca_offset;        /* Flash offset of start of area. */
+    uint32_t nca_length;        /* Size of area, in bytes. */
+    uint32_t nca_cur;           /* Area write offset at checkpoint time. */
+    uint8_t nca_flash_id;
+    uint8_t nca_gc_seq;
+    uint8_t nca_id;
+    uint8_t reserved8;
+};
+
+/**
+ * On-disk object record within a checkpoint.  Data blocks use only the
+ * first two fields; inodes use the full record.
+ */
+struct nffs_disk_checkpoint_obj {
+    uint32_t nco_id;
+    uint32_t nco_flash_loc;     /* Upper byte = area record index. */
+    uint32_t nco_parent_id;     /* NFFS_ID_NONE if no parent. */
+    uint32_t nco_lastblock_id;  /* NFFS_ID_NONE if no blocks. */
+    uint8_t nco_refcnt;
+    uint8_t nco_flags;
+    uint8_t nco_blkcnt;
+    uint8_t reserved8;
+};
+
+#define NFFS_CHECKPOINT_OBJ_BLOCK_SZ 8
+
 /**
  * What gets stored in the hash table.  Each entry represents a data block or
  * an inode.
@@ -174,6 +235,12 @@ struct nffs_file {
     struct nffs_inode_entry *nf_inode_entry;
     uint32_t nf_offset;
     uint8_t nf_access_flags;
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    uint8_t *nf_wb_buf;     /* Write-behind buffer; null until the first
+                               buffered append. */
+    uint16_t nf_wb_len;     /* Number of buffered bytes.  The buffer always
+                               holds the tail of the file. */
+#endif
 };
 
 struct nffs_area {
@@ -220,11 +287,31 @@ struct nffs_path_parser {
     int npp_off;
 };
 
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+/** Longest path a cache entry can hold; longer paths are not cached. */
+#define NFFS_PATH_CACHE_PATH_LEN    64
+
+/** Represents a single cached path resolution. */
+struct nffs_path_cache_entry {
+    TAILQ_ENTRY(nffs_path_cache_entry) npce_link;   /* LRU order. */
+    struct nffs_inode_entry *npce_inode_entry;
+    struct nffs_inode_entry *npce_parent;
+    uint8_t npce_path_len;
+    char npce_path[NFFS_PATH_CACHE_PATH_LEN];
+};
+
+TAILQ_HEAD(nffs_path_cache_entry_list, nffs_path_cache_entry);
+#endif
+
 /** Represents a single cached data block. */
 struct nffs_cache_block {
     TAILQ_ENTRY(nffs_cache_block) ncb_link; /* Next / prev cached block. */
     struct nffs_block ncb_block;            /* Full data block. */
     uint32_t ncb_file_offset;               /* File offset of this block. */
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+    uint8_t *ncb_data;                      /* Buffered block contents; null
+                                               if only metadata is cached. */
+#endif
 };
 
 TAILQ_HEAD(nffs_cache_block_list, nffs_cache_block);
@@ -235,6 +322,12 @@ struct nffs_cache_inode {
     struct nffs_inode nci_inode;                   /* Full inode. */
     struct nffs_cache_block_list nci_block_list;   /* List of cached blocks. */
     uint32_t nci_file_size;                        /* Total file size. */
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+    uint32_t nci_seq_off;                          /* Offset following the
+                                                      most recent read. */
+    uint8_t nci_seq;                               /* 1 if the current read is
+                                                      sequential. */
+#endif
 };
 
 struct nffs_dirent {
@@ -274,6 +367,12 @@ extern void *nffs_block_entry_mem;
 extern void *nffs_inode_mem;
 extern void *nffs_cache_inode_mem;
 extern void *nffs_cache_block_mem;
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+extern void *nffs_cache_data_mem;
+#endif
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+extern void *nffs_write_buf_mem;
+#endif
 extern void *nffs_dir_mem;
 extern struct os_mempool nffs_file_pool;
 extern struct os_mempool nffs_dir_pool;
@@ -281,6 +380,12 @@ extern struct os_mempool nffs_inode_entry_pool;
 extern struct os_mempool nffs_block_entry_pool;
 extern struct os_mempool nffs_cache_inode_pool;
 extern struct os_mempool nffs_cache_block_pool;
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+extern struct os_mempool nffs_cache_data_pool;
+#endif
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+extern struct os_mempool nffs_write_buf_pool;
+#endif
 extern uint32_t nffs_hash_next_file_id;
 extern uint32_t nffs_hash_next_dir_id;
 extern uint32_t nffs_hash_next_block_id;
@@ -334,6 +439,8 @@ int nffs_block_from_hash_entry(struct nffs_block *out_block,
                                struct nffs_hash_entry *entry);
 int nffs_block_read_data(const struct nffs_block *block, uint16_t offset,
                          uint16_t length, void *dst);
+const void *nffs_block_mapped(const struct nffs_block *block, uint16_t offset,
+                              uint16_t length);
 int nffs_block_is_dummy(struct nffs_hash_entry *entry);
 
 /* @cache */
@@ -346,6 +453,12 @@ void nffs_cache_inode_range(const struct nffs_cache_inode *cache_inode,
 int nffs_cache_seek(struct nffs_cache_inode *cache_inode, uint32_t to,
                     struct nffs_cache_block **out_cache_block);
 void nffs_cache_clear(void);
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+int nffs_cache_block_read_data(struct nffs_cache_inode *cache_inode,
+                               struct nffs_cache_block *cache_block,
+                               uint16_t block_off, uint16_t len, void *dst);
+void nffs_cache_data_invalidate(struct nffs_cache_inode *cache_inode);
+#endif
 
 /* @crc */
 int nffs_crc_flash(uint16_t initial_crc, uint8_t area_idx,
@@ -360,6 +473,11 @@ int nffs_crc_disk_inode_validate(const struct nffs_disk_inode *disk_inode,
 void nffs_crc_disk_inode_fill(struct nffs_disk_inode *disk_inode,
                               const char *filename);
 
+/* @checkpoint */
+int nffs_checkpoint_write(void);
+int nffs_checkpoint_load(uint16_t *out_block_data_len);
+int nffs_checkpoint_gc_prep(void);
+
 /* @config */
 void nffs_config_init(void);
 
@@ -374,6 +492,8 @@ int nffs_file_open(struct nffs_file **out_file, const char *filename,
 int nffs_file_seek(struct nffs_file *file, uint32_t offset);
 int nffs_file_read(struct nffs_file *file, uint32_t len, void *out_data,
                    uint32_t *out_len);
+int nffs_file_mmap(struct nffs_file *file, uint32_t offset,
+                   const void **out_ptr, uint32_t *out_len);
 int nffs_file_close(struct nffs_file *file);
 int nffs_file_new(struct nffs_inode_entry *parent, const char *filename,
                   uint8_t filename_len, int is_dir,
@@ -387,11 +507,19 @@ int nffs_format_full(const struct nffs_area_desc *area_descs);
 /* @gc */
 int nffs_gc(uint8_t *out_area_idx);
 int nffs_gc_until(uint32_t space, uint8_t *out_area_idx);
+#if MYNEWT_VAL(NFFS_GC_INCREMENTAL)
+int nffs_gc_slice(int budget, uint8_t *out_area_idx, int *out_done);
+int nffs_gc_src_area(void);
+int nffs_gc_needed(void);
+void nffs_gc_note_write(void);
+#endif
 
 /* @flash */
 struct nffs_area *nffs_flash_find_area(uint16_t logical_id);
 int nffs_flash_read(uint8_t area_idx, uint32_t offset,
                     void *data, uint32_t len);
+const void *nffs_flash_mapped(uint8_t area_idx, uint32_t offset,
+                              uint32_t len);
 int nffs_flash_write(uint8_t area_idx, uint32_t offset,
                      const void *data, uint32_t len);
 int nffs_flash_copy(uint8_t area_id_from, uint32_t offset_from,
@@ -456,6 +584,8 @@ int nffs_inode_filename_cmp_flash(const struct nffs_inode *inode1,
                                   int *result);
 int nffs_inode_read(struct nffs_inode_entry *inode_entry, uint32_t offset,
                     uint32_t len, void *data, uint32_t *out_len);
+int nffs_inode_mmap(struct nffs_inode_entry *inode_entry, uint32_t offset,
+                    const void **out_ptr, uint32_t *out_len);
 int nffs_inode_seek(struct nffs_inode_entry *inode_entry, uint32_t offset,
                     uint32_t length, struct nffs_seek_info *out_seek_info);
 int nffs_inode_from_entry(struct nffs_inode *out_inode,
@@ -493,18 +623,31 @@ int nffs_path_find_inode_entry(const char *filename,
                                struct nffs_inode_entry **out_inode_entry);
 int nffs_path_unlink(const char *filename);
 int nffs_path_rename(const char *from, const char *to);
+#if MYNEWT_VAL(NFFS_PATH_CACHE)
+int nffs_path_cache_find(struct nffs_path_parser *parser,
+                         struct nffs_inode_entry **out_inode_entry,
+                         struct nffs_inode_entry **out_parent);
+void nffs_path_cache_add(const char *path,
+                         struct nffs_inode_entry *inode_entry,
+                         struct nffs_inode_entry *parent);
+void nffs_path_cache_flush(void);
+#endif
 int nffs_path_new_dir(const char *path,
                       struct nffs_inode_entry **out_inode_entry);
 
 /* @restore */
 int nffs_restore_full(const struct nffs_area_desc *area_descs);
+int nffs_restore_area_tail(int area_idx, uint32_t start_off);
 
 /* @write */
 int nffs_write_to_file(struct nffs_file *file, const void *data, int len);
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+int nffs_write_flush(struct nffs_file *file);
+#endif
 
 
 #define NFFS_HASH_FOREACH(entry, i, next)                               \
-    for ((i) = 0; (i) < NFFS_HASH_SIZE; (i)++)                          \
+    for ((i) = 0; (i) < NFFS_HASH_NUM_BUCKETS; (i)++)                   \
         for ((entry) = SLIST_FIRST(nffs_hash + (i));                    \
              (entry) && (((next)) = SLIST_NEXT((entry), nhe_next), 1);  \
              (entry) = ((next)))
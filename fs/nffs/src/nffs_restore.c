@@ -288,7 +288,7 @@ nffs_restore_sweep(void)
     /* Iterate through every object in the hash table, deleting all inodes that
      * should be removed.
      */
-    for (i = 0; i < NFFS_HASH_SIZE; i++) {
+    for (i = 0; i < (int)NFFS_HASH_NUM_BUCKETS; i++) {
         list = nffs_hash + i;
 
         entry = SLIST_FIRST(list);
@@ -1028,15 +1028,15 @@ nffs_restore_disk_object_size(const struct nffs_disk_object *disk_object)
 }
 
 /**
- * Reads the specified area from disk and loads its contents into the RAM
- * representation.
+ * Reads the specified area from disk, starting at the area's current write
+ * offset, and loads the encountered objects into the RAM representation.
  *
  * @param area_idx              The index of the area to read.
  *
  * @return                      0 on success; nonzero on failure.
  */
 static int
-nffs_restore_area_contents(int area_idx)
+nffs_restore_area_from_cur(int area_idx)
 {
     struct nffs_disk_object disk_object;
     struct nffs_area *area;
@@ -1044,7 +1044,6 @@ nffs_restore_area_contents(int area_idx)
 
     area = nffs_areas + area_idx;
 
-    area->na_cur = sizeof (struct nffs_disk_area);
     while (1) {
         rc = nffs_restore_disk_object(area_idx, area->na_cur,  &disk_object);
         switch (rc) {
@@ -1086,6 +1085,41 @@ nffs_restore_area_contents(int area_idx)
     }
 }
 
+/**
+ * Reads the specified area from disk and loads its contents into the RAM
+ * representation.
+ *
+ * @param area_idx              The index of the area to read.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+nffs_restore_area_contents(int area_idx)
+{
+    nffs_areas[area_idx].na_cur = sizeof (struct nffs_disk_area);
+    return nffs_restore_area_from_cur(area_idx);
+}
+
+#if MYNEWT_VAL(NFFS_CHECKPOINT)
+/**
+ * Loads the objects that were written to the specified area after a
+ * checkpoint was taken.  The caller supplies the area's write offset as
+ * recorded in the checkpoint; everything at or beyond that offset gets
+ * replayed through the normal restore path.
+ *
+ * @param area_idx              The index of the area to read.
+ * @param start_off             The area offset to start reading from.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+nffs_restore_area_tail(int area_idx, uint32_t start_off)
+{
+    nffs_areas[area_idx].na_cur = start_off;
+    return nffs_restore_area_from_cur(area_idx);
+}
+#endif
+
 /**
  * Reads and parses one area header.  This function does not read the area's
  * contents.
@@ -1158,7 +1192,7 @@ nffs_restore_corrupt_scratch(void)
     }
 
     /* Invalidate all objects resident in the bad area. */
-    for (i = 0; i < NFFS_HASH_SIZE; i++) {
+    for (i = 0; i < (int)NFFS_HASH_NUM_BUCKETS; i++) {
         entry = SLIST_FIRST(&nffs_hash[i]);
         while (entry != NULL) {
             next = SLIST_NEXT(entry, nhe_next);
@@ -1289,6 +1323,9 @@ int
 nffs_restore_full(const struct nffs_area_desc *area_descs)
 {
     struct nffs_disk_area disk_area;
+#if MYNEWT_VAL(NFFS_CHECKPOINT)
+    uint16_t checkpoint_block_data_len;
+#endif
     int cur_area_idx;
     int use_area;
     int rc;
@@ -1356,11 +1393,34 @@ nffs_restore_full(const struct nffs_area_desc *area_descs)
             } else {
                 nffs_areas[cur_area_idx].na_cur =
                     sizeof (struct nffs_disk_area);
+#if !MYNEWT_VAL(NFFS_CHECKPOINT)
                 nffs_restore_area_contents(cur_area_idx);
+#endif
             }
         }
     }
 
+#if MYNEWT_VAL(NFFS_CHECKPOINT)
+    /* If the scratch area contains a checkpoint matching the detected areas,
+     * load the RAM representation from it and replay only the objects that
+     * were written after it was taken.  Otherwise, fall back to a full scan
+     * of every area.
+     */
+    if (nffs_scratch_area_idx == NFFS_AREA_ID_NONE ||
+        nffs_checkpoint_load(&checkpoint_block_data_len) != 0) {
+
+        for (i = 0; i < nffs_num_areas; i++) {
+            if (i != nffs_scratch_area_idx) {
+                nffs_restore_area_contents(i);
+            }
+        }
+    } else {
+        if (checkpoint_block_data_len > nffs_restore_largest_block_data_len) {
+            nffs_restore_largest_block_data_len = checkpoint_block_data_len;
+        }
+    }
+#endif
+
     /* All areas have been restored from flash. */
 
     if (nffs_scratch_area_idx == NFFS_AREA_ID_NONE) {
@@ -18,6 +18,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include "testutil/testutil.h"
 #include "nffs/nffs.h"
 #include "nffs_priv.h"
@@ -310,6 +311,13 @@ nffs_write_chunk(struct nffs_inode_entry *inode_entry, uint32_t file_offset,
 
     /** This is not an append; i.e., old data is getting overwritten. */
 
+#if MYNEWT_VAL(NFFS_CACHE_DATA)
+    /* The blocks being overwritten may have their contents buffered; drop
+     * the stale buffers.
+     */
+    nffs_cache_data_invalidate(cache_inode);
+#endif
+
     dst_off = file_offset + data_len;
     data_offset = data_len;
     cache_block = NULL;
@@ -371,6 +379,99 @@ nffs_write_chunk(struct nffs_inode_entry *inode_entry, uint32_t file_offset,
     return 0;
 }
 
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+/**
+ * Flushes the specified file's write-behind buffer to flash.  The buffered
+ * bytes always constitute the tail of the file, so they are written as a
+ * single append.  The buffer itself is retained for subsequent appends.
+ *
+ * @param file                  The file to flush.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+nffs_write_flush(struct nffs_file *file)
+{
+    struct nffs_cache_inode *cache_inode;
+    int rc;
+
+    if (file->nf_wb_len == 0) {
+        return 0;
+    }
+
+    rc = nffs_cache_inode_ensure(&cache_inode, file->nf_inode_entry);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = nffs_write_chunk(file->nf_inode_entry, cache_inode->nci_file_size,
+                          file->nf_wb_buf, file->nf_wb_len);
+    if (rc != 0) {
+        return rc;
+    }
+
+    file->nf_wb_len = 0;
+
+    return 0;
+}
+
+/**
+ * Appends data to the specified file's write-behind buffer, flushing the
+ * buffer each time it reaches the maximum block data size.  If no buffer can
+ * be obtained, the data is left for the caller to write through.
+ *
+ * @param file                  The file to append to.
+ * @param inout_data            Points to the data to append; advanced past
+ *                                  the consumed bytes on return.
+ * @param inout_len             Points to the number of bytes to append;
+ *                                  holds the number of unconsumed bytes on
+ *                                  return.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+nffs_write_buf_append(struct nffs_file *file, const uint8_t **inout_data,
+                      int *inout_len)
+{
+    uint16_t chunk_sz;
+    uint16_t space;
+    int rc;
+
+    while (*inout_len > 0) {
+        if (file->nf_wb_buf == NULL) {
+            file->nf_wb_buf = os_memblock_get(&nffs_write_buf_pool);
+            if (file->nf_wb_buf == NULL) {
+                /* No buffer available; the caller writes through. */
+                return 0;
+            }
+            file->nf_wb_len = 0;
+        }
+
+        space = nffs_block_max_data_sz - file->nf_wb_len;
+        if (*inout_len < space) {
+            chunk_sz = *inout_len;
+        } else {
+            chunk_sz = space;
+        }
+
+        memcpy(file->nf_wb_buf + file->nf_wb_len, *inout_data, chunk_sz);
+        file->nf_wb_len += chunk_sz;
+        file->nf_offset += chunk_sz;
+        *inout_data += chunk_sz;
+        *inout_len -= chunk_sz;
+
+        if (file->nf_wb_len >= nffs_block_max_data_sz) {
+            rc = nffs_write_flush(file);
+            if (rc != 0) {
+                return rc;
+            }
+        }
+    }
+
+    return 0;
+}
+#endif
+
 /**
  * Writes a chunk of contiguous data to a file.
  *
@@ -406,10 +507,34 @@ nffs_write_to_file(struct nffs_file *file, const void *data, int len)
      */
     if (file->nf_access_flags & FS_ACCESS_APPEND) {
         file->nf_offset = cache_inode->nci_file_size;
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+        file->nf_offset += file->nf_wb_len;
+#endif
     }
 
-    /* Write data as a sequence of blocks. */
     data_ptr = data;
+
+#if MYNEWT_VAL(NFFS_WRITE_BUF)
+    if (file->nf_offset == cache_inode->nci_file_size + file->nf_wb_len) {
+        /* Pure append; coalesce into the write-behind buffer.  Any bytes
+         * that don't fit (no buffer available) are written through below.
+         */
+        rc = nffs_write_buf_append(file, &data_ptr, &len);
+        if (rc != 0) {
+            return rc;
+        }
+    } else if (file->nf_wb_len > 0) {
+        /* Not an append; the buffered tail must be on flash before existing
+         * data can be overwritten.
+         */
+        rc = nffs_write_flush(file);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+#endif
+
+    /* Write data as a sequence of blocks. */
     while (len > 0) {
         if (len > nffs_block_max_data_sz) {
             chunk_size = nffs_block_max_data_sz;
@@ -108,6 +108,7 @@ TEST_CASE_DECL(nffs_test_lost_found)
 TEST_CASE_DECL(nffs_test_readdir)
 TEST_CASE_DECL(nffs_test_split_file)
 TEST_CASE_DECL(nffs_test_gc_on_oom)
+TEST_CASE_DECL(nffs_test_txn)
 
 void
 nffs_test_suite_gen_1_1_init(void)
@@ -174,6 +175,7 @@ TEST_SUITE(nffs_test_suite)
     nffs_test_readdir();
     nffs_test_split_file();
     nffs_test_gc_on_oom();
+    nffs_test_txn();
 }
 
 TEST_CASE_DECL(nffs_test_cache_large_file)
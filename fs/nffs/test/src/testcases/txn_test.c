@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "nffs_test_utils.h"
+
+TEST_CASE(nffs_test_txn)
+{
+    struct fs_file *file;
+    struct fs_txn txn;
+    const char old_a[] = "old-a";
+    const char old_b[] = "old-b";
+    const char new_a[] = "new-a";
+    const char new_b[] = "new-b";
+    uint8_t journal[64];
+    int rc;
+
+    rc = nffs_format(nffs_current_area_descs);
+    TEST_ASSERT(rc == 0);
+
+    nffs_test_util_create_file("/a.txt", old_a, sizeof old_a);
+    nffs_test_util_create_file("/b.txt", old_b, sizeof old_b);
+
+    /*** Commit replaces every target atomically. */
+    rc = fs_txn_begin(&txn);
+    TEST_ASSERT(rc == 0);
+
+    rc = fs_txn_open(&txn, "/a.txt", &file);
+    TEST_ASSERT(rc == 0);
+    rc = fs_write(file, new_a, sizeof new_a);
+    TEST_ASSERT(rc == 0);
+    rc = fs_close(file);
+    TEST_ASSERT(rc == 0);
+
+    rc = fs_txn_open(&txn, "/b.txt", &file);
+    TEST_ASSERT(rc == 0);
+    rc = fs_write(file, new_b, sizeof new_b);
+    TEST_ASSERT(rc == 0);
+    rc = fs_close(file);
+    TEST_ASSERT(rc == 0);
+
+    /* Targets are untouched while the transaction is open. */
+    nffs_test_util_assert_contents("/a.txt", old_a, sizeof old_a);
+    nffs_test_util_assert_contents("/b.txt", old_b, sizeof old_b);
+
+    rc = fs_txn_commit(&txn);
+    TEST_ASSERT(rc == 0);
+
+    nffs_test_util_assert_contents("/a.txt", new_a, sizeof new_a);
+    nffs_test_util_assert_contents("/b.txt", new_b, sizeof new_b);
+
+    /* Commit removed the staging files and the journal. */
+    rc = fs_open("/a.txt.fstx", FS_ACCESS_READ, &file);
+    TEST_ASSERT(rc == FS_ENOENT);
+    rc = fs_open("/.fstxn", FS_ACCESS_READ, &file);
+    TEST_ASSERT(rc == FS_ENOENT);
+
+    /*** Abort leaves every target untouched. */
+    rc = fs_txn_begin(&txn);
+    TEST_ASSERT(rc == 0);
+    rc = fs_txn_open(&txn, "/a.txt", &file);
+    TEST_ASSERT(rc == 0);
+    rc = fs_write(file, old_a, sizeof old_a);
+    TEST_ASSERT(rc == 0);
+    rc = fs_close(file);
+    TEST_ASSERT(rc == 0);
+    rc = fs_txn_abort(&txn);
+    TEST_ASSERT(rc == 0);
+
+    nffs_test_util_assert_contents("/a.txt", new_a, sizeof new_a);
+    rc = fs_open("/a.txt.fstx", FS_ACCESS_READ, &file);
+    TEST_ASSERT(rc == FS_ENOENT);
+
+    /*** Recovery rolls an interrupted commit forward. */
+    nffs_test_util_create_file("/a.txt.fstx", old_a, sizeof old_a);
+    journal[0] = 1;
+    journal[1] = 6;
+    memcpy(journal + 2, "/a.txt", 6);
+    journal[8] = 0xb5;
+    journal[9] = 0xf2;
+    journal[10] = 0x98;
+    journal[11] = 0x3c;
+    rc = fs_open("/.fstxn", FS_ACCESS_WRITE | FS_ACCESS_TRUNCATE, &file);
+    TEST_ASSERT(rc == 0);
+    rc = fs_write(file, journal, 12);
+    TEST_ASSERT(rc == 0);
+    rc = fs_close(file);
+    TEST_ASSERT(rc == 0);
+
+    rc = fs_txn_recover();
+    TEST_ASSERT(rc == 0);
+
+    nffs_test_util_assert_contents("/a.txt", old_a, sizeof old_a);
+    rc = fs_open("/a.txt.fstx", FS_ACCESS_READ, &file);
+    TEST_ASSERT(rc == FS_ENOENT);
+    rc = fs_open("/.fstxn", FS_ACCESS_READ, &file);
+    TEST_ASSERT(rc == FS_ENOENT);
+
+    /*** Recovery rolls an incomplete journal back. */
+    nffs_test_util_create_file("/b.txt.fstx", old_b, sizeof old_b);
+    rc = fs_open("/.fstxn", FS_ACCESS_WRITE | FS_ACCESS_TRUNCATE, &file);
+    TEST_ASSERT(rc == 0);
+    rc = fs_write(file, journal, 8);    /* no trailing magic */
+    TEST_ASSERT(rc == 0);
+    rc = fs_close(file);
+    TEST_ASSERT(rc == 0);
+
+    rc = fs_txn_recover();
+    TEST_ASSERT(rc == 0);
+
+    nffs_test_util_assert_contents("/b.txt", new_b, sizeof new_b);
+    rc = fs_open("/.fstxn", FS_ACCESS_READ, &file);
+    TEST_ASSERT(rc == FS_ENOENT);
+
+    /* Nothing to do when no journal exists. */
+    rc = fs_txn_recover();
+    TEST_ASSERT(rc == 0);
+}
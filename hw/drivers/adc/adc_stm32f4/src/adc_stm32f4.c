@@ -666,6 +666,18 @@ stm32f4_adc_read_buffer(struct adc_dev *dev, void *buf, int buf_len, int off,
     return (OS_OK);
 }
 
+static int
+stm32f4_adc_write_buffer(struct adc_dev *dev, void *buf, int buf_len, int off,
+                         int val)
+{
+
+    assert(off < buf_len);
+
+    *((uint32_t *)buf + off) = val;
+
+    return (OS_OK);
+}
+
 /**
  * Callback to return size of buffer
  *
@@ -717,6 +729,7 @@ stm32f4_adc_dev_init(struct os_dev *odev, void *arg)
     af->af_set_buffer = stm32f4_adc_set_buffer;
     af->af_release_buffer = stm32f4_adc_release_buffer;
     af->af_read_buffer = stm32f4_adc_read_buffer;
+    af->af_write_buffer = stm32f4_adc_write_buffer;
     af->af_size_buffer = stm32f4_adc_size_buffer;
 
     return (OS_OK);
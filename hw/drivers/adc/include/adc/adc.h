@@ -125,6 +125,20 @@ typedef int (*adc_buf_release_func_t)(struct adc_dev *, void *, int);
  */
 typedef int (*adc_buf_read_func_t)(struct adc_dev *, void *, int, int, int *);
 
+/**
+ * Write an entry of an ADC buffer.  Used by the continuous mode to
+ * compact a buffer in place when decimating; optional.
+ *
+ * @param The ADC device to write the entry for
+ * @param The buffer to write the entry into
+ * @param The total length of the buffer
+ * @param The entry number to write in the buffer
+ * @param The value to write
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+typedef int (*adc_buf_write_func_t)(struct adc_dev *, void *, int, int, int);
+
 /**
  * Get the size of a buffer
  *
@@ -143,9 +157,44 @@ struct adc_driver_funcs {
     adc_buf_set_func_t af_set_buffer;
     adc_buf_release_func_t af_release_buffer;
     adc_buf_read_func_t af_read_buffer;
+    adc_buf_write_func_t af_write_buffer;
     adc_buf_size_func_t af_size_buffer;
 };
 
+/**
+ * Consumer of continuous mode sample buffers.  Called from the event
+ * queue given to adc_cont_start(), i.e. in task context, with the
+ * buffer that just completed.  The buffer belongs to the driver's
+ * ping-pong set and is overwritten once DMA wraps back around to it;
+ * the consumer should copy or reduce the data before returning.
+ *
+ * @param The ADC device the buffer came from
+ * @param The argument given in the continuous mode config
+ * @param The buffer holding the samples
+ * @param The number of sample entries in the buffer (after decimation)
+ */
+typedef void (*adc_cont_buf_func_t)(struct adc_dev *, void *, void *, int);
+
+/**
+ * Configuration of continuous sampling mode; see adc_cont_start().
+ */
+struct adc_cont_cfg {
+    /* Event queue completed buffers are delivered to */
+    struct os_eventq *acc_evq;
+    /* Consumer called with each completed buffer */
+    adc_cont_buf_func_t acc_buf_func;
+    void *acc_arg;
+    /*
+     * Keep one entry of every 'acc_decimate' samples (0 and 1 deliver
+     * every sample).  Requires the driver to implement af_write_buffer.
+     */
+    uint8_t acc_decimate;
+    /* Nonzero: each group of 'acc_decimate' samples is averaged
+     * instead of picking the first, trading CPU at buffer-completion
+     * time for noise rejection. */
+    uint8_t acc_average;
+};
+
 struct adc_chan_config {
     uint16_t c_refmv;
     uint8_t c_res;
@@ -161,12 +210,19 @@ struct adc_dev {
     int ad_chan_count;
     adc_event_handler_func_t ad_event_handler_func;
     void *ad_event_handler_arg;
+    /* Continuous mode state; see adc_cont_start() */
+    struct adc_cont_cfg ad_cont_cfg;
+    struct os_event ad_cont_ev;
+    void *ad_cont_buf;
+    int ad_cont_entries;
 };
 
 int adc_chan_config(struct adc_dev *, uint8_t, void *);
 int adc_chan_read(struct adc_dev *, uint8_t, int *);
 int adc_event_handler_set(struct adc_dev *, adc_event_handler_func_t,
         void *);
+int adc_cont_start(struct adc_dev *, const struct adc_cont_cfg *);
+int adc_cont_stop(struct adc_dev *);
 
 /**
  * Sample the device specified by dev.  This is used in non-blocking mode
@@ -237,6 +293,25 @@ adc_buf_read(struct adc_dev *dev, void *buf, int buf_len, int entry,
     return (dev->ad_funcs.af_read_buffer(dev, buf, buf_len, entry, result));
 }
 
+/**
+ * Write an entry of an ADC buffer; only supported when the driver
+ * provides af_write_buffer (used for in-place decimation).
+ *
+ * @param dev The device that the entry is being written for
+ * @param buf The buffer that we're writing the entry into
+ * @param buf_len The length of the buffer we're writing the entry into
+ * @param entry The entry number to write in the buffer
+ * @param val The value to write
+ *
+ * @return 0 on success, non-zero error code on failure
+ */
+static inline int
+adc_buf_write(struct adc_dev *dev, void *buf, int buf_len, int entry,
+        int val)
+{
+    return (dev->ad_funcs.af_write_buffer(dev, buf, buf_len, entry, val));
+}
+
 /**
  * Return the size of an ADC buffer
  *
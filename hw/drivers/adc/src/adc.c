@@ -87,3 +87,123 @@ adc_event_handler_set(struct adc_dev *dev, adc_event_handler_func_t func,
     return (0);
 }
 
+/**
+ * Event callback for continuous mode; runs from the consumer's event
+ * queue and hands the completed buffer to the configured consumer.
+ */
+static void
+adc_cont_ev_cb(struct os_event *ev)
+{
+    struct adc_dev *dev;
+
+    dev = (struct adc_dev *)ev->ev_arg;
+    if (dev->ad_cont_cfg.acc_buf_func) {
+        dev->ad_cont_cfg.acc_buf_func(dev, dev->ad_cont_cfg.acc_arg,
+                dev->ad_cont_buf, dev->ad_cont_entries);
+    }
+}
+
+/**
+ * Result handler for continuous mode.  Called by the driver when a DMA
+ * buffer completes (interrupt context): decimates the buffer in place
+ * if configured, then posts it to the consumer's event queue.  If the
+ * consumer still holds the previously posted buffer the new one is
+ * dropped, so a slow consumer loses whole buffers rather than
+ * corrupting the one it is reading.
+ */
+static int
+adc_cont_result_handler(struct adc_dev *dev, void *arg,
+        adc_event_type_t type, void *buf, int buflen)
+{
+    struct adc_cont_cfg *cfg;
+    int entries;
+    int sum;
+    int val;
+    int n;
+    int i;
+    int j;
+
+    cfg = &dev->ad_cont_cfg;
+    if (cfg->acc_buf_func == NULL || OS_EVENT_QUEUED(&dev->ad_cont_ev)) {
+        return (0);
+    }
+
+    entries = buflen;
+    n = cfg->acc_decimate;
+    if (n > 1) {
+        entries = buflen / n;
+        for (i = 0; i < entries; i++) {
+            if (cfg->acc_average) {
+                sum = 0;
+                for (j = 0; j < n; j++) {
+                    adc_buf_read(dev, buf, buflen, i * n + j, &val);
+                    sum += val;
+                }
+                val = sum / n;
+            } else {
+                adc_buf_read(dev, buf, buflen, i * n, &val);
+            }
+            adc_buf_write(dev, buf, buflen, i, val);
+        }
+    }
+
+    dev->ad_cont_buf = buf;
+    dev->ad_cont_entries = entries;
+    os_eventq_put(cfg->acc_evq, &dev->ad_cont_ev);
+
+    return (0);
+}
+
+/**
+ * Start continuous sampling.  The device must have been configured and
+ * given a ping-pong buffer pair with adc_buf_set(); the driver then
+ * refills one buffer while the other is delivered, so sustained
+ * sampling runs without per-sample interrupts.  Completed buffers
+ * arrive on the configured event queue, optionally decimated or
+ * averaged down at buffer-completion time.
+ *
+ * @param dev The ADC device to sample continuously
+ * @param cfg Delivery and decimation configuration; copied
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int
+adc_cont_start(struct adc_dev *dev, const struct adc_cont_cfg *cfg)
+{
+    if (cfg->acc_buf_func == NULL || cfg->acc_evq == NULL) {
+        return (EINVAL);
+    }
+    if (cfg->acc_decimate > 1 &&
+        dev->ad_funcs.af_write_buffer == NULL) {
+        return (EINVAL);
+    }
+
+    dev->ad_cont_cfg = *cfg;
+    dev->ad_cont_ev.ev_cb = adc_cont_ev_cb;
+    dev->ad_cont_ev.ev_arg = dev;
+
+    adc_event_handler_set(dev, adc_cont_result_handler, NULL);
+
+    return (adc_sample(dev));
+}
+
+/**
+ * Stop delivering continuous samples.  Detaches the consumer and pulls
+ * any undelivered buffer off the event queue; use adc_buf_release() to
+ * halt the underlying DMA.
+ *
+ * @param dev The ADC device to stop
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int
+adc_cont_stop(struct adc_dev *dev)
+{
+    dev->ad_cont_cfg.acc_buf_func = NULL;
+    if (dev->ad_cont_cfg.acc_evq) {
+        os_eventq_remove(dev->ad_cont_cfg.acc_evq, &dev->ad_cont_ev);
+    }
+
+    return (0);
+}
+
@@ -25,6 +25,7 @@
 #include "ble/xcvr.h"
 #include "nimble/ble.h"
 #include "nimble/nimble_opt.h"
+#include "os/os_trace.h"
 #include "controller/ble_phy.h"
 #include "controller/ble_ll.h"
 
@@ -226,6 +227,8 @@ ble_phy_isr(void)
     uint32_t irq_en;
     struct ble_mbuf_hdr *ble_hdr;
 
+    OS_TRACE_ENTER(OS_TRACE_ID_BLE_PHY_ISR, 0);
+
     /* Check for disabled event. This only happens for transmits now */
     irq_en = ble_xcvr_get_irq_status();
     if (irq_en & BLE_XCVR_IRQ_F_TX_END) {
@@ -233,6 +236,7 @@ ble_phy_isr(void)
         /* Better be in TX state! */
         assert(g_ble_phy_data.phy_state == BLE_PHY_STATE_TX);
         ble_xcvr_clear_irq(BLE_XCVR_IRQ_F_TX_END);
+        ble_ll_airtime_end();
 
         transition = g_ble_phy_data.phy_transition;
         if (transition == BLE_PHY_TRANSITION_TX_RX) {
@@ -270,6 +274,7 @@ ble_phy_isr(void)
     if (irq_en & BLE_XCVR_IRQ_F_RX_END) {
 
         ble_xcvr_clear_irq(BLE_XCVR_IRQ_F_RX_END);
+        ble_ll_airtime_end();
 
         /* Construct BLE header before handing up */
         ble_hdr = &g_ble_phy_data.rxhdr;
@@ -296,6 +301,8 @@ ble_phy_isr(void)
 
     /* Count # of interrupts */
     ++g_ble_phy_stats.phy_isrs;
+
+    OS_TRACE_EXIT(OS_TRACE_ID_BLE_PHY_ISR, 0);
 }
 
 /**
@@ -320,6 +327,8 @@ ble_phy_init(void)
 int
 ble_phy_rx(void)
 {
+    OS_TRACE_EVENT(OS_TRACE_ID_BLE_PHY_RX, g_ble_phy_data.phy_chan);
+
     /* Check radio state */
     if (ble_phy_state_get() != BLE_PHY_STATE_IDLE) {
         ble_phy_disable();
@@ -328,6 +337,7 @@ ble_phy_rx(void)
     }
 
     g_ble_phy_data.phy_state = BLE_PHY_STATE_RX;
+    ble_ll_airtime_start(g_ble_phy_data.phy_chan, 1);
 
     return 0;
 }
@@ -416,6 +426,8 @@ ble_phy_tx(struct os_mbuf *txpdu, uint8_t end_trans)
     /* Better have a pdu! */
     assert(txpdu != NULL);
 
+    OS_TRACE_EVENT(OS_TRACE_ID_BLE_PHY_TX, g_ble_phy_data.phy_chan);
+
 
     if (ble_phy_state_get() != BLE_PHY_STATE_IDLE) {
         ble_phy_disable();
@@ -439,6 +451,7 @@ ble_phy_tx(struct os_mbuf *txpdu, uint8_t end_trans)
     if (state == BLE_PHY_STATE_TX) {
         /* Set phy state to transmitting and count packet statistics */
         g_ble_phy_data.phy_state = BLE_PHY_STATE_TX;
+        ble_ll_airtime_start(g_ble_phy_data.phy_chan, 0);
         ++g_ble_phy_stats.tx_good;
         g_ble_phy_stats.tx_bytes += OS_MBUF_PKTHDR(txpdu)->omp_len +
             BLE_LL_PDU_HDR_LEN;
@@ -544,6 +557,7 @@ ble_phy_setchan(uint8_t chan, uint32_t access_addr, uint32_t crcinit)
 void
 ble_phy_disable(void)
 {
+    ble_ll_airtime_end();
     g_ble_phy_data.phy_state = BLE_PHY_STATE_IDLE;
 }
 
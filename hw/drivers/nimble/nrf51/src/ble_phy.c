@@ -25,6 +25,7 @@
 #include "bsp/cmsis_nvic.h"
 #include "nimble/ble.h"
 #include "nimble/nimble_opt.h"
+#include "os/os_trace.h"
 #include "controller/ble_phy.h"
 #include "controller/ble_ll.h"
 #include "nrf51_bitfields.h"
@@ -106,6 +107,7 @@ STATS_SECT_START(ble_phy_stats)
     STATS_SECT_ENTRY(tx_bytes)
     STATS_SECT_ENTRY(rx_starts)
     STATS_SECT_ENTRY(rx_aborts)
+    STATS_SECT_ENTRY(rx_early_aborts)
     STATS_SECT_ENTRY(rx_valid)
     STATS_SECT_ENTRY(rx_crc_err)
     STATS_SECT_ENTRY(rx_late)
@@ -123,6 +125,7 @@ STATS_NAME_START(ble_phy_stats)
     STATS_NAME(ble_phy_stats, tx_bytes)
     STATS_NAME(ble_phy_stats, rx_starts)
     STATS_NAME(ble_phy_stats, rx_aborts)
+    STATS_NAME(ble_phy_stats, rx_early_aborts)
     STATS_NAME(ble_phy_stats, rx_valid)
     STATS_NAME(ble_phy_stats, rx_crc_err)
     STATS_NAME(ble_phy_stats, rx_late)
@@ -383,6 +386,7 @@ ble_phy_tx_end_isr(void)
 
     /* Better be in TX state! */
     assert(g_ble_phy_data.phy_state == BLE_PHY_STATE_TX);
+    ble_ll_airtime_end();
 
     /* Log the event */
     ble_ll_log(BLE_LL_LOG_ID_PHY_TXEND, (g_ble_phy_tx_buf[0] >> 8) & 0xFF,
@@ -417,6 +421,9 @@ ble_phy_tx_end_isr(void)
         /* Packet pointer needs to be reset. */
         ble_phy_rx_xcvr_setup();
 
+        /* Receiver turns on via the DISABLED->RXEN shortcut */
+        ble_ll_airtime_start(g_ble_phy_data.phy_chan, 1);
+
         /*
          * Enable the wait for response timer. Note that cc #1 on
          * timer 0 contains the transmit start time
@@ -447,6 +454,7 @@ ble_phy_rx_end_isr(void)
     /* Clear events and clear interrupt */
     NRF_RADIO->EVENTS_END = 0;
     NRF_RADIO->INTENCLR = RADIO_INTENCLR_END_Msk;
+    ble_ll_airtime_end();
 
     /* Disable automatic RXEN */
     NRF_PPI->CHENCLR = PPI_CHEN_CH21_Msk;
@@ -567,6 +575,22 @@ ble_phy_rx_start_isr(void)
             NRF_RADIO->BCC = (BLE_DEV_ADDR_LEN + BLE_LL_PDU_HDR_LEN) * 8;
         }
 #endif
+
+#if (MYNEWT_VAL(BLE_PHY_RX_EARLY_ABORT) == 1)
+        /*
+         * Re-arm the bit counter to fire when the advertiser address has
+         * been received so the LL can abort reception of PDUs that fail
+         * address filtering. The bit counter belongs to the AAR when
+         * privacy is enabled, and only the scanning state filters on the
+         * advertiser address.
+         */
+        if (!g_ble_phy_data.phy_privacy &&
+            (ble_ll_state_get() == BLE_LL_STATE_SCANNING)) {
+            NRF_RADIO->EVENTS_BCMATCH = 0;
+            NRF_RADIO->BCC = (BLE_DEV_ADDR_LEN + BLE_LL_PDU_HDR_LEN) * 8;
+            NRF_RADIO->INTENSET = RADIO_INTENSET_BCMATCH_Msk;
+        }
+#endif
     } else {
         /* Disable PHY */
         ble_phy_disable();
@@ -577,11 +601,39 @@ ble_phy_rx_start_isr(void)
     STATS_INC(ble_phy_stats, rx_starts);
 }
 
+#if (MYNEWT_VAL(BLE_PHY_RX_EARLY_ABORT) == 1)
+/**
+ * Called from interrupt context when the advertiser address bytes of the
+ * frame being received are in the receive buffer. If the Link Layer does
+ * not want the frame, stop receiving it and restart the receiver so the
+ * remaining scan window is spent listening instead of demodulating an
+ * unwanted payload.
+ */
+static void
+ble_phy_rx_adva_isr(void)
+{
+    int rc;
+
+    /* Clear events and clear interrupt */
+    NRF_RADIO->EVENTS_BCMATCH = 0;
+    NRF_RADIO->INTENCLR = RADIO_INTENCLR_BCMATCH_Msk;
+
+    rc = ble_ll_rx_adva(g_ble_phy_data.rxdptr, &g_ble_phy_data.rxhdr);
+    if (rc < 0) {
+        ble_phy_disable();
+        ble_phy_rx();
+        STATS_INC(ble_phy_stats, rx_early_aborts);
+    }
+}
+#endif
+
 static void
 ble_phy_isr(void)
 {
     uint32_t irq_en;
 
+    OS_TRACE_ENTER(OS_TRACE_ID_BLE_PHY_ISR, 0);
+
     /* Read irq register to determine which interrupts are enabled */
     irq_en = NRF_RADIO->INTENCLR;
 
@@ -595,6 +647,13 @@ ble_phy_isr(void)
         ble_phy_rx_start_isr();
     }
 
+#if (MYNEWT_VAL(BLE_PHY_RX_EARLY_ABORT) == 1)
+    /* We get this when the advertiser address of a frame has arrived */
+    if ((irq_en & RADIO_INTENCLR_BCMATCH_Msk) && NRF_RADIO->EVENTS_BCMATCH) {
+        ble_phy_rx_adva_isr();
+    }
+#endif
+
     /* Receive packet end (we dont enable this for transmit) */
     if ((irq_en & RADIO_INTENCLR_END_Msk) && NRF_RADIO->EVENTS_END) {
         ble_phy_rx_end_isr();
@@ -605,6 +664,8 @@ ble_phy_isr(void)
 
     /* Count # of interrupts */
     STATS_INC(ble_phy_stats, phy_isrs);
+
+    OS_TRACE_EXIT(OS_TRACE_ID_BLE_PHY_ISR, 0);
 }
 
 /**
@@ -714,6 +775,8 @@ ble_phy_init(void)
 int
 ble_phy_rx(void)
 {
+    OS_TRACE_EVENT(OS_TRACE_ID_BLE_PHY_RX, g_ble_phy_data.phy_chan);
+
     /* Check radio state */
     nrf_wait_disabled();
     if (NRF_RADIO->STATE != RADIO_STATE_STATE_Disabled) {
@@ -737,6 +800,8 @@ ble_phy_rx(void)
         NRF_RADIO->TASKS_RXEN = 1;
     }
 
+    ble_ll_airtime_start(g_ble_phy_data.phy_chan, 1);
+
     ble_ll_log(BLE_LL_LOG_ID_PHY_RX, g_ble_phy_data.phy_encrypted, 0, 0);
 
     return 0;
@@ -880,6 +945,8 @@ ble_phy_tx(struct os_mbuf *txpdu, uint8_t end_trans)
     /* Better have a pdu! */
     assert(txpdu != NULL);
 
+    OS_TRACE_EVENT(OS_TRACE_ID_BLE_PHY_TX, g_ble_phy_data.phy_chan);
+
     /*
      * This check is to make sure that the radio is not in a state where
      * it is moving to disabled state. If so, let it get there.
@@ -967,6 +1034,7 @@ ble_phy_tx(struct os_mbuf *txpdu, uint8_t end_trans)
 
         /* Set phy state to transmitting and count packet statistics */
         g_ble_phy_data.phy_state = BLE_PHY_STATE_TX;
+        ble_ll_airtime_start(g_ble_phy_data.phy_chan, 0);
         STATS_INC(ble_phy_stats, tx_good);
         STATS_INCN(ble_phy_stats, tx_bytes, payload_len + BLE_LL_PDU_HDR_LEN);
         rc = BLE_ERR_SUCCESS;
@@ -1122,6 +1190,8 @@ ble_phy_disable(void)
 {
     ble_ll_log(BLE_LL_LOG_ID_PHY_DISABLE, g_ble_phy_data.phy_state, 0, 0);
 
+    ble_ll_airtime_end();
+
     NRF_RADIO->INTENCLR = NRF_RADIO_IRQ_MASK_ALL;
     NRF_RADIO->SHORTS = 0;
     NRF_RADIO->TASKS_DISABLE = 1;
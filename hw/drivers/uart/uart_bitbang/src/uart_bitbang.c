@@ -21,6 +21,8 @@
 #include <stdio.h>
 #include <assert.h>
 
+#include <syscfg/syscfg.h>
+
 #include <hal/hal_gpio.h>
 #include <hal/hal_uart.h>
 #include <hal/hal_timer.h>
@@ -50,9 +52,13 @@ struct uart_bitbang {
     struct {
         int pin;                /* TX pin */
         struct hal_timer timer;
-        uint32_t start;         /* cputime when byte tx started */
-        uint8_t byte;           /* byte being transmitted */
-        uint8_t bits;           /* how many bits have been sent */
+        uint32_t start;         /* cputime when frame tx started */
+        uint32_t edges[10];     /* tick offsets of level transitions */
+        uint8_t nedges;         /* number of transitions in this frame */
+        uint8_t edge;           /* next transition to drive */
+        uint8_t fifo[MYNEWT_VAL(UART_BITBANG_TX_FIFO_SIZE)];
+        uint8_t fifo_out;       /* index of oldest byte in fifo */
+        uint8_t fifo_cnt;       /* number of bytes in fifo */
     } ub_tx;
 
     uint8_t ub_open:1;
@@ -68,47 +74,98 @@ struct uart_bitbang {
 /*
  * Bytes start with START bit (0) followed by 8 data bits and then the
  * STOP bit (1). STOP bit should be configurable. Data bits are sent LSB first.
+ *
+ * Precomputes the level-transition schedule for one frame.  Consecutive
+ * equal bits produce no transition, so a frame costs a compare interrupt
+ * per edge instead of one per bit (at most 10, typically about half that).
  */
+static void
+uart_bitbang_tx_sched(struct uart_bitbang *ub, uint8_t data)
+{
+    uint16_t frame;
+    int lvl;
+    int bit;
+    int n;
+    int i;
+
+    frame = (1 << 9) | ((uint16_t)data << 1);
+    lvl = 1;
+    n = 0;
+    for (i = 0; i < 10; i++) {
+        bit = (frame >> i) & 1;
+        if (bit != lvl) {
+            ub->ub_tx.edges[n++] = ub->ub_bittime * i;
+            lvl = bit;
+        }
+    }
+    ub->ub_tx.nedges = n;
+    ub->ub_tx.edge = 0;
+}
+
+/*
+ * Next byte to transmit; drains the prefetched FIFO before falling back
+ * to an upcall in interrupt context.
+ */
+static int
+uart_bitbang_tx_fifo_pop(struct uart_bitbang *ub)
+{
+    int data;
+
+    if (ub->ub_tx.fifo_cnt > 0) {
+        data = ub->ub_tx.fifo[ub->ub_tx.fifo_out];
+        ub->ub_tx.fifo_out = (ub->ub_tx.fifo_out + 1) %
+            MYNEWT_VAL(UART_BITBANG_TX_FIFO_SIZE);
+        ub->ub_tx.fifo_cnt--;
+        return data;
+    }
+    return ub->ub_tx_func(ub->ub_func_arg);
+}
+
 static void
 uart_bitbang_tx_timer(void *arg)
 {
     struct uart_bitbang *ub = (struct uart_bitbang *)arg;
-    uint32_t next = 0;
+    uint32_t next;
     int data;
 
-    if (!ub->ub_txing || ub->ub_tx.bits > 9) {
-        if (ub->ub_tx.bits > 9) {
+    if (!ub->ub_txing || ub->ub_tx.edge >= ub->ub_tx.nedges) {
+        if (ub->ub_txing) {
+            /*
+             * STOP bit has run to completion; the frame is done.
+             */
             if (ub->ub_tx_done) {
                 ub->ub_tx_done(ub->ub_func_arg);
             }
         }
-        data = ub->ub_tx_func(ub->ub_func_arg);
+        data = uart_bitbang_tx_fifo_pop(ub);
         if (data < 0) {
             ub->ub_txing = 0;
             return;
-        } else {
-            ub->ub_tx.byte = data;
         }
+        uart_bitbang_tx_sched(ub, data);
         /*
-         * Start bit
+         * First transition is the falling edge of the START bit; drive
+         * it now and pace the rest off the compare interrupt.
          */
         hal_gpio_write(ub->ub_tx.pin, 0);
         ub->ub_tx.start = os_cputime_get32();
-        next = ub->ub_tx.start + ub->ub_bittime;
+        ub->ub_tx.edge = 1;
         ub->ub_txing = 1;
-        ub->ub_tx.bits = 0;
     } else {
-        if (ub->ub_tx.bits++ < 8) {
-            hal_gpio_write(ub->ub_tx.pin, ub->ub_tx.byte & 0x01);
-            ub->ub_tx.byte = ub->ub_tx.byte >> 1;
-            next = ub->ub_tx.start + (ub->ub_bittime * (ub->ub_tx.bits + 1));
-        } else {
-            /*
-             * STOP bit.
-             */
-            hal_gpio_write(ub->ub_tx.pin, 1);
-            next = ub->ub_tx.start + (ub->ub_bittime * 10);
-        }
+        /*
+         * Levels alternate between transitions and the first edge is
+         * always falling, so the edge index parity is the new level.
+         */
+        hal_gpio_write(ub->ub_tx.pin, ub->ub_tx.edge & 1);
+        ub->ub_tx.edge++;
+    }
+    if (ub->ub_tx.edge < ub->ub_tx.nedges) {
+        next = ub->ub_tx.start + ub->ub_tx.edges[ub->ub_tx.edge];
+    } else {
+        /*
+         * No transitions remain; wake again when the STOP bit ends.
+         */
+        next = ub->ub_tx.start + (ub->ub_bittime * 10);
     }
     os_cputime_timer_start(&ub->ub_tx.timer, next);
 }
@@ -185,36 +242,50 @@ uart_bitbang_blocking_tx(struct uart_dev *dev, uint8_t data)
     if (!ub->ub_open) {
         return;
     }
-    hal_gpio_write(ub->ub_tx.pin, 0);
     start = os_cputime_get32();
-    next = start + ub->ub_bittime;
-    while (os_cputime_get32() < next);
+    hal_gpio_write(ub->ub_tx.pin, 0);
     for (i = 0; i < 8; i++) {
+        next = start + (ub->ub_bittime * (i + 1));
+        while (CPUTIME_LT(os_cputime_get32(), next));
         hal_gpio_write(ub->ub_tx.pin, data & 0x01);
         data = data >> 1;
-        next = start + (ub->ub_bittime * i + 1);
-        while (os_cputime_get32() < next);
     }
-    next = start + (ub->ub_bittime * 10);
+    next = start + (ub->ub_bittime * 9);
+    while (CPUTIME_LT(os_cputime_get32(), next));
     hal_gpio_write(ub->ub_tx.pin, 1);
-    while (os_cputime_get32() < next);
+    next = start + (ub->ub_bittime * 10);
+    while (CPUTIME_LT(os_cputime_get32(), next));
 }
 
 static void
 uart_bitbang_start_tx(struct uart_dev *dev)
 {
     struct uart_bitbang *ub;
+    int data;
     int sr;
 
     ub = (struct uart_bitbang *)dev->ud_priv;
     if (!ub->ub_open) {
         return;
     }
+    OS_ENTER_CRITICAL(sr);
+    /*
+     * Prefetch into the TX FIFO at task level so the edge interrupt can
+     * pull queued bytes without an upcall per frame.
+     */
+    while (ub->ub_tx.fifo_cnt < MYNEWT_VAL(UART_BITBANG_TX_FIFO_SIZE)) {
+        data = ub->ub_tx_func(ub->ub_func_arg);
+        if (data < 0) {
+            break;
+        }
+        ub->ub_tx.fifo[(ub->ub_tx.fifo_out + ub->ub_tx.fifo_cnt) %
+                       MYNEWT_VAL(UART_BITBANG_TX_FIFO_SIZE)] = data;
+        ub->ub_tx.fifo_cnt++;
+    }
     if (!ub->ub_txing) {
-        OS_ENTER_CRITICAL(sr);
         uart_bitbang_tx_timer(ub);
-        OS_EXIT_CRITICAL(sr);
     }
+    OS_EXIT_CRITICAL(sr);
 }
 
 static void
@@ -309,6 +380,7 @@ uart_bitbang_close(struct os_dev *odev)
     hal_gpio_irq_release(ub->ub_rx.pin);
     ub->ub_open = 0;
     ub->ub_txing = 0;
+    ub->ub_tx.fifo_cnt = 0;
     ub->ub_rx_stall = 0;
     os_cputime_timer_stop(&ub->ub_tx.timer);
     os_cputime_timer_stop(&ub->ub_rx.timer);
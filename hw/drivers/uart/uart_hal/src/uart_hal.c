@@ -27,12 +27,175 @@
 
 #include <uart/uart.h>
 
+#if MYNEWT_VAL(UART_HAL_BLOCK_MODE)
+#include <ringbuf/ringbuf.h>
+#endif
+
 #include "uart_hal/uart_hal.h"
 
 struct uart_hal_priv {
     int unit;
+#if MYNEWT_VAL(UART_HAL_BLOCK_MODE)
+    uart_tx_char uhp_tx_char;
+    uart_tx_done uhp_tx_done;
+    uart_rx_char uhp_rx_char;
+    void *uhp_cb_arg;
+    uint8_t uhp_tx_busy;
+    uint8_t uhp_rx_armed;
+    struct ringbuf uhp_rx_ring;
+    uint8_t uhp_tx_buf[MYNEWT_VAL(UART_HAL_BLOCK_BUF_SIZE)];
+    uint8_t uhp_rx_buf[MYNEWT_VAL(UART_HAL_BLOCK_BUF_SIZE)];
+#endif
 };
 
+#if MYNEWT_VAL(UART_HAL_BLOCK_MODE)
+/*
+ * Drain the upper layer's per-character tx callback into the staging
+ * buffer, so the whole chunk can go out as a single DMA transfer.
+ * Called with interrupts disabled.
+ */
+static int
+uart_hal_tx_fill(struct uart_hal_priv *priv)
+{
+    int len;
+    int ch;
+
+    len = 0;
+    while (len < sizeof(priv->uhp_tx_buf)) {
+        ch = priv->uhp_tx_char(priv->uhp_cb_arg);
+        if (ch < 0) {
+            break;
+        }
+        priv->uhp_tx_buf[len++] = ch;
+    }
+    return len;
+}
+
+static void
+uart_hal_tx_buf_done(void *arg, int len)
+{
+    struct uart_hal_priv *priv;
+    int rc;
+
+    priv = arg;
+
+    len = uart_hal_tx_fill(priv);
+    if (len > 0) {
+        rc = hal_uart_tx_buf(priv->unit, priv->uhp_tx_buf, len);
+        assert(rc == 0);
+    } else {
+        priv->uhp_tx_busy = 0;
+        if (priv->uhp_tx_done) {
+            priv->uhp_tx_done(priv->uhp_cb_arg);
+        }
+    }
+}
+
+/*
+ * Point the HAL's receive DMA at the ring's contiguous free region.
+ * A full ring leaves the receiver disarmed and flow control provides
+ * backpressure until the upper layer drains.  Called with interrupts
+ * disabled.
+ */
+static void
+uart_hal_rx_arm(struct uart_hal_priv *priv)
+{
+    uint32_t len;
+    uint8_t *buf;
+    int rc;
+
+    if (priv->uhp_rx_armed) {
+        return;
+    }
+    buf = ringbuf_put_reserve(&priv->uhp_rx_ring, &len);
+    if (len == 0) {
+        return;
+    }
+    priv->uhp_rx_armed = 1;
+    rc = hal_uart_rx_buf(priv->unit, buf, len, 1);
+    assert(rc == 0);
+}
+
+/*
+ * Deliver staged rx bytes to the upper layer in place; a partial
+ * commit keeps whatever the upper layer refused staged in the ring.
+ * Called with interrupts disabled.
+ */
+static void
+uart_hal_rx_deliver(struct uart_hal_priv *priv)
+{
+    const uint8_t *buf;
+    uint32_t len;
+    uint32_t i;
+    int rc;
+
+    while (1) {
+        buf = ringbuf_get_reserve(&priv->uhp_rx_ring, &len);
+        if (len == 0) {
+            break;
+        }
+        for (i = 0; i < len; i++) {
+            rc = priv->uhp_rx_char(priv->uhp_cb_arg, buf[i]);
+            if (rc < 0) {
+                break;
+            }
+        }
+        ringbuf_get_commit(&priv->uhp_rx_ring, i);
+        if (i < len) {
+            break;
+        }
+    }
+    uart_hal_rx_arm(priv);
+}
+
+static void
+uart_hal_rx_buf_cb(void *arg, uint8_t *buf, int len)
+{
+    struct uart_hal_priv *priv;
+
+    priv = arg;
+
+    priv->uhp_rx_armed = 0;
+    ringbuf_put_commit(&priv->uhp_rx_ring, len);
+    uart_hal_rx_deliver(priv);
+}
+
+static void
+uart_hal_start_tx(struct uart_dev *dev)
+{
+    struct uart_hal_priv *priv;
+    os_sr_t sr;
+    int len;
+    int rc;
+
+    priv = dev->ud_priv;
+    assert(priv);
+
+    OS_ENTER_CRITICAL(sr);
+    if (!priv->uhp_tx_busy) {
+        len = uart_hal_tx_fill(priv);
+        if (len > 0) {
+            priv->uhp_tx_busy = 1;
+            rc = hal_uart_tx_buf(priv->unit, priv->uhp_tx_buf, len);
+            assert(rc == 0);
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+static void
+uart_hal_start_rx(struct uart_dev *dev)
+{
+    struct uart_hal_priv *priv;
+    os_sr_t sr;
+
+    priv = dev->ud_priv;
+
+    OS_ENTER_CRITICAL(sr);
+    uart_hal_rx_deliver(priv);
+    OS_EXIT_CRITICAL(sr);
+}
+#else
 static void
 uart_hal_start_tx(struct uart_dev *dev)
 {
@@ -53,6 +216,7 @@ uart_hal_start_rx(struct uart_dev *dev)
 
     hal_uart_start_rx(priv->unit);
 }
+#endif
 
 static void
 uart_hal_blocking_tx(struct uart_dev *dev, uint8_t byte)
@@ -80,14 +244,39 @@ uart_hal_open(struct os_dev *odev, uint32_t wait, void *arg)
     if (odev->od_flags & OS_DEV_F_STATUS_OPEN) {
         return OS_EBUSY;
     }
+#if MYNEWT_VAL(UART_HAL_BLOCK_MODE)
+    priv->uhp_tx_char = uc->uc_tx_char;
+    priv->uhp_tx_done = uc->uc_tx_done;
+    priv->uhp_rx_char = uc->uc_rx_char;
+    priv->uhp_cb_arg = uc->uc_cb_arg;
+    priv->uhp_tx_busy = 0;
+    priv->uhp_rx_armed = 0;
+    rc = ringbuf_init(&priv->uhp_rx_ring, priv->uhp_rx_buf,
+      sizeof(priv->uhp_rx_buf), 0);
+    if (rc) {
+        return OS_EINVAL;
+    }
+    hal_uart_init_buf_cbs(priv->unit, uart_hal_tx_buf_done,
+      uart_hal_rx_buf_cb, priv);
+#else
     hal_uart_init_cbs(priv->unit, uc->uc_tx_char, uc->uc_tx_done,
       uc->uc_rx_char, uc->uc_cb_arg);
+#endif
 
     rc = hal_uart_config(priv->unit, uc->uc_speed, uc->uc_databits,
       uc->uc_stopbits, uc->uc_parity, uc->uc_flow_ctl);
     if (rc) {
         return OS_EINVAL;
     }
+#if MYNEWT_VAL(UART_HAL_BLOCK_MODE)
+    {
+        os_sr_t sr;
+
+        OS_ENTER_CRITICAL(sr);
+        uart_hal_rx_arm(priv);
+        OS_EXIT_CRITICAL(sr);
+    }
+#endif
     return OS_OK;
 }
 
@@ -0,0 +1,49 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_CRC_
+#define H_HAL_CRC_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+/**
+ * Compute a CRC16-CCITT over a buffer using a hardware CRC unit.  Only
+ * referenced when the CRC16_HAL syscfg setting is enabled; the MCU
+ * package must then supply the implementation.  The function must match
+ * the software crc16_ccitt() bit-for-bit, including for zero-length
+ * buffers, and must be callable from any task (i.e. it owns any locking
+ * the peripheral needs).
+ *
+ * @param initial_crc The crc to seed the computation with
+ * @param buf Buffer to compute the crc over
+ * @param len Number of bytes in 'buf'
+ *
+ * @return The computed crc.
+ */
+uint16_t hal_crc16_ccitt(uint16_t initial_crc, const void *buf, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_CRC_ */
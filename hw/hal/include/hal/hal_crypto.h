@@ -0,0 +1,67 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_CRYPTO_
+#define H_HAL_CRYPTO_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+#define HAL_AES_BLOCK_SZ        16
+#define HAL_AES_KEY_128_LEN     16
+
+/*
+ * AES-128 ECB encryption backed by a hardware AES engine.  Only
+ * referenced when the TINYCRYPT_AES_HAL syscfg setting is enabled; the
+ * MCU package must then supply the implementation.  The engine holds
+ * one key at a time; callers reload it with hal_aes_set_key() when
+ * they switch keys.  Higher level modes (CCM, CMAC, CTR) are built on
+ * top of this block primitive by the crypto libraries.
+ */
+
+/**
+ * Load an encryption key into the engine.
+ *
+ * @param key The raw key
+ * @param len Key length in bytes; only HAL_AES_KEY_128_LEN is required
+ *
+ * @return 0 on success, nonzero if the engine could not be claimed or
+ *         the key length is unsupported.
+ */
+int hal_aes_set_key(const uint8_t *key, int len);
+
+/**
+ * ECB-encrypt a run of blocks with the loaded key.
+ *
+ * @param pt     Plaintext, 'blocks' * HAL_AES_BLOCK_SZ bytes
+ * @param ct     Receives the ciphertext; may equal 'pt'
+ * @param blocks Number of blocks to encrypt
+ *
+ * @return 0 on success, nonzero on engine failure.
+ */
+int hal_aes_ecb_encrypt(const void *pt, void *ct, int blocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_CRYPTO_ */
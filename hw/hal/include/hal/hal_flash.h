@@ -25,6 +25,7 @@ extern "C" {
 #endif
 
 #include <inttypes.h>
+#include "syscfg/syscfg.h"
 
 int hal_flash_read(uint8_t flash_id, uint32_t address, void *dst,
   uint32_t num_bytes);
@@ -33,8 +34,28 @@ int hal_flash_write(uint8_t flash_id, uint32_t address, const void *src,
 int hal_flash_erase_sector(uint8_t flash_id, uint32_t sector_address);
 int hal_flash_erase(uint8_t flash_id, uint32_t address, uint32_t num_bytes);
 uint8_t hal_flash_align(uint8_t flash_id);
+const void *hal_flash_get_mapped(uint8_t flash_id, uint32_t address,
+  uint32_t num_bytes);
 int hal_flash_init(void);
 
+#if MYNEWT_VAL(HAL_FLASH_OBSERVE)
+#define HAL_FLASH_OP_READ       0
+#define HAL_FLASH_OP_WRITE      1
+#define HAL_FLASH_OP_ERASE      2
+
+/*
+ * Called after every flash operation with its duration in os_cputime
+ * ticks.  Erase observations are per sector; a multi-sector
+ * hal_flash_erase() reports once per sector with the sector size in
+ * num_bytes, while hal_flash_erase_sector() reports 0 (size unknown).
+ * Runs in the caller's context; must not block.
+ */
+typedef void hal_flash_obs_fn(uint8_t flash_id, int op, uint32_t address,
+  uint32_t num_bytes, uint32_t ticks, int rc, void *arg);
+
+int hal_flash_obs_register(hal_flash_obs_fn *fn, void *arg);
+#endif
+
 
 #ifdef __cplusplus
 }
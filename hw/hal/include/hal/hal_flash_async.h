@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_FLASH_ASYNC_
+#define H_HAL_FLASH_ASYNC_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+/*
+ * Function prototype for completion of an asynchronous flash operation.
+ * Called from the flash worker task context with the result of the
+ * underlying hal_flash call.
+ */
+typedef void (*hal_flash_async_cb)(int rc, void *arg);
+
+/**
+ * Initialize the asynchronous flash operation queue and start its worker
+ * task.  Call once, after hal_flash_init(), before submitting operations.
+ *
+ * @return 0 on success, nonzero on failure.
+ */
+int hal_flash_async_init(void);
+
+/**
+ * Queue a flash write.  Operations against the same flash device execute
+ * in submission order.  'src' must remain valid until the completion
+ * callback runs; 'cb' may be NULL for fire-and-forget writes.
+ *
+ * @return 0 if the operation was queued, -1 if the queue is full.
+ */
+int hal_flash_async_write(uint8_t flash_id, uint32_t address,
+  const void *src, uint32_t num_bytes, hal_flash_async_cb cb, void *cb_arg);
+
+/**
+ * Queue a flash erase covering [address, address + num_bytes).
+ *
+ * @return 0 if the operation was queued, -1 if the queue is full.
+ */
+int hal_flash_async_erase(uint8_t flash_id, uint32_t address,
+  uint32_t num_bytes, hal_flash_async_cb cb, void *cb_arg);
+
+/**
+ * Flush barrier; blocks the caller until every operation queued before
+ * this call has completed.
+ *
+ * @param timeout Number of os ticks to wait; OS_WAIT_FOREVER waits
+ *                forever.
+ *
+ * @return 0 when the queue drained, OS_TIMEOUT on timeout, -1 if the
+ *         barrier could not be queued.
+ */
+int hal_flash_async_flush(uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_FLASH_ASYNC_ */
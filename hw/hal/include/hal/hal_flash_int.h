@@ -43,6 +43,8 @@ struct hal_flash {
     uint32_t hf_size;
     int hf_sector_cnt;
     int hf_align;		/* Alignment requirement. 1 if unrestricted. */
+    uint8_t hf_mapped;		/* Contents are in the CPU address space at
+				   hff_read addresses. */
 };
 
 /*
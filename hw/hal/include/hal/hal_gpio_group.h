@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_GPIO_GROUP_
+#define H_HAL_GPIO_GROUP_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+#include "syscfg/syscfg.h"
+#include "hal/hal_gpio.h"
+
+/*
+ * Group operations drive several pins as one parallel bus.  Bit i of a
+ * value corresponds to pins[i]; a group may hold at most 32 pins.
+ * Write and toggle update every pin inside a single critical section,
+ * so an interrupt cannot land between the edges of one bus update.
+ */
+
+/**
+ * Initialize every pin of a group as an output, set to the given value.
+ *
+ * @param pins  Pin numbers making up the group
+ * @param npins Number of pins in the group (at most 32)
+ * @param val   Initial value; bit i sets pins[i]
+ *
+ * @return int  0: no error; -1 otherwise.
+ */
+int hal_gpio_group_init_out(const int8_t *pins, int npins, uint32_t val);
+
+/**
+ * Initialize every pin of a group as an input with the given pull.
+ *
+ * @param pins  Pin numbers making up the group
+ * @param npins Number of pins in the group (at most 32)
+ * @param pull  pull type, applied to every pin
+ *
+ * @return int  0: no error; -1 otherwise.
+ */
+int hal_gpio_group_init_in(const int8_t *pins, int npins,
+                           hal_gpio_pull_t pull);
+
+/**
+ * Write a value across a group of pins.
+ *
+ * @param pins  Pin numbers making up the group
+ * @param npins Number of pins in the group
+ * @param val   Value to write; bit i drives pins[i]
+ */
+void hal_gpio_group_write(const int8_t *pins, int npins, uint32_t val);
+
+/**
+ * Read a group of pins into one value.
+ *
+ * @param pins  Pin numbers making up the group
+ * @param npins Number of pins in the group
+ *
+ * @return uint32_t Bit i holds the state of pins[i]
+ */
+uint32_t hal_gpio_group_read(const int8_t *pins, int npins);
+
+/**
+ * Toggle the pins of a group selected by a mask.
+ *
+ * @param pins  Pin numbers making up the group
+ * @param npins Number of pins in the group
+ * @param mask  Pins to toggle; bit i selects pins[i]
+ */
+void hal_gpio_group_toggle(const int8_t *pins, int npins, uint32_t mask);
+
+#if MYNEWT_VAL(HAL_GPIO_IRQ_STATS)
+/**
+ * Attach an IRQ handler to a pin with dispatch instrumentation; same
+ * contract as hal_gpio_irq_init().  Every dispatch is counted and timed
+ * (os_cputime ticks from handler entry to return) into the
+ * "hal_gpio_irq" stats group, so interrupt load and jitter can be read
+ * in the field.  At most HAL_GPIO_IRQ_STATS_MAX_PINS distinct pins can
+ * be instrumented; re-initializing a pin reuses its slot.
+ */
+int hal_gpio_irq_init_timed(int pin, hal_gpio_irq_handler_t handler,
+                            void *arg, hal_gpio_irq_trig_t trig,
+                            hal_gpio_pull_t pull);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_GPIO_GROUP_ */
@@ -0,0 +1,70 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_HASH_
+#define H_HAL_HASH_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+#define HAL_HASH_SHA256_LEN     32
+
+/*
+ * Streaming SHA-256 backed by a hardware hash engine.  Only referenced
+ * when the BOOTUTIL_HAL_HASH syscfg setting is enabled; the MCU package
+ * must then supply the implementation.  The digest must match software
+ * SHA-256 bit-for-bit.  The engine holds one stream at a time between
+ * start and finish; callers are expected to serialize (bootutil hashes
+ * one image at a time, which is the intended user).
+ */
+
+/**
+ * Begin a SHA-256 computation.
+ *
+ * @return 0 on success, nonzero if the engine could not be claimed.
+ */
+int hal_hash_sha256_start(void);
+
+/**
+ * Feed bytes into the current computation.
+ *
+ * @param buf Data to digest
+ * @param len Number of bytes in 'buf'
+ *
+ * @return 0 on success, nonzero on engine failure.
+ */
+int hal_hash_sha256_update(const void *buf, int len);
+
+/**
+ * Finish the computation and release the engine.
+ *
+ * @param digest Receives the HAL_HASH_SHA256_LEN byte digest
+ *
+ * @return 0 on success, nonzero on engine failure.
+ */
+int hal_hash_sha256_finish(uint8_t *digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_HASH_ */
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_I2C_ASYNC_
+#define H_HAL_I2C_ASYNC_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+/*
+ * Function prototype for completion of an asynchronous I2C transaction.
+ * Called from the I2C worker task context with the result of the last
+ * underlying hal_i2c call.
+ */
+typedef void (*hal_i2c_async_cb)(int rc, void *arg);
+
+/**
+ * Initialize the asynchronous I2C transaction queue and start its
+ * worker task.  Call once, after the interfaces have been set up with
+ * hal_i2c_init(), before submitting transactions.
+ *
+ * @return 0 on success, nonzero on failure.
+ */
+int hal_i2c_async_init(void);
+
+/**
+ * Queue a write-then-read transaction against a device.  The write
+ * phase (if 'wlen' is nonzero) ends without a STOP when a read phase
+ * follows, so register address and data move under one repeated-start
+ * transaction.  Either phase may be omitted by passing a zero length.
+ *
+ * A transaction that fails (NACK, lost arbitration on a multi-master
+ * bus) is retried from a fresh START up to HAL_I2C_ASYNC_RETRIES
+ * times, with a delay that doubles after every attempt.  Buffers must
+ * remain valid until the completion callback runs; 'cb' may be NULL.
+ *
+ * @param i2c_num I2C interface to use
+ * @param address 7-bit device address
+ * @param wbuf    Bytes to write; may be NULL if 'wlen' is 0
+ * @param wlen    Number of bytes to write
+ * @param rbuf    Buffer for bytes to read; may be NULL if 'rlen' is 0
+ * @param rlen    Number of bytes to read
+ * @param timeout Per-phase timeout, in os ticks
+ * @param cb      Completion callback; may be NULL
+ * @param cb_arg  Argument passed to 'cb'
+ *
+ * @return 0 if the transaction was queued, -1 if the queue is full.
+ */
+int hal_i2c_async_txn(uint8_t i2c_num, uint8_t address, const void *wbuf,
+  uint16_t wlen, void *rbuf, uint16_t rlen, uint32_t timeout,
+  hal_i2c_async_cb cb, void *cb_arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_I2C_ASYNC_ */
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_SPI_CHAIN_
+#define H_HAL_SPI_CHAIN_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+/**
+ * One segment of a chained SPI transaction.  Segments execute
+ * back-to-back from the transfer-complete interrupt, so the bus never
+ * idles waiting for a task to queue the next buffer.  The buffer rules
+ * of hal_spi_txrx_noblock() apply per segment.
+ */
+struct hal_spi_chain_desc {
+    struct hal_spi_chain_desc *hscd_next;
+    void *hscd_txbuf;
+    void *hscd_rxbuf;
+    uint16_t hscd_len;
+    /*
+     * GPIO driven low for the duration of this segment and released
+     * when the next segment uses a different pin (or the chain ends);
+     * -1 leaves chip select alone.  The pin must have been configured
+     * with hal_gpio_init_out() beforehand.
+     */
+    int8_t hscd_cs_pin;
+};
+
+/*
+ * Completion callback; runs at interrupt context when the last segment
+ * finishes, or with a nonzero status if a segment failed to start.
+ */
+typedef void (*hal_spi_chain_cb)(void *arg, int status);
+
+/**
+ * Attach the chain engine to an enabled master SPI.  Takes over the
+ * interface's txrx callback (hal_spi_set_txrx_cb), so the non-blocking
+ * single-buffer API should not be mixed with chained transactions.
+ *
+ * @param spi_num SPI interface to drive
+ *
+ * @return 0 on success, nonzero error code on failure.
+ */
+int hal_spi_chain_init(int spi_num);
+
+/**
+ * Start a chain of transfer segments.  The descriptors and buffers must
+ * stay valid until the completion callback runs.  Only one chain may be
+ * in flight per interface.
+ *
+ * @param spi_num SPI interface to use
+ * @param chain   First descriptor of the chain
+ * @param cb      Completion callback; may be NULL
+ * @param arg     Argument passed to 'cb'
+ *
+ * @return 0 if the chain was started, -1 if the interface is busy or
+ *         the chain could not be started.
+ */
+int hal_spi_chain_submit(int spi_num, struct hal_spi_chain_desc *chain,
+  hal_spi_chain_cb cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_SPI_CHAIN_ */
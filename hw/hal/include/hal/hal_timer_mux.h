@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_TIMER_MUX_
+#define H_HAL_TIMER_MUX_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+#include "os/queue.h"
+#include "hal/hal_timer.h"
+
+/**
+ * A software-multiplexed high resolution timer.  Any number of these
+ * share a single hal_timer compare channel: the service keeps them on a
+ * deadline-sorted list and re-arms the one hardware timer for whichever
+ * expires first, so applications get many microsecond-precision timers
+ * without contending for the scarce hardware channels.
+ *
+ * NOTE: the user should not have to modify/examine the contents of this
+ * structure; the hal timer mux API should be used.
+ */
+struct hal_timer_mux {
+    hal_timer_cb        htm_cb;     /* Callback function */
+    void                *htm_cb_arg; /* Callback argument */
+    uint32_t            htm_expiry; /* Tick at which timer should expire */
+    uint8_t             htm_active; /* Nonzero while on the deadline list */
+    TAILQ_ENTRY(hal_timer_mux) htm_link;
+};
+
+/**
+ * Attach the multiplexer to a configured hardware timer.  Claims one
+ * hal_timer slot on that interface; the ticks passed to the start
+ * functions are that timer's ticks.  Call once, after hal_timer_config().
+ *
+ * @param timer_num Hardware timer to dispatch from
+ *
+ * @return 0 on success, nonzero error code on failure.
+ */
+int hal_timer_mux_init(int timer_num);
+
+/*
+ * Set the timer structure prior to use.  Should not be called if the
+ * timer is running.  Must be called at least once prior to using timer.
+ */
+int hal_timer_mux_set_cb(struct hal_timer_mux *tmr, hal_timer_cb cb_func,
+                         void *arg);
+
+/* Start a timer that will expire in 'ticks' ticks.  Ticks cannot be 0 */
+int hal_timer_mux_start(struct hal_timer_mux *tmr, uint32_t ticks);
+
+/*
+ * Start a timer that will expire when the underlying timer reaches
+ * 'tick'.  If tick has already passed the callback will be called
+ * "immediately" (at interrupt context).
+ */
+int hal_timer_mux_start_at(struct hal_timer_mux *tmr, uint32_t tick);
+
+/* Stop a currently running timer; associated callback will NOT be called */
+int hal_timer_mux_stop(struct hal_timer_mux *tmr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_TIMER_MUX_ */
@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_TRNG_
+#define H_HAL_TRNG_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+/*
+ * True random number generator, backed by the MCU TRNG peripheral.
+ * The peripheral fills an entropy ring cache from its data-ready
+ * interrupt and is stopped while the cache is full, so consumers
+ * normally find entropy already gathered instead of waiting for the
+ * peripheral's generation time.  Enabled with the HAL_TRNG syscfg
+ * setting; the MCU package must implement the hal_trng_int.h driver
+ * interface.
+ */
+
+/**
+ * Initializes the TRNG peripheral and starts filling the entropy
+ * cache.
+ *
+ * @return 0 on success, nonzero on failure.
+ */
+int hal_trng_init(void);
+
+/**
+ * Copies up to 'len' bytes of entropy from the cache into 'buf'
+ * without blocking and restarts the peripheral to replace what was
+ * taken.
+ *
+ * @return The number of bytes provided; 0 if the cache is empty.
+ */
+int hal_trng_read(void *buf, int len);
+
+/**
+ * Like hal_trng_read(), but waits for the cache to refill until the
+ * full 'len' bytes have been provided.
+ *
+ * @return len.
+ */
+int hal_trng_read_blocking(void *buf, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_TRNG_ */
@@ -0,0 +1,44 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_HAL_TRNG_INT_
+#define H_HAL_TRNG_INT_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+/*
+ * API that the MCU TRNG driver has to implement.  The driver calls
+ * 'sample_cb' from its data-ready interrupt with each byte of
+ * conditioned entropy while started; the generic layer stops the
+ * peripheral when its cache is full and restarts it as entropy is
+ * consumed.
+ */
+int hal_trng_dev_init(void (*sample_cb)(uint8_t byte));
+int hal_trng_dev_start(void);
+int hal_trng_dev_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_HAL_TRNG_INT_ */
@@ -58,6 +58,57 @@ typedef int (*hal_uart_rx_char)(void *arg, uint8_t byte);
 int hal_uart_init_cbs(int uart, hal_uart_tx_char tx_func,
   hal_uart_tx_done tx_done, hal_uart_rx_char rx_func, void *arg);
 
+/*
+ * Function prototype for UART driver to report that a buffer submitted
+ * with hal_uart_tx_buf() has been fully transmitted.
+ * Driver must call this with interrupts disabled.
+ */
+typedef void (*hal_uart_tx_buf_done)(void *arg, int len);
+
+/*
+ * Function prototype for UART driver to hand over data received into a
+ * buffer armed with hal_uart_rx_buf().  Called when at least the armed
+ * watermark of bytes has accumulated, or when the buffer fills.  The
+ * buffer is no longer owned by the driver until it is re-armed.
+ * Driver must call this with interrupts disabled.
+ */
+typedef void (*hal_uart_rx_buf_func)(void *arg, uint8_t *buf, int len);
+
+/**
+ * hal uart init buf cbs
+ *
+ * Initializes given uart for block-oriented transfers instead of the
+ * per-character callbacks.  Block transfers are optional; only MCUs
+ * whose driver can map them to DMA (or FIFO burst) provide
+ * hal_uart_tx_buf()/hal_uart_rx_buf(), and the mode is selected at
+ * build time by the driver package sitting on top of this HAL.
+ */
+int hal_uart_init_buf_cbs(int uart, hal_uart_tx_buf_done tx_done,
+  hal_uart_rx_buf_func rx_func, void *arg);
+
+/**
+ * hal uart tx buf
+ *
+ * Start transmission of 'len' bytes from 'buf'.  The buffer must stay
+ * valid until the tx_done callback reports completion; at most one
+ * transmit buffer may be outstanding per uart.
+ *
+ * @return 0 if the transfer was started, -1 on error.
+ */
+int hal_uart_tx_buf(int uart, const uint8_t *buf, int len);
+
+/**
+ * hal uart rx buf
+ *
+ * Arm 'buf' (of 'len' bytes) for reception.  The rx_func callback is
+ * invoked once at least 'watermark' bytes are available, or the buffer
+ * is full; reception stops until the buffer is re-armed, relying on
+ * flow control for backpressure.
+ *
+ * @return 0 if the buffer was armed, -1 on error.
+ */
+int hal_uart_rx_buf(int uart, uint8_t *buf, int len, int watermark);
+
 enum hal_uart_parity {
     HAL_UART_PARITY_NONE = 0,	/* no parity */
     HAL_UART_PARITY_ODD = 1,	/* odd parity bit */
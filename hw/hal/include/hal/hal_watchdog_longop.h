@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _HAL_WATCHDOG_LONGOP_H_
+#define _HAL_WATCHDOG_LONGOP_H_
+
+#include <stdint.h>
+
+#include "hal/hal_timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A scoped long-running operation that the watchdog should tolerate.
+ * While the operation is active a high resolution timer tickles the
+ * watchdog on the caller's behalf, but only as long as the operation
+ * keeps making forward progress (the caller bumps a progress counter,
+ * e.g. once per erased sector) and stays within its declared duration.
+ * A stalled or overrunning operation stops being tickled and the
+ * watchdog fires as it should, so the global timeout can be kept
+ * short without spurious resets during flash maintenance.
+ *
+ * NOTE: the user should not have to modify/examine the contents of
+ * this structure; the longop API should be used.
+ */
+struct hal_watchdog_longop {
+    struct hal_timer hwl_timer; /* Tickle timer (cputime channel) */
+    uint32_t hwl_progress;      /* Caller-updated progress counter */
+    uint32_t hwl_seen;          /* Progress value at the last tickle */
+    uint32_t hwl_remaining;     /* Tickles left within the declared budget */
+    uint8_t hwl_active;         /* Nonzero between begin and end */
+};
+
+/**
+ * Enter a long operation section.  The watchdog is tickled every
+ * HAL_WATCHDOG_LONGOP_TICKLE_MSECS until hal_watchdog_longop_end(),
+ * the declared duration runs out, or progress stops.
+ *
+ * @param op             Operation state; owned by the service until end
+ * @param expected_msecs Upper bound on the operation's duration
+ *
+ * @return 0 on success, nonzero error code on failure.
+ */
+int hal_watchdog_longop_begin(struct hal_watchdog_longop *op,
+                              uint32_t expected_msecs);
+
+/**
+ * Record forward progress; call from the operation's loop (e.g. after
+ * each erased sector or programmed block).  Safe at any context.
+ */
+static inline void
+hal_watchdog_longop_progress(struct hal_watchdog_longop *op)
+{
+    op->hwl_progress++;
+}
+
+/**
+ * Leave a long operation section; stops the auto-tickle timer.
+ *
+ * @return 0 on success, nonzero error code on failure.
+ */
+int hal_watchdog_longop_end(struct hal_watchdog_longop *op);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HAL_WATCHDOG_LONGOP_H_ */
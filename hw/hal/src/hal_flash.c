@@ -17,6 +17,7 @@
  * under the License.
  */
 #include <inttypes.h>
+#include <stddef.h>
 #include <assert.h>
 #include <bsp/bsp.h>
 
@@ -24,6 +25,41 @@
 #include "hal/hal_flash.h"
 #include "hal/hal_flash_int.h"
 
+#if MYNEWT_VAL(HAL_FLASH_OBSERVE)
+#include "os/os_cputime.h"
+
+static hal_flash_obs_fn *hal_flash_obs_cb;
+static void *hal_flash_obs_arg;
+
+int
+hal_flash_obs_register(hal_flash_obs_fn *fn, void *arg)
+{
+    hal_flash_obs_cb = fn;
+    hal_flash_obs_arg = arg;
+    return 0;
+}
+
+static void
+hal_flash_observe(uint8_t id, int op, uint32_t address, uint32_t num_bytes,
+  uint32_t start, int rc)
+{
+    if (hal_flash_obs_cb) {
+        hal_flash_obs_cb(id, op, address, num_bytes,
+          os_cputime_get32() - start, rc, hal_flash_obs_arg);
+    }
+}
+
+static uint32_t
+hal_flash_obs_start(void)
+{
+    return hal_flash_obs_cb ? os_cputime_get32() : 0;
+}
+#else
+#define hal_flash_obs_start()   0
+#define hal_flash_observe(id, op, addr, len, start, rc) \
+    ((void)(id), (void)(len), (void)(start))
+#endif
+
 int
 hal_flash_init(void)
 {
@@ -55,6 +91,27 @@ hal_flash_align(uint8_t flash_id)
     return hf->hf_align;
 }
 
+/**
+ * Returns a pointer through which the specified flash range can be read
+ * directly, or NULL if the device is not memory mapped or the range falls
+ * outside it.
+ */
+const void *
+hal_flash_get_mapped(uint8_t flash_id, uint32_t address, uint32_t num_bytes)
+{
+    const struct hal_flash *hf;
+
+    hf = hal_bsp_flash_dev(flash_id);
+    if (!hf || !hf->hf_mapped) {
+        return NULL;
+    }
+    if (address < hf->hf_base_addr ||
+        address + num_bytes > hf->hf_base_addr + hf->hf_size) {
+        return NULL;
+    }
+    return (const void *)(uintptr_t)address;
+}
+
 uint32_t
 hal_flash_sector_size(const struct hal_flash *hf, int sec_idx)
 {
@@ -80,6 +137,8 @@ int
 hal_flash_read(uint8_t id, uint32_t address, void *dst, uint32_t num_bytes)
 {
     const struct hal_flash *hf;
+    uint32_t start;
+    int rc;
 
     hf = hal_bsp_flash_dev(id);
     if (!hf) {
@@ -89,7 +148,10 @@ hal_flash_read(uint8_t id, uint32_t address, void *dst, uint32_t num_bytes)
       hal_flash_check_addr(hf, address + num_bytes)) {
         return -1;
     }
-    return hf->hf_itf->hff_read(address, dst, num_bytes);
+    start = hal_flash_obs_start();
+    rc = hf->hf_itf->hff_read(address, dst, num_bytes);
+    hal_flash_observe(id, HAL_FLASH_OP_READ, address, num_bytes, start, rc);
+    return rc;
 }
 
 int
@@ -97,6 +159,8 @@ hal_flash_write(uint8_t id, uint32_t address, const void *src,
   uint32_t num_bytes)
 {
     const struct hal_flash *hf;
+    uint32_t start;
+    int rc;
 
     hf = hal_bsp_flash_dev(id);
     if (!hf) {
@@ -106,7 +170,24 @@ hal_flash_write(uint8_t id, uint32_t address, const void *src,
       hal_flash_check_addr(hf, address + num_bytes)) {
         return -1;
     }
-    return hf->hf_itf->hff_write(address, src, num_bytes);
+    start = hal_flash_obs_start();
+    rc = hf->hf_itf->hff_write(address, src, num_bytes);
+    hal_flash_observe(id, HAL_FLASH_OP_WRITE, address, num_bytes, start, rc);
+    return rc;
+}
+
+static int
+hal_flash_erase_sector_impl(const struct hal_flash *hf, uint8_t id,
+  uint32_t sector_address, uint32_t sector_size)
+{
+    uint32_t start;
+    int rc;
+
+    start = hal_flash_obs_start();
+    rc = hf->hf_itf->hff_erase_sector(sector_address);
+    hal_flash_observe(id, HAL_FLASH_OP_ERASE, sector_address, sector_size,
+      start, rc);
+    return rc;
 }
 
 int
@@ -121,7 +202,7 @@ hal_flash_erase_sector(uint8_t id, uint32_t sector_address)
     if (hal_flash_check_addr(hf, sector_address)) {
         return -1;
     }
-    return hf->hf_itf->hff_erase_sector(sector_address);
+    return hal_flash_erase_sector_impl(hf, id, sector_address, 0);
 }
 
 int
@@ -160,7 +241,7 @@ hal_flash_erase(uint8_t id, uint32_t address, uint32_t num_bytes)
              * If some region of eraseable area falls inside sector,
              * erase the sector.
              */
-            if (hf->hf_itf->hff_erase_sector(start)) {
+            if (hal_flash_erase_sector_impl(hf, id, start, size)) {
                 return -1;
             }
         }
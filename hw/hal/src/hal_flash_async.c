@@ -0,0 +1,252 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HAL_FLASH_ASYNC)
+
+#include <assert.h>
+#include <string.h>
+
+#include "os/os.h"
+#include "hal/hal_flash.h"
+#include "hal/hal_flash_async.h"
+
+#define HAL_FLASH_ASYNC_OP_WRITE        0
+#define HAL_FLASH_ASYNC_OP_ERASE        1
+#define HAL_FLASH_ASYNC_OP_BARRIER      2
+
+/* Worker reached the barrier and released hfa_sem */
+#define HAL_FLASH_ASYNC_F_DONE          0x01
+/* Flush caller timed out; worker frees the op instead */
+#define HAL_FLASH_ASYNC_F_ABANDONED     0x02
+
+struct hal_flash_async_op {
+    STAILQ_ENTRY(hal_flash_async_op) hfa_next;
+    uint8_t hfa_type;
+    uint8_t hfa_flash_id;
+    uint8_t hfa_flags;
+    uint32_t hfa_addr;
+    uint32_t hfa_len;
+    const void *hfa_src;
+    hal_flash_async_cb hfa_cb;
+    void *hfa_cb_arg;
+    /* Released when a barrier op reaches the head of the queue */
+    struct os_sem hfa_sem;
+};
+
+static STAILQ_HEAD(, hal_flash_async_op) hal_flash_async_queue =
+    STAILQ_HEAD_INITIALIZER(hal_flash_async_queue);
+
+static struct os_mempool hal_flash_async_pool;
+static os_membuf_t hal_flash_async_pool_buf[
+    OS_MEMPOOL_SIZE(MYNEWT_VAL(HAL_FLASH_ASYNC_MAX_OPS),
+                    sizeof(struct hal_flash_async_op))];
+
+/* Counts queued operations; the worker task pends on it */
+static struct os_sem hal_flash_async_work_sem;
+
+static struct os_task hal_flash_async_task;
+static os_stack_t hal_flash_async_stack[
+    OS_STACK_ALIGN(MYNEWT_VAL(HAL_FLASH_ASYNC_STACK_SIZE))];
+
+static int
+hal_flash_async_enqueue(struct hal_flash_async_op *op)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    STAILQ_INSERT_TAIL(&hal_flash_async_queue, op, hfa_next);
+    OS_EXIT_CRITICAL(sr);
+
+    return os_sem_release(&hal_flash_async_work_sem);
+}
+
+static void
+hal_flash_async_task_handler(void *arg)
+{
+    struct hal_flash_async_op *op;
+    os_sr_t sr;
+    int rc;
+
+    while (1) {
+        rc = os_sem_pend(&hal_flash_async_work_sem, OS_WAIT_FOREVER);
+        assert(rc == OS_OK);
+
+        OS_ENTER_CRITICAL(sr);
+        op = STAILQ_FIRST(&hal_flash_async_queue);
+        assert(op);
+        STAILQ_REMOVE_HEAD(&hal_flash_async_queue, hfa_next);
+        OS_EXIT_CRITICAL(sr);
+
+        if (op->hfa_type == HAL_FLASH_ASYNC_OP_BARRIER) {
+            /* The flush caller frees a completed barrier (it owns the
+             * embedded semaphore); an abandoned one is freed here.
+             */
+            OS_ENTER_CRITICAL(sr);
+            if (op->hfa_flags & HAL_FLASH_ASYNC_F_ABANDONED) {
+                OS_EXIT_CRITICAL(sr);
+                os_memblock_put(&hal_flash_async_pool, op);
+            } else {
+                op->hfa_flags |= HAL_FLASH_ASYNC_F_DONE;
+                OS_EXIT_CRITICAL(sr);
+                os_sem_release(&op->hfa_sem);
+            }
+            continue;
+        }
+
+        switch (op->hfa_type) {
+        case HAL_FLASH_ASYNC_OP_WRITE:
+            rc = hal_flash_write(op->hfa_flash_id, op->hfa_addr, op->hfa_src,
+              op->hfa_len);
+            break;
+        case HAL_FLASH_ASYNC_OP_ERASE:
+            rc = hal_flash_erase(op->hfa_flash_id, op->hfa_addr, op->hfa_len);
+            break;
+        default:
+            assert(0);
+            rc = -1;
+            break;
+        }
+
+        if (op->hfa_cb) {
+            op->hfa_cb(rc, op->hfa_cb_arg);
+        }
+        os_memblock_put(&hal_flash_async_pool, op);
+    }
+}
+
+static int
+hal_flash_async_submit(uint8_t type, uint8_t flash_id, uint32_t address,
+  const void *src, uint32_t num_bytes, hal_flash_async_cb cb, void *cb_arg)
+{
+    struct hal_flash_async_op *op;
+
+    op = os_memblock_get(&hal_flash_async_pool);
+    if (!op) {
+        return -1;
+    }
+    op->hfa_type = type;
+    op->hfa_flash_id = flash_id;
+    op->hfa_flags = 0;
+    op->hfa_addr = address;
+    op->hfa_len = num_bytes;
+    op->hfa_src = src;
+    op->hfa_cb = cb;
+    op->hfa_cb_arg = cb_arg;
+
+    if (hal_flash_async_enqueue(op)) {
+        os_memblock_put(&hal_flash_async_pool, op);
+        return -1;
+    }
+    return 0;
+}
+
+int
+hal_flash_async_write(uint8_t flash_id, uint32_t address, const void *src,
+  uint32_t num_bytes, hal_flash_async_cb cb, void *cb_arg)
+{
+    return hal_flash_async_submit(HAL_FLASH_ASYNC_OP_WRITE, flash_id,
+      address, src, num_bytes, cb, cb_arg);
+}
+
+int
+hal_flash_async_erase(uint8_t flash_id, uint32_t address, uint32_t num_bytes,
+  hal_flash_async_cb cb, void *cb_arg)
+{
+    return hal_flash_async_submit(HAL_FLASH_ASYNC_OP_ERASE, flash_id,
+      address, NULL, num_bytes, cb, cb_arg);
+}
+
+int
+hal_flash_async_flush(uint32_t timeout)
+{
+    struct hal_flash_async_op *op;
+    os_sr_t sr;
+    int done;
+    int rc;
+
+    op = os_memblock_get(&hal_flash_async_pool);
+    if (!op) {
+        return -1;
+    }
+    memset(op, 0, sizeof(*op));
+    op->hfa_type = HAL_FLASH_ASYNC_OP_BARRIER;
+    os_sem_init(&op->hfa_sem, 0);
+
+    if (hal_flash_async_enqueue(op)) {
+        os_memblock_put(&hal_flash_async_pool, op);
+        return -1;
+    }
+
+    rc = os_sem_pend(&op->hfa_sem, timeout);
+    if (rc == OS_TIMEOUT) {
+        /*
+         * The worker may have reached the barrier between the timeout
+         * and now; if not, leave the op for the worker to free.
+         */
+        OS_ENTER_CRITICAL(sr);
+        done = op->hfa_flags & HAL_FLASH_ASYNC_F_DONE;
+        if (!done) {
+            op->hfa_flags |= HAL_FLASH_ASYNC_F_ABANDONED;
+        }
+        OS_EXIT_CRITICAL(sr);
+        if (!done) {
+            return OS_TIMEOUT;
+        }
+        /* Consume the release that beat us to it */
+        os_sem_pend(&op->hfa_sem, OS_WAIT_FOREVER);
+    }
+    os_memblock_put(&hal_flash_async_pool, op);
+    return 0;
+}
+
+int
+hal_flash_async_init(void)
+{
+    int rc;
+
+    rc = os_mempool_init(&hal_flash_async_pool,
+      MYNEWT_VAL(HAL_FLASH_ASYNC_MAX_OPS),
+      sizeof(struct hal_flash_async_op), hal_flash_async_pool_buf,
+      "hal_flash_async");
+    if (rc != 0) {
+        goto err;
+    }
+
+    rc = os_sem_init(&hal_flash_async_work_sem, 0);
+    if (rc != OS_OK) {
+        goto err;
+    }
+
+    rc = os_task_init(&hal_flash_async_task, "fl_async",
+      hal_flash_async_task_handler, NULL,
+      MYNEWT_VAL(HAL_FLASH_ASYNC_TASK_PRIO), OS_WAIT_FOREVER,
+      hal_flash_async_stack,
+      OS_STACK_ALIGN(MYNEWT_VAL(HAL_FLASH_ASYNC_STACK_SIZE)));
+    if (rc != 0) {
+        goto err;
+    }
+
+    return (0);
+err:
+    return (rc);
+}
+
+#endif /* MYNEWT_VAL(HAL_FLASH_ASYNC) */
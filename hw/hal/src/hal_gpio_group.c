@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HAL_GPIO_GROUP)
+
+#include "os/os.h"
+#include "hal/hal_gpio.h"
+#include "hal/hal_gpio_group.h"
+
+int
+hal_gpio_group_init_out(const int8_t *pins, int npins, uint32_t val)
+{
+    int i;
+    int rc;
+
+    if (npins < 0 || npins > 32) {
+        return -1;
+    }
+    for (i = 0; i < npins; i++) {
+        rc = hal_gpio_init_out(pins[i], (val >> i) & 1);
+        if (rc) {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+int
+hal_gpio_group_init_in(const int8_t *pins, int npins, hal_gpio_pull_t pull)
+{
+    int i;
+    int rc;
+
+    if (npins < 0 || npins > 32) {
+        return -1;
+    }
+    for (i = 0; i < npins; i++) {
+        rc = hal_gpio_init_in(pins[i], pull);
+        if (rc) {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+void
+hal_gpio_group_write(const int8_t *pins, int npins, uint32_t val)
+{
+    os_sr_t sr;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < npins; i++) {
+        hal_gpio_write(pins[i], (val >> i) & 1);
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+uint32_t
+hal_gpio_group_read(const int8_t *pins, int npins)
+{
+    uint32_t val;
+    os_sr_t sr;
+    int i;
+
+    val = 0;
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < npins; i++) {
+        if (hal_gpio_read(pins[i])) {
+            val |= 1UL << i;
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+    return val;
+}
+
+void
+hal_gpio_group_toggle(const int8_t *pins, int npins, uint32_t mask)
+{
+    os_sr_t sr;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < npins; i++) {
+        if (mask & (1UL << i)) {
+            hal_gpio_toggle(pins[i]);
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+#if MYNEWT_VAL(HAL_GPIO_IRQ_STATS)
+
+#include "os/os_cputime.h"
+#include "stats/stats.h"
+
+STATS_SECT_START(hal_gpio_irq_stats)
+    STATS_SECT_ENTRY(irqs)
+    STATS_SECT_ENTRY(handler_ticks)
+    STATS_SECT_ENTRY(handler_max)
+STATS_SECT_END
+
+STATS_NAME_START(hal_gpio_irq_stats)
+    STATS_NAME(hal_gpio_irq_stats, irqs)
+    STATS_NAME(hal_gpio_irq_stats, handler_ticks)
+    STATS_NAME(hal_gpio_irq_stats, handler_max)
+STATS_NAME_END(hal_gpio_irq_stats)
+
+static STATS_SECT_DECL(hal_gpio_irq_stats) hal_gpio_irq_stats;
+static int hal_gpio_irq_stats_reg;
+
+struct hal_gpio_irq_slot {
+    int hgis_pin;       /* Pin + 1; 0 marks a free slot */
+    hal_gpio_irq_handler_t hgis_handler;
+    void *hgis_arg;
+};
+
+static struct hal_gpio_irq_slot
+    hal_gpio_irq_slots[MYNEWT_VAL(HAL_GPIO_IRQ_STATS_MAX_PINS)];
+
+/*
+ * Wraps the user's handler; runs at interrupt context.  Timestamps are
+ * os_cputime ticks so jitter resolves at microsecond granularity.
+ */
+static void
+hal_gpio_irq_timed_handler(void *arg)
+{
+    struct hal_gpio_irq_slot *slot = (struct hal_gpio_irq_slot *)arg;
+    uint32_t ticks;
+
+    ticks = os_cputime_get32();
+    slot->hgis_handler(slot->hgis_arg);
+    ticks = os_cputime_get32() - ticks;
+
+    STATS_INC(hal_gpio_irq_stats, irqs);
+    STATS_INCN(hal_gpio_irq_stats, handler_ticks, ticks);
+    if (ticks > hal_gpio_irq_stats.shandler_max) {
+        hal_gpio_irq_stats.shandler_max = ticks;
+    }
+}
+
+int
+hal_gpio_irq_init_timed(int pin, hal_gpio_irq_handler_t handler, void *arg,
+  hal_gpio_irq_trig_t trig, hal_gpio_pull_t pull)
+{
+    struct hal_gpio_irq_slot *slot;
+    int rc;
+    int i;
+
+    if (!hal_gpio_irq_stats_reg) {
+        rc = stats_init_and_reg(STATS_HDR(hal_gpio_irq_stats),
+          STATS_SIZE_INIT_PARMS(hal_gpio_irq_stats, STATS_SIZE_32),
+          STATS_NAME_INIT_PARMS(hal_gpio_irq_stats), "hal_gpio_irq");
+        if (rc != 0) {
+            return rc;
+        }
+        hal_gpio_irq_stats_reg = 1;
+    }
+
+    slot = NULL;
+    for (i = 0; i < MYNEWT_VAL(HAL_GPIO_IRQ_STATS_MAX_PINS); i++) {
+        if (hal_gpio_irq_slots[i].hgis_pin == pin + 1) {
+            slot = &hal_gpio_irq_slots[i];
+            break;
+        }
+        if (!slot && hal_gpio_irq_slots[i].hgis_pin == 0) {
+            slot = &hal_gpio_irq_slots[i];
+        }
+    }
+    if (!slot) {
+        return -1;
+    }
+    slot->hgis_pin = pin + 1;
+    slot->hgis_handler = handler;
+    slot->hgis_arg = arg;
+
+    rc = hal_gpio_irq_init(pin, hal_gpio_irq_timed_handler, slot, trig, pull);
+    if (rc) {
+        slot->hgis_pin = 0;
+    }
+    return rc;
+}
+
+#endif /* MYNEWT_VAL(HAL_GPIO_IRQ_STATS) */
+
+#endif /* MYNEWT_VAL(HAL_GPIO_GROUP) */
@@ -0,0 +1,182 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HAL_I2C_ASYNC)
+
+#include <assert.h>
+
+#include "os/os.h"
+#include "hal/hal_i2c.h"
+#include "hal/hal_i2c_async.h"
+
+struct hal_i2c_async_op {
+    STAILQ_ENTRY(hal_i2c_async_op) hia_next;
+    uint8_t hia_i2c_num;
+    uint8_t hia_address;
+    const void *hia_wbuf;
+    uint16_t hia_wlen;
+    void *hia_rbuf;
+    uint16_t hia_rlen;
+    uint32_t hia_timeout;
+    hal_i2c_async_cb hia_cb;
+    void *hia_cb_arg;
+};
+
+static STAILQ_HEAD(, hal_i2c_async_op) hal_i2c_async_queue =
+    STAILQ_HEAD_INITIALIZER(hal_i2c_async_queue);
+
+static struct os_mempool hal_i2c_async_pool;
+static os_membuf_t hal_i2c_async_pool_buf[
+    OS_MEMPOOL_SIZE(MYNEWT_VAL(HAL_I2C_ASYNC_MAX_OPS),
+                    sizeof(struct hal_i2c_async_op))];
+
+/* Counts queued transactions; the worker task pends on it */
+static struct os_sem hal_i2c_async_work_sem;
+
+static struct os_task hal_i2c_async_task;
+static os_stack_t hal_i2c_async_stack[
+    OS_STACK_ALIGN(MYNEWT_VAL(HAL_I2C_ASYNC_STACK_SIZE))];
+
+/*
+ * Run one attempt of the write-then-read sequence; the write phase
+ * skips the STOP when a read follows, so the device sees a repeated
+ * start between the phases.
+ */
+static int
+hal_i2c_async_attempt(struct hal_i2c_async_op *op)
+{
+    struct hal_i2c_master_data pdata;
+    int rc;
+
+    pdata.address = op->hia_address;
+    if (op->hia_wlen) {
+        pdata.len = op->hia_wlen;
+        pdata.buffer = (uint8_t *)op->hia_wbuf;
+        rc = hal_i2c_master_write(op->hia_i2c_num, &pdata, op->hia_timeout,
+          op->hia_rlen == 0);
+        if (rc) {
+            return rc;
+        }
+    }
+    if (op->hia_rlen) {
+        pdata.len = op->hia_rlen;
+        pdata.buffer = op->hia_rbuf;
+        rc = hal_i2c_master_read(op->hia_i2c_num, &pdata, op->hia_timeout, 1);
+        if (rc) {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+static void
+hal_i2c_async_task_handler(void *arg)
+{
+    struct hal_i2c_async_op *op;
+    os_time_t delay;
+    os_sr_t sr;
+    int attempt;
+    int rc;
+
+    while (1) {
+        rc = os_sem_pend(&hal_i2c_async_work_sem, OS_WAIT_FOREVER);
+        assert(rc == OS_OK);
+
+        OS_ENTER_CRITICAL(sr);
+        op = STAILQ_FIRST(&hal_i2c_async_queue);
+        assert(op);
+        STAILQ_REMOVE_HEAD(&hal_i2c_async_queue, hia_next);
+        OS_EXIT_CRITICAL(sr);
+
+        delay = MYNEWT_VAL(HAL_I2C_ASYNC_RETRY_DELAY);
+        for (attempt = 0; ; attempt++) {
+            rc = hal_i2c_async_attempt(op);
+            if (rc == 0 || attempt >= MYNEWT_VAL(HAL_I2C_ASYNC_RETRIES)) {
+                break;
+            }
+            /*
+             * NACK or lost arbitration; back off before taking the
+             * bus again so a competing master can finish.
+             */
+            os_time_delay(delay);
+            delay <<= 1;
+        }
+
+        if (op->hia_cb) {
+            op->hia_cb(rc, op->hia_cb_arg);
+        }
+        os_memblock_put(&hal_i2c_async_pool, op);
+    }
+}
+
+int
+hal_i2c_async_txn(uint8_t i2c_num, uint8_t address, const void *wbuf,
+  uint16_t wlen, void *rbuf, uint16_t rlen, uint32_t timeout,
+  hal_i2c_async_cb cb, void *cb_arg)
+{
+    struct hal_i2c_async_op *op;
+    os_sr_t sr;
+
+    op = os_memblock_get(&hal_i2c_async_pool);
+    if (!op) {
+        return -1;
+    }
+    op->hia_i2c_num = i2c_num;
+    op->hia_address = address;
+    op->hia_wbuf = wbuf;
+    op->hia_wlen = wlen;
+    op->hia_rbuf = rbuf;
+    op->hia_rlen = rlen;
+    op->hia_timeout = timeout;
+    op->hia_cb = cb;
+    op->hia_cb_arg = cb_arg;
+
+    OS_ENTER_CRITICAL(sr);
+    STAILQ_INSERT_TAIL(&hal_i2c_async_queue, op, hia_next);
+    OS_EXIT_CRITICAL(sr);
+
+    return os_sem_release(&hal_i2c_async_work_sem);
+}
+
+int
+hal_i2c_async_init(void)
+{
+    int rc;
+
+    rc = os_mempool_init(&hal_i2c_async_pool,
+      MYNEWT_VAL(HAL_I2C_ASYNC_MAX_OPS), sizeof(struct hal_i2c_async_op),
+      hal_i2c_async_pool_buf, "hal_i2c_async");
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = os_sem_init(&hal_i2c_async_work_sem, 0);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return os_task_init(&hal_i2c_async_task, "i2c_async",
+      hal_i2c_async_task_handler, NULL, MYNEWT_VAL(HAL_I2C_ASYNC_TASK_PRIO),
+      OS_WAIT_FOREVER, hal_i2c_async_stack,
+      MYNEWT_VAL(HAL_I2C_ASYNC_STACK_SIZE));
+}
+
+#endif /* MYNEWT_VAL(HAL_I2C_ASYNC) */
@@ -0,0 +1,163 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HAL_SPI_CHAIN)
+
+#include <assert.h>
+
+#include "os/os.h"
+#include "hal/hal_spi.h"
+#include "hal/hal_spi_chain.h"
+#include "hal/hal_gpio.h"
+
+struct hal_spi_chain {
+    int hsc_spi_num;
+    struct hal_spi_chain_desc *hsc_cur;
+    hal_spi_chain_cb hsc_cb;
+    void *hsc_cb_arg;
+};
+
+static struct hal_spi_chain
+    hal_spi_chains[MYNEWT_VAL(HAL_SPI_CHAIN_MAX_DEVS)];
+
+static struct hal_spi_chain *
+hal_spi_chain_find(int spi_num, int alloc)
+{
+    struct hal_spi_chain *hsc;
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(HAL_SPI_CHAIN_MAX_DEVS); i++) {
+        hsc = &hal_spi_chains[i];
+        if (hsc->hsc_spi_num == spi_num + 1) {
+            return hsc;
+        }
+        if (alloc && hsc->hsc_spi_num == 0) {
+            hsc->hsc_spi_num = spi_num + 1;
+            return hsc;
+        }
+    }
+    return NULL;
+}
+
+static void
+hal_spi_chain_finish(struct hal_spi_chain *hsc,
+  struct hal_spi_chain_desc *cur, int status)
+{
+    hal_spi_chain_cb cb;
+    void *cb_arg;
+
+    if (cur->hscd_cs_pin >= 0) {
+        hal_gpio_write(cur->hscd_cs_pin, 1);
+    }
+    cb = hsc->hsc_cb;
+    cb_arg = hsc->hsc_cb_arg;
+    hsc->hsc_cur = NULL;
+    if (cb) {
+        cb(cb_arg, status);
+    }
+}
+
+/*
+ * Segment completion; runs at interrupt context and feeds the next
+ * descriptor straight to the controller.
+ */
+static void
+hal_spi_chain_seg_done(void *arg, int len)
+{
+    struct hal_spi_chain *hsc = (struct hal_spi_chain *)arg;
+    struct hal_spi_chain_desc *cur;
+    struct hal_spi_chain_desc *next;
+    int rc;
+
+    cur = hsc->hsc_cur;
+    assert(cur);
+    next = cur->hscd_next;
+    if (!next) {
+        hal_spi_chain_finish(hsc, cur, 0);
+        return;
+    }
+    if (cur->hscd_cs_pin != next->hscd_cs_pin) {
+        if (cur->hscd_cs_pin >= 0) {
+            hal_gpio_write(cur->hscd_cs_pin, 1);
+        }
+        if (next->hscd_cs_pin >= 0) {
+            hal_gpio_write(next->hscd_cs_pin, 0);
+        }
+    }
+    hsc->hsc_cur = next;
+    rc = hal_spi_txrx_noblock(hsc->hsc_spi_num - 1, next->hscd_txbuf,
+      next->hscd_rxbuf, next->hscd_len);
+    if (rc) {
+        hal_spi_chain_finish(hsc, next, rc);
+    }
+}
+
+int
+hal_spi_chain_init(int spi_num)
+{
+    struct hal_spi_chain *hsc;
+
+    hsc = hal_spi_chain_find(spi_num, 1);
+    if (!hsc) {
+        return -1;
+    }
+    return hal_spi_set_txrx_cb(spi_num, hal_spi_chain_seg_done, hsc);
+}
+
+int
+hal_spi_chain_submit(int spi_num, struct hal_spi_chain_desc *chain,
+  hal_spi_chain_cb cb, void *arg)
+{
+    struct hal_spi_chain *hsc;
+    os_sr_t sr;
+    int rc;
+
+    hsc = hal_spi_chain_find(spi_num, 0);
+    if (!hsc || !chain) {
+        return -1;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    if (hsc->hsc_cur) {
+        OS_EXIT_CRITICAL(sr);
+        return -1;
+    }
+    hsc->hsc_cur = chain;
+    hsc->hsc_cb = cb;
+    hsc->hsc_cb_arg = arg;
+    OS_EXIT_CRITICAL(sr);
+
+    if (chain->hscd_cs_pin >= 0) {
+        hal_gpio_write(chain->hscd_cs_pin, 0);
+    }
+    rc = hal_spi_txrx_noblock(spi_num, chain->hscd_txbuf, chain->hscd_rxbuf,
+      chain->hscd_len);
+    if (rc) {
+        if (chain->hscd_cs_pin >= 0) {
+            hal_gpio_write(chain->hscd_cs_pin, 1);
+        }
+        hsc->hsc_cur = NULL;
+        return rc;
+    }
+    return 0;
+}
+
+#endif /* MYNEWT_VAL(HAL_SPI_CHAIN) */
@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HAL_TIMER_MUX)
+
+#include <assert.h>
+
+#include "os/os.h"
+#include "hal/hal_timer.h"
+#include "hal/hal_timer_mux.h"
+
+/* The one hardware compare channel every multiplexed timer shares */
+static struct hal_timer hal_timer_mux_hw;
+static int hal_timer_mux_timer_num = -1;
+
+static TAILQ_HEAD(, hal_timer_mux) hal_timer_mux_list =
+    TAILQ_HEAD_INITIALIZER(hal_timer_mux_list);
+
+/*
+ * Deadline comparison that survives counter wraparound; 'a' is earlier
+ * than 'b' as long as they are less than half the counter range apart.
+ */
+static int
+hal_timer_mux_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+/* Re-arm the hardware channel for the earliest pending deadline */
+static void
+hal_timer_mux_rearm(void)
+{
+    struct hal_timer_mux *tmr;
+
+    tmr = TAILQ_FIRST(&hal_timer_mux_list);
+    if (tmr) {
+        hal_timer_start_at(&hal_timer_mux_hw, tmr->htm_expiry);
+    }
+}
+
+/*
+ * Hardware compare fired; runs at interrupt context.  Dispatch every
+ * timer whose deadline has passed, then re-arm for the next one.
+ */
+static void
+hal_timer_mux_expire(void *arg)
+{
+    struct hal_timer_mux *tmr;
+    uint32_t now;
+
+    while (1) {
+        tmr = TAILQ_FIRST(&hal_timer_mux_list);
+        if (!tmr) {
+            return;
+        }
+        now = hal_timer_read(hal_timer_mux_timer_num);
+        if (hal_timer_mux_before(now, tmr->htm_expiry)) {
+            break;
+        }
+        TAILQ_REMOVE(&hal_timer_mux_list, tmr, htm_link);
+        tmr->htm_active = 0;
+        tmr->htm_cb(tmr->htm_cb_arg);
+    }
+    hal_timer_mux_rearm();
+}
+
+int
+hal_timer_mux_init(int timer_num)
+{
+    if (hal_timer_mux_timer_num >= 0) {
+        return -1;
+    }
+    hal_timer_mux_timer_num = timer_num;
+    return hal_timer_set_cb(timer_num, &hal_timer_mux_hw,
+      hal_timer_mux_expire, NULL);
+}
+
+int
+hal_timer_mux_set_cb(struct hal_timer_mux *tmr, hal_timer_cb cb_func,
+  void *arg)
+{
+    if (tmr->htm_active) {
+        return -1;
+    }
+    tmr->htm_cb = cb_func;
+    tmr->htm_cb_arg = arg;
+    tmr->htm_active = 0;
+    return 0;
+}
+
+int
+hal_timer_mux_start(struct hal_timer_mux *tmr, uint32_t ticks)
+{
+    uint32_t tick;
+
+    if (ticks == 0) {
+        return -1;
+    }
+    tick = hal_timer_read(hal_timer_mux_timer_num) + ticks;
+    return hal_timer_mux_start_at(tmr, tick);
+}
+
+int
+hal_timer_mux_start_at(struct hal_timer_mux *tmr, uint32_t tick)
+{
+    struct hal_timer_mux *cur;
+    os_sr_t sr;
+
+    if (hal_timer_mux_timer_num < 0 || !tmr->htm_cb || tmr->htm_active) {
+        return -1;
+    }
+    tmr->htm_expiry = tick;
+    tmr->htm_active = 1;
+
+    OS_ENTER_CRITICAL(sr);
+    TAILQ_FOREACH(cur, &hal_timer_mux_list, htm_link) {
+        if (hal_timer_mux_before(tick, cur->htm_expiry)) {
+            TAILQ_INSERT_BEFORE(cur, tmr, htm_link);
+            break;
+        }
+    }
+    if (!cur) {
+        TAILQ_INSERT_TAIL(&hal_timer_mux_list, tmr, htm_link);
+    }
+    /*
+     * A new earliest deadline moves the hardware compare; later ones
+     * leave the already-armed channel alone.
+     */
+    if (tmr == TAILQ_FIRST(&hal_timer_mux_list)) {
+        hal_timer_mux_rearm();
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return 0;
+}
+
+int
+hal_timer_mux_stop(struct hal_timer_mux *tmr)
+{
+    int rearm;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (tmr->htm_active) {
+        rearm = (tmr == TAILQ_FIRST(&hal_timer_mux_list));
+        TAILQ_REMOVE(&hal_timer_mux_list, tmr, htm_link);
+        tmr->htm_active = 0;
+        if (rearm) {
+            hal_timer_stop(&hal_timer_mux_hw);
+            hal_timer_mux_rearm();
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return 0;
+}
+
+#endif /* MYNEWT_VAL(HAL_TIMER_MUX) */
@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HAL_TRNG)
+
+#include "os/os.h"
+#include "hal/hal_trng.h"
+#include "hal/hal_trng_int.h"
+
+/*
+ * Entropy ring cache between the TRNG interrupt and consumers.  The
+ * peripheral runs whenever the cache has room, so entropy is gathered
+ * ahead of demand and consumers normally do not wait.
+ */
+static uint8_t hal_trng_cache[MYNEWT_VAL(HAL_TRNG_CACHE_SIZE)];
+static volatile uint16_t hal_trng_cache_cnt;
+static uint16_t hal_trng_cache_in;
+static uint16_t hal_trng_cache_out;
+
+/*
+ * Called from the TRNG data-ready interrupt with one byte of
+ * conditioned entropy.
+ */
+static void
+hal_trng_sample(uint8_t byte)
+{
+    if (hal_trng_cache_cnt >= sizeof(hal_trng_cache)) {
+        /* Cache full; stop generating until a consumer makes room. */
+        hal_trng_dev_stop();
+        return;
+    }
+    hal_trng_cache[hal_trng_cache_in] = byte;
+    hal_trng_cache_in = (hal_trng_cache_in + 1) % sizeof(hal_trng_cache);
+    hal_trng_cache_cnt++;
+}
+
+int
+hal_trng_read(void *buf, int len)
+{
+    uint8_t *dst = buf;
+    os_sr_t sr;
+    int n;
+
+    n = 0;
+    OS_ENTER_CRITICAL(sr);
+    while (n < len && hal_trng_cache_cnt > 0) {
+        dst[n++] = hal_trng_cache[hal_trng_cache_out];
+        hal_trng_cache_out = (hal_trng_cache_out + 1) %
+                             sizeof(hal_trng_cache);
+        hal_trng_cache_cnt--;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    if (n > 0) {
+        /* Replace what was taken. */
+        hal_trng_dev_start();
+    }
+    return n;
+}
+
+int
+hal_trng_read_blocking(void *buf, int len)
+{
+    uint8_t *dst = buf;
+    int n;
+
+    n = 0;
+    while (n < len) {
+        /* The cache refills from the TRNG interrupt. */
+        n += hal_trng_read(dst + n, len - n);
+    }
+    return len;
+}
+
+int
+hal_trng_init(void)
+{
+    int rc;
+
+    rc = hal_trng_dev_init(hal_trng_sample);
+    if (rc == 0) {
+        rc = hal_trng_dev_start();
+    }
+    return rc;
+}
+
+#endif /* HAL_TRNG */
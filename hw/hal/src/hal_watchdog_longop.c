@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HAL_WATCHDOG_LONGOP)
+
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "hal/hal_watchdog.h"
+#include "hal/hal_watchdog_longop.h"
+
+#define HAL_WATCHDOG_LONGOP_TICKLE_USECS                        \
+    (MYNEWT_VAL(HAL_WATCHDOG_LONGOP_TICKLE_MSECS) * 1000)
+
+/*
+ * Tickle timer expiry; runs at interrupt context so it keeps firing
+ * while the operation's task blocks in a flash erase.  Falling silent
+ * (no re-arm) is the failure mode: the hardware watchdog then fires
+ * on its own schedule.
+ */
+static void
+hal_watchdog_longop_timer_exp(void *arg)
+{
+    struct hal_watchdog_longop *op = (struct hal_watchdog_longop *)arg;
+
+    if (!op->hwl_active) {
+        return;
+    }
+    if (op->hwl_progress == op->hwl_seen || op->hwl_remaining == 0) {
+        /* Stalled, or past the declared duration; let the dog bite */
+        return;
+    }
+    op->hwl_seen = op->hwl_progress;
+    op->hwl_remaining--;
+
+    hal_watchdog_tickle();
+    os_cputime_timer_relative(&op->hwl_timer,
+      HAL_WATCHDOG_LONGOP_TICKLE_USECS);
+}
+
+int
+hal_watchdog_longop_begin(struct hal_watchdog_longop *op,
+  uint32_t expected_msecs)
+{
+    uint32_t tickle_msecs;
+
+    if (op->hwl_active) {
+        return -1;
+    }
+
+    tickle_msecs = MYNEWT_VAL(HAL_WATCHDOG_LONGOP_TICKLE_MSECS);
+    /* One extra interval of slack so the last stretch is covered */
+    op->hwl_remaining = (expected_msecs + tickle_msecs - 1) / tickle_msecs + 1;
+    /*
+     * Seed progress ahead of seen so the first interval, before the
+     * operation has had a chance to report anything, is not taken for
+     * a stall.
+     */
+    op->hwl_progress = 1;
+    op->hwl_seen = 0;
+    op->hwl_active = 1;
+
+    os_cputime_timer_init(&op->hwl_timer, hal_watchdog_longop_timer_exp, op);
+    os_cputime_timer_relative(&op->hwl_timer,
+      HAL_WATCHDOG_LONGOP_TICKLE_USECS);
+
+    return 0;
+}
+
+int
+hal_watchdog_longop_end(struct hal_watchdog_longop *op)
+{
+    if (!op->hwl_active) {
+        return -1;
+    }
+    op->hwl_active = 0;
+    os_cputime_timer_stop(&op->hwl_timer);
+    hal_watchdog_tickle();
+
+    return 0;
+}
+
+#endif /* MYNEWT_VAL(HAL_WATCHDOG_LONGOP) */
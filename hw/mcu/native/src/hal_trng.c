@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HAL_TRNG)
+
+#include <stdlib.h>
+#include "hal/hal_trng_int.h"
+
+/*
+ * Simulated TRNG.  There is no peripheral and no interrupt; starting
+ * the "generator" synchronously feeds libc rand() bytes to the sample
+ * callback until the generic layer's cache fills and stops it.  Not
+ * real entropy; for simulation only.
+ */
+
+static void (*native_trng_cb)(uint8_t byte);
+static int native_trng_started;
+
+int
+hal_trng_dev_init(void (*sample_cb)(uint8_t byte))
+{
+    native_trng_cb = sample_cb;
+    return 0;
+}
+
+int
+hal_trng_dev_start(void)
+{
+    if (native_trng_cb == NULL) {
+        return -1;
+    }
+    native_trng_started = 1;
+    while (native_trng_started) {
+        /* The callback stops us once its cache is full. */
+        native_trng_cb(rand());
+    }
+    return 0;
+}
+
+int
+hal_trng_dev_stop(void)
+{
+    native_trng_started = 0;
+    return 0;
+}
+
+#endif /* HAL_TRNG */
@@ -51,7 +51,8 @@ static flash_config_t mk64f12_config;
 struct hal_flash mk64f12_flash_dev = {
     /* Most items are set after FLASH_Init() */
     .hf_itf = &mk64f12_flash_funcs,
-    .hf_align = 4
+    .hf_align = 4,
+    .hf_mapped = 1
 };
 
 static int
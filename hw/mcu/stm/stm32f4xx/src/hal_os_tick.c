@@ -21,22 +21,53 @@
 #include <os/os.h>
 #include <hal/hal_os_tick.h>
 
+static uint32_t reload_val;
+
 /*
- * XXX implement tickless mode.
+ * Tickless idle.  For multi-tick sleeps the SysTick period is stretched to
+ * cover the whole interval; on wakeup (which happens with interrupts still
+ * masked, so the tick handler has not run) the slept ticks are accounted
+ * in bulk via os_time_advance() and the periodic reload is restored.  The
+ * 24-bit SysTick counter bounds how far one sleep can reach.
  */
 void
 os_tick_idle(os_time_t ticks)
 {
+    uint32_t max_idle;
+    uint32_t elapsed;
+
     OS_ASSERT_CRITICAL();
+
+    if (ticks > 1) {
+        max_idle = 0x00ffffffU / (reload_val + 1);
+        if (ticks > max_idle) {
+            ticks = max_idle;
+        }
+        SysTick->LOAD = ticks * (reload_val + 1) - 1;
+        SysTick->VAL = 0;
+    }
+
     __DSB();
     __WFI();
+
+    if (ticks > 1) {
+        /* Reading CTRL clears COUNTFLAG */
+        if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) {
+            /* Full interval slept; the handler must not add another tick */
+            elapsed = ticks;
+            SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+        } else {
+            elapsed = ticks - 1 - (SysTick->VAL / (reload_val + 1));
+        }
+        SysTick->LOAD = reload_val;
+        SysTick->VAL = 0;
+        os_time_advance(elapsed);
+    }
 }
 
 void
 os_tick_init(uint32_t os_ticks_per_sec, int prio)
 {
-    uint32_t reload_val;
-
     reload_val = ((uint64_t)SystemCoreClock / os_ticks_per_sec) - 1;
 
     /* Set the system time ticker up */
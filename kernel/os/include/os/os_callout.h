@@ -27,6 +27,7 @@ extern "C" {
 
 #define OS_CALLOUT_F_QUEUED (0x01)
 
+#include "syscfg/syscfg.h"
 #include "os/os_eventq.h"
 
 struct os_callout {
@@ -34,6 +35,11 @@ struct os_callout {
     struct os_eventq *c_evq;
     uint32_t c_ticks;
     TAILQ_ENTRY(os_callout) c_next;
+#if MYNEWT_VAL(OS_CALLOUT_TIMING_WHEEL)
+    /* Wheel level and slot this callout currently hangs off of */
+    uint8_t c_level;
+    uint8_t c_slot;
+#endif
 };
 
 void os_callout_init(struct os_callout *cf, struct os_eventq *evq,
@@ -53,6 +53,17 @@ struct os_dev;
 #define OS_DEV_F_STATUS_SUSPENDED (1 << 2)
 #define OS_DEV_F_INIT_CRITICAL    (1 << 3)
 
+/**
+ * Device power states (OS_DEV_POWER).  ACTIVE devices are immediately
+ * usable; IDLE devices are quiesced by their driver but retain state;
+ * SLEEP devices have been suspended via od_suspend.  Any device not
+ * ACTIVE contributes its declared resume latency to the cost the idle
+ * task charges against entering a long tickless sleep.
+ */
+#define OS_DEV_PWR_ACTIVE   (0)
+#define OS_DEV_PWR_IDLE     (1)
+#define OS_DEV_PWR_SLEEP    (2)
+
 typedef int (*os_dev_init_func_t)(struct os_dev *, void *);
 typedef int (*os_dev_open_func_t)(struct os_dev *, uint32_t,
         void *);
@@ -78,6 +89,12 @@ struct os_dev {
     uint8_t od_priority;
     uint8_t od_open_ref;
     uint8_t od_flags;
+#if MYNEWT_VAL(OS_DEV_POWER)
+    /* Current power state (OS_DEV_PWR_*) */
+    uint8_t od_power_state;
+    /* Declared worst-case resume time from IDLE/SLEEP, in os ticks */
+    os_time_t od_resume_latency;
+#endif
     char *od_name;
     STAILQ_ENTRY(os_dev) od_next;
 };
@@ -115,6 +132,28 @@ struct os_dev *os_dev_open(char *devname, uint32_t timo, void *arg);
 int os_dev_close(struct os_dev *dev);
 void os_dev_reset(void);
 
+#if MYNEWT_VAL(OS_DEV_POWER)
+/*
+ * Declare how long the device takes to become usable again after
+ * leaving the ACTIVE state.
+ */
+void os_dev_power_latency_set(struct os_dev *dev, os_time_t resume_ticks);
+/*
+ * Move a device between power states.  Entering SLEEP calls
+ * od_suspend, returning to ACTIVE calls od_resume; IDLE is
+ * bookkeeping for drivers that quiesce themselves but still need
+ * their declared latency charged before the next use.
+ */
+int os_dev_power_state_set(struct os_dev *dev, uint8_t state);
+/*
+ * Aggregate resume cost, in os ticks, of every device not currently
+ * ACTIVE.  The idle task subtracts this from a prospective tickless
+ * sleep so the system is awake, with devices resumed, by the next
+ * deadline.
+ */
+os_time_t os_dev_power_resume_ticks(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
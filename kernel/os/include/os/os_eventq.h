@@ -21,6 +21,7 @@
 #define _OS_EVENTQ_H
 
 #include <inttypes.h>
+#include "syscfg/syscfg.h"
 #include "os/os_time.h"
 #include "os/queue.h"
 
@@ -43,15 +44,38 @@ struct os_event {
 struct os_eventq {
     struct os_task *evq_task;
     STAILQ_HEAD(, os_event) evq_list;
+#if MYNEWT_VAL(OS_EVENTQ_COALESCE)
+    uint8_t evq_coalesce:1;         /* defer wakeups until flush or bound */
+    uint8_t evq_dedup:1;            /* drop events matching a queued cb/arg */
+    uint8_t evq_wakeup_pending:1;
+    os_time_t evq_defer_start;      /* when the pending wakeup was deferred */
+    SLIST_ENTRY(os_eventq) evq_coalesce_next;
+#endif
 };
 
 void os_eventq_init(struct os_eventq *);
 int os_eventq_inited(const struct os_eventq *evq);
 void os_eventq_put(struct os_eventq *, struct os_event *);
 struct os_event *os_eventq_get(struct os_eventq *);
+struct os_event *os_eventq_get_no_wait(struct os_eventq *evq);
 void os_eventq_run(struct os_eventq *evq);
 struct os_event *os_eventq_poll(struct os_eventq **, int, os_time_t);
 void os_eventq_remove(struct os_eventq *, struct os_event *);
+#if MYNEWT_VAL(OS_EVENTQ_COALESCE)
+/*
+ * Wakeup coalescing: with it enabled, os_eventq_put() queues events
+ * without waking the consumer; the producer fires one wakeup for the
+ * whole burst with os_eventq_flush_wakeups(), and the OS tick wakes a
+ * forgotten queue after OS_EVENTQ_COALESCE_TICKS.  Dedup additionally
+ * drops a put whose (ev_cb, ev_arg) pair matches an event already
+ * queued, even when the event structures differ.
+ */
+void os_eventq_coalesce_set(struct os_eventq *evq, int enable);
+void os_eventq_dedup_set(struct os_eventq *evq, int enable);
+void os_eventq_flush_wakeups(struct os_eventq *evq);
+/* Called from the OS tick to enforce the deferral bound */
+void os_eventq_coalesce_tick(void);
+#endif
 void os_eventq_dflt_set(struct os_eventq *evq);
 struct os_eventq *os_eventq_dflt_get(void);
 void os_eventq_designate(struct os_eventq **dst, struct os_eventq *val,
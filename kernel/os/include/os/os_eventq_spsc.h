@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _OS_EVENTQ_SPSC_H
+#define _OS_EVENTQ_SPSC_H
+
+#include <inttypes.h>
+#include "os/os_eventq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Single-producer, single-consumer event queue.
+ *
+ * Unlike os_eventq, posting to this queue never disables interrupts, so a
+ * single ISR (or any single context) can hand events to a single consumer
+ * task without adding interrupt latency.  The queue is a power-of-two ring
+ * of os_event pointers; head is only written by the consumer and tail only
+ * by the producer.  The strict one-producer/one-consumer contract is the
+ * caller's responsibility.
+ */
+struct os_eventq_spsc {
+    struct os_event **evq_ring;
+    uint16_t evq_mask;
+    volatile uint16_t evq_head;     /* consumer index */
+    volatile uint16_t evq_tail;     /* producer index */
+    struct os_task *evq_task;       /* consumer task, set while sleeping */
+};
+
+int os_eventq_spsc_init(struct os_eventq_spsc *evq, struct os_event **ring,
+                        uint16_t nelems);
+int os_eventq_spsc_put(struct os_eventq_spsc *evq, struct os_event *ev);
+struct os_event *os_eventq_spsc_poll(struct os_eventq_spsc *evq);
+struct os_event *os_eventq_spsc_get(struct os_eventq_spsc *evq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OS_EVENTQ_SPSC_H */
@@ -21,6 +21,7 @@
 #define H_OS_HEAP_
 
 #include <stddef.h>
+#include "syscfg/syscfg.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,13 @@ void *os_malloc(size_t size);
 void os_free(void *mem);
 void *os_realloc(void *ptr, size_t size);
 
+#if MYNEWT_VAL(OS_HEAP_TLSF)
+int os_heap_tlsf_init(void *base, size_t len);
+void *os_tlsf_malloc(size_t size);
+void os_tlsf_free(void *mem);
+void *os_tlsf_realloc(void *ptr, size_t size);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
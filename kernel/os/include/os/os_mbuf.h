@@ -20,13 +20,21 @@
 #ifndef _OS_MBUF_H 
 #define _OS_MBUF_H 
 
+#include "syscfg/syscfg.h"
 #include "os/queue.h"
 #include "os/os_eventq.h"
+#include "os/os_mempool.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * When os_mempool.h is included first, its inclusion of os/os.h lands
+ * here before its own forward declaration has been seen.
+ */
+struct os_mempool_listener;
+
 /**
  * A mbuf pool from which to allocate mbufs. This contains a pointer to the os 
  * mempool to allocate mbufs out of, the total number of elements in the pool, 
@@ -96,10 +104,17 @@ struct os_mbuf {
     uint16_t om_len;
 
     /**
-     * The mbuf pool this mbuf was allocated out of 
+     * The mbuf pool this mbuf was allocated out of
      */
     struct os_mbuf_pool *om_omp;
 
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+    /**
+     * Reservation group charged for this mbuf; NULL if none
+     */
+    struct os_msys_group *om_grp;
+#endif
+
     /**
      * Pointer to next entry in the chained memory buffer
      */
@@ -116,13 +131,55 @@ struct os_mqueue {
     struct os_event mq_ev;
 };
 
+#if MYNEWT_VAL(OS_MSYS_TASK_CACHE)
+struct os_task;
+
+/**
+ * A per-task cache of msys pool blocks.  While attached, mbuf allocation
+ * and free performed by the owning task against the cached pool are plain
+ * pointer swaps with no interrupt masking; the cache refills from (and
+ * overflows back to) the shared pool in bulk.  The cache may only be
+ * touched from the owning task and from ISRs that preempt it; concurrent
+ * use is serialized with a busy flag rather than a critical section.
+ */
+struct os_msys_cache {
+    /** The msys pool the cached blocks belong to */
+    struct os_mbuf_pool *mc_omp;
+    /** Task this cache is attached to */
+    struct os_task *mc_task;
+    /** LIFO of cached pool blocks, linked through their first word */
+    void *mc_free;
+    /** Set while the owner is manipulating mc_free; ISRs then bypass */
+    volatile uint8_t mc_busy;
+    /** Number of blocks currently cached */
+    uint8_t mc_num_free;
+};
+#endif
+
 /*
  * Given a flag number, provide the mask for it
  *
- * @param __n The number of the flag in the mask 
+ * @param __n The number of the flag in the mask
  */
 #define OS_MBUF_F_MASK(__n) (1 << (__n))
 
+/* The mbuf data points at an external, caller-owned buffer */
+#define OS_MBUF_F_EXT       OS_MBUF_F_MASK(0)
+
+/* Called when an external-buffer mbuf is freed */
+typedef void os_mbuf_ext_free_fn(uint8_t *ext_buf, void *arg);
+
+/*
+ * Metadata for an external-buffer mbuf; lives at the start of om_databuf
+ * since the data area itself is unused.
+ */
+struct os_mbuf_ext {
+    os_mbuf_ext_free_fn *oe_free_cb;
+    void *oe_arg;
+};
+
+#define OS_MBUF_EXTHDR(__om) ((struct os_mbuf_ext *)(__om)->om_databuf)
+
 /* 
  * Checks whether a given mbuf is a packet header mbuf 
  *
@@ -180,6 +237,10 @@ _os_mbuf_leadingspace(struct os_mbuf *om)
     uint16_t startoff;
     uint16_t leadingspace;
 
+    if (om->om_flags & OS_MBUF_F_EXT) {
+        return (0);
+    }
+
     startoff = 0;
     if (OS_MBUF_IS_PKTHDR(om)) {
         startoff = om->om_pkthdr_len;
@@ -209,6 +270,11 @@ _os_mbuf_trailingspace(struct os_mbuf *om)
 {
     struct os_mbuf_pool *omp;
 
+    /* External buffers are caller-owned; never write past their data */
+    if (om->om_flags & OS_MBUF_F_EXT) {
+        return (0);
+    }
+
     omp = om->om_omp;
 
     return (&om->om_databuf[0] + omp->omp_databuf_len) -
@@ -249,9 +315,66 @@ void os_msys_reset(void);
 /* Return a packet header mbuf from the system pool */
 struct os_mbuf *os_msys_get_pkthdr(uint16_t dsize, uint16_t user_hdr_len);
 
+/* Return an external-buffer mbuf from the system pool */
+struct os_mbuf *os_msys_get_ext(uint8_t *buf, uint16_t len,
+                                os_mbuf_ext_free_fn *free_cb, void *arg);
+
 int os_msys_count(void);
 int os_msys_num_free(void);
 
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+/*
+ * Reservation group for msys allocations.  A subsystem that allocates
+ * through os_msys_get_grp() / os_msys_get_pkthdr_grp() is guaranteed
+ * omg_min blocks even when the rest of the system has drained msys,
+ * and is refused blocks beyond omg_max, so one misbehaving consumer
+ * cannot starve the others.  The usage fields are maintained by msys
+ * and may be read directly for diagnostics.
+ */
+struct os_msys_group {
+    uint16_t omg_min;           /* blocks guaranteed to this group */
+    uint16_t omg_max;           /* cap on blocks held; 0 = uncapped */
+    uint16_t omg_used;          /* blocks currently held */
+    uint16_t omg_max_used;      /* high watermark of omg_used */
+    uint32_t omg_denied;        /* allocations refused by cap or guarantees */
+    STAILQ_ENTRY(os_msys_group) omg_next;
+};
+
+int os_msys_group_register(struct os_msys_group *omg, uint16_t min_blocks,
+                           uint16_t max_blocks);
+
+/* As os_msys_get() / os_msys_get_pkthdr(), charged to 'omg' */
+struct os_mbuf *os_msys_get_grp(struct os_msys_group *omg, uint16_t dsize,
+                                uint16_t leadingspace);
+struct os_mbuf *os_msys_get_pkthdr_grp(struct os_msys_group *omg,
+                                       uint16_t dsize, uint16_t user_hdr_len);
+#endif
+
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+/*
+ * Register a pressure watermark on every msys pool; one listener per
+ * pool is consumed from 'omls'.  Returns the number of listeners
+ * used, or -1 if 'nomls' does not cover all pools.
+ *
+ * The callback type is spelled out instead of using
+ * os_mempool_pressure_fn; when os_mempool.h is included first, its
+ * inclusion of os/os.h lands here before the typedef has been seen.
+ */
+int os_msys_listener_register(struct os_mempool_listener *omls, int nomls,
+                              uint8_t low_pct,
+                              void (*func)(struct os_mempool *mp, int event,
+                                           void *arg),
+                              void *arg);
+#endif
+
+#if MYNEWT_VAL(OS_MSYS_TASK_CACHE)
+/* Attach a per-task block cache, bound to the msys pool fitting dsize */
+int os_msys_cache_attach(struct os_msys_cache *mc, uint16_t dsize);
+
+/* Detach the current task's block cache, returning blocks to the pool */
+void os_msys_cache_detach(struct os_msys_cache *mc);
+#endif
+
 /* Initialize a mbuf pool */
 int os_mbuf_pool_init(struct os_mbuf_pool *, struct os_mempool *mp, 
         uint16_t, uint16_t);
@@ -275,9 +398,54 @@ int os_mbuf_copydata(const struct os_mbuf *m, int off, int len, void *dst);
 /* Append data onto a mbuf */
 int os_mbuf_append(struct os_mbuf *m, const void *, uint16_t);
 
+int os_mbuf_append_at(struct os_mbuf *om, struct os_mbuf **lastp,
+                      const void *data, uint16_t len);
+
 int os_mbuf_appendfrom(struct os_mbuf *dst, const struct os_mbuf *src,
                        uint16_t src_off, uint16_t len);
 
+/*
+ * Writer object caching the tail of a chain so repeated appends are O(1).
+ */
+struct os_mbuf_writer {
+    struct os_mbuf *mw_om;
+    struct os_mbuf *mw_last;
+};
+
+void os_mbuf_writer_init(struct os_mbuf_writer *mw, struct os_mbuf *om);
+int os_mbuf_writer_append(struct os_mbuf_writer *mw, const void *data,
+                          uint16_t len);
+
+/* Largest chain os_mbuf_get_chain() will allocate in one call */
+#define OS_MBUF_CHAIN_GET_MAX   (32)
+
+struct os_mbuf *os_mbuf_get_chain(struct os_mbuf_pool *omp, uint16_t nblks);
+
+struct os_mbuf *os_mbuf_get_ext(struct os_mbuf_pool *omp, uint8_t *buf,
+                                uint16_t len, os_mbuf_ext_free_fn *free_cb,
+                                void *arg);
+
+/*
+ * Cursor over an mbuf chain.  Parsers that walk a chain through an
+ * iterator do one linear pass instead of restarting from the head on
+ * every read the way repeated os_mbuf_off()/os_mbuf_copydata() calls do.
+ */
+struct os_mbuf_iter {
+    const struct os_mbuf *mi_om;    /* current mbuf; NULL when exhausted */
+    uint16_t mi_off;                /* offset into current mbuf's data */
+};
+
+int os_mbuf_iter_init(struct os_mbuf_iter *mi, const struct os_mbuf *om,
+                      uint16_t off);
+uint16_t os_mbuf_iter_peek(struct os_mbuf_iter *mi, const uint8_t **data);
+uint16_t os_mbuf_iter_advance(struct os_mbuf_iter *mi, uint16_t len);
+
+/* Callback for os_mbuf_foreach_seg; return nonzero to stop the walk */
+typedef int os_mbuf_seg_fn(const uint8_t *data, uint16_t len, void *arg);
+
+int os_mbuf_foreach_seg(const struct os_mbuf *om, uint16_t off, uint16_t len,
+                        os_mbuf_seg_fn *fn, void *arg);
+
 /* Free a mbuf */
 int os_mbuf_free(struct os_mbuf *mb);
 
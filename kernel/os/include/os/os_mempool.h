@@ -22,6 +22,7 @@
 
 #include "os/os.h"
 #include "os/queue.h"
+#include "syscfg/syscfg.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,14 +43,23 @@ struct os_memblock {
 /* XXX: Change how I coded the SLIST_HEAD here. It should be named:
    SLIST_HEAD(,os_memblock) mp_head; */
 
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+struct os_mempool_listener;
+#endif
+
 /* Memory pool */
 struct os_mempool {
     int mp_block_size;          /* Size of the memory blocks, in bytes. */
     int mp_num_blocks;          /* The number of memory blocks. */
     int mp_num_free;            /* The number of free blocks left */
+    int mp_min_free;            /* The lowest number of free blocks seen */
+    uint32_t mp_true_block_size;/* Distance between blocks, in bytes */
     uint32_t mp_membuf_addr;    /* Address of memory buffer used by pool */
     STAILQ_ENTRY(os_mempool) mp_list;
     SLIST_HEAD(,os_memblock);   /* Pointer to list of free blocks */
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+    SLIST_HEAD(,os_mempool_listener) mp_listeners;
+#endif
     char *name;                 /* Name for memory block */
 };
 
@@ -59,6 +69,7 @@ struct os_mempool_info {
     int omi_block_size;
     int omi_num_blocks;
     int omi_num_free;
+    int omi_min_free;
     char omi_name[OS_MEMPOOL_INFO_NAME_LEN];
 };
 
@@ -82,19 +93,106 @@ typedef uint64_t os_membuf_t;
 #define OS_MEMPOOL_BYTES(n,blksize)     \
     (sizeof (os_membuf_t) * OS_MEMPOOL_SIZE((n), (blksize)))
 
+/**
+ * Number of bytes required for a pool whose blocks are padded out to
+ * 'align' byte boundaries (e.g. cache lines or DMA burst sizes).  The
+ * memory buffer itself must start on an 'align' boundary.
+ */
+#define OS_MEMPOOL_BYTES_EXT(n,blksize,align)   \
+    (OS_ALIGN((blksize), (align)) * (n))
+
 /* Initialize a memory pool */
 os_error_t os_mempool_init(struct os_mempool *mp, int blocks, int block_size,
                            void *membuf, char *name);
 
+/* Initialize a memory pool with explicit block alignment */
+os_error_t os_mempool_init_ext(struct os_mempool *mp, int blocks,
+                               int block_size, int align, void *membuf,
+                               char *name);
+
 /* Checks if a memory block was allocated from the specified mempool. */
 int os_memblock_from(struct os_mempool *mp, void *block_addr);
 
 /* Get a memory block from the pool */
 void *os_memblock_get(struct os_mempool *mp);
 
+/* Get several memory blocks from the pool in one critical section */
+int os_memblock_get_multi(struct os_mempool *mp, void **blocks, int nblocks);
+
 /* Put the memory block back into the pool */
 os_error_t os_memblock_put(struct os_mempool *mp, void *block_addr);
 
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+/*
+ * Pool-pressure notifications: a consumer registers a watermark on a
+ * pool and is called back when the free count falls to it, and again
+ * when it recovers, so producers can throttle before the pool runs
+ * dry instead of discovering exhaustion one failed allocation at a
+ * time.  Callbacks run in the context of the alloc/free that crossed
+ * the watermark -- possibly an ISR -- so they must only set flags or
+ * post events, never block.
+ */
+
+/** Free blocks fell to the registered watermark. */
+#define OS_MEMPOOL_PRESSURE_LOW         (0)
+/** Free blocks rose back above the watermark. */
+#define OS_MEMPOOL_PRESSURE_RELIEVED    (1)
+
+typedef void os_mempool_pressure_fn(struct os_mempool *mp, int event,
+                                    void *arg);
+
+struct os_mempool_listener {
+    os_mempool_pressure_fn *oml_func;
+    void *oml_arg;
+    uint8_t oml_low_pct;        /* watermark: percent of blocks still free */
+    uint8_t oml_in_pressure;    /* internal */
+    int oml_low_blocks;         /* internal: watermark in blocks */
+    SLIST_ENTRY(os_mempool_listener) oml_next;
+};
+
+/*
+ * Register a caller-allocated listener; oml_func, oml_arg and
+ * oml_low_pct must be filled in.  Fires immediately if the pool is
+ * already at or below the watermark.
+ */
+os_error_t os_mempool_listener_register(struct os_mempool *mp,
+                                        struct os_mempool_listener *oml);
+
+void os_mempool_listener_unregister(struct os_mempool *mp,
+                                    struct os_mempool_listener *oml);
+#endif
+
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+/*
+ * Allocation tracking: every outstanding block carries the pc of the
+ * call that allocated it in a fixed side table, so a slow pool leak
+ * shows up as a growing pile of blocks owned by one address (map it
+ * with addr2line).  Wrappers that allocate on behalf of a caller
+ * (e.g. os_mbuf_get()) re-record the block to attribute it to their
+ * own caller instead of themselves.
+ */
+struct os_mempool_trace_entry {
+    const struct os_mempool *omt_pool;
+    const void *omt_block;      /* NULL when the slot is free */
+    uintptr_t omt_pc;
+};
+
+/* Record, or re-attribute, an outstanding block. */
+void os_mempool_trace_record(const struct os_mempool *mp, const void *block,
+                             uintptr_t pc);
+
+/* Forget a block; called when it returns to its pool. */
+void os_mempool_trace_release(const void *block);
+
+/* Return nonzero to stop the walk. */
+typedef int (*os_mempool_trace_walk_func)(
+    const struct os_mempool_trace_entry *omt, void *arg);
+int os_mempool_trace_walk(os_mempool_trace_walk_func walk_func, void *arg);
+
+/* Allocations that found the side table full (untracked blocks) */
+uint32_t os_mempool_trace_overflows(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,7 +30,7 @@ extern "C" {
 struct os_mutex
 {
     SLIST_HEAD(, os_task) mu_head;  /* chain of waiting tasks */
-    uint8_t     _pad;
+    uint8_t     mu_ceiling;         /* priority ceiling; 0 = disabled */
     uint8_t     mu_prio;            /* owner's default priority*/
     uint16_t    mu_level;           /* call nesting level */
     struct os_task *mu_owner;       /* owners task */
@@ -54,6 +54,9 @@ os_mutex_inspect();
 /* Initialize a mutex */
 os_error_t os_mutex_init(struct os_mutex *mu);
 
+/* Initialize a mutex with a priority ceiling */
+os_error_t os_mutex_init_ceiling(struct os_mutex *mu, uint8_t prio);
+
 /* Release a mutex */
 os_error_t os_mutex_release(struct os_mutex *mu);
 
@@ -22,8 +22,12 @@
 
 #include <stdint.h>
 
+#include "syscfg/syscfg.h"
 #include "os/os_time.h"
 #include "os/queue.h"
+#if MYNEWT_VAL(OS_SANITY_EVENT_DRIVEN)
+#include "os/os_callout.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +42,14 @@ struct os_sanity_check {
     os_sanity_check_func_t sc_func;
     void *sc_arg;
 
+#if MYNEWT_VAL(OS_SANITY_EVENT_DRIVEN)
+    /* Callout that runs this check at its own cadence from the default
+     * event queue, instead of the idle-context full-list scan.
+     */
+    struct os_callout sc_callout;
+    uint8_t sc_armed;
+#endif
+
     SLIST_ENTRY(os_sanity_check) sc_next;
 
 };
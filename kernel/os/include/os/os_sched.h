@@ -26,6 +26,7 @@
 extern "C" {
 #endif
 
+void os_sched_init(void);
 void os_sched_ctx_sw_hook(struct os_task *);
 struct os_task *os_sched_get_current_task(void);
 void os_sched_set_current_task(struct os_task *);
@@ -20,6 +20,7 @@
 #ifndef _OS_SEM_H_
 #define _OS_SEM_H_
 
+#include "syscfg/syscfg.h"
 #include "os/queue.h"
 
 #ifdef __cplusplus
@@ -31,6 +32,12 @@ struct os_sem
     SLIST_HEAD(, os_task) sem_head;     /* chain of waiting tasks */
     uint16_t    _pad;
     uint16_t    sem_tokens;             /* # of tokens */
+#if MYNEWT_VAL(OS_SEM_STATS)
+    /* # of pends that had to block */
+    uint16_t    sem_blocked_cnt;
+    /* # of releases that forced a context switch */
+    uint16_t    sem_resched_cnt;
+#endif
 };
 
 /* 
@@ -50,6 +57,9 @@ os_error_t os_sem_init(struct os_sem *sem, uint16_t tokens);
 /* Release a semaphore */
 os_error_t os_sem_release(struct os_sem *sem);
 
+/* Release several tokens in one critical section */
+os_error_t os_sem_release_n(struct os_sem *sem, uint16_t tokens);
+
 /* Pend (wait) for a semaphore */
 os_error_t os_sem_pend(struct os_sem *sem, uint32_t timeout);
 
@@ -0,0 +1,70 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _OS_SIM_PROF_H
+#define _OS_SIM_PROF_H
+
+#include <inttypes.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Simulator-only performance instrumentation (kernel/os/src/arch/sim).
+ * Neither facility exists on real targets.
+ */
+
+#if MYNEWT_VAL(OS_SIM_VIRTUAL_CPUTIME)
+/*
+ * Virtual cputime: CPU time actually consumed by the simulator
+ * process, scaled by OS_SIM_CYCLES_PER_USEC so deltas approximate
+ * target cycles.  Unlike the wall-clock sim timer, this only advances
+ * when code executes, so a cputime delta measured around a code path
+ * tracks the work done, not host scheduling noise.
+ */
+uint32_t os_sim_cputime_get32(void);
+#endif
+
+#if MYNEWT_VAL(OS_SIM_PROF)
+/*
+ * Statistical profiler: SIGPROF samples the interrupted program
+ * counter at OS_SIM_PROF_HZ into a fixed hash table.  Stop the
+ * profiler before walking; map the raw addresses to functions on the
+ * host (e.g. addr2line -f against the sim executable).
+ */
+int os_sim_prof_start(void);
+void os_sim_prof_stop(void);
+void os_sim_prof_reset(void);
+
+/* Return nonzero to stop the walk. */
+typedef int (*os_sim_prof_walk_func)(uintptr_t pc, uint32_t count,
+    void *arg);
+int os_sim_prof_walk(os_sim_prof_walk_func walk_func, void *arg);
+
+/* Samples that found the table full, or had no extractable pc */
+uint32_t os_sim_prof_dropped(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OS_SIM_PROF_H */
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _OS_SIM_REPLAY_H
+#define _OS_SIM_REPLAY_H
+
+#include <inttypes.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+
+/*
+ * Deterministic record/replay for the sim kernel
+ * (kernel/os/src/arch/sim).  Recording logs every nondeterministic
+ * input at the point it enters the scheduler - virtual tick deliveries
+ * (how many ticks each SIGALRM advanced) and idle wakeups (which
+ * signals ended each sigsuspend()) - to a text file.  Replaying feeds
+ * the log back in place of the host's timers, so the recorded schedule
+ * (eventq wakeup order, callout bursts, context-switch interleaving)
+ * reproduces exactly and a pathological run captured in CI can be
+ * walked under a debugger.
+ *
+ * During replay the real tick timer is never armed, so ticks are
+ * delivered only at idle wait points; a tick the recording took while
+ * a task was running is applied at the next idle wait instead, which
+ * preserves tick counts and ready-queue order but not mid-task
+ * preemption points.
+ *
+ * Activate before os_start(), or from the environment:
+ * OS_SIM_RECORD=<path> records, OS_SIM_REPLAY=<path> replays.
+ */
+
+#define OS_SIM_REPLAY_OFF       0
+#define OS_SIM_REPLAY_RECORD    1
+#define OS_SIM_REPLAY_PLAY      2
+
+/* Process OS_SIM_RECORD / OS_SIM_REPLAY; called from os_arch_os_init() */
+void os_sim_replay_init(void);
+
+int os_sim_replay_record_start(const char *path);
+int os_sim_replay_play_start(const char *path);
+void os_sim_replay_stop(void);
+
+int os_sim_replay_mode(void);
+
+/*
+ * Hooks for os_arch_sim.c; not for application use.  _ticks logs (or,
+ * replaying, substitutes) a tick delivery; _wake logs an idle wakeup;
+ * _next_wake pops the next wakeup during replay, returning -1 when the
+ * log is exhausted (the caller falls back to live timing).
+ */
+int os_sim_replay_ticks(int ticks);
+void os_sim_replay_wake(int alrm, int urg);
+int os_sim_replay_next_wake(int *alrm, int *urg);
+
+#endif /* MYNEWT_VAL(OS_SIM_REPLAY) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OS_SIM_REPLAY_H */
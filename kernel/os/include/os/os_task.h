@@ -20,8 +20,9 @@
 #ifndef _OS_TASK_H
 #define _OS_TASK_H
 
+#include "syscfg/syscfg.h"
 #include "os/os.h"
-#include "os/os_sanity.h" 
+#include "os/os_sanity.h"
 #include "os/queue.h"
 
 #ifdef __cplusplus
@@ -56,9 +57,17 @@ typedef enum os_task_state {
 #define OS_TASK_FLAG_MUTEX_WAIT     (0x04U)
 #define OS_TASK_FLAG_EVQ_WAIT       (0x08U)
 #define OS_TASK_FLAG_LOCK_HELD      (0x10U)
+/* Task is in the EDF scheduling class (OS_SCHED_EDF) */
+#define OS_TASK_FLAG_EDF            (0x20U)
+/* An activation deadline is armed (OS_SCHED_EDF) */
+#define OS_TASK_FLAG_DEADLINE       (0x40U)
 
 typedef void (*os_task_func_t)(void *);
 
+#if MYNEWT_VAL(OS_MSYS_TASK_CACHE)
+struct os_msys_cache;
+#endif
+
 #define OS_TASK_MAX_NAME_LEN (32)
 
 struct os_task {
@@ -86,6 +95,37 @@ struct os_task {
     os_time_t t_run_time;
     uint32_t t_ctx_sw_cnt;
 
+#if MYNEWT_VAL(OS_MSYS_TASK_CACHE)
+    /* Per-task msys block cache, if one is attached */
+    struct os_msys_cache *t_msys_cache;
+#endif
+
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    /* Pairing heap linkage for timed sleepers, keyed on t_next_wakeup.
+     * t_ph_prev is the parent for a first child, the left sibling
+     * otherwise.
+     */
+    struct os_task *t_ph_child;
+    struct os_task *t_ph_sibling;
+    struct os_task *t_ph_prev;
+#endif
+
+#if MYNEWT_VAL(OS_SCHED_EDF)
+    /* Absolute deadline (os time ticks) of the current activation */
+    os_time_t t_deadline;
+    /* Activations whose deadline had passed at clear/re-arm time */
+    uint32_t t_deadline_misses;
+#endif
+
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+    /* Accumulated run time in cputime units */
+    uint32_t t_cputime;
+    /* cputime timestamp of the last transition to ready */
+    uint32_t t_ready_cputime;
+    /* Worst observed ready-to-running latency, in cputime units */
+    uint32_t t_sched_latency_max;
+#endif
+
     /* Global list of all tasks, irrespective of run or sleep lists */
     STAILQ_ENTRY(os_task) t_os_task_list;
 
@@ -101,6 +141,28 @@ int os_task_init(struct os_task *, const char *, os_task_func_t, void *,
 
 int os_task_suspend(struct os_task *t);
 
+uint16_t os_task_stack_usage(const struct os_task *t);
+
+#if MYNEWT_VAL(OS_TASK_STACK_GUARD)
+void os_task_stack_guard_check(void);
+#endif
+
+#if MYNEWT_VAL(OS_SCHED_EDF)
+/*
+ * EDF scheduling class.  A task placed in the class with an armed
+ * deadline runs ahead of every fixed-priority task, and class members
+ * run earliest-deadline-first among themselves.  The task arms an
+ * absolute deadline at the start of each activation with
+ * os_task_deadline_set() and retires it with os_task_deadline_clear()
+ * when the activation's work is done; a deadline found to be in the
+ * past at clear or re-arm time bumps t_deadline_misses.  A class
+ * member with no armed deadline schedules by its fixed priority.
+ */
+int os_task_edf_set(struct os_task *t, int enable);
+void os_task_deadline_set(struct os_task *t, os_time_t deadline);
+void os_task_deadline_clear(struct os_task *t);
+#endif
+
 uint8_t os_task_count(void);
 
 struct os_task_info {
@@ -114,6 +176,10 @@ struct os_task_info {
     uint32_t oti_runtime;
     os_time_t oti_last_checkin;
     os_time_t oti_next_checkin;
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+    uint32_t oti_cputime;
+    uint32_t oti_max_sched_latency;
+#endif
 
     char oti_name[OS_TASK_MAX_NAME_LEN];
 };
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _OS_TRACE_H
+#define _OS_TRACE_H
+
+#include <inttypes.h>
+
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Lightweight execution tracing.  Instrumentation points write 8-byte
+ * (event word, cputime) records into a fixed ring buffer; the macros
+ * compile to nothing unless OS_TRACE is enabled, so instrumented code
+ * costs nothing in production images.
+ *
+ * The event word packs the event id into bits 16..30, sets bit 31 for
+ * EXIT records, and carries 16 bits of caller argument (task priority,
+ * channel number, ...) in the low half.
+ */
+
+/* Event ids of the pre-placed kernel and radio instrumentation */
+#define OS_TRACE_ID_CTX_SW          1   /* arg: incoming task priority */
+#define OS_TRACE_ID_ISR             2   /* arg: interrupt number */
+#define OS_TRACE_ID_BLE_PHY_ISR     3
+#define OS_TRACE_ID_BLE_PHY_TX      4
+#define OS_TRACE_ID_BLE_PHY_RX      5
+#define OS_TRACE_ID_DATAWATCH       6   /* arg: (slot << 8) | task prio */
+/* First id available to applications */
+#define OS_TRACE_ID_USER            32
+
+#define OS_TRACE_EXIT_FLAG          0x80000000UL
+
+/** One trace record; cputime ticks give microsecond-scale ordering. */
+struct os_trace_record {
+    uint32_t otr_ev;
+    uint32_t otr_cputime;
+};
+
+#if MYNEWT_VAL(OS_TRACE)
+
+void os_trace_add(uint32_t ev);
+
+/**
+ * Walk the trace ring from oldest to newest record.  Records written
+ * while the walk runs are not seen.  The walk stops early if the
+ * callback returns nonzero.
+ */
+typedef int (*os_trace_walk_func_t)(const struct os_trace_record *rec,
+                                    void *arg);
+int os_trace_walk(os_trace_walk_func_t walk_func, void *arg);
+
+#define OS_TRACE_ENTER(id, arg)                                         \
+    os_trace_add(((uint32_t)(id) << 16) | ((arg) & 0xffff))
+#define OS_TRACE_EXIT(id, arg)                                          \
+    os_trace_add(OS_TRACE_EXIT_FLAG | ((uint32_t)(id) << 16) |          \
+                 ((arg) & 0xffff))
+/* A point event; records entry only */
+#define OS_TRACE_EVENT(id, arg)     OS_TRACE_ENTER(id, arg)
+
+#else
+
+#define OS_TRACE_ENTER(id, arg)
+#define OS_TRACE_EXIT(id, arg)
+#define OS_TRACE_EVENT(id, arg)
+
+#endif /* MYNEWT_VAL(OS_TRACE) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OS_TRACE_H */
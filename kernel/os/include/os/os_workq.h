@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _OS_WORKQ_H
+#define _OS_WORKQ_H
+
+#include <inttypes.h>
+#include "os/os_eventq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Shared work queue: one worker task draining OS_WORKQ_LANES
+ * priority-tiered event lanes, so packages whose only task is an
+ * eventq loop can register handlers here instead of owning a task
+ * and a stack.  Lane 0 is the highest priority; within a drain pass
+ * each lane dispatches at most OS_WORKQ_LANE_BUDGET events before
+ * higher lanes are rechecked, so a busy low lane cannot starve the
+ * queue but a chatty lane cannot monopolize it either.
+ *
+ * Work is normally submitted with os_workq_put(), which also tracks
+ * lane occupancy to measure queue latency.  A lane's eventq may
+ * instead be targeted directly (os_workq_lane_evq()) by callouts,
+ * mqueues or os_eventq_put() callers; such events still wake the
+ * worker and dispatch in lane order, they just bypass the
+ * queue-latency counters.
+ */
+
+/** Accumulated per-lane counters; os cputime units. */
+struct os_workq_lane_stats {
+    uint32_t owl_events;        /* events dispatched */
+    uint32_t owl_run_ticks;     /* total handler run time */
+    uint32_t owl_run_max;       /* longest single handler */
+    uint32_t owl_wait_ticks;    /* total time lane head spent queued */
+    uint32_t owl_wait_max;      /* longest wait of a lane head */
+    uint32_t owl_deferrals;     /* passes cut short by the lane budget */
+};
+
+/*
+ * Create the worker task at the given priority.  Call once, after
+ * os_init(); events may be submitted before the OS starts.
+ */
+int os_workq_init(uint8_t task_prio);
+
+/* Queue an event on the given lane (0 = highest priority). */
+void os_workq_put(int lane, struct os_event *ev);
+
+/* Counters for one lane; valid until the next dispatch. */
+const struct os_workq_lane_stats *os_workq_lane_stats_get(int lane);
+
+/*
+ * The eventq behind a lane, for callouts/mqueues that must name a
+ * queue directly.  Only the worker task may consume from it.
+ */
+struct os_eventq *os_workq_lane_evq(int lane);
+
+/* The worker task, e.g. for run-on-worker assertions. */
+struct os_task *os_workq_task_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OS_WORKQ_H */
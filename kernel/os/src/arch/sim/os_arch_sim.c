@@ -34,6 +34,10 @@
 #include <sys/time.h>
 #include <assert.h>
 
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+#include "os/os_sim_replay.h"
+#endif
+
 struct stack_frame {
     int sf_mainsp;              /* stack on which main() is executing */
     sigjmp_buf sf_jb;
@@ -229,6 +233,28 @@ os_tick_idle(os_time_t ticks)
 
     OS_ASSERT_CRITICAL();
 
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+    if (os_sim_replay_mode() == OS_SIM_REPLAY_PLAY) {
+        int alrm, urg;
+
+        /*
+         * Wake when and how the recording woke, instead of waiting on
+         * the host timer; the handlers below then rebuild the recorded
+         * schedule.
+         */
+        if (os_sim_replay_next_wake(&alrm, &urg) == 0) {
+            if (alrm) {
+                timer_handler(SIGALRM);
+            }
+            if (urg) {
+                ctxsw_handler(SIGURG);
+            }
+            return;
+        }
+        /* log exhausted; resume live timing */
+    }
+#endif
+
     if (ticks > 0) {
         /*
          * Enter tickless regime and set the timer to fire after 'ticks'
@@ -247,6 +273,11 @@ os_tick_idle(os_time_t ticks)
     sigsuspend(&nosigs);        /* Wait for a signal to wake us up */
     suspended = false;
 
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+    os_sim_replay_wake(sigismember(&suspsigs, SIGALRM),
+                       sigismember(&suspsigs, SIGURG));
+#endif
+
     /*
      * Call handlers for signals delivered to the process during sigsuspend().
      * The SIGALRM handler is called before any other handlers to ensure that
@@ -340,6 +371,20 @@ timer_handler(int sig)
         return;
     }
 
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+    if (os_sim_replay_mode() == OS_SIM_REPLAY_PLAY) {
+        /*
+         * Advance by what the recording advanced, independent of the
+         * host clock.
+         */
+        ticks = os_sim_replay_ticks(0);
+        if (ticks > 0) {
+            os_time_advance(ticks);
+        }
+        return;
+    }
+#endif
+
     if (!time_inited) {
         gettimeofday(&time_last, NULL);
         time_inited = 1;
@@ -351,6 +396,7 @@ timer_handler(int sig)
          * System time going backwards.
          */
         time_last = time_now;
+        ticks = 0;
     } else {
         timersub(&time_now, &time_last, &time_diff);
 
@@ -364,7 +410,17 @@ timer_handler(int sig)
         time_diff.tv_sec = 0;
         time_diff.tv_usec %= OS_USEC_PER_TICK;
         timersub(&time_now, &time_diff, &time_last);
+    }
 
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+    /*
+     * The wall-clock tick count is this handler's nondeterministic
+     * input; log it even when zero so record and replay consume the
+     * same number of events.
+     */
+    (void)os_sim_replay_ticks(ticks);
+#endif
+    if (ticks > 0) {
         os_time_advance(ticks);
     }
 }
@@ -375,6 +431,16 @@ start_timer(void)
     struct itimerval it;
     int rc;
 
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+    /*
+     * Replay delivers ticks from the log at idle wait points; never
+     * arm the host timer, so no tick arrives anywhere else.
+     */
+    if (os_sim_replay_mode() == OS_SIM_REPLAY_PLAY) {
+        return;
+    }
+#endif
+
     memset(&it, 0, sizeof(it));
     it.it_value.tv_sec = 0;
     it.it_value.tv_usec = OS_USEC_PER_TICK;
@@ -415,6 +481,10 @@ os_arch_os_init(void)
      */
     signals_init();
 
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+    os_sim_replay_init();
+#endif
+
     os_init_idle_task();
 
     return OS_OK;
@@ -457,5 +527,8 @@ os_arch_os_stop(void)
 {
     stop_timer();
     signals_cleanup();
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+    os_sim_replay_stop();
+#endif
     g_os_started = 0;
 }
@@ -0,0 +1,206 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(OS_SIM_VIRTUAL_CPUTIME) || MYNEWT_VAL(OS_SIM_PROF)
+
+#include <string.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <ucontext.h>
+
+#include "os/os.h"
+#include "os/os_sim_prof.h"
+
+#if MYNEWT_VAL(OS_SIM_VIRTUAL_CPUTIME)
+/**
+ * Return virtual cputime: CPU time consumed by this process, scaled
+ * by the OS_SIM_CYCLES_PER_USEC calibration factor.  Advances only
+ * while code runs, so deltas around a code path are insensitive to
+ * host load and sleeps.
+ */
+uint32_t
+os_sim_cputime_get32(void)
+{
+    struct rusage ru;
+    uint64_t usecs;
+    int rc;
+
+    rc = getrusage(RUSAGE_SELF, &ru);
+    if (rc != 0) {
+        return 0;
+    }
+    usecs = (uint64_t)ru.ru_utime.tv_sec * 1000000 + ru.ru_utime.tv_usec +
+            (uint64_t)ru.ru_stime.tv_sec * 1000000 + ru.ru_stime.tv_usec;
+
+    return (uint32_t)(usecs * MYNEWT_VAL(OS_SIM_CYCLES_PER_USEC));
+}
+#endif /* MYNEWT_VAL(OS_SIM_VIRTUAL_CPUTIME) */
+
+#if MYNEWT_VAL(OS_SIM_PROF)
+
+struct os_sim_prof_slot {
+    uintptr_t osp_pc;
+    uint32_t osp_count;
+};
+
+/* Open-addressed; a slot with zero count is free */
+static struct os_sim_prof_slot
+    os_sim_prof_table[MYNEWT_VAL(OS_SIM_PROF_SLOTS)];
+static uint32_t os_sim_prof_drops;
+
+static uintptr_t
+os_sim_prof_pc(void *uc_arg)
+{
+#if defined(__linux__) && defined(__x86_64__)
+    ucontext_t *uc = uc_arg;
+
+    return (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__linux__) && defined(__i386__)
+    ucontext_t *uc = uc_arg;
+
+    return (uintptr_t)uc->uc_mcontext.gregs[REG_EIP];
+#else
+    (void)uc_arg;
+    return 0;
+#endif
+}
+
+static void
+os_sim_prof_handler(int sig, siginfo_t *si, void *uc)
+{
+    struct os_sim_prof_slot *slot;
+    uintptr_t pc;
+    uint32_t idx;
+    int i;
+
+    pc = os_sim_prof_pc(uc);
+    if (pc == 0) {
+        os_sim_prof_drops++;
+        return;
+    }
+
+    idx = (uint32_t)(pc >> 2);
+    for (i = 0; i < MYNEWT_VAL(OS_SIM_PROF_SLOTS); i++) {
+        slot = &os_sim_prof_table[(idx + i) &
+                                  (MYNEWT_VAL(OS_SIM_PROF_SLOTS) - 1)];
+        if (slot->osp_count == 0 || slot->osp_pc == pc) {
+            slot->osp_pc = pc;
+            slot->osp_count++;
+            return;
+        }
+    }
+    os_sim_prof_drops++;
+}
+
+/**
+ * Arm SIGPROF sampling at OS_SIM_PROF_HZ.  Samples accumulate across
+ * start/stop cycles until os_sim_prof_reset().
+ *
+ * @return 0 on success; -1 if the handler or timer could not be set.
+ */
+int
+os_sim_prof_start(void)
+{
+    struct sigaction sa;
+    struct itimerval it;
+    int rc;
+
+    memset(&sa, 0, sizeof sa);
+    sa.sa_sigaction = os_sim_prof_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    rc = sigaction(SIGPROF, &sa, NULL);
+    if (rc != 0) {
+        return -1;
+    }
+
+    it.it_value.tv_sec = 0;
+    it.it_value.tv_usec = 1000000 / MYNEWT_VAL(OS_SIM_PROF_HZ);
+    it.it_interval = it.it_value;
+    rc = setitimer(ITIMER_PROF, &it, NULL);
+    if (rc != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Disarm the sampling timer.  Call before walking the table.
+ */
+void
+os_sim_prof_stop(void)
+{
+    struct itimerval it;
+
+    memset(&it, 0, sizeof it);
+    (void)setitimer(ITIMER_PROF, &it, NULL);
+}
+
+void
+os_sim_prof_reset(void)
+{
+    memset(os_sim_prof_table, 0, sizeof(os_sim_prof_table));
+    os_sim_prof_drops = 0;
+}
+
+/**
+ * Iterate the accumulated (pc, count) samples.
+ *
+ * @param walk_func Called per occupied slot; nonzero return stops the walk
+ * @param arg       Passed through to walk_func
+ *
+ * @return 0 when the walk completed, the walk_func return otherwise.
+ */
+int
+os_sim_prof_walk(os_sim_prof_walk_func walk_func, void *arg)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(OS_SIM_PROF_SLOTS); i++) {
+        if (os_sim_prof_table[i].osp_count == 0) {
+            continue;
+        }
+        rc = walk_func(os_sim_prof_table[i].osp_pc,
+                       os_sim_prof_table[i].osp_count, arg);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t
+os_sim_prof_dropped(void)
+{
+    return os_sim_prof_drops;
+}
+
+#endif /* MYNEWT_VAL(OS_SIM_PROF) */
+
+#endif /* MYNEWT_VAL(OS_SIM_VIRTUAL_CPUTIME) || MYNEWT_VAL(OS_SIM_PROF) */
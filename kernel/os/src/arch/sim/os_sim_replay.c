@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(OS_SIM_REPLAY)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os/os.h"
+#include "os/os_sim_replay.h"
+
+/*
+ * Log format, one event per line, in delivery order:
+ *   T <ticks>    tick delivery advancing <ticks> (timer_handler)
+ *   W <a> <u>    idle wakeup; <a>/<u> nonzero if SIGALRM/SIGURG ended it
+ * A wakeup that delivers a tick is a 'W 1 ...' line followed by its
+ * 'T' line; a 'T' with no preceding 'W' was taken while a task ran.
+ */
+
+static FILE *os_sim_replay_fp;
+static int os_sim_replay_cur_mode;
+
+/* one-event pushback for next_wake's lookahead */
+static char os_sim_replay_pushback[32];
+static int os_sim_replay_pushed;
+
+void
+os_sim_replay_init(void)
+{
+    const char *path;
+
+    path = getenv("OS_SIM_RECORD");
+    if (path != NULL) {
+        (void)os_sim_replay_record_start(path);
+        return;
+    }
+    path = getenv("OS_SIM_REPLAY");
+    if (path != NULL) {
+        (void)os_sim_replay_play_start(path);
+    }
+}
+
+int
+os_sim_replay_record_start(const char *path)
+{
+    if (os_sim_replay_cur_mode != OS_SIM_REPLAY_OFF) {
+        return -1;
+    }
+    os_sim_replay_fp = fopen(path, "w");
+    if (os_sim_replay_fp == NULL) {
+        return -1;
+    }
+    /*
+     * Line buffered: a run that dies on the bug it is capturing still
+     * leaves every event up to the crash in the log.
+     */
+    setvbuf(os_sim_replay_fp, NULL, _IOLBF, 0);
+    os_sim_replay_cur_mode = OS_SIM_REPLAY_RECORD;
+    return 0;
+}
+
+int
+os_sim_replay_play_start(const char *path)
+{
+    if (os_sim_replay_cur_mode != OS_SIM_REPLAY_OFF) {
+        return -1;
+    }
+    os_sim_replay_fp = fopen(path, "r");
+    if (os_sim_replay_fp == NULL) {
+        return -1;
+    }
+    os_sim_replay_pushed = 0;
+    os_sim_replay_cur_mode = OS_SIM_REPLAY_PLAY;
+    return 0;
+}
+
+void
+os_sim_replay_stop(void)
+{
+    if (os_sim_replay_fp != NULL) {
+        fclose(os_sim_replay_fp);
+        os_sim_replay_fp = NULL;
+    }
+    os_sim_replay_cur_mode = OS_SIM_REPLAY_OFF;
+}
+
+int
+os_sim_replay_mode(void)
+{
+    return os_sim_replay_cur_mode;
+}
+
+static int
+os_sim_replay_read(char *line, int size)
+{
+    if (os_sim_replay_pushed) {
+        strcpy(line, os_sim_replay_pushback);
+        os_sim_replay_pushed = 0;
+        return 0;
+    }
+    if (fgets(line, size, os_sim_replay_fp) == NULL) {
+        return -1;
+    }
+    return 0;
+}
+
+int
+os_sim_replay_ticks(int ticks)
+{
+    char line[32];
+    int logged;
+
+    switch (os_sim_replay_cur_mode) {
+    case OS_SIM_REPLAY_RECORD:
+        fprintf(os_sim_replay_fp, "T %d\n", ticks);
+        return ticks;
+    case OS_SIM_REPLAY_PLAY:
+        if (os_sim_replay_read(line, sizeof(line)) != 0 ||
+            sscanf(line, "T %d", &logged) != 1) {
+            /* log exhausted or out of sync; resume live timing */
+            os_sim_replay_stop();
+            return ticks;
+        }
+        return logged;
+    default:
+        return ticks;
+    }
+}
+
+void
+os_sim_replay_wake(int alrm, int urg)
+{
+    if (os_sim_replay_cur_mode == OS_SIM_REPLAY_RECORD) {
+        fprintf(os_sim_replay_fp, "W %d %d\n", alrm != 0, urg != 0);
+    }
+}
+
+int
+os_sim_replay_next_wake(int *alrm, int *urg)
+{
+    char line[32];
+
+    if (os_sim_replay_cur_mode != OS_SIM_REPLAY_PLAY) {
+        return -1;
+    }
+    if (os_sim_replay_read(line, sizeof(line)) != 0) {
+        os_sim_replay_stop();
+        return -1;
+    }
+    if (sscanf(line, "W %d %d", alrm, urg) == 2) {
+        return 0;
+    }
+    if (line[0] == 'T') {
+        /*
+         * Tick recorded outside an idle wait (it preempted a running
+         * task); deliver it here, the nearest replayable point.  Push
+         * the line back for the timer handler's _ticks call.
+         */
+        strcpy(os_sim_replay_pushback, line);
+        os_sim_replay_pushed = 1;
+        *alrm = 1;
+        *urg = 0;
+        return 0;
+    }
+    os_sim_replay_stop();
+    return -1;
+}
+
+#endif /* MYNEWT_VAL(OS_SIM_REPLAY) */
@@ -49,9 +49,11 @@ int g_os_started;
 #ifdef ARCH_sim
 #define MIN_IDLE_TICKS  1
 #else
-#define MIN_IDLE_TICKS  (100 * OS_TICKS_PER_SEC / 1000) /* 100 msec */
+#define MIN_IDLE_TICKS  \
+    (MYNEWT_VAL(OS_IDLE_TICKLESS_MS_MIN) * OS_TICKS_PER_SEC / 1000)
 #endif
-#define MAX_IDLE_TICKS  (600 * OS_TICKS_PER_SEC)        /* 10 minutes */
+#define MAX_IDLE_TICKS  \
+    (MYNEWT_VAL(OS_IDLE_TICKLESS_MS_MAX) * OS_TICKS_PER_SEC / 1000)
 
 
 /**
@@ -97,6 +99,23 @@ os_idle_task(void *arg)
          */
         iticks = min(iticks, ((sanity_last + sanity_itvl_ticks) - now));
 
+#if MYNEWT_VAL(OS_DEV_POWER)
+        /*
+         * Budget for resuming powered-down devices: only sleep long
+         * enough that everything is back up by the next deadline.
+         */
+        {
+            os_time_t rticks;
+
+            rticks = os_dev_power_resume_ticks();
+            if (iticks <= rticks) {
+                iticks = 0;
+            } else {
+                iticks -= rticks;
+            }
+        }
+#endif
+
         if (iticks < MIN_IDLE_TICKS) {
             iticks = 0;
         } else if (iticks > MAX_IDLE_TICKS) {
@@ -153,6 +172,7 @@ os_init(void)
 {
     os_error_t err;
 
+    os_sched_init();
     TAILQ_INIT(&g_callout_list);
     STAILQ_INIT(&g_os_task_list);
 
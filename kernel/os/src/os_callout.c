@@ -31,6 +31,124 @@
  */
 struct os_callout_list g_callout_list;
 
+#if MYNEWT_VAL(OS_CALLOUT_TIMING_WHEEL)
+/*
+ * Hierarchical timing wheel.  Level 0 resolves single ticks; each higher
+ * level covers 32 times the span of the one below it.  Arming and
+ * disarming a callout are O(1); expiry is amortized O(1) since a callout
+ * cascades down at most OS_CALLOUT_WHEEL_LEVELS - 1 times over its
+ * lifetime.
+ */
+#define OS_CALLOUT_WHEEL_LEVELS     (4)
+#define OS_CALLOUT_WHEEL_BITS       (5)
+#define OS_CALLOUT_WHEEL_SLOTS      (1 << OS_CALLOUT_WHEEL_BITS)
+#define OS_CALLOUT_WHEEL_MASK       (OS_CALLOUT_WHEEL_SLOTS - 1)
+
+static struct os_callout_list
+    g_callout_wheel[OS_CALLOUT_WHEEL_LEVELS][OS_CALLOUT_WHEEL_SLOTS];
+static os_time_t g_callout_wheel_time;
+static int g_callout_wheel_cnt;
+static uint8_t g_callout_wheel_inited;
+
+/*
+ * TAILQ heads cannot be statically zero-initialized as an array; set the
+ * wheel up the first time a callout API touches it.
+ */
+static void
+os_callout_wheel_assure(void)
+{
+    int level;
+    int slot;
+
+    if (g_callout_wheel_inited) {
+        return;
+    }
+    for (level = 0; level < OS_CALLOUT_WHEEL_LEVELS; level++) {
+        for (slot = 0; slot < OS_CALLOUT_WHEEL_SLOTS; slot++) {
+            TAILQ_INIT(&g_callout_wheel[level][slot]);
+        }
+    }
+    g_callout_wheel_time = os_time_get();
+    g_callout_wheel_inited = 1;
+}
+
+static void
+os_callout_wheel_insert(struct os_callout *c)
+{
+    os_time_t delta;
+    int level;
+
+    delta = c->c_ticks - g_callout_wheel_time;
+    for (level = 0; level < OS_CALLOUT_WHEEL_LEVELS - 1; level++) {
+        if (delta < ((os_time_t)1 << (OS_CALLOUT_WHEEL_BITS * (level + 1)))) {
+            break;
+        }
+    }
+    c->c_level = level;
+    c->c_slot = (c->c_ticks >> (OS_CALLOUT_WHEEL_BITS * level)) &
+                OS_CALLOUT_WHEEL_MASK;
+    TAILQ_INSERT_TAIL(&g_callout_wheel[c->c_level][c->c_slot], c, c_next);
+    g_callout_wheel_cnt++;
+}
+
+static void
+os_callout_wheel_remove(struct os_callout *c)
+{
+    TAILQ_REMOVE(&g_callout_wheel[c->c_level][c->c_slot], c, c_next);
+    c->c_next.tqe_prev = NULL;
+    g_callout_wheel_cnt--;
+}
+
+/*
+ * Advance the wheel towards 'now' and return a single expired callout,
+ * dequeued, or NULL once the wheel has caught up.  Must be called with
+ * interrupts disabled.
+ */
+static struct os_callout *
+os_callout_wheel_next_expired(os_time_t now)
+{
+    struct os_callout_list cascade;
+    struct os_callout *c;
+    int level;
+    int slot;
+
+    while (1) {
+        slot = g_callout_wheel_time & OS_CALLOUT_WHEEL_MASK;
+        c = TAILQ_FIRST(&g_callout_wheel[0][slot]);
+        if (c != NULL && OS_TIME_TICK_GEQ(g_callout_wheel_time, c->c_ticks)) {
+            os_callout_wheel_remove(c);
+            return (c);
+        }
+
+        if (!OS_TIME_TICK_LT(g_callout_wheel_time, now)) {
+            return (NULL);
+        }
+        g_callout_wheel_time++;
+
+        /* Each time a level wraps, cascade the next slot of the level
+         * above it down the wheel.
+         */
+        for (level = 1; level < OS_CALLOUT_WHEEL_LEVELS; level++) {
+            if ((g_callout_wheel_time &
+                 (((os_time_t)1 << (OS_CALLOUT_WHEEL_BITS * level)) - 1))) {
+                break;
+            }
+            slot = (g_callout_wheel_time >> (OS_CALLOUT_WHEEL_BITS * level)) &
+                   OS_CALLOUT_WHEEL_MASK;
+            TAILQ_INIT(&cascade);
+            while ((c = TAILQ_FIRST(&g_callout_wheel[level][slot])) != NULL) {
+                os_callout_wheel_remove(c);
+                TAILQ_INSERT_TAIL(&cascade, c, c_next);
+            }
+            while ((c = TAILQ_FIRST(&cascade)) != NULL) {
+                TAILQ_REMOVE(&cascade, c, c_next);
+                os_callout_wheel_insert(c);
+            }
+        }
+    }
+}
+#endif /* MYNEWT_VAL(OS_CALLOUT_TIMING_WHEEL) */
+
 /**
  * Initialize a callout.
  *
@@ -70,8 +188,12 @@ os_callout_stop(struct os_callout *c)
     OS_ENTER_CRITICAL(sr);
 
     if (os_callout_queued(c)) {
+#if MYNEWT_VAL(OS_CALLOUT_TIMING_WHEEL)
+        os_callout_wheel_remove(c);
+#else
         TAILQ_REMOVE(&g_callout_list, c, c_next);
         c->c_next.tqe_prev = NULL;
+#endif
     }
 
     if (c->c_evq) {
@@ -111,6 +233,11 @@ os_callout_reset(struct os_callout *c, int32_t ticks)
 
     c->c_ticks = os_time_get() + ticks;
 
+#if MYNEWT_VAL(OS_CALLOUT_TIMING_WHEEL)
+    (void)entry;
+    os_callout_wheel_assure();
+    os_callout_wheel_insert(c);
+#else
     entry = NULL;
     TAILQ_FOREACH(entry, &g_callout_list, c_next) {
         if (OS_TIME_TICK_LT(c->c_ticks, entry->c_ticks)) {
@@ -123,6 +250,7 @@ os_callout_reset(struct os_callout *c, int32_t ticks)
     } else {
         TAILQ_INSERT_TAIL(&g_callout_list, c, c_next);
     }
+#endif
 
     OS_EXIT_CRITICAL(sr);
 
@@ -148,6 +276,10 @@ os_callout_tick(void)
 
     while (1) {
         OS_ENTER_CRITICAL(sr);
+#if MYNEWT_VAL(OS_CALLOUT_TIMING_WHEEL)
+        os_callout_wheel_assure();
+        c = os_callout_wheel_next_expired(now);
+#else
         c = TAILQ_FIRST(&g_callout_list);
         if (c) {
             if (OS_TIME_TICK_GEQ(now, c->c_ticks)) {
@@ -157,6 +289,7 @@ os_callout_tick(void)
                 c = NULL;
             }
         }
+#endif
         OS_EXIT_CRITICAL(sr);
 
         if (c) {
@@ -183,6 +316,37 @@ os_callout_wakeup_ticks(os_time_t now)
 
     OS_ASSERT_CRITICAL();
 
+#if MYNEWT_VAL(OS_CALLOUT_TIMING_WHEEL)
+    {
+        os_time_t t;
+        int i;
+
+        (void)rt;
+        os_callout_wheel_assure();
+        if (g_callout_wheel_cnt == 0) {
+            return (OS_TIMEOUT_NEVER);
+        }
+        /* Level 0 holds everything due within the next wheel revolution;
+         * if nothing is there, wake at the next cascade boundary so
+         * higher level entries get moved down in time.
+         */
+        for (i = 0; i < OS_CALLOUT_WHEEL_SLOTS; i++) {
+            t = g_callout_wheel_time + i;
+            c = TAILQ_FIRST(&g_callout_wheel[0][t & OS_CALLOUT_WHEEL_MASK]);
+            if (c != NULL) {
+                if (OS_TIME_TICK_GEQ(c->c_ticks, now)) {
+                    return (c->c_ticks - now);
+                }
+                return (0);
+            }
+        }
+        t = (g_callout_wheel_time | OS_CALLOUT_WHEEL_MASK) + 1;
+        if (OS_TIME_TICK_GEQ(t, now)) {
+            return (t - now);
+        }
+        return (0);
+    }
+#else
     c = TAILQ_FIRST(&g_callout_list);
     if (c != NULL) {
         if (OS_TIME_TICK_GEQ(c->c_ticks, now)) {
@@ -195,6 +359,7 @@ os_callout_wakeup_ticks(os_time_t now)
     }
 
     return (rt);
+#endif
 }
 
 /**
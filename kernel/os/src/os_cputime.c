@@ -22,6 +22,9 @@
 #include <assert.h>
 #include "os/os.h"
 #include "os/os_cputime.h"
+#if MYNEWT_VAL(OS_SIM_VIRTUAL_CPUTIME)
+#include "os/os_sim_prof.h"
+#endif
 
 /**
  * @addtogroup OSKernel Operating System Kernel
@@ -269,7 +272,12 @@ os_cputime_get32(void)
 {
     uint32_t cpu_time;
 
+#if MYNEWT_VAL(OS_SIM_VIRTUAL_CPUTIME)
+    /* Simulator: virtual cycles consumed, not wall-clock time */
+    cpu_time = os_sim_cputime_get32();
+#else
     cpu_time = hal_timer_read(MYNEWT_VAL(OS_CPUTIME_TIMER_NUM));
+#endif
     return cpu_time;
 }
 
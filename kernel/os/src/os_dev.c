@@ -209,6 +209,83 @@ err:
     return (rc);
 }
 
+#if MYNEWT_VAL(OS_DEV_POWER)
+/**
+ * Declare a device's worst-case resume latency.
+ *
+ * @param dev          The device to modify
+ * @param resume_ticks Ticks needed to return to ACTIVE from IDLE/SLEEP
+ */
+void
+os_dev_power_latency_set(struct os_dev *dev, os_time_t resume_ticks)
+{
+    dev->od_resume_latency = resume_ticks;
+}
+
+/**
+ * Move a device between power states.
+ *
+ * @param dev   The device to transition
+ * @param state OS_DEV_PWR_ACTIVE, OS_DEV_PWR_IDLE or OS_DEV_PWR_SLEEP
+ *
+ * @return 0 on success, non-zero error code from the driver handler.
+ */
+int
+os_dev_power_state_set(struct os_dev *dev, uint8_t state)
+{
+    int rc;
+
+    if (state == dev->od_power_state) {
+        return (0);
+    }
+
+    switch (state) {
+    case OS_DEV_PWR_ACTIVE:
+        rc = os_dev_resume(dev);
+        break;
+    case OS_DEV_PWR_SLEEP:
+        rc = os_dev_suspend(dev, 0, 0);
+        break;
+    case OS_DEV_PWR_IDLE:
+        /* Driver has quiesced itself; state change is bookkeeping */
+        rc = 0;
+        break;
+    default:
+        rc = OS_EINVAL;
+        break;
+    }
+
+    if (rc == 0) {
+        dev->od_power_state = state;
+    }
+
+    return (rc);
+}
+
+/**
+ * Sum the declared resume latencies of every device that is not
+ * currently ACTIVE.  Called from the idle task with interrupts
+ * disabled when weighing a tickless sleep.
+ *
+ * @return Aggregate resume cost, in os ticks.
+ */
+os_time_t
+os_dev_power_resume_ticks(void)
+{
+    struct os_dev *dev;
+    os_time_t ticks;
+
+    ticks = 0;
+    STAILQ_FOREACH(dev, &g_os_dev_list, od_next) {
+        if (dev->od_power_state != OS_DEV_PWR_ACTIVE) {
+            ticks += dev->od_resume_latency;
+        }
+    }
+
+    return (ticks);
+}
+#endif /* MYNEWT_VAL(OS_DEV_POWER) */
+
 /**
  * Lookup a device by name, internal function only.
  *
@@ -31,6 +31,40 @@
 
 static struct os_eventq *os_eventq_main;
 
+#if MYNEWT_VAL(OS_EVENTQ_COALESCE)
+/* Queues with coalescing enabled, for the tick-bound backstop */
+static SLIST_HEAD(, os_eventq) os_eventq_coalesce_list =
+    SLIST_HEAD_INITIALIZER(os_eventq_coalesce_list);
+#endif
+
+/*
+ * Wake the task pending on the queue, if there is one.  Must be called
+ * with interrupts disabled; returns 1 if the caller should reschedule.
+ */
+static int
+os_eventq_wakeup(struct os_eventq *evq)
+{
+    int resched;
+
+    resched = 0;
+    if (evq->evq_task) {
+        /* If task waiting on event, wake it up.
+         * Check if task is sleeping, because another event
+         * queue may have woken this task up beforehand.
+         */
+        if (evq->evq_task->t_state == OS_TASK_SLEEP) {
+            os_sched_wakeup(evq->evq_task);
+            resched = 1;
+        }
+        /* Either way, NULL out the task, because the task will
+         * be awake upon exit of this function.
+         */
+        evq->evq_task = NULL;
+    }
+
+    return (resched);
+}
+
 /**
  * Initialize the event queue
  *
@@ -69,25 +103,40 @@ os_eventq_put(struct os_eventq *evq, struct os_event *ev)
         return;
     }
 
+#if MYNEWT_VAL(OS_EVENTQ_COALESCE)
+    if (evq->evq_dedup) {
+        struct os_event *cur;
+
+        /* Drop the put if an equivalent event is already queued */
+        STAILQ_FOREACH(cur, &evq->evq_list, ev_next) {
+            if (cur->ev_cb == ev->ev_cb && cur->ev_arg == ev->ev_arg) {
+                OS_EXIT_CRITICAL(sr);
+                return;
+            }
+        }
+    }
+#endif
+
     /* Queue the event */
     ev->ev_queued = 1;
     STAILQ_INSERT_TAIL(&evq->evq_list, ev, ev_next);
 
-    resched = 0;
-    if (evq->evq_task) {
-        /* If task waiting on event, wake it up.
-         * Check if task is sleeping, because another event
-         * queue may have woken this task up beforehand.
+#if MYNEWT_VAL(OS_EVENTQ_COALESCE)
+    if (evq->evq_coalesce && evq->evq_task) {
+        /*
+         * Hold the wakeup for the rest of the burst; the producer's
+         * flush, or the tick backstop, delivers it.
          */
-        if (evq->evq_task->t_state == OS_TASK_SLEEP) {
-            os_sched_wakeup(evq->evq_task);
-            resched = 1;
+        if (!evq->evq_wakeup_pending) {
+            evq->evq_wakeup_pending = 1;
+            evq->evq_defer_start = os_time_get();
         }
-        /* Either way, NULL out the task, because the task will
-         * be awake upon exit of this function.
-         */
-        evq->evq_task = NULL;
+        OS_EXIT_CRITICAL(sr);
+        return;
     }
+#endif
+
+    resched = os_eventq_wakeup(evq);
 
     OS_EXIT_CRITICAL(sr);
 
@@ -119,6 +168,10 @@ pull_one:
         STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
         ev->ev_queued = 0;
         t->t_flags &= ~OS_TASK_FLAG_EVQ_WAIT;
+#if MYNEWT_VAL(OS_EVENTQ_COALESCE)
+        /* Consumer is draining; any deferred wakeup is moot */
+        evq->evq_wakeup_pending = 0;
+#endif
     } else {
         evq->evq_task = t;
         os_sched_sleep(evq->evq_task, OS_TIMEOUT_NEVER);
@@ -136,6 +189,30 @@ pull_one:
     return (ev);
 }
 
+/**
+ * Pull a single item from an event queue without blocking.
+ *
+ * @param evq The event queue to pull an event from
+ *
+ * @return The event from the queue, or NULL if the queue is empty
+ */
+struct os_event *
+os_eventq_get_no_wait(struct os_eventq *evq)
+{
+    struct os_event *ev;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    ev = STAILQ_FIRST(&evq->evq_list);
+    if (ev) {
+        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
+        ev->ev_queued = 0;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return (ev);
+}
+
 void
 os_eventq_run(struct os_eventq *evq)
 {
@@ -248,6 +325,106 @@ has_event:
     return (ev);
 }
 
+#if MYNEWT_VAL(OS_EVENTQ_COALESCE)
+/**
+ * Enable or disable wakeup coalescing on a queue.  While enabled,
+ * os_eventq_put() defers the consumer wakeup; deliver it with
+ * os_eventq_flush_wakeups() after posting a burst.  The OS tick acts
+ * as a backstop, waking the queue OS_EVENTQ_COALESCE_TICKS after the
+ * first deferred event if no flush arrives.
+ *
+ * @param evq    The event queue to modify
+ * @param enable 1 to coalesce wakeups, 0 to restore wakeup-per-put
+ */
+void
+os_eventq_coalesce_set(struct os_eventq *evq, int enable)
+{
+    os_sr_t sr;
+    int resched;
+
+    resched = 0;
+    OS_ENTER_CRITICAL(sr);
+    if (enable && !evq->evq_coalesce) {
+        evq->evq_coalesce = 1;
+        SLIST_INSERT_HEAD(&os_eventq_coalesce_list, evq, evq_coalesce_next);
+    } else if (!enable && evq->evq_coalesce) {
+        evq->evq_coalesce = 0;
+        SLIST_REMOVE(&os_eventq_coalesce_list, evq, os_eventq,
+          evq_coalesce_next);
+        if (evq->evq_wakeup_pending) {
+            evq->evq_wakeup_pending = 0;
+            resched = os_eventq_wakeup(evq);
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    if (resched) {
+        os_sched(NULL);
+    }
+}
+
+/**
+ * Enable or disable event dedup on a queue.  While enabled, a put
+ * whose (ev_cb, ev_arg) pair matches an event already on the queue is
+ * dropped, even when the os_event structures differ.
+ *
+ * @param evq    The event queue to modify
+ * @param enable 1 to dedup puts, 0 to queue every distinct event
+ */
+void
+os_eventq_dedup_set(struct os_eventq *evq, int enable)
+{
+    evq->evq_dedup = (enable != 0);
+}
+
+/**
+ * Deliver the wakeup deferred by coalesced puts, if one is pending.
+ * Producers call this once per burst.
+ *
+ * @param evq The event queue to wake
+ */
+void
+os_eventq_flush_wakeups(struct os_eventq *evq)
+{
+    os_sr_t sr;
+    int resched;
+
+    resched = 0;
+    OS_ENTER_CRITICAL(sr);
+    if (evq->evq_wakeup_pending) {
+        evq->evq_wakeup_pending = 0;
+        resched = os_eventq_wakeup(evq);
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    if (resched) {
+        os_sched(NULL);
+    }
+}
+
+/**
+ * Called from the OS tick; wakes any coalescing queue whose deferred
+ * wakeup has aged past OS_EVENTQ_COALESCE_TICKS without a flush.
+ */
+void
+os_eventq_coalesce_tick(void)
+{
+    struct os_eventq *evq;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    SLIST_FOREACH(evq, &os_eventq_coalesce_list, evq_coalesce_next) {
+        if (evq->evq_wakeup_pending &&
+            OS_TIME_TICK_GEQ(os_time_get(),
+              evq->evq_defer_start + MYNEWT_VAL(OS_EVENTQ_COALESCE_TICKS))) {
+            evq->evq_wakeup_pending = 0;
+            (void)os_eventq_wakeup(evq);
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+#endif /* MYNEWT_VAL(OS_EVENTQ_COALESCE) */
+
 /**
  * Remove an event from the queue.
  *
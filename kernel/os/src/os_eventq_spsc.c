@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "os/os.h"
+#include "os/os_eventq_spsc.h"
+
+/**
+ * @addtogroup OSKernel
+ * @{
+ *   @defgroup OSEventSPSC Lock-free SPSC Event Queues
+ *   @{
+ */
+
+/*
+ * On the single-core MCUs mynewt targets, ordering between an ISR producer
+ * and a task consumer only requires that the compiler not reorder the ring
+ * store with the index publish.
+ */
+#define OS_EVENTQ_SPSC_BARRIER()    __asm__ volatile ("" ::: "memory")
+
+/**
+ * Initialize a single-producer, single-consumer event queue.
+ *
+ * @param evq    The queue to initialize
+ * @param ring   Caller-supplied array of os_event pointers used as storage
+ * @param nelems Number of elements in 'ring'; must be a power of two
+ *
+ * @return 0 on success, OS_EINVAL if nelems is not a power of two.
+ */
+int
+os_eventq_spsc_init(struct os_eventq_spsc *evq, struct os_event **ring,
+                    uint16_t nelems)
+{
+    if (nelems == 0 || (nelems & (nelems - 1)) != 0) {
+        return (OS_EINVAL);
+    }
+
+    memset(evq, 0, sizeof(*evq));
+    evq->evq_ring = ring;
+    evq->evq_mask = nelems - 1;
+
+    return (OS_OK);
+}
+
+/**
+ * Put an event on an SPSC queue.  Safe to call from an ISR; does not
+ * disable interrupts unless the consumer is asleep and must be woken.
+ *
+ * @param evq The queue to put an event on
+ * @param ev The event to enqueue
+ *
+ * @return 0 on success, OS_ENOMEM if the ring is full.
+ */
+int
+os_eventq_spsc_put(struct os_eventq_spsc *evq, struct os_event *ev)
+{
+    uint16_t tail;
+    os_sr_t sr;
+
+    /* Do not queue if already queued; only this producer ever sets it */
+    if (OS_EVENT_QUEUED(ev)) {
+        return (OS_OK);
+    }
+
+    tail = evq->evq_tail;
+    if ((uint16_t)(tail - evq->evq_head) > evq->evq_mask) {
+        return (OS_ENOMEM);
+    }
+
+    ev->ev_queued = 1;
+    evq->evq_ring[tail & evq->evq_mask] = ev;
+    OS_EVENTQ_SPSC_BARRIER();
+    evq->evq_tail = tail + 1;
+
+    /* Only mask interrupts on the empty -> non-empty transition with a
+     * sleeping consumer.
+     */
+    if (evq->evq_task) {
+        OS_ENTER_CRITICAL(sr);
+        if (evq->evq_task && evq->evq_task->t_state == OS_TASK_SLEEP) {
+            os_sched_wakeup(evq->evq_task);
+            evq->evq_task = NULL;
+            OS_EXIT_CRITICAL(sr);
+            os_sched(NULL);
+        } else {
+            OS_EXIT_CRITICAL(sr);
+        }
+    }
+
+    return (OS_OK);
+}
+
+/**
+ * Pull a single event from an SPSC queue without blocking.
+ *
+ * @param evq The queue to pull from
+ *
+ * @return The event, or NULL if the queue is empty.
+ */
+struct os_event *
+os_eventq_spsc_poll(struct os_eventq_spsc *evq)
+{
+    struct os_event *ev;
+    uint16_t head;
+
+    head = evq->evq_head;
+    if (head == evq->evq_tail) {
+        return (NULL);
+    }
+
+    ev = evq->evq_ring[head & evq->evq_mask];
+    OS_EVENTQ_SPSC_BARRIER();
+    evq->evq_head = head + 1;
+    ev->ev_queued = 0;
+
+    return (ev);
+}
+
+/**
+ * Pull a single event from an SPSC queue, blocking the current task until
+ * one is available.
+ *
+ * @param evq The queue to pull from
+ *
+ * @return The event.
+ */
+struct os_event *
+os_eventq_spsc_get(struct os_eventq_spsc *evq)
+{
+    struct os_event *ev;
+    struct os_task *t;
+    os_sr_t sr;
+
+    while (1) {
+        ev = os_eventq_spsc_poll(evq);
+        if (ev) {
+            return (ev);
+        }
+
+        /* Publish ourselves as the sleeper, then re-check for an event
+         * posted in between so the wakeup cannot be lost.
+         */
+        OS_ENTER_CRITICAL(sr);
+        t = os_sched_get_current_task();
+        evq->evq_task = t;
+        if (evq->evq_head != evq->evq_tail) {
+            evq->evq_task = NULL;
+            OS_EXIT_CRITICAL(sr);
+            continue;
+        }
+        os_sched_sleep(t, OS_TIMEOUT_NEVER);
+        t->t_flags |= OS_TASK_FLAG_EVQ_WAIT;
+        OS_EXIT_CRITICAL(sr);
+
+        os_sched(NULL);
+
+        OS_ENTER_CRITICAL(sr);
+        t->t_flags &= ~OS_TASK_FLAG_EVQ_WAIT;
+        evq->evq_task = NULL;
+        OS_EXIT_CRITICAL(sr);
+    }
+}
+
+/**
+ *   @} OSEventSPSC
+ * @} OSKernel
+ */
@@ -19,6 +19,7 @@
 
 
 #include <assert.h>
+#include "syscfg/syscfg.h"
 #include "os/os_mutex.h"
 #include "os/os_heap.h"
 
@@ -69,7 +70,11 @@ os_malloc(size_t size)
     void *ptr;
 
     os_malloc_lock();
+#if MYNEWT_VAL(OS_HEAP_TLSF)
+    ptr = os_tlsf_malloc(size);
+#else
     ptr = malloc(size);
+#endif
     os_malloc_unlock();
 
     return ptr;
@@ -86,7 +91,11 @@ void
 os_free(void *mem)
 {
     os_malloc_lock();
+#if MYNEWT_VAL(OS_HEAP_TLSF)
+    os_tlsf_free(mem);
+#else
     free(mem);
+#endif
     os_malloc_unlock();
 }
 
@@ -106,7 +115,11 @@ os_realloc(void *ptr, size_t size)
     void *new_ptr;
 
     os_malloc_lock();
+#if MYNEWT_VAL(OS_HEAP_TLSF)
+    new_ptr = os_tlsf_realloc(ptr, size);
+#else
     new_ptr = realloc(ptr, size);
+#endif
     os_malloc_unlock();
 
     return new_ptr;
@@ -0,0 +1,367 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(OS_HEAP_TLSF)
+
+#include <assert.h>
+#include <string.h>
+
+#include "os/os.h"
+#include "os/os_heap.h"
+#include "os/os_cputime.h"
+#include "stats/stats.h"
+
+/*
+ * Two-level segregated fit allocator.  The first level splits free blocks
+ * by power-of-two size class; the second level subdivides each class into
+ * OS_TLSF_SL_COUNT linear sub-bins.  Two bitmaps (one per level) make
+ * finding a fitting free block a pair of find-first-set operations, so
+ * allocation and free both run in constant, bounded time regardless of
+ * heap state.
+ */
+
+#define OS_TLSF_ALIGN           (8)
+#define OS_TLSF_SL_BITS         (2)
+#define OS_TLSF_SL_COUNT        (1 << OS_TLSF_SL_BITS)
+#define OS_TLSF_FL_SHIFT        (4)     /* smallest class: 16 bytes */
+#define OS_TLSF_FL_COUNT        (24)    /* largest class: 8MB */
+#define OS_TLSF_MIN_BLOCK       (1 << OS_TLSF_FL_SHIFT)
+
+#define OS_TLSF_F_FREE          (0x1)
+#define OS_TLSF_F_PREV_FREE     (0x2)
+#define OS_TLSF_SIZE_MASK       (~(uint32_t)0x3)
+
+struct os_tlsf_block {
+    /* Size of the payload area; low bits hold the free flags */
+    uint32_t tb_size;
+    /* Physically preceding block, valid when OS_TLSF_F_PREV_FREE set */
+    struct os_tlsf_block *tb_prev_phys;
+    /* Free-list linkage; only valid while the block is free */
+    struct os_tlsf_block *tb_next_free;
+    struct os_tlsf_block *tb_prev_free;
+};
+
+/* Overhead of an allocated block: size word plus prev_phys pointer */
+#define OS_TLSF_BLOCK_OVERHEAD  (offsetof(struct os_tlsf_block, tb_next_free))
+
+struct os_tlsf {
+    struct os_tlsf_block *t_free[OS_TLSF_FL_COUNT][OS_TLSF_SL_COUNT];
+    uint32_t t_fl_bitmap;
+    uint8_t t_sl_bitmap[OS_TLSF_FL_COUNT];
+    uint32_t t_free_bytes;
+    uint8_t t_inited;
+};
+
+static struct os_tlsf g_os_tlsf;
+
+STATS_SECT_START(os_tlsf_stats)
+    STATS_SECT_ENTRY(allocs)
+    STATS_SECT_ENTRY(frees)
+    STATS_SECT_ENTRY(alloc_fails)
+    STATS_SECT_ENTRY(free_bytes)
+    STATS_SECT_ENTRY(min_free_bytes)
+    STATS_SECT_ENTRY(max_alloc_cputime)
+STATS_SECT_END
+
+STATS_SECT_DECL(os_tlsf_stats) g_os_tlsf_stats;
+
+STATS_NAME_START(os_tlsf_stats)
+    STATS_NAME(os_tlsf_stats, allocs)
+    STATS_NAME(os_tlsf_stats, frees)
+    STATS_NAME(os_tlsf_stats, alloc_fails)
+    STATS_NAME(os_tlsf_stats, free_bytes)
+    STATS_NAME(os_tlsf_stats, min_free_bytes)
+    STATS_NAME(os_tlsf_stats, max_alloc_cputime)
+STATS_NAME_END(os_tlsf_stats)
+
+static uint32_t
+os_tlsf_block_size(struct os_tlsf_block *b)
+{
+    return (b->tb_size & OS_TLSF_SIZE_MASK);
+}
+
+static struct os_tlsf_block *
+os_tlsf_next_phys(struct os_tlsf_block *b)
+{
+    return ((struct os_tlsf_block *)
+            ((uint8_t *)b + OS_TLSF_BLOCK_OVERHEAD + os_tlsf_block_size(b)));
+}
+
+static void
+os_tlsf_mapping(uint32_t size, int *fl, int *sl)
+{
+    int f;
+
+    if (size < OS_TLSF_MIN_BLOCK) {
+        size = OS_TLSF_MIN_BLOCK;
+    }
+    f = 31 - __builtin_clz(size);
+    *sl = (size >> (f - OS_TLSF_SL_BITS)) & (OS_TLSF_SL_COUNT - 1);
+    *fl = f - OS_TLSF_FL_SHIFT;
+    if (*fl >= OS_TLSF_FL_COUNT) {
+        *fl = OS_TLSF_FL_COUNT - 1;
+        *sl = OS_TLSF_SL_COUNT - 1;
+    }
+}
+
+static void
+os_tlsf_free_insert(struct os_tlsf_block *b)
+{
+    int fl;
+    int sl;
+
+    os_tlsf_mapping(os_tlsf_block_size(b), &fl, &sl);
+    b->tb_prev_free = NULL;
+    b->tb_next_free = g_os_tlsf.t_free[fl][sl];
+    if (b->tb_next_free) {
+        b->tb_next_free->tb_prev_free = b;
+    }
+    g_os_tlsf.t_free[fl][sl] = b;
+    g_os_tlsf.t_fl_bitmap |= (1UL << fl);
+    g_os_tlsf.t_sl_bitmap[fl] |= (1 << sl);
+    b->tb_size |= OS_TLSF_F_FREE;
+    os_tlsf_next_phys(b)->tb_size |= OS_TLSF_F_PREV_FREE;
+    os_tlsf_next_phys(b)->tb_prev_phys = b;
+}
+
+static void
+os_tlsf_free_remove(struct os_tlsf_block *b, int fl, int sl)
+{
+    if (b->tb_prev_free) {
+        b->tb_prev_free->tb_next_free = b->tb_next_free;
+    } else {
+        g_os_tlsf.t_free[fl][sl] = b->tb_next_free;
+        if (g_os_tlsf.t_free[fl][sl] == NULL) {
+            g_os_tlsf.t_sl_bitmap[fl] &= ~(1 << sl);
+            if (g_os_tlsf.t_sl_bitmap[fl] == 0) {
+                g_os_tlsf.t_fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+    if (b->tb_next_free) {
+        b->tb_next_free->tb_prev_free = b->tb_prev_free;
+    }
+    b->tb_size &= ~OS_TLSF_F_FREE;
+    os_tlsf_next_phys(b)->tb_size &= ~OS_TLSF_F_PREV_FREE;
+}
+
+/*
+ * Split 'b' so its payload is exactly 'size' bytes; the remainder, if big
+ * enough to stand alone, goes back on the free lists.
+ */
+static void
+os_tlsf_split(struct os_tlsf_block *b, uint32_t size)
+{
+    struct os_tlsf_block *rem;
+    uint32_t bsize;
+
+    bsize = os_tlsf_block_size(b);
+    if (bsize - size < OS_TLSF_MIN_BLOCK + OS_TLSF_BLOCK_OVERHEAD) {
+        return;
+    }
+
+    b->tb_size = (b->tb_size & ~OS_TLSF_SIZE_MASK) | size;
+    rem = os_tlsf_next_phys(b);
+    rem->tb_size = bsize - size - OS_TLSF_BLOCK_OVERHEAD;
+    rem->tb_prev_phys = b;
+    g_os_tlsf.t_free_bytes -= OS_TLSF_BLOCK_OVERHEAD;
+    os_tlsf_free_insert(rem);
+}
+
+/**
+ * Seed the TLSF heap from a contiguous RAM region, typically the BSP heap
+ * area.  Must be called once, before the first os_malloc().
+ *
+ * @param base Start of the heap region
+ * @param len Length of the heap region in bytes
+ *
+ * @return 0 on success, OS_EINVAL if the region is unusably small.
+ */
+int
+os_heap_tlsf_init(void *base, size_t len)
+{
+    struct os_tlsf_block *b;
+    struct os_tlsf_block *sentinel;
+    uintptr_t start;
+    uintptr_t end;
+
+    start = ((uintptr_t)base + OS_TLSF_ALIGN - 1) & ~(uintptr_t)(OS_TLSF_ALIGN - 1);
+    end = ((uintptr_t)base + len) & ~(uintptr_t)(OS_TLSF_ALIGN - 1);
+
+    if (end <= start ||
+        end - start < 2 * OS_TLSF_BLOCK_OVERHEAD + OS_TLSF_MIN_BLOCK) {
+        return (OS_EINVAL);
+    }
+
+    memset(&g_os_tlsf, 0, sizeof(g_os_tlsf));
+
+    /* Terminating sentinel: zero-size, allocated, never merged */
+    sentinel = (struct os_tlsf_block *)(end - OS_TLSF_BLOCK_OVERHEAD);
+    sentinel->tb_size = 0;
+
+    b = (struct os_tlsf_block *)start;
+    b->tb_size = (end - OS_TLSF_BLOCK_OVERHEAD) - start - OS_TLSF_BLOCK_OVERHEAD;
+    g_os_tlsf.t_free_bytes = os_tlsf_block_size(b);
+    os_tlsf_free_insert(b);
+    g_os_tlsf.t_inited = 1;
+
+    stats_init_and_reg(STATS_HDR(g_os_tlsf_stats),
+        STATS_SIZE_INIT_PARMS(g_os_tlsf_stats, STATS_SIZE_32),
+        STATS_NAME_INIT_PARMS(os_tlsf_stats), "os_tlsf");
+    STATS_INCN(g_os_tlsf_stats, free_bytes, g_os_tlsf.t_free_bytes);
+    STATS_INCN(g_os_tlsf_stats, min_free_bytes, g_os_tlsf.t_free_bytes);
+
+    return (OS_OK);
+}
+
+static void
+os_tlsf_stats_free_bytes_update(void)
+{
+    g_os_tlsf_stats.sfree_bytes = g_os_tlsf.t_free_bytes;
+    if (g_os_tlsf.t_free_bytes < g_os_tlsf_stats.smin_free_bytes) {
+        g_os_tlsf_stats.smin_free_bytes = g_os_tlsf.t_free_bytes;
+    }
+}
+
+void *
+os_tlsf_malloc(size_t size)
+{
+    struct os_tlsf_block *b;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t fl_map;
+    int fl;
+    int sl;
+
+    if (!g_os_tlsf.t_inited) {
+        return (NULL);
+    }
+
+    start = os_cputime_get32();
+
+    size = (size + OS_TLSF_ALIGN - 1) & ~(size_t)(OS_TLSF_ALIGN - 1);
+    if (size < OS_TLSF_MIN_BLOCK) {
+        size = OS_TLSF_MIN_BLOCK;
+    }
+
+    /* Round the search size up one sub-bin so any block found fits */
+    os_tlsf_mapping(size + (1 << ((31 - __builtin_clz((uint32_t)size)) -
+                                  OS_TLSF_SL_BITS)) - 1, &fl, &sl);
+
+    /* Find the first non-empty list at or above (fl, sl) */
+    if (g_os_tlsf.t_sl_bitmap[fl] & (~0U << sl)) {
+        sl = __builtin_ctz(g_os_tlsf.t_sl_bitmap[fl] & (~0U << sl));
+    } else {
+        fl_map = g_os_tlsf.t_fl_bitmap & (~0UL << (fl + 1));
+        if (fl_map == 0) {
+            STATS_INC(g_os_tlsf_stats, alloc_fails);
+            return (NULL);
+        }
+        fl = __builtin_ctz(fl_map);
+        sl = __builtin_ctz(g_os_tlsf.t_sl_bitmap[fl]);
+    }
+
+    b = g_os_tlsf.t_free[fl][sl];
+    os_tlsf_free_remove(b, fl, sl);
+    os_tlsf_split(b, size);
+    g_os_tlsf.t_free_bytes -= os_tlsf_block_size(b);
+
+    STATS_INC(g_os_tlsf_stats, allocs);
+    os_tlsf_stats_free_bytes_update();
+    elapsed = os_cputime_get32() - start;
+    if (elapsed > g_os_tlsf_stats.smax_alloc_cputime) {
+        g_os_tlsf_stats.smax_alloc_cputime = elapsed;
+    }
+
+    return ((uint8_t *)b + OS_TLSF_BLOCK_OVERHEAD);
+}
+
+void
+os_tlsf_free(void *mem)
+{
+    struct os_tlsf_block *b;
+    struct os_tlsf_block *other;
+    int fl;
+    int sl;
+
+    if (mem == NULL) {
+        return;
+    }
+
+    b = (struct os_tlsf_block *)((uint8_t *)mem - OS_TLSF_BLOCK_OVERHEAD);
+    assert((b->tb_size & OS_TLSF_F_FREE) == 0);
+
+    g_os_tlsf.t_free_bytes += os_tlsf_block_size(b);
+
+    /* Coalesce with the physically previous block */
+    if (b->tb_size & OS_TLSF_F_PREV_FREE) {
+        other = b->tb_prev_phys;
+        os_tlsf_mapping(os_tlsf_block_size(other), &fl, &sl);
+        os_tlsf_free_remove(other, fl, sl);
+        other->tb_size += os_tlsf_block_size(b) + OS_TLSF_BLOCK_OVERHEAD;
+        g_os_tlsf.t_free_bytes += OS_TLSF_BLOCK_OVERHEAD;
+        b = other;
+    }
+
+    /* Coalesce with the physically next block */
+    other = os_tlsf_next_phys(b);
+    if (other->tb_size & OS_TLSF_F_FREE) {
+        os_tlsf_mapping(os_tlsf_block_size(other), &fl, &sl);
+        os_tlsf_free_remove(other, fl, sl);
+        b->tb_size += os_tlsf_block_size(other) + OS_TLSF_BLOCK_OVERHEAD;
+        g_os_tlsf.t_free_bytes += OS_TLSF_BLOCK_OVERHEAD;
+    }
+
+    os_tlsf_free_insert(b);
+    STATS_INC(g_os_tlsf_stats, frees);
+    os_tlsf_stats_free_bytes_update();
+}
+
+void *
+os_tlsf_realloc(void *ptr, size_t size)
+{
+    struct os_tlsf_block *b;
+    uint32_t old_size;
+    void *new_ptr;
+
+    if (ptr == NULL) {
+        return (os_tlsf_malloc(size));
+    }
+    if (size == 0) {
+        os_tlsf_free(ptr);
+        return (NULL);
+    }
+
+    b = (struct os_tlsf_block *)((uint8_t *)ptr - OS_TLSF_BLOCK_OVERHEAD);
+    old_size = os_tlsf_block_size(b);
+    if (old_size >= size) {
+        return (ptr);
+    }
+
+    new_ptr = os_tlsf_malloc(size);
+    if (new_ptr != NULL) {
+        memcpy(new_ptr, ptr, old_size);
+        os_tlsf_free(ptr);
+    }
+    return (new_ptr);
+}
+
+#endif /* MYNEWT_VAL(OS_HEAP_TLSF) */
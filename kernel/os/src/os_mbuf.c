@@ -214,6 +214,11 @@ _os_msys_find_pool(uint16_t dsize)
     return (pool);
 }
 
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+static int os_msys_group_claim(struct os_msys_group *omg);
+static void os_msys_group_release(struct os_msys_group *omg);
+#endif
+
 /**
  * Allocate a mbuf from msys.  Based upon the data size requested,
  * os_msys_get() will choose the mbuf pool that has the best fit.
@@ -230,6 +235,13 @@ os_msys_get(uint16_t dsize, uint16_t leadingspace)
     struct os_mbuf *m;
     struct os_mbuf_pool *pool;
 
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+    /* Ungrouped allocations may not eat into any group's guarantee */
+    if (os_msys_group_claim(NULL)) {
+        goto err;
+    }
+#endif
+
     pool = _os_msys_find_pool(dsize);
     if (!pool) {
         goto err;
@@ -257,6 +269,13 @@ os_msys_get_pkthdr(uint16_t dsize, uint16_t user_hdr_len)
     struct os_mbuf *m;
     struct os_mbuf_pool *pool;
 
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+    /* Ungrouped allocations may not eat into any group's guarantee */
+    if (os_msys_group_claim(NULL)) {
+        goto err;
+    }
+#endif
+
     total_pkthdr_len =  user_hdr_len + sizeof(struct os_mbuf_pkthdr);
     pool = _os_msys_find_pool(dsize + total_pkthdr_len);
     if (!pool) {
@@ -269,6 +288,31 @@ err:
     return (NULL);
 }
 
+/**
+ * Allocate an external-buffer mbuf from the MSYS pool.  See
+ * os_mbuf_get_ext() for the external-buffer semantics.
+ *
+ * @param buf The external data buffer
+ * @param len Number of valid data bytes in 'buf'
+ * @param free_cb Callback invoked when the mbuf is freed; may be NULL
+ * @param arg Argument passed to 'free_cb'
+ *
+ * @return A freshly allocated mbuf on success, NULL on failure.
+ */
+struct os_mbuf *
+os_msys_get_ext(uint8_t *buf, uint16_t len, os_mbuf_ext_free_fn *free_cb,
+                void *arg)
+{
+    struct os_mbuf_pool *pool;
+
+    pool = _os_msys_find_pool(sizeof(struct os_mbuf_ext));
+    if (!pool) {
+        return (NULL);
+    }
+
+    return (os_mbuf_get_ext(pool, buf, len, free_cb, arg));
+}
+
 int
 os_msys_count(void)
 {
@@ -297,6 +341,412 @@ os_msys_num_free(void)
     return total;
 }
 
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+
+static STAILQ_HEAD(, os_msys_group) g_msys_group_list =
+    STAILQ_HEAD_INITIALIZER(g_msys_group_list);
+
+/**
+ * Registers a reservation group with msys.  The group is guaranteed
+ * 'min_blocks' blocks: allocations from other groups (and ungrouped
+ * allocations) are refused while granting them would eat into the
+ * unused part of any group's guarantee.  'max_blocks' caps the blocks
+ * the group may hold at once; 0 leaves it uncapped.  The structure is
+ * owned by the caller and must stay valid for the life of the system.
+ *
+ * @return 0 on success;
+ *         OS_INVALID_PARM if the cap is below the guarantee or the
+ *             group is already registered;
+ *         OS_ENOMEM if the combined guarantees exceed the msys blocks.
+ */
+int
+os_msys_group_register(struct os_msys_group *omg, uint16_t min_blocks,
+                       uint16_t max_blocks)
+{
+    struct os_msys_group *cur;
+    int reserved;
+    os_sr_t sr;
+
+    if (max_blocks != 0 && max_blocks < min_blocks) {
+        return OS_INVALID_PARM;
+    }
+
+    reserved = min_blocks;
+    STAILQ_FOREACH(cur, &g_msys_group_list, omg_next) {
+        if (cur == omg) {
+            return OS_INVALID_PARM;
+        }
+        reserved += cur->omg_min;
+    }
+    if (reserved > os_msys_count()) {
+        return OS_ENOMEM;
+    }
+
+    omg->omg_min = min_blocks;
+    omg->omg_max = max_blocks;
+    omg->omg_used = 0;
+    omg->omg_max_used = 0;
+    omg->omg_denied = 0;
+
+    OS_ENTER_CRITICAL(sr);
+    STAILQ_INSERT_TAIL(&g_msys_group_list, omg, omg_next);
+    OS_EXIT_CRITICAL(sr);
+
+    return OS_OK;
+}
+
+/*
+ * Charge one block to 'omg' (NULL for an ungrouped allocation) if the
+ * allocation is admissible: a group may not exceed its cap, and an
+ * allocation not covered by its own group's guarantee must leave
+ * enough free blocks to satisfy the unused guarantees of every other
+ * group.
+ */
+static int
+os_msys_group_claim(struct os_msys_group *omg)
+{
+    struct os_msys_group *cur;
+    int reserved;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (omg) {
+        if (omg->omg_max != 0 && omg->omg_used >= omg->omg_max) {
+            goto deny;
+        }
+        if (omg->omg_used < omg->omg_min) {
+            goto admit;
+        }
+    }
+
+    reserved = 0;
+    STAILQ_FOREACH(cur, &g_msys_group_list, omg_next) {
+        if (cur != omg && cur->omg_used < cur->omg_min) {
+            reserved += cur->omg_min - cur->omg_used;
+        }
+    }
+    if (os_msys_num_free() - 1 < reserved) {
+        goto deny;
+    }
+
+admit:
+    if (omg) {
+        omg->omg_used++;
+        if (omg->omg_used > omg->omg_max_used) {
+            omg->omg_max_used = omg->omg_used;
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+    return 0;
+
+deny:
+    if (omg) {
+        omg->omg_denied++;
+    }
+    OS_EXIT_CRITICAL(sr);
+    return -1;
+}
+
+static void
+os_msys_group_release(struct os_msys_group *omg)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    omg->omg_used--;
+    OS_EXIT_CRITICAL(sr);
+}
+
+/**
+ * As os_msys_get(), with the block charged to the reservation group
+ * 'omg'.  The charge follows the mbuf and is returned when it is
+ * freed.
+ */
+struct os_mbuf *
+os_msys_get_grp(struct os_msys_group *omg, uint16_t dsize,
+                uint16_t leadingspace)
+{
+    struct os_mbuf_pool *pool;
+    struct os_mbuf *m;
+
+    if (os_msys_group_claim(omg)) {
+        return (NULL);
+    }
+
+    m = NULL;
+    pool = _os_msys_find_pool(dsize);
+    if (pool) {
+        m = os_mbuf_get(pool, leadingspace);
+    }
+    if (!m) {
+        if (omg) {
+            os_msys_group_release(omg);
+        }
+        return (NULL);
+    }
+    m->om_grp = omg;
+    return (m);
+}
+
+/**
+ * As os_msys_get_pkthdr(), with the block charged to the reservation
+ * group 'omg'.
+ */
+struct os_mbuf *
+os_msys_get_pkthdr_grp(struct os_msys_group *omg, uint16_t dsize,
+                       uint16_t user_hdr_len)
+{
+    uint16_t total_pkthdr_len;
+    struct os_mbuf_pool *pool;
+    struct os_mbuf *m;
+
+    if (os_msys_group_claim(omg)) {
+        return (NULL);
+    }
+
+    m = NULL;
+    total_pkthdr_len = user_hdr_len + sizeof(struct os_mbuf_pkthdr);
+    pool = _os_msys_find_pool(dsize + total_pkthdr_len);
+    if (pool) {
+        m = os_mbuf_get_pkthdr(pool, user_hdr_len);
+    }
+    if (!m) {
+        if (omg) {
+            os_msys_group_release(omg);
+        }
+        return (NULL);
+    }
+    m->om_grp = omg;
+    return (m);
+}
+
+#endif /* MYNEWT_VAL(OS_MSYS_GROUPS) */
+
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+int
+os_msys_listener_register(struct os_mempool_listener *omls, int nomls,
+                          uint8_t low_pct, os_mempool_pressure_fn *func,
+                          void *arg)
+{
+    struct os_mbuf_pool *omp;
+    int npools;
+    int rc;
+    int i;
+
+    npools = 0;
+    STAILQ_FOREACH(omp, &g_msys_pool_list, omp_next) {
+        npools++;
+    }
+    if (npools > nomls) {
+        return -1;
+    }
+
+    i = 0;
+    STAILQ_FOREACH(omp, &g_msys_pool_list, omp_next) {
+        omls[i].oml_func = func;
+        omls[i].oml_arg = arg;
+        omls[i].oml_low_pct = low_pct;
+        rc = os_mempool_listener_register(omp->omp_pool, &omls[i]);
+        if (rc != OS_OK) {
+            return -1;
+        }
+        i++;
+    }
+
+    return i;
+}
+#endif
+
+#if MYNEWT_VAL(OS_MSYS_TASK_CACHE)
+
+/* Compiler barrier bracketing cache list accesses; see mc_busy */
+#define OS_MSYS_CACHE_BARRIER()     __asm__ volatile ("" ::: "memory")
+
+/* Number of blocks stolen from the shared pool when the cache runs dry */
+#define OS_MSYS_CACHE_REFILL        ((MYNEWT_VAL(OS_MSYS_TASK_CACHE) + 1) / 2)
+
+/*
+ * Claim the current task's block cache if it applies to 'omp'.  The cache
+ * is serialized with the mc_busy flag rather than a critical section: an
+ * ISR that preempts the owner between the flag test and the flag store
+ * runs a complete cache operation of its own, and afterwards the owner
+ * re-reads the list from scratch (the barrier prevents hoisting).  An ISR
+ * that preempts while the flag is set simply falls back to the shared
+ * pool.
+ */
+static struct os_msys_cache *
+os_msys_cache_claim(struct os_mbuf_pool *omp)
+{
+    struct os_msys_cache *mc;
+    struct os_task *t;
+
+    if (!g_os_started) {
+        return (NULL);
+    }
+
+    t = os_sched_get_current_task();
+    if (!t) {
+        return (NULL);
+    }
+
+    mc = t->t_msys_cache;
+    if (!mc || mc->mc_omp != omp || mc->mc_busy) {
+        return (NULL);
+    }
+
+    mc->mc_busy = 1;
+    OS_MSYS_CACHE_BARRIER();
+
+    return (mc);
+}
+
+static void
+os_msys_cache_release(struct os_msys_cache *mc)
+{
+    OS_MSYS_CACHE_BARRIER();
+    mc->mc_busy = 0;
+}
+
+/*
+ * Pop a block from the current task's cache, refilling from the shared
+ * pool in one critical section if the cache is empty.  Returns NULL if no
+ * cache applies or the shared pool is also dry.
+ */
+static struct os_mbuf *
+os_msys_cache_block_get(struct os_mbuf_pool *omp)
+{
+    struct os_msys_cache *mc;
+    void *blocks[OS_MSYS_CACHE_REFILL];
+    void *block;
+    int cnt;
+    int i;
+
+    mc = os_msys_cache_claim(omp);
+    if (!mc) {
+        return (NULL);
+    }
+
+    block = mc->mc_free;
+    if (block) {
+        mc->mc_free = *(void **)block;
+        mc->mc_num_free--;
+    } else {
+        cnt = os_memblock_get_multi(omp->omp_pool, blocks,
+                                    OS_MSYS_CACHE_REFILL);
+        if (cnt > 0) {
+            block = blocks[--cnt];
+            for (i = 0; i < cnt; i++) {
+                *(void **)blocks[i] = mc->mc_free;
+                mc->mc_free = blocks[i];
+            }
+            mc->mc_num_free += cnt;
+        }
+    }
+    os_msys_cache_release(mc);
+
+    return ((struct os_mbuf *)block);
+}
+
+/*
+ * Push a freed block onto the current task's cache.  Returns 1 if the
+ * block was absorbed, 0 if the caller must return it to the shared pool.
+ */
+static int
+os_msys_cache_block_put(struct os_mbuf_pool *omp, struct os_mbuf *om)
+{
+    struct os_msys_cache *mc;
+    int cached;
+
+    mc = os_msys_cache_claim(omp);
+    if (!mc) {
+        return (0);
+    }
+
+    if (mc->mc_num_free >= MYNEWT_VAL(OS_MSYS_TASK_CACHE)) {
+        cached = 0;
+    } else {
+        *(void **)om = mc->mc_free;
+        mc->mc_free = om;
+        mc->mc_num_free++;
+        cached = 1;
+    }
+    os_msys_cache_release(mc);
+
+    return (cached);
+}
+
+/**
+ * Attach a block cache to the current task, bound to the msys pool that
+ * would satisfy allocations of 'dsize' bytes.  Until detached, the task's
+ * mbuf alloc/free against that pool bypasses the shared free list on the
+ * common path.
+ *
+ * @param mc Uninitialized cache structure, owned by the caller
+ * @param dsize Indicative mbuf size selecting the pool to cache
+ *
+ * @return 0 on success;
+ *         OS_EINVAL if mc is NULL or the OS is not started;
+ *         OS_ENOENT if no msys pool is registered;
+ *         OS_EBUSY if the task already has a cache attached.
+ */
+int
+os_msys_cache_attach(struct os_msys_cache *mc, uint16_t dsize)
+{
+    struct os_task *t;
+
+    if (!mc || !g_os_started) {
+        return (OS_EINVAL);
+    }
+
+    mc->mc_omp = _os_msys_find_pool(dsize);
+    if (!mc->mc_omp) {
+        return (OS_ENOENT);
+    }
+
+    t = os_sched_get_current_task();
+    if (t->t_msys_cache) {
+        return (OS_EBUSY);
+    }
+
+    mc->mc_free = NULL;
+    mc->mc_num_free = 0;
+    mc->mc_busy = 0;
+    mc->mc_task = t;
+    t->t_msys_cache = mc;
+
+    return (0);
+}
+
+/**
+ * Detach a block cache from its owning task and return any cached blocks
+ * to the shared pool.  Must be called from the owning task.
+ *
+ * @param mc The cache to detach
+ */
+void
+os_msys_cache_detach(struct os_msys_cache *mc)
+{
+    void *block;
+
+    if (!mc || !mc->mc_task) {
+        return;
+    }
+
+    /* Unhook first so preempting ISRs stop seeing the cache */
+    mc->mc_task->t_msys_cache = NULL;
+    OS_MSYS_CACHE_BARRIER();
+
+    while (mc->mc_free) {
+        block = mc->mc_free;
+        mc->mc_free = *(void **)block;
+        os_memblock_put(mc->mc_omp->omp_pool, block);
+    }
+    mc->mc_num_free = 0;
+    mc->mc_task = NULL;
+}
+
+#endif /* MYNEWT_VAL(OS_MSYS_TASK_CACHE) */
+
 /**
  * Initialize a pool of mbufs.
  *
@@ -337,7 +787,14 @@ os_mbuf_get(struct os_mbuf_pool *omp, uint16_t leadingspace)
         goto err;
     }
 
+#if MYNEWT_VAL(OS_MSYS_TASK_CACHE)
+    om = os_msys_cache_block_get(omp);
+    if (!om) {
+        om = os_memblock_get(omp->omp_pool);
+    }
+#else
     om = os_memblock_get(omp->omp_pool);
+#endif
     if (!om) {
         goto err;
     }
@@ -348,12 +805,63 @@ os_mbuf_get(struct os_mbuf_pool *omp, uint16_t leadingspace)
     om->om_len = 0;
     om->om_data = (&om->om_databuf[0] + leadingspace);
     om->om_omp = omp;
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+    om->om_grp = NULL;
+#endif
+
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+    /* Attribute the block to whoever asked for the mbuf, not to us */
+    os_mempool_trace_record(omp->omp_pool, om,
+                            (uintptr_t)__builtin_return_address(0));
+#endif
 
     return (om);
 err:
     return (NULL);
 }
 
+/**
+ * Allocate an mbuf whose data area is an external, caller-owned buffer.
+ * The mbuf structure itself still comes from the pool, but om_data points
+ * directly at 'buf', so large payloads traverse the stack without being
+ * copied into pool blocks.  When the mbuf is freed, 'free_cb' (if any) is
+ * invoked with the buffer and 'arg' so the caller can reclaim it.
+ *
+ * External mbufs report zero leading and trailing space, so appends and
+ * prepends always spill into regular pool mbufs rather than scribbling on
+ * caller memory.
+ *
+ * @param omp The mbuf pool to allocate the mbuf structure from
+ * @param buf The external data buffer
+ * @param len Number of valid data bytes in 'buf'
+ * @param free_cb Callback invoked when the mbuf is freed; may be NULL
+ * @param arg Argument passed to 'free_cb'
+ *
+ * @return The new mbuf on success, NULL on failure.
+ */
+struct os_mbuf *
+os_mbuf_get_ext(struct os_mbuf_pool *omp, uint8_t *buf, uint16_t len,
+                os_mbuf_ext_free_fn *free_cb, void *arg)
+{
+    struct os_mbuf_ext *ext;
+    struct os_mbuf *om;
+
+    om = os_mbuf_get(omp, 0);
+    if (om == NULL) {
+        return (NULL);
+    }
+
+    om->om_flags = OS_MBUF_F_EXT;
+    om->om_data = buf;
+    om->om_len = len;
+
+    ext = OS_MBUF_EXTHDR(om);
+    ext->oe_free_cb = free_cb;
+    ext->oe_arg = arg;
+
+    return (om);
+}
+
 /**
  * Allocate a new packet header mbuf out of the os_mbuf_pool.
  *
@@ -384,6 +892,11 @@ os_mbuf_get_pkthdr(struct os_mbuf_pool *omp, uint8_t user_pkthdr_len)
         pkthdr->omp_len = 0;
         pkthdr->omp_flags = 0;
         STAILQ_NEXT(pkthdr, omp_next) = NULL;
+
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+        os_mempool_trace_record(omp->omp_pool, om,
+                                (uintptr_t)__builtin_return_address(0));
+#endif
     }
 
     return om;
@@ -400,9 +913,34 @@ os_mbuf_get_pkthdr(struct os_mbuf_pool *omp, uint8_t user_pkthdr_len)
 int
 os_mbuf_free(struct os_mbuf *om)
 {
+    struct os_mbuf_ext *ext;
     int rc;
 
+    /* Hand caller-owned data back before releasing the mbuf itself */
+    if (om->om_flags & OS_MBUF_F_EXT) {
+        ext = OS_MBUF_EXTHDR(om);
+        if (ext->oe_free_cb != NULL) {
+            ext->oe_free_cb(om->om_data, ext->oe_arg);
+        }
+    }
+
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+    if (om->om_grp != NULL) {
+        os_msys_group_release(om->om_grp);
+        om->om_grp = NULL;
+    }
+#endif
+
     if (om->om_omp != NULL) {
+#if MYNEWT_VAL(OS_MSYS_TASK_CACHE)
+        if (os_msys_cache_block_put(om->om_omp, om)) {
+            /* Cached blocks bypass os_memblock_put() */
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+            os_mempool_trace_release(om);
+#endif
+            return (0);
+        }
+#endif
         rc = os_memblock_put(om->om_omp->omp_pool, om);
         if (rc != 0) {
             goto err;
@@ -473,6 +1011,38 @@ _os_mbuf_copypkthdr(struct os_mbuf *new_buf, struct os_mbuf *old_buf)
  */
 int
 os_mbuf_append(struct os_mbuf *om, const void *data,  uint16_t len)
+{
+    struct os_mbuf *last;
+
+    if (om == NULL) {
+        return (OS_EINVAL);
+    }
+
+    /* Scroll to last mbuf in the chain */
+    last = om;
+    while (SLIST_NEXT(last, om_next) != NULL) {
+        last = SLIST_NEXT(last, om_next);
+    }
+
+    return (os_mbuf_append_at(om, &last, data, len));
+}
+
+/**
+ * Append data onto a mbuf, continuing from a known last mbuf in the chain.
+ * This is the workhorse behind os_mbuf_append() and os_mbuf_writer_append();
+ * callers that keep 'lastp' across calls get O(1) appends since the chain
+ * is never rescanned.
+ *
+ * @param om The head of the chain (used for the packet header, if any)
+ * @param lastp In: the last mbuf in the chain.  Out: the new last mbuf.
+ * @param data The data to append
+ * @param len The length of the data to append
+ *
+ * @return 0 on success, and an error code on failure
+ */
+int
+os_mbuf_append_at(struct os_mbuf *om, struct os_mbuf **lastp,
+                  const void *data, uint16_t len)
 {
     struct os_mbuf_pool *omp;
     struct os_mbuf *last;
@@ -481,18 +1051,13 @@ os_mbuf_append(struct os_mbuf *om, const void *data,  uint16_t len)
     int space;
     int rc;
 
-    if (om == NULL) {
+    if (om == NULL || lastp == NULL || *lastp == NULL) {
         rc = OS_EINVAL;
         goto err;
     }
 
     omp = om->om_omp;
-
-    /* Scroll to last mbuf in the chain */
-    last = om;
-    while (SLIST_NEXT(last, om_next) != NULL) {
-        last = SLIST_NEXT(last, om_next);
-    }
+    last = *lastp;
 
     remainder = len;
     space = OS_MBUF_TRAILINGSPACE(last);
@@ -534,6 +1099,8 @@ os_mbuf_append(struct os_mbuf *om, const void *data,  uint16_t len)
         OS_MBUF_PKTHDR(om)->omp_len += len - remainder;
     }
 
+    *lastp = last;
+
     if (remainder != 0) {
         rc = OS_ENOMEM;
         goto err;
@@ -545,6 +1112,95 @@ err:
     return (rc);
 }
 
+/**
+ * Initialize a mbuf writer over an existing chain.  The writer caches the
+ * last mbuf in the chain so that subsequent os_mbuf_writer_append() calls
+ * are O(1) instead of rescanning the chain on every append.
+ *
+ * The caller must not manipulate the chain tail by other means while the
+ * writer is in use.
+ *
+ * @param mw The writer to initialize
+ * @param om The mbuf chain the writer appends to
+ */
+void
+os_mbuf_writer_init(struct os_mbuf_writer *mw, struct os_mbuf *om)
+{
+    struct os_mbuf *last;
+
+    last = om;
+    while (SLIST_NEXT(last, om_next) != NULL) {
+        last = SLIST_NEXT(last, om_next);
+    }
+
+    mw->mw_om = om;
+    mw->mw_last = last;
+}
+
+/**
+ * Append data to the chain owned by a mbuf writer.  Equivalent to
+ * os_mbuf_append() on the underlying chain, without the chain walk.
+ *
+ * @param mw The writer to append through
+ * @param data The data to append
+ * @param len The length of the data to append
+ *
+ * @return 0 on success, and an error code on failure
+ */
+int
+os_mbuf_writer_append(struct os_mbuf_writer *mw, const void *data,
+                      uint16_t len)
+{
+    return (os_mbuf_append_at(mw->mw_om, &mw->mw_last, data, len));
+}
+
+/**
+ * Allocate a chain of 'nblks' mbufs from the given pool, pulling all of
+ * the blocks in a single critical section rather than one pool lock per
+ * block.
+ *
+ * @param omp The mbuf pool to allocate from
+ * @param nblks Number of mbufs to chain together
+ *
+ * @return The head of the chain on success; NULL if the pool could not
+ *         satisfy the entire request (nothing is left allocated).
+ */
+struct os_mbuf *
+os_mbuf_get_chain(struct os_mbuf_pool *omp, uint16_t nblks)
+{
+    struct os_mbuf *om;
+    struct os_mbuf *prev;
+    void *blocks[OS_MBUF_CHAIN_GET_MAX];
+    int cnt;
+    int i;
+
+    if (nblks == 0 || nblks > OS_MBUF_CHAIN_GET_MAX) {
+        return (NULL);
+    }
+
+    cnt = os_memblock_get_multi(omp->omp_pool, blocks, nblks);
+    if (cnt != nblks) {
+        for (i = 0; i < cnt; i++) {
+            os_memblock_put(omp->omp_pool, blocks[i]);
+        }
+        return (NULL);
+    }
+
+    prev = NULL;
+    for (i = nblks - 1; i >= 0; i--) {
+        om = (struct os_mbuf *)blocks[i];
+        SLIST_NEXT(om, om_next) = prev;
+        om->om_flags = 0;
+        om->om_pkthdr_len = 0;
+        om->om_len = 0;
+        om->om_data = &om->om_databuf[0];
+        om->om_omp = omp;
+        prev = om;
+    }
+
+    return (prev);
+}
+
 /**
  * Reads data from one mbuf and appends it to another.  On error, the specified
  * data range may be partially appended.  Neither mbuf is required to contain
@@ -630,7 +1286,13 @@ os_mbuf_dup(struct os_mbuf *om)
             }
             copy = head;
         }
-        copy->om_flags = om->om_flags;
+        /* The duplicate owns its data even if the source was external */
+        copy->om_flags = om->om_flags & ~OS_MBUF_F_EXT;
+        if (om->om_len > omp->omp_databuf_len) {
+            /* External-buffer mbuf too large to copy into a pool block */
+            os_mbuf_free_chain(head);
+            goto err;
+        }
         copy->om_len = om->om_len;
         memcpy(OS_MBUF_DATA(copy, uint8_t *), OS_MBUF_DATA(om, uint8_t *),
                 om->om_len);
@@ -889,18 +1551,18 @@ os_mbuf_cmpm(const struct os_mbuf *om1, uint16_t offset1,
              const struct os_mbuf *om2, uint16_t offset2,
              uint16_t len)
 {
-    const struct os_mbuf *cur1;
-    const struct os_mbuf *cur2;
+    struct os_mbuf_iter it1;
+    struct os_mbuf_iter it2;
+    const uint8_t *p1;
+    const uint8_t *p2;
     uint16_t bytes_remaining;
     uint16_t chunk_sz;
     uint16_t om1_left;
     uint16_t om2_left;
-    uint16_t om1_off;
-    uint16_t om2_off;
     int rc;
 
-    cur1 = os_mbuf_off(om1, offset1, &om1_off);
-    cur2 = os_mbuf_off(om2, offset2, &om2_off);
+    os_mbuf_iter_init(&it1, om1, offset1);
+    os_mbuf_iter_init(&it2, om2, offset2);
 
     bytes_remaining = len;
     while (1) {
@@ -908,35 +1570,150 @@ os_mbuf_cmpm(const struct os_mbuf *om1, uint16_t offset1,
             return 0;
         }
 
-        while (cur1 != NULL && om1_off >= cur1->om_len) {
-            cur1 = SLIST_NEXT(cur1, om_next);
-            om1_off = 0;
-        }
-        while (cur2 != NULL && om2_off >= cur2->om_len) {
-            cur2 = SLIST_NEXT(cur2, om_next);
-            om2_off = 0;
-        }
-
-        if (cur1 == NULL || cur2 == NULL) {
+        om1_left = os_mbuf_iter_peek(&it1, &p1);
+        om2_left = os_mbuf_iter_peek(&it2, &p2);
+        if (om1_left == 0 || om2_left == 0) {
             return INT_MAX;
         }
 
-        om1_left = cur1->om_len - om1_off;
-        om2_left = cur2->om_len - om2_off;
         chunk_sz = min(min(om1_left, om2_left), bytes_remaining);
 
-        rc = memcmp(cur1->om_data + om1_off, cur2->om_data + om2_off,
-                    chunk_sz);
+        rc = memcmp(p1, p2, chunk_sz);
         if (rc != 0) {
             return rc;
         }
 
-        om1_off += chunk_sz;
-        om2_off += chunk_sz;
+        os_mbuf_iter_advance(&it1, chunk_sz);
+        os_mbuf_iter_advance(&it2, chunk_sz);
         bytes_remaining -= chunk_sz;
     }
 }
 
+/**
+ * Initialize an iterator over an mbuf chain, positioned 'off' bytes into
+ * the chain's data.
+ *
+ * @param mi The iterator to initialize
+ * @param om The mbuf chain to iterate over
+ * @param off Starting offset within the chain
+ *
+ * @return 0 on success; OS_EINVAL if 'off' is beyond the end of the chain.
+ */
+int
+os_mbuf_iter_init(struct os_mbuf_iter *mi, const struct os_mbuf *om,
+                  uint16_t off)
+{
+    mi->mi_om = os_mbuf_off(om, off, &mi->mi_off);
+    if (mi->mi_om == NULL) {
+        return (OS_EINVAL);
+    }
+    return (0);
+}
+
+/**
+ * Peek at the contiguous region at the iterator's current position
+ * without consuming it.
+ *
+ * @param mi The iterator to peek through
+ * @param data On success, points at the start of the region
+ *
+ * @return The number of contiguous bytes available; 0 at end of chain.
+ */
+uint16_t
+os_mbuf_iter_peek(struct os_mbuf_iter *mi, const uint8_t **data)
+{
+    while (mi->mi_om != NULL && mi->mi_off >= mi->mi_om->om_len) {
+        mi->mi_om = SLIST_NEXT(mi->mi_om, om_next);
+        mi->mi_off = 0;
+    }
+
+    if (mi->mi_om == NULL) {
+        return (0);
+    }
+
+    *data = mi->mi_om->om_data + mi->mi_off;
+    return (mi->mi_om->om_len - mi->mi_off);
+}
+
+/**
+ * Advance an iterator by up to 'len' bytes.
+ *
+ * @param mi The iterator to advance
+ * @param len Number of bytes to consume
+ *
+ * @return The number of bytes actually consumed; less than 'len' only if
+ *         the chain ended first.
+ */
+uint16_t
+os_mbuf_iter_advance(struct os_mbuf_iter *mi, uint16_t len)
+{
+    const uint8_t *data;
+    uint16_t avail;
+    uint16_t consumed;
+    uint16_t chunk;
+
+    consumed = 0;
+    while (consumed < len) {
+        avail = os_mbuf_iter_peek(mi, &data);
+        if (avail == 0) {
+            break;
+        }
+        chunk = min(avail, len - consumed);
+        mi->mi_off += chunk;
+        consumed += chunk;
+    }
+
+    return (consumed);
+}
+
+/**
+ * Walk 'len' bytes of an mbuf chain starting at 'off', invoking 'fn' once
+ * per contiguous segment.  The walk is a single linear pass over the
+ * chain.
+ *
+ * @param om The mbuf chain to walk
+ * @param off Starting offset within the chain
+ * @param len Number of bytes to walk; OS_MBUF_PKTLEN-off or greater walks
+ *            to the end of the chain
+ * @param fn Callback invoked per segment; returning nonzero stops the
+ *           walk and that value is returned
+ * @param arg Argument passed through to 'fn'
+ *
+ * @return 0 when the walk completes; OS_EINVAL if 'off' is out of range;
+ *         otherwise the first nonzero value returned by 'fn'.
+ */
+int
+os_mbuf_foreach_seg(const struct os_mbuf *om, uint16_t off, uint16_t len,
+                    os_mbuf_seg_fn *fn, void *arg)
+{
+    struct os_mbuf_iter mi;
+    const uint8_t *data;
+    uint16_t avail;
+    uint16_t chunk;
+    int rc;
+
+    rc = os_mbuf_iter_init(&mi, om, off);
+    if (rc != 0) {
+        return (rc);
+    }
+
+    while (len > 0) {
+        avail = os_mbuf_iter_peek(&mi, &data);
+        if (avail == 0) {
+            break;
+        }
+        chunk = min(avail, len);
+        rc = fn(data, chunk, arg);
+        if (rc != 0) {
+            return (rc);
+        }
+        os_mbuf_iter_advance(&mi, chunk);
+        len -= chunk;
+    }
+
+    return (0);
+}
+
 /**
  * Increases the length of an mbuf chain by adding data to the front.  If there
  * is insufficient room in the leading mbuf, additional mbufs are allocated and
@@ -34,6 +34,151 @@
 STAILQ_HEAD(, os_mempool) g_os_mempool_list =
     STAILQ_HEAD_INITIALIZER(g_os_mempool_list);
 
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+/*
+ * Fire watermark transitions for 'mp'.  Called after every alloc and
+ * free, outside the allocator's critical section; each listener keeps
+ * its own in-pressure state so it sees exactly one LOW per dip and
+ * one RELIEVED per recovery.
+ */
+static void
+os_mempool_pressure_check(struct os_mempool *mp)
+{
+    struct os_mempool_listener *oml;
+    int num_free;
+
+    num_free = mp->mp_num_free;
+    SLIST_FOREACH(oml, &mp->mp_listeners, oml_next) {
+        if (!oml->oml_in_pressure && num_free <= oml->oml_low_blocks) {
+            oml->oml_in_pressure = 1;
+            oml->oml_func(mp, OS_MEMPOOL_PRESSURE_LOW, oml->oml_arg);
+        } else if (oml->oml_in_pressure &&
+                   num_free > oml->oml_low_blocks) {
+            oml->oml_in_pressure = 0;
+            oml->oml_func(mp, OS_MEMPOOL_PRESSURE_RELIEVED, oml->oml_arg);
+        }
+    }
+}
+
+os_error_t
+os_mempool_listener_register(struct os_mempool *mp,
+                             struct os_mempool_listener *oml)
+{
+    os_sr_t sr;
+
+    if (mp == NULL || oml == NULL || oml->oml_func == NULL ||
+        oml->oml_low_pct > 100) {
+
+        return OS_INVALID_PARM;
+    }
+
+    oml->oml_low_blocks = (mp->mp_num_blocks * oml->oml_low_pct) / 100;
+    oml->oml_in_pressure = 0;
+
+    OS_ENTER_CRITICAL(sr);
+    SLIST_INSERT_HEAD(&mp->mp_listeners, oml, oml_next);
+    OS_EXIT_CRITICAL(sr);
+
+    /* Report pools that are already under pressure */
+    os_mempool_pressure_check(mp);
+
+    return OS_OK;
+}
+
+void
+os_mempool_listener_unregister(struct os_mempool *mp,
+                               struct os_mempool_listener *oml)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    SLIST_REMOVE(&mp->mp_listeners, oml, os_mempool_listener, oml_next);
+    OS_EXIT_CRITICAL(sr);
+}
+#endif /* MYNEWT_VAL(OS_MEMPOOL_PRESSURE) */
+
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+static struct os_mempool_trace_entry
+    os_mempool_trace_table[MYNEWT_VAL(OS_MEMPOOL_TRACE_ENTRIES)];
+static uint32_t os_mempool_trace_drops;
+
+void
+os_mempool_trace_record(const struct os_mempool *mp, const void *block,
+                        uintptr_t pc)
+{
+    struct os_mempool_trace_entry *omt;
+    struct os_mempool_trace_entry *free_omt;
+    os_sr_t sr;
+    int i;
+
+    free_omt = NULL;
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < MYNEWT_VAL(OS_MEMPOOL_TRACE_ENTRIES); i++) {
+        omt = &os_mempool_trace_table[i];
+        if (omt->omt_block == block) {
+            /* Re-attribution by a wrapper; keep the outer caller's pc */
+            omt->omt_pool = mp;
+            omt->omt_pc = pc;
+            OS_EXIT_CRITICAL(sr);
+            return;
+        }
+        if (free_omt == NULL && omt->omt_block == NULL) {
+            free_omt = omt;
+        }
+    }
+    if (free_omt != NULL) {
+        free_omt->omt_pool = mp;
+        free_omt->omt_block = block;
+        free_omt->omt_pc = pc;
+    } else {
+        os_mempool_trace_drops++;
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+void
+os_mempool_trace_release(const void *block)
+{
+    os_sr_t sr;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < MYNEWT_VAL(OS_MEMPOOL_TRACE_ENTRIES); i++) {
+        if (os_mempool_trace_table[i].omt_block == block) {
+            os_mempool_trace_table[i].omt_block = NULL;
+            break;
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+int
+os_mempool_trace_walk(os_mempool_trace_walk_func walk_func, void *arg)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(OS_MEMPOOL_TRACE_ENTRIES); i++) {
+        if (os_mempool_trace_table[i].omt_block == NULL) {
+            continue;
+        }
+        rc = walk_func(&os_mempool_trace_table[i], arg);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t
+os_mempool_trace_overflows(void)
+{
+    return os_mempool_trace_drops;
+}
+#endif /* MYNEWT_VAL(OS_MEMPOOL_TRACE) */
+
 /**
  * os mempool init
  *
@@ -50,6 +195,31 @@ STAILQ_HEAD(, os_mempool) g_os_mempool_list =
 os_error_t
 os_mempool_init(struct os_mempool *mp, int blocks, int block_size,
                 void *membuf, char *name)
+{
+    return (os_mempool_init_ext(mp, blocks, block_size, OS_ALIGNMENT,
+                                membuf, name));
+}
+
+/**
+ * os mempool init ext
+ *
+ * Initialize a memory pool whose blocks are spaced and aligned to an
+ * explicit boundary, e.g. a cache line or DMA burst size.  'membuf' must
+ * start on an 'align' boundary and hold OS_MEMPOOL_BYTES_EXT() bytes.
+ *
+ * @param mp            Pointer to a pointer to a mempool
+ * @param blocks        The number of blocks in the pool
+ * @param block_size    The size of the block, in bytes.
+ * @param align         Block alignment, in bytes; power of two, at least
+ *                      OS_ALIGNMENT.
+ * @param membuf        Pointer to memory to contain blocks.
+ * @param name          Name of the pool.
+ *
+ * @return os_error_t
+ */
+os_error_t
+os_mempool_init_ext(struct os_mempool *mp, int blocks, int block_size,
+                    int align, void *membuf, char *name)
 {
     int true_block_size;
     uint8_t *block_addr;
@@ -60,6 +230,10 @@ os_mempool_init(struct os_mempool *mp, int blocks, int block_size,
         return OS_INVALID_PARM;
     }
 
+    if (align < OS_ALIGNMENT || (align & (align - 1)) != 0) {
+        return OS_INVALID_PARM;
+    }
+
     if ((!membuf) && (blocks != 0)) {
         return OS_INVALID_PARM;
     }
@@ -68,19 +242,24 @@ os_mempool_init(struct os_mempool *mp, int blocks, int block_size,
         /* Blocks need to be sized properly and memory buffer should be
          * aligned
          */
-        if (((uint32_t)membuf & (OS_ALIGNMENT - 1)) != 0) {
+        if (((uint32_t)membuf & (align - 1)) != 0) {
             return OS_MEM_NOT_ALIGNED;
         }
     }
-    true_block_size = OS_MEMPOOL_TRUE_BLOCK_SIZE(block_size);
+    true_block_size = OS_ALIGN(block_size, align);
 
     /* Initialize the memory pool structure */
     mp->mp_block_size = block_size;
     mp->mp_num_free = blocks;
+    mp->mp_min_free = blocks;
     mp->mp_num_blocks = blocks;
+    mp->mp_true_block_size = true_block_size;
     mp->mp_membuf_addr = (uint32_t)membuf;
     mp->name = name;
     SLIST_FIRST(mp) = membuf;
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+    SLIST_INIT(&mp->mp_listeners);
+#endif
 
     /* Chain the memory blocks to the free list */
     block_addr = (uint8_t *)membuf;
@@ -120,7 +299,7 @@ os_memblock_from(struct os_mempool *mp, void *block_addr)
                    "Pointer to void must be 32-bits.");
 
     baddr32 = (uint32_t)block_addr;
-    true_block_size = OS_MEMPOOL_TRUE_BLOCK_SIZE(mp->mp_block_size);
+    true_block_size = mp->mp_true_block_size;
     end = mp->mp_membuf_addr + (mp->mp_num_blocks * true_block_size);
 
     /* Check that the block is in the memory buffer range. */
@@ -165,13 +344,84 @@ os_memblock_get(struct os_mempool *mp)
 
             /* Decrement number free by 1 */
             mp->mp_num_free--;
+            if (mp->mp_num_free < mp->mp_min_free) {
+                mp->mp_min_free = mp->mp_num_free;
+            }
         }
         OS_EXIT_CRITICAL(sr);
     }
 
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+    if (block) {
+        os_mempool_trace_record(mp, block,
+                                (uintptr_t)__builtin_return_address(0));
+    }
+#endif
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+    if (block) {
+        os_mempool_pressure_check(mp);
+    }
+#endif
+
     return (void *)block;
 }
 
+/**
+ * os memblock get multi
+ *
+ * Get several memory blocks from a memory pool in a single critical
+ * section, instead of paying one interrupt mask/unmask cycle per block.
+ *
+ * @param mp Pointer to the memory pool
+ * @param blocks Array to fill with block pointers
+ * @param nblocks Number of blocks requested
+ *
+ * @return int Number of blocks actually obtained; may be less than
+ *             nblocks if the pool runs dry.
+ */
+int
+os_memblock_get_multi(struct os_mempool *mp, void **blocks, int nblocks)
+{
+    struct os_memblock *block;
+    os_sr_t sr;
+    int i;
+
+    if (!mp || !blocks) {
+        return (0);
+    }
+
+    i = 0;
+    OS_ENTER_CRITICAL(sr);
+    while (i < nblocks && mp->mp_num_free) {
+        block = SLIST_FIRST(mp);
+        SLIST_FIRST(mp) = SLIST_NEXT(block, mb_next);
+        mp->mp_num_free--;
+        blocks[i++] = block;
+    }
+    if (mp->mp_num_free < mp->mp_min_free) {
+        mp->mp_min_free = mp->mp_num_free;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+    {
+        int j;
+
+        for (j = 0; j < i; j++) {
+            os_mempool_trace_record(mp, blocks[j],
+                                    (uintptr_t)__builtin_return_address(0));
+        }
+    }
+#endif
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+    if (i > 0) {
+        os_mempool_pressure_check(mp);
+    }
+#endif
+
+    return (i);
+}
+
 /**
  * os memblock put
  *
@@ -211,6 +461,13 @@ os_memblock_put(struct os_mempool *mp, void *block_addr)
 
     OS_EXIT_CRITICAL(sr);
 
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+    os_mempool_trace_release(block_addr);
+#endif
+#if MYNEWT_VAL(OS_MEMPOOL_PRESSURE)
+    os_mempool_pressure_check(mp);
+#endif
+
     return OS_OK;
 }
 
@@ -233,6 +490,7 @@ os_mempool_info_get_next(struct os_mempool *mp, struct os_mempool_info *omi)
     omi->omi_block_size = cur->mp_block_size;
     omi->omi_num_blocks = cur->mp_num_blocks;
     omi->omi_num_free = cur->mp_num_free;
+    omi->omi_min_free = cur->mp_min_free;
     strncpy(omi->omi_name, cur->name, sizeof(omi->omi_name));
 
     return (cur);
@@ -48,6 +48,7 @@ os_mutex_init(struct os_mutex *mu)
 
     /* Initialize to 0 */
     mu->mu_prio = 0;
+    mu->mu_ceiling = 0;
     mu->mu_level = 0;
     mu->mu_owner = NULL;
     SLIST_FIRST(&mu->mu_head) = NULL;
@@ -55,6 +56,40 @@ os_mutex_init(struct os_mutex *mu)
     return OS_OK;
 }
 
+/**
+ * os mutex init ceiling
+ *
+ * Create a mutex with a priority ceiling.  While the mutex is held, the
+ * owner runs at least at priority 'prio', so lower priority holders can
+ * never stall a higher priority task for longer than the critical section
+ * itself.  Waiter-driven priority inheritance still applies on top of the
+ * ceiling.
+ *
+ * @param mu Pointer to mutex
+ * @param prio Ceiling priority; must not be OS_TASK_PRI_HIGHEST (0),
+ *             which is reserved to mean "no ceiling".
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Mutex passed in was NULL or prio was 0.
+ *      OS_OK               no error.
+ */
+os_error_t
+os_mutex_init_ceiling(struct os_mutex *mu, uint8_t prio)
+{
+    os_error_t rc;
+
+    if (prio == 0) {
+        return OS_INVALID_PARM;
+    }
+
+    rc = os_mutex_init(mu);
+    if (rc == OS_OK) {
+        mu->mu_ceiling = prio;
+    }
+
+    return rc;
+}
+
 /**
  * os mutex release
  *
@@ -108,13 +143,18 @@ os_mutex_release(struct os_mutex *mu)
     /* Check if tasks are waiting for the mutex */
     rdy = SLIST_FIRST(&mu->mu_head);
     if (rdy) {
+        /* Set mutex internals; remember the new owner's base priority and
+         * apply the ceiling, if any, before it is placed on the run list.
+         */
+        mu->mu_level = 1;
+        mu->mu_prio = rdy->t_prio;
+        if (mu->mu_ceiling != 0 && rdy->t_prio > mu->mu_ceiling) {
+            rdy->t_prio = mu->mu_ceiling;
+        }
+
         /* There is one waiting. Wake it up */
         assert(rdy->t_obj);
         os_sched_wakeup(rdy);
-
-        /* Set mutex internals */
-        mu->mu_level = 1;
-        mu->mu_prio = rdy->t_prio;
     }
 
     /* Set new owner of mutex (or NULL if not owned) */
@@ -188,6 +228,10 @@ os_mutex_pend(struct os_mutex *mu, uint32_t timeout)
         current->t_lockcnt++;
         current->t_flags |= OS_TASK_FLAG_LOCK_HELD;
         mu->mu_level = 1;
+        if (mu->mu_ceiling != 0 && current->t_prio > mu->mu_ceiling) {
+            current->t_prio = mu->mu_ceiling;
+            os_sched_resort(current);
+        }
         OS_EXIT_CRITICAL(sr);
         return OS_OK;
     }
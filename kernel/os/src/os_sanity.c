@@ -184,11 +184,51 @@ err:
     return (rc);
 }
 
+#if MYNEWT_VAL(OS_SANITY_EVENT_DRIVEN)
+/*
+ * Runs a single sanity check from the default event queue, at that check's
+ * own sc_checkin_itvl.  This spreads the work out over time and evaluates
+ * a stale check in O(1), rather than rescanning every check at once from
+ * the idle context.
+ */
+static void
+os_sanity_check_ev_cb(struct os_event *ev)
+{
+    struct os_sanity_check *sc;
+    int rc;
+
+    sc = ev->ev_arg;
+
+    rc = OS_OK;
+    if (sc->sc_func) {
+        rc = sc->sc_func(sc, sc->sc_arg);
+        if (rc == OS_OK) {
+            sc->sc_checkin_last = os_time_get();
+        }
+    }
+
+    if (!(sc->sc_func && rc == OS_OK)) {
+        if (OS_TIME_TICK_GT(os_time_get(),
+                    sc->sc_checkin_last + sc->sc_checkin_itvl)) {
+            assert(0);
+        }
+    }
+
+    os_callout_reset(&sc->sc_callout, sc->sc_checkin_itvl);
+}
+#endif
+
 /*
  * Called from the IDLE task context, every MYNEWT_VAL(SANITY_INTERVAL) msecs.
  *
  * Goes through the sanity check list, and performs sanity checks.  If any of
  * these checks failed, or tasks have not checked in, it resets the processor.
+ *
+ * When OS_SANITY_EVENT_DRIVEN is enabled, each check is migrated onto its
+ * own callout (once a default event queue exists) and its sc_func runs from
+ * there instead.  This loop then only keeps a staleness backstop on the
+ * migrated checks, so a wedged default event queue task is still caught
+ * before the idle task tickles the watchdog.
  */
 void
 os_sanity_run(void)
@@ -196,12 +236,38 @@ os_sanity_run(void)
     struct os_sanity_check *sc;
     int rc;
 
+#if MYNEWT_VAL(OS_TASK_STACK_GUARD)
+    os_task_stack_guard_check();
+#endif
+
     rc = os_sanity_check_list_lock();
     if (rc != 0) {
         assert(0);
     }
 
     SLIST_FOREACH(sc, &g_os_sanity_check_list, sc_next) {
+#if MYNEWT_VAL(OS_SANITY_EVENT_DRIVEN)
+        if (!sc->sc_armed) {
+            if (os_eventq_dflt_get() != NULL && sc->sc_checkin_itvl != 0) {
+                os_callout_init(&sc->sc_callout, os_eventq_dflt_get(),
+                        os_sanity_check_ev_cb, sc);
+                sc->sc_checkin_last = os_time_get();
+                os_callout_reset(&sc->sc_callout, sc->sc_checkin_itvl);
+                sc->sc_armed = 1;
+                continue;
+            }
+        } else {
+            /* The callout refreshes sc_checkin_last every interval; allow
+             * one interval of scheduling slack before declaring the event
+             * queue itself wedged.
+             */
+            if (OS_TIME_TICK_GT(os_time_get(),
+                        sc->sc_checkin_last + 2 * sc->sc_checkin_itvl)) {
+                assert(0);
+            }
+            continue;
+        }
+#endif
         rc = OS_OK;
 
         if (sc->sc_func) {
@@ -17,8 +17,17 @@
  * under the License.
  */
 
+#include "syscfg/syscfg.h"
 #include "os/os.h"
 #include "os/queue.h"
+#if MYNEWT_VAL(OS_TASK_CPUTIME) || MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+#include "os/os_cputime.h"
+#endif
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+#include "stats/stats.h"
+#endif
+#include "os/os_trace.h"
+#include "os_priv.h"
 
 #include <assert.h>
 
@@ -29,15 +38,239 @@
  *   @{
  */
 
-TAILQ_HEAD(, os_task) g_os_run_list = TAILQ_HEAD_INITIALIZER(g_os_run_list);
+struct os_task_list g_os_run_list = TAILQ_HEAD_INITIALIZER(g_os_run_list);
 
-TAILQ_HEAD(, os_task) g_os_sleep_list = TAILQ_HEAD_INITIALIZER(g_os_sleep_list);
+struct os_task_list g_os_sleep_list = TAILQ_HEAD_INITIALIZER(g_os_sleep_list);
 
 struct os_task *g_current_task;
 
+#if MYNEWT_VAL(OS_SCHED_EDF)
+/* An EDF class member only jumps the priority order while armed */
+#define OS_SCHED_EDF_ACTIVE(t)                                          \
+    (((t)->t_flags & (OS_TASK_FLAG_EDF | OS_TASK_FLAG_DEADLINE)) ==     \
+     (OS_TASK_FLAG_EDF | OS_TASK_FLAG_DEADLINE))
+#endif
+
 extern os_time_t g_os_time;
 os_time_t g_os_last_ctx_sw_time;
 
+#if MYNEWT_VAL(OS_SCHED_BITMAP)
+/*
+ * Bitmap-indexed ready queue.  Each priority below OS_SCHED_BITMAP_NPRIO - 1
+ * gets its own FIFO; all numerically higher (i.e. lower) priorities,
+ * including the idle task, share the final queue, which is kept sorted.  A
+ * word-wide mask of non-empty queues makes insertion and next-task selection
+ * O(1) via find-first-set.
+ *
+ * The head of g_os_run_list is kept pointing at the highest priority ready
+ * task since the architecture specific context switch code loads the run
+ * list head directly.
+ */
+#define OS_SCHED_NPRIO      MYNEWT_VAL(OS_SCHED_BITMAP_NPRIO)
+
+#if OS_SCHED_NPRIO > 32
+typedef uint64_t os_sched_mask_t;
+#define OS_SCHED_FFS(mask)  __builtin_ctzll(mask)
+#else
+typedef uint32_t os_sched_mask_t;
+#define OS_SCHED_FFS(mask)  __builtin_ctz(mask)
+#endif
+
+static struct os_task_list g_os_ready_q[OS_SCHED_NPRIO];
+static os_sched_mask_t g_os_ready_mask;
+
+static int
+os_sched_prio_bucket(uint8_t prio)
+{
+    return (prio < OS_SCHED_NPRIO - 1 ? prio : OS_SCHED_NPRIO - 1);
+}
+
+static void
+os_sched_refresh_run_head(void)
+{
+    struct os_task *t;
+
+    if (g_os_ready_mask == 0) {
+        t = NULL;
+    } else {
+        t = TAILQ_FIRST(&g_os_ready_q[OS_SCHED_FFS(g_os_ready_mask)]);
+    }
+    g_os_run_list.tqh_first = t;
+}
+#endif
+
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+/*
+ * Timed sleepers live in an intrusive pairing heap keyed on t_next_wakeup,
+ * so arming a sleep is O(1) and the tick handler only ever looks at the
+ * heap root; tasks sleeping with OS_TIMEOUT_NEVER stay on g_os_sleep_list,
+ * which then needs no ordering.  t_ph_prev points at the parent for a
+ * first child and at the left sibling otherwise.
+ */
+static struct os_task *g_os_sleep_heap;
+
+STATS_SECT_START(os_sched_stats)
+    STATS_SECT_ENTRY(tick_max_cputime)
+STATS_SECT_END
+
+STATS_SECT_DECL(os_sched_stats) g_os_sched_stats;
+
+STATS_NAME_START(os_sched_stats)
+    STATS_NAME(os_sched_stats, tick_max_cputime)
+STATS_NAME_END(os_sched_stats)
+
+/* Meld two non-NULL heaps; the earlier wakeup becomes the root */
+static struct os_task *
+os_sched_ph_meld(struct os_task *a, struct os_task *b)
+{
+    struct os_task *tmp;
+
+    if (OS_TIME_TICK_GT(a->t_next_wakeup, b->t_next_wakeup)) {
+        tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    b->t_ph_prev = a;
+    b->t_ph_sibling = a->t_ph_child;
+    if (a->t_ph_child) {
+        a->t_ph_child->t_ph_prev = b;
+    }
+    a->t_ph_child = b;
+
+    return (a);
+}
+
+/* Two-pass merge of a sibling list, used when a node is deleted */
+static struct os_task *
+os_sched_ph_merge_pairs(struct os_task *n)
+{
+    struct os_task *paired;
+    struct os_task *rest;
+    struct os_task *a;
+    struct os_task *b;
+
+    paired = NULL;
+    while (n) {
+        a = n;
+        b = a->t_ph_sibling;
+        if (b) {
+            rest = b->t_ph_sibling;
+            a->t_ph_sibling = NULL;
+            b->t_ph_sibling = NULL;
+            a = os_sched_ph_meld(a, b);
+        } else {
+            rest = NULL;
+        }
+        a->t_ph_sibling = paired;
+        paired = a;
+        n = rest;
+    }
+
+    a = NULL;
+    while (paired) {
+        b = paired;
+        paired = paired->t_ph_sibling;
+        b->t_ph_sibling = NULL;
+        a = (a == NULL) ? b : os_sched_ph_meld(a, b);
+    }
+    if (a) {
+        a->t_ph_prev = NULL;
+    }
+
+    return (a);
+}
+
+static void
+os_sched_sleep_heap_insert(struct os_task *t)
+{
+    t->t_ph_child = NULL;
+    t->t_ph_sibling = NULL;
+    t->t_ph_prev = NULL;
+    if (g_os_sleep_heap) {
+        g_os_sleep_heap = os_sched_ph_meld(g_os_sleep_heap, t);
+        g_os_sleep_heap->t_ph_prev = NULL;
+    } else {
+        g_os_sleep_heap = t;
+    }
+}
+
+static void
+os_sched_sleep_heap_remove(struct os_task *t)
+{
+    struct os_task *sub;
+
+    sub = os_sched_ph_merge_pairs(t->t_ph_child);
+    if (t == g_os_sleep_heap) {
+        g_os_sleep_heap = sub;
+    } else {
+        if (t->t_ph_prev->t_ph_child == t) {
+            t->t_ph_prev->t_ph_child = t->t_ph_sibling;
+        } else {
+            t->t_ph_prev->t_ph_sibling = t->t_ph_sibling;
+        }
+        if (t->t_ph_sibling) {
+            t->t_ph_sibling->t_ph_prev = t->t_ph_prev;
+        }
+        if (sub) {
+            g_os_sleep_heap = os_sched_ph_meld(g_os_sleep_heap, sub);
+        }
+    }
+    if (g_os_sleep_heap) {
+        g_os_sleep_heap->t_ph_prev = NULL;
+    }
+
+    t->t_ph_child = NULL;
+    t->t_ph_sibling = NULL;
+    t->t_ph_prev = NULL;
+}
+#endif /* MYNEWT_VAL(OS_SCHED_SLEEP_HEAP) */
+
+/**
+ * os sched init
+ *
+ * Initializes the scheduler lists. Called early, before any tasks are
+ * created.
+ */
+void
+os_sched_init(void)
+{
+#if MYNEWT_VAL(OS_SCHED_BITMAP)
+    int i;
+
+    for (i = 0; i < OS_SCHED_NPRIO; i++) {
+        TAILQ_INIT(&g_os_ready_q[i]);
+    }
+    g_os_ready_mask = 0;
+#endif
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    g_os_sleep_heap = NULL;
+#endif
+    TAILQ_INIT(&g_os_run_list);
+    TAILQ_INIT(&g_os_sleep_list);
+}
+
+/*
+ * Remove a task from the ready queue. Must be called with interrupts
+ * disabled.
+ */
+static void
+os_sched_run_remove(struct os_task *t)
+{
+#if MYNEWT_VAL(OS_SCHED_BITMAP)
+    int bucket;
+
+    bucket = os_sched_prio_bucket(t->t_prio);
+    TAILQ_REMOVE(&g_os_ready_q[bucket], t, t_os_list);
+    if (TAILQ_EMPTY(&g_os_ready_q[bucket])) {
+        g_os_ready_mask &= ~((os_sched_mask_t)1 << bucket);
+    }
+    os_sched_refresh_run_head();
+#else
+    TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+#endif
+}
+
 /**
  * os sched insert
  *
@@ -63,7 +296,55 @@ os_sched_insert(struct os_task *t)
 
     entry = NULL;
     OS_ENTER_CRITICAL(sr);
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+    /* Stamp readiness; zero doubles as "not set", so avoid it */
+    t->t_ready_cputime = os_cputime_get32();
+    if (t->t_ready_cputime == 0) {
+        t->t_ready_cputime = 1;
+    }
+#endif
+#if MYNEWT_VAL(OS_SCHED_BITMAP)
+    {
+        int bucket;
+
+        bucket = os_sched_prio_bucket(t->t_prio);
+        if (bucket < OS_SCHED_NPRIO - 1) {
+            TAILQ_INSERT_TAIL(&g_os_ready_q[bucket], t, t_os_list);
+        } else {
+            /* Overflow queue holds all remaining priorities, sorted. */
+            TAILQ_FOREACH(entry, &g_os_ready_q[bucket], t_os_list) {
+                if (t->t_prio < entry->t_prio) {
+                    break;
+                }
+            }
+            if (entry) {
+                TAILQ_INSERT_BEFORE(entry, t, t_os_list);
+            } else {
+                TAILQ_INSERT_TAIL(&g_os_ready_q[bucket], t, t_os_list);
+            }
+        }
+        g_os_ready_mask |= (os_sched_mask_t)1 << bucket;
+        os_sched_refresh_run_head();
+    }
+#else
     TAILQ_FOREACH(entry, &g_os_run_list, t_os_list) {
+#if MYNEWT_VAL(OS_SCHED_EDF)
+        /*
+         * EDF class members with an armed deadline occupy the front of
+         * the run list, earliest deadline first; everything else sorts
+         * by fixed priority behind them.
+         */
+        if (OS_SCHED_EDF_ACTIVE(t)) {
+            if (!OS_SCHED_EDF_ACTIVE(entry) ||
+                OS_TIME_TICK_GT(entry->t_deadline, t->t_deadline)) {
+                break;
+            }
+            continue;
+        }
+        if (OS_SCHED_EDF_ACTIVE(entry)) {
+            continue;
+        }
+#endif
         if (t->t_prio < entry->t_prio) {
             break;
         }
@@ -73,6 +354,7 @@ os_sched_insert(struct os_task *t)
     } else {
         TAILQ_INSERT_TAIL(&g_os_run_list, (struct os_task *) t, t_os_list);
     }
+#endif
     OS_EXIT_CRITICAL(sr);
 
     return (0);
@@ -80,16 +362,40 @@ err:
     return (rc);
 }
 
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+static uint32_t g_os_last_ctx_sw_cputime;
+#endif
+
 void
 os_sched_ctx_sw_hook(struct os_task *next_t)
 {
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+    uint32_t now;
+    uint32_t latency;
+#endif
+
     if (g_current_task == next_t) {
         return;
     }
 
+    OS_TRACE_EVENT(OS_TRACE_ID_CTX_SW, next_t->t_prio);
+
     next_t->t_ctx_sw_cnt++;
     g_current_task->t_run_time += g_os_time - g_os_last_ctx_sw_time;
     g_os_last_ctx_sw_time = g_os_time;
+
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+    now = os_cputime_get32();
+    g_current_task->t_cputime += now - g_os_last_ctx_sw_cputime;
+    g_os_last_ctx_sw_cputime = now;
+    if (next_t->t_ready_cputime != 0) {
+        latency = now - next_t->t_ready_cputime;
+        if (latency > next_t->t_sched_latency_max) {
+            next_t->t_sched_latency_max = latency;
+        }
+        next_t->t_ready_cputime = 0;
+    }
+#endif
 }
 
 
@@ -170,12 +476,18 @@ os_sched_sleep(struct os_task *t, os_time_t nticks)
 
     entry = NULL;
 
-    TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+    os_sched_run_remove(t);
     t->t_state = OS_TASK_SLEEP;
     t->t_next_wakeup = os_time_get() + nticks;
     if (nticks == OS_TIMEOUT_NEVER) {
         t->t_flags |= OS_TASK_FLAG_NO_TIMEOUT;
         TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    } else {
+        os_sched_sleep_heap_insert(t);
+    }
+    (void)entry;
+#else
     } else {
         TAILQ_FOREACH(entry, &g_os_sleep_list, t_os_list) {
             if ((entry->t_flags & OS_TASK_FLAG_NO_TIMEOUT) ||
@@ -189,6 +501,7 @@ os_sched_sleep(struct os_task *t, os_time_t nticks)
             TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
         }
     }
+#endif
 
     return (0);
 }
@@ -211,9 +524,17 @@ os_sched_suspend(struct os_task *t)
 {
 
     if (t->t_state == OS_TASK_SLEEP) {
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+        if (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT) {
+            TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+        } else {
+            os_sched_sleep_heap_remove(t);
+        }
+#else
         TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+#endif
     } else if (t->t_state == OS_TASK_READY) {
-        TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+        os_sched_run_remove(t);
     }
     t->t_state = OS_TASK_SUSPEND;
     t->t_next_wakeup = 0;
@@ -253,8 +574,16 @@ os_sched_wakeup(struct os_task *t)
     /* Remove task from sleep list */
     t->t_state = OS_TASK_READY;
     t->t_next_wakeup = 0;
-    t->t_flags &= ~OS_TASK_FLAG_NO_TIMEOUT;
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    if (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT) {
+        TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+    } else {
+        os_sched_sleep_heap_remove(t);
+    }
+#else
     TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+#endif
+    t->t_flags &= ~OS_TASK_FLAG_NO_TIMEOUT;
     os_sched_insert(t);
 
     return (0);
@@ -273,7 +602,13 @@ void
 os_sched_os_timer_exp(void)
 {
     struct os_task *t;
+#if !MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
     struct os_task *next;
+#else
+    static uint8_t stats_registered;
+    uint32_t start;
+    uint32_t dur;
+#endif
     os_time_t now;
     os_sr_t sr;
 
@@ -281,6 +616,33 @@ os_sched_os_timer_exp(void)
 
     OS_ENTER_CRITICAL(sr);
 
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    /* Register here rather than at os_sched_init(), which runs before the
+     * stats module is initialized.
+     */
+    if (!stats_registered) {
+        stats_registered = 1;
+        stats_init_and_reg(STATS_HDR(g_os_sched_stats),
+            STATS_SIZE_INIT_PARMS(g_os_sched_stats, STATS_SIZE_32),
+            STATS_NAME_INIT_PARMS(os_sched_stats), "os_sched");
+    }
+
+    start = os_cputime_get32();
+
+    /*
+     * Wakeup any tasks that have their sleep timer expired; only the heap
+     * root ever needs examining.
+     */
+    while ((t = g_os_sleep_heap) != NULL &&
+           OS_TIME_TICK_GEQ(now, t->t_next_wakeup)) {
+        os_sched_wakeup(t);
+    }
+
+    dur = os_cputime_get32() - start;
+    if (dur > g_os_sched_stats.stick_max_cputime) {
+        g_os_sched_stats.stick_max_cputime = dur;
+    }
+#else
     /*
      * Wakeup any tasks that have their sleep timer expired
      */
@@ -298,6 +660,7 @@ os_sched_os_timer_exp(void)
         }
         t = next;
     }
+#endif
 
     OS_EXIT_CRITICAL(sr);
 }
@@ -314,7 +677,11 @@ os_sched_wakeup_ticks(os_time_t now)
 
     OS_ASSERT_CRITICAL();
 
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    t = g_os_sleep_heap;
+#else
     t = TAILQ_FIRST(&g_os_sleep_list);
+#endif
     if (t == NULL || (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT)) {
         rt = OS_TIMEOUT_NEVER;
     } else if (OS_TIME_TICK_GEQ(t->t_next_wakeup, now)) {
@@ -359,7 +726,7 @@ void
 os_sched_resort(struct os_task *t)
 {
     if (t->t_state == OS_TASK_READY) {
-        TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+        os_sched_run_remove(t);
         os_sched_insert(t);
     }
 }
@@ -55,6 +55,10 @@ os_sem_init(struct os_sem *sem, uint16_t tokens)
 
     sem->sem_tokens = tokens;
     SLIST_FIRST(&sem->sem_head) = NULL;
+#if MYNEWT_VAL(OS_SEM_STATS)
+    sem->sem_blocked_cnt = 0;
+    sem->sem_resched_cnt = 0;
+#endif
 
     return OS_OK;
 }
@@ -104,9 +108,15 @@ os_sem_release(struct os_sem *sem)
         rdy->t_flags |= OS_TASK_FLAG_LOCK_HELD;
         os_sched_wakeup(rdy);
 
-        /* Schedule if waiting task higher priority */
-        if (current->t_prio > rdy->t_prio) {
+        /* Only re-enter the scheduler if waking the task actually changed
+         * the highest priority ready task; with frequent producer signals
+         * the consumer usually isn't blocked and this stays false.
+         */
+        if (os_sched_next_task() != current) {
             resched = 1;
+#if MYNEWT_VAL(OS_SEM_STATS)
+            sem->sem_resched_cnt++;
+#endif
         }
     } else {
         /* Add to the number of tokens */
@@ -118,9 +128,87 @@ os_sem_release(struct os_sem *sem)
 
     OS_EXIT_CRITICAL(sr);
 
-    /* Re-schedule if needed */
+    /* Re-schedule if needed; let the scheduler pick the run list head in
+     * case something higher priority than the woken task is also ready.
+     */
+    if (resched) {
+        os_sched(NULL);
+    }
+
+    return OS_OK;
+}
+
+/**
+ * os sem release n
+ *
+ * Release several semaphore tokens under a single critical section, for
+ * batched producer signaling (e.g. a driver completing a burst of
+ * buffers).  Equivalent to calling os_sem_release() 'tokens' times but
+ * wakes all eligible waiters before deciding, once, whether to
+ * re-schedule.
+ *
+ * @param sem Pointer to the semaphore to be released
+ * @param tokens Number of tokens to release
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM Semaphore passed in was NULL.
+ *      OS_OK No error
+ */
+os_error_t
+os_sem_release_n(struct os_sem *sem, uint16_t tokens)
+{
+    int resched;
+    os_sr_t sr;
+    struct os_task *current;
+    struct os_task *rdy;
+
+    /* OS must be started to release semaphores */
+    if (!g_os_started) {
+        return (OS_NOT_STARTED);
+    }
+
+    /* Check for valid semaphore */
+    if (!sem) {
+        return OS_INVALID_PARM;
+    }
+
+    resched = 0;
+    current = os_sched_get_current_task();
+
+    OS_ENTER_CRITICAL(sr);
+
+    current->t_lockcnt -= tokens;
+    if (current->t_lockcnt == 0) {
+        current->t_flags &= ~OS_TASK_FLAG_LOCK_HELD;
+    }
+
+    while (tokens != 0) {
+        rdy = SLIST_FIRST(&sem->sem_head);
+        if (!rdy) {
+            /* No one left waiting; bank the remainder */
+            sem->sem_tokens += tokens;
+            break;
+        }
+
+        rdy->t_flags &= ~OS_TASK_FLAG_SEM_WAIT;
+        rdy->t_lockcnt++;
+        rdy->t_flags |= OS_TASK_FLAG_LOCK_HELD;
+        os_sched_wakeup(rdy);
+
+        tokens--;
+    }
+
+    if (os_sched_next_task() != current) {
+        resched = 1;
+#if MYNEWT_VAL(OS_SEM_STATS)
+        sem->sem_resched_cnt++;
+#endif
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
     if (resched) {
-        os_sched(rdy);
+        os_sched(NULL);
     }
 
     return OS_OK;
@@ -184,6 +272,9 @@ os_sem_pend(struct os_sem *sem, uint32_t timeout)
         rc = OS_OK;
 
         /* Link current task to tasks waiting for semaphore */
+#if MYNEWT_VAL(OS_SEM_STATS)
+        sem->sem_blocked_cnt++;
+#endif
         current->t_obj = sem;
         current->t_flags |= OS_TASK_FLAG_SEM_WAIT;
         last = NULL;
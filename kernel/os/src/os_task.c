@@ -202,6 +202,140 @@ os_task_suspend(struct os_task *t)
     return rc;
 }
 
+/**
+ * Sample a task's stack high-water mark: the number of stack elements
+ * that have ever been written since the stack was painted with
+ * OS_STACK_PATTERN at os_task_init() time.
+ *
+ * @param t Task whose stack to examine
+ *
+ * @return Stack elements used, out of t_stacksize
+ */
+uint16_t
+os_task_stack_usage(const struct os_task *t)
+{
+    os_stack_t *top;
+    os_stack_t *bottom;
+
+    top = t->t_stacktop;
+    bottom = t->t_stacktop - t->t_stacksize;
+    while (bottom < top) {
+        if (*bottom != OS_STACK_PATTERN) {
+            break;
+        }
+        ++bottom;
+    }
+
+    return (uint16_t) (t->t_stacktop - bottom);
+}
+
+#if MYNEWT_VAL(OS_TASK_STACK_GUARD)
+/**
+ * Verify that the guard zone at the bottom of every task's stack still
+ * holds the paint pattern.  Called periodically from the sanity check
+ * in the idle task; a clobbered guard word means a task has overrun
+ * (or is about to overrun) its stack, which is fatal.
+ */
+void
+os_task_stack_guard_check(void)
+{
+    struct os_task *t;
+    os_stack_t *bottom;
+    int i;
+
+    STAILQ_FOREACH(t, &g_os_task_list, t_os_task_list) {
+        bottom = t->t_stacktop - t->t_stacksize;
+        for (i = 0; i < MYNEWT_VAL(OS_TASK_STACK_GUARD_WORDS); i++) {
+            assert(bottom[i] == OS_STACK_PATTERN);
+        }
+    }
+}
+#endif
+
+#if MYNEWT_VAL(OS_SCHED_EDF)
+/**
+ * Place a task in, or remove it from, the EDF scheduling class.
+ *
+ * @param t      Task to modify
+ * @param enable 1 to join the class, 0 to leave it
+ *
+ * @return OS_OK on success
+ */
+int
+os_task_edf_set(struct os_task *t, int enable)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (enable) {
+        t->t_flags |= OS_TASK_FLAG_EDF;
+    } else {
+        t->t_flags &= ~(OS_TASK_FLAG_EDF | OS_TASK_FLAG_DEADLINE);
+    }
+    os_sched_resort(t);
+    OS_EXIT_CRITICAL(sr);
+    if (os_started()) {
+        os_sched(NULL);
+    }
+
+    return OS_OK;
+}
+
+/**
+ * Arm the absolute deadline for the task's current activation.  If the
+ * previous deadline was still armed and has passed, it is counted as a
+ * miss.  Typically called by the task on itself at the start of each
+ * periodic activation.
+ *
+ * @param t        Task whose deadline to arm
+ * @param deadline Absolute deadline, in os time ticks
+ */
+void
+os_task_deadline_set(struct os_task *t, os_time_t deadline)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if ((t->t_flags & OS_TASK_FLAG_DEADLINE) &&
+        OS_TIME_TICK_GT(os_time_get(), t->t_deadline)) {
+        t->t_deadline_misses++;
+    }
+    t->t_deadline = deadline;
+    t->t_flags |= OS_TASK_FLAG_DEADLINE;
+    os_sched_resort(t);
+    OS_EXIT_CRITICAL(sr);
+    if (os_started()) {
+        os_sched(NULL);
+    }
+}
+
+/**
+ * Retire the task's armed deadline at the end of an activation; counts
+ * a miss if the deadline has already passed.  The task then schedules
+ * by its fixed priority until the next os_task_deadline_set().
+ *
+ * @param t Task whose deadline to retire
+ */
+void
+os_task_deadline_clear(struct os_task *t)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (t->t_flags & OS_TASK_FLAG_DEADLINE) {
+        if (OS_TIME_TICK_GT(os_time_get(), t->t_deadline)) {
+            t->t_deadline_misses++;
+        }
+        t->t_flags &= ~OS_TASK_FLAG_DEADLINE;
+        os_sched_resort(t);
+    }
+    OS_EXIT_CRITICAL(sr);
+    if (os_started()) {
+        os_sched(NULL);
+    }
+}
+#endif /* MYNEWT_VAL(OS_SCHED_EDF) */
+
 /**
  * Iterate through tasks, and return the following information about them:
  *
@@ -236,8 +370,6 @@ struct os_task *
 os_task_info_get_next(const struct os_task *prev, struct os_task_info *oti)
 {
     struct os_task *next;
-    os_stack_t *top;
-    os_stack_t *bottom;
 
     if (prev != NULL) {
         next = STAILQ_NEXT(prev, t_os_task_list);
@@ -256,19 +388,14 @@ os_task_info_get_next(const struct os_task *prev, struct os_task_info *oti)
     oti->oti_taskid = next->t_taskid;
     oti->oti_state = next->t_state;
 
-    top = next->t_stacktop;
-    bottom = next->t_stacktop - next->t_stacksize;
-    while (bottom < top) {
-        if (*bottom != OS_STACK_PATTERN) {
-            break;
-        }
-        ++bottom;
-    }
-
-    oti->oti_stkusage = (uint16_t) (next->t_stacktop - bottom);
+    oti->oti_stkusage = os_task_stack_usage(next);
     oti->oti_stksize = next->t_stacksize;
     oti->oti_cswcnt = next->t_ctx_sw_cnt;
     oti->oti_runtime = next->t_run_time;
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+    oti->oti_cputime = next->t_cputime;
+    oti->oti_max_sched_latency = next->t_sched_latency_max;
+#endif
     oti->oti_last_checkin = next->t_sanity_check.sc_checkin_last;
     oti->oti_next_checkin = next->t_sanity_check.sc_checkin_last +
         next->t_sanity_check.sc_checkin_itvl;
@@ -108,6 +108,9 @@ os_time_advance(int ticks)
         } else {
             os_time_tick(ticks);
             os_callout_tick();
+#if MYNEWT_VAL(OS_EVENTQ_COALESCE)
+            os_eventq_coalesce_tick();
+#endif
             os_sched_os_timer_exp();
             os_sched(NULL);
         }
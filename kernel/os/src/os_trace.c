@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(OS_TRACE)
+
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "os/os_trace.h"
+
+/*
+ * The ring size must be a power of two so the write index can wrap
+ * with a mask; records are overwritten oldest-first when it fills.
+ */
+#define OS_TRACE_NUM_RECORDS    MYNEWT_VAL(OS_TRACE_NUM_RECORDS)
+#define OS_TRACE_MASK           (OS_TRACE_NUM_RECORDS - 1)
+
+static struct os_trace_record os_trace_ring[OS_TRACE_NUM_RECORDS];
+static uint32_t os_trace_widx;
+
+void
+os_trace_add(uint32_t ev)
+{
+    struct os_trace_record *rec;
+    os_sr_t sr;
+
+    /*
+     * Reserve a slot with interrupts off; the window is a handful of
+     * cycles, so tracing is safe from any context including ISRs.
+     */
+    OS_ENTER_CRITICAL(sr);
+    rec = &os_trace_ring[os_trace_widx & OS_TRACE_MASK];
+    os_trace_widx++;
+    OS_EXIT_CRITICAL(sr);
+
+    rec->otr_ev = ev;
+    rec->otr_cputime = os_cputime_get32();
+}
+
+int
+os_trace_walk(os_trace_walk_func_t walk_func, void *arg)
+{
+    const struct os_trace_record *rec;
+    uint32_t widx;
+    uint32_t idx;
+    uint32_t cnt;
+    int rc;
+
+    widx = os_trace_widx;
+    if (widx > OS_TRACE_NUM_RECORDS) {
+        cnt = OS_TRACE_NUM_RECORDS;
+        idx = widx - OS_TRACE_NUM_RECORDS;
+    } else {
+        cnt = widx;
+        idx = 0;
+    }
+
+    for (; cnt > 0; cnt--, idx++) {
+        rec = &os_trace_ring[idx & OS_TRACE_MASK];
+        rc = walk_func(rec, arg);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+#endif /* MYNEWT_VAL(OS_TRACE) */
@@ -0,0 +1,222 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(OS_WORKQ)
+
+#include <assert.h>
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "os/os_workq.h"
+
+struct os_workq_lane {
+    struct os_eventq wql_evq;
+    uint16_t wql_pending;
+    uint32_t wql_oldest;        /* cputime when the lane head was queued */
+    struct os_workq_lane_stats wql_stats;
+};
+
+static struct os_workq_lane os_workq_lanes[MYNEWT_VAL(OS_WORKQ_LANES)];
+
+static struct os_task os_workq_task;
+static os_stack_t os_workq_stack[OS_STACK_ALIGN(MYNEWT_VAL(OS_WORKQ_STACK_SIZE))];
+
+static void
+os_workq_dispatch(struct os_workq_lane *wql, struct os_event *ev)
+{
+    uint32_t start;
+    uint32_t ticks;
+    os_sr_t sr;
+
+    start = os_cputime_get32();
+
+    OS_ENTER_CRITICAL(sr);
+    if (wql->wql_pending > 0) {
+        ticks = start - wql->wql_oldest;
+        wql->wql_pending--;
+        wql->wql_oldest = start;
+        wql->wql_stats.owl_wait_ticks += ticks;
+        if (ticks > wql->wql_stats.owl_wait_max) {
+            wql->wql_stats.owl_wait_max = ticks;
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    assert(ev->ev_cb != NULL);
+    ev->ev_cb(ev);
+
+    ticks = os_cputime_get32() - start;
+    wql->wql_stats.owl_events++;
+    wql->wql_stats.owl_run_ticks += ticks;
+    if (ticks > wql->wql_stats.owl_run_max) {
+        wql->wql_stats.owl_run_max = ticks;
+    }
+}
+
+/*
+ * Block until any lane has an event, then dequeue the one from the
+ * highest-priority non-empty lane.  Mirrors os_eventq_poll(), but
+ * reports which lane the event came from; the worker owns the lane
+ * queues, so events can also arrive via plain os_eventq_put() (e.g.
+ * from callouts and mqueues targeting a lane).
+ */
+static struct os_event *
+os_workq_get_any(int *lanep)
+{
+    struct os_eventq *evq;
+    struct os_event *ev;
+    struct os_task *t;
+    os_sr_t sr;
+    int i;
+    int j;
+
+    OS_ENTER_CRITICAL(sr);
+    t = os_sched_get_current_task();
+    while (1) {
+        for (i = 0; i < MYNEWT_VAL(OS_WORKQ_LANES); i++) {
+            evq = &os_workq_lanes[i].wql_evq;
+            ev = STAILQ_FIRST(&evq->evq_list);
+            if (ev) {
+                STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
+                ev->ev_queued = 0;
+                for (j = 0; j < i; j++) {
+                    os_workq_lanes[j].wql_evq.evq_task = NULL;
+                }
+                *lanep = i;
+                OS_EXIT_CRITICAL(sr);
+                return ev;
+            }
+            evq->evq_task = t;
+        }
+
+        t->t_flags |= OS_TASK_FLAG_EVQ_WAIT;
+        os_sched_sleep(t, OS_TIMEOUT_NEVER);
+        OS_EXIT_CRITICAL(sr);
+
+        os_sched(NULL);
+
+        OS_ENTER_CRITICAL(sr);
+        t->t_flags &= ~OS_TASK_FLAG_EVQ_WAIT;
+        for (i = 0; i < MYNEWT_VAL(OS_WORKQ_LANES); i++) {
+            os_workq_lanes[i].wql_evq.evq_task = NULL;
+        }
+    }
+}
+
+static void
+os_workq_task_func(void *arg)
+{
+    struct os_workq_lane *wql;
+    struct os_event *ev;
+    int budget;
+    int again;
+    int i;
+
+    while (1) {
+        ev = os_workq_get_any(&i);
+        os_workq_dispatch(&os_workq_lanes[i], ev);
+
+        /*
+         * Drain passes, lane 0 first.  A pass dispatches at most
+         * OS_WORKQ_LANE_BUDGET events per lane; work left behind by
+         * the budget is picked up on the next pass, after higher
+         * lanes have been serviced again.
+         */
+        do {
+            again = 0;
+            for (i = 0; i < MYNEWT_VAL(OS_WORKQ_LANES); i++) {
+                wql = &os_workq_lanes[i];
+                budget = MYNEWT_VAL(OS_WORKQ_LANE_BUDGET);
+                while (budget > 0) {
+                    ev = os_eventq_get_no_wait(&wql->wql_evq);
+                    if (!ev) {
+                        break;
+                    }
+                    os_workq_dispatch(wql, ev);
+                    budget--;
+                }
+                if (budget == 0 && !STAILQ_EMPTY(&wql->wql_evq.evq_list)) {
+                    wql->wql_stats.owl_deferrals++;
+                    again = 1;
+                }
+            }
+        } while (again);
+    }
+}
+
+int
+os_workq_init(uint8_t task_prio)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(OS_WORKQ_LANES); i++) {
+        os_eventq_init(&os_workq_lanes[i].wql_evq);
+    }
+    rc = os_task_init(&os_workq_task, "workq", os_workq_task_func, NULL,
+      task_prio, OS_WAIT_FOREVER, os_workq_stack,
+      OS_STACK_ALIGN(MYNEWT_VAL(OS_WORKQ_STACK_SIZE)));
+    return rc;
+}
+
+void
+os_workq_put(int lane, struct os_event *ev)
+{
+    struct os_workq_lane *wql;
+    os_sr_t sr;
+    int queued;
+
+    assert(lane >= 0 && lane < MYNEWT_VAL(OS_WORKQ_LANES));
+    wql = &os_workq_lanes[lane];
+
+    OS_ENTER_CRITICAL(sr);
+    /* os_eventq_put() ignores an already-queued event; mirror that */
+    queued = !OS_EVENT_QUEUED(ev);
+    if (queued) {
+        if (wql->wql_pending == 0) {
+            wql->wql_oldest = os_cputime_get32();
+        }
+        wql->wql_pending++;
+    }
+    os_eventq_put(&wql->wql_evq, ev);
+    OS_EXIT_CRITICAL(sr);
+}
+
+struct os_eventq *
+os_workq_lane_evq(int lane)
+{
+    assert(lane >= 0 && lane < MYNEWT_VAL(OS_WORKQ_LANES));
+    return &os_workq_lanes[lane].wql_evq;
+}
+
+struct os_task *
+os_workq_task_get(void)
+{
+    return &os_workq_task;
+}
+
+const struct os_workq_lane_stats *
+os_workq_lane_stats_get(int lane)
+{
+    assert(lane >= 0 && lane < MYNEWT_VAL(OS_WORKQ_LANES));
+    return &os_workq_lanes[lane].wql_stats;
+}
+
+#endif /* MYNEWT_VAL(OS_WORKQ) */
@@ -86,6 +86,7 @@ TEST_CASE_DECL(event_test_poll_sr)
 TEST_CASE_DECL(event_test_poll_timeout_sr)
 TEST_CASE_DECL(event_test_poll_single_sr)
 TEST_CASE_DECL(event_test_poll_0timo)
+TEST_CASE_DECL(event_test_get_no_wait)
 
 /* This is the task function  to send data */
 void
@@ -270,4 +271,5 @@ TEST_SUITE(os_eventq_test_suite)
     event_test_poll_timeout_sr();
     event_test_poll_single_sr();
     event_test_poll_0timo();
+    event_test_get_no_wait();
 }
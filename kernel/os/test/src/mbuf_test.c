@@ -102,6 +102,7 @@ TEST_CASE_DECL(os_mbuf_test_pullup)
 TEST_CASE_DECL(os_mbuf_test_extend)
 TEST_CASE_DECL(os_mbuf_test_adj)
 TEST_CASE_DECL(os_mbuf_test_get_pkthdr)
+TEST_CASE_DECL(os_msys_group_test)
 
 TEST_SUITE(os_mbuf_test_suite)
 {
@@ -112,4 +113,5 @@ TEST_SUITE(os_mbuf_test_suite)
     os_mbuf_test_extend();
     os_mbuf_test_adj();
     os_mbuf_test_get_pkthdr();
+    os_msys_group_test();
 }
@@ -0,0 +1,53 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+/**
+ * Tests os_eventq_get_no_wait().  This never involves the scheduler,
+ * so it should work without starting the OS.
+ */
+TEST_CASE(event_test_get_no_wait)
+{
+    struct os_eventq evq;
+    struct os_event *evp;
+    struct os_event ev1;
+    struct os_event ev2;
+
+    os_eventq_init(&evq);
+
+    /* Empty queue returns NULL rather than blocking. */
+    evp = os_eventq_get_no_wait(&evq);
+    TEST_ASSERT(evp == NULL);
+
+    memset(&ev1, 0, sizeof ev1);
+    memset(&ev2, 0, sizeof ev2);
+    os_eventq_put(&evq, &ev1);
+    os_eventq_put(&evq, &ev2);
+
+    /* Events come back in FIFO order and are dequeued. */
+    evp = os_eventq_get_no_wait(&evq);
+    TEST_ASSERT(evp == &ev1);
+    TEST_ASSERT(!OS_EVENT_QUEUED(&ev1));
+
+    evp = os_eventq_get_no_wait(&evq);
+    TEST_ASSERT(evp == &ev2);
+
+    evp = os_eventq_get_no_wait(&evq);
+    TEST_ASSERT(evp == NULL);
+}
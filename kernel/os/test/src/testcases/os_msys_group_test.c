@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+TEST_CASE(os_msys_group_test)
+{
+    struct os_msys_group grp_rsvd;
+    struct os_msys_group grp_capped;
+    struct os_mbuf *capped_ms[3];
+    struct os_mbuf *plain_ms[MBUF_TEST_POOL_BUF_COUNT];
+    struct os_mbuf *rsvd_ms[2];
+    struct os_mbuf *m;
+    int num_plain;
+    int rc;
+    int i;
+
+    os_mbuf_test_setup();
+
+    os_msys_reset();
+    rc = os_msys_register(&os_mbuf_pool);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* A cap below the guarantee is rejected. */
+    rc = os_msys_group_register(&grp_rsvd, 4, 2);
+    TEST_ASSERT(rc == OS_INVALID_PARM);
+
+    /* Guarantees may not exceed the msys block count. */
+    rc = os_msys_group_register(&grp_rsvd, MBUF_TEST_POOL_BUF_COUNT + 1, 0);
+    TEST_ASSERT(rc == OS_ENOMEM);
+
+    rc = os_msys_group_register(&grp_rsvd, 2, 0);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_msys_group_register(&grp_capped, 0, 3);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Re-registering a group is rejected. */
+    rc = os_msys_group_register(&grp_capped, 0, 3);
+    TEST_ASSERT(rc == OS_INVALID_PARM);
+
+    /*** The cap bounds the blocks a group may hold at once. */
+    for (i = 0; i < 3; i++) {
+        capped_ms[i] = os_msys_get_grp(&grp_capped, 100, 0);
+        TEST_ASSERT_FATAL(capped_ms[i] != NULL);
+    }
+    TEST_ASSERT(grp_capped.omg_used == 3);
+    TEST_ASSERT(grp_capped.omg_max_used == 3);
+
+    m = os_msys_get_grp(&grp_capped, 100, 0);
+    TEST_ASSERT(m == NULL);
+    TEST_ASSERT(grp_capped.omg_denied == 1);
+
+    /*** Ungrouped allocations stop short of grp_rsvd's guarantee. */
+    num_plain = 0;
+    while (num_plain < MBUF_TEST_POOL_BUF_COUNT) {
+        m = os_msys_get(100, 0);
+        if (m == NULL) {
+            break;
+        }
+        plain_ms[num_plain++] = m;
+    }
+    TEST_ASSERT(num_plain == MBUF_TEST_POOL_BUF_COUNT - 3 - 2);
+    TEST_ASSERT(os_msys_num_free() == 2);
+
+    /*** The guaranteed blocks are still there for their group. */
+    for (i = 0; i < 2; i++) {
+        rsvd_ms[i] = os_msys_get_grp(&grp_rsvd, 100, 0);
+        TEST_ASSERT_FATAL(rsvd_ms[i] != NULL);
+    }
+    TEST_ASSERT(grp_rsvd.omg_used == 2);
+    TEST_ASSERT(os_msys_num_free() == 0);
+
+    /* Beyond its guarantee the group competes like everyone else. */
+    m = os_msys_get_grp(&grp_rsvd, 100, 0);
+    TEST_ASSERT(m == NULL);
+    TEST_ASSERT(grp_rsvd.omg_denied == 1);
+
+    /*** Freeing an mbuf returns its charge to the group. */
+    for (i = 0; i < 2; i++) {
+        rc = os_mbuf_free(rsvd_ms[i]);
+        TEST_ASSERT(rc == 0);
+    }
+    TEST_ASSERT(grp_rsvd.omg_used == 0);
+    TEST_ASSERT(grp_rsvd.omg_max_used == 2);
+
+    for (i = 0; i < 3; i++) {
+        rc = os_mbuf_free(capped_ms[i]);
+        TEST_ASSERT(rc == 0);
+    }
+    TEST_ASSERT(grp_capped.omg_used == 0);
+
+    for (i = 0; i < num_plain; i++) {
+        rc = os_mbuf_free(plain_ms[i]);
+        TEST_ASSERT(rc == 0);
+    }
+    TEST_ASSERT(os_msys_num_free() == MBUF_TEST_POOL_BUF_COUNT);
+
+    /* The charge follows a pkthdr mbuf, too. */
+    m = os_msys_get_pkthdr_grp(&grp_capped, 64, 10);
+    TEST_ASSERT_FATAL(m != NULL);
+    TEST_ASSERT(grp_capped.omg_used == 1);
+    rc = os_mbuf_free(m);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(grp_capped.omg_used == 0);
+}
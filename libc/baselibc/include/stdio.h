@@ -112,6 +112,73 @@ __extern int vasprintf(char **, const char *, va_list);
 __extern int sscanf(const char *, const char *, ...);
 __extern int vsscanf(const char *, const char *, va_list);
 
+/*
+ * Compile-time format pre-parse for constant format strings.
+ *
+ * printf_const()/fprintf_const()/snprintf_const() behave like their
+ * plain counterparts, but when the format is a string literal made of
+ * bare %d/%i/%u/%x/%X/%s/%c conversions (up to four, no flags, width
+ * or length modifiers), the conversions are pre-parsed at compile time
+ * into a 4-bit-per-op program and the call goes straight to the direct
+ * conversion loop, never entering the runtime format parser.  Anything
+ * else falls back to the generic implementation.
+ */
+#define TFP_OP_D    1
+#define TFP_OP_U    2
+#define TFP_OP_X    3
+#define TFP_OP_XU   4
+#define TFP_OP_S    5
+#define TFP_OP_C    6
+
+#define TFP_CONV_CODE(c) \
+    ((c) == 'd' || (c) == 'i' ? TFP_OP_D : \
+     (c) == 'u' ? TFP_OP_U : \
+     (c) == 'x' ? TFP_OP_X : \
+     (c) == 'X' ? TFP_OP_XU : \
+     (c) == 's' ? TFP_OP_S : \
+     (c) == 'c' ? TFP_OP_C : 0)
+
+#define TFP_SPEC1(fmt) __builtin_strchr((fmt), '%')
+#define TFP_SPEC2(fmt) \
+    (TFP_SPEC1(fmt) ? __builtin_strchr(TFP_SPEC1(fmt) + 2, '%') : (char *)0)
+#define TFP_SPEC3(fmt) \
+    (TFP_SPEC2(fmt) ? __builtin_strchr(TFP_SPEC2(fmt) + 2, '%') : (char *)0)
+#define TFP_SPEC4(fmt) \
+    (TFP_SPEC3(fmt) ? __builtin_strchr(TFP_SPEC3(fmt) + 2, '%') : (char *)0)
+#define TFP_SPEC5(fmt) \
+    (TFP_SPEC4(fmt) ? __builtin_strchr(TFP_SPEC4(fmt) + 2, '%') : (char *)0)
+
+#define TFP_SPEC_OP(p) ((p) ? TFP_CONV_CODE((p)[1]) : 0)
+#define TFP_SPEC_OK(p) ((p) == 0 || TFP_CONV_CODE((p)[1]) != 0)
+
+#define TFP_PROG(fmt) \
+    ((unsigned int)TFP_SPEC_OP(TFP_SPEC1(fmt)) | \
+     ((unsigned int)TFP_SPEC_OP(TFP_SPEC2(fmt)) << 4) | \
+     ((unsigned int)TFP_SPEC_OP(TFP_SPEC3(fmt)) << 8) | \
+     ((unsigned int)TFP_SPEC_OP(TFP_SPEC4(fmt)) << 12))
+
+/* __builtin_constant_p(strlen()) folds to 0 for non-literal formats,
+ * keeping the specifier scan out of the object code entirely. */
+#define TFP_PROG_OK(fmt) \
+    (__builtin_constant_p(__builtin_strlen(fmt)) && \
+     TFP_SPEC_OK(TFP_SPEC1(fmt)) && TFP_SPEC_OK(TFP_SPEC2(fmt)) && \
+     TFP_SPEC_OK(TFP_SPEC3(fmt)) && TFP_SPEC_OK(TFP_SPEC4(fmt)) && \
+     TFP_SPEC5(fmt) == 0)
+
+__extern size_t tfp_format_prog(FILE *, const char *, unsigned int, ...);
+__extern int snprintf_prog(char *, size_t, const char *, unsigned int, ...);
+
+#define fprintf_const(f, fmt, ...) \
+    (TFP_PROG_OK(fmt) ? \
+     (int)tfp_format_prog((f), (fmt), TFP_PROG(fmt), ##__VA_ARGS__) : \
+     fprintf((f), (fmt), ##__VA_ARGS__))
+#define printf_const(fmt, ...) \
+    fprintf_const(stdout, fmt, ##__VA_ARGS__)
+#define snprintf_const(str, size, fmt, ...) \
+    (TFP_PROG_OK(fmt) ? \
+     snprintf_prog((str), (size), (fmt), TFP_PROG(fmt), ##__VA_ARGS__) : \
+     snprintf((str), (size), (fmt), ##__VA_ARGS__))
+
 /* Open a memory buffer for writing.
  Note: Does not write null terminator.*/
 struct MemFile
@@ -19,6 +19,55 @@ void *memcpy(void *dst, const void *src, size_t n)
 	asm volatile ("cld ; rep ; movsq ; movl %3,%%ecx ; rep ; movsb":"+c"
 		      (nq), "+S"(p), "+D"(q)
 		      :"r"((uint32_t) (n & 7)));
+#elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || \
+      defined(__ARM_ARCH_7EM__)
+	uint32_t t0, t1, t2, t3;
+
+	/* Word-align the destination, byte at a time */
+	while (n && ((uintptr_t)q & 3)) {
+		*q++ = *p++;
+		n--;
+	}
+
+	if (((uintptr_t)p & 3) == 0) {
+		/* Both pointers word aligned; move 16-byte blocks with
+		 * ldm/stm, then words. */
+		while (n >= 16) {
+			asm volatile ("ldmia %0!, {%2, %3, %4, %5}\n\t"
+				      "stmia %1!, {%2, %3, %4, %5}"
+				      : "+r" (p), "+r" (q), "=r" (t0),
+					"=r" (t1), "=r" (t2), "=r" (t3)
+				      :
+				      : "memory");
+			n -= 16;
+		}
+		while (n >= 4) {
+			*(uint32_t *)q = *(const uint32_t *)p;
+			q += 4;
+			p += 4;
+			n -= 4;
+		}
+	}
+#if !defined(__ARM_ARCH_6M__)
+	else {
+		/* Cortex-M3/M4: ldr takes the unaligned source, the
+		 * stores stay word aligned.  Cortex-M0 has no unaligned
+		 * access and falls through to the byte loop. */
+		while (n >= 4) {
+			asm volatile ("ldr %0, [%1]"
+				      : "=r" (t0)
+				      : "r" (p));
+			*(uint32_t *)q = t0;
+			q += 4;
+			p += 4;
+			n -= 4;
+		}
+	}
+#endif
+
+	while (n--) {
+		*q++ = *p++;
+	}
 #else
 	while (n--) {
 		*q++ = *p++;
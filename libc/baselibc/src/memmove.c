@@ -3,6 +3,7 @@
  */
 
 #include <string.h>
+#include <stdint.h>
 
 void *memmove(void *dst, const void *src, size_t n)
 {
@@ -18,6 +19,46 @@ void *memmove(void *dst, const void *src, size_t n)
 		asm volatile("std; rep; movsb; cld"
 			     : "+c" (n), "+S"(p), "+D"(q));
 	}
+#elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || \
+      defined(__ARM_ARCH_7EM__)
+	/* Word-wise only when the pointers are co-aligned; the remainder
+	 * and the non-co-aligned case go byte at a time, which is always
+	 * safe for the overlap. */
+	if (q < p) {
+		if (((uintptr_t)q & 3) == ((uintptr_t)p & 3)) {
+			while (n && ((uintptr_t)q & 3)) {
+				*q++ = *p++;
+				n--;
+			}
+			while (n >= 4) {
+				*(uint32_t *)q = *(const uint32_t *)p;
+				q += 4;
+				p += 4;
+				n -= 4;
+			}
+		}
+		while (n--) {
+			*q++ = *p++;
+		}
+	} else {
+		p += n;
+		q += n;
+		if (((uintptr_t)q & 3) == ((uintptr_t)p & 3)) {
+			while (n && ((uintptr_t)q & 3)) {
+				*--q = *--p;
+				n--;
+			}
+			while (n >= 4) {
+				q -= 4;
+				p -= 4;
+				*(uint32_t *)q = *(const uint32_t *)p;
+				n -= 4;
+			}
+		}
+		while (n--) {
+			*--q = *--p;
+		}
+	}
 #else
 	if (q < p) {
 		while (n--) {
@@ -20,6 +20,34 @@ void *memset(void *dst, int c, size_t n)
 		      :"+c" (nq), "+D" (q)
 		      : "a" ((unsigned char)c * 0x0101010101010101U),
 			"r" ((uint32_t) n & 7));
+#elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || \
+      defined(__ARM_ARCH_7EM__)
+	uint32_t fill = (unsigned char)c * 0x01010101U;
+	uint32_t f1 = fill;
+	uint32_t f2 = fill;
+	uint32_t f3 = fill;
+
+	/* Word-align the destination, byte at a time */
+	while (n && ((uintptr_t)q & 3)) {
+		*q++ = c;
+		n--;
+	}
+	/* 16-byte blocks with stm, then words */
+	while (n >= 16) {
+		asm volatile ("stmia %0!, {%1, %2, %3, %4}"
+			      : "+r" (q)
+			      : "r" (fill), "r" (f1), "r" (f2), "r" (f3)
+			      : "memory");
+		n -= 16;
+	}
+	while (n >= 4) {
+		*(uint32_t *)q = fill;
+		q += 4;
+		n -= 4;
+	}
+	while (n--) {
+		*q++ = c;
+	}
 #else
 	while (n--) {
 		*q++ = c;
@@ -238,6 +238,46 @@ size_t tfp_format(FILE *putp, const char *fmt, va_list va)
         if (ch != '%') {
             written += putf(putp, ch);
         } else {
+            /* Fast path: a bare conversion with no flags, width or
+             * length modifier; these dominate console logging, so
+             * short-circuit the parameter parse. */
+            ch = *fmt;
+            if (ch == 'd' || ch == 'u' || ch == 'x' || ch == 's' ||
+                ch == 'c') {
+                fmt++;
+                p.lz = 0;
+                p.alt = 0;
+                p.width = 0;
+                p.sign = 0;
+                p.uc = 0;
+                switch (ch) {
+                case 'd':
+                    p.base = 10;
+                    i2a(va_arg(va, int), &p);
+                    written += putchw(putp, &p);
+                    break;
+                case 'u':
+                    p.base = 10;
+                    ui2a(va_arg(va, unsigned int), &p);
+                    written += putchw(putp, &p);
+                    break;
+                case 'x':
+                    p.base = 16;
+                    ui2a(va_arg(va, unsigned int), &p);
+                    written += putchw(putp, &p);
+                    break;
+                case 's':
+                    p.bf = va_arg(va, char *);
+                    written += putchw(putp, &p);
+                    p.bf = bf;
+                    break;
+                case 'c':
+                    written += putf(putp, (char)(va_arg(va, int)));
+                    break;
+                }
+                continue;
+            }
+
             /* Init parameter struct */
             p.lz = 0;
             p.alt = 0;
@@ -320,6 +360,102 @@ size_t tfp_format(FILE *putp, const char *fmt, va_list va)
  return written;
 }
 
+/*
+ * Renders a format whose conversions were pre-parsed into 'prog' by the
+ * printf_const() family (stdio.h).  Each 4-bit op is one bare
+ * conversion; literal runs go out through fwrite() and the runtime
+ * format parser is never entered.
+ */
+static size_t tfp_format_progv(FILE *putp, const char *fmt, unsigned int prog,
+                               va_list va)
+{
+    size_t written = 0;
+    struct param p;
+    char bf[23];
+    const char *pct;
+    size_t n;
+    int op;
+
+    p.bf = bf;
+
+    for (;;) {
+        pct = strchr(fmt, '%');
+        n = pct ? (size_t)(pct - fmt) : strlen(fmt);
+        if (n) {
+            written += fwrite(fmt, 1, n, putp);
+        }
+        if (!pct) {
+            break;
+        }
+
+        p.lz = 0;
+        p.alt = 0;
+        p.width = 0;
+        p.sign = 0;
+        p.uc = 0;
+
+        op = prog & 0xf;
+        prog >>= 4;
+        switch (op) {
+        case TFP_OP_D:
+            p.base = 10;
+            i2a(va_arg(va, int), &p);
+            written += putchw(putp, &p);
+            break;
+        case TFP_OP_U:
+            p.base = 10;
+            ui2a(va_arg(va, unsigned int), &p);
+            written += putchw(putp, &p);
+            break;
+        case TFP_OP_X:
+        case TFP_OP_XU:
+            p.base = 16;
+            p.uc = (op == TFP_OP_XU);
+            ui2a(va_arg(va, unsigned int), &p);
+            written += putchw(putp, &p);
+            break;
+        case TFP_OP_S:
+            p.bf = va_arg(va, char *);
+            written += putchw(putp, &p);
+            p.bf = bf;
+            break;
+        case TFP_OP_C:
+            written += putf(putp, (char)(va_arg(va, int)));
+            break;
+        default:
+            break;
+        }
+        fmt = pct + 2;
+    }
+
+    return written;
+}
+
+size_t tfp_format_prog(FILE *putp, const char *fmt, unsigned int prog, ...)
+{
+    va_list va;
+    size_t rv;
+
+    va_start(va, prog);
+    rv = tfp_format_progv(putp, fmt, prog, va);
+    va_end(va);
+    return rv;
+}
+
+int snprintf_prog(char *str, size_t size, const char *fmt,
+                  unsigned int prog, ...)
+{
+    struct MemFile state;
+    va_list va;
+    FILE *f = fmemopen_w(&state, str, size - 1);
+
+    va_start(va, prog);
+    tfp_format_progv(f, fmt, prog, va);
+    va_end(va);
+    *(state.buffer) = '\0';
+    return state.bytes_written;
+}
+
 int vfprintf(FILE *f, const char *fmt, va_list va)
 {
     return tfp_format(f, fmt, va);
@@ -0,0 +1,47 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "baselibc_test.h"
+
+TEST_CASE_DECL(mem_test_alignments)
+TEST_CASE_DECL(mem_test_memmove_overlap)
+TEST_CASE_DECL(mem_test_benchmark)
+TEST_CASE_DECL(printf_const_test)
+
+TEST_SUITE(baselibc_test_suite)
+{
+    mem_test_alignments();
+    mem_test_memmove_overlap();
+    mem_test_benchmark();
+    printf_const_test();
+}
+
+#if MYNEWT_VAL(SELFTEST)
+
+int
+main(int argc, char **argv)
+{
+    ts_config.ts_print_results = 1;
+    tu_init();
+
+    baselibc_test_suite();
+
+    return tu_any_failed;
+}
+
+#endif
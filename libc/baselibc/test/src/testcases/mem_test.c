@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "baselibc_test.h"
+
+#define MEM_TEST_BUF_SZ         97
+#define MEM_TEST_PAD            8
+#define MEM_TEST_CANARY         0xa5
+
+/*
+ * The optimized mem* variants switch between byte, word and multi-word
+ * block strategies based on source/destination alignment and length.
+ * Exercise every combination of head offset (0-3), length remainder and
+ * both short and block-sized copies, and verify the bytes on either
+ * side of the destination window are untouched.
+ */
+TEST_CASE(mem_test_alignments)
+{
+    uint8_t src[MEM_TEST_BUF_SZ + MEM_TEST_PAD];
+    uint8_t dst[MEM_TEST_BUF_SZ + 2 * MEM_TEST_PAD];
+    int soff;
+    int doff;
+    int len;
+    int i;
+
+    for (i = 0; i < sizeof(src); i++) {
+        src[i] = i ^ (i >> 5);
+    }
+
+    for (soff = 0; soff < 4; soff++) {
+        for (doff = 0; doff < 4; doff++) {
+            for (len = 0; len <= MEM_TEST_BUF_SZ; len += 7) {
+                memset(dst, MEM_TEST_CANARY, sizeof(dst));
+                memcpy(dst + MEM_TEST_PAD + doff, src + soff, len);
+
+                TEST_ASSERT(memcmp(dst + MEM_TEST_PAD + doff,
+                                   src + soff, len) == 0,
+                            "memcpy soff=%d doff=%d len=%d corrupt",
+                            soff, doff, len);
+                for (i = 0; i < MEM_TEST_PAD + doff; i++) {
+                    TEST_ASSERT_FATAL(dst[i] == MEM_TEST_CANARY,
+                                      "memcpy underran dst at %d", i);
+                }
+                for (i = MEM_TEST_PAD + doff + len; i < sizeof(dst); i++) {
+                    TEST_ASSERT_FATAL(dst[i] == MEM_TEST_CANARY,
+                                      "memcpy overran dst at %d", i);
+                }
+            }
+        }
+    }
+
+    /* memset: every head offset and length remainder */
+    for (doff = 0; doff < 4; doff++) {
+        for (len = 0; len <= MEM_TEST_BUF_SZ; len += 7) {
+            memset(dst, MEM_TEST_CANARY, sizeof(dst));
+            memset(dst + MEM_TEST_PAD + doff, 0x3c, len);
+
+            for (i = 0; i < len; i++) {
+                TEST_ASSERT_FATAL(dst[MEM_TEST_PAD + doff + i] == 0x3c,
+                                  "memset doff=%d len=%d missed byte %d",
+                                  doff, len, i);
+            }
+            for (i = 0; i < MEM_TEST_PAD + doff; i++) {
+                TEST_ASSERT_FATAL(dst[i] == MEM_TEST_CANARY,
+                                  "memset underran dst at %d", i);
+            }
+            for (i = MEM_TEST_PAD + doff + len; i < sizeof(dst); i++) {
+                TEST_ASSERT_FATAL(dst[i] == MEM_TEST_CANARY,
+                                  "memset overran dst at %d", i);
+            }
+        }
+    }
+}
+
+/*
+ * memmove has to produce the same result as copying through a bounce
+ * buffer for every overlap distance in both directions, including the
+ * sub-word shifts the word-wise path must leave to the byte loop.
+ */
+TEST_CASE(mem_test_memmove_overlap)
+{
+    uint8_t buf[MEM_TEST_BUF_SZ + MEM_TEST_PAD];
+    uint8_t expected[MEM_TEST_BUF_SZ + MEM_TEST_PAD];
+    uint8_t bounce[MEM_TEST_BUF_SZ];
+    int dist;
+    int i;
+
+    for (dist = -MEM_TEST_PAD; dist <= MEM_TEST_PAD; dist++) {
+        for (i = 0; i < sizeof(buf); i++) {
+            buf[i] = i ^ (i >> 3);
+        }
+
+        /* Reference result, byte by byte through a bounce buffer */
+        for (i = 0; i < sizeof(buf); i++) {
+            expected[i] = buf[i];
+        }
+        for (i = 0; i < MEM_TEST_BUF_SZ - MEM_TEST_PAD; i++) {
+            bounce[i] = buf[MEM_TEST_PAD + i];
+        }
+        for (i = 0; i < MEM_TEST_BUF_SZ - MEM_TEST_PAD; i++) {
+            expected[MEM_TEST_PAD + dist + i] = bounce[i];
+        }
+
+        memmove(buf + MEM_TEST_PAD + dist, buf + MEM_TEST_PAD,
+                MEM_TEST_BUF_SZ - MEM_TEST_PAD);
+
+        TEST_ASSERT(memcmp(buf, expected, sizeof(buf)) == 0,
+                    "memmove dist=%d corrupt", dist);
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdio.h>
+
+#include "baselibc_test.h"
+
+/*
+ * snprintf_const() pre-parses literal formats at compile time and
+ * renders through the direct conversion loop; formats it cannot
+ * pre-parse (flags, width, %%, five or more conversions) must fall
+ * back to the generic parser with identical output.  Only meaningful
+ * against baselibc's printf, so compiled out on selftest hosts with a
+ * native libc.
+ */
+TEST_CASE(printf_const_test)
+{
+#ifdef snprintf_const
+    char buf[64];
+    char buf2[64];
+    int rc;
+
+    rc = snprintf_const(buf, sizeof(buf), "temp %d.%u C idx %x",
+                        -12, 50, 0xbeef);
+    TEST_ASSERT(rc == (int)strlen("temp -12.50 C idx beef"));
+    TEST_ASSERT(strcmp(buf, "temp -12.50 C idx beef") == 0,
+                "const d.u.x got [%s]", buf);
+
+    snprintf_const(buf, sizeof(buf), "%s=%d", "cnt", 42);
+    TEST_ASSERT(strcmp(buf, "cnt=42") == 0, "const s=d got [%s]", buf);
+
+    snprintf_const(buf, sizeof(buf), "%X %c %i %u", 0xf0, 'Z', -3, 9);
+    TEST_ASSERT(strcmp(buf, "F0 Z -3 9") == 0, "const XcIu got [%s]", buf);
+
+    snprintf_const(buf, sizeof(buf), "no conversions");
+    TEST_ASSERT(strcmp(buf, "no conversions") == 0);
+
+    /* Fallback shapes: output must match plain snprintf exactly */
+    snprintf(buf2, sizeof(buf2), "pad %08x w %4d", 0x1a, 7);
+    snprintf_const(buf, sizeof(buf), "pad %08x w %4d", 0x1a, 7);
+    TEST_ASSERT(strcmp(buf, buf2) == 0, "width fallback [%s] != [%s]",
+                buf, buf2);
+
+    snprintf(buf2, sizeof(buf2), "100%% of %d %d %d %d %d", 1, 2, 3, 4, 5);
+    snprintf_const(buf, sizeof(buf), "100%% of %d %d %d %d %d",
+                   1, 2, 3, 4, 5);
+    TEST_ASSERT(strcmp(buf, buf2) == 0, "pct fallback [%s] != [%s]",
+                buf, buf2);
+#endif
+}
@@ -34,6 +34,13 @@
 #include "imgmgr/imgmgr.h"
 #include "imgmgr_priv.h"
 
+#if MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW) > 0
+#include "os/os.h"
+#if MYNEWT_VAL(HAL_FLASH_ASYNC)
+#include "hal/hal_flash_async.h"
+#endif
+#endif
+
 static int imgr_upload(struct mgmt_cbuf *);
 
 static const struct mgmt_handler imgr_nmgr_handlers[] = {
@@ -85,6 +92,233 @@ static struct mgmt_group imgr_nmgr_group = {
 
 struct imgr_state imgr_state;
 
+#if MYNEWT_VAL(IMGMGR_UPLOAD_HASH)
+/*
+ * The image hash covers the header and image body; the trailing TLVs
+ * (including the stored SHA256) are excluded.  The digest rides along
+ * as chunks reach the contiguous point, so the final packet only has
+ * to compare digests instead of re-reading the whole slot.
+ */
+static void
+imgr_upload_hash_start(const struct image_header *hdr)
+{
+    mbedtls_sha256_init(&imgr_state.upload.sha);
+    mbedtls_sha256_starts(&imgr_state.upload.sha, 0);
+    imgr_state.upload.hash_size = hdr->ih_hdr_size + hdr->ih_img_size;
+    imgr_state.upload.hash_off = 0;
+}
+
+static void
+imgr_upload_hash_update(const uint8_t *data, uint32_t len)
+{
+    if (imgr_state.upload.hash_off >= imgr_state.upload.hash_size) {
+        return;
+    }
+    if (imgr_state.upload.hash_off + len > imgr_state.upload.hash_size) {
+        len = imgr_state.upload.hash_size - imgr_state.upload.hash_off;
+    }
+    mbedtls_sha256_update(&imgr_state.upload.sha, data, len);
+    imgr_state.upload.hash_off += len;
+}
+
+/*
+ * Called once every byte has landed; compares the rolling digest with
+ * the image's stored SHA256 TLV.
+ */
+static int
+imgr_upload_hash_verify(void)
+{
+    struct image_header hdr;
+    uint8_t computed[IMGMGR_HASH_LEN];
+    uint8_t stored[IMGMGR_HASH_LEN];
+    int rc;
+
+    if (imgr_state.upload.hash_off < imgr_state.upload.hash_size) {
+        /* Upload was shorter than the header advertised. */
+        return MGMT_ERR_EINVAL;
+    }
+    mbedtls_sha256_finish(&imgr_state.upload.sha, computed);
+
+    rc = flash_area_read(imgr_state.upload.fa, 0, &hdr, sizeof(hdr));
+    if (rc) {
+        return MGMT_ERR_EUNKNOWN;
+    }
+    rc = bootutil_img_find_sha256(&hdr, imgr_state.upload.fa, stored);
+    if (rc || memcmp(stored, computed, IMGMGR_HASH_LEN)) {
+        return MGMT_ERR_EINVAL;
+    }
+    return 0;
+}
+#else
+#define imgr_upload_hash_start(hdr)
+#define imgr_upload_hash_update(data, len)
+#define imgr_upload_hash_verify()       (0)
+#endif /* IMGMGR_UPLOAD_HASH */
+
+#if MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW) > 0
+/*
+ * Upload chunks staged in RAM.  A chunk is FREE, STAGED (received ahead
+ * of the contiguous point, waiting for the gap to fill) or QUEUED (in
+ * the flash write queue).  The response "off" field is always the
+ * lowest offset not yet received, so stop-and-wait clients interoperate
+ * unchanged while windowed clients keep the link full.
+ */
+#define IMGR_CHUNK_FREE         0
+#define IMGR_CHUNK_STAGED       1
+#define IMGR_CHUNK_QUEUED       2
+
+struct imgr_upload_chunk {
+    uint32_t uc_off;
+    uint16_t uc_len;
+    volatile uint8_t uc_state;
+    uint8_t uc_data[IMGMGR_NMGR_MAX_MSG];
+};
+
+static struct imgr_upload_chunk
+    imgr_upload_chunks[MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW)];
+static volatile int imgr_upload_werr;
+
+static void
+imgr_upload_window_reset(void)
+{
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW); i++) {
+        imgr_upload_chunks[i].uc_state = IMGR_CHUNK_FREE;
+    }
+    imgr_upload_werr = 0;
+}
+
+#if MYNEWT_VAL(HAL_FLASH_ASYNC)
+static void
+imgr_upload_write_done(int rc, void *arg)
+{
+    struct imgr_upload_chunk *uc = (struct imgr_upload_chunk *)arg;
+
+    if (rc) {
+        imgr_upload_werr = rc;
+    }
+    uc->uc_state = IMGR_CHUNK_FREE;
+}
+#endif
+
+/*
+ * Hand a contiguous chunk to flash; asynchronously when the flash op
+ * queue is available (the ack then goes out before programming
+ * finishes), synchronously otherwise.
+ */
+static int
+imgr_upload_submit(struct imgr_upload_chunk *uc)
+{
+    const struct flash_area *fa = imgr_state.upload.fa;
+    int rc;
+
+#if MYNEWT_VAL(HAL_FLASH_ASYNC)
+    rc = hal_flash_async_write(fa->fa_device_id, fa->fa_off + uc->uc_off,
+      uc->uc_data, uc->uc_len, imgr_upload_write_done, uc);
+    if (rc == 0) {
+        uc->uc_state = IMGR_CHUNK_QUEUED;
+        return 0;
+    }
+    /* Queue full; fall through to a blocking write. */
+#endif
+    rc = flash_area_write(fa, uc->uc_off, uc->uc_data, uc->uc_len);
+    uc->uc_state = IMGR_CHUNK_FREE;
+    return rc;
+}
+
+/*
+ * Take one received chunk; data at the contiguous point goes straight
+ * to flash and then drains any staged chunks the gap was holding back,
+ * data ahead of it is staged if a slot is free, anything else is
+ * dropped and the ack offset tells the client what we still need.
+ */
+static int
+imgr_upload_window_rx(uint32_t off, uint8_t *data, int len)
+{
+    struct imgr_upload_chunk *uc;
+    int again;
+    int rc;
+    int i;
+
+    if (imgr_upload_werr) {
+        return imgr_upload_werr;
+    }
+    if (off + len <= imgr_state.upload.off) {
+        /* Duplicate. */
+        return 0;
+    }
+
+    uc = NULL;
+    for (i = 0; i < MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW); i++) {
+        if (imgr_upload_chunks[i].uc_state == IMGR_CHUNK_FREE) {
+            uc = &imgr_upload_chunks[i];
+            break;
+        }
+    }
+    if (!uc) {
+        if (off != imgr_state.upload.off) {
+            /* No room to stage; client will retransmit. */
+            return 0;
+        }
+        /*
+         * Never refuse the chunk the window is waiting for; write it
+         * in place.
+         */
+        rc = flash_area_write(imgr_state.upload.fa, off, data, len);
+        if (rc) {
+            return rc;
+        }
+        imgr_upload_hash_update(data, len);
+        imgr_state.upload.off += len;
+    } else {
+        memcpy(uc->uc_data, data, len);
+        uc->uc_off = off;
+        uc->uc_len = len;
+        uc->uc_state = IMGR_CHUNK_STAGED;
+    }
+
+    /*
+     * Submit every staged chunk that is now contiguous; discard staged
+     * duplicates the drain overtakes.
+     */
+    do {
+        again = 0;
+        for (i = 0; i < MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW); i++) {
+            uc = &imgr_upload_chunks[i];
+            if (uc->uc_state != IMGR_CHUNK_STAGED) {
+                continue;
+            }
+            if (uc->uc_off + uc->uc_len <= imgr_state.upload.off) {
+                uc->uc_state = IMGR_CHUNK_FREE;
+            } else if (uc->uc_off == imgr_state.upload.off) {
+                rc = imgr_upload_submit(uc);
+                if (rc) {
+                    return rc;
+                }
+                imgr_upload_hash_update(uc->uc_data, uc->uc_len);
+                imgr_state.upload.off += uc->uc_len;
+                again = 1;
+            }
+        }
+    } while (again);
+
+    return 0;
+}
+
+/*
+ * Wait for queued writes to land before the upload is declared done.
+ */
+static int
+imgr_upload_window_flush(void)
+{
+#if MYNEWT_VAL(HAL_FLASH_ASYNC)
+    hal_flash_async_flush(OS_WAIT_FOREVER);
+#endif
+    return imgr_upload_werr;
+}
+#endif /* IMGMGR_UPLOAD_WINDOW */
+
 /*
  * Read version and build hash from image located slot "image_slot".  Note:
  * this is a slot index, not a flash area ID.
@@ -295,6 +529,10 @@ imgr_upload(struct mgmt_cbuf *cb)
          */
         imgr_state.upload.off = 0;
         imgr_state.upload.size = size;
+        imgr_upload_hash_start(hdr);
+#if MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW) > 0
+        imgr_upload_window_reset();
+#endif
         best = -1;
 
         for (i = 0; i < 2; i++) {
@@ -346,6 +584,15 @@ imgr_upload(struct mgmt_cbuf *cb)
             rc = MGMT_ERR_ENOMEM;
             goto err;
         }
+#if MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW) > 0
+    } else if (off < imgr_state.upload.off) {
+        /*
+         * Duplicate of data we already have; ack the current offset.
+         */
+        goto out;
+    }
+    /* Data ahead of the contiguous point is handled by the window. */
+#else
     } else if (off != imgr_state.upload.off) {
         /*
          * Invalid offset. Drop the data, and respond with the offset we're
@@ -353,24 +600,52 @@ imgr_upload(struct mgmt_cbuf *cb)
          */
         goto out;
     }
+#endif
 
     if (!imgr_state.upload.fa) {
         rc = MGMT_ERR_EINVAL;
         goto err;
     }
     if (data_len) {
+#if MYNEWT_VAL(IMGMGR_UPLOAD_WINDOW) > 0
+        rc = imgr_upload_window_rx(off, img_data, data_len);
+        if (rc) {
+            rc = MGMT_ERR_EINVAL;
+            goto err_close;
+        }
+        if (imgr_state.upload.size == imgr_state.upload.off) {
+            /* Done; wait out the queued writes. */
+            rc = imgr_upload_window_flush();
+            if (rc) {
+                rc = MGMT_ERR_EINVAL;
+                goto err_close;
+            }
+            rc = imgr_upload_hash_verify();
+            if (rc) {
+                goto err_close;
+            }
+            flash_area_close(imgr_state.upload.fa);
+            imgr_state.upload.fa = NULL;
+        }
+#else
         rc = flash_area_write(imgr_state.upload.fa, imgr_state.upload.off,
           img_data, data_len);
         if (rc) {
             rc = MGMT_ERR_EINVAL;
             goto err_close;
         }
+        imgr_upload_hash_update(img_data, data_len);
         imgr_state.upload.off += data_len;
         if (imgr_state.upload.size == imgr_state.upload.off) {
             /* Done */
+            rc = imgr_upload_hash_verify();
+            if (rc) {
+                goto err_close;
+            }
             flash_area_close(imgr_state.upload.fa);
             imgr_state.upload.fa = NULL;
         }
+#endif
     }
 out:
     g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
@@ -22,6 +22,7 @@
 #if MYNEWT_VAL(IMGMGR_COREDUMP)
 
 #include <limits.h>
+#include <string.h>
 
 #include "sysflash/sysflash.h"
 #include "flash_map/flash_map.h"
@@ -32,6 +33,107 @@
 #include "imgmgr/imgmgr.h"
 #include "imgmgr_priv.h"
 
+#if MYNEWT_VAL(COREDUMP_COMPRESS)
+#include "lzss/lzss.h"
+
+struct imgr_core_dec_arg {
+    uint8_t *ida_buf;
+    uint32_t ida_skip;          /* plain bytes to discard first */
+    int ida_want;
+    int ida_have;
+};
+
+static int
+imgr_core_dec_out(void *arg, const uint8_t *data, int len)
+{
+    struct imgr_core_dec_arg *ida = (struct imgr_core_dec_arg *)arg;
+    int take;
+
+    if (ida->ida_skip) {
+        take = len;
+        if (take > ida->ida_skip) {
+            take = ida->ida_skip;
+        }
+        ida->ida_skip -= take;
+        data += take;
+        len -= take;
+    }
+    take = ida->ida_want - ida->ida_have;
+    if (take > len) {
+        take = len;
+    }
+    memcpy(ida->ida_buf + ida->ida_have, data, take);
+    ida->ida_have += take;
+    if (ida->ida_have >= ida->ida_want) {
+        /*
+         * Aborts the decode; not an error.
+         */
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Fill buf with sz plain corefile bytes starting at plain offset off,
+ * by decompressing the corefile body from the start.  The first
+ * sizeof(struct coredump_header) plain bytes are a reconstructed
+ * header carrying COREDUMP_MAGIC, so the downloaded file looks like an
+ * uncompressed corefile.
+ */
+static int
+imgr_core_load_comp(const struct flash_area *fa, uint32_t size, uint32_t off,
+  uint8_t *buf, int sz)
+{
+    struct coredump_header hdr;
+    struct imgr_core_dec_arg ida;
+    struct lzss_decoder dec;
+    uint8_t tmp[64];
+    uint32_t src;
+    int blk;
+    int copied;
+    int rc;
+
+    copied = 0;
+    if (off < sizeof(hdr)) {
+        hdr.ch_magic = COREDUMP_MAGIC;
+        hdr.ch_size = size;
+        copied = sizeof(hdr) - off;
+        if (copied > sz) {
+            copied = sz;
+        }
+        memcpy(buf, (uint8_t *)&hdr + off, copied);
+    }
+    if (copied >= sz) {
+        return 0;
+    }
+
+    ida.ida_buf = buf + copied;
+    ida.ida_skip = off + copied - sizeof(hdr);
+    ida.ida_want = sz - copied;
+    ida.ida_have = 0;
+
+    lzss_dec_init(&dec, imgr_core_dec_out, &ida);
+    for (src = sizeof(hdr); src < fa->fa_size; src += blk) {
+        blk = fa->fa_size - src;
+        if (blk > sizeof(tmp)) {
+            blk = sizeof(tmp);
+        }
+        rc = flash_area_read(fa, src, tmp, blk);
+        if (rc) {
+            return rc;
+        }
+        rc = lzss_dec_input(&dec, tmp, blk);
+        if (rc == 1) {
+            return 0;
+        }
+        if (rc) {
+            return rc;
+        }
+    }
+    return -1;
+}
+#endif
+
 int
 imgr_core_list(struct mgmt_cbuf *cb)
 {
@@ -46,7 +148,8 @@ imgr_core_list(struct mgmt_cbuf *cb)
         rc = flash_area_read(fa, 0, &hdr, sizeof(hdr));
         if (rc != 0) {
             rc = MGMT_ERR_EINVAL;
-        } else if (hdr.ch_magic != COREDUMP_MAGIC) {
+        } else if (hdr.ch_magic != COREDUMP_MAGIC &&
+                   hdr.ch_magic != COREDUMP_COMP_MAGIC) {
             rc = MGMT_ERR_ENOENT;
         } else {
             rc = 0;
@@ -97,7 +200,8 @@ imgr_core_load(struct mgmt_cbuf *cb)
         rc = MGMT_ERR_EINVAL;
         goto err_close;
     }
-    if (hdr->ch_magic != COREDUMP_MAGIC) {
+    if (hdr->ch_magic != COREDUMP_MAGIC &&
+        hdr->ch_magic != COREDUMP_COMP_MAGIC) {
         rc = MGMT_ERR_ENOENT;
         goto err_close;
     }
@@ -109,7 +213,15 @@ imgr_core_load(struct mgmt_cbuf *cb)
         sz = sizeof(data);
     }
 
+#if MYNEWT_VAL(COREDUMP_COMPRESS)
+    if (hdr->ch_magic == COREDUMP_COMP_MAGIC) {
+        rc = imgr_core_load_comp(fa, hdr->ch_size, off, data, sz);
+    } else {
+        rc = flash_area_read(fa, off, data, sz);
+    }
+#else
     rc = flash_area_read(fa, off, data, sz);
+#endif
     if (rc) {
         rc = MGMT_ERR_EINVAL;
         goto err_close;
@@ -155,7 +267,8 @@ imgr_core_erase(struct mgmt_cbuf *cb)
 
     rc = flash_area_read(fa, 0, &hdr, sizeof(hdr));
     if (rc == 0 &&
-      (hdr.ch_magic == COREDUMP_MAGIC || hdr.ch_magic == 0xffffffff)) {
+      (hdr.ch_magic == COREDUMP_MAGIC || hdr.ch_magic == COREDUMP_COMP_MAGIC ||
+       hdr.ch_magic == 0xffffffff)) {
         rc = flash_area_erase(fa, 0, fa->fa_size);
         if (rc) {
             rc = MGMT_ERR_EINVAL;
@@ -38,13 +38,36 @@
 #include "imgmgr/imgmgr.h"
 #include "imgmgr_priv.h"
 
+#if MYNEWT_VAL(IMGMGR_FS_DL_STREAM)
+/*
+ * Download state carried between requests; keeps the file open and
+ * positioned so a sequential pull pays one open and seek total, with
+ * the fs layer reading ahead underneath.
+ */
+static struct {
+    struct fs_file *file;
+    uint32_t off;
+    char name[IMGMGR_NMGR_MAX_NAME + 1];
+} imgr_dl_state;
+
+static void
+imgr_dl_state_close(void)
+{
+    if (imgr_dl_state.file) {
+        fs_close(imgr_dl_state.file);
+        imgr_dl_state.file = NULL;
+    }
+}
+#endif
+
 int
 imgr_file_download(struct mgmt_cbuf *cb)
 {
     long long unsigned int off = UINT_MAX;
+    long long unsigned int req_sz = 0;
     char tmp_str[IMGMGR_NMGR_MAX_NAME + 1];
     uint8_t img_data[IMGMGR_NMGR_MAX_MSG];
-    const struct cbor_attr_t dload_attr[3] = {
+    const struct cbor_attr_t dload_attr[4] = {
         [0] = {
             .attribute = "off",
             .type = CborAttrUnsignedIntegerType,
@@ -56,9 +79,15 @@ imgr_file_download(struct mgmt_cbuf *cb)
             .addr.string = tmp_str,
             .len = sizeof(tmp_str)
         },
-        [2] = { 0 },
+        [2] = {
+            .attribute = "sz",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &req_sz
+        },
+        [3] = { 0 },
     };
     int rc;
+    uint32_t chunk_sz;
     uint32_t out_len;
     struct fs_file *file;
     CborError g_err = CborNoError;
@@ -71,6 +100,37 @@ imgr_file_download(struct mgmt_cbuf *cb)
         goto err;
     }
 
+    /*
+     * "sz" is the number of bytes the client credits us with for this
+     * response; clients that omit it get the old 32 byte chunk.
+     */
+    chunk_sz = 32;
+    if (req_sz) {
+        chunk_sz = req_sz;
+        if (chunk_sz > sizeof(img_data)) {
+            chunk_sz = sizeof(img_data);
+        }
+    }
+
+#if MYNEWT_VAL(IMGMGR_FS_DL_STREAM)
+    if (imgr_dl_state.file && off == imgr_dl_state.off &&
+        !strcmp(tmp_str, imgr_dl_state.name)) {
+        file = imgr_dl_state.file;
+        imgr_dl_state.file = NULL;
+    } else {
+        imgr_dl_state_close();
+        rc = fs_open(tmp_str, FS_ACCESS_READ, &file);
+        if (rc || !file) {
+            rc = MGMT_ERR_ENOMEM;
+            goto err;
+        }
+        rc = fs_seek(file, off);
+        if (rc) {
+            rc = MGMT_ERR_EUNKNOWN;
+            goto err_close;
+        }
+    }
+#else
     rc = fs_open(tmp_str, FS_ACCESS_READ, &file);
     if (rc || !file) {
         rc = MGMT_ERR_ENOMEM;
@@ -82,7 +142,8 @@ imgr_file_download(struct mgmt_cbuf *cb)
         rc = MGMT_ERR_EUNKNOWN;
         goto err_close;
     }
-    rc = fs_read(file, 32, img_data, &out_len);
+#endif
+    rc = fs_read(file, chunk_sz, img_data, &out_len);
     if (rc) {
         rc = MGMT_ERR_EUNKNOWN;
         goto err_close;
@@ -105,7 +166,18 @@ imgr_file_download(struct mgmt_cbuf *cb)
     }
     g_err |= cbor_encoder_close_container(penc, &rsp);
 
+#if MYNEWT_VAL(IMGMGR_FS_DL_STREAM)
+    if (out_len < chunk_sz) {
+        /* EOF; nothing left to stream. */
+        fs_close(file);
+    } else {
+        imgr_dl_state.file = file;
+        imgr_dl_state.off = off + out_len;
+        strcpy(imgr_dl_state.name, tmp_str);
+    }
+#else
     fs_close(file);
+#endif
     if (g_err) {
           return MGMT_ERR_ENOMEM;
     }
@@ -180,6 +252,10 @@ imgr_file_upload(struct mgmt_cbuf *cb)
             fs_close(imgr_state.upload.file);
             imgr_state.upload.file = NULL;
         }
+#if MYNEWT_VAL(IMGMGR_FS_DL_STREAM)
+        /* The file we are about to rewrite may be mid-download. */
+        imgr_dl_state_close();
+#endif
         rc = fs_open(file_name, FS_ACCESS_WRITE | FS_ACCESS_TRUNCATE,
           &imgr_state.upload.file);
         if (rc) {
@@ -23,6 +23,10 @@
 #include <stdint.h>
 #include "syscfg/syscfg.h"
 
+#if MYNEWT_VAL(IMGMGR_UPLOAD_HASH)
+#include "mbedtls/sha256.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -93,6 +97,11 @@ struct imgr_state {
         uint32_t off;
         uint32_t size;
         const struct flash_area *fa;
+#if MYNEWT_VAL(IMGMGR_UPLOAD_HASH)
+        mbedtls_sha256_context sha;
+        uint32_t hash_size;     /* bytes the image hash covers */
+        uint32_t hash_off;      /* bytes hashed so far */
+#endif
 #if MYNEWT_VAL(IMGMGR_FS)
         struct fs_file *file;
 #endif
@@ -48,6 +48,9 @@ extern "C" {
 #define MGMT_GROUP_ID_CRASH     (5)
 #define MGMT_GROUP_ID_SPLIT     (6)
 #define MGMT_GROUP_ID_RUNTEST   (7)
+#define MGMT_GROUP_ID_HEALTH    (8)
+#define MGMT_GROUP_ID_REBOOT    (9)
+#define MGMT_GROUP_ID_FOOTPRINT (10)
 #define MGMT_GROUP_ID_PERUSER   (64)
 
 /**
@@ -75,6 +78,12 @@ struct mgmt_group {
     const struct mgmt_handler *mg_handlers;
     uint16_t mg_handlers_count;
     uint16_t mg_group_id;
+    /*
+     * Optional per-handler invocation counters; when non-NULL, must
+     * point at mg_handlers_count elements.  Incremented by
+     * mgmt_find_handler() on every successful dispatch.
+     */
+    uint32_t *mg_stats;
     STAILQ_ENTRY(mgmt_group) mg_next;
 };
 
@@ -83,6 +92,9 @@ struct mgmt_group {
     (__group)->mg_handlers_count = (sizeof((__handlers)) / \
             sizeof(struct mgmt_handler));
 
+#define MGMT_GROUP_SET_STATS(__group, __stats)             \
+    (__group)->mg_stats = (__stats);
+
 int mgmt_group_register(struct mgmt_group *group);
 void mgmt_cbuf_setoerr(struct mgmt_cbuf *njb, int errcode);
 const struct mgmt_handler *mgmt_find_handler(uint16_t group_id,
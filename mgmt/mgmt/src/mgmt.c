@@ -20,12 +20,22 @@
 
 #include <os/os.h>
 #include <tinycbor/cbor.h>
+#include "syscfg/syscfg.h"
 #include "mgmt/mgmt.h"
 
 static struct os_mutex mgmt_group_lock;
 static STAILQ_HEAD(, mgmt_group) mgmt_group_list =
     STAILQ_HEAD_INITIALIZER(mgmt_group_list);
 
+/*
+ * Registered groups, sorted by group id, for binary search dispatch.
+ * Groups registered after the index fills (more than MGMT_MAX_GROUPS)
+ * are still reachable through the list scan fallback.
+ */
+static struct mgmt_group *mgmt_group_idx[MYNEWT_VAL(MGMT_MAX_GROUPS)];
+static uint8_t mgmt_group_idx_cnt;
+static uint8_t mgmt_group_idx_full;
+
 static int
 mgmt_group_list_lock(void)
 {
@@ -76,6 +86,20 @@ mgmt_group_register(struct mgmt_group *group)
 
     STAILQ_INSERT_TAIL(&mgmt_group_list, group, mg_next);
 
+    if (mgmt_group_idx_cnt < MYNEWT_VAL(MGMT_MAX_GROUPS)) {
+        int i;
+
+        for (i = mgmt_group_idx_cnt;
+             i > 0 && mgmt_group_idx[i - 1]->mg_group_id > group->mg_group_id;
+             i--) {
+            mgmt_group_idx[i] = mgmt_group_idx[i - 1];
+        }
+        mgmt_group_idx[i] = group;
+        mgmt_group_idx_cnt++;
+    } else {
+        mgmt_group_idx_full = 1;
+    }
+
     rc = mgmt_group_list_unlock();
     if (rc != 0) {
         goto err;
@@ -92,6 +116,10 @@ mgmt_find_group(uint16_t group_id)
     struct mgmt_group *group;
     int rc;
 
+    int lo;
+    int hi;
+    int mid;
+
     group = NULL;
 
     rc = mgmt_group_list_lock();
@@ -99,9 +127,25 @@ mgmt_find_group(uint16_t group_id)
         goto err;
     }
 
-    STAILQ_FOREACH(group, &mgmt_group_list, mg_next) {
-        if (group->mg_group_id == group_id) {
+    lo = 0;
+    hi = mgmt_group_idx_cnt - 1;
+    while (lo <= hi) {
+        mid = (lo + hi) / 2;
+        if (mgmt_group_idx[mid]->mg_group_id == group_id) {
+            group = mgmt_group_idx[mid];
             break;
+        } else if (mgmt_group_idx[mid]->mg_group_id < group_id) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    if (!group && mgmt_group_idx_full) {
+        STAILQ_FOREACH(group, &mgmt_group_list, mg_next) {
+            if (group->mg_group_id == group_id) {
+                break;
+            }
         }
     }
 
@@ -132,6 +176,10 @@ mgmt_find_handler(uint16_t group_id, uint16_t handler_id)
 
     handler = &group->mg_handlers[handler_id];
 
+    if (group->mg_stats) {
+        group->mg_stats[handler_id]++;
+    }
+
     return (handler);
 err:
     return (NULL);
@@ -217,6 +217,10 @@ nmgr_handle_req(struct nmgr_transport *nt, struct os_mbuf *req)
         }
 
         hdr.nh_len = ntohs(hdr.nh_len);
+        if (off + sizeof(hdr) + hdr.nh_len > len) {
+            rc = MGMT_ERR_EINVAL;
+            goto err_norsp;
+        }
 
         handler = mgmt_find_handler(ntohs(hdr.nh_group), hdr.nh_id);
         if (!handler) {
@@ -233,7 +237,12 @@ nmgr_handle_req(struct nmgr_transport *nt, struct os_mbuf *req)
             goto err_norsp;
         }
 
-        cbor_mbuf_reader_init(&nmgr_task_cbuf.reader, req, sizeof(hdr));
+        /*
+         * Decode in place from the mbuf chain, bounded to this frame
+         * so a handler cannot read into a following concatenated one.
+         */
+        cbor_mbuf_reader_init_len(&nmgr_task_cbuf.reader, req,
+                                  off + sizeof(hdr), hdr.nh_len);
         cbor_parser_init(&nmgr_task_cbuf.reader.r, 0,
                          &nmgr_task_cbuf.n_b.parser, &nmgr_task_cbuf.n_b.it);
 
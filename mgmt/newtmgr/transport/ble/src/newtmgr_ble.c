@@ -30,6 +30,9 @@
 /* nmgr ble mqueue */
 struct os_mqueue nmgr_ble_mq;
 
+/* retries notifications when host transmit buffers are exhausted */
+static struct os_callout nmgr_ble_tx_retry_co;
+
 /* ble nmgr transport */
 struct nmgr_transport ble_nt;
 
@@ -154,7 +157,10 @@ nmgr_ble_get_mtu(struct os_mbuf *req) {
     memcpy(&conn_handle, OS_MBUF_USRHDR(req), sizeof (conn_handle));
     mtu = ble_att_mtu(conn_handle);
     if (!mtu) {
-        assert(0);
+        /* The connection dropped before the response was built.  Fragment
+         * for the default MTU; the notify attempts will fail benignly.
+         */
+        mtu = BLE_ATT_MTU_DFLT;
     }
 
     /* 3 is the number of bytes for ATT notification base */
@@ -165,7 +171,11 @@ nmgr_ble_get_mtu(struct os_mbuf *req) {
 
 /**
  * Nmgr ble process mqueue event
- * Gets an event from the nmgr mqueue and does a notify with the response
+ * Gets events from the nmgr mqueue and does a notify with each response
+ * fragment.  Fragments are streamed back to back; when the host runs out
+ * of transmit buffers mid-response, the fragment is kept at the head of
+ * the queue and retried from a callout instead of being dropped, so large
+ * responses survive congestion at full MTU.
  *
  * @param eventq
  * @return 0 on success; non-zero on failure
@@ -175,13 +185,49 @@ static void
 nmgr_ble_event_data_in(struct os_event *ev)
 {
     struct os_mbuf *m_resp;
+    struct os_mbuf *txom;
     uint16_t conn_handle;
+    os_sr_t sr;
+    int rc;
 
     while ((m_resp = os_mqueue_get(&nmgr_ble_mq)) != NULL) {
         assert(OS_MBUF_USRHDR_LEN(m_resp) >= sizeof (conn_handle));
         memcpy(&conn_handle, OS_MBUF_USRHDR(m_resp), sizeof (conn_handle));
-        ble_gattc_notify_custom(conn_handle, g_ble_nmgr_attr_handle,
-                                m_resp);
+
+        /* The host consumes the mbuf whether or not the notification
+         * could be enqueued, so send a copy and keep the fragment in
+         * case it needs to be retried.
+         */
+        txom = os_msys_get_pkthdr(OS_MBUF_PKTLEN(m_resp), 0);
+        if (txom == NULL ||
+            os_mbuf_appendfrom(txom, m_resp, 0, OS_MBUF_PKTLEN(m_resp))) {
+
+            os_mbuf_free_chain(txom);
+            rc = BLE_HS_ENOMEM;
+        } else {
+            rc = ble_gattc_notify_custom(conn_handle, g_ble_nmgr_attr_handle,
+                                         txom);
+        }
+
+        if (rc == BLE_HS_ENOMEM) {
+            /* Transmit resources exhausted.  Put the fragment back at
+             * the head of the queue (order within a response matters)
+             * and try again shortly.
+             */
+            OS_ENTER_CRITICAL(sr);
+            STAILQ_INSERT_HEAD(&nmgr_ble_mq.mq_head, OS_MBUF_PKTHDR(m_resp),
+                               omp_next);
+            OS_EXIT_CRITICAL(sr);
+
+            os_callout_reset(&nmgr_ble_tx_retry_co,
+                             OS_TICKS_PER_SEC / 32 + 1);
+            return;
+        }
+
+        /* Sent, or failed for a non-retryable reason (e.g. the peer
+         * disconnected); either way this fragment is finished.
+         */
+        os_mbuf_free_chain(m_resp);
     }
 }
 
@@ -222,6 +268,8 @@ nmgr_ble_gatt_svr_init(void)
     }
 
     os_mqueue_init(&nmgr_ble_mq, &nmgr_ble_event_data_in, NULL);
+    os_callout_init(&nmgr_ble_tx_retry_co, mgmt_evq_get(),
+                    nmgr_ble_event_data_in, NULL);
 
     rc = nmgr_transport_init(&ble_nt, nmgr_ble_out, nmgr_ble_get_mtu);
 
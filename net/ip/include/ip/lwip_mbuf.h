@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __IP_LWIP_MBUF_H__
+#define __IP_LWIP_MBUF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pbuf;
+struct os_mbuf;
+
+/*
+ * Zero-copy bridge between lwIP pbufs and os_mbufs.  Neither direction
+ * copies payload bytes; each wraps the other side's buffers and frees
+ * them when the wrapping chain is released.
+ */
+
+/*
+ * Wrap an os_mbuf chain in custom PBUF_REF pbufs, one per segment.
+ * On success the chain is owned by the returned pbuf; freeing the
+ * pbuf (last reference) frees the mbufs.  On failure NULL is returned
+ * and the caller still owns the chain.
+ */
+struct pbuf *lwip_pbuf_from_mbuf(struct os_mbuf *m);
+
+/*
+ * Detach the mbufs from a chain built by lwip_pbuf_from_mbuf(), handing
+ * their ownership back to the caller; freeing the pbufs then releases
+ * only the wrappers.
+ */
+void lwip_pbuf_disown(struct pbuf *p);
+
+/*
+ * Wrap a pbuf in a chain of external-data mbufs headed by a pkthdr
+ * mbuf with 'usrhdr_len' bytes of user header.  On success the pbuf
+ * reference is owned by the returned chain; freeing the chain releases
+ * it.  On failure NULL is returned and the caller keeps its reference.
+ */
+struct os_mbuf *lwip_mbuf_from_pbuf(struct pbuf *p, uint16_t usrhdr_len);
+
+int lwip_mbuf_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IP_LWIP_MBUF_H__ */
@@ -107,6 +107,9 @@ extern "C" {
 /* PBUF_POOL_BUFSIZE: the size of each pbuf in the pbuf pool. */
 #define PBUF_POOL_BUFSIZE               1580
 
+/* Custom pbufs back the zero-copy os_mbuf bridge (ip/lwip_mbuf.h). */
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+
 /* PBUF_LINK_HLEN: the number of bytes that should be allocated for a
    link level header. */
 #define PBUF_LINK_HLEN                  16
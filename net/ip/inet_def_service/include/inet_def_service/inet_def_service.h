@@ -26,6 +26,11 @@ extern "C" {
 
 struct os_eventq;
 
+/**
+ * Starts the default IP services (echo, discard, chargen).  Socket
+ * events are dispatched to a pool of INET_DEF_SERVICE_WORKERS worker
+ * tasks; 'evq' is only used when the pool is configured empty.
+ */
 void inet_def_service_init(struct os_eventq *evq);
 
 #ifdef __cplusplus
@@ -19,10 +19,12 @@
 #include <assert.h>
 #include <string.h>
 
+#include <syscfg/syscfg.h>
 #include <os/os.h>
 #include <os/endian.h>
 #include <mn_socket/mn_socket.h>
 #include <console/console.h>
+#include <stats/stats.h>
 
 #include "inet_def_service/inet_def_service.h"
 
@@ -41,8 +43,48 @@ enum inet_def_type {
 static const char chargen_pattern[] = "1234567890";
 #define CHARGEN_PATTERN_SZ   (sizeof(chargen_pattern) - 1)
 
+#define INET_DEF_NWORKERS    MYNEWT_VAL(INET_DEF_SERVICE_WORKERS)
+
 static struct os_eventq *inet_def_evq;
 
+#if INET_DEF_NWORKERS > 0
+/*
+ * Worker pool. Each service type is pinned to one worker eventq, so a
+ * service callback stalling (e.g. chargen waiting for mbufs) only holds
+ * up the services sharing its worker, not every IP service on the node.
+ */
+static struct os_task inet_def_worker_task[INET_DEF_NWORKERS];
+static struct os_eventq inet_def_worker_evq[INET_DEF_NWORKERS];
+static os_stack_t inet_def_worker_stack[INET_DEF_NWORKERS][
+    OS_STACK_ALIGN(MYNEWT_VAL(INET_DEF_SERVICE_WORKER_STACK_SIZE))];
+#endif
+
+/*
+ * Per-service counters; queue depth watermark is updated as socket
+ * events are queued for the service.
+ */
+STATS_SECT_START(inet_def_stats)
+    STATS_SECT_ENTRY(conns)
+    STATS_SECT_ENTRY(conns_refused)
+    STATS_SECT_ENTRY(events)
+    STATS_SECT_ENTRY(q_hwm)
+STATS_SECT_END
+
+STATS_NAME_START(inet_def_stats)
+    STATS_NAME(inet_def_stats, conns)
+    STATS_NAME(inet_def_stats, conns_refused)
+    STATS_NAME(inet_def_stats, events)
+    STATS_NAME(inet_def_stats, q_hwm)
+STATS_NAME_END(inet_def_stats)
+
+static STATS_SECT_DECL(inet_def_stats) inet_def_stats[INET_DEF_MAXTYPE];
+
+static char *inet_def_stat_names[INET_DEF_MAXTYPE] = {
+    "inetsvc_echo",
+    "inetsvc_discard",
+    "inetsvc_chargen"
+};
+
 struct inet_def_event {
     struct os_event ide_ev;
     enum inet_def_type ide_type;
@@ -72,17 +114,53 @@ struct inet_def_tcp {
  */
 struct inet_def_listen {
     struct mn_socket *socket;
-    uint32_t conn_cnt;
+    uint32_t conn_cnt;                  /* Currently open connections */
 };
 
 static struct inet_def {
     struct inet_def_listen tcp_service[INET_DEF_MAXTYPE];
     struct inet_def_udp udp_service[INET_DEF_MAXTYPE];
+    uint32_t q_len[INET_DEF_MAXTYPE];   /* Events queued per service */
     SLIST_HEAD(, inet_def_tcp) tcp_conns; /* List of connected TCP sockets */
 } inet_def;
 
 static void inet_def_event(struct os_event *ev);
 
+/*
+ * Eventq which feeds the given service; the caller-supplied queue when
+ * no workers are configured.
+ */
+static struct os_eventq *
+inet_def_svc_evq(enum inet_def_type type)
+{
+#if INET_DEF_NWORKERS > 0
+    return &inet_def_worker_evq[type % INET_DEF_NWORKERS];
+#else
+    return inet_def_evq;
+#endif
+}
+
+/*
+ * Queue a socket event to its service, maintaining the per-service
+ * queue depth. Called in context of IP stack task.
+ */
+static void
+inet_def_enqueue(struct inet_def_event *ide)
+{
+    uint32_t depth;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (!ide->ide_ev.ev_queued) {
+        depth = ++inet_def.q_len[ide->ide_type];
+        if (depth > inet_def_stats[ide->ide_type].sq_hwm) {
+            inet_def_stats[ide->ide_type].sq_hwm = depth;
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+    os_eventq_put(inet_def_svc_evq(ide->ide_type), &ide->ide_ev);
+}
+
 /*
  * UDP socket callbacks. Called in context of IP stack task.
  */
@@ -91,7 +169,7 @@ inet_def_udp_readable(void *arg, int err)
 {
     struct inet_def_udp *idu = (struct inet_def_udp *)arg;
 
-    os_eventq_put(inet_def_evq, &idu->ev.ide_ev);
+    inet_def_enqueue(&idu->ev);
 }
 
 static const union mn_socket_cb inet_udp_cbs = {
@@ -114,7 +192,7 @@ inet_def_tcp_readable(void *arg, int err)
          */
         SLIST_REMOVE(&inet_def.tcp_conns, idt, inet_def_tcp, list);
     }
-    os_eventq_put(inet_def_evq, &idt->ev.ide_ev);
+    inet_def_enqueue(&idt->ev);
 }
 
 static const union mn_socket_cb inet_tcp_cbs = {
@@ -131,8 +209,16 @@ static int inet_def_newconn(void *arg, struct mn_socket *new)
     struct inet_def_tcp *idt;
     enum inet_def_type type;
 
+    type = idl - &inet_def.tcp_service[0];
+
+    if (idl->conn_cnt >= MYNEWT_VAL(INET_DEF_SERVICE_MAX_CONNS)) {
+        STATS_INC(inet_def_stats[type], conns_refused);
+        return -1;
+    }
+
     idt = (struct inet_def_tcp *)os_malloc(sizeof(*idt));
     if (!idt) {
+        STATS_INC(inet_def_stats[type], conns_refused);
         return -1;
     }
 
@@ -143,18 +229,19 @@ static int inet_def_newconn(void *arg, struct mn_socket *new)
      * Event type tells what type of service this connection belongs to.
      * Ev_arg says whether it's TCP or UDP.
      */
-    type = idl - &inet_def.tcp_service[0];
     idt->ev.ide_type = type;
     idt->ev.ide_ev.ev_cb = inet_def_event;
     idt->ev.ide_ev.ev_arg = (void *)MN_SOCK_STREAM;
     mn_socket_set_cbs(new, idt, &inet_tcp_cbs);
     SLIST_INSERT_HEAD(&inet_def.tcp_conns, idt, list);
+    idl->conn_cnt++;
+    STATS_INC(inet_def_stats[type], conns);
 
     if (type == INET_DEF_CHARGEN) {
         /*
          * Start transmitting right away.
          */
-        os_eventq_put(inet_def_evq, &idt->ev.ide_ev);
+        inet_def_enqueue(&idt->ev);
     }
     return 0;
 }
@@ -225,6 +312,7 @@ inet_def_event(struct os_event *ev)
     struct mn_socket *sock;
     struct mn_sockaddr_in msin;
     struct os_mbuf *m;
+    os_sr_t sr;
     int rc;
     int off;
     int loop_cnt;
@@ -232,6 +320,12 @@ inet_def_event(struct os_event *ev)
     ide = (struct inet_def_event *)ev;
     idt = (struct inet_def_tcp *)ev;
     idu = (struct inet_def_udp *)ev;
+
+    OS_ENTER_CRITICAL(sr);
+    inet_def.q_len[ide->ide_type]--;
+    OS_EXIT_CRITICAL(sr);
+    STATS_INC(inet_def_stats[ide->ide_type], events);
+
     if ((int)ev->ev_arg == MN_SOCK_DGRAM) {
         sock = idu->socket;
     } else {
@@ -302,110 +396,26 @@ inet_def_event(struct os_event *ev)
          * callback. Close the socket and free the memory.
          */
         mn_socket_set_cbs(idt->socket, NULL, NULL);
-        os_eventq_remove(inet_def_evq, &idt->ev.ide_ev);
+        OS_ENTER_CRITICAL(sr);
+        if (idt->ev.ide_ev.ev_queued) {
+            inet_def.q_len[ide->ide_type]--;
+        }
+        os_eventq_remove(inet_def_svc_evq(ide->ide_type), &idt->ev.ide_ev);
+        OS_EXIT_CRITICAL(sr);
+        inet_def.tcp_service[ide->ide_type].conn_cnt--;
         mn_close(idt->socket);
         os_free(idt);
     }
 }
 
-#if 0
+#if INET_DEF_NWORKERS > 0
 static void
-inet_def_srv(void *arg)
+inet_def_worker(void *arg)
 {
-    struct inet_def_udp *idu;
-    struct inet_def_tcp *idt;
-    struct mn_socket *sock;
-    struct os_event *ev;
-    struct mn_sockaddr_in msin;
-    struct os_mbuf *m;
-    enum inet_def_type type;
-    int rc;
-    int off;
-    int loop_cnt;
+    struct os_eventq *evq = (struct os_eventq *)arg;
 
     while (1) {
-        /*
-         * Wait here. When event comes, check what type of socket got it,
-         * and then act on it.
-         */
-        ev = os_eventq_get(inet_def_evq);
-        type = ev->ev_type;
-        idt = (struct inet_def_tcp *)ev;
-        idu = (struct inet_def_udp *)ev;
-        if ((int)ev->ev_arg == MN_SOCK_DGRAM) {
-            sock = idu->socket;
-        } else {
-            sock = idt->socket;
-        }
-        switch (type) {
-        case INET_DEF_ECHO:
-            while (mn_recvfrom(sock, &m, (struct mn_sockaddr *)&msin) == 0) {
-                console_printf("echo %d bytes\n", OS_MBUF_PKTLEN(m));
-                rc = mn_sendto(sock, m, (struct mn_sockaddr *)&msin);
-                if (rc) {
-                    console_printf("  failed: %d!!!!\n", rc);
-                    os_mbuf_free_chain(m);
-                }
-            }
-            break;
-        case INET_DEF_DISCARD:
-            while (mn_recvfrom(sock, &m, NULL) == 0) {
-                console_printf("discard %d bytes\n", OS_MBUF_PKTLEN(m));
-                os_mbuf_free_chain(m);
-            }
-            break;
-        case INET_DEF_CHARGEN:
-            while (mn_recvfrom(sock, &m, NULL) == 0) {
-                os_mbuf_free_chain(m);
-            }
-            if ((int)ev->ev_arg == MN_SOCK_STREAM && idt->closed) {
-                /*
-                 * Don't try to send tons of data to a closed socket.
-                 */
-                break;
-            }
-            loop_cnt = 0;
-            do {
-                m = os_msys_get(CHARGEN_WRITE_SZ, 0);
-                if (m) {
-                    for (off = 0;
-                         OS_MBUF_TRAILINGSPACE(m) >= CHARGEN_PATTERN_SZ;
-                         off += CHARGEN_PATTERN_SZ) {
-                        os_mbuf_copyinto(m, off, chargen_pattern,
-                          CHARGEN_PATTERN_SZ);
-                    }
-                    console_printf("chargen %d bytes\n", m->om_len);
-                    rc = mn_sendto(sock, m, NULL); /* assumes TCP for now */
-                    if (rc) {
-                        os_mbuf_free_chain(m);
-                        if (rc != MN_ENOBUFS && rc != MN_EAGAIN) {
-                            console_write("  sendto fail!!! %d\n", rc);
-                        }
-                        break;
-                    }
-                } else {
-                    /*
-                     * Mbuf shortage. Wait for them to appear.
-                     */
-                    os_time_delay(1);
-                }
-                loop_cnt++;
-            } while (loop_cnt < 32);
-            break;
-        default:
-            assert(0);
-            break;
-        }
-        if ((int)ev->ev_arg == MN_SOCK_STREAM && idt->closed) {
-            /*
-             * Remote end has closed the connection, as indicated in the
-             * callback. Close the socket and free the memory.
-             */
-            mn_socket_set_cbs(idt->socket, NULL, NULL);
-            os_eventq_remove(&inet_def_evq, &idt->ev);
-            mn_close(idt->socket);
-            os_free(idt);
-        }
+        os_eventq_run(evq);
     }
 }
 #endif
@@ -414,17 +424,35 @@ void
 inet_def_service_init(struct os_eventq *evq)
 {
     int i;
-
-    inet_def_create_srv(INET_DEF_ECHO, ECHO_PORT);
-    inet_def_create_srv(INET_DEF_DISCARD, DISCARD_PORT);
-    inet_def_create_srv(INET_DEF_CHARGEN, CHARGEN_PORT);
+    int rc;
 
     inet_def_evq = evq;
+#if INET_DEF_NWORKERS > 0
+    for (i = 0; i < INET_DEF_NWORKERS; i++) {
+        os_eventq_init(&inet_def_worker_evq[i]);
+        rc = os_task_init(&inet_def_worker_task[i], "inetsvc",
+          inet_def_worker, &inet_def_worker_evq[i],
+          MYNEWT_VAL(INET_DEF_SERVICE_WORKER_PRIO) + i, OS_WAIT_FOREVER,
+          inet_def_worker_stack[i],
+          OS_STACK_ALIGN(MYNEWT_VAL(INET_DEF_SERVICE_WORKER_STACK_SIZE)));
+        assert(rc == 0);
+    }
+#endif
+    for (i = 0; i < INET_DEF_MAXTYPE; i++) {
+        rc = stats_init_and_reg(STATS_HDR(inet_def_stats[i]),
+          STATS_SIZE_INIT_PARMS(inet_def_stats[i], STATS_SIZE_32),
+          STATS_NAME_INIT_PARMS(inet_def_stats), inet_def_stat_names[i]);
+        assert(rc == 0);
+    }
+
     SLIST_INIT(&inet_def.tcp_conns);
-    for (i = 0; i < 3; i++) {
+    for (i = 0; i < INET_DEF_MAXTYPE; i++) {
         inet_def.udp_service[i].ev.ide_type = i;
         inet_def.udp_service[i].ev.ide_ev.ev_cb = inet_def_event;
         inet_def.udp_service[i].ev.ide_ev.ev_arg = (void *)MN_SOCK_DGRAM;
     }
-}
 
+    inet_def_create_srv(INET_DEF_ECHO, ECHO_PORT);
+    inet_def_create_srv(INET_DEF_DISCARD, DISCARD_PORT);
+    inet_def_create_srv(INET_DEF_CHARGEN, CHARGEN_PORT);
+}
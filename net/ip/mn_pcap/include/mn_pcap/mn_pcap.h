@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef __MN_PCAP_H__
+#define __MN_PCAP_H__
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct mn_socket;
+struct mn_sockaddr;
+
+/*
+ * Capture and replay of mn_socket traffic for sim builds. Captured
+ * packets are written as standard pcap records (LINKTYPE_RAW) with a
+ * synthesized IPv4/UDP header carrying the peer address and ports, so
+ * the files open directly in pcap tooling. Stream payloads are framed
+ * the same way; the framing identifies the flow, not the transport.
+ */
+
+/*
+ * Counters accumulated by mn_pcap_replay().
+ */
+struct mn_pcap_replay_stats {
+    uint32_t mprs_pkts;                 /* Packets sent */
+    uint32_t mprs_bytes;                /* Payload bytes sent */
+    uint32_t mprs_errs;                 /* Records dropped or send failures */
+};
+
+/**
+ * Starts capturing all mn_socket traffic to a pcap file at 'path'.
+ * Requires MN_SOCKET_TAP; replaces any previously registered tap.
+ *
+ * @return                      0 on success; MN_EINVAL if the file
+ *                              cannot be created.
+ */
+int mn_pcap_start(const char *path);
+
+/**
+ * Stops a capture started with mn_pcap_start() and closes the file.
+ */
+void mn_pcap_stop(void);
+
+/**
+ * Replays the payloads from a capture file through 'sock' to 'to',
+ * paced by the capture timestamps. 'speed' is an acceleration factor:
+ * 1 replays in real time, N at N times the captured rate, 0 with no
+ * pacing at all. Runs in the calling task; sends that fail with
+ * MN_ENOBUFS/MN_EAGAIN are retried after a short delay.
+ *
+ * @param path                  Capture file to replay.
+ * @param sock                  Socket to send through.
+ * @param to                    Destination address; NULL for connected
+ *                              sockets.
+ * @param speed                 Acceleration factor; 0 for full speed.
+ * @param stats                 Filled with replay counters; may be NULL.
+ *
+ * @return                      0 on success; MN_EINVAL if the file is
+ *                              missing or not a capture this package
+ *                              wrote.
+ */
+int mn_pcap_replay(const char *path, struct mn_socket *sock,
+  struct mn_sockaddr *to, uint16_t speed,
+  struct mn_pcap_replay_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MN_PCAP_H__ */
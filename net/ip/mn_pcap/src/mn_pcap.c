@@ -0,0 +1,305 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include <os/os.h>
+#include <os/endian.h>
+#include <mn_socket/mn_socket.h>
+
+#include "mn_pcap/mn_pcap.h"
+
+#define MN_PCAP_MAGIC           0xa1b2c3d4
+#define MN_PCAP_VER_MAJOR       2
+#define MN_PCAP_VER_MINOR       4
+#define MN_PCAP_LINKTYPE_RAW    101
+#define MN_PCAP_SNAPLEN         65535
+
+/* Synthesized IPv4 + UDP framing in front of each payload. */
+#define MN_PCAP_FRAME_SZ        28
+
+/* Largest payload a replayed record may carry. */
+#define MN_PCAP_REPLAY_MAX      2048
+
+#define MN_PCAP_SEND_RETRIES    10
+
+struct mn_pcap_file_hdr {
+    uint32_t pfh_magic;
+    uint16_t pfh_ver_major;
+    uint16_t pfh_ver_minor;
+    int32_t pfh_thiszone;
+    uint32_t pfh_sigfigs;
+    uint32_t pfh_snaplen;
+    uint32_t pfh_linktype;
+};
+
+struct mn_pcap_rec_hdr {
+    uint32_t prh_ts_sec;
+    uint32_t prh_ts_usec;
+    uint32_t prh_incl_len;
+    uint32_t prh_orig_len;
+};
+
+struct mn_pcap_frame {
+    uint8_t pf_ver_ihl;
+    uint8_t pf_tos;
+    uint16_t pf_len;
+    uint16_t pf_id;
+    uint16_t pf_frag;
+    uint8_t pf_ttl;
+    uint8_t pf_proto;
+    uint16_t pf_csum;
+    uint32_t pf_src;
+    uint32_t pf_dst;
+    uint16_t pf_sport;
+    uint16_t pf_dport;
+    uint16_t pf_ulen;
+    uint16_t pf_ucsum;
+};
+
+static FILE *mn_pcap_fp;
+
+static uint16_t
+mn_pcap_ip_csum(struct mn_pcap_frame *pf)
+{
+    uint16_t *w = (uint16_t *)pf;
+    uint32_t sum;
+    int i;
+
+    sum = 0;
+    for (i = 0; i < 10; i++) {
+        sum += w[i];
+    }
+    sum = (sum >> 16) + (sum & 0xffff);
+    sum += (sum >> 16);
+    return ~sum;
+}
+
+/*
+ * Capture tap. Called with every packet crossing the mn_socket layer.
+ */
+static void
+mn_pcap_tap(struct mn_socket *sock, const struct os_mbuf *m,
+  const struct mn_sockaddr *addr, int dir)
+{
+    const struct mn_sockaddr_in *msin;
+    const struct os_mbuf *n;
+    struct mn_pcap_rec_hdr prh;
+    struct mn_pcap_frame pf;
+    struct os_timeval tv;
+    uint16_t plen;
+
+    if (!mn_pcap_fp) {
+        return;
+    }
+
+    plen = OS_MBUF_PKTLEN(m);
+
+    os_gettimeofday(&tv, NULL);
+    prh.prh_ts_sec = tv.tv_sec;
+    prh.prh_ts_usec = tv.tv_usec;
+    prh.prh_incl_len = MN_PCAP_FRAME_SZ + plen;
+    prh.prh_orig_len = prh.prh_incl_len;
+
+    memset(&pf, 0, sizeof(pf));
+    pf.pf_ver_ihl = 0x45;
+    pf.pf_len = htons(MN_PCAP_FRAME_SZ + plen);
+    pf.pf_ttl = 64;
+    pf.pf_proto = 17;                   /* UDP */
+    if (addr && addr->msa_family == MN_AF_INET) {
+        msin = (const struct mn_sockaddr_in *)addr;
+        if (dir == MN_SOCKET_TAP_RX) {
+            pf.pf_src = msin->msin_addr.s_addr;
+            pf.pf_sport = msin->msin_port;
+        } else {
+            pf.pf_dst = msin->msin_addr.s_addr;
+            pf.pf_dport = msin->msin_port;
+        }
+    }
+    pf.pf_ulen = htons(8 + plen);
+    pf.pf_csum = mn_pcap_ip_csum(&pf);
+
+    fwrite(&prh, sizeof(prh), 1, mn_pcap_fp);
+    fwrite(&pf, sizeof(pf), 1, mn_pcap_fp);
+    for (n = m; n; n = SLIST_NEXT(n, om_next)) {
+        if (n->om_len) {
+            fwrite(n->om_data, n->om_len, 1, mn_pcap_fp);
+        }
+    }
+}
+
+int
+mn_pcap_start(const char *path)
+{
+    struct mn_pcap_file_hdr pfh;
+    FILE *fp;
+
+    fp = fopen(path, "wb");
+    if (!fp) {
+        return MN_EINVAL;
+    }
+
+    memset(&pfh, 0, sizeof(pfh));
+    pfh.pfh_magic = MN_PCAP_MAGIC;
+    pfh.pfh_ver_major = MN_PCAP_VER_MAJOR;
+    pfh.pfh_ver_minor = MN_PCAP_VER_MINOR;
+    pfh.pfh_snaplen = MN_PCAP_SNAPLEN;
+    pfh.pfh_linktype = MN_PCAP_LINKTYPE_RAW;
+    fwrite(&pfh, sizeof(pfh), 1, fp);
+
+    mn_pcap_fp = fp;
+    mn_socket_set_tap(mn_pcap_tap);
+    return 0;
+}
+
+void
+mn_pcap_stop(void)
+{
+    FILE *fp;
+
+    mn_socket_set_tap(NULL);
+    fp = mn_pcap_fp;
+    mn_pcap_fp = NULL;
+    if (fp) {
+        fclose(fp);
+    }
+}
+
+/*
+ * Reads 'len' bytes of payload into an mbuf chain.
+ */
+static struct os_mbuf *
+mn_pcap_read_payload(FILE *fp, uint32_t len)
+{
+    struct os_mbuf *m;
+    uint8_t buf[128];
+    uint32_t blk;
+
+    m = os_msys_get_pkthdr(len, 0);
+    if (!m) {
+        return NULL;
+    }
+    while (len) {
+        blk = len > sizeof(buf) ? sizeof(buf) : len;
+        if (fread(buf, blk, 1, fp) != 1 ||
+          os_mbuf_append(m, buf, blk)) {
+            os_mbuf_free_chain(m);
+            return NULL;
+        }
+        len -= blk;
+    }
+    return m;
+}
+
+int
+mn_pcap_replay(const char *path, struct mn_socket *sock,
+  struct mn_sockaddr *to, uint16_t speed, struct mn_pcap_replay_stats *stats)
+{
+    struct mn_pcap_replay_stats st;
+    struct mn_pcap_file_hdr pfh;
+    struct mn_pcap_rec_hdr prh;
+    struct os_mbuf *m;
+    uint32_t prev_sec;
+    uint32_t prev_usec;
+    uint32_t delay_ms;
+    uint32_t ticks;
+    uint32_t plen;
+    int have_prev;
+    int retry;
+    long rec_end;
+    FILE *fp;
+    int rc;
+
+    memset(&st, 0, sizeof(st));
+
+    fp = fopen(path, "rb");
+    if (!fp) {
+        return MN_EINVAL;
+    }
+    if (fread(&pfh, sizeof(pfh), 1, fp) != 1 ||
+      pfh.pfh_magic != MN_PCAP_MAGIC ||
+      pfh.pfh_linktype != MN_PCAP_LINKTYPE_RAW) {
+        fclose(fp);
+        return MN_EINVAL;
+    }
+
+    have_prev = 0;
+    prev_sec = 0;
+    prev_usec = 0;
+    while (fread(&prh, sizeof(prh), 1, fp) == 1) {
+        if (prh.prh_incl_len < MN_PCAP_FRAME_SZ ||
+          prh.prh_incl_len > MN_PCAP_FRAME_SZ + MN_PCAP_REPLAY_MAX) {
+            if (fseek(fp, prh.prh_incl_len, SEEK_CUR)) {
+                break;
+            }
+            st.mprs_errs++;
+            continue;
+        }
+        if (fseek(fp, MN_PCAP_FRAME_SZ, SEEK_CUR)) {
+            break;
+        }
+        plen = prh.prh_incl_len - MN_PCAP_FRAME_SZ;
+
+        /*
+         * Pace by the captured inter-packet gap, scaled by 'speed'.
+         */
+        if (speed && have_prev) {
+            delay_ms = (prh.prh_ts_sec - prev_sec) * 1000 +
+              ((int32_t)(prh.prh_ts_usec - prev_usec)) / 1000;
+            delay_ms /= speed;
+            if (delay_ms && os_time_ms_to_ticks(delay_ms, &ticks) == 0) {
+                os_time_delay(ticks);
+            }
+        }
+        prev_sec = prh.prh_ts_sec;
+        prev_usec = prh.prh_ts_usec;
+        have_prev = 1;
+
+        rec_end = ftell(fp) + plen;
+        m = mn_pcap_read_payload(fp, plen);
+        if (!m) {
+            st.mprs_errs++;
+            if (fseek(fp, rec_end, SEEK_SET)) {
+                break;
+            }
+            continue;
+        }
+        for (retry = 0; ; retry++) {
+            rc = mn_sendto(sock, m, to);
+            if (rc == 0) {
+                st.mprs_pkts++;
+                st.mprs_bytes += plen;
+                break;
+            }
+            if ((rc != MN_ENOBUFS && rc != MN_EAGAIN) ||
+              retry >= MN_PCAP_SEND_RETRIES) {
+                os_mbuf_free_chain(m);
+                st.mprs_errs++;
+                break;
+            }
+            os_time_delay(1);
+        }
+    }
+    fclose(fp);
+
+    if (stats) {
+        *stats = st;
+    }
+    return 0;
+}
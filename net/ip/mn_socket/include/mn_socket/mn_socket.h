@@ -21,6 +21,8 @@
 
 #include <inttypes.h>
 
+#include <syscfg/syscfg.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -166,6 +168,55 @@ int mn_recvfrom(struct mn_socket *, struct os_mbuf **,
   struct mn_sockaddr *from);
 int mn_sendto(struct mn_socket *, struct os_mbuf *, struct mn_sockaddr *to);
 
+/*
+ * Vectored I/O.  An iovec array describes data fragments which are
+ * wrapped into an mbuf chain without copying.
+ */
+struct mn_iovec {
+    void *miov_base;
+    uint16_t miov_len;
+};
+
+/*
+ * Wrap an iovec array in an mbuf chain of external-buffer mbufs; the
+ * fragments themselves are not copied.
+ */
+int mn_iovec_to_mbuf(const struct mn_iovec *iov, int iovcnt,
+  struct os_mbuf **mp);
+
+/*
+ * Map an mbuf chain onto an iovec array, one entry per non-empty
+ * segment.  On entry *iovcnt holds the array capacity; on success it
+ * is set to the number of entries used.  Returns MN_ENOBUFS if the
+ * chain has more segments than the array can describe.
+ */
+int mn_mbuf_to_iovec(struct os_mbuf *m, struct mn_iovec *iov, int *iovcnt);
+
+/*
+ * mn_sendv() wraps the fragments and hands them to mn_sendto(); they
+ * are not copied, so each fragment must stay valid until the socket
+ * reports writable.
+ *
+ * mn_recvv() receives a packet and maps its segments onto 'iov';
+ * the chain is returned in '*mp' and must be freed by the caller
+ * once the iovec contents have been consumed.  If the chain has more
+ * segments than the array holds, MN_ENOBUFS is returned and the
+ * (unmapped) chain is still handed over through '*mp'.
+ */
+int mn_sendv(struct mn_socket *, const struct mn_iovec *iov, int iovcnt,
+  struct mn_sockaddr *to);
+int mn_recvv(struct mn_socket *, struct mn_iovec *iov, int *iovcnt,
+  struct os_mbuf **mp, struct mn_sockaddr *from);
+
+/*
+ * Like mn_recvfrom(), but the packet is left queued on the socket and
+ * remains owned by it; the caller must not free the chain and the
+ * pointer is only valid until the next receive or close.  Returns
+ * MN_EPROTONOSUPPORT if the socket provider cannot peek.
+ */
+int mn_peekfrom(struct mn_socket *, struct os_mbuf **,
+  struct mn_sockaddr *from);
+
 int mn_getsockopt(struct mn_socket *, uint8_t level, uint8_t optname,
   void *optval);
 int mn_setsockopt(struct mn_socket *, uint8_t level, uint8_t optname,
@@ -176,6 +227,23 @@ int mn_getpeername(struct mn_socket *, struct mn_sockaddr *);
 
 int mn_close(struct mn_socket *);
 
+#if MYNEWT_VAL(MN_SOCKET_TAP)
+/*
+ * Packet tap. When registered, the tap is called with every packet
+ * passing through mn_sendto()/mn_recvfrom(), before the socket
+ * provider consumes it.  'addr' is the peer address when known, NULL
+ * for connected stream sockets.  Sim-only tooling (e.g. net/ip/mn_pcap)
+ * uses this to capture traffic for offline analysis and replay.
+ */
+#define MN_SOCKET_TAP_RX        0
+#define MN_SOCKET_TAP_TX        1
+
+typedef void (*mn_socket_tap_fn)(struct mn_socket *, const struct os_mbuf *,
+  const struct mn_sockaddr *, int dir);
+
+void mn_socket_set_tap(mn_socket_tap_fn fn);
+#endif
+
 #define mn_socket_set_cbs(sock, cb_arg, cbs)                            \
     do {                                                                \
         (sock)->ms_cbs = (cbs);                                         \
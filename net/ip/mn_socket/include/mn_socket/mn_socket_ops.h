@@ -45,6 +45,9 @@ struct mn_socket_ops {
       struct mn_sockaddr *to);
     int (*mso_recvfrom)(struct mn_socket *, struct os_mbuf **,
       struct mn_sockaddr *from);
+    /* optional; leaves the packet queued and owned by the socket */
+    int (*mso_peekfrom)(struct mn_socket *, struct os_mbuf **,
+      struct mn_sockaddr *from);
 
     int (*mso_getsockopt)(struct mn_socket *, uint8_t level, uint8_t name,
       void *val);
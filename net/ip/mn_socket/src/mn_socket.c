@@ -21,6 +21,7 @@
 #include <assert.h>
 
 #include <os/os.h>
+#include <os/os_mbuf.h>
 
 #include "mn_socket/mn_socket.h"
 #include "mn_socket/mn_socket_ops.h"
@@ -33,6 +34,16 @@ static const struct mn_socket_ops *mn_sock_tgt;
 /** All zeros. */
 const uint32_t nm_in6addr_any[4];
 
+#if MYNEWT_VAL(MN_SOCKET_TAP)
+static mn_socket_tap_fn mn_socket_tap;
+
+void
+mn_socket_set_tap(mn_socket_tap_fn fn)
+{
+    mn_socket_tap = fn;
+}
+#endif
+
 int
 mn_socket_ops_reg(const struct mn_socket_ops *ops)
 {
@@ -86,15 +97,124 @@ mn_listen(struct mn_socket *s, uint8_t qlen)
 int
 mn_recvfrom(struct mn_socket *s, struct os_mbuf **mp, struct mn_sockaddr *from)
 {
-    return s->ms_ops->mso_recvfrom(s, mp, from);
+    int rc;
+
+    rc = s->ms_ops->mso_recvfrom(s, mp, from);
+#if MYNEWT_VAL(MN_SOCKET_TAP)
+    if (rc == 0 && mn_socket_tap) {
+        mn_socket_tap(s, *mp, from, MN_SOCKET_TAP_RX);
+    }
+#endif
+    return rc;
 }
 
 int
 mn_sendto(struct mn_socket *s, struct os_mbuf *m, struct mn_sockaddr *to)
 {
+#if MYNEWT_VAL(MN_SOCKET_TAP)
+    /*
+     * Tap before handing off; the provider consumes the chain on
+     * success. A send the provider then rejects still gets captured.
+     */
+    if (mn_socket_tap) {
+        mn_socket_tap(s, m, to, MN_SOCKET_TAP_TX);
+    }
+#endif
     return s->ms_ops->mso_sendto(s, m, to);
 }
 
+int
+mn_iovec_to_mbuf(const struct mn_iovec *iov, int iovcnt, struct os_mbuf **mp)
+{
+    struct os_mbuf *m;
+    struct os_mbuf *n;
+    int i;
+
+    m = os_msys_get_pkthdr(0, 0);
+    if (!m) {
+        return MN_ENOBUFS;
+    }
+    for (i = 0; i < iovcnt; i++) {
+        n = os_msys_get_ext(iov[i].miov_base, iov[i].miov_len, NULL, NULL);
+        if (!n) {
+            os_mbuf_free_chain(m);
+            return MN_ENOBUFS;
+        }
+        os_mbuf_concat(m, n);
+    }
+    *mp = m;
+    return 0;
+}
+
+int
+mn_mbuf_to_iovec(struct os_mbuf *m, struct mn_iovec *iov, int *iovcnt)
+{
+    struct os_mbuf *n;
+    int cnt;
+
+    cnt = 0;
+    for (n = m; n; n = SLIST_NEXT(n, om_next)) {
+        if (n->om_len == 0) {
+            continue;
+        }
+        if (cnt >= *iovcnt) {
+            return MN_ENOBUFS;
+        }
+        iov[cnt].miov_base = n->om_data;
+        iov[cnt].miov_len = n->om_len;
+        cnt++;
+    }
+    *iovcnt = cnt;
+    return 0;
+}
+
+int
+mn_sendv(struct mn_socket *s, const struct mn_iovec *iov, int iovcnt,
+  struct mn_sockaddr *to)
+{
+    struct os_mbuf *m;
+    int rc;
+
+    rc = mn_iovec_to_mbuf(iov, iovcnt, &m);
+    if (rc) {
+        return rc;
+    }
+    rc = s->ms_ops->mso_sendto(s, m, to);
+    if (rc) {
+        /*
+         * The wrappers are ours; the caller's fragments are untouched.
+         */
+        os_mbuf_free_chain(m);
+    }
+    return rc;
+}
+
+int
+mn_recvv(struct mn_socket *s, struct mn_iovec *iov, int *iovcnt,
+  struct os_mbuf **mp, struct mn_sockaddr *from)
+{
+    struct os_mbuf *m;
+    int rc;
+
+    rc = s->ms_ops->mso_recvfrom(s, &m, from);
+    if (rc) {
+        *mp = NULL;
+        return rc;
+    }
+    *mp = m;
+    return mn_mbuf_to_iovec(m, iov, iovcnt);
+}
+
+int
+mn_peekfrom(struct mn_socket *s, struct os_mbuf **mp, struct mn_sockaddr *from)
+{
+    if (!s->ms_ops->mso_peekfrom) {
+        *mp = NULL;
+        return MN_EPROTONOSUPPORT;
+    }
+    return s->ms_ops->mso_peekfrom(s, mp, from);
+}
+
 int
 mn_getsockopt(struct mn_socket *s, uint8_t level, uint8_t name, void *val)
 {
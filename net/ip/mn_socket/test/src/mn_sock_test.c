@@ -41,6 +41,7 @@ static struct os_mbuf_pool test_mbuf_pool;
 
 TEST_CASE_DECL(inet_pton_test)
 TEST_CASE_DECL(inet_ntop_test)
+TEST_CASE_DECL(iovec_test)
 TEST_CASE_DECL(socket_tests)
 
 TEST_SUITE(mn_socket_test_all)
@@ -58,6 +59,7 @@ TEST_SUITE(mn_socket_test_all)
 
     inet_pton_test();
     inet_ntop_test();
+    iovec_test();
     socket_tests();
 }
 
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "mn_sock_test.h"
+
+TEST_CASE(iovec_test)
+{
+    char hdr[] = "hdr:";
+    char body[] = "payload-bytes";
+    struct mn_iovec iov[4];
+    struct mn_iovec out_iov[4];
+    struct os_mbuf *m;
+    uint8_t buf[32];
+    int cnt;
+    int rc;
+
+    iov[0].miov_base = hdr;
+    iov[0].miov_len = 4;
+    iov[1].miov_base = body;
+    iov[1].miov_len = sizeof(body) - 1;
+
+    rc = mn_iovec_to_mbuf(iov, 2, &m);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(OS_MBUF_PKTLEN(m) == 4 + sizeof(body) - 1);
+
+    rc = os_mbuf_copydata(m, 0, OS_MBUF_PKTLEN(m), buf);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(!memcmp(buf, "hdr:payload-bytes", 17));
+
+    /*
+     * The fragments are wrapped, not copied.
+     */
+    hdr[0] = 'H';
+    rc = os_mbuf_copydata(m, 0, 1, buf);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(buf[0] == 'H');
+
+    /*
+     * Map the chain back; the pkthdr mbuf is empty and must not
+     * produce an entry.
+     */
+    cnt = 4;
+    rc = mn_mbuf_to_iovec(m, out_iov, &cnt);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cnt == 2);
+    TEST_ASSERT(out_iov[0].miov_base == (void *)hdr);
+    TEST_ASSERT(out_iov[0].miov_len == 4);
+    TEST_ASSERT(out_iov[1].miov_base == (void *)body);
+    TEST_ASSERT(out_iov[1].miov_len == sizeof(body) - 1);
+
+    /*
+     * Array too small for the segments.
+     */
+    cnt = 1;
+    rc = mn_mbuf_to_iovec(m, out_iov, &cnt);
+    TEST_ASSERT(rc == MN_ENOBUFS);
+
+    rc = os_mbuf_free_chain(m);
+    TEST_ASSERT(rc == 0);
+}
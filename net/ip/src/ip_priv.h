@@ -20,6 +20,8 @@
 #ifndef __IP_PRIV_H__
 #define __IP_PRIV_H__
 
+#include <syscfg/syscfg.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,6 +32,33 @@ int lwip_itf_getnext(struct mn_itf *mi);
 int lwip_itf_addr_getnext(struct mn_itf *mi, struct mn_itf_addr *mia);
 
 int lwip_socket_init(void);
+int lwip_mbuf_init(void);
+
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+/* Msys reservation group all IP stack allocations are charged to. */
+extern struct os_msys_group ip_msys_group;
+#endif
+
+/*
+ * Percentage of RX buffering still available; the lower of msys free
+ * blocks (within the IP group's quota) and free inbound wrappers.
+ */
+int lwip_mbuf_rx_avail_pct(void);
+
+#if MYNEWT_VAL(IP_HTTPD_FS)
+/*
+ * Mynewt FS access for the httpd custom file handler; see
+ * lwip_httpd_fs_shim.c for why these exist.  Handles are opaque
+ * struct fs_file pointers.
+ */
+int lwip_httpd_fs_shim_open(const char *path, void **out_handle,
+  uint32_t *out_len);
+void lwip_httpd_fs_shim_close(void *handle);
+int lwip_httpd_fs_shim_mmap(void *handle, uint32_t off, const void **out_ptr,
+  uint32_t *out_len);
+int lwip_httpd_fs_shim_read(void *handle, uint32_t off, void *buf,
+  uint32_t len);
+#endif
 
 #ifdef __cplusplus
 }
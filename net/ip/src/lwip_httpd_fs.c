@@ -0,0 +1,131 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <syscfg/syscfg.h>
+
+#if MYNEWT_VAL(IP_HTTPD_FS)
+
+/*
+ * Serves lwIP httpd requests from the Mynewt file system instead of
+ * the compiled-in fsdata blobs.  Files whose data is memory mapped as
+ * one contiguous extent (fs_mmap()) are handed to httpd as a direct
+ * flash pointer; httpd then feeds tcp_write() without the copy flag,
+ * so the payload goes out as PBUF_ROM references straight from flash.
+ * Fragmented or unmapped files fall back to per-chunk reads through
+ * httpd's send buffer.
+ *
+ * Requires LWIP_HTTPD_CUSTOM_FILES, LWIP_HTTPD_DYNAMIC_FILE_READ and
+ * LWIP_HTTPD_DYNAMIC_HEADERS in the application's lwipopts.h.  URIs
+ * are looked up under IP_HTTPD_FS_ROOT.
+ */
+#include <string.h>
+
+#include <lwip/apps/fs.h>
+
+#include "ip_priv.h"
+
+#if !LWIP_HTTPD_CUSTOM_FILES || !LWIP_HTTPD_DYNAMIC_FILE_READ
+#error IP_HTTPD_FS requires LWIP_HTTPD_CUSTOM_FILES and \
+ LWIP_HTTPD_DYNAMIC_FILE_READ
+#endif
+
+#define LWIP_HTTPD_FS_MAX_PATH  64
+
+int
+fs_open_custom(struct fs_file *file, const char *name)
+{
+    char path[LWIP_HTTPD_FS_MAX_PATH];
+    const void *ptr;
+    uint32_t flen;
+    uint32_t elen;
+    void *handle;
+
+    if (strlen(MYNEWT_VAL(IP_HTTPD_FS_ROOT)) + strlen(name) >=
+      sizeof(path)) {
+        return 0;
+    }
+    strcpy(path, MYNEWT_VAL(IP_HTTPD_FS_ROOT));
+    strcat(path, name);
+
+    if (lwip_httpd_fs_shim_open(path, &handle, &flen)) {
+        return 0;
+    }
+
+    memset(file, 0, sizeof(*file));
+    file->pextension = handle;
+    file->len = flen;
+    file->is_custom_file = 1;
+
+    /*
+     * Whole file in one mapped extent: serve it in place, no reads,
+     * no copies.  Otherwise leave data NULL and httpd pulls the file
+     * through fs_read_custom().
+     */
+    if (lwip_httpd_fs_shim_mmap(handle, 0, &ptr, &elen) == 0 &&
+      elen >= flen) {
+        file->data = ptr;
+        file->index = flen;
+    }
+    return 1;
+}
+
+void
+fs_close_custom(struct fs_file *file)
+{
+    if (file->pextension) {
+        lwip_httpd_fs_shim_close(file->pextension);
+        file->pextension = NULL;
+    }
+}
+
+int
+fs_read_custom(struct fs_file *file, char *buffer, int count)
+{
+    const void *ptr;
+    uint32_t elen;
+    int rc;
+
+    if (file->index >= file->len) {
+        return FS_READ_EOF;
+    }
+    if (count > file->len - file->index) {
+        count = file->len - file->index;
+    }
+    /*
+     * Copy out of the mapped extent when there is one; this skips the
+     * FS read path and its flash-driver buffering.
+     */
+    if (lwip_httpd_fs_shim_mmap(file->pextension, file->index, &ptr,
+          &elen) == 0) {
+        if ((uint32_t)count > elen) {
+            count = elen;
+        }
+        memcpy(buffer, ptr, count);
+        rc = count;
+    } else {
+        rc = lwip_httpd_fs_shim_read(file->pextension, file->index, buffer,
+          count);
+        if (rc <= 0) {
+            return FS_READ_EOF;
+        }
+    }
+    file->index += rc;
+    return rc;
+}
+
+#endif /* MYNEWT_VAL(IP_HTTPD_FS) */
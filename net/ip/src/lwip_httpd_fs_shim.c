@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <syscfg/syscfg.h>
+
+#if MYNEWT_VAL(IP_HTTPD_FS)
+
+/*
+ * Thin wrappers around the Mynewt file system for lwip_httpd_fs.c.
+ * lwIP's httpd and Mynewt's FS both define fs_open()/fs_read() with
+ * incompatible signatures, so the two APIs can never meet in one
+ * translation unit; this file sees only <fs/fs.h> and exports the
+ * handful of operations the httpd handler needs under its own names.
+ */
+#include <fs/fs.h>
+
+#include "ip_priv.h"
+
+int
+lwip_httpd_fs_shim_open(const char *path, void **out_handle,
+  uint32_t *out_len)
+{
+    struct fs_file *file;
+
+    if (fs_open(path, FS_ACCESS_READ, &file)) {
+        return -1;
+    }
+    if (fs_filelen(file, out_len)) {
+        fs_close(file);
+        return -1;
+    }
+    *out_handle = file;
+    return 0;
+}
+
+void
+lwip_httpd_fs_shim_close(void *handle)
+{
+    fs_close((struct fs_file *)handle);
+}
+
+int
+lwip_httpd_fs_shim_mmap(void *handle, uint32_t off, const void **out_ptr,
+  uint32_t *out_len)
+{
+    if (fs_mmap((struct fs_file *)handle, off, out_ptr, out_len)) {
+        return -1;
+    }
+    return 0;
+}
+
+int
+lwip_httpd_fs_shim_read(void *handle, uint32_t off, void *buf, uint32_t len)
+{
+    struct fs_file *file = (struct fs_file *)handle;
+    uint32_t out_len;
+
+    if (fs_seek(file, off)) {
+        return -1;
+    }
+    if (fs_read(file, len, buf, &out_len)) {
+        return -1;
+    }
+    return out_len;
+}
+
+#endif /* MYNEWT_VAL(IP_HTTPD_FS) */
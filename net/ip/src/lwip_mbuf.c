@@ -0,0 +1,227 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdlib.h>
+
+#include <os/os.h>
+#include <os/os_mbuf.h>
+#include <os/os_mempool.h>
+
+#include <lwip/pbuf.h>
+
+#include <ip/lwip_mbuf.h>
+#include "ip_priv.h"
+
+/*
+ * Custom pbuf wrapping a single os_mbuf segment; lwIP calls back into
+ * lwip_pbuf_free() when the last reference goes away.
+ */
+struct lwip_pbuf_wrap {
+    struct pbuf_custom lpw_p;
+    struct os_mbuf *lpw_m;
+};
+
+/*
+ * In-flight wrapped segments in each direction.  Outbound wrappers live
+ * until the driver releases the frame; inbound ones until the app has
+ * consumed the packet through the socket.
+ */
+#define LWIP_MBUF_NUM_PBUF_WRAPS        MYNEWT_VAL(IP_PBUF_WRAPS)
+#define LWIP_MBUF_NUM_EXT_MBUFS         MYNEWT_VAL(IP_EXT_MBUFS)
+
+static struct os_mempool lwip_pbuf_wraps;
+
+static struct os_mempool lwip_ext_mempool;
+static struct os_mbuf_pool lwip_ext_mbufs;
+
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+struct os_msys_group ip_msys_group;
+#endif
+
+int
+lwip_mbuf_rx_avail_pct(void)
+{
+    int pct;
+    int wrap_pct;
+
+    pct = os_msys_num_free() * 100 / os_msys_count();
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+    if (ip_msys_group.omg_max) {
+        wrap_pct = (ip_msys_group.omg_max - ip_msys_group.omg_used) * 100 /
+          ip_msys_group.omg_max;
+        if (wrap_pct < pct) {
+            pct = wrap_pct;
+        }
+    }
+#endif
+    wrap_pct = lwip_ext_mempool.mp_num_free * 100 /
+      lwip_ext_mempool.mp_num_blocks;
+    return wrap_pct < pct ? wrap_pct : pct;
+}
+
+static void
+lwip_pbuf_free(struct pbuf *p)
+{
+    struct lwip_pbuf_wrap *w = (struct lwip_pbuf_wrap *)p;
+
+    if (w->lpw_m) {
+        os_mbuf_free(w->lpw_m);
+    }
+    os_memblock_put(&lwip_pbuf_wraps, w);
+}
+
+void
+lwip_pbuf_disown(struct pbuf *p)
+{
+    struct lwip_pbuf_wrap *w;
+
+    for (; p; p = p->next) {
+        if (p->flags & PBUF_FLAG_IS_CUSTOM) {
+            w = (struct lwip_pbuf_wrap *)p;
+            w->lpw_m = NULL;
+        }
+    }
+}
+
+struct pbuf *
+lwip_pbuf_from_mbuf(struct os_mbuf *m)
+{
+    struct lwip_pbuf_wrap *w;
+    struct pbuf *head;
+    struct pbuf *q;
+    struct os_mbuf *n;
+
+    head = NULL;
+    for (n = m; n; n = SLIST_NEXT(n, om_next)) {
+        w = os_memblock_get(&lwip_pbuf_wraps);
+        if (!w) {
+            goto err;
+        }
+        q = pbuf_alloced_custom(PBUF_RAW, n->om_len, PBUF_REF, &w->lpw_p,
+          n->om_data, n->om_len);
+        if (!q) {
+            os_memblock_put(&lwip_pbuf_wraps, w);
+            goto err;
+        }
+        w->lpw_p.custom_free_function = lwip_pbuf_free;
+        w->lpw_m = n;
+        if (!head) {
+            head = q;
+        } else {
+            pbuf_cat(head, q);
+        }
+    }
+    return head;
+err:
+    /*
+     * Return the wrappers without touching the mbufs; the caller still
+     * owns the chain.
+     */
+    while (head) {
+        q = head->next;
+        os_memblock_put(&lwip_pbuf_wraps, head);
+        head = q;
+    }
+    return NULL;
+}
+
+/*
+ * Each external mbuf holds one reference on the head of the wrapped
+ * pbuf chain; the last segment freed releases the chain.
+ */
+static void
+lwip_ext_mbuf_free(uint8_t *ext_buf, void *arg)
+{
+    pbuf_free((struct pbuf *)arg);
+}
+
+struct os_mbuf *
+lwip_mbuf_from_pbuf(struct pbuf *p, uint16_t usrhdr_len)
+{
+    struct os_mbuf *head;
+    struct os_mbuf *m;
+    struct pbuf *q;
+    int refs;
+
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+    head = os_msys_get_pkthdr_grp(&ip_msys_group, 0, usrhdr_len);
+#else
+    head = os_msys_get_pkthdr(0, usrhdr_len);
+#endif
+    if (!head) {
+        return NULL;
+    }
+    refs = 0;
+    for (q = p; q; q = q->next) {
+        m = os_mbuf_get_ext(&lwip_ext_mbufs, q->payload, q->len,
+          lwip_ext_mbuf_free, p);
+        if (!m) {
+            goto err;
+        }
+        os_mbuf_concat(head, m);
+        refs++;
+    }
+    /*
+     * Take over the caller's reference for the first segment; further
+     * segments each pin the chain with a reference of their own.
+     */
+    while (refs-- > 1) {
+        pbuf_ref(p);
+    }
+    return head;
+err:
+    for (m = head; m; m = SLIST_NEXT(m, om_next)) {
+        if (m->om_flags & OS_MBUF_F_EXT) {
+            OS_MBUF_EXTHDR(m)->oe_free_cb = NULL;
+        }
+    }
+    os_mbuf_free_chain(head);
+    return NULL;
+}
+
+int
+lwip_mbuf_init(void)
+{
+    void *mem;
+    int blksz;
+
+#if MYNEWT_VAL(OS_MSYS_GROUPS)
+    if (os_msys_group_register(&ip_msys_group,
+          MYNEWT_VAL(IP_MSYS_MIN_BLOCKS), MYNEWT_VAL(IP_MSYS_MAX_BLOCKS))) {
+        return -1;
+    }
+#endif
+    mem = malloc(OS_MEMPOOL_BYTES(LWIP_MBUF_NUM_PBUF_WRAPS,
+          sizeof(struct lwip_pbuf_wrap)));
+    if (!mem) {
+        return -1;
+    }
+    os_mempool_init(&lwip_pbuf_wraps, LWIP_MBUF_NUM_PBUF_WRAPS,
+      sizeof(struct lwip_pbuf_wrap), mem, "lwip_pbuf");
+
+    blksz = sizeof(struct os_mbuf) + sizeof(struct os_mbuf_ext);
+    mem = malloc(OS_MEMPOOL_BYTES(LWIP_MBUF_NUM_EXT_MBUFS, blksz));
+    if (!mem) {
+        return -1;
+    }
+    os_mempool_init(&lwip_ext_mempool, LWIP_MBUF_NUM_EXT_MBUFS, blksz,
+      mem, "lwip_embuf");
+    os_mbuf_pool_init(&lwip_ext_mbufs, &lwip_ext_mempool,
+      sizeof(struct os_mbuf_ext), LWIP_MBUF_NUM_EXT_MBUFS);
+    return 0;
+}
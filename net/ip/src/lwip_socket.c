@@ -26,6 +26,7 @@
 
 #include <lwip/udp.h>
 #include <lwip/tcp.h>
+#include <ip/lwip_mbuf.h>
 #include "ip_priv.h"
 
 static int lwip_sock_create(struct mn_socket **sp, uint8_t domain,
@@ -38,6 +39,8 @@ static int lwip_sendto(struct mn_socket *, struct os_mbuf *,
   struct mn_sockaddr *);
 static int lwip_recvfrom(struct mn_socket *, struct os_mbuf **,
   struct mn_sockaddr *);
+static int lwip_peekfrom(struct mn_socket *, struct os_mbuf **,
+  struct mn_sockaddr *);
 static int lwip_getsockopt(struct mn_socket *, uint8_t level,
   uint8_t name, void *val);
 static int lwip_setsockopt(struct mn_socket *, uint8_t level,
@@ -55,6 +58,7 @@ static const struct mn_socket_ops lwip_sock_ops = {
 
     .mso_sendto = lwip_sendto,
     .mso_recvfrom = lwip_recvfrom,
+    .mso_peekfrom = lwip_peekfrom,
 
     .mso_getsockopt = lwip_getsockopt,
     .mso_setsockopt = lwip_setsockopt,
@@ -76,6 +80,9 @@ struct lwip_sock {
     } ls_pcb;
     STAILQ_HEAD(, os_mbuf_pkthdr) ls_rx;
     struct os_mbuf *ls_tx;
+#if LWIP_TCP
+    uint32_t ls_rx_deficit;             /* RX bytes not yet credited to wnd */
+#endif
 };
 
 static struct os_mempool lwip_sockets;
@@ -184,33 +191,53 @@ lwip_sock_udp_rx(void *arg, struct udp_pcb *pcb, struct pbuf *p,
 {
     struct lwip_sock *s = (struct lwip_sock *)arg;
     struct os_mbuf *m;
-    struct pbuf *q;
-    int off;
 
-    m = os_msys_get_pkthdr(p->tot_len, sizeof(struct mn_sockaddr_in6));
+    m = lwip_mbuf_from_pbuf(p, sizeof(struct mn_sockaddr_in6));
     if (!m) {
         pbuf_free(p);
         return;
     }
     lwip_addr_to_mn_addr((struct mn_sockaddr *)OS_MBUF_USRHDR(m),
       addr, port);
-    off = 0;
-    for (q = p; q; q = q->next) {
-        os_mbuf_copyinto(m, off, q->payload, p->len);
-    }
     STAILQ_INSERT_TAIL(&s->ls_rx, OS_MBUF_PKTHDR(m), omp_next);
     mn_socket_readable(&s->ls_sock, 0);
 }
 #endif
 
 #if LWIP_TCP
+/*
+ * Reopen the receive window for data the app has taken, but only while
+ * the buffer pools can absorb more; otherwise the bytes accumulate as
+ * a deficit and the advertised window stays shut, making bulk peers
+ * throttle to what the node can actually buffer instead of draining
+ * msys out from under other subsystems.
+ */
+static void
+lwip_tcp_rx_credit(struct lwip_sock *s, uint32_t len)
+{
+    uint32_t credit;
+
+    credit = s->ls_rx_deficit + len;
+    if (credit == 0) {
+        return;
+    }
+    if (lwip_mbuf_rx_avail_pct() < MYNEWT_VAL(IP_TCP_WND_LOWAT_PCT)) {
+        s->ls_rx_deficit = credit;
+        return;
+    }
+    s->ls_rx_deficit = 0;
+    while (credit) {
+        len = credit > 0xffff ? 0xffff : credit;
+        tcp_recved(s->ls_pcb.tcp, len);
+        credit -= len;
+    }
+}
+
 static err_t
 lwip_sock_tcp_rx(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
 {
     struct lwip_sock *s = (struct lwip_sock *)arg;
     struct os_mbuf *m;
-    struct pbuf *q;
-    int off;
 
     if (!p) {
         /*
@@ -219,16 +246,21 @@ lwip_sock_tcp_rx(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
         mn_socket_readable(&s->ls_sock, MN_ECONNABORTED);
         return ERR_OK;
     }
-    m = os_msys_get_pkthdr(p->tot_len, 0);
-    assert(m);
-    /* XXX fix this */
-    off = 0;
-    for (q = p; q; q = q->next) {
-        os_mbuf_copyinto(m, off, q->payload, p->len);
+    m = lwip_mbuf_from_pbuf(p, 0);
+    if (!m) {
+        /*
+         * No wrappers left; leave the data with lwIP for redelivery.
+         */
+        return ERR_MEM;
     }
     STAILQ_INSERT_TAIL(&s->ls_rx, OS_MBUF_PKTHDR(m), omp_next);
     mn_socket_readable(&s->ls_sock, 0);
 
+    /*
+     * Retry any window credit held back while buffers were scarce.
+     */
+    lwip_tcp_rx_credit(s, 0);
+
     return ERR_OK;
 }
 
@@ -271,6 +303,7 @@ lwip_sock_accept(void *arg, struct tcp_pcb *new, err_t err)
     new_s->ls_pcb.tcp = new;
     STAILQ_INIT(&new_s->ls_rx);
     new_s->ls_tx = NULL;
+    new_s->ls_rx_deficit = 0;
     if (mn_socket_newconn(&s->ls_sock, &new_s->ls_sock)) {
         /* XXX close connection */
     }
@@ -292,6 +325,9 @@ lwip_sock_create(struct mn_socket **sp, uint8_t domain, uint8_t type,
     s->ls_pcb.ip = NULL;
     STAILQ_INIT(&s->ls_rx);
     s->ls_tx = NULL;
+#if LWIP_TCP
+    s->ls_rx_deficit = 0;
+#endif
 
     switch (type) {
 #if LWIP_UDP
@@ -480,10 +516,8 @@ lwip_sendto(struct mn_socket *ms, struct os_mbuf *m,
 {
     struct lwip_sock *s = (struct lwip_sock *)ms;
     struct pbuf *p;
-    struct os_mbuf *n;
     ip_addr_t ip_addr;
     uint16_t port;
-    int off;
     int rc;
 
     switch (s->ls_type) {
@@ -496,28 +530,22 @@ lwip_sendto(struct mn_socket *ms, struct os_mbuf *m,
         if (rc) {
             return rc;
         }
-        off = 0;
-        for (n = m; n; n = SLIST_NEXT(n, om_next)) {
-            off += n->om_len;
-        }
-        p = pbuf_alloc(PBUF_TRANSPORT, off, PBUF_RAM);
+        p = lwip_pbuf_from_mbuf(m);
         if (!p) {
             return MN_ENOBUFS;
         }
 
-        off = 0;
-        for (n = m; n; n = SLIST_NEXT(n, om_next)) {
-            pbuf_take_at(p, n->om_data, n->om_len, off);
-            off += n->om_len;
-        }
-
         rc = udp_sendto(s->ls_pcb.udp, p, &ip_addr, port);
         if (rc) {
-            rc = lwip_err_to_mn_err(rc);
+            /*
+             * Caller keeps the mbuf chain on error; only drop the
+             * wrappers.
+             */
+            lwip_pbuf_disown(p);
             pbuf_free(p);
-            return rc;
+            return lwip_err_to_mn_err(rc);
         }
-        os_mbuf_free_chain(m);
+        pbuf_free(p);
         return 0;
 #endif
 #if LWIP_TCP
@@ -566,6 +594,11 @@ lwip_recvfrom(struct mn_socket *ms, struct os_mbuf **mp,
 #endif
             }
         }
+#if LWIP_TCP
+        if (s->ls_type == MN_SOCK_STREAM) {
+            lwip_tcp_rx_credit(s, m->omp_len);
+        }
+#endif
         return 0;
     } else {
         *mp = NULL;
@@ -573,6 +606,43 @@ lwip_recvfrom(struct mn_socket *ms, struct os_mbuf **mp,
     }
 }
 
+static int
+lwip_peekfrom(struct mn_socket *ms, struct os_mbuf **mp,
+  struct mn_sockaddr *addr)
+{
+    struct lwip_sock *s = (struct lwip_sock *)ms;
+    struct mn_sockaddr *ms_a;
+    struct os_mbuf_pkthdr *m;
+    int slen;
+
+    m = STAILQ_FIRST(&s->ls_rx);
+    if (!m) {
+        *mp = NULL;
+        return MN_EAGAIN;
+    }
+    /*
+     * The packet stays queued; the caller only gets to look at it.
+     */
+    *mp = OS_MBUF_PKTHDR_TO_MBUF(m);
+    if (addr) {
+        if (s->ls_type == MN_SOCK_DGRAM) {
+            ms_a = (struct mn_sockaddr *)(m + 1);
+            if (ms_a->msa_family == MN_AF_INET6) {
+                slen = sizeof(struct mn_sockaddr_in6);
+            } else {
+                slen = sizeof(struct mn_sockaddr_in);
+            }
+            memcpy(addr, ms_a, slen);
+        } else {
+#if LWIP_TCP
+            lwip_addr_to_mn_addr(addr, &s->ls_pcb.ip->local_ip,
+              s->ls_pcb.tcp->local_port);
+#endif
+        }
+    }
+    return 0;
+}
+
 static int
 lwip_getsockopt(struct mn_socket *s, uint8_t level,
   uint8_t name, void *val)
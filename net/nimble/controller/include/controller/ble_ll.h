@@ -117,11 +117,19 @@ STATS_SECT_START(ble_ll_stats)
     STATS_SECT_ENTRY(adv_late_starts)
     STATS_SECT_ENTRY(sched_state_conn_errs)
     STATS_SECT_ENTRY(sched_state_adv_errs)
+    STATS_SECT_ENTRY(sched_airtime_ticks)
     STATS_SECT_ENTRY(scan_starts)
     STATS_SECT_ENTRY(scan_stops)
     STATS_SECT_ENTRY(scan_req_txf)
     STATS_SECT_ENTRY(scan_req_txg)
     STATS_SECT_ENTRY(scan_rsp_txg)
+    STATS_SECT_ENTRY(scan_early_aborts)
+    STATS_SECT_ENTRY(airtime_tx_adv_usecs)
+    STATS_SECT_ENTRY(airtime_tx_data_usecs)
+    STATS_SECT_ENTRY(airtime_tx_scan_usecs)
+    STATS_SECT_ENTRY(airtime_rx_adv_usecs)
+    STATS_SECT_ENTRY(airtime_rx_data_usecs)
+    STATS_SECT_ENTRY(airtime_rx_scan_usecs)
 STATS_SECT_END
 extern STATS_SECT_DECL(ble_ll_stats) ble_ll_stats;
 
@@ -131,6 +139,7 @@ extern STATS_SECT_DECL(ble_ll_stats) ble_ll_stats;
 #define BLE_LL_STATE_SCANNING       (2)
 #define BLE_LL_STATE_INITIATING     (3)
 #define BLE_LL_STATE_CONNECTION     (4)
+#define BLE_LL_STATE_DTM            (5)
 
 /* LL Features */
 #define BLE_LL_FEAT_LE_ENCRYPTION   (0x01)
@@ -335,9 +344,38 @@ struct ble_mbuf_hdr;
 /* Called by the PHY when a packet has started */
 int ble_ll_rx_start(uint8_t *rxbuf, uint8_t chan, struct ble_mbuf_hdr *hdr);
 
+/* Called by the PHY when the advertiser address bytes have been received */
+int ble_ll_rx_adva(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr);
+
 /* Called by the PHY when a packet reception ends */
 int ble_ll_rx_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr);
 
+#if MYNEWT_VAL(BLE_LL_AIRTIME)
+/*
+ * Radio airtime accounting.  The PHY marks the start of each radio op
+ * (transmit or receiver-on) and its end; the elapsed time is
+ * accumulated, in microseconds, per direction and channel class in the
+ * airtime_* link layer stats.  Adv channel receive while scanning or
+ * initiating is classed as scan time.  Cost is two os_cputime reads
+ * per radio op.
+ */
+#define BLE_LL_AIRTIME_ADV          (0)
+#define BLE_LL_AIRTIME_DATA         (1)
+#define BLE_LL_AIRTIME_SCAN         (2)
+
+/* Called by the PHY when the radio starts a transmit or receive */
+void ble_ll_airtime_start(uint8_t chan, uint8_t is_rx);
+
+/* Called by the PHY when the radio op ends; safe to call repeatedly */
+void ble_ll_airtime_end(void);
+
+/* Returns accumulated airtime, in microseconds, for a class/direction */
+uint32_t ble_ll_airtime_get(int airtime_class, int is_rx);
+#else
+#define ble_ll_airtime_start(chan, is_rx)   ((void)(chan), (void)(is_rx))
+#define ble_ll_airtime_end()
+#endif
+
 /*--- Controller API ---*/
 void ble_ll_mbuf_init(struct os_mbuf *m, uint8_t pdulen, uint8_t hdr);
 
@@ -133,6 +133,9 @@ uint8_t *ble_ll_adv_get_peer_rpa(void);
 /* Called to initialize advertising functionality. */
 void ble_ll_adv_init(void);
 
+/* Called to register the vendor-specific advertising commands. */
+void ble_ll_adv_hci_vendor_init(void);
+
 /* Called when LL wait for response timer expires in advertising state */
 void ble_ll_adv_wfr_timer_exp(void);
 
@@ -159,7 +162,7 @@ int ble_ll_adv_can_chg_whitelist(void);
 int ble_ll_adv_conn_req_rxd(uint8_t *rxbuf, struct ble_mbuf_hdr *hdr);
 
 /* Called when an advertising event has been scheduled */
-void ble_ll_adv_scheduled(uint32_t sch_start);
+void ble_ll_adv_scheduled(void *arg, uint32_t sch_start);
 
 /* Called to halt currently running advertising event */
 void ble_ll_adv_halt(void);
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_LL_CA_
+#define H_BLE_LL_CA_
+
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MYNEWT_VAL(BLE_LL_CHAN_ASSESS) == 1)
+
+#include <inttypes.h>
+
+/*
+ * Channel assessment. The connection event rx path reports each
+ * received data channel PDU; per-channel CRC error counts and an RSSI
+ * average are kept and periodically folded into a suggested channel
+ * map with noisy channels masked. The suggestion is advisory until
+ * the host opts in to autonomous application through the channel
+ * assessment vendor HCI command, registered with ble_ll_hci_vendor.
+ */
+
+/* Initialize the channel assessment module */
+void ble_ll_ca_init(void);
+
+/*
+ * Record a received data channel PDU.
+ *
+ * Context: interrupt (connection event rx isr).
+ */
+void ble_ll_ca_rx(uint8_t chan, int8_t rssi, uint8_t crc_ok);
+
+/* Copy the current suggested channel map (BLE_LL_CONN_CHMAP_LEN bytes) */
+void ble_ll_ca_suggested_map(uint8_t *chanmap);
+
+/*
+ * Record the host channel classification. Assessment starts from this
+ * map, so host-masked channels stay masked and channels we masked can
+ * be retried once their counters have decayed.
+ */
+void ble_ll_ca_host_map_set(uint8_t *chanmap);
+
+#else
+
+/* Channel assessment compiled out */
+#define ble_ll_ca_init()
+#define ble_ll_ca_rx(chan, rssi, crc_ok)    \
+    ((void)(chan), (void)(rssi), (void)(crc_ok))
+#define ble_ll_ca_host_map_set(chanmap)     ((void)(chanmap))
+
+#endif /* BLE_LL_CHAN_ASSESS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BLE_LL_CA_ */
@@ -137,6 +137,12 @@ struct ble_ll_conn_sm
     uint8_t rem_max_rx_octets;
     uint8_t eff_max_tx_octets;
     uint8_t eff_max_rx_octets;
+#if (MYNEWT_VAL(BLE_LL_CONN_ADAPTIVE_TXLEN) == 1)
+    /* Adaptive payload sizing based on per-connection ack/nack history */
+    uint8_t apl_max_tx_octets;
+    uint8_t apl_cons_failures;
+    uint8_t apl_cons_successes;
+#endif
     uint16_t max_tx_time;
     uint16_t max_rx_time;
     uint16_t rem_max_tx_time;
@@ -191,6 +197,10 @@ struct ble_ll_conn_sm
     uint32_t ce_end_time;   /* cputime at which connection event should end */
     uint32_t terminate_timeout;
     uint32_t last_scheduled;
+#if (MYNEWT_VAL(BLE_NUM_COMP_PKT_THRESH) > 1)
+    /* os time at which the oldest unreported completed packet was counted */
+    uint32_t comp_pkt_itvl_start;
+#endif
 
     /* Connection timing */
     uint16_t conn_itvl_min;
@@ -205,6 +215,11 @@ struct ble_ll_conn_sm
     uint32_t last_anchor_point;
     uint32_t slave_cur_tx_win_usecs;
     uint32_t slave_cur_window_widening;
+#if (MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST) == 1)
+    /* Measured combined sleep clock drift (ppm) and sample count */
+    uint16_t slave_drift_ppm;
+    uint8_t slave_drift_samples;
+#endif
 
     /* address information */
     uint8_t own_addr_type;
@@ -273,6 +288,17 @@ struct ble_ll_conn_sm
 #define CONN_F_ENC_CHANGE_SENT(csm) ((csm)->csmflags.cfbit.encrypt_chg_sent)
 #define CONN_F_LE_PING_SUPP(csm)    ((csm)->csmflags.cfbit.le_ping_supp)
 
+/*
+ * Maximum payload used when sizing data PDU transmissions. With adaptive
+ * payload sizing this can be lower than the effective maximum negotiated
+ * through the data length update procedure; it never exceeds it.
+ */
+#if (MYNEWT_VAL(BLE_LL_CONN_ADAPTIVE_TXLEN) == 1)
+#define CONN_CUR_TX_OCTETS(csm)     ((csm)->apl_max_tx_octets)
+#else
+#define CONN_CUR_TX_OCTETS(csm)     ((csm)->eff_max_tx_octets)
+#endif
+
 /* Role */
 #define CONN_IS_MASTER(csm)         (csm->conn_role == BLE_LL_CONN_ROLE_MASTER)
 #define CONN_IS_SLAVE(csm)          (csm->conn_role == BLE_LL_CONN_ROLE_SLAVE)
@@ -284,6 +310,14 @@ struct ble_ll_conn_sm
  */
 struct ble_ll_conn_sm *ble_ll_conn_find_active_conn(uint16_t handle);
 
+/*
+ * Returns the event counter, anchor point (cputime) and interval (usecs) of
+ * the most recently scheduled connection event; a shared time reference for
+ * synchronization protocols.
+ */
+int ble_ll_conn_anchor_get(uint16_t handle, uint16_t *evt_cntr,
+                           uint32_t *anchor, uint32_t *itvl_usecs);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_LL_DTM_
+#define H_BLE_LL_DTM_
+
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MYNEWT_VAL(BLE_LL_DTM) == 1)
+
+#include <inttypes.h>
+
+/*
+ * Direct Test Mode (LE Test Mode). The standard receiver test,
+ * transmitter test and test end HCI commands drive the PHY directly:
+ * the transmitter test sends the requested payload pattern back to
+ * back at the spec packet interval and the receiver test counts
+ * received packets per channel. Per-channel receive and CRC error
+ * counters survive test end so production line software can sweep the
+ * band and read packet error rates through the DTM vendor HCI command
+ * or the dtm shell command.
+ */
+
+/* Forward declarations */
+struct ble_mbuf_hdr;
+
+/* Process the LE receiver test HCI command */
+int ble_ll_dtm_rx_test(uint8_t *cmdbuf);
+
+/* Process the LE transmitter test HCI command */
+int ble_ll_dtm_tx_test(uint8_t *cmdbuf);
+
+/* Process the LE test end HCI command */
+int ble_ll_dtm_end_test(uint8_t *rspbuf, uint8_t *rsplen);
+
+/*
+ * Called when a packet reception ends while in DTM state.
+ *
+ * Context: interrupt
+ */
+int ble_ll_dtm_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr);
+
+/* Stop any running test (LL reset) */
+void ble_ll_dtm_reset(void);
+
+/* Initialize the direct test mode module */
+void ble_ll_dtm_init(void);
+
+#else
+
+/* Direct test mode compiled out */
+#define ble_ll_dtm_reset()
+#define ble_ll_dtm_init()
+
+#endif /* BLE_LL_DTM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BLE_LL_DTM_ */
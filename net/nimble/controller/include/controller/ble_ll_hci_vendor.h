@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_LL_HCI_VENDOR_
+#define H_BLE_LL_HCI_VENDOR_
+
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+
+#include <inttypes.h>
+
+/*
+ * Vendor-specific HCI commands (OGF = 0x3F). Packages register a
+ * handler per OCF at init time and the dispatcher indexes the table;
+ * no changes to ble_ll_hci.c are needed to add a command.
+ *
+ * Handlers get the command parameters in place in the HCI command
+ * buffer and build their response in place as well; nothing is copied.
+ * On entry, cmdbuf points at the command parameters, len is the
+ * parameter length from the command header and rspbuf points at the
+ * response parameter area of the command complete event. A handler
+ * stores the number of response bytes it wrote through rsplen (left at
+ * zero by the dispatcher) and returns a BLE error code.
+ *
+ * Context: Link Layer task.
+ */
+typedef int ble_ll_hci_vendor_cmd_fn(uint8_t *cmdbuf, uint8_t len,
+                                     uint8_t *rspbuf, uint8_t *rsplen);
+
+/* Register a handler for a vendor OCF. Returns 0 on success; -1 if the
+   table is full or the OCF is already registered. */
+int ble_ll_hci_vendor_cmd_register(uint16_t ocf,
+                                   ble_ll_hci_vendor_cmd_fn *handler);
+
+/* Called by the HCI dispatcher to process a vendor command */
+int ble_ll_hci_vendor_cmd_proc(uint8_t *cmdbuf, uint16_t ocf,
+                               uint8_t *rsplen);
+
+/* Initialize the vendor command table */
+void ble_ll_hci_vendor_init(void);
+
+#else
+
+/* Vendor HCI commands compiled out */
+#define ble_ll_hci_vendor_init()
+
+#endif /* BLE_LL_VENDOR_HCI */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BLE_LL_HCI_VENDOR_ */
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_LL_PROF_
+#define H_BLE_LL_PROF_
+
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MYNEWT_VAL(BLE_LL_CONN_PROFILE) == 1)
+
+#include <inttypes.h>
+
+/*
+ * Profiled phases of a connection event. Time between two consecutive
+ * phase marks is attributed to the phase named by the later mark.
+ */
+#define BLE_LL_PROF_PHASE_SETUP         (0)     /* radio setup/scheduling */
+#define BLE_LL_PROF_PHASE_ENC           (1)     /* encryption configuration */
+#define BLE_LL_PROF_PHASE_PDU           (2)     /* tx/rx pdu handling */
+#define BLE_LL_PROF_PHASE_CLEANUP       (3)     /* post-event cleanup */
+#define BLE_LL_PROF_NUM_PHASES          (4)
+
+/* One record per profiled connection event */
+struct ble_ll_prof_rec
+{
+    uint16_t bpr_handle;
+    uint16_t bpr_event_cntr;
+    uint32_t bpr_start_cputime;
+    uint16_t bpr_phase_ticks[BLE_LL_PROF_NUM_PHASES];
+};
+
+/* Initialize the connection event profiler */
+void ble_ll_prof_init(void);
+
+/* Begin a new record for a connection event */
+void ble_ll_prof_conn_ev_start(uint16_t handle, uint16_t event_cntr);
+
+/* Restart the phase clock without attributing the elapsed time */
+void ble_ll_prof_enter(void);
+
+/* Attribute the time since the last mark to the given phase */
+void ble_ll_prof_exit(int phase);
+
+/* Close the current record and append it to the profiling ring */
+void ble_ll_prof_conn_ev_end(void);
+
+#else
+
+/* Profiling compiled out */
+#define ble_ll_prof_init()
+#define ble_ll_prof_conn_ev_start(handle, event_cntr)
+#define ble_ll_prof_enter()
+#define ble_ll_prof_exit(phase)
+#define ble_ll_prof_conn_ev_end()
+
+#endif /* BLE_LL_CONN_PROFILE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BLE_LL_PROF_ */
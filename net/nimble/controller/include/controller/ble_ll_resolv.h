@@ -94,6 +94,9 @@ int ble_ll_resolv_rpa(uint8_t *rpa, uint8_t *irk);
 /* Initialize resolv*/
 void ble_ll_resolv_init(void);
 
+/* Register resolving list vendor-specific HCI commands */
+void ble_ll_resolv_hci_vendor_init(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -76,6 +76,11 @@ struct ble_ll_scan_sm
     struct os_mbuf *scan_req_pdu;
     struct os_event scan_sched_ev;
     struct hal_timer scan_timer;
+#if (MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS) > 0)
+    /* Partially filled advertising report event awaiting more reports */
+    uint8_t *scan_batch_evbuf;
+    struct os_callout scan_batch_timer;
+#endif
 };
 
 /* Scan types */
@@ -100,6 +105,9 @@ void ble_ll_scan_reset(void);
 /* Called when Link Layer starts to receive a PDU and is in scanning state */
 int ble_ll_scan_rx_isr_start(uint8_t pdu_type, uint8_t *rxflags);
 
+/* Called when the advertiser address of a PDU has been received */
+int ble_ll_scan_rx_isr_adva(uint8_t *rxbuf);
+
 /* Called when Link Layer has finished receiving a PDU while scanning */
 int ble_ll_scan_rx_isr_end(struct os_mbuf *rxpdu, uint8_t crcok);
 
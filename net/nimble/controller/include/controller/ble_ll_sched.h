@@ -20,6 +20,8 @@
 #ifndef H_BLE_LL_SCHED_
 #define H_BLE_LL_SCHED_
 
+#include "syscfg/syscfg.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -54,11 +56,19 @@ struct ble_ll_sched_item
 {
     uint8_t         sched_type;
     uint8_t         enqueued;
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+    /* Number of express lanes this item participates in (0: list only) */
+    uint8_t         sl_height;
+#endif
     uint32_t        start_time;
     uint32_t        end_time;
     void            *cb_arg;
     sched_cb_func   sched_cb;
     TAILQ_ENTRY(ble_ll_sched_item) link;
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+    /* Express lane forward pointers indexing into the schedule queue */
+    struct ble_ll_sched_item *sl_next[MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST_LEVELS)];
+#endif
 };
 
 /* Initialize the scheduler */
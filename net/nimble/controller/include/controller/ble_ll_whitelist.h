@@ -45,6 +45,9 @@ void ble_ll_whitelist_disable(void);
 /* Boolean function returning true if address matches a whitelist entry */
 int ble_ll_whitelist_match(uint8_t *addr, uint8_t addr_type, int is_ident);
 
+/* Register whitelist vendor-specific HCI commands */
+void ble_ll_whitelist_hci_vendor_init(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,6 +39,10 @@
 #include "controller/ble_ll_hci.h"
 #include "controller/ble_ll_whitelist.h"
 #include "controller/ble_ll_resolv.h"
+#include "controller/ble_ll_prof.h"
+#include "controller/ble_ll_hci_vendor.h"
+#include "controller/ble_ll_ca.h"
+#include "controller/ble_ll_dtm.h"
 #include "ble_ll_conn_priv.h"
 
 /* XXX:
@@ -174,11 +178,19 @@ STATS_NAME_START(ble_ll_stats)
     STATS_NAME(ble_ll_stats, adv_late_starts)
     STATS_NAME(ble_ll_stats, sched_state_conn_errs)
     STATS_NAME(ble_ll_stats, sched_state_adv_errs)
+    STATS_NAME(ble_ll_stats, sched_airtime_ticks)
     STATS_NAME(ble_ll_stats, scan_starts)
     STATS_NAME(ble_ll_stats, scan_stops)
     STATS_NAME(ble_ll_stats, scan_req_txf)
     STATS_NAME(ble_ll_stats, scan_req_txg)
     STATS_NAME(ble_ll_stats, scan_rsp_txg)
+    STATS_NAME(ble_ll_stats, scan_early_aborts)
+    STATS_NAME(ble_ll_stats, airtime_tx_adv_usecs)
+    STATS_NAME(ble_ll_stats, airtime_tx_data_usecs)
+    STATS_NAME(ble_ll_stats, airtime_tx_scan_usecs)
+    STATS_NAME(ble_ll_stats, airtime_rx_adv_usecs)
+    STATS_NAME(ble_ll_stats, airtime_rx_data_usecs)
+    STATS_NAME(ble_ll_stats, airtime_rx_scan_usecs)
 STATS_NAME_END(ble_ll_stats)
 
 static void ble_ll_event_rx_pkt(struct os_event *ev);
@@ -567,9 +579,21 @@ ble_ll_tx_pkt_in(void)
     uint16_t pb;
     struct os_mbuf_pkthdr *pkthdr;
     struct os_mbuf *om;
+#if MYNEWT_VAL(BLE_LL_DATA_EVT_BUDGET)
+    int budget;
+
+    budget = MYNEWT_VAL(BLE_LL_DATA_EVT_BUDGET);
+#endif
 
     /* Drain all packets off the queue */
     while (STAILQ_FIRST(&g_ble_ll_data.ll_tx_pkt_q)) {
+#if MYNEWT_VAL(BLE_LL_DATA_EVT_BUDGET)
+        /* Re-post ourselves so pending LL events get a turn first */
+        if (budget-- == 0) {
+            os_eventq_put(&g_ble_ll_data.ll_evq, &g_ble_ll_data.ll_tx_pkt_ev);
+            break;
+        }
+#endif
         /* Get mbuf pointer from packet header pointer */
         pkthdr = STAILQ_FIRST(&g_ble_ll_data.ll_tx_pkt_q);
         om = (struct os_mbuf *)((uint8_t *)pkthdr - sizeof(struct os_mbuf));
@@ -649,9 +673,21 @@ ble_ll_rx_pkt_in(void)
     struct os_mbuf_pkthdr *pkthdr;
     struct ble_mbuf_hdr *ble_hdr;
     struct os_mbuf *m;
+#if MYNEWT_VAL(BLE_LL_DATA_EVT_BUDGET)
+    int budget;
+
+    budget = MYNEWT_VAL(BLE_LL_DATA_EVT_BUDGET);
+#endif
 
     /* Drain all packets off the queue */
     while (STAILQ_FIRST(&g_ble_ll_data.ll_rx_pkt_q)) {
+#if MYNEWT_VAL(BLE_LL_DATA_EVT_BUDGET)
+        /* Re-post ourselves so pending LL events get a turn first */
+        if (budget-- == 0) {
+            os_eventq_put(&g_ble_ll_data.ll_evq, &g_ble_ll_data.ll_rx_pkt_ev);
+            break;
+        }
+#endif
         /* Get mbuf pointer from packet header pointer */
         pkthdr = STAILQ_FIRST(&g_ble_ll_data.ll_rx_pkt_q);
         m = (struct os_mbuf *)((uint8_t *)pkthdr - sizeof(struct os_mbuf));
@@ -791,6 +827,13 @@ ble_ll_rx_start(uint8_t *rxbuf, uint8_t chan, struct ble_mbuf_hdr *rxhdr)
 
     ble_ll_log(BLE_LL_LOG_ID_RX_START, chan, 0, rxhdr->beg_cputime);
 
+#if (MYNEWT_VAL(BLE_LL_DTM) == 1)
+    /* Test packets are received regardless of channel type */
+    if (g_ble_ll_data.ll_state == BLE_LL_STATE_DTM) {
+        return 0;
+    }
+#endif
+
     /* Check channel type */
     if (chan < BLE_PHY_NUM_DATA_CHANS) {
         /*
@@ -839,6 +882,40 @@ ble_ll_rx_start(uint8_t *rxbuf, uint8_t chan, struct ble_mbuf_hdr *rxhdr)
     return rc;
 }
 
+/**
+ * Called by the PHY when the advertiser address bytes of an advertising
+ * channel PDU have been received, before the rest of the payload arrives.
+ * Gives the Link Layer a chance to abort reception of PDUs that will fail
+ * address filtering anyway, reclaiming the radio-on time spent receiving
+ * the remainder of the frame.
+ *
+ * NOTE: Called from interrupt context!
+ *
+ * @param rxbuf Pointer to received PDU data (header and advertiser address
+ *              are valid; the rest of the payload is not)
+ *        rxhdr Pointer to BLE header of received frame
+ *
+ * @return int
+ *   < 0: Abort reception of this frame and restart the receiver.
+ *  >= 0: Continue receiving the frame.
+ */
+int
+ble_ll_rx_adva(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
+{
+    int rc;
+
+    switch (g_ble_ll_data.ll_state) {
+    case BLE_LL_STATE_SCANNING:
+        rc = ble_ll_scan_rx_isr_adva(rxbuf);
+        break;
+    default:
+        rc = 0;
+        break;
+    }
+
+    return rc;
+}
+
 /**
  * Called by the PHY when a receive packet has ended.
  *
@@ -871,6 +948,13 @@ ble_ll_rx_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
                ((uint16_t)rxhdr->rxinfo.flags << 8) | rxbuf[1],
                rxhdr->beg_cputime);
 
+#if (MYNEWT_VAL(BLE_LL_DTM) == 1)
+    /* Test packets are counted in the DTM module, not handed up */
+    if (BLE_MBUF_HDR_RX_STATE(rxhdr) == BLE_LL_STATE_DTM) {
+        return ble_ll_dtm_rx_isr_end(rxbuf, rxhdr);
+    }
+#endif
+
     /* Check channel type */
     if (chan < BLE_PHY_NUM_DATA_CHANS) {
         /*
@@ -1031,6 +1115,110 @@ ble_ll_state_get(void)
     return g_ble_ll_data.ll_state;
 }
 
+#if MYNEWT_VAL(BLE_LL_AIRTIME)
+/*
+ * Airtime accounting state.  Radio ops do not nest, so a single
+ * mark/class pair suffices; the active flag makes ble_ll_airtime_end()
+ * safe to call from both the end isr and ble_phy_disable().
+ */
+static uint32_t g_ble_ll_airtime_mark;
+static uint8_t g_ble_ll_airtime_class;
+static uint8_t g_ble_ll_airtime_rx;
+static uint8_t g_ble_ll_airtime_active;
+
+/**
+ * Called by the PHY when the radio starts a transmit or a receive.
+ * The channel class is latched here since the channel may be
+ * reprogrammed before the op ends.
+ *
+ * Context: Link Layer task or interrupt.
+ */
+void
+ble_ll_airtime_start(uint8_t chan, uint8_t is_rx)
+{
+    uint8_t state;
+
+    if (chan < BLE_PHY_NUM_DATA_CHANS) {
+        g_ble_ll_airtime_class = BLE_LL_AIRTIME_DATA;
+    } else {
+        state = g_ble_ll_data.ll_state;
+        if ((state == BLE_LL_STATE_SCANNING) ||
+            (state == BLE_LL_STATE_INITIATING)) {
+            g_ble_ll_airtime_class = BLE_LL_AIRTIME_SCAN;
+        } else {
+            g_ble_ll_airtime_class = BLE_LL_AIRTIME_ADV;
+        }
+    }
+    g_ble_ll_airtime_rx = is_rx;
+    g_ble_ll_airtime_active = 1;
+    g_ble_ll_airtime_mark = os_cputime_get32();
+}
+
+/**
+ * Called by the PHY when the radio op ends (end isr or disable).
+ *
+ * Context: Link Layer task or interrupt.
+ */
+void
+ble_ll_airtime_end(void)
+{
+    uint32_t usecs;
+
+    if (!g_ble_ll_airtime_active) {
+        return;
+    }
+    g_ble_ll_airtime_active = 0;
+
+    usecs = os_cputime_ticks_to_usecs(os_cputime_get32() -
+                                      g_ble_ll_airtime_mark);
+    switch (g_ble_ll_airtime_class) {
+    case BLE_LL_AIRTIME_ADV:
+        if (g_ble_ll_airtime_rx) {
+            STATS_INCN(ble_ll_stats, airtime_rx_adv_usecs, usecs);
+        } else {
+            STATS_INCN(ble_ll_stats, airtime_tx_adv_usecs, usecs);
+        }
+        break;
+    case BLE_LL_AIRTIME_DATA:
+        if (g_ble_ll_airtime_rx) {
+            STATS_INCN(ble_ll_stats, airtime_rx_data_usecs, usecs);
+        } else {
+            STATS_INCN(ble_ll_stats, airtime_tx_data_usecs, usecs);
+        }
+        break;
+    default:
+        if (g_ble_ll_airtime_rx) {
+            STATS_INCN(ble_ll_stats, airtime_rx_scan_usecs, usecs);
+        } else {
+            STATS_INCN(ble_ll_stats, airtime_tx_scan_usecs, usecs);
+        }
+        break;
+    }
+}
+
+/**
+ * Returns the airtime accumulated so far for a class/direction, in
+ * microseconds.  Wraps at 2^32 like any other stat.
+ */
+uint32_t
+ble_ll_airtime_get(int airtime_class, int is_rx)
+{
+    switch (airtime_class) {
+    case BLE_LL_AIRTIME_ADV:
+        return is_rx ? ble_ll_stats.STATS_SECT_VAR(airtime_rx_adv_usecs) :
+            ble_ll_stats.STATS_SECT_VAR(airtime_tx_adv_usecs);
+    case BLE_LL_AIRTIME_DATA:
+        return is_rx ? ble_ll_stats.STATS_SECT_VAR(airtime_rx_data_usecs) :
+            ble_ll_stats.STATS_SECT_VAR(airtime_tx_data_usecs);
+    case BLE_LL_AIRTIME_SCAN:
+        return is_rx ? ble_ll_stats.STATS_SECT_VAR(airtime_rx_scan_usecs) :
+            ble_ll_stats.STATS_SECT_VAR(airtime_tx_scan_usecs);
+    default:
+        return 0;
+    }
+}
+#endif /* MYNEWT_VAL(BLE_LL_AIRTIME) */
+
 /**
  * ble ll event send
  *
@@ -1149,6 +1337,9 @@ ble_ll_reset(void)
     /* Stop any advertising */
     ble_ll_adv_reset();
 
+    /* Stop any direct test mode test */
+    ble_ll_dtm_reset();
+
     /* FLush all packets from Link layer queues */
     ble_ll_flush_pkt_queue(&g_ble_ll_data.ll_tx_pkt_q);
     ble_ll_flush_pkt_queue(&g_ble_ll_data.ll_rx_pkt_q);
@@ -1271,6 +1462,21 @@ ble_ll_init(void)
     /* Initialize the connection module */
     ble_ll_conn_module_init();
 
+    /* Initialize the connection event profiler */
+    ble_ll_prof_init();
+
+    /* Initialize the vendor HCI command table and its users */
+    ble_ll_hci_vendor_init();
+    ble_ll_adv_hci_vendor_init();
+    ble_ll_whitelist_hci_vendor_init();
+#if (MYNEWT_VAL(BLE_LL_CFG_FEAT_LL_PRIVACY) == 1)
+    ble_ll_resolv_hci_vendor_init();
+#endif
+    ble_ll_ca_init();
+
+    /* Initialize direct test mode */
+    ble_ll_dtm_init();
+
     /* Set the supported features. NOTE: we always support extended reject. */
     features = BLE_LL_FEAT_EXTENDED_REJ;
 
@@ -36,6 +36,7 @@
 #include "controller/ble_ll_scan.h"
 #include "controller/ble_ll_whitelist.h"
 #include "controller/ble_ll_resolv.h"
+#include "controller/ble_ll_hci_vendor.h"
 #include "ble_ll_conn_priv.h"
 #include "hal/hal_gpio.h"
 
@@ -99,13 +100,44 @@ struct ble_ll_adv_sm
     uint8_t *conn_comp_ev;
     struct os_event adv_txdone_ev;
     struct ble_ll_sched_item adv_sch;
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+    struct os_mbuf *adv_pdu_cache;
+    struct os_mbuf *scan_rsp_pdu_cache;
+#endif
 };
 
-/* The advertising state machine global object */
-struct ble_ll_adv_sm g_ble_ll_adv_sm;
+/* Number of advertising sets supported by the link layer */
+#define BLE_LL_ADV_INSTANCES        (MYNEWT_VAL(BLE_LL_NUM_ADV_SETS))
+
+/*
+ * The advertising state machines. Each set has its own parameters, data
+ * and schedule item; the sets share the radio through the link layer
+ * scheduler. Set 0 is the default set and the only one that exists in a
+ * single-set configuration.
+ */
+struct ble_ll_adv_sm g_ble_ll_adv_sm[BLE_LL_ADV_INSTANCES];
+
+/*
+ * The set whose advertising event is (or was most recently) on the air.
+ * Set by the scheduler callback when an advertising event starts; the
+ * ISR receive paths and the connection creation code use it to find the
+ * state machine the radio is acting for.
+ */
+static struct ble_ll_adv_sm *g_ble_ll_adv_cur_sm = &g_ble_ll_adv_sm[0];
+
+/*
+ * The set that the standard advertising HCI commands (set parameters,
+ * data, scan response data, enable) operate on. Defaults to set 0 and is
+ * changed with the vendor-specific set-select command.
+ */
+static struct ble_ll_adv_sm *g_ble_ll_adv_hci_sm = &g_ble_ll_adv_sm[0];
 
 static void ble_ll_adv_done(struct ble_ll_adv_sm *advsm);
 
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+static void ble_ll_adv_pdu_cache_rebuild(struct ble_ll_adv_sm *advsm);
+#endif
+
 /*
  * Worst case time needed for scheduled advertising item. This is the longest
  * possible time to receive a scan request and send a scan response (with the
@@ -178,6 +210,13 @@ ble_ll_adv_chk_rpa_timeout(struct ble_ll_adv_sm *advsm)
                     advsm->adv_txadd = 0;
                 }
             }
+
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+            /* The cached PDUs contain the old addresses */
+            if (advsm->enabled) {
+                ble_ll_adv_pdu_cache_rebuild(advsm);
+            }
+#endif
         }
     }
 }
@@ -288,25 +327,18 @@ ble_ll_adv_pdu_make(struct ble_ll_adv_sm *advsm, struct os_mbuf *m)
 }
 
 /**
- * Create a scan response PDU
+ * Fill out a scan response PDU in the given mbuf
  *
  * @param advsm
+ * @param m
  */
-static struct os_mbuf *
-ble_ll_adv_scan_rsp_pdu_make(struct ble_ll_adv_sm *advsm)
+static void
+ble_ll_adv_scan_rsp_pdu_fill(struct ble_ll_adv_sm *advsm, struct os_mbuf *m)
 {
     uint8_t     scan_rsp_len;
     uint8_t     *dptr;
     uint8_t     pdulen;
     uint8_t     hdr;
-    struct os_mbuf *m;
-
-    /* Obtain scan response buffer */
-    m = os_msys_get_pkthdr(BLE_SCAN_RSP_DATA_MAX_LEN + BLE_DEV_ADDR_LEN,
-                           sizeof(struct ble_mbuf_hdr));
-    if (!m) {
-        return NULL;
-    }
 
     /* Make sure that the length is valid */
     scan_rsp_len = advsm->scan_rsp_len;
@@ -336,9 +368,71 @@ ble_ll_adv_scan_rsp_pdu_make(struct ble_ll_adv_sm *advsm)
     if (scan_rsp_len != 0) {
         memcpy(dptr + BLE_DEV_ADDR_LEN, advsm->scan_rsp_data, scan_rsp_len);
     }
+}
+
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 0)
+/**
+ * Create a scan response PDU
+ *
+ * @param advsm
+ */
+static struct os_mbuf *
+ble_ll_adv_scan_rsp_pdu_make(struct ble_ll_adv_sm *advsm)
+{
+    struct os_mbuf *m;
+
+    /* Obtain scan response buffer */
+    m = os_msys_get_pkthdr(BLE_SCAN_RSP_DATA_MAX_LEN + BLE_DEV_ADDR_LEN,
+                           sizeof(struct ble_mbuf_hdr));
+    if (!m) {
+        return NULL;
+    }
+
+    ble_ll_adv_scan_rsp_pdu_fill(advsm, m);
 
     return m;
 }
+#endif
+
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+/**
+ * Re-encode the cached advertising and scan response PDUs.
+ *
+ * Called whenever an input to the PDU contents changes (advertising data,
+ * scan response data, the advertising addresses) so that the transmit paths
+ * can hand a pre-built PDU straight to the PHY instead of encoding it in
+ * the radio-prep critical section before every advertising event.
+ *
+ * Context: Link Layer task
+ *
+ * @param advsm
+ */
+static void
+ble_ll_adv_pdu_cache_rebuild(struct ble_ll_adv_sm *advsm)
+{
+    os_sr_t sr;
+
+    if (!advsm->adv_pdu_cache) {
+        advsm->adv_pdu_cache = os_msys_get_pkthdr(BLE_ADV_MAX_PKT_LEN,
+                                                  sizeof(struct ble_mbuf_hdr));
+    }
+    if (!advsm->scan_rsp_pdu_cache) {
+        advsm->scan_rsp_pdu_cache =
+            os_msys_get_pkthdr(BLE_SCAN_RSP_DATA_MAX_LEN + BLE_DEV_ADDR_LEN,
+                               sizeof(struct ble_mbuf_hdr));
+    }
+
+    /* The interrupt-context transmit paths read these buffers directly */
+    OS_ENTER_CRITICAL(sr);
+    if (advsm->adv_pdu_cache) {
+        ble_ll_adv_pdu_make(advsm, advsm->adv_pdu_cache);
+    }
+    if (advsm->scan_rsp_pdu_cache) {
+        ble_ll_adv_scan_rsp_pdu_fill(advsm, advsm->scan_rsp_pdu_cache);
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+#endif
 
 /**
  * Called to indicate the advertising event is over.
@@ -382,6 +476,7 @@ ble_ll_adv_tx_start_cb(struct ble_ll_sched_item *sch)
 
     /* Get the state machine for the event */
     advsm = (struct ble_ll_adv_sm *)sch->cb_arg;
+    g_ble_ll_adv_cur_sm = advsm;
 
     /* Set channel */
     rc = ble_phy_setchan(advsm->adv_chan, 0, 0);
@@ -418,6 +513,17 @@ ble_ll_adv_tx_start_cb(struct ble_ll_sched_item *sch)
         ble_phy_set_txend_cb(NULL, NULL);
     }
 
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+    /* The advertising PDU was pre-encoded when its contents last changed */
+    adv_pdu = advsm->adv_pdu_cache;
+    if (!adv_pdu) {
+        ble_phy_disable();
+        goto adv_tx_done;
+    }
+
+    /* Transmit advertisement */
+    rc = ble_phy_tx(adv_pdu, end_trans);
+#else
     /* Get an advertising mbuf (packet header)  */
     adv_pdu = os_msys_get_pkthdr(BLE_ADV_MAX_PKT_LEN,
                                  sizeof(struct ble_mbuf_hdr));
@@ -431,6 +537,7 @@ ble_ll_adv_tx_start_cb(struct ble_ll_sched_item *sch)
     /* Transmit advertisement */
     rc = ble_phy_tx(adv_pdu, end_trans);
     os_mbuf_free_chain(adv_pdu);
+#endif
     if (rc) {
         goto adv_tx_done;
     }
@@ -512,7 +619,7 @@ ble_ll_adv_set_sched(struct ble_ll_adv_sm *advsm, int sched_new)
 void
 ble_ll_adv_halt(void)
 {
-    ble_ll_adv_tx_done(&g_ble_ll_adv_sm);
+    ble_ll_adv_tx_done(g_ble_ll_adv_cur_sm);
 }
 
 /**
@@ -539,7 +646,7 @@ ble_ll_adv_set_adv_params(uint8_t *cmd)
     struct ble_ll_adv_sm *advsm;
 
     /* If already enabled, we return an error */
-    advsm = &g_ble_ll_adv_sm;
+    advsm = g_ble_ll_adv_hci_sm;
     if (advsm->enabled) {
         return BLE_ERR_CMD_DISALLOWED;
     }
@@ -671,6 +778,18 @@ ble_ll_adv_sm_stop(struct ble_ll_adv_sm *advsm)
             advsm->conn_comp_ev = NULL;
         }
 
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+        /* Return the cached PDUs to msys while not advertising */
+        if (advsm->adv_pdu_cache) {
+            os_mbuf_free_chain(advsm->adv_pdu_cache);
+            advsm->adv_pdu_cache = NULL;
+        }
+        if (advsm->scan_rsp_pdu_cache) {
+            os_mbuf_free_chain(advsm->scan_rsp_pdu_cache);
+            advsm->scan_rsp_pdu_cache = NULL;
+        }
+#endif
+
         /* Disable advertising */
         advsm->enabled = 0;
     }
@@ -755,6 +874,15 @@ ble_ll_adv_sm_start(struct ble_ll_adv_sm *advsm)
     /* Set flag telling us that advertising is enabled */
     advsm->enabled = 1;
 
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+    /*
+     * Encode the PDUs now so the scheduler callback just hands the
+     * pre-built buffer to the PHY. This also sets adv_pdu_len, which the
+     * schedule length calculation below uses.
+     */
+    ble_ll_adv_pdu_cache_rebuild(advsm);
+#endif
+
     /* Determine the advertising interval we will use */
     if (advsm->adv_type == BLE_HCI_ADV_TYPE_ADV_DIRECT_IND_HD) {
         /* Set it to max. allowed for high duty cycle advertising */
@@ -779,11 +907,11 @@ ble_ll_adv_sm_start(struct ble_ll_adv_sm *advsm)
 }
 
 void
-ble_ll_adv_scheduled(uint32_t sch_start)
+ble_ll_adv_scheduled(void *arg, uint32_t sch_start)
 {
     struct ble_ll_adv_sm *advsm;
 
-    advsm = &g_ble_ll_adv_sm;
+    advsm = (struct ble_ll_adv_sm *)arg;
 
     /* The event start time is when we start transmission of the adv PDU */
     advsm->adv_event_start_time = sch_start +
@@ -832,7 +960,7 @@ ble_ll_adv_set_enable(uint8_t *cmd)
     uint8_t enable;
     struct ble_ll_adv_sm *advsm;
 
-    advsm = &g_ble_ll_adv_sm;
+    advsm = g_ble_ll_adv_hci_sm;
 
     rc = 0;
     enable = cmd[0];
@@ -872,10 +1000,16 @@ ble_ll_adv_set_scan_rsp_data(uint8_t *cmd, uint8_t len)
     }
 
     /* Copy the new data into the advertising structure. */
-    advsm = &g_ble_ll_adv_sm;
+    advsm = g_ble_ll_adv_hci_sm;
     advsm->scan_rsp_len = datalen;
     memcpy(advsm->scan_rsp_data, cmd + 1, datalen);
 
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+    if (advsm->enabled) {
+        ble_ll_adv_pdu_cache_rebuild(advsm);
+    }
+#endif
+
     return 0;
 }
 
@@ -893,6 +1027,10 @@ ble_ll_adv_set_adv_data(uint8_t *cmd, uint8_t len)
 {
     uint8_t datalen;
     struct ble_ll_adv_sm *advsm;
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+    uint8_t *dptr;
+    os_sr_t sr;
+#endif
 
     /* Check for valid advertising data length */
     datalen = cmd[0];
@@ -900,11 +1038,40 @@ ble_ll_adv_set_adv_data(uint8_t *cmd, uint8_t len)
         return BLE_ERR_INV_HCI_CMD_PARMS;
     }
 
+    advsm = g_ble_ll_adv_hci_sm;
+
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+    /*
+     * Fast path for in-place payload updates: if the new data is the
+     * same length as the old, the cached PDU header and addresses are
+     * unchanged, so only the data bytes need to be patched. This keeps
+     * high-rate payload updates (sensor-in-advertisement beacons) from
+     * re-encoding both cached PDUs on every update. Directed
+     * advertisements carry no advertising data in the PDU.
+     */
+    if (advsm->enabled && advsm->adv_pdu_cache && !advsm->adv_directed &&
+        (datalen == advsm->adv_len)) {
+
+        dptr = advsm->adv_pdu_cache->om_data + BLE_LL_PDU_HDR_LEN +
+               BLE_DEV_ADDR_LEN;
+        OS_ENTER_CRITICAL(sr);
+        memcpy(advsm->adv_data, cmd + 1, datalen);
+        memcpy(dptr, cmd + 1, datalen);
+        OS_EXIT_CRITICAL(sr);
+        return 0;
+    }
+#endif
+
     /* Copy the new data into the advertising structure. */
-    advsm = &g_ble_ll_adv_sm;
     advsm->adv_len = datalen;
     memcpy(advsm->adv_data, cmd + 1, datalen);
 
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+    if (advsm->enabled) {
+        ble_ll_adv_pdu_cache_rebuild(advsm);
+    }
+#endif
+
     return 0;
 }
 
@@ -935,7 +1102,7 @@ ble_ll_adv_rx_req(uint8_t pdu_type, struct os_mbuf *rxpdu)
     struct os_mbuf *scan_rsp;
 
     /* See if adva in the request (scan or connect) matches what we sent */
-    advsm = &g_ble_ll_adv_sm;
+    advsm = g_ble_ll_adv_cur_sm;
     rxbuf = rxpdu->om_data;
     adva = rxbuf + BLE_LL_PDU_HDR_LEN + BLE_DEV_ADDR_LEN;
     if (memcmp(advsm->adva, adva, BLE_DEV_ADDR_LEN)) {
@@ -993,15 +1160,21 @@ ble_ll_adv_rx_req(uint8_t pdu_type, struct os_mbuf *rxpdu)
     /* Setup to transmit the scan response if appropriate */
     rc = -1;
     if (pdu_type == BLE_ADV_PDU_TYPE_SCAN_REQ) {
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+        scan_rsp = advsm->scan_rsp_pdu_cache;
+#else
         scan_rsp = ble_ll_adv_scan_rsp_pdu_make(advsm);
+#endif
         if (scan_rsp) {
-            ble_phy_set_txend_cb(ble_ll_adv_tx_done, &g_ble_ll_adv_sm);
+            ble_phy_set_txend_cb(ble_ll_adv_tx_done, advsm);
             rc = ble_phy_tx(scan_rsp, BLE_PHY_TRANSITION_NONE);
             if (!rc) {
                 ble_hdr->rxinfo.flags |= BLE_MBUF_HDR_F_SCAN_RSP_TXD;
                 STATS_INC(ble_ll_stats, scan_rsp_txg);
             }
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 0)
             os_mbuf_free_chain(scan_rsp);
+#endif
         }
     }
 
@@ -1037,7 +1210,7 @@ ble_ll_adv_conn_req_rxd(uint8_t *rxbuf, struct ble_mbuf_hdr *hdr)
 #if MYNEWT_VAL(BLE_LL_CFG_FEAT_LL_PRIVACY)
     resolved = BLE_MBUF_HDR_RESOLVED(hdr);
 #endif
-    advsm = &g_ble_ll_adv_sm;
+    advsm = g_ble_ll_adv_cur_sm;
     inita = rxbuf + BLE_LL_PDU_HDR_LEN;
     if (hdr->rxinfo.flags & BLE_MBUF_HDR_F_DEVMATCH) {
 
@@ -1129,7 +1302,7 @@ ble_ll_adv_rx_isr_end(uint8_t pdu_type, struct os_mbuf *rxpdu, int crcok)
 
     rc = -1;
     if (rxpdu == NULL) {
-        ble_ll_adv_tx_done(&g_ble_ll_adv_sm);
+        ble_ll_adv_tx_done(g_ble_ll_adv_cur_sm);
     } else {
         if (crcok) {
             if ((pdu_type == BLE_ADV_PDU_TYPE_SCAN_REQ) ||
@@ -1164,13 +1337,15 @@ void
 ble_ll_adv_rx_pkt_in(uint8_t ptype, uint8_t *rxbuf, struct ble_mbuf_hdr *hdr)
 {
     int adv_event_over;
+    struct ble_ll_adv_sm *advsm;
 
     /*
      * It is possible that advertising was stopped and a packet plcaed on the
      * LL receive packet queue. In this case, just ignore the received packet
      * as the advertising state machine is no longer "valid"
      */
-    if (!g_ble_ll_adv_sm.enabled) {
+    advsm = g_ble_ll_adv_cur_sm;
+    if (!advsm->enabled) {
         return;
     }
 
@@ -1196,7 +1371,7 @@ ble_ll_adv_rx_pkt_in(uint8_t ptype, uint8_t *rxbuf, struct ble_mbuf_hdr *hdr)
     }
 
     if (adv_event_over) {
-        ble_ll_adv_done(&g_ble_ll_adv_sm);
+        ble_ll_adv_done(advsm);
     }
 }
 
@@ -1223,7 +1398,7 @@ ble_ll_adv_rx_isr_start(uint8_t pdu_type)
     rc = -1;
 
     /* If we get a scan request we must tell the phy to go from rx to tx */
-    advsm = &g_ble_ll_adv_sm;
+    advsm = g_ble_ll_adv_cur_sm;
     if (pdu_type == BLE_ADV_PDU_TYPE_SCAN_REQ) {
         /* Only accept scan requests if we are indirect adv or scan adv */
         if ((advsm->adv_type == BLE_HCI_ADV_TYPE_ADV_SCAN_IND) ||
@@ -1364,6 +1539,13 @@ ble_ll_adv_done(struct ble_ll_adv_sm *advsm)
     ble_ll_adv_chk_rpa_timeout(advsm);
 #endif
 
+#if (MYNEWT_VAL(BLE_LL_ADV_PDU_CACHE) == 1)
+    /* Retry the cache allocation if msys was exhausted when we started */
+    if (!advsm->adv_pdu_cache || !advsm->scan_rsp_pdu_cache) {
+        ble_ll_adv_pdu_cache_rebuild(advsm);
+    }
+#endif
+
     /* Schedule advertising transmit */
     ble_ll_adv_set_sched(advsm, 0);
 
@@ -1392,14 +1574,18 @@ ble_ll_adv_event_done(struct os_event *ev)
 int
 ble_ll_adv_can_chg_whitelist(void)
 {
+    int i;
     int rc;
     struct ble_ll_adv_sm *advsm;
 
-    advsm = &g_ble_ll_adv_sm;
-    if (advsm->enabled && (advsm->adv_filter_policy != BLE_HCI_ADV_FILT_NONE)) {
-        rc = 0;
-    } else {
-        rc = 1;
+    rc = 1;
+    for (i = 0; i < BLE_LL_ADV_INSTANCES; ++i) {
+        advsm = &g_ble_ll_adv_sm[i];
+        if (advsm->enabled &&
+            (advsm->adv_filter_policy != BLE_HCI_ADV_FILT_NONE)) {
+            rc = 0;
+            break;
+        }
     }
 
     return rc;
@@ -1415,9 +1601,9 @@ ble_ll_adv_get_conn_comp_ev(void)
 {
     uint8_t *evbuf;
 
-    evbuf = g_ble_ll_adv_sm.conn_comp_ev;
+    evbuf = g_ble_ll_adv_cur_sm->conn_comp_ev;
     assert(evbuf != NULL);
-    g_ble_ll_adv_sm.conn_comp_ev = NULL;
+    g_ble_ll_adv_cur_sm->conn_comp_ev = NULL;
 
     return evbuf;
 }
@@ -1434,7 +1620,7 @@ ble_ll_adv_get_local_rpa(void)
     uint8_t *rpa;
     struct ble_ll_adv_sm *advsm;
 
-    advsm = &g_ble_ll_adv_sm;
+    advsm = g_ble_ll_adv_cur_sm;
 
     rpa = NULL;
     if (advsm->own_addr_type > BLE_HCI_ADV_OWN_ADDR_RANDOM) {
@@ -1454,7 +1640,7 @@ ble_ll_adv_get_peer_rpa(void)
 {
     struct ble_ll_adv_sm *advsm;
 
-    advsm = &g_ble_ll_adv_sm;
+    advsm = g_ble_ll_adv_cur_sm;
 
     /* XXX: should this go into IRK list or connection? */
     return advsm->adv_rpa;
@@ -1469,7 +1655,7 @@ void
 ble_ll_adv_wfr_timer_exp(void)
 {
     ble_phy_disable();
-    ble_ll_adv_tx_done(&g_ble_ll_adv_sm);
+    ble_ll_adv_tx_done(g_ble_ll_adv_cur_sm);
 }
 
 /**
@@ -1481,13 +1667,14 @@ ble_ll_adv_wfr_timer_exp(void)
 void
 ble_ll_adv_reset(void)
 {
-    struct ble_ll_adv_sm *advsm;
-    advsm = &g_ble_ll_adv_sm;
+    int i;
 
-    /* Stop advertising state machine */
-    ble_ll_adv_sm_stop(advsm);
+    /* Stop all advertising state machines */
+    for (i = 0; i < BLE_LL_ADV_INSTANCES; ++i) {
+        ble_ll_adv_sm_stop(&g_ble_ll_adv_sm[i]);
+    }
 
-    /* re-initialize the advertiser state machine */
+    /* re-initialize the advertiser state machines */
     ble_ll_adv_init();
 }
 
@@ -1495,7 +1682,54 @@ ble_ll_adv_reset(void)
 uint8_t
 ble_ll_adv_enabled(void)
 {
-    return g_ble_ll_adv_sm.enabled;
+    int i;
+
+    for (i = 0; i < BLE_LL_ADV_INSTANCES; ++i) {
+        if (g_ble_ll_adv_sm[i].enabled) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1) && (MYNEWT_VAL(BLE_LL_NUM_ADV_SETS) > 1)
+/**
+ * Vendor-specific HCI command used to select the advertising set that the
+ * standard advertising commands operate on. The single command parameter
+ * byte carries the set index; the response carries the number of sets
+ * supported by the link layer so the host can discover the configuration.
+ */
+static int
+ble_ll_adv_hci_set_sel(uint8_t *cmdbuf, uint8_t len, uint8_t *rspbuf,
+                       uint8_t *rsplen)
+{
+    if ((len != 1) || (cmdbuf[0] >= BLE_LL_ADV_INSTANCES)) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    g_ble_ll_adv_hci_sm = &g_ble_ll_adv_sm[cmdbuf[0]];
+
+    rspbuf[0] = BLE_LL_ADV_INSTANCES;
+    *rsplen = 1;
+    return BLE_ERR_SUCCESS;
+}
+#endif
+
+/**
+ * Register the vendor-specific advertising commands. Called once from
+ * ble_ll_init() after the vendor command table has been initialized.
+ */
+void
+ble_ll_adv_hci_vendor_init(void)
+{
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1) && (MYNEWT_VAL(BLE_LL_NUM_ADV_SETS) > 1)
+    int rc;
+
+    rc = ble_ll_hci_vendor_cmd_register(BLE_HCI_OCF_VENDOR_ADV_SET_SEL,
+                                        ble_ll_adv_hci_set_sel);
+    assert(rc == 0);
+#endif
 }
 
 /**
@@ -1505,18 +1739,25 @@ ble_ll_adv_enabled(void)
 void
 ble_ll_adv_init(void)
 {
+    int i;
     struct ble_ll_adv_sm *advsm;
 
     /* Set default advertising parameters */
-    advsm = &g_ble_ll_adv_sm;
-    memset(advsm, 0, sizeof(struct ble_ll_adv_sm));
+    for (i = 0; i < BLE_LL_ADV_INSTANCES; ++i) {
+        advsm = &g_ble_ll_adv_sm[i];
+        memset(advsm, 0, sizeof(struct ble_ll_adv_sm));
 
-    advsm->adv_itvl_min = BLE_HCI_ADV_ITVL_DEF;
-    advsm->adv_itvl_max = BLE_HCI_ADV_ITVL_DEF;
-    advsm->adv_chanmask = BLE_HCI_ADV_CHANMASK_DEF;
+        advsm->adv_itvl_min = BLE_HCI_ADV_ITVL_DEF;
+        advsm->adv_itvl_max = BLE_HCI_ADV_ITVL_DEF;
+        advsm->adv_chanmask = BLE_HCI_ADV_CHANMASK_DEF;
+
+        /* Initialize advertising tx done event */
+        advsm->adv_txdone_ev.ev_cb = ble_ll_adv_event_done;
+        advsm->adv_txdone_ev.ev_arg = advsm;
+    }
 
-    /* Initialize advertising tx done event */
-    advsm->adv_txdone_ev.ev_cb = ble_ll_adv_event_done;
-    advsm->adv_txdone_ev.ev_arg = advsm;
+    /* Until a set is selected or on the air, use the default set */
+    g_ble_ll_adv_cur_sm = &g_ble_ll_adv_sm[0];
+    g_ble_ll_adv_hci_sm = &g_ble_ll_adv_sm[0];
 }
 
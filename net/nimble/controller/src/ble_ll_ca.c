@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "syscfg/syscfg.h"
+
+#if (MYNEWT_VAL(BLE_LL_CHAN_ASSESS) == 1)
+
+#include "os/os.h"
+#include "nimble/ble.h"
+#include "nimble/hci_common.h"
+#include "controller/ble_phy.h"
+#include "controller/ble_ll.h"
+#include "controller/ble_ll_ca.h"
+#include "controller/ble_ll_hci_vendor.h"
+#include "ble_ll_conn_priv.h"
+
+/*
+ * Per data channel link quality. Counters saturate and are halved at
+ * every assessment so recent history dominates; the RSSI average is an
+ * EWMA kept in 1/4 dBm units.
+ */
+struct ble_ll_ca_chan
+{
+    uint16_t crc_ok;
+    uint16_t crc_err;
+    int16_t rssi_ewma;
+    uint8_t rssi_valid;
+};
+
+static struct ble_ll_ca_chan g_ble_ll_ca_chans[BLE_PHY_NUM_DATA_CHANS];
+static uint8_t g_ble_ll_ca_host_map[BLE_LL_CONN_CHMAP_LEN];
+static uint8_t g_ble_ll_ca_sugg_map[BLE_LL_CONN_CHMAP_LEN];
+static uint8_t g_ble_ll_ca_auto;
+static struct os_callout g_ble_ll_ca_timer;
+
+#define BLE_LL_CA_ITVL_TICKS        \
+    (MYNEWT_VAL(BLE_LL_CHAN_ASSESS_ITVL_SECS) * OS_TICKS_PER_SEC)
+
+void
+ble_ll_ca_rx(uint8_t chan, int8_t rssi, uint8_t crc_ok)
+{
+    struct ble_ll_ca_chan *cc;
+
+    if (chan >= BLE_PHY_NUM_DATA_CHANS) {
+        return;
+    }
+    cc = &g_ble_ll_ca_chans[chan];
+
+    if (crc_ok) {
+        if (cc->crc_ok < UINT16_MAX) {
+            ++cc->crc_ok;
+        }
+    } else {
+        if (cc->crc_err < UINT16_MAX) {
+            ++cc->crc_err;
+        }
+    }
+
+    if (cc->rssi_valid) {
+        cc->rssi_ewma += ((int16_t)rssi * 4 - cc->rssi_ewma) / 8;
+    } else {
+        cc->rssi_ewma = (int16_t)rssi * 4;
+        cc->rssi_valid = 1;
+    }
+}
+
+void
+ble_ll_ca_suggested_map(uint8_t *chanmap)
+{
+    memcpy(chanmap, g_ble_ll_ca_sugg_map, BLE_LL_CONN_CHMAP_LEN);
+}
+
+void
+ble_ll_ca_host_map_set(uint8_t *chanmap)
+{
+    memcpy(g_ble_ll_ca_host_map, chanmap, BLE_LL_CONN_CHMAP_LEN);
+}
+
+/**
+ * Recompute the suggested channel map from the accumulated counters.
+ *
+ * Starting from the host classification, the worst channel whose CRC
+ * error rate exceeds the threshold is masked repeatedly until no
+ * channel qualifies or the minimum used channel count is reached.
+ * When the host has opted in, the result is applied through the same
+ * path the host channel classification command uses, triggering the
+ * channel map update procedure on master connections.
+ *
+ * Context: Link Layer task.
+ */
+static void
+ble_ll_ca_assess(struct os_event *ev)
+{
+    struct ble_ll_ca_chan *cc;
+    uint8_t map[BLE_LL_CONN_CHMAP_LEN];
+    uint32_t total;
+    uint32_t pct;
+    uint32_t worst_pct;
+    int num_used;
+    int worst;
+    int i;
+    os_sr_t sr;
+
+    memcpy(map, g_ble_ll_ca_host_map, BLE_LL_CONN_CHMAP_LEN);
+
+    num_used = 0;
+    for (i = 0; i < BLE_PHY_NUM_DATA_CHANS; ++i) {
+        if (map[i >> 3] & (1 << (i & 0x07))) {
+            ++num_used;
+        }
+    }
+
+    while (num_used > MYNEWT_VAL(BLE_LL_CHAN_ASSESS_MIN_CHANS)) {
+        worst = -1;
+        worst_pct = MYNEWT_VAL(BLE_LL_CHAN_ASSESS_ERR_PCT);
+        for (i = 0; i < BLE_PHY_NUM_DATA_CHANS; ++i) {
+            if ((map[i >> 3] & (1 << (i & 0x07))) == 0) {
+                continue;
+            }
+            cc = &g_ble_ll_ca_chans[i];
+            total = (uint32_t)cc->crc_ok + cc->crc_err;
+            if (total < MYNEWT_VAL(BLE_LL_CHAN_ASSESS_MIN_SAMPLES)) {
+                continue;
+            }
+            pct = (cc->crc_err * 100) / total;
+            if (pct > worst_pct) {
+                worst_pct = pct;
+                worst = i;
+            }
+        }
+        if (worst < 0) {
+            break;
+        }
+        map[worst >> 3] &= ~(1 << (worst & 0x07));
+        --num_used;
+    }
+
+    memcpy(g_ble_ll_ca_sugg_map, map, BLE_LL_CONN_CHMAP_LEN);
+
+    if (g_ble_ll_ca_auto) {
+        ble_ll_conn_set_global_chanmap(num_used, map);
+    }
+
+    /* Halve the counters so the next window favors fresh samples */
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < BLE_PHY_NUM_DATA_CHANS; ++i) {
+        g_ble_ll_ca_chans[i].crc_ok >>= 1;
+        g_ble_ll_ca_chans[i].crc_err >>= 1;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    os_callout_reset(&g_ble_ll_ca_timer, BLE_LL_CA_ITVL_TICKS);
+}
+
+/**
+ * Process the channel assessment vendor HCI command.
+ *
+ * The command takes one mode byte (0 = advisory only, 1 = autonomously
+ * apply suggested maps) and always returns the current suggested
+ * channel map, so the host can poll the suggestion without changing
+ * the mode it last set.
+ */
+static int
+ble_ll_ca_hci_cmd(uint8_t *cmdbuf, uint8_t len, uint8_t *rspbuf,
+                  uint8_t *rsplen)
+{
+    if ((len != 1) || (cmdbuf[0] > 1)) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    g_ble_ll_ca_auto = cmdbuf[0];
+    memcpy(rspbuf, g_ble_ll_ca_sugg_map, BLE_LL_CONN_CHMAP_LEN);
+    *rsplen = BLE_LL_CONN_CHMAP_LEN;
+
+    return BLE_ERR_SUCCESS;
+}
+
+void
+ble_ll_ca_init(void)
+{
+    int rc;
+
+    memset(g_ble_ll_ca_chans, 0, sizeof(g_ble_ll_ca_chans));
+    g_ble_ll_ca_auto = 0;
+
+    /* Until samples accumulate the suggestion is all data channels */
+    memset(g_ble_ll_ca_host_map, 0xff, BLE_LL_CONN_CHMAP_LEN - 1);
+    g_ble_ll_ca_host_map[BLE_LL_CONN_CHMAP_LEN - 1] = 0x1f;
+    memcpy(g_ble_ll_ca_sugg_map, g_ble_ll_ca_host_map,
+           BLE_LL_CONN_CHMAP_LEN);
+
+    rc = ble_ll_hci_vendor_cmd_register(BLE_HCI_OCF_VENDOR_CHAN_ASSESS,
+                                        ble_ll_ca_hci_cmd);
+    assert(rc == 0);
+
+    os_callout_init(&g_ble_ll_ca_timer, &g_ble_ll_data.ll_evq,
+                    ble_ll_ca_assess, NULL);
+    os_callout_reset(&g_ble_ll_ca_timer, BLE_LL_CA_ITVL_TICKS);
+}
+
+#endif /* BLE_LL_CHAN_ASSESS */
@@ -39,6 +39,8 @@
 #include "controller/ble_ll_adv.h"
 #include "controller/ble_phy.h"
 #include "controller/ble_hw.h"
+#include "controller/ble_ll_prof.h"
+#include "controller/ble_ll_ca.h"
 #include "ble_ll_conn_priv.h"
 #include "hal/hal_gpio.h"
 
@@ -184,6 +186,8 @@ STATS_SECT_START(ble_ll_conn_stats)
     STATS_SECT_ENTRY(tx_l2cap_bytes)
     STATS_SECT_ENTRY(tx_empty_pdus)
     STATS_SECT_ENTRY(mic_failures)
+    STATS_SECT_ENTRY(adaptive_txlen_incr)
+    STATS_SECT_ENTRY(adaptive_txlen_decr)
 STATS_SECT_END
 STATS_SECT_DECL(ble_ll_conn_stats) ble_ll_conn_stats;
 
@@ -214,6 +218,8 @@ STATS_NAME_START(ble_ll_conn_stats)
     STATS_NAME(ble_ll_conn_stats, tx_l2cap_bytes)
     STATS_NAME(ble_ll_conn_stats, tx_empty_pdus)
     STATS_NAME(ble_ll_conn_stats, mic_failures)
+    STATS_NAME(ble_ll_conn_stats, adaptive_txlen_incr)
+    STATS_NAME(ble_ll_conn_stats, adaptive_txlen_decr)
 STATS_NAME_END(ble_ll_conn_stats)
 
 static void ble_ll_conn_spvn_timeout(struct os_event *ev);
@@ -338,6 +344,11 @@ ble_ll_conn_current_sm_over(struct ble_ll_conn_sm *connsm)
 /**
  * Given a handle, find an active connection matching the handle
  *
+ * This is a direct index into g_ble_ll_conn_sm: handles are assigned
+ * linearly (1 to BLE_MAX_CONNECTIONS) by ble_ll_conn_module_init() and
+ * never reassigned, so the per-packet lookup is O(1) with no list walk.
+ * Keep that invariant if the handle assignment scheme ever changes.
+ *
  * @param handle
  *
  * @return struct ble_ll_conn_sm*
@@ -357,6 +368,41 @@ ble_ll_conn_find_active_conn(uint16_t handle)
     return connsm;
 }
 
+/**
+ * Returns the timing of the most recently scheduled connection event of an
+ * active connection: its event counter, its anchor point (cputime) and the
+ * connection interval in microseconds.  Both peers of a connection agree on
+ * the mapping from event counter to anchor point to within the receive
+ * accuracy of the slave's radio, which makes the anchor a shared time
+ * reference for synchronization protocols layered above.
+ *
+ * @param handle        Connection handle
+ * @param evt_cntr      Event counter of the returned anchor point
+ * @param anchor        Anchor point, in cputime ticks
+ * @param itvl_usecs    Connection interval, in microseconds
+ *
+ * @return int 0 on success; BLE_ERR_UNK_CONN_ID if no such connection.
+ */
+int
+ble_ll_conn_anchor_get(uint16_t handle, uint16_t *evt_cntr, uint32_t *anchor,
+                       uint32_t *itvl_usecs)
+{
+    struct ble_ll_conn_sm *connsm;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    connsm = ble_ll_conn_find_active_conn(handle);
+    if (!connsm) {
+        OS_EXIT_CRITICAL(sr);
+        return BLE_ERR_UNK_CONN_ID;
+    }
+    *evt_cntr = connsm->event_cntr;
+    *anchor = connsm->anchor_point;
+    *itvl_usecs = connsm->conn_itvl * BLE_LL_CONN_ITVL_USECS;
+    OS_EXIT_CRITICAL(sr);
+    return BLE_ERR_SUCCESS;
+}
+
 /**
  * Get a connection state machine.
  */
@@ -391,6 +437,9 @@ ble_ll_conn_calc_window_widening(struct ble_ll_conn_sm *connsm)
     uint32_t window_widening;
     int32_t time_since_last_anchor;
     uint32_t delta_msec;
+#if (MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST) == 1)
+    uint32_t meas_ppm;
+#endif
 
     window_widening = 0;
 
@@ -400,6 +449,23 @@ ble_ll_conn_calc_window_widening(struct ble_ll_conn_sm *connsm)
         delta_msec = os_cputime_ticks_to_usecs(time_since_last_anchor) / 1000;
         total_sca_ppm = g_ble_sca_ppm_tbl[connsm->master_sca] +
             MYNEWT_VAL(BLE_LL_OUR_SCA);
+
+#if (MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST) == 1)
+        /*
+         * Once enough anchors have been observed, use the measured drift
+         * plus a guard band instead of the worst-case sleep clock
+         * accuracy. The worst-case value remains an upper bound.
+         */
+        if (connsm->slave_drift_samples >=
+            MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST_MIN_EVENTS)) {
+            meas_ppm = connsm->slave_drift_ppm +
+                MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST_GUARD_PPM);
+            if (meas_ppm < total_sca_ppm) {
+                total_sca_ppm = meas_ppm;
+            }
+        }
+#endif
+
         window_widening = (total_sca_ppm * delta_msec) / 1000;
     }
 
@@ -407,6 +473,69 @@ ble_ll_conn_calc_window_widening(struct ble_ll_conn_sm *connsm)
     return window_widening;
 }
 
+#if (MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST) == 1)
+/**
+ * Update the per-connection clock drift estimate from a received anchor.
+ *
+ * Called when the first PDU of a connection event is received by a slave.
+ * The difference between the predicted anchor point and the actual receive
+ * time, relative to the time elapsed since the last observed anchor, is
+ * the combined drift of the two sleep clocks in ppm. An exponentially
+ * weighted average of these samples replaces the worst-case sleep clock
+ * accuracy in the window widening calculation once enough connection
+ * events have been observed.
+ *
+ * Context: Interrupt
+ *
+ * @param connsm Pointer to connection state machine.
+ * @param anchor Receive start time of the first PDU of the event.
+ */
+static void
+ble_ll_conn_drift_meas(struct ble_ll_conn_sm *connsm, uint32_t anchor)
+{
+    uint32_t sample_ppm;
+    uint32_t delta_usecs;
+    uint32_t elapsed_msecs;
+    int32_t delta;
+    int32_t elapsed;
+
+    /* Time over which the drift accumulated (prediction was made from the
+       last observed anchor) */
+    elapsed = (int32_t)(connsm->anchor_point - connsm->last_anchor_point);
+    if (elapsed <= 0) {
+        return;
+    }
+    elapsed_msecs = os_cputime_ticks_to_usecs(elapsed) / 1000;
+    if (elapsed_msecs == 0) {
+        return;
+    }
+
+    delta = (int32_t)(anchor - connsm->anchor_point);
+    if (delta < 0) {
+        delta = -delta;
+    }
+    delta_usecs = os_cputime_ticks_to_usecs(delta);
+    sample_ppm = (delta_usecs * 1000) / elapsed_msecs;
+
+    /* A sample can never exceed what the worst-case accuracy allows */
+    if (sample_ppm > (g_ble_sca_ppm_tbl[connsm->master_sca] +
+                      MYNEWT_VAL(BLE_LL_OUR_SCA))) {
+        return;
+    }
+
+    if (connsm->slave_drift_samples == 0) {
+        connsm->slave_drift_ppm = sample_ppm;
+    } else {
+        connsm->slave_drift_ppm =
+            ((3 * (uint32_t)connsm->slave_drift_ppm) + sample_ppm) / 4;
+    }
+    if (connsm->slave_drift_samples <
+        MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST_MIN_EVENTS)) {
+        ++connsm->slave_drift_samples;
+    }
+}
+#endif
+
 /**
  * Calculates the number of used channels in the channel map
  *
@@ -762,6 +891,88 @@ ble_ll_conn_chk_csm_flags(struct ble_ll_conn_sm *connsm)
     }
 }
 
+#if (MYNEWT_VAL(BLE_LL_CONN_ADAPTIVE_TXLEN) == 1)
+/*
+ * Adaptive payload sizing parameters. The preferred payload halves after
+ * this many consecutive failed transmissions (nacks or CRC errors with a
+ * data PDU outstanding) and grows by one minimum-sized payload after this
+ * many consecutive acks, clamped to [27, eff_max_tx_octets].
+ */
+#define BLE_LL_CONN_APL_FAIL_THRESH     (2)
+#define BLE_LL_CONN_APL_SUCC_THRESH     (8)
+#define BLE_LL_CONN_APL_INCR_OCTETS     (BLE_LL_CONN_SUPP_BYTES_MIN)
+
+/**
+ * Update the adaptive preferred payload length from the outcome of a data
+ * PDU transmission. On noisy links this backs the payload off toward the
+ * minimum so shorter (more likely to survive) PDUs keep goodput up; as the
+ * link recovers the payload grows back to the negotiated effective maximum.
+ *
+ * Context: interrupt
+ *
+ * @param connsm
+ * @param acked 1 if transmission was acknowledged, 0 otherwise
+ */
+static void
+ble_ll_conn_adaptive_txlen_upd(struct ble_ll_conn_sm *connsm, int acked)
+{
+    uint16_t octets;
+
+    if (acked) {
+        connsm->apl_cons_failures = 0;
+        if (connsm->apl_max_tx_octets >= connsm->eff_max_tx_octets) {
+            connsm->apl_cons_successes = 0;
+            return;
+        }
+        ++connsm->apl_cons_successes;
+        if (connsm->apl_cons_successes >= BLE_LL_CONN_APL_SUCC_THRESH) {
+            connsm->apl_cons_successes = 0;
+            octets = connsm->apl_max_tx_octets + BLE_LL_CONN_APL_INCR_OCTETS;
+            if (octets > connsm->eff_max_tx_octets) {
+                octets = connsm->eff_max_tx_octets;
+            }
+            connsm->apl_max_tx_octets = octets;
+            STATS_INC(ble_ll_conn_stats, adaptive_txlen_incr);
+        }
+    } else {
+        connsm->apl_cons_successes = 0;
+        ++connsm->apl_cons_failures;
+        if (connsm->apl_cons_failures >= BLE_LL_CONN_APL_FAIL_THRESH) {
+            connsm->apl_cons_failures = 0;
+            octets = connsm->apl_max_tx_octets / 2;
+            if (octets < BLE_LL_CONN_SUPP_BYTES_MIN) {
+                octets = BLE_LL_CONN_SUPP_BYTES_MIN;
+            }
+            if (octets != connsm->apl_max_tx_octets) {
+                connsm->apl_max_tx_octets = octets;
+                STATS_INC(ble_ll_conn_stats, adaptive_txlen_decr);
+            }
+        }
+    }
+}
+
+/**
+ * Return whether the current tx PDU is a data PDU whose transmission
+ * outcome should feed adaptive payload sizing (control PDUs and empty
+ * PDUs say nothing about payload size).
+ */
+static int
+ble_ll_conn_adaptive_txlen_chk(struct ble_ll_conn_sm *connsm)
+{
+    struct ble_mbuf_hdr *txhdr;
+
+    if (!connsm->cur_tx_pdu) {
+        return 0;
+    }
+    txhdr = BLE_MBUF_HDR_PTR(connsm->cur_tx_pdu);
+    if ((txhdr->txinfo.hdr_byte & BLE_LL_DATA_HDR_LLID_MASK) ==
+        BLE_LL_LLID_CTRL) {
+        return 0;
+    }
+    return 1;
+}
+#endif
+
 /**
  * Called when we want to send a data channel pdu inside a connection event.
  *
@@ -846,7 +1057,7 @@ ble_ll_conn_tx_data_pdu(struct ble_ll_conn_sm *connsm)
         ble_hdr = BLE_MBUF_HDR_PTR(m);
 
         /* Determine packet length we will transmit */
-        cur_txlen = connsm->eff_max_tx_octets;
+        cur_txlen = CONN_CUR_TX_OCTETS(connsm);
         pktlen = pkthdr->omp_len;
         if (cur_txlen > pktlen) {
             cur_txlen = pktlen;
@@ -917,8 +1128,8 @@ ble_ll_conn_tx_data_pdu(struct ble_ll_conn_sm *connsm)
         if ((cur_offset + cur_txlen) < pktlen) {
             next_txlen = pktlen - (cur_offset + cur_txlen);
         } else {
-            if (nextpkthdr->omp_len > connsm->eff_max_tx_octets) {
-                next_txlen = connsm->eff_max_tx_octets;
+            if (nextpkthdr->omp_len > CONN_CUR_TX_OCTETS(connsm)) {
+                next_txlen = CONN_CUR_TX_OCTETS(connsm);
             } else {
                 next_txlen = nextpkthdr->omp_len;
             }
@@ -1105,6 +1316,7 @@ conn_tx_pdu:
             STATS_INCN(ble_ll_conn_stats, tx_l2cap_bytes, cur_txlen);
         }
     }
+    ble_ll_prof_exit(BLE_LL_PROF_PHASE_PDU);
     return rc;
 }
 
@@ -1132,6 +1344,9 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
     g_ble_ll_conn_cur_sm = connsm;
     assert(connsm);
 
+    /* Start a profiling record for this connection event */
+    ble_ll_prof_conn_ev_start(connsm->conn_handle, connsm->event_cntr);
+
     /* Disable whitelisting as connections do not use it */
     ble_ll_whitelist_disable();
 
@@ -1154,6 +1369,7 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
         /* Set start time of transmission */
         rc = ble_phy_tx_set_start_time(sch->start_time + XCVR_PROC_DELAY_USECS);
         if (!rc) {
+            ble_ll_prof_exit(BLE_LL_PROF_PHASE_SETUP);
 #if MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_ENCRYPTION)
             if (CONN_F_ENCRYPTED(connsm)) {
                 ble_phy_encrypt_enable(connsm->enc_data.tx_pkt_cntr,
@@ -1164,6 +1380,7 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
                 ble_phy_encrypt_disable();
             }
 #endif
+            ble_ll_prof_exit(BLE_LL_PROF_PHASE_ENC);
             rc = ble_ll_conn_tx_data_pdu(connsm);
             if (!rc) {
                 rc = BLE_LL_SCHED_STATE_RUNNING;
@@ -1176,6 +1393,7 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
             rc = BLE_LL_SCHED_STATE_DONE;
         }
     } else {
+        ble_ll_prof_exit(BLE_LL_PROF_PHASE_SETUP);
 #if MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_ENCRYPTION)
             if (CONN_F_ENCRYPTED(connsm)) {
                 ble_phy_encrypt_enable(connsm->enc_data.rx_pkt_cntr,
@@ -1186,6 +1404,7 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
                 ble_phy_encrypt_disable();
             }
 #endif
+        ble_ll_prof_exit(BLE_LL_PROF_PHASE_ENC);
         /*
          * XXX: make sure I dont care that I get here early to start receiving.
          * I could use events compare and all that shit to start rx.
@@ -1228,6 +1447,7 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
 
     /* Set time that we last serviced the schedule */
     connsm->last_scheduled = os_cputime_get32();
+    ble_ll_prof_exit(BLE_LL_PROF_PHASE_SETUP);
     return rc;
 }
 
@@ -1273,8 +1493,8 @@ ble_ll_conn_can_send_next_pdu(struct ble_ll_conn_sm *connsm, uint32_t begtime)
         if (txpdu) {
             txhdr = BLE_MBUF_HDR_PTR(txpdu);
             rem_bytes = pkthdr->omp_len - txhdr->txinfo.offset;
-            if (rem_bytes > connsm->eff_max_tx_octets) {
-                rem_bytes = connsm->eff_max_tx_octets;
+            if (rem_bytes > CONN_CUR_TX_OCTETS(connsm)) {
+                rem_bytes = CONN_CUR_TX_OCTETS(connsm);
             }
             ticks = BLE_TX_DUR_USECS_M(rem_bytes);
         } else {
@@ -1491,6 +1711,16 @@ ble_ll_conn_sm_new(struct ble_ll_conn_sm *connsm)
     connsm->rem_max_rx_octets = BLE_LL_CONN_SUPP_BYTES_MIN;
     connsm->eff_max_tx_octets = BLE_LL_CONN_SUPP_BYTES_MIN;
     connsm->eff_max_rx_octets = BLE_LL_CONN_SUPP_BYTES_MIN;
+#if (MYNEWT_VAL(BLE_LL_CONN_ADAPTIVE_TXLEN) == 1)
+    connsm->apl_max_tx_octets = connsm->eff_max_tx_octets;
+    connsm->apl_cons_failures = 0;
+    connsm->apl_cons_successes = 0;
+#endif
+
+#if (MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST) == 1)
+    connsm->slave_drift_ppm = 0;
+    connsm->slave_drift_samples = 0;
+#endif
 
     /* Reset encryption data */
 #if MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_ENCRYPTION)
@@ -1556,6 +1786,12 @@ ble_ll_conn_datalen_update(struct ble_ll_conn_sm *connsm,
     if (eff_bytes != connsm->eff_max_tx_octets) {
         connsm->eff_max_tx_octets = eff_bytes;
         send_event = 1;
+#if (MYNEWT_VAL(BLE_LL_CONN_ADAPTIVE_TXLEN) == 1)
+        /* New negotiated regime; restart adaptation from the new maximum */
+        connsm->apl_max_tx_octets = connsm->eff_max_tx_octets;
+        connsm->apl_cons_failures = 0;
+        connsm->apl_cons_successes = 0;
+#endif
     }
 
     if (send_event) {
@@ -1895,6 +2131,8 @@ ble_ll_conn_event_end(struct os_event *ev)
     connsm = (struct ble_ll_conn_sm *)ev->ev_arg;
     assert(connsm);
 
+    ble_ll_prof_enter();
+
     /* Check if we need to resume scanning */
     ble_ll_scan_chk_resume();
 
@@ -1972,6 +2210,10 @@ ble_ll_conn_event_end(struct os_event *ev)
 
     /* If we have completed packets, send an event */
     ble_ll_conn_num_comp_pkts_event_send(connsm);
+
+    /* Close out the profiling record for this connection event */
+    ble_ll_prof_exit(BLE_LL_PROF_PHASE_CLEANUP);
+    ble_ll_prof_conn_ev_end();
 }
 
 /**
@@ -2500,6 +2742,9 @@ ble_ll_conn_rx_isr_start(struct ble_mbuf_hdr *rxhdr, uint32_t aa)
         /* Set anchor point (and last) if 1st rxd frame in connection event */
         if (connsm->csmflags.cfbit.slave_set_last_anchor) {
             connsm->csmflags.cfbit.slave_set_last_anchor = 0;
+#if (MYNEWT_VAL(BLE_LL_CONN_DRIFT_EST) == 1)
+            ble_ll_conn_drift_meas(connsm, rxhdr->beg_cputime);
+#endif
             connsm->last_anchor_point = rxhdr->beg_cputime;
             connsm->anchor_point = connsm->last_anchor_point;
         }
@@ -2623,7 +2868,11 @@ ble_ll_conn_rx_data_pdu(struct os_mbuf *rxpdu, struct ble_mbuf_hdr *hdr)
                     acl_hdr = (acl_hdr << 12) | connsm->conn_handle;
                     htole16(rxbuf, acl_hdr);
                     htole16(rxbuf + 2, acl_len);
+#if (MYNEWT_VAL(BLE_LL_HOST_FLOW_CTRL) == 1)
+                    ble_ll_conn_hci_acl_to_host(rxpdu);
+#else
                     ble_hci_trans_ll_acl_tx(rxpdu);
+#endif
                 }
 
                 /* NOTE: we dont free the mbuf since we handed it off! */
@@ -2674,6 +2923,8 @@ ble_ll_conn_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
     struct os_mbuf *rxpdu;
     struct ble_mbuf_hdr *txhdr;
 
+    ble_ll_prof_enter();
+
     /* Retrieve the header and payload length */
     hdr_byte = rxbuf[0];
     rx_pyld_len = rxbuf[1];
@@ -2698,6 +2949,10 @@ ble_ll_conn_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
         goto conn_exit;
     }
 
+    /* Feed the channel assessment counters */
+    ble_ll_ca_rx(connsm->data_chan_index, rxhdr->rxinfo.rssi,
+                 BLE_MBUF_HDR_CRC_OK(rxhdr));
+
     /*
      * Check the packet CRC. A connection event can continue even if the
      * received PDU does not pass the CRC check. If we receive two consecutive
@@ -2709,6 +2964,11 @@ ble_ll_conn_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
          * one we will end the connection event.
          */
         ++connsm->cons_rxd_bad_crc;
+#if (MYNEWT_VAL(BLE_LL_CONN_ADAPTIVE_TXLEN) == 1)
+        if (ble_ll_conn_adaptive_txlen_chk(connsm)) {
+            ble_ll_conn_adaptive_txlen_upd(connsm, 0);
+        }
+#endif
         if (connsm->cons_rxd_bad_crc >= 2) {
             reply = 0;
         } else {
@@ -2772,6 +3032,11 @@ ble_ll_conn_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
             if ((hdr_nesn && conn_sn) || (!hdr_nesn && !conn_sn)) {
                 /* We did not get an ACK. Must retry the PDU */
                 STATS_INC(ble_ll_conn_stats, data_pdu_txf);
+#if (MYNEWT_VAL(BLE_LL_CONN_ADAPTIVE_TXLEN) == 1)
+                if (ble_ll_conn_adaptive_txlen_chk(connsm)) {
+                    ble_ll_conn_adaptive_txlen_upd(connsm, 0);
+                }
+#endif
             } else {
                 /* Transmit success */
                 connsm->tx_seqnum ^= 1;
@@ -2808,6 +3073,9 @@ ble_ll_conn_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
                         }
                     }
 
+#if (MYNEWT_VAL(BLE_LL_CONN_ADAPTIVE_TXLEN) == 1)
+                    ble_ll_conn_adaptive_txlen_upd(connsm, 1);
+#endif
                     /* Increment offset based on number of bytes sent */
                     txhdr->txinfo.offset += txhdr->txinfo.pyld_len;
                     if (txhdr->txinfo.offset >= OS_MBUF_PKTLEN(txpdu)) {
@@ -2822,8 +3090,8 @@ ble_ll_conn_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
                         connsm->cur_tx_pdu = NULL;
                     } else {
                         rem_bytes = OS_MBUF_PKTLEN(txpdu) - txhdr->txinfo.offset;
-                        if (rem_bytes > connsm->eff_max_tx_octets) {
-                            txhdr->txinfo.pyld_len = connsm->eff_max_tx_octets;
+                        if (rem_bytes > CONN_CUR_TX_OCTETS(connsm)) {
+                            txhdr->txinfo.pyld_len = CONN_CUR_TX_OCTETS(connsm);
                         } else {
                             txhdr->txinfo.pyld_len = rem_bytes;
                         }
@@ -2881,6 +3149,7 @@ conn_exit:
         ble_ll_conn_current_sm_over(connsm);
     }
 
+    ble_ll_prof_exit(BLE_LL_PROF_PHASE_PDU);
     return rc;
 }
 
@@ -3189,6 +3458,9 @@ ble_ll_conn_module_reset(void)
         g_ble_ll_conn_comp_ev = NULL;
     }
 
+    /* Drop any ACL packets queued for the host and disable flow control */
+    ble_ll_conn_hci_fc_reset();
+
     /* Now go through and end all the connections */
     while (1) {
         connsm = SLIST_FIRST(&g_ble_ll_conn_active_list);
@@ -33,6 +33,7 @@
 #include "controller/ble_ll_ctrl.h"
 #include "controller/ble_ll_scan.h"
 #include "controller/ble_ll_adv.h"
+#include "controller/ble_ll_ca.h"
 #include "ble_ll_conn_priv.h"
 
 /*
@@ -40,6 +41,12 @@
  * event to the host. This is the os time at which we can send an event.
  */
 static uint32_t g_ble_ll_last_num_comp_pkt_evt;
+
+#if (MYNEWT_VAL(BLE_NUM_COMP_PKT_THRESH) > 1)
+/* Longest time completed packets are held back waiting for more. */
+#define BLE_LL_NUM_COMP_PKT_ITVL_TICKS      \
+    ((MYNEWT_VAL(BLE_NUM_COMP_PKT_ITVL_MS) * OS_TICKS_PER_SEC) / 1000)
+#endif
 extern uint8_t *g_ble_ll_conn_comp_ev;
 
 /**
@@ -266,6 +273,22 @@ ble_ll_conn_num_comp_pkts_event_send(struct ble_ll_conn_sm *connsm)
          * We do this to increase throughput but we dont want to search the
          * entire active list every time.
          */
+#if (MYNEWT_VAL(BLE_NUM_COMP_PKT_THRESH) > 1)
+        /*
+         * Coalesce: keep restarting the hold-back interval while nothing
+         * has completed; once packets complete, hold them until either
+         * enough accumulate or the oldest has waited long enough.
+         */
+        if (connsm->completed_pkts == 0) {
+            connsm->comp_pkt_itvl_start = os_time_get();
+            return;
+        }
+        if ((connsm->completed_pkts < MYNEWT_VAL(BLE_NUM_COMP_PKT_THRESH)) &&
+            ((uint32_t)(os_time_get() - connsm->comp_pkt_itvl_start) <
+             BLE_LL_NUM_COMP_PKT_ITVL_TICKS)) {
+            return;
+        }
+#endif
         if (connsm->completed_pkts) {
             evbuf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_HI);
             if (evbuf) {
@@ -276,6 +299,9 @@ ble_ll_conn_num_comp_pkts_event_send(struct ble_ll_conn_sm *connsm)
                 htole16(evbuf + 5, connsm->completed_pkts);
                 ble_ll_hci_event_send(evbuf);
                 connsm->completed_pkts = 0;
+#if (MYNEWT_VAL(BLE_NUM_COMP_PKT_THRESH) > 1)
+                connsm->comp_pkt_itvl_start = os_time_get();
+#endif
             }
         }
         return;
@@ -972,6 +998,9 @@ ble_ll_conn_hci_set_chan_class(uint8_t *cmdbuf)
     num_used_chans = ble_ll_conn_calc_used_chans(cmdbuf);
     if ((num_used_chans < 2) || ((cmdbuf[4] & 0xe0) != 0)) {
         rc = BLE_ERR_INV_HCI_CMD_PARMS;
+    } else {
+        /* Channel assessment bases its suggestions on the host map */
+        ble_ll_ca_host_map_set(cmdbuf);
     }
 
     /* Set the host channel mask */
@@ -1193,3 +1222,193 @@ wr_auth_exit:
     return rc;
 }
 #endif
+
+#if (MYNEWT_VAL(BLE_LL_HOST_FLOW_CTRL) == 1)
+/*
+ * Controller-to-host flow control. The host grants buffer credits with
+ * the host-buffer-size command and returns them with the host-number-
+ * of-completed-packets command; while no credits remain, ACL packets
+ * destined for the host are queued here in arrival order instead of
+ * being dropped. As the queue consumes the controller's receive
+ * buffers, the link layer stops acknowledging the peer, so the
+ * back-pressure extends end to end. All state is accessed from the
+ * Link Layer task only.
+ */
+static uint8_t g_ble_ll_conn_fc_enabled;
+static uint16_t g_ble_ll_conn_fc_credits;
+static uint16_t g_ble_ll_conn_fc_host_acl_num;
+static STAILQ_HEAD(, os_mbuf_pkthdr) g_ble_ll_conn_fc_q =
+    STAILQ_HEAD_INITIALIZER(g_ble_ll_conn_fc_q);
+
+/**
+ * Send queued ACL packets to the host while credits remain.
+ */
+static void
+ble_ll_conn_hci_fc_drain(void)
+{
+    struct os_mbuf_pkthdr *pkthdr;
+    struct os_mbuf *om;
+
+    while (g_ble_ll_conn_fc_credits > 0) {
+        pkthdr = STAILQ_FIRST(&g_ble_ll_conn_fc_q);
+        if (!pkthdr) {
+            break;
+        }
+        STAILQ_REMOVE_HEAD(&g_ble_ll_conn_fc_q, omp_next);
+        --g_ble_ll_conn_fc_credits;
+        om = OS_MBUF_PKTHDR_TO_MBUF(pkthdr);
+        ble_hci_trans_ll_acl_tx(om);
+    }
+}
+
+/**
+ * Called by the connection data path to send a received ACL data packet
+ * to the host, consuming a credit (or queueing the packet) when flow
+ * control is enabled.
+ *
+ * @param om ACL data packet, beginning with the HCI ACL data header.
+ */
+void
+ble_ll_conn_hci_acl_to_host(struct os_mbuf *om)
+{
+    if (!g_ble_ll_conn_fc_enabled) {
+        ble_hci_trans_ll_acl_tx(om);
+        return;
+    }
+
+    /* Preserve ordering: never pass packets already queued */
+    if (STAILQ_EMPTY(&g_ble_ll_conn_fc_q) && (g_ble_ll_conn_fc_credits > 0)) {
+        --g_ble_ll_conn_fc_credits;
+        ble_hci_trans_ll_acl_tx(om);
+    } else {
+        STAILQ_INSERT_TAIL(&g_ble_ll_conn_fc_q, OS_MBUF_PKTHDR(om), omp_next);
+    }
+}
+
+/**
+ * Process the set controller to host flow control command.
+ *
+ * @param cmdbuf Command parameters
+ * @param len Parameter length
+ *
+ * @return int BLE error code
+ */
+int
+ble_ll_conn_hci_set_ctlr_to_host_fc(uint8_t *cmdbuf, uint8_t len)
+{
+    if (len != BLE_HCI_CTLR_TO_HOST_FC_LEN) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    /* We only support ACL flow control (no synchronous data) */
+    if (cmdbuf[0] > BLE_HCI_CTLR_TO_HOST_FC_ACL) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    /* Not allowed to change while connections exist */
+    if (!SLIST_EMPTY(&g_ble_ll_conn_active_list)) {
+        return BLE_ERR_CMD_DISALLOWED;
+    }
+
+    g_ble_ll_conn_fc_enabled = cmdbuf[0];
+    g_ble_ll_conn_fc_credits = g_ble_ll_conn_fc_host_acl_num;
+
+    return BLE_ERR_SUCCESS;
+}
+
+/**
+ * Process the host buffer size command.
+ *
+ * @param cmdbuf Command parameters
+ * @param len Parameter length
+ *
+ * @return int BLE error code
+ */
+int
+ble_ll_conn_hci_host_buf_size(uint8_t *cmdbuf, uint8_t len)
+{
+    uint16_t acl_num;
+
+    if (len != BLE_HCI_HOST_BUF_SIZE_LEN) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    /* ACL packet length (2), sync packet length (1), ACL count (2),
+       sync count (2); we only use the ACL count. */
+    acl_num = le16toh(cmdbuf + 3);
+    if (acl_num == 0) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    g_ble_ll_conn_fc_host_acl_num = acl_num;
+    g_ble_ll_conn_fc_credits = acl_num;
+
+    return BLE_ERR_SUCCESS;
+}
+
+/**
+ * Process the host number of completed packets command.
+ *
+ * NOTE: per specification this command gets no command complete event
+ * on success; we send one anyway as the dispatcher acknowledges every
+ * command and our host uses the acknowledgement to pace itself.
+ *
+ * @param cmdbuf Command parameters
+ * @param len Parameter length
+ *
+ * @return int BLE error code
+ */
+int
+ble_ll_conn_hci_host_num_comp_pkts(uint8_t *cmdbuf, uint8_t len)
+{
+    int i;
+    uint8_t num_handles;
+    uint32_t credits;
+
+    if (len < BLE_HCI_HOST_NUM_COMP_PKTS_HDR_LEN) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    num_handles = cmdbuf[0];
+    if (len != BLE_HCI_HOST_NUM_COMP_PKTS_HDR_LEN +
+               (num_handles * BLE_HCI_HOST_NUM_COMP_PKTS_ENT_LEN)) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    /* The connection handles do not matter to us; the host buffer pool
+       is shared. Sum the counts. */
+    credits = g_ble_ll_conn_fc_credits;
+    cmdbuf += BLE_HCI_HOST_NUM_COMP_PKTS_HDR_LEN;
+    for (i = 0; i < num_handles; ++i) {
+        credits += le16toh(cmdbuf + 2);
+        cmdbuf += BLE_HCI_HOST_NUM_COMP_PKTS_ENT_LEN;
+    }
+    if (credits > g_ble_ll_conn_fc_host_acl_num) {
+        credits = g_ble_ll_conn_fc_host_acl_num;
+    }
+    g_ble_ll_conn_fc_credits = credits;
+
+    ble_ll_conn_hci_fc_drain();
+
+    return BLE_ERR_SUCCESS;
+}
+
+/**
+ * Called when the LL resets to drop queued packets and disable flow
+ * control.
+ */
+void
+ble_ll_conn_hci_fc_reset(void)
+{
+    struct os_mbuf_pkthdr *pkthdr;
+
+    while ((pkthdr = STAILQ_FIRST(&g_ble_ll_conn_fc_q)) != NULL) {
+        STAILQ_REMOVE_HEAD(&g_ble_ll_conn_fc_q, omp_next);
+        os_mbuf_free_chain(OS_MBUF_PKTHDR_TO_MBUF(pkthdr));
+    }
+
+    g_ble_ll_conn_fc_enabled = 0;
+    g_ble_ll_conn_fc_credits = 0;
+    g_ble_ll_conn_fc_host_acl_num = 0;
+}
+#endif
@@ -158,6 +158,17 @@ void ble_ll_conn_auth_pyld_timer_start(struct ble_ll_conn_sm *connsm);
 #define ble_ll_conn_auth_pyld_timer_start(x)
 #endif
 
+/* Controller-to-host flow control */
+#if (MYNEWT_VAL(BLE_LL_HOST_FLOW_CTRL) == 1)
+void ble_ll_conn_hci_acl_to_host(struct os_mbuf *om);
+int ble_ll_conn_hci_set_ctlr_to_host_fc(uint8_t *cmdbuf, uint8_t len);
+int ble_ll_conn_hci_host_buf_size(uint8_t *cmdbuf, uint8_t len);
+int ble_ll_conn_hci_host_num_comp_pkts(uint8_t *cmdbuf, uint8_t len);
+void ble_ll_conn_hci_fc_reset(void);
+#else
+#define ble_ll_conn_hci_fc_reset()
+#endif
+
 int ble_ll_hci_cmd_rx(uint8_t *cmd, void *arg);
 int ble_ll_hci_acl_rx(struct os_mbuf *om, void *arg);
 
@@ -0,0 +1,514 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "syscfg/syscfg.h"
+
+#if (MYNEWT_VAL(BLE_LL_DTM) == 1)
+
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "nimble/ble.h"
+#include "nimble/hci_common.h"
+#include "controller/ble_ll.h"
+#include "controller/ble_phy.h"
+#include "controller/ble_ll_dtm.h"
+#include "controller/ble_ll_hci_vendor.h"
+
+#if (MYNEWT_VAL(BLE_LL_DTM_CLI) == 1)
+#include "shell/shell.h"
+#include "console/console.h"
+#endif
+
+/* Test packet access address and CRC initial value (Vol 6, Part F) */
+#define BLE_LL_DTM_SYNC_WORD        (0x71764129)
+#define BLE_LL_DTM_CRC_INIT         (0x555555)
+
+/* Test packet payload types (transmitter test command) */
+#define BLE_LL_DTM_PAYLOAD_PRBS9    (0x00)
+#define BLE_LL_DTM_PAYLOAD_0F       (0x01)
+#define BLE_LL_DTM_PAYLOAD_55       (0x02)
+#define BLE_LL_DTM_PAYLOAD_PRBS15   (0x03)
+#define BLE_LL_DTM_PAYLOAD_FF       (0x04)
+#define BLE_LL_DTM_PAYLOAD_00       (0x05)
+#define BLE_LL_DTM_PAYLOAD_F0       (0x06)
+#define BLE_LL_DTM_PAYLOAD_AA       (0x07)
+#define BLE_LL_DTM_PAYLOAD_MAX      (0x07)
+
+/* Test mode channels are a frequency index: F = 2402 + (index * 2) MHz */
+#define BLE_LL_DTM_NUM_CHANS        (40)
+
+/* Current test mode */
+#define BLE_LL_DTM_MODE_NONE        (0)
+#define BLE_LL_DTM_MODE_TX          (1)
+#define BLE_LL_DTM_MODE_RX          (2)
+
+static uint8_t g_ble_ll_dtm_mode;
+static uint8_t g_ble_ll_dtm_chan;
+static uint16_t g_ble_ll_dtm_num_pkts;
+static uint32_t g_ble_ll_dtm_itvl_ticks;
+static uint32_t g_ble_ll_dtm_next_tx;
+static struct os_mbuf *g_ble_ll_dtm_txpdu;
+
+/*
+ * Per-channel receive statistics, indexed by test mode frequency index.
+ * These accumulate across receiver tests until explicitly cleared so a
+ * channel sweep can be read out in one go when the sweep ends.
+ */
+static uint32_t g_ble_ll_dtm_rx_ok[BLE_LL_DTM_NUM_CHANS];
+static uint32_t g_ble_ll_dtm_rx_crcerr[BLE_LL_DTM_NUM_CHANS];
+
+/**
+ * Map a test mode frequency index (0-39) to the BLE channel index the
+ * PHY uses. Frequency index k is 2402 + 2k MHz; BLE data channels 0-10
+ * occupy 2404-2424, 11-36 occupy 2428-2478 and the advertising
+ * channels 37, 38, 39 sit at 2402, 2426 and 2480.
+ */
+static uint8_t
+ble_ll_dtm_phy_chan(uint8_t chan)
+{
+    if (chan == 0) {
+        return 37;
+    } else if (chan < 12) {
+        return chan - 1;
+    } else if (chan == 12) {
+        return 38;
+    } else if (chan < 39) {
+        return chan - 2;
+    } else {
+        return 39;
+    }
+}
+
+/**
+ * Fill a test packet payload with the PRBS9 or PRBS15 sequence, bits
+ * transmitted least significant first (Vol 6, Part F, 4.1.5).
+ */
+static void
+ble_ll_dtm_prbs_fill(uint8_t *dst, int len, int prbs15)
+{
+    uint32_t lfsr;
+    uint32_t fb;
+    uint8_t byte;
+    int i;
+    int j;
+
+    lfsr = prbs15 ? 0x7fff : 0x1ff;
+    for (i = 0; i < len; ++i) {
+        byte = 0;
+        for (j = 0; j < 8; ++j) {
+            byte |= (lfsr & 1) << j;
+            if (prbs15) {
+                /* x^15 + x^14 + 1 */
+                fb = ((lfsr >> 0) ^ (lfsr >> 1)) & 1;
+                lfsr = (lfsr >> 1) | (fb << 14);
+            } else {
+                /* x^9 + x^5 + 1 */
+                fb = ((lfsr >> 0) ^ (lfsr >> 4)) & 1;
+                lfsr = (lfsr >> 1) | (fb << 8);
+            }
+        }
+        dst[i] = byte;
+    }
+}
+
+/**
+ * Transmit end callback for the transmitter test. Re-arms the PHY for
+ * the next test packet at the spec packet interval.
+ *
+ * Context: interrupt
+ */
+static void
+ble_ll_dtm_txend_cb(void *arg)
+{
+    if (g_ble_ll_dtm_mode != BLE_LL_DTM_MODE_TX) {
+        return;
+    }
+
+    ++g_ble_ll_dtm_num_pkts;
+    g_ble_ll_dtm_next_tx += g_ble_ll_dtm_itvl_ticks;
+    ble_phy_tx_set_start_time(g_ble_ll_dtm_next_tx);
+    ble_phy_set_txend_cb(ble_ll_dtm_txend_cb, NULL);
+    ble_phy_tx(g_ble_ll_dtm_txpdu, BLE_PHY_TRANSITION_NONE);
+}
+
+/**
+ * Process the LE transmitter test HCI command.
+ *
+ * Starts transmitting test packets with the requested payload back to
+ * back at the packet interval mandated by the spec (the packet airtime
+ * plus turnaround, rounded up to a multiple of 625 usecs).
+ *
+ * @param cmdbuf tx channel (1), test data length (1), payload type (1)
+ *
+ * @return int BLE error code
+ */
+int
+ble_ll_dtm_tx_test(uint8_t *cmdbuf)
+{
+    uint8_t chan;
+    uint8_t len;
+    uint8_t payload;
+    uint32_t itvl_usecs;
+    struct os_mbuf *m;
+
+    chan = cmdbuf[0];
+    len = cmdbuf[1];
+    payload = cmdbuf[2];
+
+    if ((chan >= BLE_LL_DTM_NUM_CHANS) ||
+        (payload > BLE_LL_DTM_PAYLOAD_MAX) ||
+        (len > ble_phy_max_data_pdu_pyld())) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    if ((g_ble_ll_dtm_mode != BLE_LL_DTM_MODE_NONE) ||
+        (ble_ll_state_get() != BLE_LL_STATE_STANDBY)) {
+        return BLE_ERR_CMD_DISALLOWED;
+    }
+
+    m = os_msys_get_pkthdr(len, sizeof(struct ble_mbuf_hdr));
+    if (!m) {
+        return BLE_ERR_MEM_CAPACITY;
+    }
+
+    /* Build the test packet; the header byte carries the payload type */
+    ble_ll_mbuf_init(m, len, payload);
+    switch (payload) {
+    case BLE_LL_DTM_PAYLOAD_PRBS9:
+        ble_ll_dtm_prbs_fill(m->om_data, len, 0);
+        break;
+    case BLE_LL_DTM_PAYLOAD_PRBS15:
+        ble_ll_dtm_prbs_fill(m->om_data, len, 1);
+        break;
+    case BLE_LL_DTM_PAYLOAD_0F:
+        memset(m->om_data, 0x0f, len);
+        break;
+    case BLE_LL_DTM_PAYLOAD_55:
+        memset(m->om_data, 0x55, len);
+        break;
+    case BLE_LL_DTM_PAYLOAD_FF:
+        memset(m->om_data, 0xff, len);
+        break;
+    case BLE_LL_DTM_PAYLOAD_00:
+        memset(m->om_data, 0x00, len);
+        break;
+    case BLE_LL_DTM_PAYLOAD_F0:
+        memset(m->om_data, 0xf0, len);
+        break;
+    case BLE_LL_DTM_PAYLOAD_AA:
+        memset(m->om_data, 0xaa, len);
+        break;
+    default:
+        break;
+    }
+
+    /*
+     * Packet interval: airtime of preamble, access address, header,
+     * payload and CRC (10 + len octets at 8 usecs each) plus minimum
+     * turnaround, rounded up to a multiple of 625 usecs.
+     */
+    itvl_usecs = (uint32_t)(len + 10) * 8;
+    itvl_usecs = ((itvl_usecs + 249 + 624) / 625) * 625;
+    g_ble_ll_dtm_itvl_ticks = os_cputime_usecs_to_ticks(itvl_usecs);
+
+    g_ble_ll_dtm_txpdu = m;
+    g_ble_ll_dtm_chan = chan;
+    g_ble_ll_dtm_num_pkts = 0;
+    g_ble_ll_dtm_mode = BLE_LL_DTM_MODE_TX;
+
+    ble_phy_setchan(ble_ll_dtm_phy_chan(chan), BLE_LL_DTM_SYNC_WORD,
+                    BLE_LL_DTM_CRC_INIT);
+    ble_ll_state_set(BLE_LL_STATE_DTM);
+
+    g_ble_ll_dtm_next_tx = os_cputime_get32() + g_ble_ll_dtm_itvl_ticks;
+    ble_phy_set_txend_cb(ble_ll_dtm_txend_cb, NULL);
+    ble_phy_tx(g_ble_ll_dtm_txpdu, BLE_PHY_TRANSITION_NONE);
+
+    return BLE_ERR_SUCCESS;
+}
+
+/**
+ * Process the LE receiver test HCI command.
+ *
+ * Places the PHY in receive mode on the requested channel; each test
+ * packet that passes CRC bumps the packet count returned by test end.
+ *
+ * @param cmdbuf rx channel (1)
+ *
+ * @return int BLE error code
+ */
+int
+ble_ll_dtm_rx_test(uint8_t *cmdbuf)
+{
+    uint8_t chan;
+
+    chan = cmdbuf[0];
+    if (chan >= BLE_LL_DTM_NUM_CHANS) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    if ((g_ble_ll_dtm_mode != BLE_LL_DTM_MODE_NONE) ||
+        (ble_ll_state_get() != BLE_LL_STATE_STANDBY)) {
+        return BLE_ERR_CMD_DISALLOWED;
+    }
+
+    g_ble_ll_dtm_chan = chan;
+    g_ble_ll_dtm_num_pkts = 0;
+    g_ble_ll_dtm_mode = BLE_LL_DTM_MODE_RX;
+
+    ble_phy_setchan(ble_ll_dtm_phy_chan(chan), BLE_LL_DTM_SYNC_WORD,
+                    BLE_LL_DTM_CRC_INIT);
+    ble_ll_state_set(BLE_LL_STATE_DTM);
+    ble_phy_rx();
+
+    return BLE_ERR_SUCCESS;
+}
+
+/**
+ * Stop the running test without building a command response.
+ */
+static void
+ble_ll_dtm_stop(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    g_ble_ll_dtm_mode = BLE_LL_DTM_MODE_NONE;
+    OS_EXIT_CRITICAL(sr);
+
+    ble_phy_disable();
+    ble_phy_set_txend_cb(NULL, NULL);
+    if (g_ble_ll_dtm_txpdu) {
+        os_mbuf_free_chain(g_ble_ll_dtm_txpdu);
+        g_ble_ll_dtm_txpdu = NULL;
+    }
+    ble_ll_state_set(BLE_LL_STATE_STANDBY);
+}
+
+/**
+ * Process the LE test end HCI command.
+ *
+ * Stops the running test. The response carries the number of packets
+ * received during a receiver test; for a transmitter test it is zero,
+ * as the spec requires.
+ *
+ * @param rspbuf number of packets (2)
+ *
+ * @return int BLE error code
+ */
+int
+ble_ll_dtm_end_test(uint8_t *rspbuf, uint8_t *rsplen)
+{
+    uint16_t num_pkts;
+
+    if (g_ble_ll_dtm_mode == BLE_LL_DTM_MODE_NONE) {
+        return BLE_ERR_CMD_DISALLOWED;
+    }
+
+    num_pkts = 0;
+    if (g_ble_ll_dtm_mode == BLE_LL_DTM_MODE_RX) {
+        num_pkts = g_ble_ll_dtm_num_pkts;
+    }
+    ble_ll_dtm_stop();
+
+    htole16(rspbuf, num_pkts);
+    *rsplen = sizeof(uint16_t);
+
+    return BLE_ERR_SUCCESS;
+}
+
+/**
+ * Called when a packet reception ends while in DTM state.
+ *
+ * Counts the packet and re-arms the receiver; test packets are never
+ * handed up the stack.
+ *
+ * Context: interrupt
+ *
+ * @return int > 0: PHY re-enable already handled here.
+ */
+int
+ble_ll_dtm_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
+{
+    if (g_ble_ll_dtm_mode == BLE_LL_DTM_MODE_RX) {
+        if (BLE_MBUF_HDR_CRC_OK(rxhdr)) {
+            ++g_ble_ll_dtm_num_pkts;
+            ++g_ble_ll_dtm_rx_ok[g_ble_ll_dtm_chan];
+        } else {
+            ++g_ble_ll_dtm_rx_crcerr[g_ble_ll_dtm_chan];
+        }
+
+        /* Keep receiving until test end */
+        ble_phy_disable();
+        ble_phy_rx();
+    }
+
+    return 1;
+}
+
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+/**
+ * Process the DTM packet error rate vendor HCI command.
+ *
+ * The command takes one test mode frequency index and returns the
+ * accumulated receive and CRC error counts for that channel; index
+ * 0xFF clears the counters for all channels instead. The counters
+ * persist across receiver tests so line software sweeps the band with
+ * standard receiver test commands and reads per-channel PER out here.
+ */
+static int
+ble_ll_dtm_per_hci_cmd(uint8_t *cmdbuf, uint8_t len, uint8_t *rspbuf,
+                       uint8_t *rsplen)
+{
+    uint8_t chan;
+
+    if (len != 1) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    chan = cmdbuf[0];
+    if (chan == 0xff) {
+        memset(g_ble_ll_dtm_rx_ok, 0, sizeof(g_ble_ll_dtm_rx_ok));
+        memset(g_ble_ll_dtm_rx_crcerr, 0, sizeof(g_ble_ll_dtm_rx_crcerr));
+        return BLE_ERR_SUCCESS;
+    }
+
+    if (chan >= BLE_LL_DTM_NUM_CHANS) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    htole32(rspbuf, g_ble_ll_dtm_rx_ok[chan]);
+    htole32(rspbuf + sizeof(uint32_t), g_ble_ll_dtm_rx_crcerr[chan]);
+    *rsplen = 2 * sizeof(uint32_t);
+
+    return BLE_ERR_SUCCESS;
+}
+#endif
+
+#if (MYNEWT_VAL(BLE_LL_DTM_CLI) == 1)
+/*
+ * Shell front-end for line testing without an HCI tester attached. The
+ * radio is dedicated to the test station while these run, so calling
+ * the test entry points from the shell task is fine.
+ */
+static int
+ble_ll_dtm_shell_cmd(int argc, char **argv)
+{
+    uint8_t cmdbuf[BLE_HCI_TX_TEST_LEN];
+    uint8_t rspbuf[sizeof(uint16_t)];
+    uint8_t rsplen;
+    uint32_t total;
+    int chan;
+    int rc;
+
+    if ((argc >= 2) && (strcmp(argv[1], "tx") == 0) && (argc >= 5)) {
+        cmdbuf[0] = atoi(argv[2]);
+        cmdbuf[1] = atoi(argv[3]);
+        cmdbuf[2] = atoi(argv[4]);
+        rc = ble_ll_dtm_tx_test(cmdbuf);
+        console_printf("dtm tx: rc=%d\n", rc);
+    } else if ((argc >= 3) && (strcmp(argv[1], "rx") == 0)) {
+        cmdbuf[0] = atoi(argv[2]);
+        rc = ble_ll_dtm_rx_test(cmdbuf);
+        console_printf("dtm rx: rc=%d\n", rc);
+    } else if ((argc >= 2) && (strcmp(argv[1], "end") == 0)) {
+        rsplen = 0;
+        rspbuf[0] = 0;
+        rspbuf[1] = 0;
+        rc = ble_ll_dtm_end_test(rspbuf, &rsplen);
+        console_printf("dtm end: rc=%d num_pkts=%u\n", rc,
+                       rspbuf[0] | ((uint16_t)rspbuf[1] << 8));
+    } else if ((argc >= 2) && (strcmp(argv[1], "per") == 0)) {
+        if ((argc >= 3) && (strcmp(argv[2], "clear") == 0)) {
+            memset(g_ble_ll_dtm_rx_ok, 0, sizeof(g_ble_ll_dtm_rx_ok));
+            memset(g_ble_ll_dtm_rx_crcerr, 0,
+                   sizeof(g_ble_ll_dtm_rx_crcerr));
+            return 0;
+        }
+        console_printf("chan      rx_ok  crc_err  per(%%)\n");
+        for (chan = 0; chan < BLE_LL_DTM_NUM_CHANS; ++chan) {
+            total = g_ble_ll_dtm_rx_ok[chan] + g_ble_ll_dtm_rx_crcerr[chan];
+            if (total == 0) {
+                continue;
+            }
+            console_printf("%4d %10lu %8lu %7lu\n", chan,
+                           (unsigned long)g_ble_ll_dtm_rx_ok[chan],
+                           (unsigned long)g_ble_ll_dtm_rx_crcerr[chan],
+                           (unsigned long)
+                           ((g_ble_ll_dtm_rx_crcerr[chan] * 100) / total));
+        }
+    } else {
+        console_printf("usage: dtm tx <chan> <len> <payload> |"
+                       " rx <chan> | end | per [clear]\n");
+    }
+
+    return 0;
+}
+
+static struct shell_cmd g_ble_ll_dtm_shell_cmd = {
+    .sc_cmd = "dtm",
+    .sc_cmd_func = ble_ll_dtm_shell_cmd
+};
+#endif
+
+/**
+ * Stop any running test. Called on LL reset; counters are cleared so
+ * the controller comes up in a known state.
+ */
+void
+ble_ll_dtm_reset(void)
+{
+    if (g_ble_ll_dtm_mode != BLE_LL_DTM_MODE_NONE) {
+        ble_ll_dtm_stop();
+    }
+    memset(g_ble_ll_dtm_rx_ok, 0, sizeof(g_ble_ll_dtm_rx_ok));
+    memset(g_ble_ll_dtm_rx_crcerr, 0, sizeof(g_ble_ll_dtm_rx_crcerr));
+}
+
+/**
+ * Initialize the direct test mode module.
+ */
+void
+ble_ll_dtm_init(void)
+{
+    int rc;
+
+    g_ble_ll_dtm_mode = BLE_LL_DTM_MODE_NONE;
+    g_ble_ll_dtm_txpdu = NULL;
+    memset(g_ble_ll_dtm_rx_ok, 0, sizeof(g_ble_ll_dtm_rx_ok));
+    memset(g_ble_ll_dtm_rx_crcerr, 0, sizeof(g_ble_ll_dtm_rx_crcerr));
+
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+    rc = ble_ll_hci_vendor_cmd_register(BLE_HCI_OCF_VENDOR_DTM_PER,
+                                        ble_ll_dtm_per_hci_cmd);
+    assert(rc == 0);
+#endif
+
+#if (MYNEWT_VAL(BLE_LL_DTM_CLI) == 1)
+    rc = shell_cmd_register(&g_ble_ll_dtm_shell_cmd);
+    assert(rc == 0);
+#endif
+
+    (void)rc;
+}
+
+#endif /* BLE_LL_DTM */
@@ -30,8 +30,10 @@
 #include "controller/ble_ll_scan.h"
 #include "controller/ble_ll.h"
 #include "controller/ble_ll_hci.h"
+#include "controller/ble_ll_hci_vendor.h"
 #include "controller/ble_ll_whitelist.h"
 #include "controller/ble_ll_resolv.h"
+#include "controller/ble_ll_dtm.h"
 #include "ble_ll_conn_priv.h"
 
 static void ble_ll_hci_cmd_proc(struct os_event *ev);
@@ -641,6 +643,17 @@ ble_ll_hci_le_cmd_proc(uint8_t *cmdbuf, uint16_t ocf, uint8_t *rsplen)
     case BLE_HCI_OCF_LE_RD_SUPP_STATES :
         rc = ble_ll_hci_le_read_supp_states(rspbuf, rsplen);
         break;
+#if (MYNEWT_VAL(BLE_LL_DTM) == 1)
+    case BLE_HCI_OCF_LE_RX_TEST:
+        rc = ble_ll_dtm_rx_test(cmdbuf);
+        break;
+    case BLE_HCI_OCF_LE_TX_TEST:
+        rc = ble_ll_dtm_tx_test(cmdbuf);
+        break;
+    case BLE_HCI_OCF_LE_TEST_END:
+        rc = ble_ll_dtm_end_test(rspbuf, rsplen);
+        break;
+#endif
     case BLE_HCI_OCF_LE_REM_CONN_PARAM_NRR:
         rc = ble_ll_conn_hci_param_reply(cmdbuf, 0);
         break;
@@ -798,6 +811,17 @@ ble_ll_hci_ctlr_bb_cmd_proc(uint8_t *cmdbuf, uint16_t ocf, uint8_t *rsplen)
             rc = BLE_ERR_SUCCESS;
         }
         break;
+#if (MYNEWT_VAL(BLE_LL_HOST_FLOW_CTRL) == 1)
+    case BLE_HCI_OCF_CB_SET_CTLR_TO_HOST_FC:
+        rc = ble_ll_conn_hci_set_ctlr_to_host_fc(cmdbuf, len);
+        break;
+    case BLE_HCI_OCF_CB_HOST_BUF_SIZE:
+        rc = ble_ll_conn_hci_host_buf_size(cmdbuf, len);
+        break;
+    case BLE_HCI_OCF_CB_HOST_NUM_COMP_PKTS:
+        rc = ble_ll_conn_hci_host_num_comp_pkts(cmdbuf, len);
+        break;
+#endif
 #if (MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_PING) == 1)
     case BLE_HCI_OCF_CB_RD_AUTH_PYLD_TMO:
         rc = ble_ll_conn_hci_wr_auth_pyld_tmo(cmdbuf, rspbuf, rsplen);
@@ -951,6 +975,11 @@ ble_ll_hci_cmd_proc(struct os_event *ev)
     case BLE_HCI_OGF_LE:
         rc = ble_ll_hci_le_cmd_proc(cmdbuf, ocf, &rsplen);
         break;
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+    case BLE_HCI_OGF_VENDOR:
+        rc = ble_ll_hci_vendor_cmd_proc(cmdbuf, ocf, &rsplen);
+        break;
+#endif
     default:
         /* XXX: Need to support other OGF. For now, return unsupported */
         rc = BLE_ERR_UNKNOWN_HCI_CMD;
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+
+#include "nimble/ble.h"
+#include "nimble/hci_common.h"
+#include "controller/ble_ll.h"
+#include "controller/ble_ll_hci_vendor.h"
+
+struct ble_ll_hci_vendor_cmd
+{
+    uint16_t ocf;
+    ble_ll_hci_vendor_cmd_fn *handler;
+};
+
+static struct ble_ll_hci_vendor_cmd
+    g_ble_ll_hci_vendor_cmds[MYNEWT_VAL(BLE_LL_VENDOR_HCI_CMD_MAX)];
+static uint8_t g_ble_ll_hci_vendor_cmd_cnt;
+
+int
+ble_ll_hci_vendor_cmd_register(uint16_t ocf,
+                               ble_ll_hci_vendor_cmd_fn *handler)
+{
+    int i;
+
+    if (g_ble_ll_hci_vendor_cmd_cnt >=
+        MYNEWT_VAL(BLE_LL_VENDOR_HCI_CMD_MAX)) {
+        return -1;
+    }
+
+    for (i = 0; i < g_ble_ll_hci_vendor_cmd_cnt; ++i) {
+        if (g_ble_ll_hci_vendor_cmds[i].ocf == ocf) {
+            return -1;
+        }
+    }
+
+    g_ble_ll_hci_vendor_cmds[g_ble_ll_hci_vendor_cmd_cnt].ocf = ocf;
+    g_ble_ll_hci_vendor_cmds[g_ble_ll_hci_vendor_cmd_cnt].handler = handler;
+    ++g_ble_ll_hci_vendor_cmd_cnt;
+
+    return 0;
+}
+
+int
+ble_ll_hci_vendor_cmd_proc(uint8_t *cmdbuf, uint16_t ocf, uint8_t *rsplen)
+{
+    int i;
+    uint8_t len;
+    uint8_t *rspbuf;
+
+    /* Get length from command */
+    len = cmdbuf[sizeof(uint16_t)];
+
+    /*
+     * The command response pointer points into the same buffer as the
+     * command data itself. That is fine, as each command reads all the data
+     * before crafting a response.
+     */
+    rspbuf = cmdbuf + BLE_HCI_EVENT_CMD_COMPLETE_MIN_LEN;
+
+    /* Move past HCI command header */
+    cmdbuf += BLE_HCI_CMD_HDR_LEN;
+
+    for (i = 0; i < g_ble_ll_hci_vendor_cmd_cnt; ++i) {
+        if (g_ble_ll_hci_vendor_cmds[i].ocf == ocf) {
+            return g_ble_ll_hci_vendor_cmds[i].handler(cmdbuf, len, rspbuf,
+                                                       rsplen);
+        }
+    }
+
+    return BLE_ERR_UNKNOWN_HCI_CMD;
+}
+
+void
+ble_ll_hci_vendor_init(void)
+{
+    memset(g_ble_ll_hci_vendor_cmds, 0, sizeof(g_ble_ll_hci_vendor_cmds));
+    g_ble_ll_hci_vendor_cmd_cnt = 0;
+}
+
+#endif /* BLE_LL_VENDOR_HCI */
@@ -0,0 +1,153 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "syscfg/syscfg.h"
+
+#if (MYNEWT_VAL(BLE_LL_CONN_PROFILE) == 1)
+
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "cbmem/cbmem.h"
+#include "controller/ble_ll_prof.h"
+
+#if (MYNEWT_VAL(BLE_LL_CONN_PROFILE_CLI) == 1)
+#include "shell/shell.h"
+#include "console/console.h"
+#endif
+
+/* Ring of profiling records; the oldest record is overwritten first */
+static struct cbmem g_ble_ll_prof_cbmem;
+static uint8_t g_ble_ll_prof_mem[MYNEWT_VAL(BLE_LL_CONN_PROFILE_RING_SIZE) *
+                                 sizeof(struct ble_ll_prof_rec)];
+
+/*
+ * Record being accumulated for the current connection event. Phase marks
+ * run at interrupt context but connection events themselves are serialized,
+ * so a single accumulator suffices.
+ */
+static struct ble_ll_prof_rec g_ble_ll_prof_cur;
+static uint32_t g_ble_ll_prof_last_mark;
+
+void
+ble_ll_prof_conn_ev_start(uint16_t handle, uint16_t event_cntr)
+{
+    memset(&g_ble_ll_prof_cur, 0, sizeof(g_ble_ll_prof_cur));
+    g_ble_ll_prof_cur.bpr_handle = handle;
+    g_ble_ll_prof_cur.bpr_event_cntr = event_cntr;
+    g_ble_ll_prof_cur.bpr_start_cputime = os_cputime_get32();
+    g_ble_ll_prof_last_mark = g_ble_ll_prof_cur.bpr_start_cputime;
+}
+
+void
+ble_ll_prof_enter(void)
+{
+    g_ble_ll_prof_last_mark = os_cputime_get32();
+}
+
+void
+ble_ll_prof_exit(int phase)
+{
+    uint32_t now;
+    uint32_t ticks;
+
+    assert(phase < BLE_LL_PROF_NUM_PHASES);
+
+    now = os_cputime_get32();
+    ticks = g_ble_ll_prof_cur.bpr_phase_ticks[phase] +
+        (now - g_ble_ll_prof_last_mark);
+    if (ticks > UINT16_MAX) {
+        ticks = UINT16_MAX;
+    }
+    g_ble_ll_prof_cur.bpr_phase_ticks[phase] = ticks;
+    g_ble_ll_prof_last_mark = now;
+}
+
+void
+ble_ll_prof_conn_ev_end(void)
+{
+    os_sr_t sr;
+    struct ble_ll_prof_rec rec;
+
+    /* Phase marks run at interrupt context; snapshot the record whole */
+    OS_ENTER_CRITICAL(sr);
+    rec = g_ble_ll_prof_cur;
+    OS_EXIT_CRITICAL(sr);
+
+    cbmem_append(&g_ble_ll_prof_cbmem, &rec, sizeof(rec));
+}
+
+#if (MYNEWT_VAL(BLE_LL_CONN_PROFILE_CLI) == 1)
+static int
+ble_ll_prof_dump_walk(struct cbmem *cbmem, struct cbmem_entry_hdr *hdr,
+                      void *arg)
+{
+    struct ble_ll_prof_rec rec;
+
+    /* The ring is in fixed-record mode; entries point directly at records */
+    memcpy(&rec, hdr, sizeof(rec));
+    console_printf("%6u %6u %10lu %6lu %6lu %6lu %6lu\n",
+        rec.bpr_handle, rec.bpr_event_cntr,
+        (unsigned long)rec.bpr_start_cputime,
+        (unsigned long)os_cputime_ticks_to_usecs(
+            rec.bpr_phase_ticks[BLE_LL_PROF_PHASE_SETUP]),
+        (unsigned long)os_cputime_ticks_to_usecs(
+            rec.bpr_phase_ticks[BLE_LL_PROF_PHASE_ENC]),
+        (unsigned long)os_cputime_ticks_to_usecs(
+            rec.bpr_phase_ticks[BLE_LL_PROF_PHASE_PDU]),
+        (unsigned long)os_cputime_ticks_to_usecs(
+            rec.bpr_phase_ticks[BLE_LL_PROF_PHASE_CLEANUP]));
+
+    return 0;
+}
+
+static int
+ble_ll_prof_shell_cmd(int argc, char **argv)
+{
+    console_printf("handle  event      start  setup    enc    pdu  clean"
+                   " (usecs)\n");
+    cbmem_walk(&g_ble_ll_prof_cbmem, ble_ll_prof_dump_walk, NULL);
+
+    return 0;
+}
+
+static struct shell_cmd g_ble_ll_prof_shell_cmd = {
+    .sc_cmd = "llprof",
+    .sc_cmd_func = ble_ll_prof_shell_cmd
+};
+#endif
+
+void
+ble_ll_prof_init(void)
+{
+    int rc;
+
+    rc = cbmem_init_fixed(&g_ble_ll_prof_cbmem, g_ble_ll_prof_mem,
+                          sizeof(g_ble_ll_prof_mem),
+                          sizeof(struct ble_ll_prof_rec));
+    assert(rc == 0);
+
+#if (MYNEWT_VAL(BLE_LL_CONN_PROFILE_CLI) == 1)
+    rc = shell_cmd_register(&g_ble_ll_prof_shell_cmd);
+    assert(rc == 0);
+#endif
+}
+
+#endif /* BLE_LL_CONN_PROFILE */
@@ -26,7 +26,11 @@
 #include "nimble/nimble_opt.h"
 #include "controller/ble_hw.h"
 #include "controller/ble_ll.h"
+#if MYNEWT_VAL(BLE_LL_RNG_USE_HAL_TRNG)
+#include "hal/hal_trng.h"
+#endif
 
+#if !MYNEWT_VAL(BLE_LL_RNG_USE_HAL_TRNG)
 /* This is a simple circular buffer for holding N samples of random data */
 struct ble_ll_rnum_data
 {
@@ -103,6 +107,16 @@ ble_ll_rand_data_get(uint8_t *buf, uint8_t len)
 
     return BLE_ERR_SUCCESS;
 }
+#else
+/* Get 'len' bytes of random data */
+int
+ble_ll_rand_data_get(uint8_t *buf, uint8_t len)
+{
+    /* The hal_trng entropy cache refills from the TRNG interrupt. */
+    hal_trng_read_blocking(buf, len);
+    return BLE_ERR_SUCCESS;
+}
+#endif
 
 /**
  * Called to obtain a "prand" as defined in core V4.2 Vol 6 Part B 1.3.2.2
@@ -138,10 +152,14 @@ ble_ll_rand_prand_get(uint8_t *prand)
 int
 ble_ll_rand_start(void)
 {
+#if MYNEWT_VAL(BLE_LL_RNG_USE_HAL_TRNG)
+    /* hal_trng keeps its entropy cache topped up on its own */
+#else
     /* Start the generation of numbers if we are not full */
     if (g_ble_ll_rnum_data.rnd_size < MYNEWT_VAL(BLE_LL_RNG_BUFSIZE)) {
         ble_hw_rng_start();
     }
+#endif
     return 0;
 }
 
@@ -154,8 +172,12 @@ ble_ll_rand_start(void)
 int
 ble_ll_rand_init(void)
 {
+#if MYNEWT_VAL(BLE_LL_RNG_USE_HAL_TRNG)
+    return hal_trng_init();
+#else
     g_ble_ll_rnum_data.rnd_in = g_ble_ll_rnum_buf;
     g_ble_ll_rnum_data.rnd_out = g_ble_ll_rnum_buf;
     ble_hw_rng_init(ble_ll_rand_sample, 1);
     return 0;
+#endif
 }
@@ -23,9 +23,11 @@
 #include "os/os.h"
 #include "nimble/ble.h"
 #include "nimble/nimble_opt.h"
+#include "nimble/hci_common.h"
 #include "controller/ble_ll.h"
 #include "controller/ble_ll_resolv.h"
 #include "controller/ble_ll_hci.h"
+#include "controller/ble_ll_hci_vendor.h"
 #include "controller/ble_ll_scan.h"
 #include "controller/ble_ll_adv.h"
 #include "controller/ble_hw.h"
@@ -44,6 +46,106 @@ struct ble_ll_resolv_data g_ble_ll_resolv_data;
 
 struct ble_ll_resolv_entry g_ble_ll_resolv_list[MYNEWT_VAL(BLE_LL_RESOLV_LIST_SIZE)];
 
+#if (MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE) > 0)
+/*
+ * Cache of recent RPA resolution results consulted before running the
+ * software AES check. Resolution of a given RPA against a given IRK is
+ * deterministic, so cached results only become invalid when the resolving
+ * list changes; every list mutation flushes the cache. IRKs are referenced
+ * by pointer since resolving list entries can shift when one is removed
+ * (which also flushes the cache).
+ */
+struct ble_ll_resolv_rpa_cache_entry
+{
+    uint8_t rce_used;
+    uint8_t rce_resolved;
+    uint8_t rce_rpa[BLE_DEV_ADDR_LEN];
+    const uint8_t *rce_irk;
+    uint32_t rce_lru_seq;
+};
+
+static struct ble_ll_resolv_rpa_cache_entry
+g_ble_ll_resolv_rpa_cache[MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE)];
+static uint32_t g_ble_ll_resolv_rpa_cache_seq;
+
+/**
+ * Flush the RPA resolution cache. Called whenever the resolving list is
+ * modified.
+ */
+static void
+ble_ll_resolv_rpa_cache_clear(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    memset(&g_ble_ll_resolv_rpa_cache[0], 0,
+           sizeof(g_ble_ll_resolv_rpa_cache));
+    OS_EXIT_CRITICAL(sr);
+}
+
+/**
+ * Look up a cached RPA resolution result.
+ *
+ * @param rpa Pointer to resolvable private address
+ * @param irk Pointer to IRK the address is checked against
+ *
+ * @return int -1: not cached; 0 or 1: cached resolution result.
+ */
+static int
+ble_ll_resolv_rpa_cache_find(uint8_t *rpa, uint8_t *irk)
+{
+    int i;
+    struct ble_ll_resolv_rpa_cache_entry *rce;
+
+    rce = &g_ble_ll_resolv_rpa_cache[0];
+    for (i = 0; i < MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE); ++i, ++rce) {
+        if (rce->rce_used && (rce->rce_irk == irk) &&
+            !memcmp(rce->rce_rpa, rpa, BLE_DEV_ADDR_LEN)) {
+            ++g_ble_ll_resolv_rpa_cache_seq;
+            rce->rce_lru_seq = g_ble_ll_resolv_rpa_cache_seq;
+            return rce->rce_resolved;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Add an RPA resolution result to the cache, evicting the least recently
+ * used entry if no free one exists.
+ *
+ * @param rpa Pointer to resolvable private address
+ * @param irk Pointer to IRK the address was checked against
+ * @param resolved Resolution result
+ */
+static void
+ble_ll_resolv_rpa_cache_add(uint8_t *rpa, uint8_t *irk, uint8_t resolved)
+{
+    int i;
+    struct ble_ll_resolv_rpa_cache_entry *rce;
+    struct ble_ll_resolv_rpa_cache_entry *lru;
+
+    lru = &g_ble_ll_resolv_rpa_cache[0];
+    rce = lru;
+    for (i = 0; i < MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE); ++i, ++rce) {
+        if (!rce->rce_used) {
+            lru = rce;
+            break;
+        }
+        if ((int32_t)(rce->rce_lru_seq - lru->rce_lru_seq) < 0) {
+            lru = rce;
+        }
+    }
+
+    lru->rce_used = 1;
+    lru->rce_resolved = resolved;
+    memcpy(lru->rce_rpa, rpa, BLE_DEV_ADDR_LEN);
+    lru->rce_irk = irk;
+    ++g_ble_ll_resolv_rpa_cache_seq;
+    lru->rce_lru_seq = g_ble_ll_resolv_rpa_cache_seq;
+}
+#endif
+
 /**
  * Called to determine if a change is allowed to the resolving list at this
  * time. We are not allowed to modify the resolving list if address translation
@@ -133,6 +235,10 @@ ble_ll_resolv_list_clr(void)
     g_ble_ll_resolv_data.rl_cnt = 0;
     ble_hw_resolv_list_clear();
 
+#if (MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE) > 0)
+    ble_ll_resolv_rpa_cache_clear();
+#endif
+
     return BLE_ERR_SUCCESS;
 }
 
@@ -251,6 +357,10 @@ ble_ll_resolv_list_add(uint8_t *cmdbuf)
             rl->rl_local_rpa_set = 1;
         }
         ++g_ble_ll_resolv_data.rl_cnt;
+
+#if (MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE) > 0)
+        ble_ll_resolv_rpa_cache_clear();
+#endif
     }
 
     return rc;
@@ -288,10 +398,92 @@ ble_ll_resolv_list_rmv(uint8_t *cmdbuf)
 
         /* Remove from HW list */
         ble_hw_resolv_list_rmv(position - 1);
+
+#if (MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE) > 0)
+        ble_ll_resolv_rpa_cache_clear();
+#endif
+    }
+
+    return BLE_ERR_SUCCESS;
+}
+
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+/**
+ * Vendor-specific bulk resolving list set command.
+ *
+ * Atomically replaces the entire resolving list with the entries carried in
+ * a single HCI command: a one byte entry count followed by count instances
+ * of the standard LE add-to-resolving-list parameter block (address type,
+ * identity address, peer IRK, local IRK). Avoids one HCI round trip per
+ * bonded device when restoring the list after a reboot.
+ *
+ * @return int BLE error code
+ */
+static int
+ble_ll_resolv_list_bulk_set(uint8_t *cmdbuf, uint8_t len, uint8_t *rspbuf,
+                            uint8_t *rsplen)
+{
+    int i;
+    int rc;
+    uint8_t nentries;
+    uint8_t *entry;
+
+    /* Validate length and each entry before we touch the list */
+    if (len < 1) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+    nentries = cmdbuf[0];
+    if ((nentries > g_ble_ll_resolv_data.rl_size) ||
+        (len != (1 + (nentries * BLE_HCI_RL_BULK_SET_ENT_LEN)))) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    entry = cmdbuf + 1;
+    for (i = 0; i < nentries; ++i) {
+        if (entry[0] > BLE_ADDR_TYPE_RANDOM) {
+            return BLE_ERR_INV_HCI_CMD_PARMS;
+        }
+        entry += BLE_HCI_RL_BULK_SET_ENT_LEN;
+    }
+
+    rc = ble_ll_resolv_list_clr();
+    if (rc != BLE_ERR_SUCCESS) {
+        return rc;
+    }
+
+    entry = cmdbuf + 1;
+    for (i = 0; i < nentries; ++i) {
+        rc = ble_ll_resolv_list_add(entry);
+        if (rc != BLE_ERR_SUCCESS) {
+            return rc;
+        }
+        entry += BLE_HCI_RL_BULK_SET_ENT_LEN;
     }
 
+    /* Return the number of entries programmed */
+    rspbuf[0] = nentries;
+    *rsplen = 1;
     return BLE_ERR_SUCCESS;
 }
+#endif
+
+/**
+ * Register the resolving list vendor-specific HCI commands.
+ *
+ * Called once at link layer initialization, after the vendor command table
+ * has been initialized.
+ */
+void
+ble_ll_resolv_hci_vendor_init(void)
+{
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+    int rc;
+
+    rc = ble_ll_hci_vendor_cmd_register(BLE_HCI_OCF_VENDOR_RL_BULK_SET,
+                                        ble_ll_resolv_list_bulk_set);
+    assert(rc == 0);
+#endif
+}
 
 /**
  * Called to enable or disable address resolution in the controller
@@ -494,6 +686,13 @@ ble_ll_resolv_rpa(uint8_t *rpa, uint8_t *irk)
     uint32_t *pt32;
     struct ble_encryption_block ecb;
 
+#if (MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE) > 0)
+    rc = ble_ll_resolv_rpa_cache_find(rpa, irk);
+    if (rc >= 0) {
+        return rc;
+    }
+#endif
+
     irk32 = (uint32_t *)irk;
     key32 = (uint32_t *)&ecb.key[0];
 
@@ -520,6 +719,10 @@ ble_ll_resolv_rpa(uint8_t *rpa, uint8_t *irk)
         rc = 0;
     }
 
+#if (MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE) > 0)
+    ble_ll_resolv_rpa_cache_add(rpa, irk, rc);
+#endif
+
     return rc;
 }
 
@@ -50,6 +50,7 @@
  * receive a scan response from? Implement this.
  */
 
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 0)
 /* Dont allow more than 255 of these entries */
 #if MYNEWT_VAL(BLE_LL_NUM_SCAN_DUP_ADVS) > 255
     #error "Cannot have more than 255 duplicate entries!"
@@ -57,6 +58,22 @@
 #if MYNEWT_VAL(BLE_LL_NUM_SCAN_RSP_ADVS) > 255
     #error "Cannot have more than 255 scan response entries!"
 #endif
+#else
+/* The tables are indexed by masking a hash; sizes must be powers of two */
+#if MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH_SIZE) & \
+    (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH_SIZE) - 1)
+    #error "BLE_LL_SCAN_FILT_HASH_SIZE must be a power of two!"
+#endif
+#if MYNEWT_VAL(BLE_LL_SCAN_FILT_BLOOM_BITS) & \
+    (MYNEWT_VAL(BLE_LL_SCAN_FILT_BLOOM_BITS) - 1)
+    #error "BLE_LL_SCAN_FILT_BLOOM_BITS must be a power of two!"
+#endif
+#endif
+
+/* The spec limits an advertising report event to 25 reports */
+#if MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS) > 0x19
+    #error "Cannot batch more than 25 advertising reports per event!"
+#endif
 
 /* The scanning state machine global object */
 struct ble_ll_scan_sm g_ble_ll_scan_sm;
@@ -76,7 +93,34 @@ struct ble_ll_scan_advertisers
 #define BLE_LL_SC_ADV_F_SCAN_RSP_RXD    (0x02)
 #define BLE_LL_SC_ADV_F_DIRECT_RPT_SENT (0x04)
 #define BLE_LL_SC_ADV_F_ADV_RPT_SENT    (0x08)
+#define BLE_LL_SC_ADV_F_IN_USE          (0x10)
+
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 1)
+/*
+ * The advertiser stores are open-addressed hash tables keyed on the
+ * advertiser address (and address type), each fronted by a small Bloom
+ * prefilter. The prefilter rejects never-seen advertisers with two bit
+ * tests so per-PDU filtering cost stays constant in dense RF environments.
+ */
 
+/* Contains list of advertisers that we have heard scan responses from */
+static uint16_t g_ble_ll_scan_num_rsp_advs;
+struct ble_ll_scan_advertisers
+g_ble_ll_scan_rsp_advs[MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH_SIZE)];
+static uint32_t
+g_ble_ll_scan_rsp_bloom[MYNEWT_VAL(BLE_LL_SCAN_FILT_BLOOM_BITS) / 32];
+
+/* Used to filter duplicate advertising events to host */
+static uint16_t g_ble_ll_scan_num_dup_advs;
+struct ble_ll_scan_advertisers
+g_ble_ll_scan_dup_advs[MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH_SIZE)];
+static uint32_t
+g_ble_ll_scan_dup_bloom[MYNEWT_VAL(BLE_LL_SCAN_FILT_BLOOM_BITS) / 32];
+
+/* Stop inserting at 3/4 occupancy to keep probe sequences short */
+#define BLE_LL_SCAN_FILT_HASH_CAPACITY      \
+    ((3 * MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH_SIZE)) / 4)
+#else
 /* Contains list of advertisers that we have heard scan responses from */
 static uint8_t g_ble_ll_scan_num_rsp_advs;
 struct ble_ll_scan_advertisers
@@ -86,6 +130,7 @@ g_ble_ll_scan_rsp_advs[MYNEWT_VAL(BLE_LL_NUM_SCAN_RSP_ADVS)];
 static uint8_t g_ble_ll_scan_num_dup_advs;
 struct ble_ll_scan_advertisers
 g_ble_ll_scan_dup_advs[MYNEWT_VAL(BLE_LL_NUM_SCAN_DUP_ADVS)];
+#endif
 
 /* See Vol 6 Part B Section 4.4.3.2. Active scanning backoff */
 static void
@@ -190,6 +235,149 @@ ble_ll_scan_req_pdu_make(struct ble_ll_scan_sm *scansm, uint8_t *adv_addr,
     memcpy(dptr + BLE_DEV_ADDR_LEN, adv_addr, BLE_DEV_ADDR_LEN);
 }
 
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 1)
+/**
+ * Calculate the filter hash of an advertiser address.
+ *
+ * @param addr Pointer to address
+ * @param txadd TxAdd bit. 0: public; random otherwise
+ *
+ * @return uint32_t Hash of the address and address type
+ */
+static uint32_t
+ble_ll_scan_filt_hash(uint8_t *addr, uint8_t txadd)
+{
+    uint32_t h;
+
+    h = addr[0] | ((uint32_t)addr[1] << 8) | ((uint32_t)addr[2] << 16) |
+        ((uint32_t)addr[3] << 24);
+    h ^= addr[4] | ((uint32_t)addr[5] << 8);
+    if (txadd) {
+        h ^= (1UL << 16);
+    }
+    h *= 0x9E3779B1;
+    h ^= h >> 16;
+
+    return h;
+}
+
+/**
+ * Check the Bloom prefilter for an advertiser hash. A clear bit means the
+ * advertiser is definitely not in the corresponding hash table.
+ *
+ * @param bloom Pointer to prefilter bitmap
+ * @param h Advertiser hash
+ *
+ * @return int 0: definitely not present; 1: possibly present.
+ */
+static int
+ble_ll_scan_filt_bloom_chk(uint32_t *bloom, uint32_t h)
+{
+    uint32_t bit;
+
+    bit = h & (MYNEWT_VAL(BLE_LL_SCAN_FILT_BLOOM_BITS) - 1);
+    if ((bloom[bit >> 5] & (1UL << (bit & 31))) == 0) {
+        return 0;
+    }
+    bit = (h >> 16) & (MYNEWT_VAL(BLE_LL_SCAN_FILT_BLOOM_BITS) - 1);
+    if ((bloom[bit >> 5] & (1UL << (bit & 31))) == 0) {
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Set the Bloom prefilter bits for an advertiser hash.
+ *
+ * @param bloom Pointer to prefilter bitmap
+ * @param h Advertiser hash
+ */
+static void
+ble_ll_scan_filt_bloom_set(uint32_t *bloom, uint32_t h)
+{
+    uint32_t bit;
+
+    bit = h & (MYNEWT_VAL(BLE_LL_SCAN_FILT_BLOOM_BITS) - 1);
+    bloom[bit >> 5] |= (1UL << (bit & 31));
+    bit = (h >> 16) & (MYNEWT_VAL(BLE_LL_SCAN_FILT_BLOOM_BITS) - 1);
+    bloom[bit >> 5] |= (1UL << (bit & 31));
+}
+
+/**
+ * Probe an advertiser hash table for an address.  Entries are never removed
+ * individually (the tables are only cleared wholesale) so linear probing
+ * can stop at the first unused slot.
+ *
+ * @param tbl Pointer to hash table
+ * @param addr Pointer to address
+ * @param txadd TxAdd bit. 0: public; random otherwise
+ * @param h Advertiser hash
+ * @param free_adv If not NULL, set to the insertion slot for the address
+ *                 (NULL if the table is full).
+ *
+ * @return Pointer to matching entry, or NULL if not present.
+ */
+static struct ble_ll_scan_advertisers *
+ble_ll_scan_filt_find(struct ble_ll_scan_advertisers *tbl, uint8_t *addr,
+                      uint8_t txadd, uint32_t h,
+                      struct ble_ll_scan_advertisers **free_adv)
+{
+    uint32_t idx;
+    uint32_t probes;
+    struct ble_ll_scan_advertisers *adv;
+
+    if (free_adv) {
+        *free_adv = NULL;
+    }
+
+    idx = h & (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH_SIZE) - 1);
+    for (probes = 0; probes < MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH_SIZE);
+         ++probes) {
+        adv = &tbl[idx];
+        if ((adv->sc_adv_flags & BLE_LL_SC_ADV_F_IN_USE) == 0) {
+            if (free_adv) {
+                *free_adv = adv;
+            }
+            return NULL;
+        }
+
+        /* Address type must match as well as the address */
+        if (!memcmp(&adv->adv_addr, addr, BLE_DEV_ADDR_LEN)) {
+            if (txadd) {
+                if (adv->sc_adv_flags & BLE_LL_SC_ADV_F_RANDOM_ADDR) {
+                    return adv;
+                }
+            } else {
+                if ((adv->sc_adv_flags & BLE_LL_SC_ADV_F_RANDOM_ADDR) == 0) {
+                    return adv;
+                }
+            }
+        }
+
+        idx = (idx + 1) & (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH_SIZE) - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * Forget all filtered advertisers: clear both hash tables and their Bloom
+ * prefilters.
+ */
+static void
+ble_ll_scan_filt_clear(void)
+{
+    g_ble_ll_scan_num_rsp_advs = 0;
+    memset(&g_ble_ll_scan_rsp_advs[0], 0, sizeof(g_ble_ll_scan_rsp_advs));
+    memset(&g_ble_ll_scan_rsp_bloom[0], 0, sizeof(g_ble_ll_scan_rsp_bloom));
+
+    g_ble_ll_scan_num_dup_advs = 0;
+    memset(&g_ble_ll_scan_dup_advs[0], 0, sizeof(g_ble_ll_scan_dup_advs));
+    memset(&g_ble_ll_scan_dup_bloom[0], 0, sizeof(g_ble_ll_scan_dup_bloom));
+}
+#endif
+
 /**
  * Checks to see if an advertiser is on the duplicate address list.
  *
@@ -201,6 +389,17 @@ ble_ll_scan_req_pdu_make(struct ble_ll_scan_sm *scansm, uint8_t *adv_addr,
 static struct ble_ll_scan_advertisers *
 ble_ll_scan_find_dup_adv(uint8_t *addr, uint8_t txadd)
 {
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 1)
+    uint32_t h;
+
+    h = ble_ll_scan_filt_hash(addr, txadd);
+    if (!ble_ll_scan_filt_bloom_chk(g_ble_ll_scan_dup_bloom, h)) {
+        return NULL;
+    }
+
+    return ble_ll_scan_filt_find(g_ble_ll_scan_dup_advs, addr, txadd, h,
+                                 NULL);
+#else
     uint8_t num_advs;
     struct ble_ll_scan_advertisers *adv;
 
@@ -229,6 +428,7 @@ next_dup_adv:
     }
 
     return NULL;
+#endif
 }
 
 /**
@@ -273,6 +473,34 @@ ble_ll_scan_is_dup_adv(uint8_t pdu_type, uint8_t txadd, uint8_t *addr)
 void
 ble_ll_scan_add_dup_adv(uint8_t *addr, uint8_t txadd, uint8_t subev)
 {
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 1)
+    uint32_t h;
+    struct ble_ll_scan_advertisers *adv;
+    struct ble_ll_scan_advertisers *free_adv;
+
+    /* Check to see if in table. */
+    h = ble_ll_scan_filt_hash(addr, txadd);
+    adv = ble_ll_scan_filt_find(g_ble_ll_scan_dup_advs, addr, txadd, h,
+                                &free_adv);
+    if (!adv) {
+        /* XXX: for now, if we dont have room, just leave */
+        if (!free_adv ||
+            (g_ble_ll_scan_num_dup_advs == BLE_LL_SCAN_FILT_HASH_CAPACITY)) {
+            return;
+        }
+
+        /* Add the advertiser to the table */
+        adv = free_adv;
+        memcpy(&adv->adv_addr, addr, BLE_DEV_ADDR_LEN);
+        ++g_ble_ll_scan_num_dup_advs;
+
+        adv->sc_adv_flags = BLE_LL_SC_ADV_F_IN_USE;
+        if (txadd) {
+            adv->sc_adv_flags |= BLE_LL_SC_ADV_F_RANDOM_ADDR;
+        }
+        ble_ll_scan_filt_bloom_set(g_ble_ll_scan_dup_bloom, h);
+    }
+#else
     uint8_t num_advs;
     struct ble_ll_scan_advertisers *adv;
 
@@ -295,6 +523,7 @@ ble_ll_scan_add_dup_adv(uint8_t *addr, uint8_t txadd, uint8_t subev)
             adv->sc_adv_flags |= BLE_LL_SC_ADV_F_RANDOM_ADDR;
         }
     }
+#endif
 
     if (subev == BLE_HCI_LE_SUBEV_DIRECT_ADV_RPT) {
         adv->sc_adv_flags |= BLE_LL_SC_ADV_F_DIRECT_RPT_SENT;
@@ -314,6 +543,20 @@ ble_ll_scan_add_dup_adv(uint8_t *addr, uint8_t txadd, uint8_t subev)
 static int
 ble_ll_scan_have_rxd_scan_rsp(uint8_t *addr, uint8_t txadd)
 {
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 1)
+    uint32_t h;
+
+    h = ble_ll_scan_filt_hash(addr, txadd);
+    if (!ble_ll_scan_filt_bloom_chk(g_ble_ll_scan_rsp_bloom, h)) {
+        return 0;
+    }
+
+    if (ble_ll_scan_filt_find(g_ble_ll_scan_rsp_advs, addr, txadd, h, NULL)) {
+        return 1;
+    }
+
+    return 0;
+#else
     uint8_t num_advs;
     struct ble_ll_scan_advertisers *adv;
 
@@ -338,11 +581,42 @@ ble_ll_scan_have_rxd_scan_rsp(uint8_t *addr, uint8_t txadd)
     }
 
     return 0;
+#endif
 }
 
 static void
 ble_ll_scan_add_scan_rsp_adv(uint8_t *addr, uint8_t txadd)
 {
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 1)
+    uint32_t h;
+    struct ble_ll_scan_advertisers *adv;
+    struct ble_ll_scan_advertisers *free_adv;
+
+    /* Check if address is already in the table */
+    h = ble_ll_scan_filt_hash(addr, txadd);
+    if (ble_ll_scan_filt_find(g_ble_ll_scan_rsp_advs, addr, txadd, h,
+                              &free_adv)) {
+        return;
+    }
+
+    /* XXX: for now, if we dont have room, just leave */
+    if (!free_adv ||
+        (g_ble_ll_scan_num_rsp_advs == BLE_LL_SCAN_FILT_HASH_CAPACITY)) {
+        return;
+    }
+
+    /* Add the advertiser to the table */
+    adv = free_adv;
+    memcpy(&adv->adv_addr, addr, BLE_DEV_ADDR_LEN);
+    adv->sc_adv_flags = BLE_LL_SC_ADV_F_IN_USE | BLE_LL_SC_ADV_F_SCAN_RSP_RXD;
+    if (txadd) {
+        adv->sc_adv_flags |= BLE_LL_SC_ADV_F_RANDOM_ADDR;
+    }
+    ble_ll_scan_filt_bloom_set(g_ble_ll_scan_rsp_bloom, h);
+    ++g_ble_ll_scan_num_rsp_advs;
+
+    return;
+#else
     uint8_t num_advs;
     struct ble_ll_scan_advertisers *adv;
 
@@ -367,7 +641,133 @@ ble_ll_scan_add_scan_rsp_adv(uint8_t *addr, uint8_t txadd)
     ++g_ble_ll_scan_num_rsp_advs;
 
     return;
+#endif
+}
+
+#if (MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS) > 0)
+/**
+ * Send the partially filled advertising report event to the host (if any).
+ */
+static void
+ble_ll_scan_batch_flush(struct ble_ll_scan_sm *scansm)
+{
+    uint8_t *evbuf;
+
+    evbuf = scansm->scan_batch_evbuf;
+    if (evbuf) {
+        scansm->scan_batch_evbuf = NULL;
+        os_callout_stop(&scansm->scan_batch_timer);
+        ble_ll_hci_event_send(evbuf);
+    }
+}
+
+static void
+ble_ll_scan_batch_timer_cb(struct os_event *ev)
+{
+    ble_ll_scan_batch_flush(&g_ble_ll_scan_sm);
+}
+
+/**
+ * Append a report to a pending advertising report event.
+ *
+ * Because of the ridiculous spec, each field of the reports is a contiguous
+ * array inside the event (all event types, then all address types, and so
+ * on), so appending a report means inserting into each array, shifting the
+ * later arrays towards the back of the event buffer. Each report occupies
+ * 10 fixed bytes (event type, address type, address, data length, rssi)
+ * plus its advertising data; 9 of those come before the data arrays.
+ *
+ * @return 0 on success; -1 if the report does not fit in the event.
+ */
+static int
+ble_ll_scan_batch_append(uint8_t *evbuf, uint8_t evtype, uint8_t addr_type,
+                         uint8_t *addr, uint8_t adv_data_len,
+                         uint8_t *adv_data, uint8_t rssi)
+{
+    int n;
+    int dlen;
+    uint8_t *p;
+
+    n = evbuf[3];
+    if (n >= MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS)) {
+        return -1;
+    }
+    if ((BLE_HCI_EVENT_HDR_LEN + evbuf[1] + 10 + adv_data_len) >
+        BLE_LL_MAX_EVT_LEN) {
+        return -1;
+    }
+
+    /* Length of the advertising data already staged in the event */
+    dlen = evbuf[1] - 2 - (10 * n);
+
+    /* Shift the arrays back to front so none gets overwritten */
+    p = evbuf + 4;
+    memmove(p + 9 * (n + 1) + dlen + adv_data_len, p + 9 * n + dlen, n);
+    memmove(p + 9 * (n + 1), p + 9 * n, dlen);
+    memmove(p + 8 * (n + 1), p + 8 * n, n);
+    memmove(p + 2 * (n + 1), p + 2 * n, n * BLE_DEV_ADDR_LEN);
+    memmove(p + (n + 1), p + n, n);
+
+    p[n] = evtype;
+    p[(n + 1) + n] = addr_type;
+    memcpy(p + 2 * (n + 1) + n * BLE_DEV_ADDR_LEN, addr, BLE_DEV_ADDR_LEN);
+    p[8 * (n + 1) + n] = adv_data_len;
+    memcpy(p + 9 * (n + 1) + dlen, adv_data, adv_data_len);
+    p[9 * (n + 1) + dlen + adv_data_len + n] = rssi;
+
+    evbuf[1] += 10 + adv_data_len;
+    evbuf[3] = n + 1;
+
+    return 0;
+}
+
+/**
+ * Add an advertising report to the batched report event, allocating a new
+ * event and sending filled ones as needed.
+ *
+ * @return 0 if the report was staged or sent; -1 on buffer exhaustion.
+ */
+static int
+ble_ll_scan_batch_adv_report(struct ble_ll_scan_sm *scansm, uint8_t evtype,
+                             uint8_t addr_type, uint8_t *addr,
+                             uint8_t adv_data_len, uint8_t *adv_data,
+                             uint8_t rssi)
+{
+    uint8_t *evbuf;
+
+    evbuf = scansm->scan_batch_evbuf;
+    if (evbuf &&
+        ble_ll_scan_batch_append(evbuf, evtype, addr_type, addr,
+                                 adv_data_len, adv_data, rssi)) {
+        /* The pending event is full; send it and start a new one */
+        ble_ll_scan_batch_flush(scansm);
+        evbuf = NULL;
+    }
+
+    if (!evbuf) {
+        evbuf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
+        if (!evbuf) {
+            return -1;
+        }
+        evbuf[0] = BLE_HCI_EVCODE_LE_META;
+        evbuf[1] = 2;
+        evbuf[2] = BLE_HCI_LE_SUBEV_ADV_RPT;
+        evbuf[3] = 0;
+        ble_ll_scan_batch_append(evbuf, evtype, addr_type, addr,
+                                 adv_data_len, adv_data, rssi);
+        scansm->scan_batch_evbuf = evbuf;
+        os_callout_reset(&scansm->scan_batch_timer,
+                         (MYNEWT_VAL(BLE_LL_SCAN_BATCH_ITVL_MS) *
+                          OS_TICKS_PER_SEC) / 1000);
+    }
+
+    if (evbuf[3] >= MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS)) {
+        ble_ll_scan_batch_flush(scansm);
+    }
+
+    return 0;
 }
+#endif
 
 /**
  * Send an advertising report to the host.
@@ -427,8 +827,57 @@ ble_ll_hci_send_adv_report(uint8_t pdu_type, uint8_t txadd, uint8_t *rxbuf,
         event_len = BLE_HCI_LE_ADV_RPT_MIN_LEN + adv_data_len;
     }
 
+#if (MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS) > 0)
+    /*
+     * Batch everything except directed advertising reports; those have
+     * their own subevent and format and are not worth coalescing.
+     */
+    if (pdu_type != BLE_ADV_PDU_TYPE_ADV_DIRECT_IND) {
+        if (!ble_ll_hci_is_le_event_enabled(subev)) {
+            return;
+        }
+
+        if (txadd) {
+            addr_type = BLE_HCI_ADV_OWN_ADDR_RANDOM;
+        } else {
+            addr_type = BLE_HCI_ADV_OWN_ADDR_PUBLIC;
+        }
+
+        rxbuf += BLE_LL_PDU_HDR_LEN;
+#if MYNEWT_VAL(BLE_LL_CFG_FEAT_LL_PRIVACY)
+        if (BLE_MBUF_HDR_RESOLVED(hdr)) {
+            index = scansm->scan_rpa_index;
+            adv_addr = g_ble_ll_resolv_list[index].rl_identity_addr;
+            /*
+             * NOTE: this looks a bit odd, but the resolved address types
+             * are 2 greater than the unresolved ones in the spec, so
+             * we just add 2 here.
+             */
+            addr_type = g_ble_ll_resolv_list[index].rl_addr_type + 2;
+        } else {
+            adv_addr = rxbuf;
+        }
+#else
+        adv_addr = rxbuf;
+#endif
+
+        rc = ble_ll_scan_batch_adv_report(scansm, evtype, addr_type,
+                                          adv_addr, adv_data_len,
+                                          rxbuf + BLE_DEV_ADDR_LEN,
+                                          hdr->rxinfo.rssi);
+        if (!rc) {
+            /* If filtering, add it to list of duplicate addresses */
+            if (g_ble_ll_scan_sm.scan_filt_dups) {
+                ble_ll_scan_add_dup_adv(adv_addr, txadd, subev);
+            }
+        }
+        return;
+    }
+#endif
+
     if (ble_ll_hci_is_le_event_enabled(subev)) {
-        evbuf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
+        /* Advertising reports always fit in a small event buffer. */
+        evbuf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_SMALL);
         if (evbuf) {
             evbuf[0] = BLE_HCI_EVCODE_LE_META;
             evbuf[1] = event_len;
@@ -678,6 +1127,11 @@ ble_ll_scan_sm_stop(int chk_disable)
     /* Count # of times stopped */
     STATS_INC(ble_ll_stats, scan_stops);
 
+#if (MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS) > 0)
+    /* Send any batched advertising reports before stopping */
+    ble_ll_scan_batch_flush(scansm);
+#endif
+
     /* Only set state if we are currently in a scan window */
     if (chk_disable) {
         OS_ENTER_CRITICAL(sr);
@@ -724,8 +1178,12 @@ ble_ll_scan_sm_start(struct ble_ll_scan_sm *scansm)
     scansm->scan_rsp_pending = 0;
 
     /* Forget filtered advertisers from previous scan. */
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 1)
+    ble_ll_scan_filt_clear();
+#else
     g_ble_ll_scan_num_rsp_advs = 0;
     g_ble_ll_scan_num_dup_advs = 0;
+#endif
 
     /* XXX: align to current or next slot???. */
     /* Schedule start time now */
@@ -769,6 +1227,11 @@ ble_ll_scan_event_proc(struct os_event *ev)
         return;
     }
 
+#if (MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS) > 0)
+    /* The scan window is changing; dont hold reports across it */
+    ble_ll_scan_batch_flush(scansm);
+#endif
+
     /* Make sure the scan window start time and channel are up to date. */
     now = os_cputime_get32();
 
@@ -887,6 +1350,79 @@ ble_ll_scan_rx_isr_start(uint8_t pdu_type, uint8_t *rxflags)
     return rc;
 }
 
+/**
+ * Called when the advertiser address bytes of a received PDU have arrived
+ * and the Link Layer is in the scanning state. If the scanning filter
+ * policy uses the whitelist and the advertiser is not on it, the rest of
+ * the PDU will be discarded at rx end anyway, so tell the PHY to abort
+ * reception now and reclaim the remaining radio-on time.
+ *
+ * Context: Interrupt
+ *
+ * @param rxbuf Pointer to received data; only the PDU header and the
+ *              advertiser address are valid.
+ *
+ * @return int
+ *   < 0: Abort reception of this frame.
+ *  >= 0: Continue receiving the frame.
+ */
+int
+ble_ll_scan_rx_isr_adva(uint8_t *rxbuf)
+{
+    uint8_t pdu_type;
+    uint8_t addr_type;
+    uint8_t *peer;
+    struct ble_ll_scan_sm *scansm;
+
+    scansm = &g_ble_ll_scan_sm;
+
+    /* Can only pre-judge PDUs when the whitelist filter policy is used */
+    if ((scansm->scan_filt_policy & 1) == 0) {
+        return 0;
+    }
+
+    /*
+     * Dont abort while a scan request is outstanding; the backoff
+     * accounting in rx start/end must see the frame through.
+     */
+    if (scansm->scan_rsp_pending) {
+        return 0;
+    }
+
+    /* Only these PDU types are whitelist filtered while scanning */
+    pdu_type = rxbuf[0] & BLE_ADV_PDU_HDR_TYPE_MASK;
+    switch (pdu_type) {
+    case BLE_ADV_PDU_TYPE_ADV_IND:
+    case BLE_ADV_PDU_TYPE_ADV_SCAN_IND:
+    case BLE_ADV_PDU_TYPE_ADV_NONCONN_IND:
+    case BLE_ADV_PDU_TYPE_ADV_DIRECT_IND:
+        break;
+    default:
+        return 0;
+    }
+
+    peer = rxbuf + BLE_LL_PDU_HDR_LEN;
+    if (rxbuf[0] & BLE_ADV_PDU_HDR_TXADD_MASK) {
+        addr_type = BLE_ADDR_TYPE_RANDOM;
+    } else {
+        addr_type = BLE_ADDR_TYPE_PUBLIC;
+    }
+
+#if (MYNEWT_VAL(BLE_LL_CFG_FEAT_LL_PRIVACY) == 1)
+    /* Resolvable addresses cannot be judged until resolution at rx end */
+    if (ble_ll_is_rpa(peer, addr_type) && ble_ll_resolv_enabled()) {
+        return 0;
+    }
+#endif
+
+    if (!ble_ll_whitelist_match(peer, addr_type, 0)) {
+        STATS_INC(ble_ll_stats, scan_early_aborts);
+        return -1;
+    }
+
+    return 0;
+}
+
 /**
  * Called when a receive PDU has ended.
  *
@@ -1447,11 +1983,15 @@ ble_ll_scan_reset(void)
     os_mbuf_free_chain(scansm->scan_req_pdu);
 
     /* Reset duplicate advertisers and those from which we rxd a response */
+#if (MYNEWT_VAL(BLE_LL_SCAN_FILT_HASH) == 1)
+    ble_ll_scan_filt_clear();
+#else
     g_ble_ll_scan_num_rsp_advs = 0;
     memset(&g_ble_ll_scan_rsp_advs[0], 0, sizeof(g_ble_ll_scan_rsp_advs));
 
     g_ble_ll_scan_num_dup_advs = 0;
     memset(&g_ble_ll_scan_dup_advs[0], 0, sizeof(g_ble_ll_scan_dup_advs));
+#endif
 
     /* Call the init function again */
     ble_ll_scan_init();
@@ -1483,6 +2023,12 @@ ble_ll_scan_init(void)
     /* Initialize connection supervision timer */
     os_cputime_timer_init(&scansm->scan_timer, ble_ll_scan_timer_cb, scansm);
 
+#if (MYNEWT_VAL(BLE_LL_SCAN_BATCH_ADV_REPORTS) > 0)
+    /* Initialize the batched advertising report flush timer */
+    os_callout_init(&scansm->scan_batch_timer, &g_ble_ll_data.ll_evq,
+                    ble_ll_scan_batch_timer_cb, NULL);
+#endif
+
     /* Get a scan request mbuf (packet header) and attach to state machine */
     scansm->scan_req_pdu = os_msys_get_pkthdr(BLE_SCAN_MAX_PKT_LEN,
                                               sizeof(struct ble_mbuf_hdr));
@@ -51,6 +51,191 @@ int32_t g_ble_ll_sched_max_late;
 /* Queue for timers */
 TAILQ_HEAD(ll_sched_qhead, ble_ll_sched_item) g_ble_ll_sched_q;
 
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+
+#define BLE_LL_SCHED_SL_LEVELS      MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST_LEVELS)
+
+/*
+ * Express lanes over the schedule queue.  Since scheduled items never
+ * overlap, they are ordered identically by start and end time, so the
+ * lanes can be searched on either key.  NULL predecessor means the lane
+ * head.  All lane manipulation happens inside the caller's critical
+ * section.
+ */
+static struct ble_ll_sched_item *g_ble_ll_sched_sl_head[BLE_LL_SCHED_SL_LEVELS];
+static uint32_t g_ble_ll_sched_sl_rand = 0xA3C59AC3;
+
+static uint8_t
+ble_ll_sched_sl_rand_height(void)
+{
+    uint32_t r;
+    uint8_t h;
+
+    /* xorshift32; each extra lane is taken with probability 1/2 */
+    r = g_ble_ll_sched_sl_rand;
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+    g_ble_ll_sched_sl_rand = r;
+
+    h = 0;
+    while ((r & 1) && (h < BLE_LL_SCHED_SL_LEVELS)) {
+        h++;
+        r >>= 1;
+    }
+    return h;
+}
+
+static void
+ble_ll_sched_sl_preds(uint32_t start_time, struct ble_ll_sched_item **update)
+{
+    struct ble_ll_sched_item *pred;
+    struct ble_ll_sched_item *next;
+    int lvl;
+
+    pred = NULL;
+    for (lvl = BLE_LL_SCHED_SL_LEVELS - 1; lvl >= 0; lvl--) {
+        next = pred ? pred->sl_next[lvl] : g_ble_ll_sched_sl_head[lvl];
+        while (next && (int32_t)(next->start_time - start_time) < 0) {
+            pred = next;
+            next = pred->sl_next[lvl];
+        }
+        update[lvl] = pred;
+    }
+}
+
+static void
+ble_ll_sched_sl_insert(struct ble_ll_sched_item *sch)
+{
+    struct ble_ll_sched_item *update[BLE_LL_SCHED_SL_LEVELS];
+    int lvl;
+
+    ble_ll_sched_sl_preds(sch->start_time, update);
+    sch->sl_height = ble_ll_sched_sl_rand_height();
+    for (lvl = 0; lvl < sch->sl_height; lvl++) {
+        if (update[lvl]) {
+            sch->sl_next[lvl] = update[lvl]->sl_next[lvl];
+            update[lvl]->sl_next[lvl] = sch;
+        } else {
+            sch->sl_next[lvl] = g_ble_ll_sched_sl_head[lvl];
+            g_ble_ll_sched_sl_head[lvl] = sch;
+        }
+    }
+}
+
+static void
+ble_ll_sched_sl_remove(struct ble_ll_sched_item *sch)
+{
+    struct ble_ll_sched_item *update[BLE_LL_SCHED_SL_LEVELS];
+    struct ble_ll_sched_item *next;
+    int lvl;
+
+    if (sch->sl_height == 0) {
+        return;
+    }
+
+    ble_ll_sched_sl_preds(sch->start_time, update);
+    for (lvl = 0; lvl < sch->sl_height; lvl++) {
+        /* Step over lane peers with an equal start time (transient while
+         * overlapping items are being evicted).
+         */
+        while (1) {
+            next = update[lvl] ? update[lvl]->sl_next[lvl] :
+                g_ble_ll_sched_sl_head[lvl];
+            if (!next || next == sch ||
+                (int32_t)(next->start_time - sch->start_time) > 0) {
+                break;
+            }
+            update[lvl] = next;
+        }
+        if (next == sch) {
+            if (update[lvl]) {
+                update[lvl]->sl_next[lvl] = sch->sl_next[lvl];
+            } else {
+                g_ble_ll_sched_sl_head[lvl] = sch->sl_next[lvl];
+            }
+        }
+    }
+    sch->sl_height = 0;
+}
+
+#endif /* MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST) */
+
+/*
+ * Schedule queue mutators.  All insertions and removals must go through
+ * these so the express lane index (when enabled) stays in sync with the
+ * list.
+ */
+static void
+ble_ll_sched_q_insert_before(struct ble_ll_sched_item *entry,
+                             struct ble_ll_sched_item *sch)
+{
+    TAILQ_INSERT_BEFORE(entry, sch, link);
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+    ble_ll_sched_sl_insert(sch);
+#endif
+}
+
+static void
+ble_ll_sched_q_insert_head(struct ble_ll_sched_item *sch)
+{
+    TAILQ_INSERT_HEAD(&g_ble_ll_sched_q, sch, link);
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+    ble_ll_sched_sl_insert(sch);
+#endif
+}
+
+static void
+ble_ll_sched_q_insert_tail(struct ble_ll_sched_item *sch)
+{
+    TAILQ_INSERT_TAIL(&g_ble_ll_sched_q, sch, link);
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+    ble_ll_sched_sl_insert(sch);
+#endif
+}
+
+static void
+ble_ll_sched_q_remove(struct ble_ll_sched_item *sch)
+{
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+    ble_ll_sched_sl_remove(sch);
+#endif
+    TAILQ_REMOVE(&g_ble_ll_sched_q, sch, link);
+}
+
+/*
+ * Find the first scheduled item whose end time is after 'time'; this is
+ * where any slot search for an item starting at 'time' must begin, as
+ * everything before it ends too early to matter.  Since scheduled items
+ * are disjoint, end times are ordered the same way as start times.
+ */
+static struct ble_ll_sched_item *
+ble_ll_sched_q_find_end_gt(uint32_t time)
+{
+    struct ble_ll_sched_item *entry;
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+    struct ble_ll_sched_item *pred;
+    struct ble_ll_sched_item *next;
+    int lvl;
+
+    pred = NULL;
+    for (lvl = BLE_LL_SCHED_SL_LEVELS - 1; lvl >= 0; lvl--) {
+        next = pred ? pred->sl_next[lvl] : g_ble_ll_sched_sl_head[lvl];
+        while (next && (int32_t)(next->end_time - time) <= 0) {
+            pred = next;
+            next = pred->sl_next[lvl];
+        }
+    }
+    entry = pred ? TAILQ_NEXT(pred, link) : TAILQ_FIRST(&g_ble_ll_sched_q);
+#else
+    entry = TAILQ_FIRST(&g_ble_ll_sched_q);
+#endif
+    while (entry && (int32_t)(entry->end_time - time) <= 0) {
+        entry = TAILQ_NEXT(entry, link);
+    }
+    return entry;
+}
+
 /**
  * Checks if two events in the schedule will overlap in time. NOTE: consecutive
  * schedule items can end and start at the same time.
@@ -112,7 +297,7 @@ ble_ll_sched_conn_overlap(struct ble_ll_sched_item *entry)
     if (entry->sched_type == BLE_LL_SCHED_TYPE_CONN) {
         connsm = (struct ble_ll_conn_sm *)entry->cb_arg;
         entry->enqueued = 0;
-        TAILQ_REMOVE(&g_ble_ll_sched_q, entry, link);
+        ble_ll_sched_q_remove(entry);
         ble_ll_event_send(&connsm->conn_ev_end);
         rc = 0;
     } else {
@@ -129,7 +314,7 @@ ble_ll_sched_insert_if_empty(struct ble_ll_sched_item *sch)
 
     entry = TAILQ_FIRST(&g_ble_ll_sched_q);
     if (!entry) {
-        TAILQ_INSERT_HEAD(&g_ble_ll_sched_q, sch, link);
+        ble_ll_sched_q_insert_head(sch);
         sch->enqueued = 1;
     }
     return entry;
@@ -179,7 +364,8 @@ ble_ll_sched_conn_reschedule(struct ble_ll_conn_sm *connsm)
     start_overlap = NULL;
     end_overlap = NULL;
     rc = 0;
-    TAILQ_FOREACH(entry, &g_ble_ll_sched_q, link) {
+    for (entry = ble_ll_sched_q_find_end_gt(sch->start_time); entry;
+         entry = TAILQ_NEXT(entry, link)) {
         if (ble_ll_sched_is_overlap(sch, entry)) {
             /* Only insert if this element is older than all that we overlap */
             if ((entry->sched_type == BLE_LL_SCHED_TYPE_ADV) ||
@@ -198,7 +384,7 @@ ble_ll_sched_conn_reschedule(struct ble_ll_conn_sm *connsm)
         } else {
             if ((int32_t)(sch->end_time - entry->start_time) < 0) {
                 rc = 0;
-                TAILQ_INSERT_BEFORE(entry, sch, link);
+                ble_ll_sched_q_insert_before(entry, sch);
                 break;
             }
         }
@@ -206,7 +392,7 @@ ble_ll_sched_conn_reschedule(struct ble_ll_conn_sm *connsm)
 
     if (!rc) {
         if (!entry) {
-            TAILQ_INSERT_TAIL(&g_ble_ll_sched_q, sch, link);
+            ble_ll_sched_q_insert_tail(sch);
         }
         sch->enqueued = 1;
     }
@@ -220,7 +406,7 @@ ble_ll_sched_conn_reschedule(struct ble_ll_conn_sm *connsm)
             ble_ll_event_send(&tmp->conn_ev_end);
         }
 
-        TAILQ_REMOVE(&g_ble_ll_sched_q, entry, link);
+        ble_ll_sched_q_remove(entry);
         entry->enqueued = 0;
 
         if (entry == end_overlap) {
@@ -309,7 +495,8 @@ ble_ll_sched_master_new(struct ble_ll_conn_sm *connsm, uint32_t adv_rxend,
         connsm->tx_win_off = 0;
     } else {
         os_cputime_timer_stop(&g_ble_ll_sched_timer);
-        TAILQ_FOREACH(entry, &g_ble_ll_sched_q, link) {
+        for (entry = ble_ll_sched_q_find_end_gt(earliest_start); entry;
+             entry = TAILQ_NEXT(entry, link)) {
             /* Set these because overlap function needs them to be set */
             sch->start_time = earliest_start;
             sch->end_time = earliest_end;
@@ -318,7 +505,7 @@ ble_ll_sched_master_new(struct ble_ll_conn_sm *connsm, uint32_t adv_rxend,
             if ((int32_t)(sch->end_time - entry->start_time) < 0) {
                 if ((earliest_start - initial_start) <= itvl_t) {
                     rc = 0;
-                    TAILQ_INSERT_BEFORE(entry, sch, link);
+                    ble_ll_sched_q_insert_before(entry, sch);
                 }
                 break;
             }
@@ -334,7 +521,7 @@ ble_ll_sched_master_new(struct ble_ll_conn_sm *connsm, uint32_t adv_rxend,
         if (!entry) {
             if ((earliest_start - initial_start) <= itvl_t) {
                 rc = 0;
-                TAILQ_INSERT_TAIL(&g_ble_ll_sched_q, sch, link);
+                ble_ll_sched_q_insert_tail(sch);
             }
         }
 
@@ -398,12 +585,20 @@ ble_ll_sched_slave_new(struct ble_ll_conn_sm *connsm)
         rc = 0;
     } else {
         os_cputime_timer_stop(&g_ble_ll_sched_timer);
+        entry = ble_ll_sched_q_find_end_gt(sch->start_time);
         while (1) {
+            /* Insert at tail if none left to check */
+            if (!entry) {
+                rc = 0;
+                ble_ll_sched_q_insert_tail(sch);
+                break;
+            }
+
             next_sch = entry->link.tqe_next;
             /* Insert if event ends before next starts */
             if ((int32_t)(sch->end_time - entry->start_time) < 0) {
                 rc = 0;
-                TAILQ_INSERT_BEFORE(entry, sch, link);
+                ble_ll_sched_q_insert_before(entry, sch);
                 break;
             }
 
@@ -416,13 +611,6 @@ ble_ll_sched_slave_new(struct ble_ll_conn_sm *connsm)
 
             /* Move to next entry */
             entry = next_sch;
-
-            /* Insert at tail if none left to check */
-            if (!entry) {
-                rc = 0;
-                TAILQ_INSERT_TAIL(&g_ble_ll_sched_q, sch, link);
-                break;
-            }
         }
 
         if (!rc) {
@@ -447,11 +635,15 @@ ble_ll_sched_adv_new(struct ble_ll_sched_item *sch)
     uint32_t ce_end_time;
     uint32_t adv_start;
     uint32_t duration;
+    void *cb_arg;
     struct ble_ll_sched_item *entry;
 
     /* Get length of schedule item */
     duration = sch->end_time - sch->start_time;
 
+    /* The advertising state machine the item belongs to */
+    cb_arg = sch->cb_arg;
+
     OS_ENTER_CRITICAL(sr);
 
     /*
@@ -474,11 +666,12 @@ ble_ll_sched_adv_new(struct ble_ll_sched_item *sch)
         adv_start = sch->start_time;
     } else {
         os_cputime_timer_stop(&g_ble_ll_sched_timer);
-        TAILQ_FOREACH(entry, &g_ble_ll_sched_q, link) {
+        for (entry = ble_ll_sched_q_find_end_gt(sch->start_time); entry;
+             entry = TAILQ_NEXT(entry, link)) {
             /* We can insert if before entry in list */
             if ((int32_t)(sch->end_time - entry->start_time) < 0) {
                 rc = 0;
-                TAILQ_INSERT_BEFORE(entry, sch, link);
+                ble_ll_sched_q_insert_before(entry, sch);
                 break;
             }
 
@@ -492,7 +685,7 @@ ble_ll_sched_adv_new(struct ble_ll_sched_item *sch)
 
         if (!entry) {
             rc = 0;
-            TAILQ_INSERT_TAIL(&g_ble_ll_sched_q, sch, link);
+            ble_ll_sched_q_insert_tail(sch);
         }
         adv_start = sch->start_time;
 
@@ -504,7 +697,7 @@ ble_ll_sched_adv_new(struct ble_ll_sched_item *sch)
         sch = TAILQ_FIRST(&g_ble_ll_sched_q);
     }
 
-    ble_ll_adv_scheduled(adv_start);
+    ble_ll_adv_scheduled(cb_arg, adv_start);
 
     OS_EXIT_CRITICAL(sr);
 
@@ -539,12 +732,20 @@ ble_ll_sched_adv_reschedule(struct ble_ll_sched_item *sch)
     entry = ble_ll_sched_insert_if_empty(sch);
     if (entry) {
         os_cputime_timer_stop(&g_ble_ll_sched_timer);
+        entry = ble_ll_sched_q_find_end_gt(sch->start_time);
         while (1) {
+            /* Insert at tail if none left to check */
+            if (!entry) {
+                rc = 0;
+                ble_ll_sched_q_insert_tail(sch);
+                break;
+            }
+
             /* Insert before if adv event is before this event */
             next_sch = entry->link.tqe_next;
             if ((int32_t)(sch->end_time - entry->start_time) < 0) {
                 rc = 0;
-                TAILQ_INSERT_BEFORE(entry, sch, link);
+                ble_ll_sched_q_insert_before(entry, sch);
                 break;
             }
 
@@ -556,13 +757,6 @@ ble_ll_sched_adv_reschedule(struct ble_ll_sched_item *sch)
 
             /* Move to next entry */
             entry = next_sch;
-
-            /* Insert at tail if none left to check */
-            if (!entry) {
-                rc = 0;
-                TAILQ_INSERT_TAIL(&g_ble_ll_sched_q, sch, link);
-                break;
-            }
         }
 
         if (!rc) {
@@ -603,7 +797,7 @@ ble_ll_sched_rmv_elem(struct ble_ll_sched_item *sch)
             os_cputime_timer_stop(&g_ble_ll_sched_timer);
         }
 
-        TAILQ_REMOVE(&g_ble_ll_sched_q, sch, link);
+        ble_ll_sched_q_remove(sch);
         sch->enqueued = 0;
 
         if (first == sch) {
@@ -682,8 +876,10 @@ ble_ll_sched_run(void *arg)
             }
 #endif
             /* Remove schedule item and execute the callback */
-            TAILQ_REMOVE(&g_ble_ll_sched_q, sch, link);
+            ble_ll_sched_q_remove(sch);
             sch->enqueued = 0;
+            STATS_INCN(ble_ll_stats, sched_airtime_ticks,
+                       sch->end_time - sch->start_time);
             ble_ll_sched_execute_item(sch);
         } else {
             os_cputime_timer_start(&g_ble_ll_sched_timer, sch->start_time);
@@ -741,6 +937,10 @@ ble_ll_sched_stop(void)
 int
 ble_ll_sched_init(void)
 {
+#if MYNEWT_VAL(BLE_LL_SCHED_SKIPLIST)
+    memset(g_ble_ll_sched_sl_head, 0, sizeof(g_ble_ll_sched_sl_head));
+#endif
+
     /* Initialize cputimer for the scheduler */
     os_cputime_timer_init(&g_ble_ll_sched_timer, ble_ll_sched_run, NULL);
     return 0;
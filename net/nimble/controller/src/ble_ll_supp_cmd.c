@@ -134,9 +134,15 @@
 #define BLE_SUPP_CMD_LE_LTK_REQ_REPLY       (0 << 1)
 #define BLE_SUPP_CMD_LE_LTK_REQ_NEG_REPLY   (0 << 2)
 #define BLE_SUPP_CMD_LE_READ_SUPP_STATES    (1 << 3)
+#if (MYNEWT_VAL(BLE_LL_DTM) == 1)
+#define BLE_SUPP_CMD_LE_RX_TEST             (1 << 4)
+#define BLE_SUPP_CMD_LE_TX_TEST             (1 << 5)
+#define BLE_SUPP_CMD_LE_TEST_END            (1 << 6)
+#else
 #define BLE_SUPP_CMD_LE_RX_TEST             (0 << 4)
 #define BLE_SUPP_CMD_LE_TX_TEST             (0 << 5)
 #define BLE_SUPP_CMD_LE_TEST_END            (0 << 6)
+#endif
 
 #define BLE_LL_SUPP_CMD_OCTET_28            \
 (                                           \
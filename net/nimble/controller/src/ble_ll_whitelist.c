@@ -24,8 +24,10 @@
 #include "nimble/ble.h"
 #include "nimble/nimble_opt.h"
 #include "ble/xcvr.h"
+#include "nimble/hci_common.h"
 #include "controller/ble_ll_whitelist.h"
 #include "controller/ble_ll_hci.h"
+#include "controller/ble_ll_hci_vendor.h"
 #include "controller/ble_ll_adv.h"
 #include "controller/ble_ll_scan.h"
 #include "controller/ble_hw.h"
@@ -246,6 +248,83 @@ ble_ll_whitelist_rmv(uint8_t *addr, uint8_t addr_type)
     return BLE_ERR_SUCCESS;
 }
 
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+/**
+ * Vendor-specific bulk whitelist set command.
+ *
+ * Atomically replaces the entire whitelist with the entries carried in a
+ * single HCI command: a one byte entry count followed by count instances of
+ * (address type, 6 byte address). This avoids the clear plus one-add-per-entry
+ * command exchange when reloading the filter set for many bonded devices.
+ *
+ * @return int BLE error code
+ */
+static int
+ble_ll_whitelist_bulk_set(uint8_t *cmdbuf, uint8_t len, uint8_t *rspbuf,
+                          uint8_t *rsplen)
+{
+    int i;
+    int rc;
+    uint8_t nentries;
+    uint8_t *entry;
+
+    /* Validate length and each entry before we touch the list */
+    if (len < 1) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+    nentries = cmdbuf[0];
+    if ((nentries > BLE_LL_WHITELIST_SIZE) ||
+        (len != (1 + (nentries * BLE_HCI_WL_BULK_SET_ENT_LEN)))) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    entry = cmdbuf + 1;
+    for (i = 0; i < nentries; ++i) {
+        if (entry[0] > BLE_ADDR_TYPE_RANDOM) {
+            return BLE_ERR_INV_HCI_CMD_PARMS;
+        }
+        entry += BLE_HCI_WL_BULK_SET_ENT_LEN;
+    }
+
+    rc = ble_ll_whitelist_clear();
+    if (rc != BLE_ERR_SUCCESS) {
+        return rc;
+    }
+
+    entry = cmdbuf + 1;
+    for (i = 0; i < nentries; ++i) {
+        rc = ble_ll_whitelist_add(entry + 1, entry[0]);
+        if (rc != BLE_ERR_SUCCESS) {
+            return rc;
+        }
+        entry += BLE_HCI_WL_BULK_SET_ENT_LEN;
+    }
+
+    /* Return the number of entries programmed */
+    rspbuf[0] = nentries;
+    *rsplen = 1;
+    return BLE_ERR_SUCCESS;
+}
+#endif
+
+/**
+ * Register the whitelist vendor-specific HCI commands.
+ *
+ * Called once at link layer initialization, after the vendor command table
+ * has been initialized.
+ */
+void
+ble_ll_whitelist_hci_vendor_init(void)
+{
+#if (MYNEWT_VAL(BLE_LL_VENDOR_HCI) == 1)
+    int rc;
+
+    rc = ble_ll_hci_vendor_cmd_register(BLE_HCI_OCF_VENDOR_WL_BULK_SET,
+                                        ble_ll_whitelist_bulk_set);
+    assert(rc == 0);
+#endif
+}
+
 /**
  * Enable whitelisting.
  *
@@ -541,6 +541,7 @@ int ble_gap_adv_start(uint8_t own_addr_type, uint8_t peer_addr_type,
 int ble_gap_adv_stop(void);
 int ble_gap_adv_active(void);
 int ble_gap_adv_set_fields(const struct ble_hs_adv_fields *adv_fields);
+int ble_gap_adv_update_data(const uint8_t *data, uint8_t data_len);
 int ble_gap_adv_rsp_set_fields(const struct ble_hs_adv_fields *rsp_fields);
 int ble_gap_disc(uint8_t own_addr_type, int32_t duration_ms,
                  const struct ble_gap_disc_params *disc_params,
@@ -27,6 +27,7 @@ extern "C" {
 
 struct ble_l2cap_sig_update_req;
 struct ble_hs_conn;
+struct os_mbuf;
 
 #define BLE_L2CAP_SIG_OP_REJECT                 0x01
 #define BLE_L2CAP_SIG_OP_CONNECT_REQ            0x02
@@ -56,6 +57,8 @@ struct ble_hs_conn;
 #define BLE_L2CAP_SIG_ERR_MTU_EXCEEDED          0x0001
 #define BLE_L2CAP_SIG_ERR_INVALID_CID           0x0002
 
+#define BLE_L2CAP_COC_CID_START                 0x0040
+
 typedef void ble_l2cap_sig_update_fn(uint16_t conn_handle, int status,
                                      void *arg);
 
@@ -70,6 +73,133 @@ int ble_l2cap_sig_update(uint16_t conn_handle,
                          struct ble_l2cap_sig_update_params *params,
                          ble_l2cap_sig_update_fn *cb, void *cb_arg);
 
+struct ble_l2cap_chan;
+
+/** A connect procedure (our initiative) has completed. */
+#define BLE_L2CAP_EVENT_COC_CONNECTED           0
+
+/** A connection-oriented channel has been closed. */
+#define BLE_L2CAP_EVENT_COC_DISCONNECTED        1
+
+/** A peer wants to open a channel to one of our registered servers. */
+#define BLE_L2CAP_EVENT_COC_ACCEPT              2
+
+/** A complete SDU has been received on a connection-oriented channel. */
+#define BLE_L2CAP_EVENT_COC_DATA_RECEIVED       3
+
+/** An SDU submitted via ble_l2cap_send() has been fully transmitted. */
+#define BLE_L2CAP_EVENT_COC_TX_COMPLETE         4
+
+/**
+ * Represents an L2CAP connection-oriented channel event.  This is passed to
+ * the callback the application supplied when it created the server or
+ * initiated the connection.
+ */
+struct ble_l2cap_event {
+    /**
+     * Indicates the type of L2CAP event that occurred.  This is one of the
+     * BLE_L2CAP_EVENT codes.
+     */
+    uint8_t type;
+
+    union {
+        /**
+         * Represents a completed connect procedure.  Valid for the following
+         * event types:
+         *     o BLE_L2CAP_EVENT_COC_CONNECTED
+         */
+        struct {
+            /**
+             * The status of the connect procedure; 0 on success, BLE host
+             * error code on failure.
+             */
+            int status;
+
+            /** The handle of the relevant connection. */
+            uint16_t conn_handle;
+
+            /**
+             * The connected channel; null if the underlying connection was
+             * terminated before the procedure completed.
+             */
+            struct ble_l2cap_chan *chan;
+        } connect;
+
+        /**
+         * Represents a terminated channel.  The channel pointer is no longer
+         * valid after the callback returns.  Valid for the following event
+         * types:
+         *     o BLE_L2CAP_EVENT_COC_DISCONNECTED
+         */
+        struct {
+            /** The handle of the relevant connection. */
+            uint16_t conn_handle;
+
+            /** The channel that was closed. */
+            struct ble_l2cap_chan *chan;
+        } disconnect;
+
+        /**
+         * Represents a peer's request to open a channel to one of our
+         * servers.  Return 0 from the callback to accept the channel;
+         * nonzero to reject it.  Valid for the following event types:
+         *     o BLE_L2CAP_EVENT_COC_ACCEPT
+         */
+        struct {
+            /** The handle of the relevant connection. */
+            uint16_t conn_handle;
+
+            /** The maximum SDU size the peer can receive. */
+            uint16_t peer_sdu_size;
+
+            /** The channel awaiting acceptance. */
+            struct ble_l2cap_chan *chan;
+        } accept;
+
+        /**
+         * Represents a received SDU.  The application takes ownership of the
+         * sdu_rx mbuf and must free it when it is done with the data.  Valid
+         * for the following event types:
+         *     o BLE_L2CAP_EVENT_COC_DATA_RECEIVED
+         */
+        struct {
+            /** The handle of the relevant connection. */
+            uint16_t conn_handle;
+
+            /** The channel the SDU was received on. */
+            struct ble_l2cap_chan *chan;
+
+            /** The reassembled SDU; ownership passes to the application. */
+            struct os_mbuf *sdu_rx;
+        } receive;
+
+        /**
+         * Represents completed transmission of an SDU.  Valid for the
+         * following event types:
+         *     o BLE_L2CAP_EVENT_COC_TX_COMPLETE
+         */
+        struct {
+            /** The status of the transmission; 0 on success. */
+            int status;
+
+            /** The handle of the relevant connection. */
+            uint16_t conn_handle;
+
+            /** The channel the SDU was sent on. */
+            struct ble_l2cap_chan *chan;
+        } tx_complete;
+    };
+};
+
+typedef int ble_l2cap_event_fn(struct ble_l2cap_event *event, void *arg);
+
+int ble_l2cap_create_server(uint16_t psm, uint16_t mtu,
+                            ble_l2cap_event_fn *cb, void *cb_arg);
+int ble_l2cap_connect(uint16_t conn_handle, uint16_t psm, uint16_t mtu,
+                      ble_l2cap_event_fn *cb, void *cb_arg);
+int ble_l2cap_disconnect(struct ble_l2cap_chan *chan);
+int ble_l2cap_send(struct ble_l2cap_chan *chan, struct os_mbuf *sdu_tx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -95,8 +95,42 @@ struct ble_sm_io {
     };
 };
 
+/**
+ * Driver for offloading the security manager's P-256 operations to hardware.
+ * An MCU with an ECC accelerator registers one of these via
+ * ble_sm_ecc_driver_set(); the security manager then uses the driver instead
+ * of the software implementation for secure connections pairing.
+ */
+struct ble_sm_ecc_driver {
+    /**
+     * Generates a P-256 key pair.
+     *
+     * @param pub               Receives the 64-byte public key (X || Y,
+     *                              little endian).
+     * @param priv              Receives the 32-byte private key.
+     *
+     * @return                  0 on success; nonzero on failure.
+     */
+    int (*gen_key_pair)(void *pub, uint32_t *priv);
+
+    /**
+     * Computes a Diffie-Hellman shared secret.
+     *
+     * @param peer_pub_key_x    The peer's 32-byte public key X coordinate.
+     * @param peer_pub_key_y    The peer's 32-byte public key Y coordinate.
+     * @param our_priv_key      Our 32-byte private key.
+     * @param out_dhkey         Receives the 32-byte shared secret.
+     *
+     * @return                  0 on success; nonzero on failure (e.g., the
+     *                              peer's public key is invalid).
+     */
+    int (*gen_dhkey)(uint8_t *peer_pub_key_x, uint8_t *peer_pub_key_y,
+                     uint32_t *our_priv_key, void *out_dhkey);
+};
+
 #if NIMBLE_BLE_SM
 int ble_sm_inject_io(uint16_t conn_handle, struct ble_sm_io *pkey);
+void ble_sm_ecc_driver_set(const struct ble_sm_ecc_driver *drv);
 #else
 #define ble_sm_inject_io(conn_handle, pkey) \
     ((void)(conn_handle), BLE_HS_ENOTSUP)
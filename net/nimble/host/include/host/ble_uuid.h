@@ -29,6 +29,7 @@ struct os_mbuf;
 
 uint16_t ble_uuid_128_to_16(const void *uuid128);
 int ble_uuid_16_to_128(uint16_t uuid16, void *dst);
+int ble_uuid_128_eq(const void *uuid128_a, const void *uuid128_b);
 
 #define BLE_UUID16_ARR(uuid16) {                                            \
     0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,                         \
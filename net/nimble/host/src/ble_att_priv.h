@@ -21,6 +21,7 @@
 #define H_BLE_ATT_PRIV_
 
 #include <inttypes.h>
+#include "syscfg/syscfg.h"
 #include "stats/stats.h"
 #include "os/queue.h"
 #include "host/ble_att.h"
@@ -111,6 +112,8 @@ struct ble_att_prep_entry {
 
     /* XXX: This is wasteful; we should use one mbuf chain for the entire
      * prepared write, and compress the data into as few mbufs as possible.
+     * Enabling BLE_ATT_SVR_PREP_WRITE_COALESCE does this for contiguous
+     * fragments.
      */
     struct os_mbuf *bape_value;
 };
@@ -146,6 +149,9 @@ int ble_att_svr_register_uuid16(uint16_t uuid16, uint8_t flags,
                                 uint16_t *handle_id, ble_att_svr_access_fn *cb,
                                 void *cb_arg);
 
+/** Indicates an attribute UUID that is absent from the dedup table. */
+#define BLE_ATT_SVR_UUID_IDX_NONE   0xffff
+
 struct ble_att_svr_entry {
     STAILQ_ENTRY(ble_att_svr_entry) ha_next;
 
@@ -153,10 +159,48 @@ struct ble_att_svr_entry {
     uint8_t ha_flags;
     uint8_t ha_pad1;
     uint16_t ha_handle_id;
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+    /** Index of ha_uuid in the dedup table; assigned at registration. */
+    uint16_t ha_uuid_idx;
+#endif
     ble_att_svr_access_fn *ha_cb;
     void *ha_cb_arg;
 };
 
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+/**
+ * Builds one attribute of a static attribute table (see
+ * ble_att_svr_static_db_set()).  Entries must be declared in handle
+ * order, with handles starting at 1 and increasing by one per entry;
+ * the trailing arguments are the sixteen bytes of the attribute's
+ * 128-bit UUID, least significant first.
+ */
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+#define BLE_ATT_SVR_STATIC_ENTRY(handle_, flags_, cb_, cb_arg_, ...) {  \
+    .ha_uuid = { __VA_ARGS__ },                                         \
+    .ha_flags = (flags_),                                               \
+    .ha_handle_id = (handle_),                                          \
+    .ha_uuid_idx = BLE_ATT_SVR_UUID_IDX_NONE,                           \
+    .ha_cb = (cb_),                                                     \
+    .ha_cb_arg = (cb_arg_),                                             \
+}
+#else
+#define BLE_ATT_SVR_STATIC_ENTRY(handle_, flags_, cb_, cb_arg_, ...) {  \
+    .ha_uuid = { __VA_ARGS__ },                                         \
+    .ha_flags = (flags_),                                               \
+    .ha_handle_id = (handle_),                                          \
+    .ha_cb = (cb_),                                                     \
+    .ha_cb_arg = (cb_arg_),                                             \
+}
+#endif
+
+int ble_att_svr_static_db_set(const struct ble_att_svr_entry *db,
+                              uint16_t count);
+#endif
+
+struct ble_att_svr_entry *
+ble_att_svr_entry_next(struct ble_att_svr_entry *entry);
+
 SLIST_HEAD(ble_att_clt_entry_list, ble_att_clt_entry);
 
 /*** @gen */
@@ -179,6 +223,7 @@ int ble_att_init(void);
 /*** @svr */
 
 int ble_att_svr_start(void);
+int ble_att_svr_build_index(void);
 
 struct ble_att_svr_entry *
 ble_att_svr_find_by_uuid(struct ble_att_svr_entry *start_at,
@@ -40,6 +40,80 @@ static os_membuf_t ble_att_svr_prep_entry_mem[
 
 static struct os_mempool ble_att_svr_prep_entry_pool;
 
+#if MYNEWT_VAL(BLE_ATT_SVR_HANDLE_INDEX)
+/* Maps (handle - 1) to the corresponding registered attribute; rebuilt by
+ * ble_att_svr_build_index() when service registration completes.
+ */
+static struct ble_att_svr_entry **ble_att_svr_index;
+static uint16_t ble_att_svr_index_count;
+#endif
+
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+/* Application-provided flash-resident attribute table covering handles
+ * 1 .. ble_att_svr_static_db_count; dynamically registered attributes
+ * continue after it.  The server never writes to attribute entries
+ * after registration, so the const table can be served through the
+ * same struct pointer as pool-allocated entries.
+ */
+static const struct ble_att_svr_entry *ble_att_svr_static_db;
+static uint16_t ble_att_svr_static_db_count;
+#endif
+
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+/* Dedup table of the distinct 128-bit UUIDs used by registered attributes.
+ * Attribute entries carry a 16-bit index into this table, so UUID matching
+ * during discovery reduces to an index compare in the common case.
+ */
+static uint8_t ble_att_svr_uuid_tbl[MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)][16];
+static uint16_t ble_att_svr_uuid_cnt;
+
+/**
+ * Resolves a 128-bit UUID to its index in the dedup table.
+ *
+ * @param uuid                  The UUID to resolve.
+ * @param add                   Whether to add the UUID to the table if it is
+ *                                  not already present.
+ *
+ * @return                      The UUID's table index on success;
+ *                              BLE_ATT_SVR_UUID_IDX_NONE if the UUID is not
+ *                                  in the table (and could not be added).
+ */
+static uint16_t
+ble_att_svr_uuid_intern(const uint8_t *uuid, int add)
+{
+    uint16_t i;
+
+    for (i = 0; i < ble_att_svr_uuid_cnt; i++) {
+        if (ble_uuid_128_eq(ble_att_svr_uuid_tbl[i], uuid)) {
+            return i;
+        }
+    }
+
+    if (!add || ble_att_svr_uuid_cnt >= MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)) {
+        return BLE_ATT_SVR_UUID_IDX_NONE;
+    }
+
+    memcpy(ble_att_svr_uuid_tbl[ble_att_svr_uuid_cnt], uuid, 16);
+    return ble_att_svr_uuid_cnt++;
+}
+
+/**
+ * Indicates whether the specified attribute has the specified UUID.  The
+ * caller resolves the UUID to its interned index once, up front; each
+ * attribute is then matched on the index alone.  Attributes that overflowed
+ * the dedup table at registration time fall back to a full compare.
+ */
+static int
+ble_att_svr_entry_uuid_eq(const struct ble_att_svr_entry *entry,
+                          const uint8_t *uuid, uint16_t uuid_idx)
+{
+    if (entry->ha_uuid_idx != BLE_ATT_SVR_UUID_IDX_NONE) {
+        return entry->ha_uuid_idx == uuid_idx;
+    }
+    return ble_uuid_128_eq(entry->ha_uuid, uuid);
+}
+#endif
+
 static struct ble_att_svr_entry *
 ble_att_svr_entry_alloc(void)
 {
@@ -89,6 +163,9 @@ ble_att_svr_register(const uint8_t *uuid, uint8_t flags, uint16_t *handle_id,
     }
 
     memcpy(&entry->ha_uuid, uuid, sizeof entry->ha_uuid);
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+    entry->ha_uuid_idx = ble_att_svr_uuid_intern(entry->ha_uuid, 1);
+#endif
     entry->ha_flags = flags;
     entry->ha_handle_id = ble_att_svr_next_id();
     entry->ha_cb = cb;
@@ -103,6 +180,46 @@ ble_att_svr_register(const uint8_t *uuid, uint8_t flags, uint16_t *handle_id,
     return 0;
 }
 
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+/**
+ * Installs a static attribute table, typically a const array built with
+ * BLE_ATT_SVR_STATIC_ENTRY() and placed in flash.  The table's
+ * attributes answer to handles 1 through 'count' without any
+ * registration-time RAM or processing; attributes registered afterwards
+ * (e.g. by ble_gatts) are assigned handles following the table.  Must
+ * be called before any dynamic registration.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EALREADY if attributes have
+ *                                  already been registered;
+ *                              BLE_HS_EINVAL if the table's handles are
+ *                                  not sequential from 1.
+ */
+int
+ble_att_svr_static_db_set(const struct ble_att_svr_entry *db, uint16_t count)
+{
+    uint16_t i;
+
+    if (ble_att_svr_id != 0 || !STAILQ_EMPTY(&ble_att_svr_list)) {
+        return BLE_HS_EALREADY;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (db[i].ha_handle_id != i + 1) {
+            return BLE_HS_EINVAL;
+        }
+    }
+
+    ble_att_svr_static_db = db;
+    ble_att_svr_static_db_count = count;
+
+    /* Dynamic registrations continue after the static handles. */
+    ble_att_svr_id = count;
+
+    return 0;
+}
+#endif
+
 int
 ble_att_svr_register_uuid16(uint16_t uuid16, uint8_t flags,
                             uint16_t *handle_id, ble_att_svr_access_fn *cb,
@@ -130,6 +247,42 @@ ble_att_svr_prev_handle(void)
     return ble_att_svr_id;
 }
 
+/**
+ * Retrieves the attribute with the lowest handle.
+ */
+static struct ble_att_svr_entry *
+ble_att_svr_entry_first(void)
+{
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+    if (ble_att_svr_static_db_count > 0) {
+        return (struct ble_att_svr_entry *)&ble_att_svr_static_db[0];
+    }
+#endif
+    return STAILQ_FIRST(&ble_att_svr_list);
+}
+
+/**
+ * Retrieves the attribute following 'entry' in handle order, crossing
+ * from the static attribute table into the dynamically registered list
+ * when the table runs out.
+ */
+struct ble_att_svr_entry *
+ble_att_svr_entry_next(struct ble_att_svr_entry *entry)
+{
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+    const struct ble_att_svr_entry *db;
+
+    db = ble_att_svr_static_db;
+    if (db != NULL && entry >= db && entry < db + ble_att_svr_static_db_count) {
+        if (entry + 1 < db + ble_att_svr_static_db_count) {
+            return (struct ble_att_svr_entry *)(entry + 1);
+        }
+        return STAILQ_FIRST(&ble_att_svr_list);
+    }
+#endif
+    return STAILQ_NEXT(entry, ha_next);
+}
+
 /**
  * Find a host attribute by handle id.
  *
@@ -149,6 +302,23 @@ ble_att_svr_find_by_handle(uint16_t handle_id)
 {
     struct ble_att_svr_entry *entry;
 
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+    if (handle_id >= 1 && handle_id <= ble_att_svr_static_db_count) {
+        return (struct ble_att_svr_entry *)
+               &ble_att_svr_static_db[handle_id - 1];
+    }
+#endif
+
+#if MYNEWT_VAL(BLE_ATT_SVR_HANDLE_INDEX)
+    /* Handles are assigned sequentially at registration time, so an indexed
+     * attribute lives at position (handle - 1).  Attributes registered after
+     * the index was built are found by the list walk below.
+     */
+    if (handle_id >= 1 && handle_id <= ble_att_svr_index_count) {
+        return ble_att_svr_index[handle_id - 1];
+    }
+#endif
+
     for (entry = STAILQ_FIRST(&ble_att_svr_list);
          entry != NULL;
          entry = STAILQ_NEXT(entry, ha_next)) {
@@ -180,18 +350,27 @@ ble_att_svr_find_by_uuid(struct ble_att_svr_entry *prev, const uint8_t *uuid,
                          uint16_t end_handle)
 {
     struct ble_att_svr_entry *entry;
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+    uint16_t uuid_idx;
+
+    uuid_idx = ble_att_svr_uuid_intern(uuid, 0);
+#endif
 
     if (prev == NULL) {
-        entry = STAILQ_FIRST(&ble_att_svr_list);
+        entry = ble_att_svr_entry_first();
     } else {
-        entry = STAILQ_NEXT(prev, ha_next);
+        entry = ble_att_svr_entry_next(prev);
     }
 
     for (;
          entry != NULL && entry->ha_handle_id <= end_handle;
-         entry = STAILQ_NEXT(entry, ha_next)) {
+         entry = ble_att_svr_entry_next(entry)) {
 
-        if (memcmp(entry->ha_uuid, uuid, sizeof entry->ha_uuid) == 0) {
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+        if (ble_att_svr_entry_uuid_eq(entry, uuid, uuid_idx)) {
+#else
+        if (ble_uuid_128_eq(entry->ha_uuid, uuid)) {
+#endif
             return entry;
         }
     }
@@ -199,6 +378,31 @@ ble_att_svr_find_by_uuid(struct ble_att_svr_entry *prev, const uint8_t *uuid,
     return NULL;
 }
 
+/**
+ * Retrieves the entry at which an iteration over the specified handle range
+ * should begin.  When the handle index is enabled, iteration starts at the
+ * first attribute in the range rather than at the front of the list.
+ */
+static struct ble_att_svr_entry *
+ble_att_svr_iter_start(uint16_t start_handle)
+{
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+    if (start_handle >= 1 && start_handle <= ble_att_svr_static_db_count) {
+        return (struct ble_att_svr_entry *)
+               &ble_att_svr_static_db[start_handle - 1];
+    }
+#endif
+#if MYNEWT_VAL(BLE_ATT_SVR_HANDLE_INDEX)
+    if (start_handle >= 1 && start_handle <= ble_att_svr_index_count) {
+        return ble_att_svr_index[start_handle - 1];
+    }
+#endif
+    /* All handles in the static table (if any) precede start_handle at
+     * this point, so iteration begins at the dynamic list.
+     */
+    return STAILQ_FIRST(&ble_att_svr_list);
+}
+
 static int
 ble_att_svr_pullup_req_base(struct os_mbuf **om, int base_len,
                             uint8_t *out_att_err)
@@ -750,7 +954,10 @@ ble_att_svr_fill_info(struct ble_att_find_info_req *req, struct os_mbuf *om,
     num_entries = 0;
     rc = 0;
 
-    STAILQ_FOREACH(ha, &ble_att_svr_list, ha_next) {
+    for (ha = ble_att_svr_iter_start(req->bafq_start_handle);
+         ha != NULL;
+         ha = ble_att_svr_entry_next(ha)) {
+
         if (ha->ha_handle_id > req->bafq_end_handle) {
             rc = 0;
             goto done;
@@ -1078,7 +1285,10 @@ ble_att_svr_fill_type_value(uint16_t conn_handle,
      * matching group.  For each attribute entry, determine if data needs to be
      * written to the response.
      */
-    STAILQ_FOREACH(ha, &ble_att_svr_list, ha_next) {
+    for (ha = ble_att_svr_iter_start(req->bavq_start_handle);
+         ha != NULL;
+         ha = ble_att_svr_entry_next(ha)) {
+
         match = 0;
 
         if (ha->ha_handle_id > req->bavq_end_handle) {
@@ -1287,6 +1497,16 @@ ble_att_svr_build_read_type_rsp(uint16_t conn_handle,
 
     /* Find all matching attributes, writing a record for each. */
     entry = NULL;
+#if MYNEWT_VAL(BLE_ATT_SVR_HANDLE_INDEX)
+    /* Seed the walk with the attribute preceding the requested range;
+     * ble_att_svr_find_by_uuid() starts at the entry following its argument.
+     */
+    if (req->batq_start_handle > 1 &&
+        req->batq_start_handle - 1 <= ble_att_svr_index_count) {
+
+        entry = ble_att_svr_index[req->batq_start_handle - 2];
+    }
+#endif
     while (1) {
         entry = ble_att_svr_find_by_uuid(entry, uuid128, req->batq_end_handle);
         if (entry == NULL) {
@@ -1764,6 +1984,9 @@ ble_att_svr_build_read_group_type_rsp(uint16_t conn_handle,
     uint16_t mtu;
     uint8_t service_uuid128[16];
     void *rsp_buf;
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+    uint16_t group_uuid_idx;
+#endif
     int rc;
 
     /* Silence warnings. */
@@ -1771,6 +1994,10 @@ ble_att_svr_build_read_group_type_rsp(uint16_t conn_handle,
     service_uuid16 = 0;
     end_group_handle = 0;
 
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+    group_uuid_idx = ble_att_svr_uuid_intern(group_uuid128, 0);
+#endif
+
     *att_err = 0;
     *err_handle = req->bagq_start_handle;
 
@@ -1791,7 +2018,10 @@ ble_att_svr_build_read_group_type_rsp(uint16_t conn_handle,
 
     start_group_handle = 0;
     rsp.bagp_length = 0;
-    STAILQ_FOREACH(entry, &ble_att_svr_list, ha_next) {
+    for (entry = ble_att_svr_iter_start(req->bagq_start_handle);
+         entry != NULL;
+         entry = ble_att_svr_entry_next(entry)) {
+
         if (entry->ha_handle_id < req->bagq_start_handle) {
             continue;
         }
@@ -1829,7 +2059,12 @@ ble_att_svr_build_read_group_type_rsp(uint16_t conn_handle,
 
         if (start_group_handle == 0) {
             /* We are looking for the start of a group. */
-            if (memcmp(entry->ha_uuid, group_uuid128, 16) == 0) {
+#if MYNEWT_VAL(BLE_ATT_SVR_UUID_INTERN)
+            if (ble_att_svr_entry_uuid_eq(entry, group_uuid128,
+                                          group_uuid_idx)) {
+#else
+            if (ble_uuid_128_eq(entry->ha_uuid, group_uuid128)) {
+#endif
                 /* Found a group start.  Read the group UUID. */
                 rc = ble_att_svr_service_uuid(entry, &service_uuid16,
                                               service_uuid128);
@@ -2340,6 +2575,35 @@ ble_att_svr_insert_prep_entry(uint16_t conn_handle,
 
     conn = ble_hs_conn_find_assert(conn_handle);
 
+    prep_prev = ble_att_svr_prep_find_prev(&conn->bhc_att_svr,
+                                           req->bapc_handle,
+                                           req->bapc_offset);
+
+#if MYNEWT_VAL(BLE_ATT_SVR_PREP_WRITE_COALESCE)
+    /* If this fragment continues the preceding entry for the same attribute,
+     * append it to that entry's mbuf chain rather than consuming a new entry.
+     * Long writes get packed into one chain per attribute, avoiding the
+     * per-fragment entry and chain allocations.
+     */
+    if (prep_prev != NULL &&
+        prep_prev->bape_handle == req->bapc_handle &&
+        prep_prev->bape_offset + OS_MBUF_PKTLEN(prep_prev->bape_value) ==
+            req->bapc_offset) {
+
+        rc = os_mbuf_appendfrom(
+            prep_prev->bape_value,
+            rxom,
+            BLE_ATT_PREP_WRITE_CMD_BASE_SZ,
+            OS_MBUF_PKTLEN(rxom) - BLE_ATT_PREP_WRITE_CMD_BASE_SZ);
+        if (rc != 0) {
+            *out_att_err = BLE_ATT_ERR_PREPARE_QUEUE_FULL;
+            return rc;
+        }
+
+        return 0;
+    }
+#endif
+
     prep_entry = ble_att_svr_prep_alloc();
     if (prep_entry == NULL) {
         *out_att_err = BLE_ATT_ERR_PREPARE_QUEUE_FULL;
@@ -2360,9 +2624,6 @@ ble_att_svr_insert_prep_entry(uint16_t conn_handle,
         return rc;
     }
 
-    prep_prev = ble_att_svr_prep_find_prev(&conn->bhc_att_svr,
-                                           req->bapc_handle,
-                                           req->bapc_offset);
     if (prep_prev == NULL) {
         SLIST_INSERT_HEAD(&conn->bhc_att_svr.basc_prep_list, prep_entry,
                           bape_next);
@@ -2688,6 +2949,62 @@ ble_att_svr_free_start_mem(void)
 {
     free(ble_att_svr_entry_mem);
     ble_att_svr_entry_mem = NULL;
+
+#if MYNEWT_VAL(BLE_ATT_SVR_HANDLE_INDEX)
+    free(ble_att_svr_index);
+    ble_att_svr_index = NULL;
+    ble_att_svr_index_count = 0;
+#endif
+}
+
+/**
+ * Builds the handle-to-attribute index used to accelerate handle lookups and
+ * range iteration.  Handles are assigned sequentially at registration time,
+ * so the attribute with handle h lives at position (h - 1).  Called when
+ * service registration completes; attributes registered afterwards are still
+ * found via the list walks.
+ *
+ * @return                      0 on success; BLE_HS_ENOMEM on allocation
+ *                                  failure.
+ */
+int
+ble_att_svr_build_index(void)
+{
+#if MYNEWT_VAL(BLE_ATT_SVR_HANDLE_INDEX)
+    struct ble_att_svr_entry *entry;
+    uint16_t i;
+
+    free(ble_att_svr_index);
+    ble_att_svr_index = NULL;
+    ble_att_svr_index_count = 0;
+
+    if (ble_att_svr_id == 0) {
+        return 0;
+    }
+
+    ble_att_svr_index = malloc(ble_att_svr_id * sizeof *ble_att_svr_index);
+    if (ble_att_svr_index == NULL) {
+        return BLE_HS_ENOMEM;
+    }
+
+    i = 0;
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+    for (; i < ble_att_svr_static_db_count; i++) {
+        ble_att_svr_index[i] =
+            (struct ble_att_svr_entry *)&ble_att_svr_static_db[i];
+    }
+#endif
+    STAILQ_FOREACH(entry, &ble_att_svr_list, ha_next) {
+        BLE_HS_DBG_ASSERT(entry->ha_handle_id == i + 1);
+        ble_att_svr_index[i] = entry;
+        i++;
+    }
+    BLE_HS_DBG_ASSERT(i == ble_att_svr_id);
+
+    ble_att_svr_index_count = i;
+#endif
+
+    return 0;
 }
 
 int
@@ -2742,5 +3059,10 @@ ble_att_svr_init(void)
 
     ble_att_svr_id = 0;
 
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+    ble_att_svr_static_db = NULL;
+    ble_att_svr_static_db_count = 0;
+#endif
+
     return 0;
 }
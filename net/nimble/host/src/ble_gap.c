@@ -187,6 +187,8 @@ STATS_NAME_START(ble_gap_stats)
     STATS_NAME(ble_gap_stats, adv_start_fail)
     STATS_NAME(ble_gap_stats, adv_set_fields)
     STATS_NAME(ble_gap_stats, adv_set_fields_fail)
+    STATS_NAME(ble_gap_stats, adv_update_data)
+    STATS_NAME(ble_gap_stats, adv_update_data_fail)
     STATS_NAME(ble_gap_stats, adv_rsp_set_fields)
     STATS_NAME(ble_gap_stats, adv_rsp_set_fields_fail)
     STATS_NAME(ble_gap_stats, discover)
@@ -199,6 +201,8 @@ STATS_NAME_START(ble_gap_stats)
     STATS_NAME(ble_gap_stats, cancel_fail)
     STATS_NAME(ble_gap_stats, update)
     STATS_NAME(ble_gap_stats, update_fail)
+    STATS_NAME(ble_gap_stats, autotune)
+    STATS_NAME(ble_gap_stats, autotune_fail)
     STATS_NAME(ble_gap_stats, connect_mst)
     STATS_NAME(ble_gap_stats, connect_slv)
     STATS_NAME(ble_gap_stats, disconnect)
@@ -832,6 +836,9 @@ ble_gap_conn_broken(uint16_t conn_handle, int reason)
      * get informed of spurious notify-tx events.
      */
     ble_l2cap_sig_conn_broken(conn_handle, reason);
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+    ble_l2cap_coc_conn_broken(conn_handle);
+#endif
     ble_sm_connection_broken(conn_handle);
     ble_gatts_connection_broken(conn_handle);
     ble_gattc_connection_broken(conn_handle);
@@ -1322,6 +1329,137 @@ ble_gap_slave_timer(void)
     return BLE_HS_FOREVER;
 }
 
+#if MYNEWT_VAL(BLE_GAP_AUTOTUNE)
+
+#define BLE_GAP_AT_PROFILE_NONE         0
+#define BLE_GAP_AT_PROFILE_ACTIVE       1
+#define BLE_GAP_AT_PROFILE_IDLE         2
+
+#define BLE_GAP_AUTOTUNE_PERIOD_TICKS   \
+    (MYNEWT_VAL(BLE_GAP_AUTOTUNE_ITVL_SECS) * OS_TICKS_PER_SEC)
+
+/* OS time at which the next autotune sample period ends (0 = not started) */
+static os_time_t ble_gap_autotune_exp_os_ticks;
+
+/**
+ * Connection parameter autotuner.
+ *
+ * Once per sample period each connection's data packet count, maintained by
+ * the ACL transmit and receive paths, is inspected.  A busy link is moved to
+ * the tight "active" parameter profile; a link that stays quiet for
+ * BLE_GAP_AUTOTUNE_IDLE_PERIODS consecutive periods drifts to the relaxed
+ * "idle" profile.  Updates are requested through the normal
+ * ble_gap_update_params path, so the application sees the usual connection
+ * update events; a failed request (e.g., an update already in progress) is
+ * retried in a later period.
+ *
+ * @return                      The number of ticks until this function should
+ *                                  be called again.
+ */
+static int32_t
+ble_gap_autotune_timer(void)
+{
+    struct ble_gap_upd_params params;
+    struct ble_hs_conn *conn;
+    os_time_t now;
+    uint16_t conn_handle;
+    uint16_t min_tmo;
+    uint8_t profile;
+    int32_t ticks;
+    int rc;
+    int i;
+
+    now = os_time_get();
+    if (ble_gap_autotune_exp_os_ticks == 0) {
+        ble_gap_autotune_exp_os_ticks = now + BLE_GAP_AUTOTUNE_PERIOD_TICKS;
+    }
+    ticks = (int32_t)(ble_gap_autotune_exp_os_ticks - now);
+    if (ticks > 0) {
+        return ticks;
+    }
+    ble_gap_autotune_exp_os_ticks = now + BLE_GAP_AUTOTUNE_PERIOD_TICKS;
+
+    for (i = 0; ; i++) {
+        ble_hs_lock();
+
+        conn = ble_hs_conn_find_by_idx(i);
+        if (conn == NULL) {
+            ble_hs_unlock();
+            break;
+        }
+
+        profile = BLE_GAP_AT_PROFILE_NONE;
+        if (conn->bhc_at_pkts >= MYNEWT_VAL(BLE_GAP_AUTOTUNE_ACTIVE_PKTS)) {
+            conn->bhc_at_quiet_periods = 0;
+            if (conn->bhc_at_profile != BLE_GAP_AT_PROFILE_ACTIVE) {
+                profile = BLE_GAP_AT_PROFILE_ACTIVE;
+            }
+        } else if (conn->bhc_at_pkts == 0) {
+            if (conn->bhc_at_quiet_periods <
+                MYNEWT_VAL(BLE_GAP_AUTOTUNE_IDLE_PERIODS)) {
+                conn->bhc_at_quiet_periods++;
+            } else if (conn->bhc_at_profile != BLE_GAP_AT_PROFILE_IDLE) {
+                profile = BLE_GAP_AT_PROFILE_IDLE;
+            }
+        } else {
+            /* Light traffic; neither profile is clearly better. */
+            conn->bhc_at_quiet_periods = 0;
+        }
+        conn->bhc_at_pkts = 0;
+
+        conn_handle = conn->bhc_handle;
+        memset(&params, 0, sizeof params);
+        params.supervision_timeout = conn->bhc_supervision_timeout;
+        params.min_ce_len = BLE_GAP_INITIAL_CONN_MIN_CE_LEN;
+        params.max_ce_len = BLE_GAP_INITIAL_CONN_MAX_CE_LEN;
+
+        ble_hs_unlock();
+
+        switch (profile) {
+        case BLE_GAP_AT_PROFILE_ACTIVE:
+            params.itvl_min = MYNEWT_VAL(BLE_GAP_AUTOTUNE_ACTIVE_ITVL_MIN);
+            params.itvl_max = MYNEWT_VAL(BLE_GAP_AUTOTUNE_ACTIVE_ITVL_MAX);
+            params.latency = 0;
+            break;
+
+        case BLE_GAP_AT_PROFILE_IDLE:
+            params.itvl_min = MYNEWT_VAL(BLE_GAP_AUTOTUNE_IDLE_ITVL_MIN);
+            params.itvl_max = MYNEWT_VAL(BLE_GAP_AUTOTUNE_IDLE_ITVL_MAX);
+            params.latency = MYNEWT_VAL(BLE_GAP_AUTOTUNE_IDLE_LATENCY);
+            break;
+
+        default:
+            continue;
+        }
+
+        /* The supervision timeout (10 msec units) must exceed
+         * (1 + latency) * itvl * 2 (itvl in 1.25 msec units); grow it if the
+         * new profile would violate that.
+         */
+        min_tmo = (((1 + params.latency) * params.itvl_max) + 3) / 4 + 1;
+        if (params.supervision_timeout < min_tmo) {
+            params.supervision_timeout = min_tmo;
+        }
+
+        rc = ble_gap_update_params(conn_handle, &params);
+        if (rc == 0) {
+            STATS_INC(ble_gap_stats, autotune);
+
+            ble_hs_lock();
+            conn = ble_hs_conn_find(conn_handle);
+            if (conn != NULL) {
+                conn->bhc_at_profile = profile;
+            }
+            ble_hs_unlock();
+        } else {
+            STATS_INC(ble_gap_stats, autotune_fail);
+        }
+    }
+
+    return BLE_GAP_AUTOTUNE_PERIOD_TICKS;
+}
+#endif
+
 static int32_t
 ble_gap_update_timer(void)
 {
@@ -1367,6 +1505,10 @@ ble_gap_timer(void)
     slave_ticks = ble_gap_slave_timer();
     update_ticks = ble_gap_update_timer();
 
+#if MYNEWT_VAL(BLE_GAP_AUTOTUNE)
+    update_ticks = min(update_ticks, ble_gap_autotune_timer());
+#endif
+
     return min(min(master_ticks, slave_ticks), update_ticks);
 }
 
@@ -1423,6 +1565,30 @@ ble_gap_wl_tx_clear(void)
     return 0;
 }
 
+#if MYNEWT_VAL(BLE_HS_WL_BULK)
+static int
+ble_gap_wl_tx_bulk_set(const struct ble_gap_white_entry *white_list,
+                       uint8_t white_list_count)
+{
+    uint8_t buf[BLE_HCI_CMD_HDR_LEN + 1 +
+                BLE_HCI_WL_BULK_SET_MAX_ENTS * BLE_HCI_WL_BULK_SET_ENT_LEN];
+    int rc;
+
+    rc = ble_hs_hci_cmd_build_wl_bulk_set(white_list, white_list_count,
+                                          buf, sizeof buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = ble_hs_hci_cmd_tx_empty_ack(buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+#endif
+
 /**
  * Overwrites the controller's white list with the specified contents.
  *
@@ -1469,6 +1635,19 @@ ble_gap_wl_set(const struct ble_gap_white_entry *white_list,
     ble_gap_log_wl(white_list, white_list_count);
     BLE_HS_LOG(INFO, "\n");
 
+#if MYNEWT_VAL(BLE_HS_WL_BULK)
+    /* Reprogram the whole list with a single vendor-specific command.  If
+     * the controller does not implement it, fall through to the standard
+     * clear plus one-add-per-entry exchange.
+     */
+    if (white_list_count <= BLE_HCI_WL_BULK_SET_MAX_ENTS) {
+        rc = ble_gap_wl_tx_bulk_set(white_list, white_list_count);
+        if (rc != BLE_HS_HCI_ERR(BLE_ERR_UNKNOWN_HCI_CMD)) {
+            goto done;
+        }
+    }
+#endif
+
     rc = ble_gap_wl_tx_clear();
     if (rc != 0) {
         goto done;
@@ -2008,6 +2187,76 @@ done:
     return rc;
 }
 
+/**
+ * Replaces the data included in subsequent advertisements.  Unlike
+ * ble_gap_adv_set_fields(), this may be called while advertising is
+ * active: the fully-formed payload is passed to the controller in a
+ * single set-advertising-data HCI command and the advertising
+ * procedure is not restarted, so high-rate payload updates (e.g.
+ * sensor readings carried in the advertisement) stay cheap.
+ *
+ * @param data                  The fully-formed advertisement payload
+ *                                  (sequence of AD structures).
+ * @param data_len              The number of bytes of payload.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EMSGSIZE if the specified data is too
+ *                                  large to fit in an advertisement;
+ *                              BLE_HS_EINVAL if directed advertising is in
+ *                                  progress (it carries no data);
+ *                              Other nonzero on failure.
+ */
+int
+ble_gap_adv_update_data(const uint8_t *data, uint8_t data_len)
+{
+#if !NIMBLE_BLE_ADVERTISE
+    return BLE_HS_ENOTSUP;
+#endif
+
+    int rc;
+
+    STATS_INC(ble_gap_stats, adv_update_data);
+
+    ble_hs_lock();
+
+    if (data_len > BLE_HCI_MAX_ADV_DATA_LEN) {
+        rc = BLE_HS_EMSGSIZE;
+        goto done;
+    }
+
+    /* Directed advertisements carry no advertising data. */
+    if (ble_gap_slave.op == BLE_GAP_OP_S_ADV &&
+        ble_gap_slave.conn_mode == BLE_GAP_CONN_MODE_DIR) {
+
+        rc = BLE_HS_EINVAL;
+        goto done;
+    }
+
+    memcpy(ble_gap_slave.adv_data, data, data_len);
+    ble_gap_slave.adv_data_len = data_len;
+    ble_gap_slave.adv_auto_flags = 0;
+
+    /* If advertising is active, push the new payload to the controller
+     * immediately; otherwise it is sent when advertising starts.
+     */
+    if (ble_gap_slave.op == BLE_GAP_OP_S_ADV) {
+        rc = ble_gap_adv_data_tx();
+        if (rc != 0) {
+            goto done;
+        }
+    }
+
+    rc = 0;
+
+done:
+    ble_hs_unlock();
+
+    if (rc != 0) {
+        STATS_INC(ble_gap_stats, adv_update_data_fail);
+    }
+    return rc;
+}
+
 /**
  * Configures the data to include in subsequent scan responses.
  *
@@ -44,6 +44,8 @@ STATS_SECT_START(ble_gap_stats)
     STATS_SECT_ENTRY(adv_start_fail)
     STATS_SECT_ENTRY(adv_set_fields)
     STATS_SECT_ENTRY(adv_set_fields_fail)
+    STATS_SECT_ENTRY(adv_update_data)
+    STATS_SECT_ENTRY(adv_update_data_fail)
     STATS_SECT_ENTRY(adv_rsp_set_fields)
     STATS_SECT_ENTRY(adv_rsp_set_fields_fail)
     STATS_SECT_ENTRY(discover)
@@ -56,6 +58,8 @@ STATS_SECT_START(ble_gap_stats)
     STATS_SECT_ENTRY(cancel_fail)
     STATS_SECT_ENTRY(update)
     STATS_SECT_ENTRY(update_fail)
+    STATS_SECT_ENTRY(autotune)
+    STATS_SECT_ENTRY(autotune_fail)
     STATS_SECT_ENTRY(connect_mst)
     STATS_SECT_ENTRY(connect_slv)
     STATS_SECT_ENTRY(disconnect)
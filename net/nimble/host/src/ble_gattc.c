@@ -90,6 +90,7 @@
 
 /** Procedure stalled due to resource exhaustion. */
 #define BLE_GATTC_PROC_F_STALLED                0x01
+#define BLE_GATTC_PROC_F_PENDING                0x02
 
 /** Represents an in-progress GATT procedure. */
 struct ble_gattc_proc {
@@ -183,6 +184,7 @@ struct ble_gattc_proc {
 
         struct {
             uint16_t att_handle;
+            struct os_mbuf *om;
             ble_gatt_attr_fn *cb;
             void *cb_arg;
         } write;
@@ -282,6 +284,49 @@ ble_gattc_resume_dispatch[BLE_GATT_OP_MAX] = {
     [BLE_GATT_OP_INDICATE]          = NULL,
 };
 
+/**
+ * Transmit functions - these send the initial request for a newly-allocated
+ * GATT procedure.
+ */
+typedef int ble_gattc_tx_fn(struct ble_gattc_proc *proc);
+
+static ble_gattc_tx_fn ble_gattc_mtu_tx;
+static ble_gattc_tx_fn ble_gattc_disc_all_svcs_tx;
+static ble_gattc_tx_fn ble_gattc_disc_svc_uuid_tx;
+static ble_gattc_tx_fn ble_gattc_find_inc_svcs_tx;
+static ble_gattc_tx_fn ble_gattc_disc_all_chrs_tx;
+static ble_gattc_tx_fn ble_gattc_disc_chr_uuid_tx;
+static ble_gattc_tx_fn ble_gattc_disc_all_dscs_tx;
+static ble_gattc_tx_fn ble_gattc_read_tx;
+static ble_gattc_tx_fn ble_gattc_read_uuid_tx;
+static ble_gattc_tx_fn ble_gattc_read_long_tx;
+static ble_gattc_tx_fn ble_gattc_read_mult_tx;
+static ble_gattc_tx_fn ble_gattc_write_tx;
+static ble_gattc_tx_fn ble_gattc_write_long_tx;
+static ble_gattc_tx_fn ble_gattc_write_reliable_tx;
+
+static ble_gattc_tx_fn * const ble_gattc_tx_dispatch[BLE_GATT_OP_MAX] = {
+    [BLE_GATT_OP_MTU]               = ble_gattc_mtu_tx,
+    [BLE_GATT_OP_DISC_ALL_SVCS]     = ble_gattc_disc_all_svcs_tx,
+    [BLE_GATT_OP_DISC_SVC_UUID]     = ble_gattc_disc_svc_uuid_tx,
+    [BLE_GATT_OP_FIND_INC_SVCS]     = ble_gattc_find_inc_svcs_tx,
+    [BLE_GATT_OP_DISC_ALL_CHRS]     = ble_gattc_disc_all_chrs_tx,
+    [BLE_GATT_OP_DISC_CHR_UUID]     = ble_gattc_disc_chr_uuid_tx,
+    [BLE_GATT_OP_DISC_ALL_DSCS]     = ble_gattc_disc_all_dscs_tx,
+    [BLE_GATT_OP_READ]              = ble_gattc_read_tx,
+    [BLE_GATT_OP_READ_UUID]         = ble_gattc_read_uuid_tx,
+    [BLE_GATT_OP_READ_LONG]         = ble_gattc_read_long_tx,
+    [BLE_GATT_OP_READ_MULT]         = ble_gattc_read_mult_tx,
+    [BLE_GATT_OP_WRITE]             = ble_gattc_write_tx,
+    [BLE_GATT_OP_WRITE_LONG]        = ble_gattc_write_long_tx,
+    [BLE_GATT_OP_WRITE_RELIABLE]    = ble_gattc_write_reliable_tx,
+    [BLE_GATT_OP_INDICATE]          = NULL,
+};
+
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+static void ble_gattc_pend_kick(uint16_t conn_handle);
+#endif
+
 /**
  * Receive functions - these handle specific incoming responses and apply them
  * to the appropriate active GATT procedure.
@@ -370,6 +415,15 @@ static struct os_mempool ble_gattc_proc_pool;
 /* The list of active GATT client procedures. */
 static struct ble_gattc_proc_list ble_gattc_procs;
 
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+/* The list of procedures waiting for their connection's active procedure to
+ * complete.  ATT permits only one outstanding request per connection, so a
+ * queued procedure's request is transmitted when the connection's slot frees
+ * up.
+ */
+static struct ble_gattc_proc_list ble_gattc_pend_procs;
+#endif
+
 /* The time when we should attempt to resume stalled procedures, in OS ticks.
  * A value of 0 indicates no stalled procedures.
  */
@@ -663,6 +717,10 @@ ble_gattc_proc_free(struct ble_gattc_proc *proc)
         ble_gattc_dbg_assert_proc_not_inserted(proc);
 
         switch (proc->op) {
+        case BLE_GATT_OP_WRITE:
+            os_mbuf_free_chain(proc->write.om);
+            break;
+
         case BLE_GATT_OP_WRITE_LONG:
             os_mbuf_free_chain(proc->write_long.attr.om);
             break;
@@ -719,8 +777,24 @@ ble_gattc_proc_set_resume_timer(struct ble_gattc_proc *proc)
 static void
 ble_gattc_process_status(struct ble_gattc_proc *proc, int status)
 {
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+    uint16_t conn_handle;
+#endif
+
     switch (status) {
     case 0:
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+        if (proc->flags & BLE_GATTC_PROC_F_PENDING) {
+            /* The connection already has a procedure in progress; queue this
+             * one and transmit its request when the slot frees up.
+             */
+            ble_hs_lock();
+            STAILQ_INSERT_TAIL(&ble_gattc_pend_procs, proc, next);
+            ble_hs_unlock();
+            break;
+        }
+#endif
+
         if (!(proc->flags & BLE_GATTC_PROC_F_STALLED)) {
             ble_gattc_proc_set_exp_timer(proc);
         }
@@ -730,7 +804,13 @@ ble_gattc_process_status(struct ble_gattc_proc *proc, int status)
         break;
 
     default:
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+        conn_handle = proc->conn_handle;
+        ble_gattc_proc_free(proc);
+        ble_gattc_pend_kick(conn_handle);
+#else
         ble_gattc_proc_free(proc);
+#endif
         break;
     }
 }
@@ -771,6 +851,16 @@ ble_gattc_err_dispatch_get(uint8_t op)
     return ble_gattc_err_dispatch[op];
 }
 
+/**
+ * Retrieves the transmit dispatch entry with the specified op code.
+ */
+static ble_gattc_tx_fn *
+ble_gattc_tx_dispatch_get(uint8_t op)
+{
+    BLE_HS_DBG_ASSERT(op < BLE_GATT_OP_MAX);
+    return ble_gattc_tx_dispatch[op];
+}
+
 /**
  * Retrieves the error dispatch entry with the specified op code.
  */
@@ -996,6 +1086,147 @@ ble_gattc_extract_with_rx_entry(uint16_t conn_handle,
     return proc;
 }
 
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+/**
+ * Indicates whether the specified connection has a procedure in progress.
+ * Indication procedures are excluded; the server's indication occupies a
+ * separate ATT flow control slot from the client's requests.
+ */
+static int
+ble_gattc_conn_is_busy(uint16_t conn_handle)
+{
+    struct ble_gattc_proc *proc;
+    int busy;
+
+    busy = 0;
+
+    ble_hs_lock();
+    STAILQ_FOREACH(proc, &ble_gattc_procs, next) {
+        if (proc->conn_handle == conn_handle &&
+            proc->op != BLE_GATT_OP_INDICATE) {
+
+            busy = 1;
+            break;
+        }
+    }
+    ble_hs_unlock();
+
+    return busy;
+}
+
+/**
+ * Removes and returns the oldest queued procedure for the specified
+ * connection; null if the connection has no queued procedures.
+ */
+static struct ble_gattc_proc *
+ble_gattc_pend_remove(uint16_t conn_handle)
+{
+    struct ble_gattc_proc *proc;
+    struct ble_gattc_proc *prev;
+
+    ble_hs_lock();
+
+    prev = NULL;
+    STAILQ_FOREACH(proc, &ble_gattc_pend_procs, next) {
+        if (proc->conn_handle == conn_handle) {
+            if (prev == NULL) {
+                STAILQ_REMOVE_HEAD(&ble_gattc_pend_procs, next);
+            } else {
+                STAILQ_REMOVE_AFTER(&ble_gattc_pend_procs, prev, next);
+            }
+            break;
+        }
+        prev = proc;
+    }
+
+    ble_hs_unlock();
+
+    return proc;
+}
+
+/**
+ * Transmits queued procedures for the specified connection until one is
+ * successfully in flight or the queue is empty.  Queued procedures whose
+ * requests fail to transmit are reported to the application via the error
+ * dispatch, just as an incoming error response would be.
+ */
+static void
+ble_gattc_pend_kick(uint16_t conn_handle)
+{
+    struct ble_gattc_proc *proc;
+    ble_gattc_err_fn *err_cb;
+    ble_gattc_tx_fn *tx_cb;
+    int rc;
+
+    while (!ble_gattc_conn_is_busy(conn_handle)) {
+        proc = ble_gattc_pend_remove(conn_handle);
+        if (proc == NULL) {
+            return;
+        }
+
+        proc->flags &= ~BLE_GATTC_PROC_F_PENDING;
+
+        tx_cb = ble_gattc_tx_dispatch_get(proc->op);
+        BLE_HS_DBG_ASSERT(tx_cb != NULL);
+        rc = tx_cb(proc);
+        if (rc == 0) {
+            ble_gattc_proc_set_exp_timer(proc);
+            ble_gattc_proc_insert(proc);
+            ble_hs_timer_resched();
+            return;
+        }
+
+        err_cb = ble_gattc_err_dispatch_get(proc->op);
+        if (err_cb != NULL) {
+            err_cb(proc, rc, 0);
+        }
+        ble_gattc_proc_free(proc);
+    }
+}
+
+/**
+ * Causes all queued procedures for the specified connection to fail with the
+ * specified status code.
+ */
+static void
+ble_gattc_pend_fail(uint16_t conn_handle, int status)
+{
+    struct ble_gattc_proc *proc;
+    ble_gattc_err_fn *err_cb;
+
+    while ((proc = ble_gattc_pend_remove(conn_handle)) != NULL) {
+        err_cb = ble_gattc_err_dispatch_get(proc->op);
+        if (err_cb != NULL) {
+            err_cb(proc, status, 0);
+        }
+        ble_gattc_proc_free(proc);
+    }
+}
+#endif /* BLE_GATT_PIPELINE */
+
+/**
+ * Transmits the initial request for the specified newly-allocated procedure.
+ * If BLE_GATT_PIPELINE is enabled and the connection already has a procedure
+ * in progress, the procedure is instead marked pending; its request gets
+ * transmitted when the active procedure completes.
+ */
+static int
+ble_gattc_tx(struct ble_gattc_proc *proc)
+{
+    ble_gattc_tx_fn *tx_cb;
+
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+    if (ble_gattc_conn_is_busy(proc->conn_handle)) {
+        proc->flags |= BLE_GATTC_PROC_F_PENDING;
+        return 0;
+    }
+#endif
+
+    tx_cb = ble_gattc_tx_dispatch_get(proc->op);
+    BLE_HS_DBG_ASSERT(tx_cb != NULL);
+    return tx_cb(proc);
+}
+
 /**
  * Searches the main proc list for an entry whose connection handle and op code
  * match those specified.  If a matching entry is found, it is removed from the
@@ -1043,6 +1274,12 @@ ble_gattc_fail_procs(uint16_t conn_handle, uint8_t op, int status)
         STAILQ_REMOVE_HEAD(&temp_list, next);
         ble_gattc_proc_free(proc);
     }
+
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+    if (op == BLE_GATT_OP_NONE) {
+        ble_gattc_pend_fail(conn_handle, status);
+    }
+#endif
 }
 
 static void
@@ -1249,7 +1486,7 @@ ble_gattc_exchange_mtu(uint16_t conn_handle, ble_gatt_mtu_fn *cb, void *cb_arg)
 
     ble_gattc_log_proc_init("exchange mtu\n");
 
-    rc = ble_gattc_mtu_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -1482,7 +1719,7 @@ ble_gattc_disc_all_svcs(uint16_t conn_handle, ble_gatt_disc_svc_fn *cb,
 
     ble_gattc_log_proc_init("discover all services\n");
 
-    rc = ble_gattc_disc_all_svcs_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -1700,7 +1937,7 @@ ble_gattc_disc_svc_by_uuid(uint16_t conn_handle, const void *svc_uuid128,
 
     ble_gattc_log_disc_svc_uuid(proc);
 
-    rc = ble_gattc_disc_svc_uuid_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -2036,7 +2273,7 @@ ble_gattc_find_inc_svcs(uint16_t conn_handle, uint16_t start_handle,
 
     ble_gattc_log_find_inc_svcs(proc);
 
-    rc = ble_gattc_find_inc_svcs_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -2280,7 +2517,7 @@ ble_gattc_disc_all_chrs(uint16_t conn_handle, uint16_t start_handle,
 
     ble_gattc_log_disc_all_chrs(proc);
 
-    rc = ble_gattc_disc_all_chrs_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -2445,7 +2682,7 @@ done:
     if (rc != 0) {
         /* Failure. */
         cbrc = ble_gattc_disc_chr_uuid_cb(proc, rc, 0, NULL);
-    } else if (memcmp(chr.uuid128, proc->disc_chr_uuid.chr_uuid, 16) == 0) {
+    } else if (ble_uuid_128_eq(chr.uuid128, proc->disc_chr_uuid.chr_uuid)) {
         /* Requested characteristic discovered. */
         cbrc = ble_gattc_disc_chr_uuid_cb(proc, 0, 0, &chr);
     } else {
@@ -2538,7 +2775,7 @@ ble_gattc_disc_chrs_by_uuid(uint16_t conn_handle, uint16_t start_handle,
 
     ble_gattc_log_disc_chr_uuid(proc);
 
-    rc = ble_gattc_disc_chr_uuid_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -2757,7 +2994,7 @@ ble_gattc_disc_all_dscs(uint16_t conn_handle, uint16_t chr_val_handle,
 
     ble_gattc_log_disc_all_dscs(proc);
 
-    rc = ble_gattc_disc_all_dscs_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -2898,7 +3135,7 @@ ble_gattc_read(uint16_t conn_handle, uint16_t attr_handle,
     proc->read.cb_arg = cb_arg;
 
     ble_gattc_log_read(attr_handle);
-    rc = ble_gattc_read_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -3082,7 +3319,7 @@ ble_gattc_read_by_uuid(uint16_t conn_handle, uint16_t start_handle,
     proc->read_uuid.cb_arg = cb_arg;
 
     ble_gattc_log_read_uuid(start_handle, end_handle, uuid128);
-    rc = ble_gattc_read_uuid_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -3285,7 +3522,7 @@ ble_gattc_read_long(uint16_t conn_handle, uint16_t handle,
 
     ble_gattc_log_read_long(proc);
 
-    rc = ble_gattc_read_long_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -3424,7 +3661,7 @@ ble_gattc_read_mult(uint16_t conn_handle, const uint16_t *handles,
     proc->read_mult.cb_arg = cb_arg;
 
     ble_gattc_log_read_mult(handles, num_handles);
-    rc = ble_gattc_read_mult_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -3561,6 +3798,29 @@ ble_gattc_write_err(struct ble_gattc_proc *proc, int status,
     ble_gattc_write_cb(proc, status, att_handle);
 }
 
+/**
+ * Triggers a pending transmit for the specified write-characteristic-value
+ * proc.  The proc's mbuf is consumed regardless of the outcome.
+ */
+static int
+ble_gattc_write_tx(struct ble_gattc_proc *proc)
+{
+    struct ble_att_write_req req;
+    struct os_mbuf *om;
+    int rc;
+
+    om = proc->write.om;
+    proc->write.om = NULL;
+
+    req.bawq_handle = proc->write.att_handle;
+    rc = ble_att_clt_tx_write_req(proc->conn_handle, &req, om);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+
 /**
  * Initiates GATT procedure: Write Characteristic Value.  This function
  * consumes the supplied mbuf regardless of the outcome.
@@ -3585,7 +3845,6 @@ ble_gattc_write(uint16_t conn_handle, uint16_t attr_handle,
     return BLE_HS_ENOTSUP;
 #endif
 
-    struct ble_att_write_req req;
     struct ble_gattc_proc *proc;
     int rc;
 
@@ -3605,9 +3864,13 @@ ble_gattc_write(uint16_t conn_handle, uint16_t attr_handle,
 
     ble_gattc_log_write(attr_handle, OS_MBUF_PKTLEN(txom), 1);
 
-    req.bawq_handle = attr_handle;
-    rc = ble_att_clt_tx_write_req(conn_handle, &req, txom);
+    /* The proc now owns the mbuf; it is freed when the request gets
+     * transmitted.
+     */
+    proc->write.om = txom;
     txom = NULL;
+
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -3617,7 +3880,7 @@ done:
         STATS_INC(ble_gattc_stats, write_fail);
     }
 
-    /* Free the mbuf in case the send failed. */
+    /* Free the mbuf in case ownership was never transferred to the proc. */
     os_mbuf_free_chain(txom);
 
     ble_gattc_process_status(proc, rc);
@@ -3947,7 +4210,7 @@ ble_gattc_write_long(uint16_t conn_handle, uint16_t attr_handle,
 
     ble_gattc_log_write_long(proc);
 
-    rc = ble_gattc_write_long_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -4251,7 +4514,7 @@ ble_gattc_write_reliable(uint16_t conn_handle,
     }
 
     ble_gattc_log_write_reliable(proc);
-    rc = ble_gattc_write_reliable_tx(proc);
+    rc = ble_gattc_tx(proc);
     if (rc != 0) {
         goto done;
     }
@@ -4544,6 +4807,10 @@ ble_gattc_rx_err(uint16_t conn_handle, struct ble_att_error_rsp *rsp)
                    rsp->baep_handle);
         }
         ble_gattc_proc_free(proc);
+
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+        ble_gattc_pend_kick(conn_handle);
+#endif
     }
 }
 
@@ -4941,6 +5208,10 @@ ble_gattc_init(void)
 
     STAILQ_INIT(&ble_gattc_procs);
 
+#if MYNEWT_VAL(BLE_GATT_PIPELINE)
+    STAILQ_INIT(&ble_gattc_pend_procs);
+#endif
+
     if (MYNEWT_VAL(BLE_GATT_MAX_PROCS) > 0) {
         rc = os_mempool_init(&ble_gattc_proc_pool,
                              MYNEWT_VAL(BLE_GATT_MAX_PROCS),
@@ -1173,6 +1173,12 @@ ble_gatts_start(void)
     }
     ble_gatts_free_svc_defs();
 
+    /* Registration is complete; index the attributes for fast lookup. */
+    rc = ble_att_svr_build_index();
+    if (rc != 0) {
+        goto err;
+    }
+
     if (ble_gatts_num_cfgable_chrs == 0) {
         return 0;
     }
@@ -1526,6 +1532,131 @@ ble_gatts_chr_updated(uint16_t chr_val_handle)
     }
 }
 
+#if MYNEWT_VAL(BLE_GATTS_NOTIFY_FANOUT)
+/**
+ * Shared notification payload.  When a characteristic gets notified to
+ * several subscribers in one pass, its value is read once into this buffer
+ * and each subscriber receives a header-only mbuf whose data is an external
+ * reference to the buffer.  The reference count tracks the encoder plus the
+ * clones still owned by the transmit path; the buffer must not be re-encoded
+ * until it drops back to zero.
+ */
+static uint8_t ble_gatts_fanout_buf[BLE_ATT_ATTR_MAX_LEN];
+static uint16_t ble_gatts_fanout_len;
+static uint8_t ble_gatts_fanout_refs;
+
+static void
+ble_gatts_fanout_unref(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    BLE_HS_DBG_ASSERT(ble_gatts_fanout_refs > 0);
+    ble_gatts_fanout_refs--;
+    OS_EXIT_CRITICAL(sr);
+}
+
+/**
+ * Called when a clone referencing the shared payload gets freed.  This may
+ * run in any task, hence the critical section in the unref helper.
+ */
+static void
+ble_gatts_fanout_free_cb(uint8_t *ext_buf, void *arg)
+{
+    ble_gatts_fanout_unref();
+}
+
+/**
+ * Reads the specified characteristic value into the shared payload buffer.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EBUSY if a previously encoded payload
+ *                                  is still in flight;
+ *                              Other nonzero on error.
+ */
+static int
+ble_gatts_fanout_encode(uint16_t chr_val_handle)
+{
+    struct os_mbuf *om;
+    os_sr_t sr;
+    int rc;
+
+    OS_ENTER_CRITICAL(sr);
+    if (ble_gatts_fanout_refs != 0) {
+        OS_EXIT_CRITICAL(sr);
+        return BLE_HS_EBUSY;
+    }
+    ble_gatts_fanout_refs = 1;
+    OS_EXIT_CRITICAL(sr);
+
+    om = ble_hs_mbuf_att_pkt();
+    if (om == NULL) {
+        rc = BLE_HS_ENOMEM;
+        goto err;
+    }
+
+    rc = ble_att_svr_read_handle(BLE_HS_CONN_HANDLE_NONE, chr_val_handle, 0,
+                                 om, NULL);
+    if (rc != 0) {
+        os_mbuf_free_chain(om);
+        goto err;
+    }
+
+    if (OS_MBUF_PKTLEN(om) > sizeof ble_gatts_fanout_buf) {
+        os_mbuf_free_chain(om);
+        rc = BLE_HS_EMSGSIZE;
+        goto err;
+    }
+
+    ble_gatts_fanout_len = OS_MBUF_PKTLEN(om);
+    rc = os_mbuf_copydata(om, 0, ble_gatts_fanout_len, ble_gatts_fanout_buf);
+    BLE_HS_DBG_ASSERT(rc == 0);
+    os_mbuf_free_chain(om);
+
+    return 0;
+
+err:
+    ble_gatts_fanout_unref();
+    return rc;
+}
+
+/**
+ * Allocates a notification payload mbuf referencing the shared buffer.  The
+ * returned chain consists of a normal packet header mbuf, providing leading
+ * space for the ATT and L2CAP headers, followed by an external-data mbuf
+ * pointing at the shared payload.
+ */
+static struct os_mbuf *
+ble_gatts_fanout_clone(void)
+{
+    struct os_mbuf *head;
+    struct os_mbuf *ext;
+    os_sr_t sr;
+
+    head = ble_hs_mbuf_att_pkt();
+    if (head == NULL) {
+        return NULL;
+    }
+
+    ext = os_mbuf_get_ext(head->om_omp, ble_gatts_fanout_buf,
+                          ble_gatts_fanout_len, ble_gatts_fanout_free_cb,
+                          NULL);
+    if (ext == NULL) {
+        os_mbuf_free_chain(head);
+        return NULL;
+    }
+
+    SLIST_NEXT(head, om_next) = ext;
+    OS_MBUF_PKTHDR(head)->omp_len = ble_gatts_fanout_len;
+
+    OS_ENTER_CRITICAL(sr);
+    ble_gatts_fanout_refs++;
+    OS_EXIT_CRITICAL(sr);
+
+    return head;
+}
+#endif
+
 /**
  * Sends notifications or indications for the specified characteristic to all
  * connected devices.  The bluetooth spec does not allow more than one
@@ -1537,6 +1668,11 @@ ble_gatts_tx_notifications_one_chr(uint16_t chr_val_handle)
 {
     struct ble_gatts_clt_cfg *clt_cfg;
     struct ble_hs_conn *conn;
+#if MYNEWT_VAL(BLE_GATTS_NOTIFY_FANOUT)
+    struct os_mbuf *txom;
+    int encoded;
+    int rc;
+#endif
     uint16_t conn_handle;
     uint8_t att_op;
     int clt_cfg_idx;
@@ -1551,6 +1687,11 @@ ble_gatts_tx_notifications_one_chr(uint16_t chr_val_handle)
         return;
     }
 
+#if MYNEWT_VAL(BLE_GATTS_NOTIFY_FANOUT)
+    /* 0: not encoded yet; 1: shared payload valid; -1: encode failed. */
+    encoded = 0;
+#endif
+
     for (i = 0; ; i++) {
         ble_hs_lock();
 
@@ -1581,7 +1722,33 @@ ble_gatts_tx_notifications_one_chr(uint16_t chr_val_handle)
             break;
 
         case BLE_ATT_OP_NOTIFY_REQ:
+#if MYNEWT_VAL(BLE_GATTS_NOTIFY_FANOUT)
+            if (encoded == 0) {
+                encoded = ble_gatts_fanout_encode(chr_val_handle) == 0 ?
+                          1 : -1;
+            }
+            if (encoded == 1) {
+                txom = ble_gatts_fanout_clone();
+            } else {
+                txom = NULL;
+            }
+            if (txom != NULL) {
+                rc = ble_gattc_notify_custom(conn_handle, chr_val_handle,
+                                             txom);
+
+                /* Tell the application that a notification transmission was
+                 * attempted.
+                 */
+                ble_gap_notify_tx_event(rc, conn_handle, chr_val_handle, 0);
+            } else {
+                /* Shared payload unavailable; fall back to a per-connection
+                 * read and copy.
+                 */
+                ble_gattc_notify(conn_handle, chr_val_handle);
+            }
+#else
             ble_gattc_notify(conn_handle, chr_val_handle);
+#endif
             break;
 
         case BLE_ATT_OP_INDICATE_REQ:
@@ -1593,6 +1760,15 @@ ble_gatts_tx_notifications_one_chr(uint16_t chr_val_handle)
             break;
         }
     }
+
+#if MYNEWT_VAL(BLE_GATTS_NOTIFY_FANOUT)
+    if (encoded == 1) {
+        /* Drop the encoder's reference; the shared buffer becomes reusable
+         * when the last clone gets freed.
+         */
+        ble_gatts_fanout_unref();
+    }
+#endif
 }
 
 /**
@@ -1714,7 +1890,7 @@ ble_gatts_find_svc_entry(const void *uuid128)
 
     for (i = 0; i < ble_gatts_num_svc_entries; i++) {
         entry = ble_gatts_svc_entries + i;
-        if (memcmp(uuid128, entry->svc->uuid128, 16) == 0) {
+        if (ble_uuid_128_eq(uuid128, entry->svc->uuid128)) {
             return entry;
         }
     }
@@ -1743,13 +1919,13 @@ ble_gatts_find_svc_chr_attr(const void *svc_uuid128, const void *chr_uuid128,
         return BLE_HS_EUNKNOWN;
     }
 
-    cur = STAILQ_NEXT(att_svc, ha_next);
+    cur = ble_att_svr_entry_next(att_svc);
     while (1) {
         if (cur == NULL) {
             /* Reached end of attribute list without a match. */
             return BLE_HS_ENOENT;
         }
-        next = STAILQ_NEXT(cur, ha_next);
+        next = ble_att_svr_entry_next(cur);
 
         if (cur->ha_handle_id == svc_entry->end_group_handle) {
             /* Reached end of service without a match. */
@@ -1759,7 +1935,7 @@ ble_gatts_find_svc_chr_attr(const void *svc_uuid128, const void *chr_uuid128,
         uuid16 = ble_uuid_128_to_16(cur->ha_uuid);
         if (uuid16 == BLE_ATT_UUID_CHARACTERISTIC &&
             next != NULL &&
-            memcmp(next->ha_uuid, chr_uuid128, 16) == 0) {
+            ble_uuid_128_eq(next->ha_uuid, chr_uuid128)) {
 
             if (out_svc_entry != NULL) {
                 *out_svc_entry = svc_entry;
@@ -1871,7 +2047,7 @@ ble_gatts_find_dsc(const void *svc_uuid128, const void *chr_uuid128,
         return rc;
     }
 
-    cur = STAILQ_NEXT(att_chr, ha_next);
+    cur = ble_att_svr_entry_next(att_chr);
     while (1) {
         if (cur == NULL) {
             /* Reached end of attribute list without a match. */
@@ -1889,13 +2065,13 @@ ble_gatts_find_dsc(const void *svc_uuid128, const void *chr_uuid128,
             return BLE_HS_ENOENT;
         }
 
-        if (memcmp(cur->ha_uuid, dsc_uuid128, 16) == 0) {
+        if (ble_uuid_128_eq(cur->ha_uuid, dsc_uuid128)) {
             if (out_handle != NULL) {
                 *out_handle = cur->ha_handle_id;
                 return 0;
             }
         }
-        cur = STAILQ_NEXT(cur, ha_next);
+        cur = ble_att_svr_entry_next(cur);
     }
 }
 
@@ -25,6 +25,9 @@
 #include "bsp/bsp.h"
 #include "stats/stats.h"
 #include "os/os.h"
+#if MYNEWT_VAL(BLE_HS_WORKQ)
+#include "os/os_workq.h"
+#endif
 #include "console/console.h"
 #include "nimble/ble_hci_trans.h"
 #include "ble_hs_priv.h"
@@ -110,8 +113,18 @@ STATS_NAME_END(ble_hs_stats)
 static struct os_eventq *
 ble_hs_evq_get(void)
 {
+#if MYNEWT_VAL(BLE_HS_WORKQ)
+    /* Default to the shared work queue lane rather than the default
+     * eventq; an earlier explicit ble_hs_evq_set() wins.
+     */
+    if (ble_hs_evq == NULL) {
+        ble_hs_evq_set(os_workq_lane_evq(MYNEWT_VAL(BLE_HS_WORKQ_LANE)));
+    }
+    return ble_hs_evq;
+#else
     os_eventq_ensure(&ble_hs_evq, &ble_hs_ev_start);
     return ble_hs_evq;
+#endif
 }
 
 void
@@ -184,9 +197,21 @@ void
 ble_hs_process_tx_data_queue(void)
 {
     struct os_mbuf *om;
+#if MYNEWT_VAL(BLE_HS_DATA_EVT_BUDGET)
+    int budget;
+
+    budget = MYNEWT_VAL(BLE_HS_DATA_EVT_BUDGET);
+#endif
 
     while ((om = os_mqueue_get(&ble_hs_tx_q)) != NULL) {
         ble_hci_trans_hs_acl_tx(om);
+#if MYNEWT_VAL(BLE_HS_DATA_EVT_BUDGET)
+        /* Re-post the data event so other host work gets a turn */
+        if (--budget == 0 && STAILQ_FIRST(&ble_hs_tx_q.mq_head)) {
+            os_eventq_put(ble_hs_evq_get(), &ble_hs_tx_q.mq_ev);
+            break;
+        }
+#endif
     }
 }
 
@@ -194,9 +219,21 @@ void
 ble_hs_process_rx_data_queue(void)
 {
     struct os_mbuf *om;
+#if MYNEWT_VAL(BLE_HS_DATA_EVT_BUDGET)
+    int budget;
+
+    budget = MYNEWT_VAL(BLE_HS_DATA_EVT_BUDGET);
+#endif
 
     while ((om = os_mqueue_get(&ble_hs_rx_q)) != NULL) {
         ble_hs_hci_evt_acl_process(om);
+#if MYNEWT_VAL(BLE_HS_DATA_EVT_BUDGET)
+        /* Re-post the data event so other host work gets a turn */
+        if (--budget == 0 && STAILQ_FIRST(&ble_hs_rx_q.mq_head)) {
+            os_eventq_put(ble_hs_evq_get(), &ble_hs_rx_q.mq_ev);
+            break;
+        }
+#endif
     }
 }
 
@@ -458,7 +495,19 @@ ble_hs_start(void)
 {
     int rc;
 
+#if MYNEWT_VAL(BLE_HS_WORKQ)
+    /* Host events run on the shared worker unless the app pointed the
+     * host at its own eventq, in which case the caller's task is the
+     * one that will drain it.
+     */
+    if (ble_hs_evq_get() == os_workq_lane_evq(MYNEWT_VAL(BLE_HS_WORKQ_LANE))) {
+        ble_hs_parent_task = os_workq_task_get();
+    } else {
+        ble_hs_parent_task = os_sched_get_current_task();
+    }
+#else
     ble_hs_parent_task = os_sched_get_current_task();
+#endif
 
     os_callout_init(&ble_hs_timer_timer, ble_hs_evq_get(),
                     ble_hs_timer_exp, NULL);
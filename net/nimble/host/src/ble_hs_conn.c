@@ -30,6 +30,14 @@
 static SLIST_HEAD(, ble_hs_conn) ble_hs_conns;
 static struct os_mempool ble_hs_conn_pool;
 
+#if MYNEWT_VAL(BLE_HS_CONN_CACHE)
+/* The most recently found connection; only accessed with the host mutex
+ * held.  Hot paths look the same connection up several times per packet, so
+ * repeat lookups short-circuit the list walk.
+ */
+static struct ble_hs_conn *ble_hs_conn_cache;
+#endif
+
 static os_membuf_t ble_hs_conn_elem_mem[
     OS_MEMPOOL_SIZE(MYNEWT_VAL(BLE_MAX_CONNECTIONS),
                     sizeof (struct ble_hs_conn))
@@ -120,6 +128,10 @@ ble_hs_conn_alloc(void)
 
     SLIST_INIT(&conn->bhc_channels);
 
+#if MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE)
+    STAILQ_INIT(&conn->bhc_tx_q);
+#endif
+
     chan = ble_att_create_chan();
     if (chan == NULL) {
         goto err;
@@ -197,6 +209,10 @@ ble_hs_conn_free(struct ble_hs_conn *conn)
         ble_hs_conn_delete_chan(conn, chan);
     }
 
+#if MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE)
+    ble_hs_hci_acl_purge(conn);
+#endif
+
     rc = os_memblock_put(&ble_hs_conn_pool, conn);
     BLE_HS_DBG_ASSERT_EVAL(rc == 0);
 
@@ -225,6 +241,12 @@ ble_hs_conn_remove(struct ble_hs_conn *conn)
 
     BLE_HS_DBG_ASSERT(ble_hs_locked_by_cur_task());
 
+#if MYNEWT_VAL(BLE_HS_CONN_CACHE)
+    if (ble_hs_conn_cache == conn) {
+        ble_hs_conn_cache = NULL;
+    }
+#endif
+
     SLIST_REMOVE(&ble_hs_conns, conn, ble_hs_conn, bhc_next);
 }
 
@@ -239,8 +261,19 @@ ble_hs_conn_find(uint16_t conn_handle)
 
     BLE_HS_DBG_ASSERT(ble_hs_locked_by_cur_task());
 
+#if MYNEWT_VAL(BLE_HS_CONN_CACHE)
+    if (ble_hs_conn_cache != NULL &&
+        ble_hs_conn_cache->bhc_handle == conn_handle) {
+
+        return ble_hs_conn_cache;
+    }
+#endif
+
     SLIST_FOREACH(conn, &ble_hs_conns, bhc_next) {
         if (conn->bhc_handle == conn_handle) {
+#if MYNEWT_VAL(BLE_HS_CONN_CACHE)
+            ble_hs_conn_cache = conn;
+#endif
             return conn;
         }
     }
@@ -392,5 +425,9 @@ ble_hs_conn_init(void)
 
     SLIST_INIT(&ble_hs_conns);
 
+#if MYNEWT_VAL(BLE_HS_CONN_CACHE)
+    ble_hs_conn_cache = NULL;
+#endif
+
     return 0;
 }
@@ -56,6 +56,23 @@ struct ble_hs_conn {
     struct ble_l2cap_chan *bhc_rx_chan; /* Channel rxing current packet. */
     uint16_t bhc_outstanding_pkts;
 
+#if MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE)
+    /* Per-connection ACL transmit queue, drained by deficit round robin. */
+    STAILQ_HEAD(, os_mbuf_pkthdr) bhc_tx_q;
+    struct os_mbuf *bhc_tx_cur;     /* Packet currently being fragmented. */
+    uint8_t bhc_tx_pb;              /* PB flag for cur's next fragment. */
+    int32_t bhc_tx_deficit;         /* DRR deficit counter, in bytes. */
+    uint16_t bhc_tx_q_len;          /* Current queue depth, in packets. */
+    uint16_t bhc_tx_q_max;          /* High watermark of bhc_tx_q_len. */
+#endif
+
+#if MYNEWT_VAL(BLE_GAP_AUTOTUNE)
+    /* Connection parameter autotuner (see ble_gap_autotune_timer) */
+    uint16_t bhc_at_pkts;           /* Data packets seen this period. */
+    uint8_t bhc_at_profile;         /* Parameter profile last applied. */
+    uint8_t bhc_at_quiet_periods;   /* Consecutive periods with no data. */
+#endif
+
     struct ble_att_svr_conn bhc_att_svr;
     struct ble_gatts_conn bhc_gatt_svr;
 
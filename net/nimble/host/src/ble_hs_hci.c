@@ -34,6 +34,11 @@ static uint8_t *ble_hs_hci_ack;
 static uint16_t ble_hs_hci_buf_sz;
 static uint8_t ble_hs_hci_max_pkts;
 
+#if MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE)
+/* Number of ACL data packets the controller can currently accept. */
+static uint16_t ble_hs_hci_avail_pkts;
+#endif
+
 #if MYNEWT_VAL(BLE_HS_PHONY_HCI_ACKS)
 static ble_hs_hci_phony_ack_fn *ble_hs_hci_phony_ack_cb;
 #endif
@@ -73,6 +78,9 @@ ble_hs_hci_set_buf_sz(uint16_t pktlen, uint8_t max_pkts)
 
     ble_hs_hci_buf_sz = pktlen;
     ble_hs_hci_max_pkts = max_pkts;
+#if MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE)
+    ble_hs_hci_avail_pkts = max_pkts;
+#endif
 
     return 0;
 }
@@ -451,6 +459,206 @@ ble_hs_hci_acl_hdr_prepend(struct os_mbuf *om, uint16_t handle,
     return om;
 }
 
+#if MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE)
+
+/**
+ * Transmits one fragment of the connection's current outgoing packet,
+ * dequeueing the next packet first if necessary.  On failure, the remainder
+ * of the current packet is dropped.
+ *
+ * Lock restrictions: requires the ble_hs mutex to be locked.
+ *
+ * @return                      0 on success; nonzero on error.
+ */
+static int
+ble_hs_hci_acl_tx_frag(struct ble_hs_conn *conn)
+{
+    struct os_mbuf_pkthdr *omp;
+    struct os_mbuf *frag;
+    uint16_t frag_len;
+    int rc;
+
+    if (conn->bhc_tx_cur == NULL) {
+        omp = STAILQ_FIRST(&conn->bhc_tx_q);
+        BLE_HS_DBG_ASSERT(omp != NULL);
+        STAILQ_REMOVE_HEAD(&conn->bhc_tx_q, omp_next);
+        conn->bhc_tx_q_len--;
+
+        conn->bhc_tx_cur = OS_MBUF_PKTHDR_TO_MBUF(omp);
+        conn->bhc_tx_pb = BLE_HCI_PB_FIRST_NON_FLUSH;
+    }
+
+    rc = ble_hs_hci_split_frag(&conn->bhc_tx_cur, &frag);
+    if (rc != 0) {
+        goto err;
+    }
+    frag_len = OS_MBUF_PKTLEN(frag);
+
+    frag = ble_hs_hci_acl_hdr_prepend(frag, conn->bhc_handle,
+                                      conn->bhc_tx_pb);
+    if (frag == NULL) {
+        rc = BLE_HS_ENOMEM;
+        goto err;
+    }
+    conn->bhc_tx_pb = BLE_HCI_PB_MIDDLE;
+
+    BLE_HS_LOG(DEBUG, "ble_hs_hci_acl_tx_frag(): ");
+    ble_hs_log_mbuf(frag);
+    BLE_HS_LOG(DEBUG, "\n");
+
+    rc = ble_hs_tx_data(frag);
+    if (rc != 0) {
+        goto err;
+    }
+
+    conn->bhc_outstanding_pkts++;
+    ble_hs_hci_avail_pkts--;
+    conn->bhc_tx_deficit -= frag_len;
+
+    return 0;
+
+err:
+    /* Drop the remainder of the current packet. */
+    os_mbuf_free_chain(conn->bhc_tx_cur);
+    conn->bhc_tx_cur = NULL;
+    return rc;
+}
+
+/**
+ * Drains the per-connection transmit queues into the controller's buffer
+ * pool using deficit round robin: each connection with pending data earns a
+ * byte quantum per round and transmits while its deficit lasts.  A
+ * connection performing a bulk transfer therefore cannot monopolize the
+ * controller buffers; the other connections get their share each round.
+ *
+ * Lock restrictions: requires the ble_hs mutex to be locked.
+ */
+static void
+ble_hs_hci_acl_drain(void)
+{
+    struct ble_hs_conn *conn;
+    uint16_t quantum;
+    int progress;
+
+    quantum = ble_hs_hci_max_acl_payload_sz();
+
+    progress = 1;
+    while (ble_hs_hci_avail_pkts > 0 && progress) {
+        progress = 0;
+
+        for (conn = ble_hs_conn_first();
+             conn != NULL;
+             conn = SLIST_NEXT(conn, bhc_next)) {
+
+            if (conn->bhc_tx_cur == NULL && STAILQ_EMPTY(&conn->bhc_tx_q)) {
+                /* Idle connections don't accumulate credit. */
+                conn->bhc_tx_deficit = 0;
+                continue;
+            }
+
+            conn->bhc_tx_deficit += quantum;
+
+            while (conn->bhc_tx_deficit > 0 &&
+                   ble_hs_hci_avail_pkts > 0 &&
+                   (conn->bhc_tx_cur != NULL ||
+                    !STAILQ_EMPTY(&conn->bhc_tx_q))) {
+
+                if (ble_hs_hci_acl_tx_frag(conn) != 0) {
+                    break;
+                }
+                progress = 1;
+            }
+        }
+    }
+}
+
+/**
+ * Enqueues an HCI ACL data packet for transmission.  This function consumes
+ * the supplied mbuf, regardless of the outcome.  Packets are drained into
+ * the controller's buffer pool with per-connection fair scheduling; a packet
+ * that cannot be sent immediately remains queued until the controller
+ * reports completed packets.
+ *
+ * Lock restrictions: requires the ble_hs mutex to be locked.
+ */
+int
+ble_hs_hci_acl_tx(struct ble_hs_conn *connection, struct os_mbuf *txom)
+{
+    STAILQ_INSERT_TAIL(&connection->bhc_tx_q, OS_MBUF_PKTHDR(txom),
+                       omp_next);
+    connection->bhc_tx_q_len++;
+#if MYNEWT_VAL(BLE_GAP_AUTOTUNE)
+    connection->bhc_at_pkts++;
+#endif
+    if (connection->bhc_tx_q_len > connection->bhc_tx_q_max) {
+        connection->bhc_tx_q_max = connection->bhc_tx_q_len;
+    }
+
+    ble_hs_hci_acl_drain();
+
+    return 0;
+}
+
+/**
+ * Processes a number-of-completed-packets entry from the controller:
+ * returns the freed controller buffers to the global budget and resumes
+ * draining the transmit queues.
+ */
+void
+ble_hs_hci_acl_pkts_completed(uint16_t conn_handle, uint16_t num_pkts)
+{
+    struct ble_hs_conn *conn;
+
+    ble_hs_lock();
+
+    conn = ble_hs_conn_find(conn_handle);
+    if (conn != NULL) {
+        if (num_pkts > conn->bhc_outstanding_pkts) {
+            num_pkts = conn->bhc_outstanding_pkts;
+        }
+        conn->bhc_outstanding_pkts -= num_pkts;
+
+        ble_hs_hci_avail_pkts += num_pkts;
+        if (ble_hs_hci_avail_pkts > ble_hs_hci_max_pkts) {
+            ble_hs_hci_avail_pkts = ble_hs_hci_max_pkts;
+        }
+
+        ble_hs_hci_acl_drain();
+    }
+
+    ble_hs_unlock();
+}
+
+/**
+ * Releases the transmit state of a connection that is being deleted: frees
+ * its queued packets and returns its outstanding controller buffers to the
+ * global budget.
+ *
+ * Lock restrictions: requires the ble_hs mutex to be locked.
+ */
+void
+ble_hs_hci_acl_purge(struct ble_hs_conn *conn)
+{
+    struct os_mbuf_pkthdr *omp;
+
+    os_mbuf_free_chain(conn->bhc_tx_cur);
+    conn->bhc_tx_cur = NULL;
+
+    while ((omp = STAILQ_FIRST(&conn->bhc_tx_q)) != NULL) {
+        STAILQ_REMOVE_HEAD(&conn->bhc_tx_q, omp_next);
+        os_mbuf_free_chain(OS_MBUF_PKTHDR_TO_MBUF(omp));
+    }
+    conn->bhc_tx_q_len = 0;
+
+    ble_hs_hci_avail_pkts += conn->bhc_outstanding_pkts;
+    if (ble_hs_hci_avail_pkts > ble_hs_hci_max_pkts) {
+        ble_hs_hci_avail_pkts = ble_hs_hci_max_pkts;
+    }
+    conn->bhc_outstanding_pkts = 0;
+}
+
+#else /* !MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE) */
+
 /**
  * Transmits an HCI ACL data packet.  This function consumes the supplied mbuf,
  * regardless of the outcome.
@@ -471,6 +679,10 @@ ble_hs_hci_acl_tx(struct ble_hs_conn *connection, struct os_mbuf *txom)
      */
     pb = BLE_HCI_PB_FIRST_NON_FLUSH;
 
+#if MYNEWT_VAL(BLE_GAP_AUTOTUNE)
+    connection->bhc_at_pkts++;
+#endif
+
     /* Send fragments until the entire packet has been sent. */
     while (txom != NULL) {
         rc = ble_hs_hci_split_frag(&txom, &frag);
@@ -506,6 +718,212 @@ err:
     return rc;
 }
 
+#endif /* !MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE) */
+
+#if MYNEWT_VAL(BLE_HS_FLOW_CTRL)
+/*
+ * Controller-to-host flow control. Every ACL packet received from the
+ * controller owes it a buffer credit; while the msys pools are healthy
+ * the credits are returned immediately with the host-number-of-
+ * completed-packets command, so the feature costs one short HCI command
+ * per received packet. When any msys pool falls to its pressure
+ * watermark, credit returns are withheld: the controller queues in its
+ * own buffers and link-layer acknowledgements pace the peer. The
+ * accumulated credits are flushed from the host task when the last
+ * pool recovers.
+ */
+
+/* The controller sends at most one LL payload per ACL packet. */
+#define BLE_HS_HCI_FC_ACL_PKT_SZ        (260)
+
+/* Listeners to cover every msys pool. */
+#define BLE_HS_HCI_FC_MAX_POOLS         (4)
+
+/* One slot per connection, plus one for packets with unknown handles. */
+#define BLE_HS_HCI_FC_MAX_PEND          (MYNEWT_VAL(BLE_MAX_CONNECTIONS) + 1)
+
+struct ble_hs_hci_fc_ent {
+    uint16_t handle;
+    uint16_t count;                 /* 0 = slot unused */
+};
+
+static struct ble_hs_hci_fc_ent ble_hs_hci_fc_pend[BLE_HS_HCI_FC_MAX_PEND];
+static struct os_mempool_listener
+    ble_hs_hci_fc_listeners[BLE_HS_HCI_FC_MAX_POOLS];
+static struct os_event ble_hs_hci_fc_flush_ev;
+static uint8_t ble_hs_hci_fc_enabled;
+
+/* Number of msys pools currently at their watermark; modified from the
+ * pressure callbacks, which may run in interrupt context.
+ */
+static volatile uint8_t ble_hs_hci_fc_pools_low;
+
+/**
+ * Returns all pending credits to the controller in one
+ * host-number-of-completed-packets command.
+ *
+ * Context: host task.
+ */
+static void
+ble_hs_hci_fc_flush(void)
+{
+    uint8_t buf[BLE_HCI_CMD_HDR_LEN + BLE_HCI_HOST_NUM_COMP_PKTS_HDR_LEN +
+                BLE_HS_HCI_FC_MAX_PEND * BLE_HCI_HOST_NUM_COMP_PKTS_ENT_LEN];
+    uint8_t *dst;
+    uint8_t num_handles;
+    int i;
+    int rc;
+
+    num_handles = 0;
+    dst = buf + BLE_HCI_CMD_HDR_LEN + BLE_HCI_HOST_NUM_COMP_PKTS_HDR_LEN;
+    for (i = 0; i < BLE_HS_HCI_FC_MAX_PEND; i++) {
+        if (ble_hs_hci_fc_pend[i].count != 0) {
+            htole16(dst, ble_hs_hci_fc_pend[i].handle);
+            htole16(dst + 2, ble_hs_hci_fc_pend[i].count);
+            dst += BLE_HCI_HOST_NUM_COMP_PKTS_ENT_LEN;
+            num_handles++;
+
+            ble_hs_hci_fc_pend[i].count = 0;
+        }
+    }
+
+    if (num_handles == 0) {
+        return;
+    }
+
+    ble_hs_hci_cmd_write_hdr(BLE_HCI_OGF_CTLR_BASEBAND,
+                             BLE_HCI_OCF_CB_HOST_NUM_COMP_PKTS,
+                             BLE_HCI_HOST_NUM_COMP_PKTS_HDR_LEN +
+                             num_handles * BLE_HCI_HOST_NUM_COMP_PKTS_ENT_LEN,
+                             buf);
+    buf[BLE_HCI_CMD_HDR_LEN] = num_handles;
+
+    rc = ble_hs_hci_cmd_tx_empty_ack(buf);
+    BLE_HS_DBG_ASSERT_EVAL(rc == 0);
+}
+
+static void
+ble_hs_hci_fc_flush_ev_cb(struct os_event *ev)
+{
+    if (ble_hs_hci_fc_pools_low == 0) {
+        ble_hs_hci_fc_flush();
+    }
+}
+
+static void
+ble_hs_hci_fc_pressure_cb(struct os_mempool *mp, int event, void *arg)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (event == OS_MEMPOOL_PRESSURE_LOW) {
+        ble_hs_hci_fc_pools_low++;
+    } else {
+        ble_hs_hci_fc_pools_low--;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    /* On full recovery, flush withheld credits from the host task; the
+     * controller may be stalled waiting for them.
+     */
+    if (event == OS_MEMPOOL_PRESSURE_RELIEVED &&
+        ble_hs_hci_fc_pools_low == 0) {
+
+        os_eventq_put(ble_hs_evq_get(), &ble_hs_hci_fc_flush_ev);
+    }
+}
+
+/**
+ * Records receipt of an ACL packet from the controller and, unless an
+ * msys pool is under pressure, immediately returns the credit.
+ *
+ * Context: host task.
+ */
+void
+ble_hs_hci_fc_acl_rxed(uint16_t conn_handle)
+{
+    struct ble_hs_hci_fc_ent *ent;
+    int i;
+
+    if (!ble_hs_hci_fc_enabled) {
+        return;
+    }
+
+    ent = NULL;
+    for (i = 0; i < BLE_HS_HCI_FC_MAX_PEND; i++) {
+        if (ble_hs_hci_fc_pend[i].count != 0 &&
+            ble_hs_hci_fc_pend[i].handle == conn_handle) {
+
+            ent = &ble_hs_hci_fc_pend[i];
+            break;
+        }
+        if (ent == NULL && ble_hs_hci_fc_pend[i].count == 0) {
+            ent = &ble_hs_hci_fc_pend[i];
+        }
+    }
+    BLE_HS_DBG_ASSERT(ent != NULL);
+
+    ent->handle = conn_handle;
+    ent->count++;
+
+    if (ble_hs_hci_fc_pools_low == 0) {
+        ble_hs_hci_fc_flush();
+    }
+}
+
+/**
+ * Enables controller-to-host flow control; called during host startup,
+ * before any connections exist.
+ */
+int
+ble_hs_hci_fc_startup(void)
+{
+    uint8_t buf[BLE_HCI_CMD_HDR_LEN + BLE_HCI_HOST_BUF_SIZE_LEN];
+    uint16_t acl_num;
+    int total;
+    int rc;
+
+    rc = os_msys_listener_register(ble_hs_hci_fc_listeners,
+                                   BLE_HS_HCI_FC_MAX_POOLS,
+                                   MYNEWT_VAL(BLE_HS_FLOW_CTRL_LOW_PCT),
+                                   ble_hs_hci_fc_pressure_cb, NULL);
+    if (rc < 0) {
+        return BLE_HS_ENOMEM;
+    }
+
+    ble_hs_hci_fc_flush_ev.ev_cb = ble_hs_hci_fc_flush_ev_cb;
+
+    /* Advertise half the msys blocks as receive buffers, leaving the
+     * rest for transmit and reassembly.
+     */
+    total = os_msys_count() / 2;
+    if (total < 1) {
+        total = 1;
+    } else if (total > UINT16_MAX) {
+        total = UINT16_MAX;
+    }
+    acl_num = total;
+
+    ble_hs_hci_cmd_build_ctlr_to_host_fc(BLE_HCI_CTLR_TO_HOST_FC_ACL,
+                                         buf, sizeof buf);
+    rc = ble_hs_hci_cmd_tx_empty_ack(buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_hs_hci_cmd_build_host_buf_size(BLE_HS_HCI_FC_ACL_PKT_SZ, acl_num,
+                                       buf, sizeof buf);
+    rc = ble_hs_hci_cmd_tx_empty_ack(buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_hs_hci_fc_enabled = 1;
+
+    return 0;
+}
+#endif /* BLE_HS_FLOW_CTRL */
+
 void
 ble_hs_hci_init(void)
 {
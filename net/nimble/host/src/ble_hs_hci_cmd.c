@@ -376,6 +376,39 @@ ble_hs_hci_cmd_build_set_event_mask2(uint64_t event_mask,
     ble_hs_hci_cmd_body_set_event_mask(event_mask, dst);
 }
 
+void
+ble_hs_hci_cmd_build_ctlr_to_host_fc(uint8_t fc_enable,
+                                     uint8_t *dst, int dst_len)
+{
+    BLE_HS_DBG_ASSERT(
+        dst_len >= BLE_HCI_CMD_HDR_LEN + BLE_HCI_CTLR_TO_HOST_FC_LEN);
+
+    ble_hs_hci_cmd_write_hdr(BLE_HCI_OGF_CTLR_BASEBAND,
+                       BLE_HCI_OCF_CB_SET_CTLR_TO_HOST_FC,
+                       BLE_HCI_CTLR_TO_HOST_FC_LEN, dst);
+    dst += BLE_HCI_CMD_HDR_LEN;
+
+    dst[0] = fc_enable;
+}
+
+void
+ble_hs_hci_cmd_build_host_buf_size(uint16_t acl_pkt_len, uint16_t acl_num_pkts,
+                                   uint8_t *dst, int dst_len)
+{
+    BLE_HS_DBG_ASSERT(
+        dst_len >= BLE_HCI_CMD_HDR_LEN + BLE_HCI_HOST_BUF_SIZE_LEN);
+
+    ble_hs_hci_cmd_write_hdr(BLE_HCI_OGF_CTLR_BASEBAND,
+                       BLE_HCI_OCF_CB_HOST_BUF_SIZE,
+                       BLE_HCI_HOST_BUF_SIZE_LEN, dst);
+    dst += BLE_HCI_CMD_HDR_LEN;
+
+    htole16(dst + 0, acl_pkt_len);
+    dst[2] = 0;                     /* No synchronous data buffers. */
+    htole16(dst + 3, acl_num_pkts);
+    htole16(dst + 5, 0);
+}
+
 static void
 ble_hs_hci_cmd_body_disconnect(uint16_t handle, uint8_t reason, uint8_t *dst)
 {
@@ -709,6 +742,44 @@ ble_hs_hci_cmd_build_le_add_to_whitelist(const uint8_t *addr,
     return 0;
 }
 
+/**
+ * Vendor-specific bulk white list set (OGF 0x3F, OCF 0x0003).
+ *
+ * Replaces the controller's entire white list in a single command: an entry
+ * count followed by (address type, address) pairs.
+ */
+int
+ble_hs_hci_cmd_build_wl_bulk_set(const struct ble_gap_white_entry *white_list,
+                                 uint8_t white_list_count,
+                                 uint8_t *dst, int dst_len)
+{
+    int i;
+
+    if (white_list_count > BLE_HCI_WL_BULK_SET_MAX_ENTS) {
+        return BLE_ERR_INV_HCI_CMD_PARMS;
+    }
+
+    BLE_HS_DBG_ASSERT(
+        dst_len >= BLE_HCI_CMD_HDR_LEN + 1 +
+                   white_list_count * BLE_HCI_WL_BULK_SET_ENT_LEN);
+
+    ble_hs_hci_cmd_write_hdr(BLE_HCI_OGF_VENDOR, BLE_HCI_OCF_VENDOR_WL_BULK_SET,
+                       1 + white_list_count * BLE_HCI_WL_BULK_SET_ENT_LEN, dst);
+    dst += BLE_HCI_CMD_HDR_LEN;
+
+    *dst++ = white_list_count;
+    for (i = 0; i < white_list_count; i++) {
+        if (white_list[i].addr_type > BLE_ADDR_TYPE_RANDOM) {
+            return BLE_ERR_INV_HCI_CMD_PARMS;
+        }
+        *dst++ = white_list[i].addr_type;
+        memcpy(dst, white_list[i].addr, BLE_DEV_ADDR_LEN);
+        dst += BLE_DEV_ADDR_LEN;
+    }
+
+    return 0;
+}
+
 void
 ble_hs_hci_cmd_build_reset(uint8_t *dst, int dst_len)
 {
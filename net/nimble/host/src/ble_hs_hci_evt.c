@@ -222,9 +222,13 @@ ble_hs_hci_evt_num_completed_pkts(uint8_t event_code, uint8_t *data, int len)
         handle = le16toh(data + off + 2 * i);
         num_pkts = le16toh(data + off + 2 * num_handles + 2 * i);
 
+#if MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE)
+        ble_hs_hci_acl_pkts_completed(handle, num_pkts);
+#else
         /* XXX: Do something with these values. */
         (void)handle;
         (void)num_pkts;
+#endif
     }
 
     return 0;
@@ -616,6 +620,7 @@ ble_hs_hci_evt_acl_process(struct os_mbuf *om)
     ble_l2cap_rx_fn *rx_cb;
     struct os_mbuf *rx_buf;
     uint16_t conn_handle;
+    uint16_t rx_cid;
     int reject_cid;
     int rc;
 
@@ -641,13 +646,20 @@ ble_hs_hci_evt_acl_process(struct os_mbuf *om)
 
     conn_handle = BLE_HCI_DATA_HANDLE(hci_hdr.hdh_handle_pb_bc);
 
+    /* The packet occupies a host buffer; owe the controller a credit */
+    ble_hs_hci_fc_acl_rxed(conn_handle);
+
     ble_hs_lock();
 
     conn = ble_hs_conn_find(conn_handle);
     if (conn == NULL) {
         rc = BLE_HS_ENOTCONN;
     } else {
-        rc = ble_l2cap_rx(conn, &hci_hdr, om, &rx_cb, &rx_buf, &reject_cid);
+#if MYNEWT_VAL(BLE_GAP_AUTOTUNE)
+        conn->bhc_at_pkts++;
+#endif
+        rc = ble_l2cap_rx(conn, &hci_hdr, om, &rx_cb, &rx_cid, &rx_buf,
+                          &reject_cid);
         om = NULL;
     }
 
@@ -658,7 +670,7 @@ ble_hs_hci_evt_acl_process(struct os_mbuf *om)
         /* Final fragment received. */
         BLE_HS_DBG_ASSERT(rx_cb != NULL);
         BLE_HS_DBG_ASSERT(rx_buf != NULL);
-        rc = rx_cb(conn_handle, &rx_buf);
+        rc = rx_cb(conn_handle, rx_cid, &rx_buf);
         os_mbuf_free_chain(rx_buf);
         break;
 
@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 struct ble_hs_conn;
+struct ble_gap_white_entry;
 struct os_mbuf;
 
 struct ble_hs_hci_ack {
@@ -42,6 +43,13 @@ int ble_hs_hci_cmd_tx_empty_ack(void *cmd);
 void ble_hs_hci_rx_ack(uint8_t *ack_ev);
 void ble_hs_hci_init(void);
 
+#if MYNEWT_VAL(BLE_HS_FLOW_CTRL)
+int ble_hs_hci_fc_startup(void);
+void ble_hs_hci_fc_acl_rxed(uint16_t conn_handle);
+#else
+#define ble_hs_hci_fc_acl_rxed(conn_handle)     ((void)(conn_handle))
+#endif
+
 #if MYNEWT_VAL(BLE_HS_PHONY_HCI_ACKS)
 typedef int ble_hs_hci_phony_ack_fn(uint8_t *ack, int ack_buf_len);
 void ble_hs_hci_set_phony_ack_cb(ble_hs_hci_phony_ack_fn *cb);
@@ -68,6 +76,11 @@ void ble_hs_hci_cmd_build_set_event_mask(uint64_t event_mask,
                                          uint8_t *dst, int dst_len);
 void ble_hs_hci_cmd_build_set_event_mask2(uint64_t event_mask, uint8_t *dst,
                                           int dst_len);
+void ble_hs_hci_cmd_build_ctlr_to_host_fc(uint8_t fc_enable,
+                                          uint8_t *dst, int dst_len);
+void ble_hs_hci_cmd_build_host_buf_size(uint16_t acl_pkt_len,
+                                        uint16_t acl_num_pkts,
+                                        uint8_t *dst, int dst_len);
 void ble_hs_hci_cmd_build_disconnect(uint16_t handle, uint8_t reason,
                                      uint8_t *dst, int dst_len);
 int ble_hs_hci_cmd_disconnect(uint16_t handle, uint8_t reason);
@@ -105,6 +118,9 @@ void ble_hs_hci_cmd_build_le_clear_whitelist(uint8_t *dst, int dst_len);
 int ble_hs_hci_cmd_build_le_add_to_whitelist(const uint8_t *addr,
                                              uint8_t addr_type,
                                              uint8_t *dst, int dst_len);
+int ble_hs_hci_cmd_build_wl_bulk_set(
+    const struct ble_gap_white_entry *white_list, uint8_t white_list_count,
+    uint8_t *dst, int dst_len);
 void ble_hs_hci_cmd_build_reset(uint8_t *dst, int dst_len);
 int ble_hs_hci_cmd_reset(void);
 void ble_hs_hci_cmd_build_read_adv_pwr(uint8_t *dst, int dst_len);
@@ -134,6 +150,10 @@ uint16_t ble_hs_hci_util_handle_pb_bc_join(uint16_t handle, uint8_t pb,
                                            uint8_t bc);
 
 int ble_hs_hci_acl_tx(struct ble_hs_conn *connection, struct os_mbuf *txom);
+#if MYNEWT_VAL(BLE_HS_ACL_TX_QUEUE)
+void ble_hs_hci_acl_pkts_completed(uint16_t conn_handle, uint16_t num_pkts);
+void ble_hs_hci_acl_purge(struct ble_hs_conn *conn);
+#endif
 
 int ble_hs_hci_cmd_build_set_data_len(uint16_t connection_handle,
                                       uint16_t tx_octets, uint16_t tx_time,
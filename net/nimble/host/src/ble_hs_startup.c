@@ -250,6 +250,13 @@ ble_hs_startup_go(void)
         return rc;
     }
 
+#if MYNEWT_VAL(BLE_HS_FLOW_CTRL)
+    rc = ble_hs_hci_fc_startup();
+    if (rc != 0) {
+        return rc;
+    }
+#endif
+
     ble_hs_pvcy_set_our_irk(NULL);
 
     return 0;
@@ -75,6 +75,11 @@ ble_l2cap_chan_free(struct ble_l2cap_chan *chan)
         return;
     }
 
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+    os_mbuf_free_chain(chan->blc_coc_rx_sdu);
+    os_mbuf_free_chain(chan->blc_coc_tx_sdu);
+#endif
+
     rc = os_memblock_put(&ble_l2cap_chan_pool, chan);
     BLE_HS_DBG_ASSERT_EVAL(rc == 0);
 
@@ -155,7 +160,8 @@ ble_l2cap_discard_rx(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan)
 static int
 ble_l2cap_rx_payload(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan,
                      struct os_mbuf *om,
-                     ble_l2cap_rx_fn **out_rx_cb, struct os_mbuf **out_rx_buf)
+                     ble_l2cap_rx_fn **out_rx_cb, uint16_t *out_rx_cid,
+                     struct os_mbuf **out_rx_buf)
 {
     int len_diff;
     int rc;
@@ -175,6 +181,7 @@ ble_l2cap_rx_payload(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan,
     } else if (len_diff == 0) {
         /* All fragments received. */
         *out_rx_cb = chan->blc_rx_fn;
+        *out_rx_cid = chan->blc_cid;
         *out_rx_buf = chan->blc_rx_buf;
         ble_l2cap_forget_rx(conn, chan);
         rc = 0;
@@ -203,6 +210,10 @@ ble_l2cap_rx_payload(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan,
  *                                  pointer to the appropriate handler gets
  *                                  written here.  The caller should pass the
  *                                  receive buffer to this callback.
+ * @param out_rx_cid            If a full L2CAP packet has been received, the
+ *                                  ID of the channel it arrived on gets
+ *                                  written here.  The caller should pass this
+ *                                  to the receive handler (out_rx_cb).
  * @param out_rx_buf            If a full L2CAP packet has been received, this
  *                                  will point to the entire L2CAP packet.  To
  *                                  process the packet, pass this buffer to the
@@ -223,6 +234,7 @@ ble_l2cap_rx(struct ble_hs_conn *conn,
              struct hci_data_hdr *hci_hdr,
              struct os_mbuf *om,
              ble_l2cap_rx_fn **out_rx_cb,
+             uint16_t *out_rx_cid,
              struct os_mbuf **out_rx_buf,
              int *out_reject_cid)
 {
@@ -285,7 +297,8 @@ ble_l2cap_rx(struct ble_hs_conn *conn,
         goto err;
     }
 
-    rc = ble_l2cap_rx_payload(conn, chan, om, out_rx_cb, out_rx_buf);
+    rc = ble_l2cap_rx_payload(conn, chan, om, out_rx_cb, out_rx_cid,
+                              out_rx_buf);
     om = NULL;
     if (rc != 0) {
         goto err;
@@ -343,6 +356,13 @@ ble_l2cap_init(void)
         return rc;
     }
 
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+    rc = ble_l2cap_coc_init();
+    if (rc != 0) {
+        return rc;
+    }
+#endif
+
     rc = ble_sm_init();
     if (rc != 0) {
         return rc;
@@ -0,0 +1,656 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * L2CAP LE credit-based connection-oriented channels.
+ *
+ * This file implements the data path for dynamically allocated channels:
+ * SDU reassembly on receive, SDU segmentation on transmit, and credit
+ * accounting for both directions.  The signalling procedures that open and
+ * close these channels live in ble_l2cap_sig.c.
+ *
+ * Received LE-frames are accumulated into a single mbuf chain per SDU; no
+ * payload bytes are copied during reassembly.  When the final frame arrives,
+ * the chain is handed to the application, which assumes ownership.  Credits
+ * are replenished in one batch per delivered SDU rather than per frame, so a
+ * large SDU costs one flow-control packet instead of one per segment.
+ *
+ * Notes on thread-safety: application callbacks are never executed while the
+ * ble_hs mutex is locked.  Channel state is only modified while the mutex is
+ * held.
+ */
+
+#include <string.h>
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+
+#include "os/os.h"
+#include "nimble/ble.h"
+#include "ble_hs_priv.h"
+
+#define BLE_L2CAP_COC_CID_END   \
+    (BLE_L2CAP_COC_CID_START + MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM))
+
+struct ble_l2cap_coc_srv {
+    STAILQ_ENTRY(ble_l2cap_coc_srv) next;
+    uint16_t psm;
+    uint16_t mtu;
+    ble_l2cap_event_fn *cb;
+    void *cb_arg;
+};
+
+static STAILQ_HEAD(, ble_l2cap_coc_srv) ble_l2cap_coc_srvs;
+
+static os_membuf_t ble_l2cap_coc_srv_mem[
+    OS_MEMPOOL_SIZE(MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM),
+                    sizeof (struct ble_l2cap_coc_srv))
+];
+
+static struct os_mempool ble_l2cap_coc_srv_pool;
+
+/**
+ * Calculates the number of credits to grant a peer on a newly opened
+ * channel: enough LE-frames for two maximum-size SDUs, so the peer never
+ * stalls while a replenishment is in flight.
+ */
+uint16_t
+ble_l2cap_coc_initial_credits(uint16_t mtu, uint16_t mps)
+{
+    uint32_t credits;
+
+    credits = (mtu + BLE_L2CAP_COC_SDU_HDR_SZ + mps - 1) / mps * 2;
+    if (credits > 0xffff) {
+        credits = 0xffff;
+    }
+
+    return credits;
+}
+
+int
+ble_l2cap_coc_event_call(struct ble_l2cap_chan *chan,
+                         struct ble_l2cap_event *event)
+{
+    BLE_HS_DBG_ASSERT(!ble_hs_locked_by_cur_task());
+
+    if (chan->blc_coc_cb == NULL) {
+        return 0;
+    }
+
+    return chan->blc_coc_cb(event, chan->blc_coc_cb_arg);
+}
+
+/**
+ * Searches the server list for an entry registered for the specified PSM.
+ *
+ * @return                      0 on success; BLE_HS_ENOENT if no server is
+ *                                  listening on the PSM.
+ */
+int
+ble_l2cap_coc_srv_find(uint16_t psm, uint16_t *out_mtu,
+                       ble_l2cap_event_fn **out_cb, void **out_cb_arg)
+{
+    struct ble_l2cap_coc_srv *srv;
+    int rc;
+
+    rc = BLE_HS_ENOENT;
+
+    ble_hs_lock();
+
+    STAILQ_FOREACH(srv, &ble_l2cap_coc_srvs, next) {
+        if (srv->psm == psm) {
+            *out_mtu = srv->mtu;
+            *out_cb = srv->cb;
+            *out_cb_arg = srv->cb_arg;
+            rc = 0;
+            break;
+        }
+    }
+
+    ble_hs_unlock();
+
+    return rc;
+}
+
+/**
+ * Registers a server that accepts incoming credit-based connections on the
+ * specified PSM.  When a peer opens a channel, the callback receives a
+ * BLE_L2CAP_EVENT_COC_ACCEPT event; returning 0 accepts the channel.
+ *
+ * @param psm                   The protocol/service multiplexer to listen on.
+ * @param mtu                   The maximum SDU size this server can receive.
+ * @param cb                    The callback to execute for channel events.
+ * @param cb_arg                An optional argument to pass to the callback.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+ble_l2cap_create_server(uint16_t psm, uint16_t mtu,
+                        ble_l2cap_event_fn *cb, void *cb_arg)
+{
+    struct ble_l2cap_coc_srv *srv;
+    uint16_t old_mtu;
+    ble_l2cap_event_fn *old_cb;
+    void *old_cb_arg;
+    int rc;
+
+    if (psm == 0 || mtu == 0 || cb == NULL) {
+        return BLE_HS_EINVAL;
+    }
+
+    rc = ble_l2cap_coc_srv_find(psm, &old_mtu, &old_cb, &old_cb_arg);
+    if (rc == 0) {
+        return BLE_HS_EALREADY;
+    }
+
+    srv = os_memblock_get(&ble_l2cap_coc_srv_pool);
+    if (srv == NULL) {
+        return BLE_HS_ENOMEM;
+    }
+
+    srv->psm = psm;
+    srv->mtu = mtu;
+    srv->cb = cb;
+    srv->cb_arg = cb_arg;
+
+    ble_hs_lock();
+    STAILQ_INSERT_TAIL(&ble_l2cap_coc_srvs, srv, next);
+    ble_hs_unlock();
+
+    return 0;
+}
+
+/**
+ * Finds an unused dynamic CID on the specified connection.  CIDs are unique
+ * per connection in LE, so the search only consults the connection's own
+ * channel list.
+ *
+ * @return                      A free CID on success; 0 if all dynamic CIDs
+ *                                  are in use.
+ */
+static uint16_t
+ble_l2cap_coc_cid_alloc(struct ble_hs_conn *conn)
+{
+    uint16_t cid;
+
+    for (cid = BLE_L2CAP_COC_CID_START; cid < BLE_L2CAP_COC_CID_END; cid++) {
+        if (ble_hs_conn_chan_find(conn, cid) == NULL) {
+            return cid;
+        }
+    }
+
+    return 0;
+}
+
+static int ble_l2cap_coc_rx(uint16_t conn_handle, uint16_t cid,
+                            struct os_mbuf **rxom);
+
+/**
+ * Allocates a connection-oriented channel and inserts it into the specified
+ * connection's channel list.  The caller must fill in the peer's parameters
+ * (CID, MTU, MPS, credits) when they become known.
+ *
+ * Lock restrictions: requires the ble_hs mutex to be locked.
+ *
+ * @return                      The new channel on success; null on failure.
+ */
+struct ble_l2cap_chan *
+ble_l2cap_coc_chan_open(struct ble_hs_conn *conn, uint16_t psm, uint16_t mtu,
+                        ble_l2cap_event_fn *cb, void *cb_arg)
+{
+    struct ble_l2cap_chan *chan;
+    uint16_t cid;
+    int rc;
+
+    cid = ble_l2cap_coc_cid_alloc(conn);
+    if (cid == 0) {
+        return NULL;
+    }
+
+    chan = ble_l2cap_chan_alloc();
+    if (chan == NULL) {
+        return NULL;
+    }
+
+    chan->blc_cid = cid;
+    chan->blc_my_mtu = mtu;
+    chan->blc_default_mtu = mtu;
+    chan->blc_flags |= BLE_L2CAP_CHAN_F_COC;
+    chan->blc_rx_fn = ble_l2cap_coc_rx;
+
+    chan->blc_coc_conn_handle = conn->bhc_handle;
+    chan->blc_coc_psm = psm;
+    chan->blc_coc_my_mps = MYNEWT_VAL(BLE_L2CAP_COC_MPS);
+    chan->blc_coc_rx_credits =
+        ble_l2cap_coc_initial_credits(mtu, chan->blc_coc_my_mps);
+    chan->blc_coc_cb = cb;
+    chan->blc_coc_cb_arg = cb_arg;
+
+    rc = ble_hs_conn_chan_insert(conn, chan);
+    if (rc != 0) {
+        ble_l2cap_chan_free(chan);
+        return NULL;
+    }
+
+    return chan;
+}
+
+/**
+ * Removes the specified channel from its connection's channel list without
+ * freeing it.  A no-op if the connection no longer exists.
+ */
+void
+ble_l2cap_coc_chan_detach(uint16_t conn_handle, struct ble_l2cap_chan *chan)
+{
+    struct ble_hs_conn *conn;
+
+    ble_hs_lock();
+
+    conn = ble_hs_conn_find(conn_handle);
+    if (conn != NULL) {
+        if (conn->bhc_rx_chan == chan) {
+            conn->bhc_rx_chan = NULL;
+        }
+        SLIST_REMOVE(&conn->bhc_channels, chan, ble_l2cap_chan, blc_next);
+    }
+
+    ble_hs_unlock();
+}
+
+/**
+ * Transmits as much of the channel's pending SDU as the available credits
+ * allow.  Each iteration sends one LE-frame of at most the peer's MPS.
+ *
+ * Lock restrictions: requires the ble_hs mutex to be locked.
+ *
+ * @return                      1 if the pending SDU was fully transmitted;
+ *                              0 if transmission stalled awaiting credits;
+ *                              Other nonzero on error (the SDU is dropped).
+ */
+static int
+ble_l2cap_coc_tx_resume(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan)
+{
+    struct os_mbuf *txom;
+    uint16_t frag_len;
+    int rc;
+
+    while (chan->blc_coc_tx_sdu != NULL && chan->blc_coc_tx_credits > 0) {
+        frag_len = min(OS_MBUF_PKTLEN(chan->blc_coc_tx_sdu),
+                       chan->blc_coc_peer_mps);
+
+        txom = ble_hs_mbuf_l2cap_pkt();
+        if (txom == NULL) {
+            rc = BLE_HS_ENOMEM;
+            goto err;
+        }
+
+        rc = os_mbuf_appendfrom(txom, chan->blc_coc_tx_sdu, 0, frag_len);
+        if (rc != 0) {
+            os_mbuf_free_chain(txom);
+            rc = BLE_HS_ENOMEM;
+            goto err;
+        }
+
+        txom = ble_l2cap_prepend_hdr(txom, chan->blc_coc_peer_cid, frag_len);
+        if (txom == NULL) {
+            rc = BLE_HS_ENOMEM;
+            goto err;
+        }
+
+        rc = ble_hs_hci_acl_tx(conn, txom);
+        if (rc != 0) {
+            goto err;
+        }
+
+        os_mbuf_adj(chan->blc_coc_tx_sdu, frag_len);
+        chan->blc_coc_tx_credits--;
+
+        if (OS_MBUF_PKTLEN(chan->blc_coc_tx_sdu) == 0) {
+            os_mbuf_free_chain(chan->blc_coc_tx_sdu);
+            chan->blc_coc_tx_sdu = NULL;
+            return 1;
+        }
+    }
+
+    return 0;
+
+err:
+    os_mbuf_free_chain(chan->blc_coc_tx_sdu);
+    chan->blc_coc_tx_sdu = NULL;
+    return rc;
+}
+
+/**
+ * Transmits an SDU over a connection-oriented channel.  The SDU gets
+ * segmented into LE-frames sized to the peer's MPS; frames that cannot be
+ * sent immediately due to lack of credits remain queued and go out when the
+ * peer grants more credits.  A BLE_L2CAP_EVENT_COC_TX_COMPLETE event is
+ * reported when the full SDU has been handed to the controller.
+ *
+ * Ownership of the supplied mbuf passes to the host unless BLE_HS_EBUSY or
+ * BLE_HS_EMSGSIZE is returned, in which case the caller retains it.
+ *
+ * @param chan                  The channel to transmit over.
+ * @param sdu_tx                The SDU to transmit.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EBUSY if a previous SDU is still being
+ *                                  transmitted;
+ *                              BLE_HS_EMSGSIZE if the SDU exceeds the peer's
+ *                                  MTU;
+ *                              Other nonzero on error.
+ */
+int
+ble_l2cap_send(struct ble_l2cap_chan *chan, struct os_mbuf *sdu_tx)
+{
+    struct ble_hs_conn *conn;
+    uint16_t conn_handle;
+    uint16_t sdu_len;
+    int done;
+
+    conn_handle = chan->blc_coc_conn_handle;
+    sdu_len = OS_MBUF_PKTLEN(sdu_tx);
+
+    if (sdu_len > chan->blc_peer_mtu) {
+        return BLE_HS_EMSGSIZE;
+    }
+
+    ble_hs_lock();
+
+    conn = ble_hs_conn_find(conn_handle);
+    if (conn == NULL) {
+        ble_hs_unlock();
+        os_mbuf_free_chain(sdu_tx);
+        return BLE_HS_ENOTCONN;
+    }
+
+    if (chan->blc_coc_tx_sdu != NULL) {
+        ble_hs_unlock();
+        return BLE_HS_EBUSY;
+    }
+
+    /* The first LE-frame of an SDU starts with the total SDU length. */
+    sdu_tx = os_mbuf_prepend_pullup(sdu_tx, BLE_L2CAP_COC_SDU_HDR_SZ);
+    if (sdu_tx == NULL) {
+        ble_hs_unlock();
+        return BLE_HS_ENOMEM;
+    }
+    htole16(sdu_tx->om_data, sdu_len);
+
+    chan->blc_coc_tx_sdu = sdu_tx;
+    done = ble_l2cap_coc_tx_resume(conn, chan);
+
+    ble_hs_unlock();
+
+    if (done != 0) {
+        struct ble_l2cap_event event;
+
+        memset(&event, 0, sizeof event);
+        event.type = BLE_L2CAP_EVENT_COC_TX_COMPLETE;
+        event.tx_complete.status = done == 1 ? 0 : done;
+        event.tx_complete.conn_handle = conn_handle;
+        event.tx_complete.chan = chan;
+        ble_l2cap_coc_event_call(chan, &event);
+    }
+
+    return 0;
+}
+
+/**
+ * Processes an incoming flow-control credit packet.  Newly granted credits
+ * may allow a stalled SDU transmission to proceed.
+ *
+ * @param conn_handle           The connection the credits arrived on.
+ * @param peer_cid              The peer's CID for the channel (i.e., the CID
+ *                                  we transmit to).
+ * @param credits               The number of additional LE-frames the peer
+ *                                  can accept.
+ */
+void
+ble_l2cap_coc_credits_rx(uint16_t conn_handle, uint16_t peer_cid,
+                         uint16_t credits)
+{
+    struct ble_l2cap_chan *chan;
+    struct ble_l2cap_chan *found;
+    struct ble_hs_conn *conn;
+    uint32_t sum;
+    int done;
+
+    found = NULL;
+    done = 0;
+
+    ble_hs_lock();
+
+    conn = ble_hs_conn_find(conn_handle);
+    if (conn != NULL) {
+        SLIST_FOREACH(chan, &conn->bhc_channels, blc_next) {
+            if (chan->blc_flags & BLE_L2CAP_CHAN_F_COC &&
+                chan->blc_coc_peer_cid == peer_cid) {
+
+                found = chan;
+                break;
+            }
+        }
+    }
+
+    if (found != NULL) {
+        sum = found->blc_coc_tx_credits + credits;
+        if (sum > 0xffff) {
+            sum = 0xffff;
+        }
+        found->blc_coc_tx_credits = sum;
+
+        done = ble_l2cap_coc_tx_resume(conn, found);
+    }
+
+    ble_hs_unlock();
+
+    if (found == NULL) {
+        BLE_HS_LOG(DEBUG, "rx credits on unknown L2CAP channel: %d\n",
+                   peer_cid);
+        return;
+    }
+
+    if (done != 0) {
+        struct ble_l2cap_event event;
+
+        memset(&event, 0, sizeof event);
+        event.type = BLE_L2CAP_EVENT_COC_TX_COMPLETE;
+        event.tx_complete.status = done == 1 ? 0 : done;
+        event.tx_complete.conn_handle = conn_handle;
+        event.tx_complete.chan = found;
+        ble_l2cap_coc_event_call(found, &event);
+    }
+}
+
+/**
+ * Processes one received LE-frame.  The frame's payload is linked into the
+ * channel's reassembly chain without copying; when the SDU is complete, the
+ * chain is delivered to the application and the peer's credits are topped
+ * back up in a single batch.
+ */
+static int
+ble_l2cap_coc_rx(uint16_t conn_handle, uint16_t cid, struct os_mbuf **rxom)
+{
+    struct ble_l2cap_chan *chan;
+    struct ble_hs_conn *conn;
+    struct os_mbuf *sdu;
+    struct os_mbuf *om;
+    uint16_t sdu_len;
+    uint16_t grant;
+    int rc;
+
+    sdu = NULL;
+    grant = 0;
+
+    /* Take ownership of the receive buffer so the mbuf chain can be handed
+     * to the application without a copy.
+     */
+    om = *rxom;
+    *rxom = NULL;
+
+    ble_hs_lock();
+
+    rc = ble_hs_misc_conn_chan_find(conn_handle, cid, &conn, &chan);
+    if (rc != 0) {
+        goto err;
+    }
+    if (!(chan->blc_flags & BLE_L2CAP_CHAN_F_COC)) {
+        rc = BLE_HS_ENOENT;
+        goto err;
+    }
+
+    if (chan->blc_coc_rx_credits > 0) {
+        chan->blc_coc_rx_credits--;
+    }
+
+    if (chan->blc_coc_rx_sdu == NULL) {
+        /* First LE-frame of an SDU; starts with the total SDU length. */
+        if (OS_MBUF_PKTLEN(om) < BLE_L2CAP_COC_SDU_HDR_SZ) {
+            rc = BLE_HS_EBADDATA;
+            goto err;
+        }
+        os_mbuf_copydata(om, 0, sizeof sdu_len, &sdu_len);
+        sdu_len = le16toh(&sdu_len);
+        os_mbuf_adj(om, BLE_L2CAP_COC_SDU_HDR_SZ);
+
+        if (sdu_len > chan->blc_my_mtu) {
+            rc = BLE_HS_EBADDATA;
+            goto err;
+        }
+
+        chan->blc_coc_rx_sdu = om;
+        chan->blc_coc_rx_sdu_len = sdu_len;
+    } else {
+        os_mbuf_concat(chan->blc_coc_rx_sdu, om);
+    }
+    om = NULL;
+
+    if (OS_MBUF_PKTLEN(chan->blc_coc_rx_sdu) > chan->blc_coc_rx_sdu_len) {
+        /* More data than the SDU length indicated; peer error. */
+        os_mbuf_free_chain(chan->blc_coc_rx_sdu);
+        chan->blc_coc_rx_sdu = NULL;
+        rc = BLE_HS_EBADDATA;
+        goto err;
+    }
+
+    if (OS_MBUF_PKTLEN(chan->blc_coc_rx_sdu) == chan->blc_coc_rx_sdu_len) {
+        /* SDU complete; detach it and replenish the peer's credits. */
+        sdu = chan->blc_coc_rx_sdu;
+        chan->blc_coc_rx_sdu = NULL;
+
+        grant = ble_l2cap_coc_initial_credits(chan->blc_my_mtu,
+                                              chan->blc_coc_my_mps) -
+                chan->blc_coc_rx_credits;
+        chan->blc_coc_rx_credits += grant;
+    }
+
+    ble_hs_unlock();
+
+    if (grant > 0) {
+        ble_l2cap_sig_coc_credits_tx(conn_handle, cid, grant);
+    }
+
+    if (sdu != NULL) {
+        struct ble_l2cap_event event;
+
+        memset(&event, 0, sizeof event);
+        event.type = BLE_L2CAP_EVENT_COC_DATA_RECEIVED;
+        event.receive.conn_handle = conn_handle;
+        event.receive.chan = chan;
+        event.receive.sdu_rx = sdu;
+        ble_l2cap_coc_event_call(chan, &event);
+    }
+
+    return 0;
+
+err:
+    ble_hs_unlock();
+    os_mbuf_free_chain(om);
+    return rc;
+}
+
+/**
+ * Indicates the termination of the specified connection to the applications
+ * that own its connection-oriented channels, then frees the channels.
+ */
+void
+ble_l2cap_coc_conn_broken(uint16_t conn_handle)
+{
+    struct ble_l2cap_event event;
+    struct ble_l2cap_chan *chan;
+    struct ble_hs_conn *conn;
+
+    while (1) {
+        chan = NULL;
+
+        ble_hs_lock();
+
+        conn = ble_hs_conn_find(conn_handle);
+        if (conn != NULL) {
+            SLIST_FOREACH(chan, &conn->bhc_channels, blc_next) {
+                if (chan->blc_flags & BLE_L2CAP_CHAN_F_COC) {
+                    break;
+                }
+            }
+            if (chan != NULL) {
+                if (conn->bhc_rx_chan == chan) {
+                    conn->bhc_rx_chan = NULL;
+                }
+                SLIST_REMOVE(&conn->bhc_channels, chan, ble_l2cap_chan,
+                             blc_next);
+            }
+        }
+
+        ble_hs_unlock();
+
+        if (chan == NULL) {
+            return;
+        }
+
+        memset(&event, 0, sizeof event);
+        event.type = BLE_L2CAP_EVENT_COC_DISCONNECTED;
+        event.disconnect.conn_handle = conn_handle;
+        event.disconnect.chan = chan;
+        ble_l2cap_coc_event_call(chan, &event);
+
+        ble_l2cap_chan_free(chan);
+    }
+}
+
+int
+ble_l2cap_coc_init(void)
+{
+    int rc;
+
+    STAILQ_INIT(&ble_l2cap_coc_srvs);
+
+    rc = os_mempool_init(&ble_l2cap_coc_srv_pool,
+                         MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM),
+                         sizeof (struct ble_l2cap_coc_srv),
+                         ble_l2cap_coc_srv_mem,
+                         "ble_l2cap_coc_srv_pool");
+    if (rc != 0) {
+        return BLE_HS_EOS;
+    }
+
+    return 0;
+}
+
+#endif /* MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0 */
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_L2CAP_COC_
+#define H_BLE_L2CAP_COC_
+
+#include <inttypes.h>
+#include "syscfg/syscfg.h"
+#include "host/ble_l2cap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ble_hs_conn;
+struct ble_l2cap_chan;
+
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+
+/** Size of the SDU length field at the start of the first LE-frame. */
+#define BLE_L2CAP_COC_SDU_HDR_SZ        2
+
+int ble_l2cap_coc_srv_find(uint16_t psm, uint16_t *out_mtu,
+                           ble_l2cap_event_fn **out_cb, void **out_cb_arg);
+struct ble_l2cap_chan *ble_l2cap_coc_chan_open(struct ble_hs_conn *conn,
+                                               uint16_t psm, uint16_t mtu,
+                                               ble_l2cap_event_fn *cb,
+                                               void *cb_arg);
+void ble_l2cap_coc_chan_detach(uint16_t conn_handle,
+                               struct ble_l2cap_chan *chan);
+uint16_t ble_l2cap_coc_initial_credits(uint16_t mtu, uint16_t mps);
+void ble_l2cap_coc_credits_rx(uint16_t conn_handle, uint16_t peer_cid,
+                              uint16_t credits);
+int ble_l2cap_coc_event_call(struct ble_l2cap_chan *chan,
+                             struct ble_l2cap_event *event);
+void ble_l2cap_coc_conn_broken(uint16_t conn_handle);
+int ble_l2cap_coc_init(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -61,7 +61,8 @@ extern struct os_mempool ble_l2cap_chan_pool;
 
 typedef uint8_t ble_l2cap_chan_flags;
 
-typedef int ble_l2cap_rx_fn(uint16_t conn_handle, struct os_mbuf **rxom);
+typedef int ble_l2cap_rx_fn(uint16_t conn_handle, uint16_t cid,
+                            struct os_mbuf **rxom);
 
 struct ble_l2cap_chan {
     SLIST_ENTRY(ble_l2cap_chan) blc_next;
@@ -75,6 +76,26 @@ struct ble_l2cap_chan {
     uint16_t blc_rx_len;        /* Length of current reassembled rx packet. */
 
     ble_l2cap_rx_fn *blc_rx_fn;
+
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+    /* Connection-oriented channel state; unused on fixed channels.  The
+     * blc_my_mtu and blc_peer_mtu fields above hold the maximum SDU sizes.
+     */
+    uint16_t blc_coc_conn_handle;
+    uint16_t blc_coc_psm;
+    uint16_t blc_coc_peer_cid;
+    uint16_t blc_coc_my_mps;
+    uint16_t blc_coc_peer_mps;
+    uint16_t blc_coc_tx_credits;    /* LE-frames we may still send. */
+    uint16_t blc_coc_rx_credits;    /* LE-frames the peer may still send. */
+
+    struct os_mbuf *blc_coc_rx_sdu; /* SDU being reassembled from K-frames. */
+    uint16_t blc_coc_rx_sdu_len;    /* Expected length of current rx SDU. */
+    struct os_mbuf *blc_coc_tx_sdu; /* SDU awaiting credits to transmit. */
+
+    ble_l2cap_event_fn *blc_coc_cb;
+    void *blc_coc_cb_arg;
+#endif
 };
 
 struct ble_l2cap_hdr {
@@ -86,6 +107,7 @@ typedef int ble_l2cap_tx_fn(struct ble_hs_conn *conn,
                             struct ble_l2cap_chan *chan);
 
 #define BLE_L2CAP_CHAN_F_TXED_MTU       0x01    /* We have sent our MTU. */
+#define BLE_L2CAP_CHAN_F_COC            0x02    /* Connection-oriented chan. */
 
 SLIST_HEAD(ble_l2cap_chan_list, ble_l2cap_chan);
 
@@ -104,6 +126,7 @@ int ble_l2cap_rx(struct ble_hs_conn *conn,
                  struct hci_data_hdr *hci_hdr,
                  struct os_mbuf *om,
                  ble_l2cap_rx_fn **out_rx_cb,
+                 uint16_t *out_rx_cid,
                  struct os_mbuf **out_rx_buf,
                  int *out_reject_cid);
 int ble_l2cap_tx(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan,
@@ -55,7 +55,9 @@
 #define BLE_L2CAP_SIG_UNRESPONSIVE_TIMEOUT      30000   /* Milliseconds. */
 
 #define BLE_L2CAP_SIG_PROC_OP_UPDATE            0
-#define BLE_L2CAP_SIG_PROC_OP_MAX               1
+#define BLE_L2CAP_SIG_PROC_OP_CONNECT           1
+#define BLE_L2CAP_SIG_PROC_OP_DISCONNECT        2
+#define BLE_L2CAP_SIG_PROC_OP_MAX               3
 
 struct ble_l2cap_sig_proc {
     STAILQ_ENTRY(ble_l2cap_sig_proc) next;
@@ -70,6 +72,14 @@ struct ble_l2cap_sig_proc {
             ble_l2cap_sig_update_fn *cb;
             void *cb_arg;
         } update;
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+        struct {
+            struct ble_l2cap_chan *chan;
+        } connect;
+        struct {
+            struct ble_l2cap_chan *chan;
+        } disconnect;
+#endif
     };
 };
 
@@ -84,12 +94,18 @@ typedef int ble_l2cap_sig_rx_fn(uint16_t conn_handle,
 static ble_l2cap_sig_rx_fn ble_l2cap_sig_rx_noop;
 static ble_l2cap_sig_rx_fn ble_l2cap_sig_update_req_rx;
 static ble_l2cap_sig_rx_fn ble_l2cap_sig_update_rsp_rx;
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+static ble_l2cap_sig_rx_fn ble_l2cap_sig_credit_connect_req_rx;
+static ble_l2cap_sig_rx_fn ble_l2cap_sig_credit_connect_rsp_rx;
+static ble_l2cap_sig_rx_fn ble_l2cap_sig_flow_ctrl_credit_rx;
+static ble_l2cap_sig_rx_fn ble_l2cap_sig_disconn_req_rx;
+static ble_l2cap_sig_rx_fn ble_l2cap_sig_disconn_rsp_rx;
+#endif
 
 static ble_l2cap_sig_rx_fn * const ble_l2cap_sig_dispatch[] = {
     [BLE_L2CAP_SIG_OP_REJECT]               = ble_l2cap_sig_rx_noop,
     [BLE_L2CAP_SIG_OP_CONNECT_RSP]          = ble_l2cap_sig_rx_noop,
     [BLE_L2CAP_SIG_OP_CONFIG_RSP]           = ble_l2cap_sig_rx_noop,
-    [BLE_L2CAP_SIG_OP_DISCONN_RSP]          = ble_l2cap_sig_rx_noop,
     [BLE_L2CAP_SIG_OP_ECHO_RSP]             = ble_l2cap_sig_rx_noop,
     [BLE_L2CAP_SIG_OP_INFO_RSP]             = ble_l2cap_sig_rx_noop,
     [BLE_L2CAP_SIG_OP_CREATE_CHAN_RSP]      = ble_l2cap_sig_rx_noop,
@@ -97,7 +113,19 @@ static ble_l2cap_sig_rx_fn * const ble_l2cap_sig_dispatch[] = {
     [BLE_L2CAP_SIG_OP_MOVE_CHAN_CONF_RSP]   = ble_l2cap_sig_rx_noop,
     [BLE_L2CAP_SIG_OP_UPDATE_REQ]           = ble_l2cap_sig_update_req_rx,
     [BLE_L2CAP_SIG_OP_UPDATE_RSP]           = ble_l2cap_sig_update_rsp_rx,
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+    [BLE_L2CAP_SIG_OP_DISCONN_REQ]          = ble_l2cap_sig_disconn_req_rx,
+    [BLE_L2CAP_SIG_OP_DISCONN_RSP]          = ble_l2cap_sig_disconn_rsp_rx,
+    [BLE_L2CAP_SIG_OP_CREDIT_CONNECT_REQ]   =
+        ble_l2cap_sig_credit_connect_req_rx,
+    [BLE_L2CAP_SIG_OP_CREDIT_CONNECT_RSP]   =
+        ble_l2cap_sig_credit_connect_rsp_rx,
+    [BLE_L2CAP_SIG_OP_FLOW_CTRL_CREDIT]     =
+        ble_l2cap_sig_flow_ctrl_credit_rx,
+#else
+    [BLE_L2CAP_SIG_OP_DISCONN_RSP]          = ble_l2cap_sig_rx_noop,
     [BLE_L2CAP_SIG_OP_CREDIT_CONNECT_RSP]   = ble_l2cap_sig_rx_noop,
+#endif
 };
 
 static uint8_t ble_l2cap_sig_cur_id;
@@ -475,8 +503,437 @@ done:
     return rc;
 }
 
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+/*****************************************************************************
+ * $connection oriented channels                                             *
+ *****************************************************************************/
+
+/**
+ * Reports the outcome of a connect procedure to the application.  The chan
+ * argument is null if the channel was torn down before the procedure
+ * completed.
+ */
+static void
+ble_l2cap_sig_coc_connect_event(uint16_t conn_handle, int status,
+                                struct ble_l2cap_chan *chan,
+                                ble_l2cap_event_fn *cb, void *cb_arg)
+{
+    struct ble_l2cap_event event;
+
+    BLE_HS_DBG_ASSERT(!ble_hs_locked_by_cur_task());
+
+    if (cb == NULL) {
+        return;
+    }
+
+    memset(&event, 0, sizeof event);
+    event.type = BLE_L2CAP_EVENT_COC_CONNECTED;
+    event.connect.status = status;
+    event.connect.conn_handle = conn_handle;
+    event.connect.chan = chan;
+    cb(&event, cb_arg);
+}
+
+/**
+ * Fails an in-progress connect procedure: frees the half-open channel and
+ * reports the failure to the application.
+ */
+static void
+ble_l2cap_sig_coc_connect_fail(struct ble_l2cap_sig_proc *proc, int status)
+{
+    struct ble_l2cap_chan *chan;
+    ble_l2cap_event_fn *cb;
+    void *cb_arg;
+
+    chan = proc->connect.chan;
+    cb = chan->blc_coc_cb;
+    cb_arg = chan->blc_coc_cb_arg;
+
+    ble_l2cap_coc_chan_detach(proc->conn_handle, chan);
+    ble_l2cap_chan_free(chan);
+
+    ble_l2cap_sig_coc_connect_event(proc->conn_handle, status, NULL,
+                                    cb, cb_arg);
+}
+
+/**
+ * Closes the specified channel: removes it from its connection, reports a
+ * disconnect event to the application, and frees it.
+ */
+static void
+ble_l2cap_sig_coc_chan_closed(uint16_t conn_handle,
+                              struct ble_l2cap_chan *chan)
+{
+    struct ble_l2cap_event event;
+
+    ble_l2cap_coc_chan_detach(conn_handle, chan);
+
+    memset(&event, 0, sizeof event);
+    event.type = BLE_L2CAP_EVENT_COC_DISCONNECTED;
+    event.disconnect.conn_handle = conn_handle;
+    event.disconnect.chan = chan;
+    ble_l2cap_coc_event_call(chan, &event);
+
+    ble_l2cap_chan_free(chan);
+}
+
+/**
+ * Transmits a flow-control credit packet granting the peer additional
+ * LE-frames on the specified channel.
+ */
+int
+ble_l2cap_sig_coc_credits_tx(uint16_t conn_handle, uint16_t cid,
+                             uint16_t credits)
+{
+    struct ble_l2cap_sig_flow_ctrl_credit cmd;
+
+    cmd.cid = cid;
+    cmd.credits = credits;
+
+    return ble_l2cap_sig_flow_ctrl_credit_tx(conn_handle,
+                                             ble_l2cap_sig_next_id(), &cmd);
+}
+
+/**
+ * Initiates an LE credit-based connection to the specified peer's PSM.  The
+ * result is reported via a BLE_L2CAP_EVENT_COC_CONNECTED event.
+ *
+ * @param conn_handle           The connection to open the channel over.
+ * @param psm                   The protocol/service multiplexer to connect
+ *                                  to.
+ * @param mtu                   The maximum SDU size we can receive.
+ * @param cb                    The callback to execute for channel events.
+ * @param cb_arg                An optional argument to pass to the callback.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+ble_l2cap_connect(uint16_t conn_handle, uint16_t psm, uint16_t mtu,
+                  ble_l2cap_event_fn *cb, void *cb_arg)
+{
+    struct ble_l2cap_sig_credit_connect_req req;
+    struct ble_l2cap_sig_proc *proc;
+    struct ble_l2cap_chan *chan;
+    struct ble_hs_conn *conn;
+    int rc;
+
+    if (psm == 0 || mtu == 0 || cb == NULL) {
+        return BLE_HS_EINVAL;
+    }
+
+    proc = ble_l2cap_sig_proc_alloc();
+    if (proc == NULL) {
+        return BLE_HS_ENOMEM;
+    }
+
+    ble_hs_lock();
+    conn = ble_hs_conn_find(conn_handle);
+    if (conn == NULL) {
+        chan = NULL;
+        rc = BLE_HS_ENOTCONN;
+    } else {
+        chan = ble_l2cap_coc_chan_open(conn, psm, mtu, cb, cb_arg);
+        rc = chan == NULL ? BLE_HS_ENOMEM : 0;
+    }
+    ble_hs_unlock();
+
+    if (rc != 0) {
+        ble_l2cap_sig_proc_free(proc);
+        return rc;
+    }
+
+    proc->op = BLE_L2CAP_SIG_PROC_OP_CONNECT;
+    proc->id = ble_l2cap_sig_next_id();
+    proc->conn_handle = conn_handle;
+    proc->connect.chan = chan;
+
+    req.psm = psm;
+    req.scid = chan->blc_cid;
+    req.mtu = mtu;
+    req.mps = chan->blc_coc_my_mps;
+    req.credits = chan->blc_coc_rx_credits;
+
+    rc = ble_l2cap_sig_credit_connect_req_tx(conn_handle, proc->id, &req);
+    if (rc != 0) {
+        ble_l2cap_coc_chan_detach(conn_handle, chan);
+        ble_l2cap_chan_free(chan);
+    }
+
+    ble_l2cap_sig_process_status(proc, rc);
+    return rc;
+}
+
+/**
+ * Closes a connection-oriented channel.  The result is reported via a
+ * BLE_L2CAP_EVENT_COC_DISCONNECTED event; the channel pointer remains valid
+ * until that event has been delivered.
+ *
+ * @param chan                  The channel to close.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+ble_l2cap_disconnect(struct ble_l2cap_chan *chan)
+{
+    struct ble_l2cap_sig_disconn_req req;
+    struct ble_l2cap_sig_proc *proc;
+    uint16_t conn_handle;
+    int rc;
+
+    conn_handle = chan->blc_coc_conn_handle;
+
+    proc = ble_l2cap_sig_proc_alloc();
+    if (proc == NULL) {
+        return BLE_HS_ENOMEM;
+    }
+
+    proc->op = BLE_L2CAP_SIG_PROC_OP_DISCONNECT;
+    proc->id = ble_l2cap_sig_next_id();
+    proc->conn_handle = conn_handle;
+    proc->disconnect.chan = chan;
+
+    req.dcid = chan->blc_coc_peer_cid;
+    req.scid = chan->blc_cid;
+
+    rc = ble_l2cap_sig_disconn_req_tx(conn_handle, proc->id, &req);
+
+    ble_l2cap_sig_process_status(proc, rc);
+    return rc;
+}
+
+static int
+ble_l2cap_sig_credit_connect_req_rx(uint16_t conn_handle,
+                                    struct ble_l2cap_sig_hdr *hdr,
+                                    struct os_mbuf **om)
+{
+    struct ble_l2cap_sig_credit_connect_req req;
+    struct ble_l2cap_sig_credit_connect_rsp rsp;
+    struct ble_l2cap_event event;
+    struct ble_l2cap_chan *chan;
+    struct ble_hs_conn *conn;
+    ble_l2cap_event_fn *cb;
+    void *cb_arg;
+    uint16_t mtu;
+    int rc;
+
+    memset(&rsp, 0, sizeof rsp);
+
+    rc = ble_hs_mbuf_pullup_base(om, BLE_L2CAP_SIG_CREDIT_CONNECT_REQ_SZ);
+    if (rc != 0) {
+        return rc;
+    }
+    ble_l2cap_sig_credit_connect_req_parse((*om)->om_data, (*om)->om_len,
+                                           &req);
+
+    rc = ble_l2cap_coc_srv_find(req.psm, &mtu, &cb, &cb_arg);
+    if (rc != 0) {
+        rsp.result = BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_RESULT_NO_PSM;
+        return ble_l2cap_sig_credit_connect_rsp_tx(conn_handle,
+                                                   hdr->identifier, &rsp);
+    }
+
+    chan = NULL;
+
+    ble_hs_lock();
+    conn = ble_hs_conn_find(conn_handle);
+    if (conn != NULL) {
+        chan = ble_l2cap_coc_chan_open(conn, req.psm, mtu, cb, cb_arg);
+        if (chan != NULL) {
+            chan->blc_coc_peer_cid = req.scid;
+            chan->blc_peer_mtu = req.mtu;
+            chan->blc_coc_peer_mps = req.mps;
+            chan->blc_coc_tx_credits = req.credits;
+        }
+    }
+    ble_hs_unlock();
+
+    if (chan == NULL) {
+        rsp.result = BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_RESULT_NO_RESOURCES;
+        return ble_l2cap_sig_credit_connect_rsp_tx(conn_handle,
+                                                   hdr->identifier, &rsp);
+    }
+
+    /* Ask the application whether to accept the channel. */
+    memset(&event, 0, sizeof event);
+    event.type = BLE_L2CAP_EVENT_COC_ACCEPT;
+    event.accept.conn_handle = conn_handle;
+    event.accept.peer_sdu_size = req.mtu;
+    event.accept.chan = chan;
+    rc = ble_l2cap_coc_event_call(chan, &event);
+    if (rc != 0) {
+        ble_l2cap_coc_chan_detach(conn_handle, chan);
+        ble_l2cap_chan_free(chan);
+
+        rsp.result = BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_RESULT_NO_RESOURCES;
+        return ble_l2cap_sig_credit_connect_rsp_tx(conn_handle,
+                                                   hdr->identifier, &rsp);
+    }
+
+    rsp.dcid = chan->blc_cid;
+    rsp.mtu = chan->blc_my_mtu;
+    rsp.mps = chan->blc_coc_my_mps;
+    rsp.credits = chan->blc_coc_rx_credits;
+    rsp.result = BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_RESULT_SUCCESS;
+
+    rc = ble_l2cap_sig_credit_connect_rsp_tx(conn_handle, hdr->identifier,
+                                             &rsp);
+    if (rc != 0) {
+        ble_l2cap_coc_chan_detach(conn_handle, chan);
+        ble_l2cap_chan_free(chan);
+        return rc;
+    }
+
+    ble_l2cap_sig_coc_connect_event(conn_handle, 0, chan,
+                                    chan->blc_coc_cb, chan->blc_coc_cb_arg);
+    return 0;
+}
+
 static int
-ble_l2cap_sig_rx(uint16_t conn_handle, struct os_mbuf **om)
+ble_l2cap_sig_credit_connect_rsp_rx(uint16_t conn_handle,
+                                    struct ble_l2cap_sig_hdr *hdr,
+                                    struct os_mbuf **om)
+{
+    struct ble_l2cap_sig_credit_connect_rsp rsp;
+    struct ble_l2cap_sig_proc *proc;
+    struct ble_l2cap_chan *chan;
+    ble_l2cap_event_fn *cb;
+    void *cb_arg;
+    int status;
+    int rc;
+
+    proc = ble_l2cap_sig_proc_extract(conn_handle,
+                                      BLE_L2CAP_SIG_PROC_OP_CONNECT,
+                                      hdr->identifier);
+    if (proc == NULL) {
+        return BLE_HS_ENOENT;
+    }
+
+    chan = proc->connect.chan;
+    cb = chan->blc_coc_cb;
+    cb_arg = chan->blc_coc_cb_arg;
+
+    rc = ble_hs_mbuf_pullup_base(om, BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_SZ);
+    if (rc != 0) {
+        status = rc;
+        goto done;
+    }
+
+    ble_l2cap_sig_credit_connect_rsp_parse((*om)->om_data, (*om)->om_len,
+                                           &rsp);
+
+    if (rsp.result != BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_RESULT_SUCCESS) {
+        status = BLE_HS_EREJECT;
+        goto done;
+    }
+
+    ble_hs_lock();
+    chan->blc_coc_peer_cid = rsp.dcid;
+    chan->blc_peer_mtu = rsp.mtu;
+    chan->blc_coc_peer_mps = rsp.mps;
+    chan->blc_coc_tx_credits = rsp.credits;
+    ble_hs_unlock();
+
+    status = 0;
+
+done:
+    if (status != 0) {
+        ble_l2cap_coc_chan_detach(conn_handle, chan);
+        ble_l2cap_chan_free(chan);
+        chan = NULL;
+    }
+    ble_l2cap_sig_coc_connect_event(conn_handle, status, chan, cb, cb_arg);
+    ble_l2cap_sig_proc_free(proc);
+    return 0;
+}
+
+static int
+ble_l2cap_sig_flow_ctrl_credit_rx(uint16_t conn_handle,
+                                  struct ble_l2cap_sig_hdr *hdr,
+                                  struct os_mbuf **om)
+{
+    struct ble_l2cap_sig_flow_ctrl_credit cmd;
+    int rc;
+
+    rc = ble_hs_mbuf_pullup_base(om, BLE_L2CAP_SIG_FLOW_CTRL_CREDIT_SZ);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_l2cap_sig_flow_ctrl_credit_parse((*om)->om_data, (*om)->om_len, &cmd);
+
+    ble_l2cap_coc_credits_rx(conn_handle, cmd.cid, cmd.credits);
+    return 0;
+}
+
+static int
+ble_l2cap_sig_disconn_req_rx(uint16_t conn_handle,
+                             struct ble_l2cap_sig_hdr *hdr,
+                             struct os_mbuf **om)
+{
+    struct ble_l2cap_sig_disconn_req req;
+    struct ble_l2cap_sig_disconn_rsp rsp;
+    struct ble_l2cap_chan *chan;
+    struct ble_hs_conn *conn;
+    int rc;
+
+    rc = ble_hs_mbuf_pullup_base(om, BLE_L2CAP_SIG_DISCONN_REQ_SZ);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_l2cap_sig_disconn_req_parse((*om)->om_data, (*om)->om_len, &req);
+
+    ble_hs_lock();
+    conn = ble_hs_conn_find(conn_handle);
+    if (conn == NULL) {
+        chan = NULL;
+    } else {
+        chan = ble_hs_conn_chan_find(conn, req.dcid);
+        if (chan != NULL &&
+            (!(chan->blc_flags & BLE_L2CAP_CHAN_F_COC) ||
+             chan->blc_coc_peer_cid != req.scid)) {
+
+            chan = NULL;
+        }
+    }
+    ble_hs_unlock();
+
+    if (chan == NULL) {
+        ble_l2cap_sig_reject_invalid_cid_tx(conn_handle, hdr->identifier,
+                                            req.scid, req.dcid);
+        return BLE_HS_ENOENT;
+    }
+
+    rsp.dcid = req.dcid;
+    rsp.scid = req.scid;
+    ble_l2cap_sig_disconn_rsp_tx(conn_handle, hdr->identifier, &rsp);
+
+    ble_l2cap_sig_coc_chan_closed(conn_handle, chan);
+    return 0;
+}
+
+static int
+ble_l2cap_sig_disconn_rsp_rx(uint16_t conn_handle,
+                             struct ble_l2cap_sig_hdr *hdr,
+                             struct os_mbuf **om)
+{
+    struct ble_l2cap_sig_proc *proc;
+
+    proc = ble_l2cap_sig_proc_extract(conn_handle,
+                                      BLE_L2CAP_SIG_PROC_OP_DISCONNECT,
+                                      hdr->identifier);
+    if (proc == NULL) {
+        return BLE_HS_ENOENT;
+    }
+
+    ble_l2cap_sig_coc_chan_closed(conn_handle, proc->disconnect.chan);
+    ble_l2cap_sig_proc_free(proc);
+    return 0;
+}
+#endif /* MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0 */
+
+static int
+ble_l2cap_sig_rx(uint16_t conn_handle, uint16_t cid, struct os_mbuf **om)
 {
     struct ble_l2cap_sig_hdr hdr;
     ble_l2cap_sig_rx_fn *rx_cb;
@@ -598,6 +1055,28 @@ ble_l2cap_sig_conn_broken(uint16_t conn_handle, int reason)
         ble_l2cap_sig_update_call_cb(proc, reason);
         ble_l2cap_sig_proc_free(proc);
     }
+
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+    /* Fail each connect procedure that was awaiting a response.  This frees
+     * the half-open channels so that ble_l2cap_coc_conn_broken() only
+     * reports disconnects for channels the application knew about.
+     */
+    while ((proc = ble_l2cap_sig_proc_extract(
+                conn_handle, BLE_L2CAP_SIG_PROC_OP_CONNECT, 0)) != NULL) {
+
+        ble_l2cap_sig_coc_connect_fail(proc, reason);
+        ble_l2cap_sig_proc_free(proc);
+    }
+
+    /* Channels awaiting a disconnect response get reported by
+     * ble_l2cap_coc_conn_broken(); only the procedure entries need freeing.
+     */
+    while ((proc = ble_l2cap_sig_proc_extract(
+                conn_handle, BLE_L2CAP_SIG_PROC_OP_DISCONNECT, 0)) != NULL) {
+
+        ble_l2cap_sig_proc_free(proc);
+    }
+#endif
 }
 
 /**
@@ -622,7 +1101,28 @@ ble_l2cap_sig_timer(void)
     /* Report a failure for each timed out procedure. */
     while ((proc = STAILQ_FIRST(&temp_list)) != NULL) {
         STATS_INC(ble_l2cap_stats, proc_timeout);
-        ble_l2cap_sig_update_call_cb(proc, BLE_HS_ETIMEOUT);
+
+        switch (proc->op) {
+        case BLE_L2CAP_SIG_PROC_OP_UPDATE:
+            ble_l2cap_sig_update_call_cb(proc, BLE_HS_ETIMEOUT);
+            break;
+
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+        case BLE_L2CAP_SIG_PROC_OP_CONNECT:
+            ble_l2cap_sig_coc_connect_fail(proc, BLE_HS_ETIMEOUT);
+            break;
+
+        case BLE_L2CAP_SIG_PROC_OP_DISCONNECT:
+            /* No response from the peer; close the channel locally. */
+            ble_l2cap_sig_coc_chan_closed(proc->conn_handle,
+                                          proc->disconnect.chan);
+            break;
+#endif
+
+        default:
+            BLE_HS_DBG_ASSERT(0);
+            break;
+        }
 
         STAILQ_REMOVE_HEAD(&temp_list, next);
         ble_l2cap_sig_proc_free(proc);
@@ -224,6 +224,224 @@ ble_l2cap_sig_update_req_tx(uint16_t conn_handle, uint8_t id,
     return 0;
 }
 
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+static void
+ble_l2cap_sig_credit_connect_req_swap(
+    struct ble_l2cap_sig_credit_connect_req *dst,
+    struct ble_l2cap_sig_credit_connect_req *src)
+{
+    dst->psm = TOFROMLE16(src->psm);
+    dst->scid = TOFROMLE16(src->scid);
+    dst->mtu = TOFROMLE16(src->mtu);
+    dst->mps = TOFROMLE16(src->mps);
+    dst->credits = TOFROMLE16(src->credits);
+}
+
+void
+ble_l2cap_sig_credit_connect_req_parse(
+    void *payload, int len, struct ble_l2cap_sig_credit_connect_req *dst)
+{
+    BLE_HS_DBG_ASSERT(len >= BLE_L2CAP_SIG_CREDIT_CONNECT_REQ_SZ);
+    ble_l2cap_sig_credit_connect_req_swap(dst, payload);
+}
+
+int
+ble_l2cap_sig_credit_connect_req_tx(
+    uint16_t conn_handle, uint8_t id,
+    struct ble_l2cap_sig_credit_connect_req *req)
+{
+    struct os_mbuf *txom;
+    void *payload_buf;
+    int rc;
+
+    rc = ble_l2cap_sig_init_cmd(BLE_L2CAP_SIG_OP_CREDIT_CONNECT_REQ, id,
+                                BLE_L2CAP_SIG_CREDIT_CONNECT_REQ_SZ, &txom,
+                                &payload_buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_l2cap_sig_credit_connect_req_swap(payload_buf, req);
+
+    rc = ble_l2cap_sig_tx(conn_handle, txom);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+
+static void
+ble_l2cap_sig_credit_connect_rsp_swap(
+    struct ble_l2cap_sig_credit_connect_rsp *dst,
+    struct ble_l2cap_sig_credit_connect_rsp *src)
+{
+    dst->dcid = TOFROMLE16(src->dcid);
+    dst->mtu = TOFROMLE16(src->mtu);
+    dst->mps = TOFROMLE16(src->mps);
+    dst->credits = TOFROMLE16(src->credits);
+    dst->result = TOFROMLE16(src->result);
+}
+
+void
+ble_l2cap_sig_credit_connect_rsp_parse(
+    void *payload, int len, struct ble_l2cap_sig_credit_connect_rsp *dst)
+{
+    BLE_HS_DBG_ASSERT(len >= BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_SZ);
+    ble_l2cap_sig_credit_connect_rsp_swap(dst, payload);
+}
+
+int
+ble_l2cap_sig_credit_connect_rsp_tx(
+    uint16_t conn_handle, uint8_t id,
+    struct ble_l2cap_sig_credit_connect_rsp *rsp)
+{
+    struct os_mbuf *txom;
+    void *payload_buf;
+    int rc;
+
+    rc = ble_l2cap_sig_init_cmd(BLE_L2CAP_SIG_OP_CREDIT_CONNECT_RSP, id,
+                                BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_SZ, &txom,
+                                &payload_buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_l2cap_sig_credit_connect_rsp_swap(payload_buf, rsp);
+
+    rc = ble_l2cap_sig_tx(conn_handle, txom);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+
+static void
+ble_l2cap_sig_flow_ctrl_credit_swap(
+    struct ble_l2cap_sig_flow_ctrl_credit *dst,
+    struct ble_l2cap_sig_flow_ctrl_credit *src)
+{
+    dst->cid = TOFROMLE16(src->cid);
+    dst->credits = TOFROMLE16(src->credits);
+}
+
+void
+ble_l2cap_sig_flow_ctrl_credit_parse(
+    void *payload, int len, struct ble_l2cap_sig_flow_ctrl_credit *dst)
+{
+    BLE_HS_DBG_ASSERT(len >= BLE_L2CAP_SIG_FLOW_CTRL_CREDIT_SZ);
+    ble_l2cap_sig_flow_ctrl_credit_swap(dst, payload);
+}
+
+int
+ble_l2cap_sig_flow_ctrl_credit_tx(uint16_t conn_handle, uint8_t id,
+                                  struct ble_l2cap_sig_flow_ctrl_credit *cmd)
+{
+    struct os_mbuf *txom;
+    void *payload_buf;
+    int rc;
+
+    rc = ble_l2cap_sig_init_cmd(BLE_L2CAP_SIG_OP_FLOW_CTRL_CREDIT, id,
+                                BLE_L2CAP_SIG_FLOW_CTRL_CREDIT_SZ, &txom,
+                                &payload_buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_l2cap_sig_flow_ctrl_credit_swap(payload_buf, cmd);
+
+    rc = ble_l2cap_sig_tx(conn_handle, txom);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+
+static void
+ble_l2cap_sig_disconn_req_swap(struct ble_l2cap_sig_disconn_req *dst,
+                               struct ble_l2cap_sig_disconn_req *src)
+{
+    dst->dcid = TOFROMLE16(src->dcid);
+    dst->scid = TOFROMLE16(src->scid);
+}
+
+void
+ble_l2cap_sig_disconn_req_parse(void *payload, int len,
+                                struct ble_l2cap_sig_disconn_req *dst)
+{
+    BLE_HS_DBG_ASSERT(len >= BLE_L2CAP_SIG_DISCONN_REQ_SZ);
+    ble_l2cap_sig_disconn_req_swap(dst, payload);
+}
+
+int
+ble_l2cap_sig_disconn_req_tx(uint16_t conn_handle, uint8_t id,
+                             struct ble_l2cap_sig_disconn_req *req)
+{
+    struct os_mbuf *txom;
+    void *payload_buf;
+    int rc;
+
+    rc = ble_l2cap_sig_init_cmd(BLE_L2CAP_SIG_OP_DISCONN_REQ, id,
+                                BLE_L2CAP_SIG_DISCONN_REQ_SZ, &txom,
+                                &payload_buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_l2cap_sig_disconn_req_swap(payload_buf, req);
+
+    rc = ble_l2cap_sig_tx(conn_handle, txom);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+
+static void
+ble_l2cap_sig_disconn_rsp_swap(struct ble_l2cap_sig_disconn_rsp *dst,
+                               struct ble_l2cap_sig_disconn_rsp *src)
+{
+    dst->dcid = TOFROMLE16(src->dcid);
+    dst->scid = TOFROMLE16(src->scid);
+}
+
+void
+ble_l2cap_sig_disconn_rsp_parse(void *payload, int len,
+                                struct ble_l2cap_sig_disconn_rsp *dst)
+{
+    BLE_HS_DBG_ASSERT(len >= BLE_L2CAP_SIG_DISCONN_RSP_SZ);
+    ble_l2cap_sig_disconn_rsp_swap(dst, payload);
+}
+
+int
+ble_l2cap_sig_disconn_rsp_tx(uint16_t conn_handle, uint8_t id,
+                             struct ble_l2cap_sig_disconn_rsp *rsp)
+{
+    struct os_mbuf *txom;
+    void *payload_buf;
+    int rc;
+
+    rc = ble_l2cap_sig_init_cmd(BLE_L2CAP_SIG_OP_DISCONN_RSP, id,
+                                BLE_L2CAP_SIG_DISCONN_RSP_SZ, &txom,
+                                &payload_buf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_l2cap_sig_disconn_rsp_swap(payload_buf, rsp);
+
+    rc = ble_l2cap_sig_tx(conn_handle, txom);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return 0;
+}
+#endif /* MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0 */
+
 static void
 ble_l2cap_sig_update_rsp_swap(struct ble_l2cap_sig_update_rsp *dst,
                               struct ble_l2cap_sig_update_rsp *src)
@@ -20,6 +20,8 @@
 #ifndef H_BLE_L2CAP_SIG_
 #define H_BLE_L2CAP_SIG_
 
+#include "syscfg/syscfg.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -54,6 +56,46 @@ struct ble_l2cap_sig_update_rsp {
 #define BLE_L2CAP_SIG_UPDATE_RSP_RESULT_ACCEPT  0x0000
 #define BLE_L2CAP_SIG_UPDATE_RSP_RESULT_REJECT  0x0001
 
+#define BLE_L2CAP_SIG_CREDIT_CONNECT_REQ_SZ     10
+struct ble_l2cap_sig_credit_connect_req {
+    uint16_t psm;
+    uint16_t scid;
+    uint16_t mtu;
+    uint16_t mps;
+    uint16_t credits;
+} __attribute__((packed));
+
+#define BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_SZ     10
+struct ble_l2cap_sig_credit_connect_rsp {
+    uint16_t dcid;
+    uint16_t mtu;
+    uint16_t mps;
+    uint16_t credits;
+    uint16_t result;
+} __attribute__((packed));
+
+#define BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_RESULT_SUCCESS         0x0000
+#define BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_RESULT_NO_PSM          0x0002
+#define BLE_L2CAP_SIG_CREDIT_CONNECT_RSP_RESULT_NO_RESOURCES    0x0004
+
+#define BLE_L2CAP_SIG_FLOW_CTRL_CREDIT_SZ       4
+struct ble_l2cap_sig_flow_ctrl_credit {
+    uint16_t cid;
+    uint16_t credits;
+} __attribute__((packed));
+
+#define BLE_L2CAP_SIG_DISCONN_REQ_SZ            4
+struct ble_l2cap_sig_disconn_req {
+    uint16_t dcid;
+    uint16_t scid;
+} __attribute__((packed));
+
+#define BLE_L2CAP_SIG_DISCONN_RSP_SZ            4
+struct ble_l2cap_sig_disconn_rsp {
+    uint16_t dcid;
+    uint16_t scid;
+} __attribute__((packed));
+
 int ble_l2cap_sig_init_cmd(uint8_t op, uint8_t id, uint8_t payload_len,
                            struct os_mbuf **out_om, void **out_payload_buf);
 void ble_l2cap_sig_hdr_parse(void *payload, uint16_t len,
@@ -79,6 +121,35 @@ int ble_l2cap_sig_update_rsp_tx(uint16_t conn_handle, uint8_t id,
 int ble_l2cap_sig_reject_invalid_cid_tx(uint16_t conn_handle, uint8_t id,
                                         uint16_t src_cid, uint16_t dst_cid);
 
+#if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) != 0
+void ble_l2cap_sig_credit_connect_req_parse(
+    void *payload, int len, struct ble_l2cap_sig_credit_connect_req *dst);
+int ble_l2cap_sig_credit_connect_req_tx(
+    uint16_t conn_handle, uint8_t id,
+    struct ble_l2cap_sig_credit_connect_req *req);
+void ble_l2cap_sig_credit_connect_rsp_parse(
+    void *payload, int len, struct ble_l2cap_sig_credit_connect_rsp *dst);
+int ble_l2cap_sig_credit_connect_rsp_tx(
+    uint16_t conn_handle, uint8_t id,
+    struct ble_l2cap_sig_credit_connect_rsp *rsp);
+void ble_l2cap_sig_flow_ctrl_credit_parse(
+    void *payload, int len, struct ble_l2cap_sig_flow_ctrl_credit *dst);
+int ble_l2cap_sig_flow_ctrl_credit_tx(
+    uint16_t conn_handle, uint8_t id,
+    struct ble_l2cap_sig_flow_ctrl_credit *cmd);
+void ble_l2cap_sig_disconn_req_parse(void *payload, int len,
+                                     struct ble_l2cap_sig_disconn_req *dst);
+int ble_l2cap_sig_disconn_req_tx(uint16_t conn_handle, uint8_t id,
+                                 struct ble_l2cap_sig_disconn_req *req);
+void ble_l2cap_sig_disconn_rsp_parse(void *payload, int len,
+                                     struct ble_l2cap_sig_disconn_rsp *dst);
+int ble_l2cap_sig_disconn_rsp_tx(uint16_t conn_handle, uint8_t id,
+                                 struct ble_l2cap_sig_disconn_rsp *rsp);
+
+int ble_l2cap_sig_coc_credits_tx(uint16_t conn_handle, uint16_t cid,
+                                 uint16_t credits);
+#endif
+
 void ble_l2cap_sig_conn_broken(uint16_t conn_handle, int reason);
 int32_t ble_l2cap_sig_timer(void);
 struct ble_l2cap_chan *ble_l2cap_sig_create_chan(void);
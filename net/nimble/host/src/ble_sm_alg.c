@@ -183,6 +183,19 @@ done:
     return rc;
 }
 
+/**
+ * Optional hardware ECC driver.  When set, the security manager performs its
+ * P-256 operations via the driver instead of the bundled software
+ * implementation.
+ */
+static const struct ble_sm_ecc_driver *ble_sm_alg_ecc_driver;
+
+void
+ble_sm_ecc_driver_set(const struct ble_sm_ecc_driver *drv)
+{
+    ble_sm_alg_ecc_driver = drv;
+}
+
 #if MYNEWT_VAL(BLE_SM_SC)
 
 static void
@@ -424,6 +437,14 @@ ble_sm_alg_gen_dhkey(uint8_t *peer_pub_key_x, uint8_t *peer_pub_key_y,
     uint32_t dh[8];
     EccPoint pk;
 
+    if (ble_sm_alg_ecc_driver != NULL &&
+        ble_sm_alg_ecc_driver->gen_dhkey != NULL) {
+
+        return ble_sm_alg_ecc_driver->gen_dhkey(peer_pub_key_x,
+                                                peer_pub_key_y,
+                                                our_priv_key, out_dhkey);
+    }
+
     memcpy(pk.x, peer_pub_key_x, 32);
     memcpy(pk.y, peer_pub_key_y, 32);
 
@@ -457,6 +478,12 @@ ble_sm_alg_gen_key_pair(void *pub, uint32_t *priv)
     EccPoint pkey;
     int rc;
 
+    if (ble_sm_alg_ecc_driver != NULL &&
+        ble_sm_alg_ecc_driver->gen_key_pair != NULL) {
+
+        return ble_sm_alg_ecc_driver->gen_key_pair(pub, priv);
+    }
+
     do {
         rc = ble_hs_hci_util_rand(random, sizeof random);
         if (rc != 0) {
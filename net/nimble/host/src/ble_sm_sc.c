@@ -216,6 +216,213 @@ ble_sm_sc_initiator_txes_confirm(struct ble_sm_proc *proc)
            proc->pair_alg != BLE_SM_PAIR_ALG_NUMCMP;
 }
 
+/**
+ * Advances the supplied procedure after our DH key has been computed.  The
+ * caller must hold the host mutex.
+ */
+static void
+ble_sm_sc_public_key_advance(struct ble_sm_proc *proc,
+                             struct ble_sm_result *res)
+{
+    uint8_t ioact;
+
+    if (proc->flags & BLE_SM_PROC_F_INITIATOR) {
+        proc->state = BLE_SM_PROC_STATE_CONFIRM;
+
+        ioact = ble_sm_sc_io_action(proc);
+        if (ble_sm_ioact_state(ioact) == proc->state) {
+            res->passkey_params.action = ioact;
+        }
+
+        if (ble_sm_proc_can_advance(proc) &&
+            ble_sm_sc_initiator_txes_confirm(proc)) {
+
+            res->execute = 1;
+        }
+    } else {
+        res->execute = 1;
+    }
+}
+
+#if MYNEWT_VAL(BLE_SM_CRYPTO_ASYNC)
+
+static void ble_sm_sc_keygen_work_ev_cb(struct os_event *ev);
+static void ble_sm_sc_keygen_done_ev_cb(struct os_event *ev);
+static void ble_sm_sc_dhkey_work_ev_cb(struct os_event *ev);
+static void ble_sm_sc_dhkey_done_ev_cb(struct os_event *ev);
+
+/**
+ * State for the single in-flight DH key computation.  The host task fills the
+ * job and marks it busy; the worker task only touches the job while it is
+ * busy; the host task clears the busy flag after consuming the result.
+ */
+static struct {
+    uint16_t conn_handle;
+    uint8_t peer_pub_x[32];
+    uint8_t peer_pub_y[32];
+    uint8_t dhkey[32];
+    int rc;
+    uint8_t busy;
+} ble_sm_sc_crypto_job;
+
+/** Key pair generated in the background on startup. */
+static union {
+    uint32_t u32[16];
+    uint8_t u8[64];
+} ble_sm_sc_keygen_pub;
+static union {
+    uint32_t u32[8];
+    uint8_t u8[32];
+} ble_sm_sc_keygen_priv;
+static int ble_sm_sc_keygen_rc;
+
+static struct os_task ble_sm_sc_crypto_task;
+static struct os_eventq ble_sm_sc_crypto_evq;
+static os_stack_t ble_sm_sc_crypto_stack[
+    OS_STACK_ALIGN(MYNEWT_VAL(BLE_SM_CRYPTO_STACK_SIZE))];
+static uint8_t ble_sm_sc_crypto_task_started;
+
+/* Work events; these run on the crypto worker task. */
+static struct os_event ble_sm_sc_keygen_work_ev = {
+    .ev_cb = ble_sm_sc_keygen_work_ev_cb,
+};
+static struct os_event ble_sm_sc_dhkey_work_ev = {
+    .ev_cb = ble_sm_sc_dhkey_work_ev_cb,
+};
+
+/* Completion events; these run on the host parent task. */
+static struct os_event ble_sm_sc_keygen_done_ev = {
+    .ev_cb = ble_sm_sc_keygen_done_ev_cb,
+};
+static struct os_event ble_sm_sc_dhkey_done_ev = {
+    .ev_cb = ble_sm_sc_dhkey_done_ev_cb,
+};
+
+static void
+ble_sm_sc_crypto_task_handler(void *arg)
+{
+    while (1) {
+        os_eventq_run(&ble_sm_sc_crypto_evq);
+    }
+}
+
+static void
+ble_sm_sc_keygen_work_ev_cb(struct os_event *ev)
+{
+    ble_sm_sc_keygen_rc = ble_sm_alg_gen_key_pair(ble_sm_sc_keygen_pub.u8,
+                                                  ble_sm_sc_keygen_priv.u32);
+    ble_hs_event_enqueue(&ble_sm_sc_keygen_done_ev);
+}
+
+static void
+ble_sm_sc_keygen_done_ev_cb(struct os_event *ev)
+{
+    /* This runs on the host parent task, so it cannot race
+     * ble_sm_sc_ensure_keys_generated().  Discard the generated pair if a
+     * pairing procedure (or a debug override) beat us to it.
+     */
+    if (ble_sm_sc_keygen_rc != 0 || ble_sm_sc_keys_generated) {
+        return;
+    }
+#if MYNEWT_VAL(BLE_HS_DEBUG)
+    if (ble_sm_dbg_sc_keys_set) {
+        return;
+    }
+#endif
+
+    memcpy(ble_sm_sc_pub_key.u8, ble_sm_sc_keygen_pub.u8, 64);
+    memcpy(ble_sm_sc_priv_key.u8, ble_sm_sc_keygen_priv.u8, 32);
+    ble_sm_sc_keys_generated = 1;
+}
+
+static void
+ble_sm_sc_dhkey_work_ev_cb(struct os_event *ev)
+{
+    ble_sm_sc_crypto_job.rc =
+        ble_sm_alg_gen_dhkey(ble_sm_sc_crypto_job.peer_pub_x,
+                             ble_sm_sc_crypto_job.peer_pub_y,
+                             ble_sm_sc_priv_key.u32,
+                             ble_sm_sc_crypto_job.dhkey);
+    ble_hs_event_enqueue(&ble_sm_sc_dhkey_done_ev);
+}
+
+static void
+ble_sm_sc_dhkey_done_ev_cb(struct os_event *ev)
+{
+    struct ble_sm_result res;
+    struct ble_sm_proc *proc;
+    struct ble_sm_proc *prev;
+    uint16_t conn_handle;
+    int found;
+
+    conn_handle = ble_sm_sc_crypto_job.conn_handle;
+
+    memset(&res, 0, sizeof res);
+
+    ble_hs_lock();
+    proc = ble_sm_proc_find(conn_handle, BLE_SM_PROC_STATE_PUBLIC_KEY, -1,
+                            &prev);
+    if (proc == NULL || !(proc->flags & BLE_SM_PROC_F_DHKEY_PEND)) {
+        /* The procedure ended (e.g., disconnect) while the key was being
+         * computed.
+         */
+        found = 0;
+    } else {
+        found = 1;
+        proc->flags &= ~BLE_SM_PROC_F_DHKEY_PEND;
+        if (ble_sm_sc_crypto_job.rc != 0) {
+            res.app_status = BLE_HS_SM_US_ERR(BLE_SM_ERR_DHKEY);
+            res.sm_err = BLE_SM_ERR_DHKEY;
+            res.enc_cb = 1;
+        } else {
+            memcpy(proc->dhkey, ble_sm_sc_crypto_job.dhkey, 32);
+            ble_sm_sc_public_key_advance(proc, &res);
+        }
+    }
+    ble_hs_unlock();
+
+    ble_sm_sc_crypto_job.busy = 0;
+
+    if (found) {
+        ble_sm_process_result(conn_handle, &res);
+    }
+}
+
+/**
+ * Schedules the DH key computation for the supplied procedure on the crypto
+ * worker task.  The caller must hold the host mutex.
+ *
+ * @return                      1 if the computation was scheduled;
+ *                              0 if the caller must compute synchronously.
+ */
+static int
+ble_sm_sc_dhkey_sched(struct ble_sm_proc *proc)
+{
+    if (proc->flags & BLE_SM_PROC_F_INITIATOR) {
+        /* As initiator, the peer's confirm may already be queued behind the
+         * public key that prompted this computation; it would find the
+         * procedure in the wrong state if we advanced asynchronously.
+         */
+        return 0;
+    }
+
+    if (ble_sm_sc_crypto_job.busy) {
+        return 0;
+    }
+
+    ble_sm_sc_crypto_job.busy = 1;
+    ble_sm_sc_crypto_job.conn_handle = proc->conn_handle;
+    memcpy(ble_sm_sc_crypto_job.peer_pub_x, proc->pub_key_peer.x, 32);
+    memcpy(ble_sm_sc_crypto_job.peer_pub_y, proc->pub_key_peer.y, 32);
+    proc->flags |= BLE_SM_PROC_F_DHKEY_PEND;
+
+    os_eventq_put(&ble_sm_sc_crypto_evq, &ble_sm_sc_dhkey_work_ev);
+
+    return 1;
+}
+
+#endif /* MYNEWT_VAL(BLE_SM_CRYPTO_ASYNC) */
+
 /* Responder does not verify the initiator's random number when pairing
  * algorithm is any of:
  *     o just works
@@ -513,7 +720,6 @@ ble_sm_sc_public_key_rx(uint16_t conn_handle, uint8_t op, struct os_mbuf **om,
     struct ble_sm_public_key cmd;
     struct ble_sm_proc *proc;
     struct ble_sm_proc *prev;
-    uint8_t ioact;
     int rc;
 
     res->app_status = ble_hs_mbuf_pullup_base(om, BLE_SM_PUBLIC_KEY_SZ);
@@ -540,6 +746,15 @@ ble_sm_sc_public_key_rx(uint16_t conn_handle, uint8_t op, struct os_mbuf **om,
         res->sm_err = BLE_SM_ERR_UNSPECIFIED;
     } else {
         proc->pub_key_peer = cmd;
+
+#if MYNEWT_VAL(BLE_SM_CRYPTO_ASYNC)
+        if (ble_sm_sc_dhkey_sched(proc)) {
+            /* The result gets processed when the worker task completes. */
+            ble_hs_unlock();
+            return;
+        }
+#endif
+
         rc = ble_sm_alg_gen_dhkey(proc->pub_key_peer.x,
                                   proc->pub_key_peer.y,
                                   ble_sm_sc_priv_key.u32,
@@ -549,22 +764,7 @@ ble_sm_sc_public_key_rx(uint16_t conn_handle, uint8_t op, struct os_mbuf **om,
             res->sm_err = BLE_SM_ERR_DHKEY;
             res->enc_cb = 1;
         } else {
-            if (proc->flags & BLE_SM_PROC_F_INITIATOR) {
-                proc->state = BLE_SM_PROC_STATE_CONFIRM;
-
-                ioact = ble_sm_sc_io_action(proc);
-                if (ble_sm_ioact_state(ioact) == proc->state) {
-                    res->passkey_params.action = ioact;
-                }
-
-                if (ble_sm_proc_can_advance(proc) &&
-                    ble_sm_sc_initiator_txes_confirm(proc)) {
-
-                    res->execute = 1;
-                }
-            } else {
-                res->execute = 1;
-            }
+            ble_sm_sc_public_key_advance(proc, res);
         }
     }
     ble_hs_unlock();
@@ -743,7 +943,29 @@ ble_sm_sc_dhkey_check_rx(uint16_t conn_handle, uint8_t op, struct os_mbuf **om,
 void
 ble_sm_sc_init(void)
 {
+#if MYNEWT_VAL(BLE_SM_CRYPTO_ASYNC)
+    int rc;
+#endif
+
     ble_sm_sc_keys_generated = 0;
+
+#if MYNEWT_VAL(BLE_SM_CRYPTO_ASYNC)
+    if (!ble_sm_sc_crypto_task_started) {
+        os_eventq_init(&ble_sm_sc_crypto_evq);
+        rc = os_task_init(&ble_sm_sc_crypto_task, "ble_sm_crypto",
+                          ble_sm_sc_crypto_task_handler, NULL,
+                          MYNEWT_VAL(BLE_SM_CRYPTO_TASK_PRIO),
+                          OS_WAIT_FOREVER, ble_sm_sc_crypto_stack,
+                          OS_STACK_ALIGN(MYNEWT_VAL(BLE_SM_CRYPTO_STACK_SIZE)));
+        BLE_HS_DBG_ASSERT_EVAL(rc == 0);
+        ble_sm_sc_crypto_task_started = 1;
+    }
+
+    /* Pre-generate our key pair in the background so that the first pairing
+     * does not block the host task for the generation time.
+     */
+    os_eventq_put(&ble_sm_sc_crypto_evq, &ble_sm_sc_keygen_work_ev);
+#endif
 }
 
 #endif  /* MYNEWT_VAL(BLE_SM_SC) */
@@ -100,6 +100,35 @@ ble_uuid_16_to_128(uint16_t uuid16, void *out_uuid128)
     return 0;
 }
 
+/**
+ * Indicates whether two 128-bit UUIDs are identical.  The comparison is
+ * performed on four 32-bit words rather than byte-by-byte; this is
+ * noticeably faster than memcmp on the UUID-matching paths exercised during
+ * discovery of a large GATT database.
+ *
+ * @param uuid128_a             The first UUID to compare.  This must point to
+ *                                  16 contiguous bytes.
+ * @param uuid128_b             The second UUID to compare.  This must point
+ *                                  to 16 contiguous bytes.
+ *
+ * @return                      1 if the two UUIDs are equal; 0 otherwise.
+ */
+int
+ble_uuid_128_eq(const void *uuid128_a, const void *uuid128_b)
+{
+    uint32_t wa[4];
+    uint32_t wb[4];
+
+    /* The memcpys compile down to word loads when the operands are aligned;
+     * the UUIDs embedded in registered attributes always are.
+     */
+    memcpy(wa, uuid128_a, sizeof wa);
+    memcpy(wb, uuid128_b, sizeof wb);
+
+    return ((wa[0] ^ wb[0]) | (wa[1] ^ wb[1]) |
+            (wa[2] ^ wb[2]) | (wa[3] ^ wb[3])) == 0;
+}
+
 int
 ble_uuid_append(struct os_mbuf *om, const void *uuid128)
 {
@@ -0,0 +1,734 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * This file implements a flash-resident key database for BLE host security
+ * material and CCCDs, built on the flash circular buffer (fs/fcb).  Records
+ * are append-only; the newest record for a key wins.  An in-RAM index sorted
+ * by (object type, peer address, characteristic handle) maps each key to its
+ * flash location, so lookups at connection time are a binary search plus one
+ * flash read, independent of the number of bonded peers.  When the buffer
+ * fills up, the oldest sector is compacted: records that are still current
+ * get re-appended and the sector is erased.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+#include "fcb/fcb.h"
+#include "host/ble_hs.h"
+#include "store/fcb/ble_store_fcb.h"
+
+#define BLE_STORE_FCB_MAGIC     0xb1e5704e
+#define BLE_STORE_FCB_VERS      1
+
+#define BLE_STORE_FCB_MAX_ENTRIES   MYNEWT_VAL(BLE_STORE_FCB_MAX_ENTRIES)
+
+/** Representation of a record in flash. */
+struct ble_store_fcb_disk {
+    uint8_t type;       /* BLE_STORE_OBJ_TYPE_[...] */
+    uint8_t deleted;    /* 1 if this record is a tombstone. */
+    union ble_store_value val;
+};
+
+/**
+ * One element of the in-RAM index.  The key fields are duplicated here so
+ * that lookups only touch flash for the final value read.
+ */
+struct ble_store_fcb_idx_entry {
+    uint8_t obj_type;
+    uint8_t peer_addr_type;
+    uint8_t peer_addr[6];
+    uint16_t chr_val_handle;    /* CCCDs only; 0 for security material. */
+    uint16_t ediv;              /* Security material only. */
+    uint64_t rand_num;          /* Security material only. */
+    struct fcb_entry loc;
+};
+
+static struct ble_store_fcb_idx_entry
+    ble_store_fcb_idx[BLE_STORE_FCB_MAX_ENTRIES];
+static int ble_store_fcb_idx_count;
+
+static struct fcb *ble_store_fcb;
+
+/*****************************************************************************
+ * $index                                                                    *
+ *****************************************************************************/
+
+static int
+ble_store_fcb_idx_cmp(uint8_t obj_type, uint8_t peer_addr_type,
+                      const uint8_t *peer_addr, uint16_t chr_val_handle,
+                      const struct ble_store_fcb_idx_entry *entry)
+{
+    int rc;
+
+    if (obj_type != entry->obj_type) {
+        return obj_type < entry->obj_type ? -1 : 1;
+    }
+    if (peer_addr_type != entry->peer_addr_type) {
+        return peer_addr_type < entry->peer_addr_type ? -1 : 1;
+    }
+    rc = memcmp(peer_addr, entry->peer_addr, 6);
+    if (rc != 0) {
+        return rc;
+    }
+    if (chr_val_handle != entry->chr_val_handle) {
+        return chr_val_handle < entry->chr_val_handle ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Binary-searches the index for the specified key.
+ *
+ * @param out_idx               On return, the position of the matching entry,
+ *                                  or the position where it would get
+ *                                  inserted.
+ *
+ * @return                      1 if a matching entry was found; else 0.
+ */
+static int
+ble_store_fcb_idx_search(uint8_t obj_type, uint8_t peer_addr_type,
+                         const uint8_t *peer_addr, uint16_t chr_val_handle,
+                         int *out_idx)
+{
+    int lo;
+    int hi;
+    int mid;
+    int rc;
+
+    lo = 0;
+    hi = ble_store_fcb_idx_count;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        rc = ble_store_fcb_idx_cmp(obj_type, peer_addr_type, peer_addr,
+                                   chr_val_handle, ble_store_fcb_idx + mid);
+        if (rc == 0) {
+            *out_idx = mid;
+            return 1;
+        } else if (rc < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    *out_idx = lo;
+    return 0;
+}
+
+/**
+ * Extracts the index key fields from the specified record.
+ */
+static void
+ble_store_fcb_idx_fill(struct ble_store_fcb_idx_entry *entry,
+                       uint8_t obj_type, const union ble_store_value *val)
+{
+    memset(entry, 0, sizeof *entry);
+
+    entry->obj_type = obj_type;
+    switch (obj_type) {
+    case BLE_STORE_OBJ_TYPE_OUR_SEC:
+    case BLE_STORE_OBJ_TYPE_PEER_SEC:
+        entry->peer_addr_type = val->sec.peer_addr_type;
+        memcpy(entry->peer_addr, val->sec.peer_addr, 6);
+        entry->ediv = val->sec.ediv;
+        entry->rand_num = val->sec.rand_num;
+        break;
+
+    case BLE_STORE_OBJ_TYPE_CCCD:
+        entry->peer_addr_type = val->cccd.peer_addr_type;
+        memcpy(entry->peer_addr, val->cccd.peer_addr, 6);
+        entry->chr_val_handle = val->cccd.chr_val_handle;
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+ble_store_fcb_idx_remove(int idx)
+{
+    memmove(ble_store_fcb_idx + idx, ble_store_fcb_idx + idx + 1,
+            (ble_store_fcb_idx_count - idx - 1) * sizeof ble_store_fcb_idx[0]);
+    ble_store_fcb_idx_count--;
+}
+
+/**
+ * Inserts or updates the index entry for the specified record.
+ *
+ * @return                      0 on success; BLE_HS_ENOMEM if the index is
+ *                                  full.
+ */
+static int
+ble_store_fcb_idx_upsert(uint8_t obj_type, const union ble_store_value *val,
+                         const struct fcb_entry *loc)
+{
+    struct ble_store_fcb_idx_entry entry;
+    int found;
+    int idx;
+
+    ble_store_fcb_idx_fill(&entry, obj_type, val);
+    entry.loc = *loc;
+
+    found = ble_store_fcb_idx_search(entry.obj_type, entry.peer_addr_type,
+                                     entry.peer_addr, entry.chr_val_handle,
+                                     &idx);
+    if (!found) {
+        if (ble_store_fcb_idx_count >= BLE_STORE_FCB_MAX_ENTRIES) {
+            return BLE_HS_ENOMEM;
+        }
+
+        memmove(ble_store_fcb_idx + idx + 1, ble_store_fcb_idx + idx,
+                (ble_store_fcb_idx_count - idx) *
+                    sizeof ble_store_fcb_idx[0]);
+        ble_store_fcb_idx_count++;
+    }
+
+    ble_store_fcb_idx[idx] = entry;
+    return 0;
+}
+
+/*****************************************************************************
+ * $flash                                                                    *
+ *****************************************************************************/
+
+/**
+ * Reads the record at the specified flash location.
+ */
+static int
+ble_store_fcb_load(const struct fcb_entry *loc,
+                   struct ble_store_fcb_disk *disk)
+{
+    uint16_t len;
+    int rc;
+
+    memset(disk, 0, sizeof *disk);
+
+    len = loc->fe_data_len;
+    if (len > sizeof *disk) {
+        len = sizeof *disk;
+    }
+
+    rc = flash_area_read(loc->fe_area, loc->fe_data_off, disk, len);
+    if (rc != 0) {
+        return BLE_HS_EUNKNOWN;
+    }
+
+    return 0;
+}
+
+/**
+ * Appends the specified record to the flash circular buffer.  Does not
+ * attempt compaction; returns the raw fcb error on failure.
+ */
+static int
+ble_store_fcb_append(const struct ble_store_fcb_disk *disk,
+                     struct fcb_entry *out_loc)
+{
+    int rc;
+
+    rc = fcb_append(ble_store_fcb, sizeof *disk, out_loc);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = flash_area_write(out_loc->fe_area, out_loc->fe_data_off,
+                          disk, sizeof *disk);
+    if (rc != 0) {
+        return FCB_ERR_FLASH;
+    }
+
+    return fcb_append_finish(ble_store_fcb, out_loc);
+}
+
+/**
+ * Makes room in the flash circular buffer by erasing the oldest sector.
+ * Records in that sector that are still current get re-appended first, and
+ * their index entries updated; superseded records and tombstones are simply
+ * dropped.
+ */
+static int
+ble_store_fcb_compact(void)
+{
+    struct ble_store_fcb_disk disk;
+    struct ble_store_fcb_idx_entry *entry;
+    struct fcb_entry loc;
+    struct fcb_entry new_loc;
+    int rc;
+    int i;
+
+    /* Take the scratch sector into use so the re-appends below have room. */
+    rc = fcb_append_to_scratch(ble_store_fcb);
+    if (rc != 0) {
+        return BLE_HS_ENOMEM;
+    }
+
+    memset(&loc, 0, sizeof loc);
+    loc.fe_area = ble_store_fcb->f_oldest;
+
+    while (fcb_getnext(ble_store_fcb, &loc) == 0 &&
+           loc.fe_area == ble_store_fcb->f_oldest) {
+
+        /* Determine if this record is the current one for its key. */
+        entry = NULL;
+        for (i = 0; i < ble_store_fcb_idx_count; i++) {
+            if (ble_store_fcb_idx[i].loc.fe_area == loc.fe_area &&
+                ble_store_fcb_idx[i].loc.fe_data_off == loc.fe_data_off) {
+
+                entry = ble_store_fcb_idx + i;
+                break;
+            }
+        }
+        if (entry == NULL) {
+            continue;
+        }
+
+        rc = ble_store_fcb_load(&loc, &disk);
+        if (rc != 0) {
+            return rc;
+        }
+
+        rc = ble_store_fcb_append(&disk, &new_loc);
+        if (rc != 0) {
+            /* No room to relocate the record; give up rather than lose it. */
+            return BLE_HS_ENOMEM;
+        }
+
+        entry->loc = new_loc;
+    }
+
+    rc = fcb_rotate(ble_store_fcb);
+    if (rc != 0) {
+        return BLE_HS_EUNKNOWN;
+    }
+
+    return 0;
+}
+
+/**
+ * Appends the specified record, compacting the buffer as necessary.
+ */
+static int
+ble_store_fcb_write_rec(const struct ble_store_fcb_disk *disk,
+                        struct fcb_entry *out_loc)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < ble_store_fcb->f_sector_cnt; i++) {
+        rc = ble_store_fcb_append(disk, out_loc);
+        if (rc != FCB_ERR_NOSPACE) {
+            break;
+        }
+
+        rc = ble_store_fcb_compact();
+        if (rc != 0) {
+            return rc;
+        }
+        rc = BLE_HS_ENOMEM;
+    }
+    if (rc != 0) {
+        return BLE_HS_EUNKNOWN;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+ * $sec                                                                      *
+ *****************************************************************************/
+
+static int
+ble_store_fcb_read_sec(int obj_type, struct ble_store_key_sec *key_sec,
+                       struct ble_store_value_sec *value_sec)
+{
+    struct ble_store_fcb_disk disk;
+    struct ble_store_fcb_idx_entry *entry;
+    int skipped;
+    int found;
+    int idx;
+    int rc;
+    int i;
+
+    if (key_sec->peer_addr_type != BLE_STORE_ADDR_TYPE_NONE) {
+        /* Keyed by peer address; the index holds at most one security entry
+         * per peer, so this is a pure binary search.
+         */
+        found = ble_store_fcb_idx_search(obj_type, key_sec->peer_addr_type,
+                                         key_sec->peer_addr, 0, &idx);
+        if (!found || key_sec->idx > 0) {
+            return BLE_HS_ENOENT;
+        }
+        entry = ble_store_fcb_idx + idx;
+
+        if (key_sec->ediv_rand_present &&
+            (entry->ediv != key_sec->ediv ||
+             entry->rand_num != key_sec->rand_num)) {
+
+            return BLE_HS_ENOENT;
+        }
+    } else {
+        /* No peer address; scan the obj type's section of the index. */
+        entry = NULL;
+        skipped = 0;
+        for (i = 0; i < ble_store_fcb_idx_count; i++) {
+            if (ble_store_fcb_idx[i].obj_type != obj_type) {
+                continue;
+            }
+
+            if (key_sec->ediv_rand_present &&
+                (ble_store_fcb_idx[i].ediv != key_sec->ediv ||
+                 ble_store_fcb_idx[i].rand_num != key_sec->rand_num)) {
+
+                continue;
+            }
+
+            if (key_sec->idx > skipped) {
+                skipped++;
+                continue;
+            }
+
+            entry = ble_store_fcb_idx + i;
+            break;
+        }
+        if (entry == NULL) {
+            return BLE_HS_ENOENT;
+        }
+    }
+
+    rc = ble_store_fcb_load(&entry->loc, &disk);
+    if (rc != 0) {
+        return rc;
+    }
+
+    *value_sec = disk.val.sec;
+    return 0;
+}
+
+/*****************************************************************************
+ * $cccd                                                                     *
+ *****************************************************************************/
+
+static int
+ble_store_fcb_read_cccd(struct ble_store_key_cccd *key_cccd,
+                        struct ble_store_value_cccd *value_cccd)
+{
+    struct ble_store_fcb_disk disk;
+    struct ble_store_fcb_idx_entry *entry;
+    int skipped;
+    int found;
+    int idx;
+    int rc;
+
+    entry = NULL;
+    skipped = 0;
+
+    if (key_cccd->peer_addr_type != BLE_STORE_ADDR_TYPE_NONE) {
+        /* The peer's CCCDs are contiguous in the index, sorted by handle;
+         * seek to the start of the peer's range and iterate.
+         */
+        found = ble_store_fcb_idx_search(BLE_STORE_OBJ_TYPE_CCCD,
+                                         key_cccd->peer_addr_type,
+                                         key_cccd->peer_addr,
+                                         key_cccd->chr_val_handle, &idx);
+        if (key_cccd->chr_val_handle != 0) {
+            if (found && key_cccd->idx == 0) {
+                entry = ble_store_fcb_idx + idx;
+            }
+        } else {
+            for (; idx < ble_store_fcb_idx_count; idx++) {
+                if (ble_store_fcb_idx_cmp(BLE_STORE_OBJ_TYPE_CCCD,
+                                          key_cccd->peer_addr_type,
+                                          key_cccd->peer_addr,
+                                          ble_store_fcb_idx[idx].
+                                              chr_val_handle,
+                                          ble_store_fcb_idx + idx) != 0) {
+                    break;
+                }
+
+                if (key_cccd->idx > skipped) {
+                    skipped++;
+                    continue;
+                }
+
+                entry = ble_store_fcb_idx + idx;
+                break;
+            }
+        }
+    } else {
+        for (idx = 0; idx < ble_store_fcb_idx_count; idx++) {
+            if (ble_store_fcb_idx[idx].obj_type != BLE_STORE_OBJ_TYPE_CCCD) {
+                continue;
+            }
+
+            if (key_cccd->chr_val_handle != 0 &&
+                ble_store_fcb_idx[idx].chr_val_handle !=
+                    key_cccd->chr_val_handle) {
+
+                continue;
+            }
+
+            if (key_cccd->idx > skipped) {
+                skipped++;
+                continue;
+            }
+
+            entry = ble_store_fcb_idx + idx;
+            break;
+        }
+    }
+
+    if (entry == NULL) {
+        return BLE_HS_ENOENT;
+    }
+
+    rc = ble_store_fcb_load(&entry->loc, &disk);
+    if (rc != 0) {
+        return rc;
+    }
+
+    *value_cccd = disk.val.cccd;
+    return 0;
+}
+
+/*****************************************************************************
+ * $api                                                                      *
+ *****************************************************************************/
+
+/**
+ * Searches the database for an object matching the specified criteria.
+ *
+ * @return                      0 if a key was found; else BLE_HS_ENOENT.
+ */
+int
+ble_store_fcb_read(int obj_type, union ble_store_key *key,
+                   union ble_store_value *value)
+{
+    switch (obj_type) {
+    case BLE_STORE_OBJ_TYPE_OUR_SEC:
+    case BLE_STORE_OBJ_TYPE_PEER_SEC:
+        return ble_store_fcb_read_sec(obj_type, &key->sec, &value->sec);
+
+    case BLE_STORE_OBJ_TYPE_CCCD:
+        return ble_store_fcb_read_cccd(&key->cccd, &value->cccd);
+
+    default:
+        return BLE_HS_ENOTSUP;
+    }
+}
+
+/**
+ * Adds the specified object to the database.  The record gets appended to
+ * flash and the in-RAM index updated to point at it; the superseded record,
+ * if any, gets reclaimed during a future compaction.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+ble_store_fcb_write(int obj_type, union ble_store_value *val)
+{
+    struct ble_store_fcb_disk disk;
+    struct fcb_entry loc;
+    int rc;
+
+    switch (obj_type) {
+    case BLE_STORE_OBJ_TYPE_OUR_SEC:
+    case BLE_STORE_OBJ_TYPE_PEER_SEC:
+    case BLE_STORE_OBJ_TYPE_CCCD:
+        break;
+
+    default:
+        return BLE_HS_ENOTSUP;
+    }
+
+    memset(&disk, 0, sizeof disk);
+    disk.type = obj_type;
+    disk.val = *val;
+
+    rc = ble_store_fcb_write_rec(&disk, &loc);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = ble_store_fcb_idx_upsert(obj_type, val, &loc);
+    if (rc != 0) {
+        BLE_HS_LOG(DEBUG, "error persisting record; index full (%d)\n",
+                   ble_store_fcb_idx_count);
+        return rc;
+    }
+
+    return 0;
+}
+
+/**
+ * Removes the specified object from the database.  A tombstone record gets
+ * appended so that the deletion survives a restart.
+ *
+ * @return                      0 on success; BLE_HS_ENOENT if no matching
+ *                                  object exists.
+ */
+int
+ble_store_fcb_delete(int obj_type, union ble_store_key *key)
+{
+    struct ble_store_fcb_disk disk;
+    struct fcb_entry loc;
+    uint16_t chr_val_handle;
+    uint8_t peer_addr_type;
+    const uint8_t *peer_addr;
+    int found;
+    int idx;
+    int rc;
+
+    switch (obj_type) {
+    case BLE_STORE_OBJ_TYPE_OUR_SEC:
+    case BLE_STORE_OBJ_TYPE_PEER_SEC:
+        peer_addr_type = key->sec.peer_addr_type;
+        peer_addr = key->sec.peer_addr;
+        chr_val_handle = 0;
+        break;
+
+    case BLE_STORE_OBJ_TYPE_CCCD:
+        peer_addr_type = key->cccd.peer_addr_type;
+        peer_addr = key->cccd.peer_addr;
+        chr_val_handle = key->cccd.chr_val_handle;
+        break;
+
+    default:
+        return BLE_HS_ENOTSUP;
+    }
+
+    if (peer_addr_type == BLE_STORE_ADDR_TYPE_NONE) {
+        return BLE_HS_ENOTSUP;
+    }
+
+    found = ble_store_fcb_idx_search(obj_type, peer_addr_type, peer_addr,
+                                     chr_val_handle, &idx);
+    if (!found) {
+        return BLE_HS_ENOENT;
+    }
+
+    /* Load the doomed record so the tombstone carries its key fields. */
+    rc = ble_store_fcb_load(&ble_store_fcb_idx[idx].loc, &disk);
+    if (rc != 0) {
+        return rc;
+    }
+    disk.deleted = 1;
+
+    rc = ble_store_fcb_write_rec(&disk, &loc);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_store_fcb_idx_remove(idx);
+    return 0;
+}
+
+/**
+ * Populates the index with the record at the specified flash location.
+ * Called once per record during startup; records are visited oldest first,
+ * so the latest record for each key wins.
+ */
+static int
+ble_store_fcb_restore_cb(struct fcb_entry *loc, void *arg)
+{
+    struct ble_store_fcb_disk disk;
+    int found;
+    int idx;
+    int rc;
+
+    rc = ble_store_fcb_load(loc, &disk);
+    if (rc != 0) {
+        /* Skip unreadable records. */
+        return 0;
+    }
+
+    switch (disk.type) {
+    case BLE_STORE_OBJ_TYPE_OUR_SEC:
+    case BLE_STORE_OBJ_TYPE_PEER_SEC:
+    case BLE_STORE_OBJ_TYPE_CCCD:
+        break;
+
+    default:
+        return 0;
+    }
+
+    if (disk.deleted) {
+        struct ble_store_fcb_idx_entry entry;
+
+        ble_store_fcb_idx_fill(&entry, disk.type, &disk.val);
+        found = ble_store_fcb_idx_search(entry.obj_type,
+                                         entry.peer_addr_type,
+                                         entry.peer_addr,
+                                         entry.chr_val_handle, &idx);
+        if (found) {
+            ble_store_fcb_idx_remove(idx);
+        }
+        return 0;
+    }
+
+    ble_store_fcb_idx_upsert(disk.type, &disk.val, loc);
+    return 0;
+}
+
+int
+ble_store_fcb_init(struct fcb *fcb)
+{
+    int rc;
+
+    fcb->f_magic = BLE_STORE_FCB_MAGIC;
+    fcb->f_version = BLE_STORE_FCB_VERS;
+    fcb->f_scratch_cnt = 1;
+
+    while (1) {
+        rc = fcb_init(fcb);
+        if (rc != 0) {
+            return BLE_HS_EUNKNOWN;
+        }
+
+        /*
+         * Check if system was reset in middle of emptying a sector.  This
+         * situation is recognized by checking if the scratch block is
+         * missing.
+         */
+        if (fcb_free_sector_cnt(fcb) < 1) {
+            flash_area_erase(fcb->f_active.fe_area, 0,
+                             fcb->f_active.fe_area->fa_size);
+        } else {
+            break;
+        }
+    }
+
+    ble_store_fcb = fcb;
+    ble_store_fcb_idx_count = 0;
+
+    rc = fcb_walk(fcb, NULL, ble_store_fcb_restore_cb, NULL);
+    if (rc != 0) {
+        return BLE_HS_EUNKNOWN;
+    }
+
+    ble_hs_cfg.store_read_cb = ble_store_fcb_read;
+    ble_hs_cfg.store_write_cb = ble_store_fcb_write;
+    ble_hs_cfg.store_delete_cb = ble_store_fcb_delete;
+
+    return 0;
+}
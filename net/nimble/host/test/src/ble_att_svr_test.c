@@ -2255,6 +2255,77 @@ TEST_CASE(ble_att_svr_test_oom)
     os_mbuf_free_chain(oms);
 }
 
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+static const struct ble_att_svr_entry ble_att_svr_test_static_attrs[] = {
+    BLE_ATT_SVR_STATIC_ENTRY(1, BLE_ATT_F_READ,
+        ble_att_svr_test_misc_attr_fn_r_1, NULL,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff),
+    BLE_ATT_SVR_STATIC_ENTRY(2, BLE_ATT_F_READ | BLE_ATT_F_WRITE,
+        ble_att_svr_test_misc_attr_fn_r_1, NULL,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+        0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f),
+    BLE_ATT_SVR_STATIC_ENTRY(3, BLE_ATT_F_READ,
+        ble_att_svr_test_misc_attr_fn_r_1, NULL,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff),
+};
+
+TEST_CASE(ble_att_svr_test_static_db)
+{
+    static const uint8_t uuid_a[16] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    };
+    struct ble_att_svr_entry *entry;
+    int rc;
+    int i;
+
+    ble_hs_test_util_init();
+
+    /* The host has already registered its own services. */
+    rc = ble_att_svr_static_db_set(ble_att_svr_test_static_attrs, 3);
+    TEST_ASSERT(rc == BLE_HS_EALREADY);
+
+    /* Start over with an empty attribute server. */
+    rc = ble_att_svr_init();
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = ble_att_svr_static_db_set(ble_att_svr_test_static_attrs, 3);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Static attributes resolve without any registration. */
+    for (i = 0; i < 3; i++) {
+        entry = ble_att_svr_find_by_handle(i + 1);
+        TEST_ASSERT(entry == &ble_att_svr_test_static_attrs[i]);
+    }
+    TEST_ASSERT(ble_att_svr_find_by_handle(4) == NULL);
+
+    /* Dynamic registration continues after the table. */
+    ble_att_svr_test_misc_register_uuid128((uint8_t *)uuid_a, BLE_ATT_F_READ,
+                                           4,
+                                           ble_att_svr_test_misc_attr_fn_r_1);
+
+    /* A UUID search spans the table and the dynamic list. */
+    entry = ble_att_svr_find_by_uuid(NULL, uuid_a, 0xffff);
+    TEST_ASSERT(entry == &ble_att_svr_test_static_attrs[0]);
+
+    entry = ble_att_svr_find_by_uuid(entry, uuid_a, 0xffff);
+    TEST_ASSERT(entry == &ble_att_svr_test_static_attrs[2]);
+
+    entry = ble_att_svr_find_by_uuid(entry, uuid_a, 0xffff);
+    TEST_ASSERT_FATAL(entry != NULL);
+    TEST_ASSERT(entry->ha_handle_id == 4);
+
+    entry = ble_att_svr_find_by_uuid(entry, uuid_a, 0xffff);
+    TEST_ASSERT(entry == NULL);
+
+    /* Installing a second table is rejected. */
+    rc = ble_att_svr_static_db_set(ble_att_svr_test_static_attrs, 3);
+    TEST_ASSERT(rc == BLE_HS_EALREADY);
+}
+#endif
+
 TEST_SUITE(ble_att_svr_suite)
 {
     /* When checking for mbuf leaks, ensure no stale prep entries. */
@@ -2279,6 +2350,9 @@ TEST_SUITE(ble_att_svr_suite)
     ble_att_svr_test_notify();
     ble_att_svr_test_indicate();
     ble_att_svr_test_oom();
+#if MYNEWT_VAL(BLE_ATT_SVR_STATIC_DB)
+    ble_att_svr_test_static_db();
+#endif
 }
 
 int
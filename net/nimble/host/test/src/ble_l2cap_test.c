@@ -96,7 +96,8 @@ ble_l2cap_test_util_verify_tx_update_conn(
 }
 
 static int
-ble_l2cap_test_util_dummy_rx(uint16_t conn_handle, struct os_mbuf **om)
+ble_l2cap_test_util_dummy_rx(uint16_t conn_handle, uint16_t cid,
+                             struct os_mbuf **om)
 {
     return 0;
 }
@@ -60,6 +60,25 @@ struct os_mbuf;
 /* Host-to-controller command. */
 #define BLE_HCI_TRANS_BUF_CMD       3
 
+/**
+ * Small controller-to-host event buffer.  Most events the controller sends
+ * (advertising reports in particular) are far smaller than the full event
+ * buffer size, so transports may maintain a dedicated pool of small buffers
+ * to raise event capacity in the same amount of RAM.  A small buffer is
+ * guaranteed to hold at least BLE_HCI_TRANS_BUF_EVT_SMALL_SZ bytes; events
+ * known to fit may be allocated with this type.  If the small pool is
+ * exhausted, or the transport does not maintain one, a request for a small
+ * buffer is satisfied from the low-priority pool instead.
+ */
+#define BLE_HCI_TRANS_BUF_EVT_SMALL 4
+
+/*
+ * Size of a small event buffer: the two-byte event header plus the largest
+ * LE advertising report event (12 byte minimum report length plus up to 31
+ * bytes of advertising data).
+ */
+#define BLE_HCI_TRANS_BUF_EVT_SMALL_SZ  45
+
 /** Callback function types; executed when HCI packets are received. */
 typedef int ble_hci_trans_rx_cmd_fn(uint8_t *cmd, void *arg);
 typedef int ble_hci_trans_rx_acl_fn(struct os_mbuf *om, void *arg);
@@ -106,6 +125,33 @@ int ble_hci_trans_hs_cmd_tx(uint8_t *cmd);
  */
 int ble_hci_trans_hs_acl_tx(struct os_mbuf *om);
 
+/**
+ * Sends a chain of ACL data packets from controller to host in one call.
+ *
+ * Packets are linked through their packet headers
+ * (OS_MBUF_PKTHDR()->omp_next); the chain is NULL terminated and the
+ * transport consumes every packet on it regardless of outcome, so a
+ * burst of packets costs a single transport handoff (and, with an
+ * in-RAM transport, a single receiver wakeup).
+ *
+ * @param om                    The first ACL data packet of the chain.
+ *
+ * @return                      0 on success;
+ *                              A BLE_ERR_[...] error code on failure.
+ */
+int ble_hci_trans_ll_acl_tx_chain(struct os_mbuf *om);
+
+/**
+ * Sends a chain of ACL data packets from host to controller in one call.
+ * Chain linkage and ownership rules match ble_hci_trans_ll_acl_tx_chain().
+ *
+ * @param om                    The first ACL data packet of the chain.
+ *
+ * @return                      0 on success;
+ *                              A BLE_ERR_[...] error code on failure.
+ */
+int ble_hci_trans_hs_acl_tx_chain(struct os_mbuf *om);
+
 /**
  * Allocates a flat buffer of the specified type.
  *
@@ -51,6 +51,22 @@ extern "C" {
 #define BLE_HCI_OGF_STATUS_PARAMS           (0x05)
 #define BLE_HCI_OGF_TESTING                 (0x06)
 #define BLE_HCI_OGF_LE                      (0x08)
+#define BLE_HCI_OGF_VENDOR                  (0x3F)
+
+/* List of OCF for vendor-specific commands (OGF = 0x3F) */
+#define BLE_HCI_OCF_VENDOR_CHAN_ASSESS      (0x0001)
+#define BLE_HCI_OCF_VENDOR_ADV_SET_SEL      (0x0002)
+#define BLE_HCI_OCF_VENDOR_WL_BULK_SET      (0x0003)
+#define BLE_HCI_OCF_VENDOR_RL_BULK_SET      (0x0004)
+#define BLE_HCI_OCF_VENDOR_DTM_PER          (0x0005)
+
+/* --- Vendor white list bulk set (OGF 0x3F, OCF 0x0003) --- */
+#define BLE_HCI_WL_BULK_SET_ENT_LEN         (7)
+#define BLE_HCI_WL_BULK_SET_MAX_ENTS        (36)
+
+/* --- Vendor resolving list bulk set (OGF 0x3F, OCF 0x0004) --- */
+#define BLE_HCI_RL_BULK_SET_ENT_LEN         (BLE_HCI_ADD_TO_RESOLV_LIST_LEN)
+#define BLE_HCI_RL_BULK_SET_MAX_ENTS        (6)
 
 /*
  * Number of LE commands. NOTE: this is really just used to size the array
@@ -66,6 +82,9 @@ extern "C" {
 #define BLE_HCI_OCF_CB_SET_EVENT_MASK       (0x0001)
 #define BLE_HCI_OCF_CB_RESET                (0x0003)
 #define BLE_HCI_OCF_CB_READ_TX_PWR          (0x002D)
+#define BLE_HCI_OCF_CB_SET_CTLR_TO_HOST_FC  (0x0031)
+#define BLE_HCI_OCF_CB_HOST_BUF_SIZE        (0x0033)
+#define BLE_HCI_OCF_CB_HOST_NUM_COMP_PKTS   (0x0035)
 #define BLE_HCI_OCF_CB_SET_EVENT_MASK2      (0x0063)
 #define BLE_HCI_OCF_CB_RD_AUTH_PYLD_TMO     (0x007B)
 #define BLE_HCI_OCF_CB_WR_AUTH_PYLD_TMO     (0x007C)
@@ -138,6 +157,19 @@ extern "C" {
 /* --- Read BD_ADDR (OGF 0x04, OCF 0x0009 --- */
 #define BLE_HCI_IP_RD_BD_ADDR_ACK_PARAM_LEN (6)
 
+/* --- Set controller to host flow control (OGF 0x03, OCF 0x0031) --- */
+#define BLE_HCI_CTLR_TO_HOST_FC_LEN         (1)
+
+#define BLE_HCI_CTLR_TO_HOST_FC_OFF         (0)
+#define BLE_HCI_CTLR_TO_HOST_FC_ACL         (1)
+
+/* --- Host buffer size (OGF 0x03, OCF 0x0033) --- */
+#define BLE_HCI_HOST_BUF_SIZE_LEN           (7)
+
+/* --- Host number of completed packets (OGF 0x03, OCF 0x0035) --- */
+#define BLE_HCI_HOST_NUM_COMP_PKTS_HDR_LEN  (1)
+#define BLE_HCI_HOST_NUM_COMP_PKTS_ENT_LEN  (4)
+
 /* --- Read/Write authenticated payload timeout (ocf 0x007B/0x007C) */
 #define BLE_HCI_RD_AUTH_PYLD_TMO_LEN        (4)
 #define BLE_HCI_WR_AUTH_PYLD_TMO_LEN        (2)
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_TIMESYNC_
+#define H_BLE_TIMESYNC_
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct os_mbuf;
+
+/*
+ * Clock synchronization over BLE connections, using connection event
+ * anchor points as the shared time reference.  Both peers of a
+ * connection know the anchor point of each connection event to within
+ * the receive accuracy of the slave's radio, so a beacon saying "at
+ * connection event N my synchronized clock read T" lets the receiver
+ * discipline its clock without caring when the beacon itself was
+ * actually transmitted.  Requires a combined host/controller image.
+ *
+ * The time source node simply never feeds ble_timesync_rx(); every
+ * other node disciplines its clock from received beacons and may
+ * re-beacon the disciplined time to nodes further from the source.
+ */
+
+/* Beacon payload: event counter (le16) + synchronized time (le64). */
+#define BLE_TIMESYNC_BEACON_SZ      10
+
+/* Service and beacon characteristic UUIDs, for discovery and routing. */
+extern const uint8_t ble_timesync_svc_uuid[16];
+extern const uint8_t ble_timesync_chr_beacon_uuid[16];
+
+/**
+ * Returns the synchronized clock, in microseconds.  Before the first
+ * beacon is received this is just local time since boot.
+ */
+int64_t ble_timesync_get_usecs(void);
+
+/**
+ * Returns nonzero once at least one beacon has disciplined the clock.
+ */
+int ble_timesync_synced(void);
+
+/**
+ * Starts (or stops) periodic beaconing to a peer that has subscribed
+ * to the beacon characteristic; call from the application's GAP
+ * subscribe/disconnect events.
+ */
+int ble_timesync_beacon_enable(uint16_t conn_handle);
+void ble_timesync_beacon_disable(uint16_t conn_handle);
+
+/**
+ * Feeds a received beacon notification to the clock discipline; call
+ * from the application's notify-rx GAP event when the attribute is the
+ * peer's beacon characteristic.  Does not consume the mbuf.
+ */
+int ble_timesync_rx(uint16_t conn_handle, struct os_mbuf *om);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,360 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "host/ble_hs.h"
+#include "controller/ble_ll_conn.h"
+#include "timesync/ble_timesync.h"
+
+/* {8D40F6B2-71C5-4E8A-B7D3-5F02A19C6E30} */
+const uint8_t ble_timesync_svc_uuid[16] = {
+    0x30, 0x6e, 0x9c, 0xa1, 0x02, 0x5f, 0xd3, 0xb7,
+    0x8a, 0x4e, 0xc5, 0x71, 0xb2, 0xf6, 0x40, 0x8d
+};
+
+/* {8D40F6B3-71C5-4E8A-B7D3-5F02A19C6E30} */
+const uint8_t ble_timesync_chr_beacon_uuid[16] = {
+    0x30, 0x6e, 0x9c, 0xa1, 0x02, 0x5f, 0xd3, 0xb7,
+    0x8a, 0x4e, 0xc5, 0x71, 0xb3, 0xf6, 0x40, 0x8d
+};
+
+static uint16_t ble_timesync_beacon_handle;
+
+static struct os_callout ble_timesync_co;
+
+/* Connections being beaconed to. */
+static uint16_t ble_timesync_conns[MYNEWT_VAL(BLE_TIMESYNC_MAX_CONNS)];
+
+/*
+ * 64-bit extension of the 32-bit cputime counter.  The periodic callout
+ * guarantees a sample well inside each wrap period.
+ */
+static uint64_t ble_timesync_ticks_base;
+static uint32_t ble_timesync_ticks_last;
+
+/* Offset of the synchronized clock from local time, in microseconds. */
+static int64_t ble_timesync_offset;
+static uint8_t ble_timesync_is_synced;
+
+static uint64_t
+ble_timesync_cputime64(void)
+{
+    uint64_t ticks;
+    uint32_t now;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    now = os_cputime_get32();
+    if (now < ble_timesync_ticks_last) {
+        ble_timesync_ticks_base += (uint64_t)1 << 32;
+    }
+    ble_timesync_ticks_last = now;
+    ticks = ble_timesync_ticks_base + now;
+    OS_EXIT_CRITICAL(sr);
+    return ticks;
+}
+
+/*
+ * Extends a recent 32-bit cputime value (e.g. a connection anchor
+ * point) to 64 bits, relative to the current time.
+ */
+static uint64_t
+ble_timesync_ticks64_at(uint32_t tick32)
+{
+    uint64_t now;
+
+    now = ble_timesync_cputime64();
+    return now + (int32_t)(tick32 - (uint32_t)now);
+}
+
+static int64_t
+ble_timesync_ticks_to_usecs(uint64_t ticks)
+{
+    return ticks * 1000000 / MYNEWT_VAL(OS_CPUTIME_FREQ);
+}
+
+/*
+ * Synchronized clock time of a connection's anchor point for the given
+ * event counter.  The link layer reports the latest scheduled anchor;
+ * earlier (or slightly later) events are reconstructed from the
+ * connection interval, which both peers pace identically.
+ */
+static int
+ble_timesync_anchor_usecs(uint16_t conn_handle, uint16_t evt_cntr,
+                          int64_t *out_usecs)
+{
+    uint32_t anchor;
+    uint32_t itvl_usecs;
+    uint16_t last_cntr;
+    int16_t delta;
+    int rc;
+
+    rc = ble_ll_conn_anchor_get(conn_handle, &last_cntr, &anchor,
+                                &itvl_usecs);
+    if (rc != 0) {
+        return BLE_HS_ENOTCONN;
+    }
+
+    delta = (int16_t)(last_cntr - evt_cntr);
+    *out_usecs = ble_timesync_ticks_to_usecs(ble_timesync_ticks64_at(anchor)) -
+                 (int64_t)delta * itvl_usecs + ble_timesync_offset;
+    return 0;
+}
+
+/**
+ * Builds a beacon for one connection: "at connection event N, my
+ * synchronized clock read T".  The content refers to the anchor point,
+ * not to the moment of transmission, so queueing and radio latency do
+ * not affect accuracy.
+ */
+static int
+ble_timesync_beacon_build(uint16_t conn_handle,
+                          uint8_t buf[BLE_TIMESYNC_BEACON_SZ])
+{
+    uint32_t anchor;
+    uint32_t itvl_usecs;
+    uint16_t evt_cntr;
+    int64_t anchor_usecs;
+    int rc;
+
+    rc = ble_ll_conn_anchor_get(conn_handle, &evt_cntr, &anchor,
+                                &itvl_usecs);
+    if (rc != 0) {
+        return BLE_HS_ENOTCONN;
+    }
+
+    anchor_usecs =
+        ble_timesync_ticks_to_usecs(ble_timesync_ticks64_at(anchor)) +
+        ble_timesync_offset;
+
+    htole16(buf, evt_cntr);
+    htole64(buf + 2, anchor_usecs);
+    return 0;
+}
+
+int64_t
+ble_timesync_get_usecs(void)
+{
+    return ble_timesync_ticks_to_usecs(ble_timesync_cputime64()) +
+           ble_timesync_offset;
+}
+
+int
+ble_timesync_synced(void)
+{
+    return ble_timesync_is_synced;
+}
+
+int
+ble_timesync_beacon_enable(uint16_t conn_handle)
+{
+    int free_slot;
+    int i;
+
+    free_slot = -1;
+    for (i = 0; i < MYNEWT_VAL(BLE_TIMESYNC_MAX_CONNS); i++) {
+        if (ble_timesync_conns[i] == conn_handle) {
+            return 0;
+        }
+        if (ble_timesync_conns[i] == BLE_HS_CONN_HANDLE_NONE &&
+            free_slot < 0) {
+
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        return BLE_HS_ENOMEM;
+    }
+    ble_timesync_conns[free_slot] = conn_handle;
+    return 0;
+}
+
+void
+ble_timesync_beacon_disable(uint16_t conn_handle)
+{
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(BLE_TIMESYNC_MAX_CONNS); i++) {
+        if (ble_timesync_conns[i] == conn_handle) {
+            ble_timesync_conns[i] = BLE_HS_CONN_HANDLE_NONE;
+        }
+    }
+}
+
+int
+ble_timesync_rx(uint16_t conn_handle, struct os_mbuf *om)
+{
+    uint8_t buf[BLE_TIMESYNC_BEACON_SZ];
+    int64_t local_usecs;
+    int64_t beacon_usecs;
+    int64_t err;
+    uint16_t evt_cntr;
+    os_sr_t sr;
+    int rc;
+
+    if (OS_MBUF_PKTLEN(om) < BLE_TIMESYNC_BEACON_SZ) {
+        return BLE_HS_EINVAL;
+    }
+    rc = os_mbuf_copydata(om, 0, BLE_TIMESYNC_BEACON_SZ, buf);
+    if (rc != 0) {
+        return BLE_HS_EUNKNOWN;
+    }
+
+    evt_cntr = le16toh(buf);
+    beacon_usecs = le64toh(buf + 2);
+
+    rc = ble_timesync_anchor_usecs(conn_handle, evt_cntr, &local_usecs);
+    if (rc != 0) {
+        return rc;
+    }
+
+    err = beacon_usecs - local_usecs;
+
+    OS_ENTER_CRITICAL(sr);
+    if (!ble_timesync_is_synced ||
+        err > MYNEWT_VAL(BLE_TIMESYNC_STEP_THRESH_US) ||
+        err < -MYNEWT_VAL(BLE_TIMESYNC_STEP_THRESH_US)) {
+        /* Step straight to the beacon's time. */
+        ble_timesync_offset += err;
+    } else {
+        /*
+         * Slew halfway.  With periodic beacons the steady-state error
+         * settles around twice the clock drift accumulated per beacon
+         * interval, well under a millisecond for sleep-clock-grade
+         * oscillators at the default interval.
+         */
+        ble_timesync_offset += err / 2;
+    }
+    ble_timesync_is_synced = 1;
+    OS_EXIT_CRITICAL(sr);
+
+    return 0;
+}
+
+/**
+ * Periodic tick: refreshes the 64-bit time extension and beacons to
+ * every registered connection.
+ */
+static void
+ble_timesync_tick(struct os_event *ev)
+{
+    uint8_t buf[BLE_TIMESYNC_BEACON_SZ];
+    struct os_mbuf *om;
+    int rc;
+    int i;
+
+    (void)ble_timesync_cputime64();
+
+    for (i = 0; i < MYNEWT_VAL(BLE_TIMESYNC_MAX_CONNS); i++) {
+        if (ble_timesync_conns[i] == BLE_HS_CONN_HANDLE_NONE) {
+            continue;
+        }
+        rc = ble_timesync_beacon_build(ble_timesync_conns[i], buf);
+        if (rc != 0) {
+            ble_timesync_conns[i] = BLE_HS_CONN_HANDLE_NONE;
+            continue;
+        }
+        om = ble_hs_mbuf_from_flat(buf, sizeof(buf));
+        if (om == NULL) {
+            /* Try again next tick. */
+            continue;
+        }
+        rc = ble_gattc_notify_custom(ble_timesync_conns[i],
+                                     ble_timesync_beacon_handle, om);
+        if (rc != 0 && rc != BLE_HS_ENOMEM) {
+            ble_timesync_conns[i] = BLE_HS_CONN_HANDLE_NONE;
+        }
+    }
+
+    os_callout_reset(&ble_timesync_co,
+                     (MYNEWT_VAL(BLE_TIMESYNC_ITVL_MS) * OS_TICKS_PER_SEC) /
+                     1000);
+}
+
+static int
+ble_timesync_gatt_access(uint16_t conn_handle, uint16_t attr_handle,
+                         struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    uint8_t buf[BLE_TIMESYNC_BEACON_SZ];
+    int rc;
+
+    switch (ctxt->op) {
+    case BLE_GATT_ACCESS_OP_READ_CHR:
+        rc = ble_timesync_beacon_build(conn_handle, buf);
+        if (rc != 0) {
+            return BLE_ATT_ERR_UNLIKELY;
+        }
+        rc = os_mbuf_append(ctxt->om, buf, sizeof(buf));
+        return rc == 0 ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+
+    default:
+        assert(0);
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+}
+
+static const struct ble_gatt_svc_def ble_timesync_svcs[] = {
+    {
+        /* Service: time synchronization */
+        .type = BLE_GATT_SVC_TYPE_PRIMARY,
+        .uuid128 = (void *)ble_timesync_svc_uuid,
+        .characteristics = (struct ble_gatt_chr_def[]) { {
+            /* Characteristic: anchor beacon */
+            .uuid128 = (void *)ble_timesync_chr_beacon_uuid,
+            .access_cb = ble_timesync_gatt_access,
+            .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+            .val_handle = &ble_timesync_beacon_handle,
+        }, {
+            0, /* No more characteristics in this service */
+        } },
+    },
+
+    {
+        0, /* No more services */
+    },
+};
+
+void
+ble_timesync_pkg_init(void)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(BLE_TIMESYNC_MAX_CONNS); i++) {
+        ble_timesync_conns[i] = BLE_HS_CONN_HANDLE_NONE;
+    }
+    ble_timesync_ticks_last = os_cputime_get32();
+
+    rc = ble_gatts_count_cfg(ble_timesync_svcs);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+    rc = ble_gatts_add_svcs(ble_timesync_svcs);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+    os_callout_init(&ble_timesync_co, os_eventq_dflt_get(),
+                    ble_timesync_tick, NULL);
+    os_callout_reset(&ble_timesync_co,
+                     (MYNEWT_VAL(BLE_TIMESYNC_ITVL_MS) * OS_TICKS_PER_SEC) /
+                     1000);
+}
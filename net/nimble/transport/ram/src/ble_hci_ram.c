@@ -45,6 +45,11 @@ static void *ble_hci_ram_evt_hi_buf;
 static struct os_mempool ble_hci_ram_evt_lo_pool;
 static void *ble_hci_ram_evt_lo_buf;
 
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+static struct os_mempool ble_hci_ram_evt_small_pool;
+static void *ble_hci_ram_evt_small_buf;
+#endif
+
 static uint8_t *ble_hci_ram_hs_cmd_buf;
 static uint8_t ble_hci_ram_hs_cmd_buf_alloced;
 
@@ -116,6 +121,55 @@ ble_hci_trans_ll_acl_tx(struct os_mbuf *om)
     return rc;
 }
 
+/*
+ * Walks a NULL-terminated packet chain (linked via the mbuf packet
+ * header), detaching each packet and handing it to the receiver's ACL
+ * callback.  Consumes the entire chain; the first nonzero callback
+ * result is returned.
+ */
+static int
+ble_hci_ram_acl_tx_chain(struct os_mbuf *om, ble_hci_trans_rx_acl_fn *acl_cb,
+                         void *acl_arg)
+{
+    struct os_mbuf_pkthdr *pkthdr;
+    struct os_mbuf *next;
+    int rc;
+    int first_rc;
+
+    first_rc = 0;
+    while (om != NULL) {
+        pkthdr = OS_MBUF_PKTHDR(om);
+        next = STAILQ_NEXT(pkthdr, omp_next) ?
+            OS_MBUF_PKTHDR_TO_MBUF(STAILQ_NEXT(pkthdr, omp_next)) : NULL;
+        STAILQ_NEXT(pkthdr, omp_next) = NULL;
+
+        rc = acl_cb(om, acl_arg);
+        if (rc != 0 && first_rc == 0) {
+            first_rc = rc;
+        }
+        om = next;
+    }
+    return first_rc;
+}
+
+int
+ble_hci_trans_hs_acl_tx_chain(struct os_mbuf *om)
+{
+    assert(ble_hci_ram_rx_acl_ll_cb != NULL);
+
+    return ble_hci_ram_acl_tx_chain(om, ble_hci_ram_rx_acl_ll_cb,
+                                    ble_hci_ram_rx_acl_ll_arg);
+}
+
+int
+ble_hci_trans_ll_acl_tx_chain(struct os_mbuf *om)
+{
+    assert(ble_hci_ram_rx_acl_hs_cb != NULL);
+
+    return ble_hci_ram_acl_tx_chain(om, ble_hci_ram_rx_acl_hs_cb,
+                                    ble_hci_ram_rx_acl_hs_arg);
+}
+
 uint8_t *
 ble_hci_trans_buf_alloc(int type)
 {
@@ -136,6 +190,18 @@ ble_hci_trans_buf_alloc(int type)
         buf = os_memblock_get(&ble_hci_ram_evt_lo_pool);
         break;
 
+    case BLE_HCI_TRANS_BUF_EVT_SMALL:
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+        buf = os_memblock_get(&ble_hci_ram_evt_small_pool);
+        if (buf == NULL) {
+            /* Small events always fit in a low-priority buffer. */
+            buf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
+        }
+#else
+        buf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
+#endif
+        break;
+
     case BLE_HCI_TRANS_BUF_CMD:
         assert(!ble_hci_ram_hs_cmd_buf_alloced);
         ble_hci_ram_hs_cmd_buf_alloced = 1;
@@ -161,6 +227,11 @@ ble_hci_trans_buf_free(uint8_t *buf)
     } else if (os_memblock_from(&ble_hci_ram_evt_hi_pool, buf)) {
         rc = os_memblock_put(&ble_hci_ram_evt_hi_pool, buf);
         assert(rc == 0);
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    } else if (os_memblock_from(&ble_hci_ram_evt_small_pool, buf)) {
+        rc = os_memblock_put(&ble_hci_ram_evt_small_pool, buf);
+        assert(rc == 0);
+#endif
     } else {
         assert(os_memblock_from(&ble_hci_ram_evt_lo_pool, buf));
         rc = os_memblock_put(&ble_hci_ram_evt_lo_pool, buf);
@@ -177,6 +248,11 @@ ble_hci_ram_free_mem(void)
     free(ble_hci_ram_evt_lo_buf);
     ble_hci_ram_evt_lo_buf = NULL;
 
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    free(ble_hci_ram_evt_small_buf);
+    ble_hci_ram_evt_small_buf = NULL;
+#endif
+
     free(ble_hci_ram_hs_cmd_buf);
     ble_hci_ram_hs_cmd_buf = NULL;
     ble_hci_ram_hs_cmd_buf_alloced = 0;
@@ -227,6 +303,18 @@ ble_hci_ram_init(void)
         goto err;
     }
 
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    rc = mem_malloc_mempool(&ble_hci_ram_evt_small_pool,
+                            MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT),
+                            BLE_HCI_TRANS_BUF_EVT_SMALL_SZ,
+                            "ble_hci_ram_evt_small_pool",
+                            &ble_hci_ram_evt_small_buf);
+    if (rc != 0) {
+        rc = ble_err_from_os(rc);
+        goto err;
+    }
+#endif
+
     ble_hci_ram_hs_cmd_buf = malloc(BLE_HCI_TRANS_CMD_SZ);
     if (ble_hci_ram_hs_cmd_buf == NULL) {
         rc = BLE_ERR_MEM_CAPACITY;
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_HCI_SHM_
+#define H_BLE_HCI_SHM_
+
+#include "nimble/ble_hci_trans.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Shared-memory HCI transport configuration.
+ *
+ * The BSP provides a region of RAM visible to both cores at the same
+ * address, plus a way to interrupt the peer core (a mailbox or doorbell
+ * peripheral).  Both images must be built with identical values for
+ * this package's syscfg settings; the region layout is computed from
+ * them on each side independently.
+ */
+struct ble_hci_shm_cfg {
+    /** Base of the shared RAM region. */
+    void *bhsc_mem;
+
+    /** Size of the shared RAM region, in bytes. */
+    int bhsc_mem_size;
+
+    /**
+     * Rings the peer core's doorbell.  Called whenever a message has
+     * been placed on the outgoing ring; may be called in interrupt
+     * context.
+     */
+    void (*bhsc_signal_cb)(void *arg);
+    void *bhsc_signal_arg;
+};
+
+/**
+ * Initializes the shared-memory HCI transport.  The BSP calls this
+ * during system initialization, after the shared region and mailbox
+ * hardware are set up.  The image containing the host initializes the
+ * region; the controller image must therefore be released from reset
+ * only after the host side has run this function.
+ *
+ * @return                      0 on success;
+ *                              A BLE_ERR_[...] error code on failure.
+ */
+int ble_hci_shm_init(const struct ble_hci_shm_cfg *cfg);
+
+/**
+ * Processes the incoming message ring.  The BSP calls this from its
+ * mailbox/doorbell interrupt handler whenever the peer core signals.
+ */
+void ble_hci_shm_doorbell(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,715 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "os/os.h"
+#include "nimble/ble.h"
+#include "nimble/hci_common.h"
+#include "nimble/ble_hci_trans.h"
+#include "transport/shm/ble_hci_shm.h"
+
+/*
+ * Shared-memory HCI transport for dual-core parts (application core
+ * running the host, network core running the controller).
+ *
+ * The shared region holds two single-producer/single-consumer message
+ * rings (one per direction) followed by the HCI buffer pools, so
+ * command and event buffers are handed to the peer by passing their
+ * address; no serialization takes place.  Each flat buffer is owned by
+ * the side that allocates it (the command buffer by the host, event
+ * buffers by the controller) and is returned to its owner with a
+ * BUF_RET message when the peer frees it.
+ *
+ * ACL data uses receiver-posted credits: each side pre-allocates mbufs
+ * from its own shared-RAM pool and posts their addresses to the peer
+ * with CREDIT messages.  The sender flattens an outgoing packet into a
+ * credited mbuf (a single copy) and passes its address; the receiver
+ * hands the mbuf straight to its stack, which frees it into the
+ * receiver's pool as usual, and posts a fresh credit.  Mbuf headers
+ * are image-private, so this is as close to zero-copy as ACL data can
+ * get without sharing pool descriptors between images.
+ *
+ * Ring slots are only ever produced by one core and consumed by the
+ * other, so free-running head/tail indices need no cross-core locking.
+ * Both images must be built with identical values for this package's
+ * syscfg settings.
+ */
+
+#define BLE_HCI_SHM_MAGIC           (0x314d4853) /* "SHM1" */
+
+#define BLE_HCI_SHM_RING_SIZE       MYNEWT_VAL(BLE_HCI_SHM_RING_SIZE)
+#define BLE_HCI_SHM_RING_MASK       (BLE_HCI_SHM_RING_SIZE - 1)
+
+/* Message types */
+#define BLE_HCI_SHM_MSG_CMD         (1) /* HCI command (host to controller) */
+#define BLE_HCI_SHM_MSG_EVT         (2) /* HCI event (controller to host) */
+#define BLE_HCI_SHM_MSG_ACL         (3) /* ACL data in a credited mbuf */
+#define BLE_HCI_SHM_MSG_BUF_RET     (4) /* Return a peer-owned flat buffer */
+#define BLE_HCI_SHM_MSG_CREDIT      (5) /* Post an empty ACL mbuf to peer */
+
+/* This image's role; exactly one of host or controller per image. */
+#define BLE_HCI_SHM_CTLR            MYNEWT_VAL(BLE_DEVICE)
+
+struct ble_hci_shm_msg {
+    /*
+     * Address of the buffer in shared RAM.  Both cores map the region
+     * at the same address, so no translation is performed.
+     */
+    uint32_t bhsm_buf;
+    uint16_t bhsm_len;
+    uint8_t bhsm_type;
+    uint8_t bhsm_pad;
+};
+
+struct ble_hci_shm_ring {
+    /* Free-running; producer advances head, consumer advances tail. */
+    volatile uint16_t bhsr_head;
+    volatile uint16_t bhsr_tail;
+    struct ble_hci_shm_msg bhsr_msgs[BLE_HCI_SHM_RING_SIZE];
+};
+
+struct ble_hci_shm_hdr {
+    uint32_t bhsh_magic;
+    volatile uint8_t bhsh_host_ready;
+    volatile uint8_t bhsh_ctlr_ready;
+    uint8_t bhsh_pad[2];
+    struct ble_hci_shm_ring bhsh_h2c;
+    struct ble_hci_shm_ring bhsh_c2h;
+};
+
+#define BLE_HCI_SHM_ACL_BLOCK_SIZE                              \
+    OS_ALIGN(MYNEWT_VAL(BLE_ACL_BUF_SIZE) +                     \
+             BLE_MBUF_MEMBLOCK_OVERHEAD +                       \
+             BLE_HCI_DATA_HDR_SZ, OS_ALIGNMENT)
+
+static struct ble_hci_shm_hdr *ble_hci_shm_region;
+static struct ble_hci_shm_ring *ble_hci_shm_tx_ring;
+static struct ble_hci_shm_ring *ble_hci_shm_rx_ring;
+
+static void (*ble_hci_shm_signal_cb)(void *arg);
+static void *ble_hci_shm_signal_arg;
+
+/* Bounds of the peer-owned buffer area; frees inside it are returned. */
+static uint8_t *ble_hci_shm_peer_area;
+static int ble_hci_shm_peer_area_sz;
+
+#if BLE_HCI_SHM_CTLR
+static ble_hci_trans_rx_cmd_fn *ble_hci_shm_rx_cmd_ll_cb;
+static void *ble_hci_shm_rx_cmd_ll_arg;
+static ble_hci_trans_rx_acl_fn *ble_hci_shm_rx_acl_ll_cb;
+static void *ble_hci_shm_rx_acl_ll_arg;
+
+static struct os_mempool ble_hci_shm_evt_hi_pool;
+static struct os_mempool ble_hci_shm_evt_lo_pool;
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+static struct os_mempool ble_hci_shm_evt_small_pool;
+#endif
+#else
+static ble_hci_trans_rx_cmd_fn *ble_hci_shm_rx_cmd_hs_cb;
+static void *ble_hci_shm_rx_cmd_hs_arg;
+static ble_hci_trans_rx_acl_fn *ble_hci_shm_rx_acl_hs_cb;
+static void *ble_hci_shm_rx_acl_hs_arg;
+
+static uint8_t *ble_hci_shm_cmd_buf;
+static uint8_t ble_hci_shm_cmd_buf_alloced;
+#endif
+
+/* Pool backing the ACL mbufs this side posts to the peer as credits. */
+static struct os_mempool ble_hci_shm_acl_pool;
+static struct os_mbuf_pool ble_hci_shm_acl_mbuf_pool;
+
+/* Empty peer-owned mbufs available for outgoing ACL data. */
+static struct os_mbuf *ble_hci_shm_credits[MYNEWT_VAL(BLE_ACL_BUF_COUNT)];
+static uint8_t ble_hci_shm_credit_cnt;
+
+/* Number of credits we still owe the peer (pool was empty at post time). */
+static uint8_t ble_hci_shm_credits_owed;
+
+/* Outgoing ACL packets waiting for a credit or for ring space. */
+static STAILQ_HEAD(, os_mbuf_pkthdr) ble_hci_shm_acl_txq;
+
+static void
+ble_hci_shm_signal(void)
+{
+    if (ble_hci_shm_signal_cb != NULL) {
+        ble_hci_shm_signal_cb(ble_hci_shm_signal_arg);
+    }
+}
+
+static int
+ble_hci_shm_ring_put(struct ble_hci_shm_ring *ring, uint8_t type, void *buf,
+                     uint16_t len)
+{
+    struct ble_hci_shm_msg *msg;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if ((uint16_t)(ring->bhsr_head - ring->bhsr_tail) >=
+        BLE_HCI_SHM_RING_SIZE) {
+
+        OS_EXIT_CRITICAL(sr);
+        return BLE_ERR_MEM_CAPACITY;
+    }
+
+    msg = &ring->bhsr_msgs[ring->bhsr_head & BLE_HCI_SHM_RING_MASK];
+    msg->bhsm_buf = (uint32_t)(uintptr_t)buf;
+    msg->bhsm_len = len;
+    msg->bhsm_type = type;
+
+    /* The slot must be filled in before the head advance publishes it. */
+    ring->bhsr_head = ring->bhsr_head + 1;
+    OS_EXIT_CRITICAL(sr);
+
+    ble_hci_shm_signal();
+
+    return 0;
+}
+
+static int
+ble_hci_shm_ring_get(struct ble_hci_shm_ring *ring,
+                     struct ble_hci_shm_msg *msg)
+{
+    if (ring->bhsr_tail == ring->bhsr_head) {
+        return -1;
+    }
+
+    *msg = ring->bhsr_msgs[ring->bhsr_tail & BLE_HCI_SHM_RING_MASK];
+    ring->bhsr_tail = ring->bhsr_tail + 1;
+
+    return 0;
+}
+
+/**
+ * Posts fresh ACL credits until the debt is paid or our pool runs dry.
+ * A dry pool means the stack still holds previously delivered mbufs;
+ * the debt is retried on every subsequent transport activity.
+ */
+static void
+ble_hci_shm_credit_replenish(void)
+{
+    struct os_mbuf *om;
+    os_sr_t sr;
+    int rc;
+
+    while (ble_hci_shm_credits_owed > 0) {
+        om = os_mbuf_get_pkthdr(&ble_hci_shm_acl_mbuf_pool,
+                                sizeof(struct ble_mbuf_hdr));
+        if (om == NULL) {
+            break;
+        }
+
+        rc = ble_hci_shm_ring_put(ble_hci_shm_tx_ring,
+                                  BLE_HCI_SHM_MSG_CREDIT, om, 0);
+        if (rc != 0) {
+            os_mbuf_free_chain(om);
+            break;
+        }
+
+        OS_ENTER_CRITICAL(sr);
+        ble_hci_shm_credits_owed--;
+        OS_EXIT_CRITICAL(sr);
+    }
+}
+
+/**
+ * Sends as many queued ACL packets as available credits and ring space
+ * allow.  Each packet is flattened into a credited peer-owned mbuf and
+ * handed off by address; the local chain is then freed.
+ */
+static void
+ble_hci_shm_acl_txq_drain(void)
+{
+    struct os_mbuf_pkthdr *pkthdr;
+    struct os_mbuf *om;
+    struct os_mbuf *dst;
+    os_sr_t sr;
+    int pktlen;
+    int rc;
+
+    while (1) {
+        OS_ENTER_CRITICAL(sr);
+        pkthdr = STAILQ_FIRST(&ble_hci_shm_acl_txq);
+        if (pkthdr == NULL || ble_hci_shm_credit_cnt == 0) {
+            OS_EXIT_CRITICAL(sr);
+            break;
+        }
+        STAILQ_REMOVE_HEAD(&ble_hci_shm_acl_txq, omp_next);
+        dst = ble_hci_shm_credits[--ble_hci_shm_credit_cnt];
+        OS_EXIT_CRITICAL(sr);
+
+        om = OS_MBUF_PKTHDR_TO_MBUF(pkthdr);
+        pktlen = OS_MBUF_PKTLEN(om);
+
+        /*
+         * Both images size their ACL pools from the same syscfg values,
+         * so a credited mbuf always has room for a maximum-length
+         * packet.  The peer's pool descriptor must not be dereferenced
+         * here, hence the explicit capacity check.
+         */
+        assert(pktlen <=
+               MYNEWT_VAL(BLE_ACL_BUF_SIZE) + BLE_HCI_DATA_HDR_SZ);
+
+        os_mbuf_copydata(om, 0, pktlen, dst->om_data);
+        dst->om_len = pktlen;
+        OS_MBUF_PKTHDR(dst)->omp_len = pktlen;
+
+        rc = ble_hci_shm_ring_put(ble_hci_shm_tx_ring, BLE_HCI_SHM_MSG_ACL,
+                                  dst, pktlen);
+        if (rc != 0) {
+            /* Ring full; put everything back and retry on next doorbell. */
+            OS_ENTER_CRITICAL(sr);
+            ble_hci_shm_credits[ble_hci_shm_credit_cnt++] = dst;
+            STAILQ_INSERT_HEAD(&ble_hci_shm_acl_txq, pkthdr, omp_next);
+            OS_EXIT_CRITICAL(sr);
+            break;
+        }
+
+        os_mbuf_free_chain(om);
+    }
+}
+
+static int
+ble_hci_shm_acl_tx(struct os_mbuf *om)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    STAILQ_INSERT_TAIL(&ble_hci_shm_acl_txq, OS_MBUF_PKTHDR(om), omp_next);
+    OS_EXIT_CRITICAL(sr);
+
+    ble_hci_shm_acl_txq_drain();
+
+    return 0;
+}
+
+/*
+ * Walks a NULL-terminated packet chain (linked via the mbuf packet
+ * header), detaching each packet and queueing it for transmission.
+ */
+static int
+ble_hci_shm_acl_tx_chain(struct os_mbuf *om)
+{
+    struct os_mbuf_pkthdr *pkthdr;
+    struct os_mbuf *next;
+
+    while (om != NULL) {
+        pkthdr = OS_MBUF_PKTHDR(om);
+        next = STAILQ_NEXT(pkthdr, omp_next) ?
+            OS_MBUF_PKTHDR_TO_MBUF(STAILQ_NEXT(pkthdr, omp_next)) : NULL;
+        STAILQ_NEXT(pkthdr, omp_next) = NULL;
+
+        ble_hci_shm_acl_tx(om);
+        om = next;
+    }
+
+    return 0;
+}
+
+/**
+ * Returns a flat buffer to the pool it was allocated from; called when
+ * the peer frees one of our buffers.
+ */
+static void
+ble_hci_shm_buf_ret(uint8_t *buf)
+{
+#if BLE_HCI_SHM_CTLR
+    if (os_memblock_from(&ble_hci_shm_evt_hi_pool, buf)) {
+        os_memblock_put(&ble_hci_shm_evt_hi_pool, buf);
+    } else if (os_memblock_from(&ble_hci_shm_evt_lo_pool, buf)) {
+        os_memblock_put(&ble_hci_shm_evt_lo_pool, buf);
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    } else if (os_memblock_from(&ble_hci_shm_evt_small_pool, buf)) {
+        os_memblock_put(&ble_hci_shm_evt_small_pool, buf);
+#endif
+    } else {
+        assert(0);
+    }
+#else
+    assert(buf == ble_hci_shm_cmd_buf);
+    assert(ble_hci_shm_cmd_buf_alloced);
+    ble_hci_shm_cmd_buf_alloced = 0;
+#endif
+}
+
+void
+ble_hci_shm_doorbell(void)
+{
+    struct ble_hci_shm_msg msg;
+    struct os_mbuf *om;
+    uint8_t *buf;
+    os_sr_t sr;
+    int rc;
+
+    while (ble_hci_shm_ring_get(ble_hci_shm_rx_ring, &msg) == 0) {
+        buf = (uint8_t *)(uintptr_t)msg.bhsm_buf;
+
+        switch (msg.bhsm_type) {
+#if BLE_HCI_SHM_CTLR
+        case BLE_HCI_SHM_MSG_CMD:
+            assert(ble_hci_shm_rx_cmd_ll_cb != NULL);
+            rc = ble_hci_shm_rx_cmd_ll_cb(buf, ble_hci_shm_rx_cmd_ll_arg);
+            if (rc != 0) {
+                ble_hci_trans_buf_free(buf);
+            }
+            break;
+#else
+        case BLE_HCI_SHM_MSG_EVT:
+            assert(ble_hci_shm_rx_cmd_hs_cb != NULL);
+            rc = ble_hci_shm_rx_cmd_hs_cb(buf, ble_hci_shm_rx_cmd_hs_arg);
+            if (rc != 0) {
+                ble_hci_trans_buf_free(buf);
+            }
+            break;
+#endif
+
+        case BLE_HCI_SHM_MSG_ACL:
+            om = (struct os_mbuf *)(uintptr_t)msg.bhsm_buf;
+
+            /* The delivered mbuf consumed a posted credit. */
+            OS_ENTER_CRITICAL(sr);
+            ble_hci_shm_credits_owed++;
+            OS_EXIT_CRITICAL(sr);
+
+#if BLE_HCI_SHM_CTLR
+            assert(ble_hci_shm_rx_acl_ll_cb != NULL);
+            ble_hci_shm_rx_acl_ll_cb(om, ble_hci_shm_rx_acl_ll_arg);
+#else
+            assert(ble_hci_shm_rx_acl_hs_cb != NULL);
+            ble_hci_shm_rx_acl_hs_cb(om, ble_hci_shm_rx_acl_hs_arg);
+#endif
+            break;
+
+        case BLE_HCI_SHM_MSG_BUF_RET:
+            ble_hci_shm_buf_ret(buf);
+            break;
+
+        case BLE_HCI_SHM_MSG_CREDIT:
+            om = (struct os_mbuf *)(uintptr_t)msg.bhsm_buf;
+            OS_ENTER_CRITICAL(sr);
+            assert(ble_hci_shm_credit_cnt < MYNEWT_VAL(BLE_ACL_BUF_COUNT));
+            ble_hci_shm_credits[ble_hci_shm_credit_cnt++] = om;
+            OS_EXIT_CRITICAL(sr);
+            break;
+
+        default:
+            assert(0);
+            break;
+        }
+    }
+
+    ble_hci_shm_credit_replenish();
+    ble_hci_shm_acl_txq_drain();
+}
+
+void
+ble_hci_trans_cfg_hs(ble_hci_trans_rx_cmd_fn *cmd_cb,
+                     void *cmd_arg,
+                     ble_hci_trans_rx_acl_fn *acl_cb,
+                     void *acl_arg)
+{
+#if !BLE_HCI_SHM_CTLR
+    ble_hci_shm_rx_cmd_hs_cb = cmd_cb;
+    ble_hci_shm_rx_cmd_hs_arg = cmd_arg;
+    ble_hci_shm_rx_acl_hs_cb = acl_cb;
+    ble_hci_shm_rx_acl_hs_arg = acl_arg;
+#endif
+}
+
+void
+ble_hci_trans_cfg_ll(ble_hci_trans_rx_cmd_fn *cmd_cb,
+                     void *cmd_arg,
+                     ble_hci_trans_rx_acl_fn *acl_cb,
+                     void *acl_arg)
+{
+#if BLE_HCI_SHM_CTLR
+    ble_hci_shm_rx_cmd_ll_cb = cmd_cb;
+    ble_hci_shm_rx_cmd_ll_arg = cmd_arg;
+    ble_hci_shm_rx_acl_ll_cb = acl_cb;
+    ble_hci_shm_rx_acl_ll_arg = acl_arg;
+#endif
+}
+
+int
+ble_hci_trans_hs_cmd_tx(uint8_t *cmd)
+{
+    int rc;
+
+    rc = ble_hci_shm_ring_put(ble_hci_shm_tx_ring, BLE_HCI_SHM_MSG_CMD, cmd,
+                              cmd[2] + BLE_HCI_CMD_HDR_LEN);
+    if (rc != 0) {
+        ble_hci_trans_buf_free(cmd);
+    }
+    return rc;
+}
+
+int
+ble_hci_trans_ll_evt_tx(uint8_t *hci_ev)
+{
+    int rc;
+
+    rc = ble_hci_shm_ring_put(ble_hci_shm_tx_ring, BLE_HCI_SHM_MSG_EVT,
+                              hci_ev, hci_ev[1] + BLE_HCI_EVENT_HDR_LEN);
+    if (rc != 0) {
+        ble_hci_trans_buf_free(hci_ev);
+    }
+    return rc;
+}
+
+int
+ble_hci_trans_hs_acl_tx(struct os_mbuf *om)
+{
+    return ble_hci_shm_acl_tx(om);
+}
+
+int
+ble_hci_trans_ll_acl_tx(struct os_mbuf *om)
+{
+    return ble_hci_shm_acl_tx(om);
+}
+
+int
+ble_hci_trans_hs_acl_tx_chain(struct os_mbuf *om)
+{
+    return ble_hci_shm_acl_tx_chain(om);
+}
+
+int
+ble_hci_trans_ll_acl_tx_chain(struct os_mbuf *om)
+{
+    return ble_hci_shm_acl_tx_chain(om);
+}
+
+uint8_t *
+ble_hci_trans_buf_alloc(int type)
+{
+    uint8_t *buf;
+
+    switch (type) {
+#if BLE_HCI_SHM_CTLR
+    case BLE_HCI_TRANS_BUF_EVT_HI:
+        buf = os_memblock_get(&ble_hci_shm_evt_hi_pool);
+        if (buf == NULL) {
+            /* If no high-priority event buffers remain, try to grab a
+             * low-priority one.
+             */
+            buf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
+        }
+        break;
+
+    case BLE_HCI_TRANS_BUF_EVT_LO:
+        buf = os_memblock_get(&ble_hci_shm_evt_lo_pool);
+        break;
+
+    case BLE_HCI_TRANS_BUF_EVT_SMALL:
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+        buf = os_memblock_get(&ble_hci_shm_evt_small_pool);
+        if (buf == NULL) {
+            /* Small events always fit in a low-priority buffer. */
+            buf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
+        }
+#else
+        buf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
+#endif
+        break;
+#else
+    case BLE_HCI_TRANS_BUF_CMD:
+        assert(!ble_hci_shm_cmd_buf_alloced);
+        ble_hci_shm_cmd_buf_alloced = 1;
+        buf = ble_hci_shm_cmd_buf;
+        break;
+#endif
+
+    default:
+        assert(0);
+        buf = NULL;
+    }
+
+    return buf;
+}
+
+void
+ble_hci_trans_buf_free(uint8_t *buf)
+{
+    int rc;
+
+    /* Peer-owned buffers go back to their owner via the message ring.
+     * The rings are sized to hold every outstanding buffer, so this
+     * cannot fail.
+     */
+    if (buf >= ble_hci_shm_peer_area &&
+        buf < ble_hci_shm_peer_area + ble_hci_shm_peer_area_sz) {
+
+        rc = ble_hci_shm_ring_put(ble_hci_shm_tx_ring,
+                                  BLE_HCI_SHM_MSG_BUF_RET, buf, 0);
+        assert(rc == 0);
+    } else {
+        ble_hci_shm_buf_ret(buf);
+    }
+
+    /* A freed buffer is a chance to pay down any credit debt. */
+    ble_hci_shm_credit_replenish();
+}
+
+/**
+ * Unsupported; the shared rings cannot be reset unilaterally while the
+ * peer core is running.
+ */
+int
+ble_hci_trans_reset(void)
+{
+    return 0;
+}
+
+int
+ble_hci_shm_init(const struct ble_hci_shm_cfg *cfg)
+{
+    struct ble_hci_shm_hdr *hdr;
+    uint8_t *ctlr_area;
+    uint8_t *host_area;
+    uint8_t *u;
+    int rc;
+
+    assert(cfg != NULL);
+    assert(cfg->bhsc_mem != NULL);
+
+    /* The ring index arithmetic requires a power-of-2 slot count. */
+    assert((BLE_HCI_SHM_RING_SIZE & (BLE_HCI_SHM_RING_SIZE - 1)) == 0);
+
+    /*
+     * Both sides lay the region out identically from syscfg values:
+     * the header (with both rings), then the host-owned buffers, then
+     * the controller-owned buffers.
+     */
+    u = cfg->bhsc_mem;
+    hdr = (struct ble_hci_shm_hdr *)u;
+    u += OS_ALIGN(sizeof(*hdr), OS_ALIGNMENT);
+
+    host_area = u;
+    u += OS_ALIGN(BLE_HCI_TRANS_CMD_SZ, OS_ALIGNMENT);
+    u += MYNEWT_VAL(BLE_ACL_BUF_COUNT) * BLE_HCI_SHM_ACL_BLOCK_SIZE;
+
+    ctlr_area = u;
+    u += MYNEWT_VAL(BLE_HCI_EVT_HI_BUF_COUNT) *
+         OS_ALIGN(MYNEWT_VAL(BLE_HCI_EVT_BUF_SIZE), OS_ALIGNMENT);
+    u += MYNEWT_VAL(BLE_HCI_EVT_LO_BUF_COUNT) *
+         OS_ALIGN(MYNEWT_VAL(BLE_HCI_EVT_BUF_SIZE), OS_ALIGNMENT);
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    u += MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT) *
+         OS_ALIGN(BLE_HCI_TRANS_BUF_EVT_SMALL_SZ, OS_ALIGNMENT);
+#endif
+    u += MYNEWT_VAL(BLE_ACL_BUF_COUNT) * BLE_HCI_SHM_ACL_BLOCK_SIZE;
+
+    if (u - (uint8_t *)cfg->bhsc_mem > cfg->bhsc_mem_size) {
+        return BLE_ERR_MEM_CAPACITY;
+    }
+
+    ble_hci_shm_region = hdr;
+    ble_hci_shm_signal_cb = cfg->bhsc_signal_cb;
+    ble_hci_shm_signal_arg = cfg->bhsc_signal_arg;
+
+    STAILQ_INIT(&ble_hci_shm_acl_txq);
+    ble_hci_shm_credit_cnt = 0;
+    ble_hci_shm_credits_owed = MYNEWT_VAL(BLE_ACL_BUF_COUNT);
+
+#if BLE_HCI_SHM_CTLR
+    ble_hci_shm_tx_ring = &hdr->bhsh_c2h;
+    ble_hci_shm_rx_ring = &hdr->bhsh_h2c;
+    ble_hci_shm_peer_area = host_area;
+    ble_hci_shm_peer_area_sz = ctlr_area - host_area;
+
+    u = ctlr_area;
+    rc = os_mempool_init(&ble_hci_shm_evt_hi_pool,
+                         MYNEWT_VAL(BLE_HCI_EVT_HI_BUF_COUNT),
+                         OS_ALIGN(MYNEWT_VAL(BLE_HCI_EVT_BUF_SIZE),
+                                  OS_ALIGNMENT),
+                         u, "ble_hci_shm_evt_hi_pool");
+    assert(rc == 0);
+    u += MYNEWT_VAL(BLE_HCI_EVT_HI_BUF_COUNT) *
+         OS_ALIGN(MYNEWT_VAL(BLE_HCI_EVT_BUF_SIZE), OS_ALIGNMENT);
+
+    rc = os_mempool_init(&ble_hci_shm_evt_lo_pool,
+                         MYNEWT_VAL(BLE_HCI_EVT_LO_BUF_COUNT),
+                         OS_ALIGN(MYNEWT_VAL(BLE_HCI_EVT_BUF_SIZE),
+                                  OS_ALIGNMENT),
+                         u, "ble_hci_shm_evt_lo_pool");
+    assert(rc == 0);
+    u += MYNEWT_VAL(BLE_HCI_EVT_LO_BUF_COUNT) *
+         OS_ALIGN(MYNEWT_VAL(BLE_HCI_EVT_BUF_SIZE), OS_ALIGNMENT);
+
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    rc = os_mempool_init(&ble_hci_shm_evt_small_pool,
+                         MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT),
+                         OS_ALIGN(BLE_HCI_TRANS_BUF_EVT_SMALL_SZ,
+                                  OS_ALIGNMENT),
+                         u, "ble_hci_shm_evt_small_pool");
+    assert(rc == 0);
+    u += MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT) *
+         OS_ALIGN(BLE_HCI_TRANS_BUF_EVT_SMALL_SZ, OS_ALIGNMENT);
+#endif
+
+    rc = os_mempool_init(&ble_hci_shm_acl_pool,
+                         MYNEWT_VAL(BLE_ACL_BUF_COUNT),
+                         BLE_HCI_SHM_ACL_BLOCK_SIZE,
+                         u, "ble_hci_shm_acl_pool");
+    assert(rc == 0);
+
+    /*
+     * The host side laid out the region and stamped the magic before
+     * this core was released from reset.
+     */
+    assert(hdr->bhsh_magic == BLE_HCI_SHM_MAGIC);
+    hdr->bhsh_ctlr_ready = 1;
+#else
+    ble_hci_shm_tx_ring = &hdr->bhsh_h2c;
+    ble_hci_shm_rx_ring = &hdr->bhsh_c2h;
+    ble_hci_shm_peer_area = ctlr_area;
+    ble_hci_shm_peer_area_sz = u - ctlr_area;
+
+    u = host_area;
+    ble_hci_shm_cmd_buf = u;
+    ble_hci_shm_cmd_buf_alloced = 0;
+    u += OS_ALIGN(BLE_HCI_TRANS_CMD_SZ, OS_ALIGNMENT);
+
+    rc = os_mempool_init(&ble_hci_shm_acl_pool,
+                         MYNEWT_VAL(BLE_ACL_BUF_COUNT),
+                         BLE_HCI_SHM_ACL_BLOCK_SIZE,
+                         u, "ble_hci_shm_acl_pool");
+    assert(rc == 0);
+
+    /* The host initializes the shared region. */
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->bhsh_magic = BLE_HCI_SHM_MAGIC;
+    hdr->bhsh_host_ready = 1;
+#endif
+
+    rc = os_mbuf_pool_init(&ble_hci_shm_acl_mbuf_pool, &ble_hci_shm_acl_pool,
+                           BLE_HCI_SHM_ACL_BLOCK_SIZE,
+                           MYNEWT_VAL(BLE_ACL_BUF_COUNT));
+    assert(rc == 0);
+
+    /* Post the initial ACL credits; they wait on the ring until the
+     * peer core comes up and processes them.
+     */
+    ble_hci_shm_credit_replenish();
+
+    return 0;
+}
@@ -39,7 +39,9 @@
 #include "transport/uart/ble_hci_uart.h"
 
 #define BLE_HCI_UART_EVT_COUNT  \
-    (MYNEWT_VAL(BLE_HCI_EVT_HI_BUF_COUNT) + MYNEWT_VAL(BLE_HCI_EVT_LO_BUF_COUNT))
+    (MYNEWT_VAL(BLE_HCI_EVT_HI_BUF_COUNT) +     \
+     MYNEWT_VAL(BLE_HCI_EVT_LO_BUF_COUNT) +     \
+     MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT))
 
 /***
  * NOTES:
@@ -85,6 +87,11 @@ static void *ble_hci_uart_evt_hi_buf;
 static struct os_mempool ble_hci_uart_evt_lo_pool;
 static void *ble_hci_uart_evt_lo_buf;
 
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+static struct os_mempool ble_hci_uart_evt_small_pool;
+static void *ble_hci_uart_evt_small_buf;
+#endif
+
 static struct os_mempool ble_hci_uart_cmd_pool;
 static void *ble_hci_uart_cmd_buf;
 
@@ -143,6 +150,39 @@ static struct {
 
 static uint16_t ble_hci_uart_max_acl_datalen;
 
+#if MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
+/*
+ * Block-mode transfers. Instead of per-character callbacks, the H4
+ * stream is reassembled with length-aware reads: the packet type
+ * indicator and the packet header are read with small armed buffers
+ * and the announced body is then received straight into the target
+ * command/event buffer or ACL mbuf in one transfer, so a packet costs
+ * three rx interrupts instead of one per byte. Transmit submits the
+ * type indicator, then the payload (per mbuf segment for ACL data),
+ * from the completion callback. Requires an MCU driver that backs
+ * hal_uart_tx_buf()/hal_uart_rx_buf() with DMA or FIFO bursts.
+ */
+
+/* Receive phases */
+#define BLE_HCI_UART_RX_PHASE_TYPE      (0)
+#define BLE_HCI_UART_RX_PHASE_HDR       (1)
+#define BLE_HCI_UART_RX_PHASE_BODY      (2)
+
+/* Scratch buffer for headers and bodies of skipped packets */
+#define BLE_HCI_UART_BLK_SINK_SZ        (32)
+
+static uint8_t ble_hci_uart_blk_rx_phase;
+static uint8_t ble_hci_uart_blk_rx_type;    /* armed type indicator */
+static uint16_t ble_hci_uart_blk_rx_rem;    /* skipped body bytes left */
+static uint8_t ble_hci_uart_blk_sink[BLE_HCI_UART_BLK_SINK_SZ];
+
+static uint8_t ble_hci_uart_blk_tx_h4;      /* submitted type indicator */
+static uint8_t ble_hci_uart_blk_tx_phase;   /* 0: type byte, 1: payload */
+static struct os_mbuf *ble_hci_uart_blk_tx_seg;
+
+static void ble_hci_uart_blk_tx_kick(void);
+#endif
+
 /**
  * Allocates a buffer (mbuf) for ACL operation.
  *
@@ -182,11 +222,46 @@ ble_hci_uart_acl_tx(struct os_mbuf *om)
     STAILQ_INSERT_TAIL(&ble_hci_uart_state.tx_pkts, pkt, next);
     OS_EXIT_CRITICAL(sr);
 
+#if MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
+    ble_hci_uart_blk_tx_kick();
+#else
     hal_uart_start_tx(MYNEWT_VAL(BLE_HCI_UART_PORT));
+#endif
 
     return 0;
 }
 
+/*
+ * Detaches and transmits each packet of a NULL-terminated chain (linked
+ * via the mbuf packet header).  The whole chain is consumed; the first
+ * nonzero result is returned.  Over a wire transport there is no
+ * receiver wakeup to batch, so this is equivalent to queueing the
+ * packets one at a time.
+ */
+static int
+ble_hci_uart_acl_tx_chain(struct os_mbuf *om)
+{
+    struct os_mbuf_pkthdr *pkthdr;
+    struct os_mbuf *next;
+    int rc;
+    int first_rc;
+
+    first_rc = 0;
+    while (om != NULL) {
+        pkthdr = OS_MBUF_PKTHDR(om);
+        next = STAILQ_NEXT(pkthdr, omp_next) ?
+            OS_MBUF_PKTHDR_TO_MBUF(STAILQ_NEXT(pkthdr, omp_next)) : NULL;
+        STAILQ_NEXT(pkthdr, omp_next) = NULL;
+
+        rc = ble_hci_uart_acl_tx(om);
+        if (rc != 0 && first_rc == 0) {
+            first_rc = rc;
+        }
+        om = next;
+    }
+    return first_rc;
+}
+
 static int
 ble_hci_uart_cmdevt_tx(uint8_t *hci_ev, uint8_t h4_type)
 {
@@ -206,7 +281,11 @@ ble_hci_uart_cmdevt_tx(uint8_t *hci_ev, uint8_t h4_type)
     STAILQ_INSERT_TAIL(&ble_hci_uart_state.tx_pkts, pkt, next);
     OS_EXIT_CRITICAL(sr);
 
+#if MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
+    ble_hci_uart_blk_tx_kick();
+#else
     hal_uart_start_tx(MYNEWT_VAL(BLE_HCI_UART_PORT));
+#endif
 
     return 0;
 }
@@ -267,6 +346,7 @@ ble_hci_uart_tx_pkt_type(void)
     return rc;
 }
 
+#if !MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
 /**
  * @return                      The byte to transmit on success;
  *                              -1 if there is nothing to send.
@@ -303,6 +383,7 @@ ble_hci_uart_tx_char(void *arg)
 
     return rc;
 }
+#endif
 
 #if MYNEWT_VAL(BLE_DEVICE)
 /**
@@ -454,6 +535,7 @@ ble_hci_uart_rx_sync_loss(uint8_t data)
     ble_hci_uart_state.rx_cmd.cur = index;
 }
 
+#if !MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
 static void
 ble_hci_uart_rx_cmd(uint8_t data)
 {
@@ -506,8 +588,10 @@ ble_hci_uart_rx_skip_cmd(uint8_t data)
     }
 }
 #endif
+#endif
 
 #if MYNEWT_VAL(BLE_HOST)
+#if !MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
 static void
 ble_hci_uart_rx_evt(uint8_t data)
 {
@@ -535,7 +619,9 @@ ble_hci_uart_rx_evt(uint8_t data)
     }
 }
 #endif
+#endif
 
+#if !MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
 static void
 ble_hci_uart_rx_acl(uint8_t data)
 {
@@ -641,6 +727,371 @@ ble_hci_uart_rx_char(void *arg, uint8_t data)
         return 0;
     }
 }
+#endif /* !BLE_HCI_UART_BLOCK_MODE */
+
+#if MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
+/**
+ * Picks the next queued packet and submits its H4 packet type
+ * indicator; the payload follows from the completion callback.
+ * Safe to call from any context; does nothing if a transmit is
+ * already in flight.
+ */
+static void
+ble_hci_uart_blk_tx_kick(void)
+{
+    os_sr_t sr;
+    int type;
+
+    OS_ENTER_CRITICAL(sr);
+    if (ble_hci_uart_state.tx_type != BLE_HCI_UART_H4_NONE) {
+        OS_EXIT_CRITICAL(sr);
+        return;
+    }
+    type = ble_hci_uart_tx_pkt_type();
+    if (type < 0) {
+        OS_EXIT_CRITICAL(sr);
+        return;
+    }
+
+    ble_hci_uart_blk_tx_h4 = (uint8_t)type;
+    ble_hci_uart_blk_tx_phase = 0;
+    if (type == BLE_HCI_UART_H4_ACL) {
+        ble_hci_uart_blk_tx_seg = ble_hci_uart_state.tx_acl;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    hal_uart_tx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                    &ble_hci_uart_blk_tx_h4, 1);
+}
+
+/**
+ * Transmit buffer completion. Submits the payload after the type
+ * indicator, walks the mbuf chain one segment per transfer for ACL
+ * data, and starts the next queued packet when the current one is
+ * fully on the wire.
+ *
+ * Context: interrupt
+ */
+static void
+ble_hci_uart_blk_tx_done(void *arg, int len)
+{
+    switch (ble_hci_uart_state.tx_type) {
+    case BLE_HCI_UART_H4_CMD:
+    case BLE_HCI_UART_H4_EVT:
+        if (ble_hci_uart_blk_tx_phase == 0) {
+            ble_hci_uart_blk_tx_phase = 1;
+            hal_uart_tx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                            ble_hci_uart_state.tx_cmd.data,
+                            ble_hci_uart_state.tx_cmd.len);
+            return;
+        }
+        ble_hci_trans_buf_free(ble_hci_uart_state.tx_cmd.data);
+        ble_hci_uart_state.tx_type = BLE_HCI_UART_H4_NONE;
+        break;
+
+    case BLE_HCI_UART_H4_ACL:
+        if (ble_hci_uart_blk_tx_phase != 0) {
+            ble_hci_uart_blk_tx_seg = SLIST_NEXT(ble_hci_uart_blk_tx_seg,
+                                                 om_next);
+        }
+        ble_hci_uart_blk_tx_phase = 1;
+
+        /* Submit the next non-empty segment of the chain */
+        while (ble_hci_uart_blk_tx_seg != NULL &&
+               ble_hci_uart_blk_tx_seg->om_len == 0) {
+            ble_hci_uart_blk_tx_seg = SLIST_NEXT(ble_hci_uart_blk_tx_seg,
+                                                 om_next);
+        }
+        if (ble_hci_uart_blk_tx_seg != NULL) {
+            hal_uart_tx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                            ble_hci_uart_blk_tx_seg->om_data,
+                            ble_hci_uart_blk_tx_seg->om_len);
+            return;
+        }
+        os_mbuf_free_chain(ble_hci_uart_state.tx_acl);
+        ble_hci_uart_state.tx_type = BLE_HCI_UART_H4_NONE;
+        break;
+
+    default:
+        break;
+    }
+
+    ble_hci_uart_blk_tx_kick();
+}
+
+/**
+ * Arms reception of the next H4 packet type indicator.
+ */
+static void
+ble_hci_uart_blk_rx_start(void)
+{
+    ble_hci_uart_blk_rx_phase = BLE_HCI_UART_RX_PHASE_TYPE;
+    hal_uart_rx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                    &ble_hci_uart_blk_rx_type, 1, 1);
+}
+
+/**
+ * Arms reception of the next chunk of a packet body that is being
+ * skipped (no buffer could be allocated for it).
+ */
+static void
+ble_hci_uart_blk_rx_sink(void)
+{
+    int len;
+
+    len = ble_hci_uart_blk_rx_rem;
+    if (len > BLE_HCI_UART_BLK_SINK_SZ) {
+        len = BLE_HCI_UART_BLK_SINK_SZ;
+    }
+    hal_uart_rx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                    ble_hci_uart_blk_sink, len, len);
+}
+
+/**
+ * Arms reception of the header of the packet announced by the type
+ * indicator, or of single bytes while scanning for a reset command
+ * after a loss of sync. Packets being skipped collect their header in
+ * the sink buffer.
+ */
+static void
+ble_hci_uart_blk_rx_hdr_arm(void)
+{
+    uint8_t *dst;
+    int len;
+
+    ble_hci_uart_blk_rx_phase = BLE_HCI_UART_RX_PHASE_HDR;
+
+    switch (ble_hci_uart_state.rx_type) {
+#if MYNEWT_VAL(BLE_DEVICE)
+    case BLE_HCI_UART_H4_CMD:
+        dst = ble_hci_uart_state.rx_cmd.data;
+        len = BLE_HCI_CMD_HDR_LEN;
+        break;
+    case BLE_HCI_UART_H4_SKIP_CMD:
+        dst = ble_hci_uart_blk_sink;
+        len = BLE_HCI_CMD_HDR_LEN;
+        break;
+    case BLE_HCI_UART_H4_SYNC_LOSS:
+        dst = ble_hci_uart_blk_sink;
+        len = 1;
+        break;
+#endif
+#if MYNEWT_VAL(BLE_HOST)
+    case BLE_HCI_UART_H4_EVT:
+        dst = ble_hci_uart_state.rx_cmd.data;
+        len = BLE_HCI_EVENT_HDR_LEN;
+        break;
+#endif
+    case BLE_HCI_UART_H4_ACL:
+        dst = ble_hci_uart_state.rx_acl.dptr;
+        len = BLE_HCI_DATA_HDR_SZ;
+        break;
+    case BLE_HCI_UART_H4_SKIP_ACL:
+        dst = ble_hci_uart_blk_sink;
+        len = BLE_HCI_DATA_HDR_SZ;
+        break;
+    default:
+        /* Unknown type on a host build; resynchronize on the next byte */
+        ble_hci_uart_blk_rx_start();
+        return;
+    }
+
+    hal_uart_rx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT), dst, len, len);
+}
+
+/**
+ * Completes the current packet: hands it to the registered callback
+ * and re-arms reception of the next type indicator.
+ */
+static void
+ble_hci_uart_blk_rx_done(void)
+{
+    int rc;
+
+    switch (ble_hci_uart_state.rx_type) {
+#if MYNEWT_VAL(BLE_DEVICE)
+    case BLE_HCI_UART_H4_CMD:
+#endif
+#if MYNEWT_VAL(BLE_HOST)
+    case BLE_HCI_UART_H4_EVT:
+#endif
+        assert(ble_hci_uart_rx_cmd_cb != NULL);
+        rc = ble_hci_uart_rx_cmd_cb(ble_hci_uart_state.rx_cmd.data,
+                                    ble_hci_uart_rx_cmd_arg);
+        if (rc != 0) {
+            ble_hci_trans_buf_free(ble_hci_uart_state.rx_cmd.data);
+        }
+        break;
+
+    case BLE_HCI_UART_H4_ACL:
+        assert(ble_hci_uart_rx_acl_cb != NULL);
+        OS_MBUF_PKTLEN(ble_hci_uart_state.rx_acl.buf) =
+            ble_hci_uart_state.rx_acl.len;
+        ble_hci_uart_state.rx_acl.buf->om_len = ble_hci_uart_state.rx_acl.len;
+        ble_hci_uart_rx_acl_cb(ble_hci_uart_state.rx_acl.buf,
+                               ble_hci_uart_rx_acl_arg);
+        break;
+
+    case BLE_HCI_UART_H4_SKIP_ACL:
+/* XXX: I dont like this but for now this denotes controller only */
+#if MYNEWT_VAL(BLE_DEVICE)
+        ble_ll_data_buffer_overflow();
+#endif
+        break;
+
+    default:
+        break;
+    }
+
+    ble_hci_uart_state.rx_type = BLE_HCI_UART_H4_NONE;
+    ble_hci_uart_blk_rx_start();
+}
+
+/**
+ * Receive buffer completion. Walks the packet through its type,
+ * header and body phases, arming each read with the exact length the
+ * previous one announced.
+ *
+ * Context: interrupt
+ */
+static void
+ble_hci_uart_blk_rx_buf_func(void *arg, uint8_t *buf, int len)
+{
+    uint16_t pktlen;
+
+    if (ble_hci_uart_blk_rx_phase == BLE_HCI_UART_RX_PHASE_TYPE) {
+        ble_hci_uart_rx_pkt_type(ble_hci_uart_blk_rx_type);
+        if (ble_hci_uart_state.rx_type == BLE_HCI_UART_H4_NONE) {
+            ble_hci_uart_blk_rx_start();
+        } else {
+            ble_hci_uart_blk_rx_hdr_arm();
+        }
+        return;
+    }
+
+    switch (ble_hci_uart_state.rx_type) {
+#if MYNEWT_VAL(BLE_DEVICE)
+    case BLE_HCI_UART_H4_SYNC_LOSS:
+        /* Scan the stream for a reset command one byte at a time */
+        ble_hci_uart_rx_sync_loss(buf[0]);
+        if (ble_hci_uart_state.rx_type == BLE_HCI_UART_H4_NONE) {
+            ble_hci_uart_blk_rx_start();
+        } else {
+            ble_hci_uart_blk_rx_hdr_arm();
+        }
+        return;
+
+    case BLE_HCI_UART_H4_CMD:
+        if (ble_hci_uart_blk_rx_phase == BLE_HCI_UART_RX_PHASE_HDR) {
+            ble_hci_uart_state.rx_cmd.len =
+                ble_hci_uart_state.rx_cmd.data[2] + BLE_HCI_CMD_HDR_LEN;
+            if (ble_hci_uart_state.rx_cmd.len > BLE_HCI_CMD_HDR_LEN) {
+                ble_hci_uart_blk_rx_phase = BLE_HCI_UART_RX_PHASE_BODY;
+                hal_uart_rx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                                ble_hci_uart_state.rx_cmd.data +
+                                BLE_HCI_CMD_HDR_LEN,
+                                ble_hci_uart_state.rx_cmd.len -
+                                BLE_HCI_CMD_HDR_LEN,
+                                ble_hci_uart_state.rx_cmd.len -
+                                BLE_HCI_CMD_HDR_LEN);
+                return;
+            }
+        }
+        ble_hci_uart_blk_rx_done();
+        return;
+
+    case BLE_HCI_UART_H4_SKIP_CMD:
+        if (ble_hci_uart_blk_rx_phase == BLE_HCI_UART_RX_PHASE_HDR) {
+            ble_hci_uart_blk_rx_rem = ble_hci_uart_blk_sink[2];
+        } else {
+            ble_hci_uart_blk_rx_rem -= len;
+        }
+        if (ble_hci_uart_blk_rx_rem > 0) {
+            ble_hci_uart_blk_rx_phase = BLE_HCI_UART_RX_PHASE_BODY;
+            ble_hci_uart_blk_rx_sink();
+            return;
+        }
+        ble_hci_uart_blk_rx_done();
+        return;
+#endif
+
+#if MYNEWT_VAL(BLE_HOST)
+    case BLE_HCI_UART_H4_EVT:
+        if (ble_hci_uart_blk_rx_phase == BLE_HCI_UART_RX_PHASE_HDR) {
+            ble_hci_uart_state.rx_cmd.len =
+                ble_hci_uart_state.rx_cmd.data[1] + BLE_HCI_EVENT_HDR_LEN;
+            if (ble_hci_uart_state.rx_cmd.len > BLE_HCI_EVENT_HDR_LEN) {
+                ble_hci_uart_blk_rx_phase = BLE_HCI_UART_RX_PHASE_BODY;
+                hal_uart_rx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                                ble_hci_uart_state.rx_cmd.data +
+                                BLE_HCI_EVENT_HDR_LEN,
+                                ble_hci_uart_state.rx_cmd.len -
+                                BLE_HCI_EVENT_HDR_LEN,
+                                ble_hci_uart_state.rx_cmd.len -
+                                BLE_HCI_EVENT_HDR_LEN);
+                return;
+            }
+        }
+        ble_hci_uart_blk_rx_done();
+        return;
+#endif
+
+    case BLE_HCI_UART_H4_ACL:
+        if (ble_hci_uart_blk_rx_phase == BLE_HCI_UART_RX_PHASE_HDR) {
+            pktlen = ble_hci_uart_state.rx_acl.dptr[3];
+            pktlen = (pktlen << 8) + ble_hci_uart_state.rx_acl.dptr[2];
+            ble_hci_uart_state.rx_acl.len = pktlen + BLE_HCI_DATA_HDR_SZ;
+
+            /*
+             * Data portion cannot exceed data length of acl buffer. If it
+             * does this is considered to be a loss of sync.
+             */
+            if (pktlen > ble_hci_uart_max_acl_datalen) {
+                os_mbuf_free_chain(ble_hci_uart_state.rx_acl.buf);
+#if MYNEWT_VAL(BLE_DEVICE)
+                ble_hci_uart_sync_lost();
+                ble_hci_uart_blk_rx_hdr_arm();
+#else
+                ble_hci_uart_state.rx_type = BLE_HCI_UART_H4_NONE;
+                ble_hci_uart_blk_rx_start();
+#endif
+                return;
+            }
+            if (pktlen > 0) {
+                ble_hci_uart_blk_rx_phase = BLE_HCI_UART_RX_PHASE_BODY;
+                hal_uart_rx_buf(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                                ble_hci_uart_state.rx_acl.dptr +
+                                BLE_HCI_DATA_HDR_SZ,
+                                pktlen, pktlen);
+                return;
+            }
+        }
+        ble_hci_uart_blk_rx_done();
+        return;
+
+    case BLE_HCI_UART_H4_SKIP_ACL:
+        if (ble_hci_uart_blk_rx_phase == BLE_HCI_UART_RX_PHASE_HDR) {
+            pktlen = ble_hci_uart_blk_sink[3];
+            pktlen = (pktlen << 8) + ble_hci_uart_blk_sink[2];
+            ble_hci_uart_blk_rx_rem = pktlen;
+        } else {
+            ble_hci_uart_blk_rx_rem -= len;
+        }
+        if (ble_hci_uart_blk_rx_rem > 0) {
+            ble_hci_uart_blk_rx_phase = BLE_HCI_UART_RX_PHASE_BODY;
+            ble_hci_uart_blk_rx_sink();
+            return;
+        }
+        ble_hci_uart_blk_rx_done();
+        return;
+
+    default:
+        ble_hci_uart_state.rx_type = BLE_HCI_UART_H4_NONE;
+        ble_hci_uart_blk_rx_start();
+        return;
+    }
+}
+#endif /* BLE_HCI_UART_BLOCK_MODE */
 
 static void
 ble_hci_uart_set_rx_cbs(ble_hci_trans_rx_cmd_fn *cmd_cb,
@@ -685,6 +1136,11 @@ ble_hci_uart_free_mem(void)
     free(ble_hci_uart_evt_lo_buf);
     ble_hci_uart_evt_lo_buf = NULL;
 
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    free(ble_hci_uart_evt_small_buf);
+    ble_hci_uart_evt_small_buf = NULL;
+#endif
+
     free(ble_hci_uart_pkt_buf);
     ble_hci_uart_pkt_buf = NULL;
 
@@ -700,9 +1156,15 @@ ble_hci_uart_config(void)
 {
     int rc;
 
+#if MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
+    rc = hal_uart_init_buf_cbs(MYNEWT_VAL(BLE_HCI_UART_PORT),
+                               ble_hci_uart_blk_tx_done,
+                               ble_hci_uart_blk_rx_buf_func, NULL);
+#else
     rc = hal_uart_init_cbs(MYNEWT_VAL(BLE_HCI_UART_PORT),
                            ble_hci_uart_tx_char, NULL,
                            ble_hci_uart_rx_char, NULL);
+#endif
     if (rc != 0) {
         return BLE_ERR_UNSPECIFIED;
     }
@@ -717,6 +1179,11 @@ ble_hci_uart_config(void)
         return BLE_ERR_HW_FAIL;
     }
 
+#if MYNEWT_VAL(BLE_HCI_UART_BLOCK_MODE)
+    /* Arm reception of the first packet type indicator */
+    ble_hci_uart_blk_rx_start();
+#endif
+
     return 0;
 }
 
@@ -755,6 +1222,20 @@ ble_hci_trans_ll_acl_tx(struct os_mbuf *om)
     return rc;
 }
 
+/**
+ * Sends a chain of ACL data packets from controller to host.
+ *
+ * @param om                    The first ACL data packet of the chain.
+ *
+ * @return                      0 on success;
+ *                              A BLE_ERR_[...] error code on failure.
+ */
+int
+ble_hci_trans_ll_acl_tx_chain(struct os_mbuf *om)
+{
+    return ble_hci_uart_acl_tx_chain(om);
+}
+
 /**
  * Sends an HCI command from the host to the controller.
  *
@@ -790,6 +1271,20 @@ ble_hci_trans_hs_acl_tx(struct os_mbuf *om)
     return rc;
 }
 
+/**
+ * Sends a chain of ACL data packets from host to controller.
+ *
+ * @param om                    The first ACL data packet of the chain.
+ *
+ * @return                      0 on success;
+ *                              A BLE_ERR_[...] error code on failure.
+ */
+int
+ble_hci_trans_hs_acl_tx_chain(struct os_mbuf *om)
+{
+    return ble_hci_uart_acl_tx_chain(om);
+}
+
 /**
  * Configures the HCI transport to call the specified callback upon receiving
  * HCI packets from the controller.  This function should only be called by by
@@ -867,6 +1362,18 @@ ble_hci_trans_buf_alloc(int type)
         buf = os_memblock_get(&ble_hci_uart_evt_lo_pool);
         break;
 
+    case BLE_HCI_TRANS_BUF_EVT_SMALL:
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+        buf = os_memblock_get(&ble_hci_uart_evt_small_pool);
+        if (buf == NULL) {
+            /* Small events always fit in a low-priority buffer. */
+            buf = os_memblock_get(&ble_hci_uart_evt_lo_pool);
+        }
+#else
+        buf = os_memblock_get(&ble_hci_uart_evt_lo_pool);
+#endif
+        break;
+
     default:
         assert(0);
         buf = NULL;
@@ -900,6 +1407,11 @@ ble_hci_trans_buf_free(uint8_t *buf)
     } else if (os_memblock_from(&ble_hci_uart_evt_lo_pool, buf)) {
         rc = os_memblock_put(&ble_hci_uart_evt_lo_pool, buf);
         assert(rc == 0);
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    } else if (os_memblock_from(&ble_hci_uart_evt_small_pool, buf)) {
+        rc = os_memblock_put(&ble_hci_uart_evt_small_pool, buf);
+        assert(rc == 0);
+#endif
     } else {
         assert(os_memblock_from(&ble_hci_uart_cmd_pool, buf));
         rc = os_memblock_put(&ble_hci_uart_cmd_pool, buf);
@@ -1027,6 +1539,18 @@ ble_hci_uart_init(void)
         goto err;
     }
 
+#if MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT)
+    rc = mem_malloc_mempool(&ble_hci_uart_evt_small_pool,
+                            MYNEWT_VAL(BLE_HCI_EVT_SMALL_BUF_COUNT),
+                            BLE_HCI_TRANS_BUF_EVT_SMALL_SZ,
+                            "ble_hci_uart_evt_small_pool",
+                            &ble_hci_uart_evt_small_buf);
+    if (rc != 0) {
+        rc = ble_err_from_os(rc);
+        goto err;
+    }
+#endif
+
     /*
      * Create memory pool of packet list nodes. NOTE: the number of these
      * buffers should be, at least, the total number of event buffers (hi
@@ -80,6 +80,9 @@ oc_client_cb_t *oc_ri_alloc_client_cb(const char *uri,
 oc_client_cb_t *oc_ri_get_client_cb(const char *uri, oc_server_handle_t *server,
                                     oc_method_t method);
 
+oc_client_cb_t *oc_ri_get_client_cb_by_token(uint8_t *token,
+                                             uint8_t token_len);
+
 void oc_ri_remove_client_cb_by_mid(uint16_t mid);
 
 oc_discovery_flags_t oc_ri_process_discovery_payload(uint8_t *payload, int len,
@@ -227,6 +227,14 @@ typedef struct oc_rep_s
 uint16_t oc_parse_rep(const uint8_t *payload, uint16_t payload_size,
                       oc_rep_t **value_list);
 
+/*
+ * Like oc_parse_rep(), but decodes straight out of an mbuf chain (e.g.
+ * the payload located by coap_parse_message_mbuf()) without flattening.
+ */
+struct os_mbuf;
+uint16_t oc_parse_rep_mbuf(struct os_mbuf *m, uint16_t off, uint16_t len,
+                           oc_rep_t **value_list);
+
 void oc_free_rep(oc_rep_t *rep);
 
 #ifdef __cplusplus
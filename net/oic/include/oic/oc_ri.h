@@ -22,10 +22,22 @@
 #include "oc_uuid.h"
 #include "../../src/port/oc_connectivity.h"
 
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+#include "stats/stats.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+STATS_SECT_START(oc_res_stats)
+    STATS_SECT_ENTRY(requests)
+    STATS_SECT_ENTRY(errors)
+    STATS_SECT_ENTRY(handler_us)
+STATS_SECT_END
+#endif
+
 typedef enum { OC_GET = 1, OC_POST, OC_PUT, OC_DELETE } oc_method_t;
 
 typedef enum {
@@ -110,9 +122,17 @@ typedef struct
 
 typedef void (*oc_request_handler_t)(oc_request_t *, oc_interface_mask_t);
 
+/*
+ * Application check invoked before observers are notified; returning
+ * false suppresses the notification (e.g. the value moved less than
+ * the app's reporting threshold).
+ */
+typedef bool (*oc_notify_filter_t)(oc_resource_t *resource, void *arg);
+
 typedef struct oc_resource_s
 {
   struct oc_resource_s *next;
+  struct oc_resource_s *uri_hash_next; /* bucket chain of the URI index */
   int device;
   oc_string_t uri;
   oc_string_array_t types;
@@ -126,6 +146,17 @@ typedef struct oc_resource_s
   struct os_callout callout;
   uint16_t observe_period_seconds;
   uint8_t num_observers;
+
+  /* observe notification shaping; see oc_resource_set_notify_min_interval */
+  uint32_t notify_min_interval; /* min ticks between notifications; 0 = off */
+  os_time_t notify_last;
+  struct os_callout notify_callout;
+  oc_notify_filter_t notify_filter;
+  void *notify_filter_arg;
+
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+  STATS_SECT_DECL(oc_res_stats) stats;
+#endif
 } oc_resource_t;
 
 void oc_ri_init(void);
@@ -141,6 +172,14 @@ oc_resource_t *oc_ri_get_app_resources(void);
 #ifdef OC_SERVER
 oc_resource_t *oc_ri_alloc_resource(void);
 bool oc_ri_add_resource(oc_resource_t *resource);
+
+/*
+ * Notifies a resource's observers subject to its shaping policy:
+ * the notify filter may suppress the update and updates arriving
+ * inside the minimum interval are coalesced into one deferred
+ * notification.  Returns the observer count.
+ */
+int oc_ri_notify_observers(oc_resource_t *resource);
 void oc_ri_delete_resource(oc_resource_t *resource);
 #endif
 
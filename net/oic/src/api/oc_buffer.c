@@ -19,6 +19,11 @@
 #include <os/os_eventq.h>
 #include <os/os_mempool.h>
 
+#if MYNEWT_VAL(OC_RX_CLASSES)
+#include <os/os_time.h>
+#include <stats/stats.h>
+#endif
+
 #include "messaging/coap/engine.h"
 #include "port/oc_signal_main_loop.h"
 
@@ -37,7 +42,43 @@ static uint8_t oc_buffer_area[OS_MEMPOOL_BYTES(MAX_NUM_CONCURRENT_REQUESTS * 2,
 
 static void oc_buffer_handler(struct os_event *);
 
+#if MYNEWT_VAL(OC_RX_CLASSES)
+/*
+ * Inbound messages are sorted into latency classes at enqueue time and
+ * drained in priority order, so a discovery or telemetry storm cannot
+ * queue ahead of an actuator command.
+ */
+#define OC_RX_CLASS_URGENT      0       /* PUT/POST/DELETE requests */
+#define OC_RX_CLASS_NORMAL      1       /* unicast GET, responses */
+#define OC_RX_CLASS_BULK        2       /* multicast GET (discovery) */
+#define OC_RX_NUM_CLASSES       3
+
+static struct oc_message_s *oc_buffer_inq_cls[OC_RX_NUM_CLASSES];
+
+STATS_SECT_START(oc_rx_stats)
+    STATS_SECT_ENTRY(urgent)
+    STATS_SECT_ENTRY(normal)
+    STATS_SECT_ENTRY(bulk)
+    STATS_SECT_ENTRY(urgent_lat)
+    STATS_SECT_ENTRY(normal_lat)
+    STATS_SECT_ENTRY(bulk_lat)
+    STATS_SECT_ENTRY(deferred)
+STATS_SECT_END
+
+STATS_NAME_START(oc_rx_stats)
+    STATS_NAME(oc_rx_stats, urgent)
+    STATS_NAME(oc_rx_stats, normal)
+    STATS_NAME(oc_rx_stats, bulk)
+    STATS_NAME(oc_rx_stats, urgent_lat)
+    STATS_NAME(oc_rx_stats, normal_lat)
+    STATS_NAME(oc_rx_stats, bulk_lat)
+    STATS_NAME(oc_rx_stats, deferred)
+STATS_NAME_END(oc_rx_stats)
+
+static STATS_SECT_DECL(oc_rx_stats) oc_rx_stats;
+#else
 static struct oc_message_s *oc_buffer_inq;
+#endif
 static struct oc_message_s *oc_buffer_outq;
 static struct os_event oc_buffer_ev = {
     .ev_cb = oc_buffer_handler
@@ -48,6 +89,11 @@ oc_buffer_init(void)
 {
     os_mempool_init(&oc_buffers, MAX_NUM_CONCURRENT_REQUESTS * 2,
       sizeof(oc_message_t), oc_buffer_area, "oc_bufs");
+#if MYNEWT_VAL(OC_RX_CLASSES)
+    stats_init_and_reg(STATS_HDR(oc_rx_stats),
+      STATS_SIZE_INIT_PARMS(oc_rx_stats, STATS_SIZE_32),
+      STATS_NAME_INIT_PARMS(oc_rx_stats), "oc_rx");
+#endif
 }
 
 oc_message_t *
@@ -102,10 +148,43 @@ oc_queue_msg(struct oc_message_s **head, struct oc_message_s *msg)
     }
 }
 
+#if MYNEWT_VAL(OC_RX_CLASSES)
+static int
+oc_rx_classify(struct oc_message_s *msg)
+{
+    uint8_t code;
+
+    if (msg->length < 2) {
+        return OC_RX_CLASS_NORMAL;
+    }
+#ifdef OC_SECURITY
+    /* DTLS records are classed once their payload comes back decrypted */
+    if (msg->data[0] > 19 && msg->data[0] < 64) {
+        return OC_RX_CLASS_NORMAL;
+    }
+#endif
+    code = msg->data[1];
+    if (code >= COAP_POST && code <= COAP_DELETE) {
+        /* actuator commands and other state changes */
+        return OC_RX_CLASS_URGENT;
+    }
+    if (code == COAP_GET && (msg->endpoint.flags & MULTICAST)) {
+        /* discovery floods arrive as multicast GETs */
+        return OC_RX_CLASS_BULK;
+    }
+    return OC_RX_CLASS_NORMAL;
+}
+#endif
+
 void
 oc_recv_message(oc_message_t *message)
 {
+#if MYNEWT_VAL(OC_RX_CLASSES)
+    message->queued_at = os_time_get();
+    oc_queue_msg(&oc_buffer_inq_cls[oc_rx_classify(message)], message);
+#else
     oc_queue_msg(&oc_buffer_inq, message);
+#endif
     os_eventq_put(oc_evq_get(), &oc_buffer_ev);
 }
 
@@ -172,11 +251,96 @@ oc_buffer_rx(struct oc_message_s *msg)
 #endif
 }
 
+#if MYNEWT_VAL(OC_RX_CLASSES)
+/*
+ * Pop the highest-priority queued message whose class still has budget.
+ * Urgent is never budgeted; a command queued behind a storm is at most
+ * one in-progress message away from dispatch.
+ */
+static struct oc_message_s *
+oc_buffer_rx_dequeue(int *budgets)
+{
+    struct oc_message_s *msg;
+    uint32_t lat;
+    int i;
+
+    for (i = 0; i < OC_RX_NUM_CLASSES; i++) {
+        msg = oc_buffer_inq_cls[i];
+        if (!msg) {
+            continue;
+        }
+        if (i != OC_RX_CLASS_URGENT && budgets[i] <= 0) {
+            continue;
+        }
+        oc_buffer_inq_cls[i] = msg->next;
+        msg->next = NULL;
+        if (i != OC_RX_CLASS_URGENT) {
+            budgets[i]--;
+        }
+        lat = os_time_get() - msg->queued_at;
+        switch (i) {
+        case OC_RX_CLASS_URGENT:
+            STATS_INC(oc_rx_stats, urgent);
+            if (lat > oc_rx_stats.surgent_lat) {
+                oc_rx_stats.surgent_lat = lat;
+            }
+            break;
+        case OC_RX_CLASS_NORMAL:
+            STATS_INC(oc_rx_stats, normal);
+            if (lat > oc_rx_stats.snormal_lat) {
+                oc_rx_stats.snormal_lat = lat;
+            }
+            break;
+        default:
+            STATS_INC(oc_rx_stats, bulk);
+            if (lat > oc_rx_stats.sbulk_lat) {
+                oc_rx_stats.sbulk_lat = lat;
+            }
+            break;
+        }
+        return msg;
+    }
+    return NULL;
+}
+#endif
+
 static void
 oc_buffer_handler(struct os_event *ev)
 {
     struct oc_message_s *msg;
+#if MYNEWT_VAL(OC_RX_CLASSES)
+    int budgets[OC_RX_NUM_CLASSES] = {
+        0,
+        MYNEWT_VAL(OC_RX_CLASS_BUDGET),
+        MYNEWT_VAL(OC_RX_CLASS_BUDGET)
+    };
+    int busy;
 
+    do {
+        busy = 0;
+        msg = oc_buffer_outq;
+        if (msg) {
+            oc_buffer_outq = msg->next;
+            msg->next = NULL;
+            oc_buffer_tx(msg);
+            busy = 1;
+        }
+        msg = oc_buffer_rx_dequeue(budgets);
+        if (msg) {
+            oc_buffer_rx(msg);
+            busy = 1;
+        }
+    } while (busy);
+    if (oc_buffer_inq_cls[OC_RX_CLASS_NORMAL] ||
+        oc_buffer_inq_cls[OC_RX_CLASS_BULK]) {
+        /*
+         * Out of budget with backlog remaining; requeue ourselves so
+         * timers and other events on the shared queue run in between.
+         */
+        STATS_INC(oc_rx_stats, deferred);
+        os_eventq_put(oc_evq_get(), &oc_buffer_ev);
+    }
+#else
     while (oc_buffer_outq || oc_buffer_inq) {
         msg = oc_buffer_outq;
         if (msg) {
@@ -191,4 +355,5 @@ oc_buffer_handler(struct os_event *ev)
             oc_buffer_rx(msg);
         }
     }
+#endif
 }
@@ -24,11 +24,67 @@
 #include "api/oc_priv.h"
 #include <tinycbor/cbor_buf_writer.h>
 #include <tinycbor/cbor_buf_reader.h>
+#include <tinycbor/cbor_mbuf_reader.h>
 
+#if MYNEWT_VAL(OC_REP_ARENA)
+#include <string.h>
+#include <mem/mem.h>
+#include <stats/stats.h>
+
+#include "util/oc_mmem.h"
+
+/*
+ * Request-scoped arena.  Every parse-side allocation - rep nodes,
+ * strings, arrays - is a bump off this region, and freeing the tree is
+ * a single O(1) reset.  Parse/free pairs never overlap across requests
+ * in this stack, so one arena serves all of them.
+ */
+static struct mem_arena oc_rep_arena;
+static uint8_t oc_rep_arena_buf[MYNEWT_VAL(OC_REP_ARENA_SIZE)];
+
+STATS_SECT_START(oc_rep_stats)
+    STATS_SECT_ENTRY(trees)
+    STATS_SECT_ENTRY(peak)
+STATS_SECT_END
+
+STATS_NAME_START(oc_rep_stats)
+    STATS_NAME(oc_rep_stats, trees)
+    STATS_NAME(oc_rep_stats, peak)
+STATS_NAME_END(oc_rep_stats)
+
+static STATS_SECT_DECL(oc_rep_stats) oc_rep_stats;
+
+static void
+oc_rep_arena_handle(struct oc_mmem *m, unsigned int size)
+{
+  m->next = NULL;
+  m->ptr = mem_arena_alloc(&oc_rep_arena, size);
+  oc_assert(m->ptr != NULL);
+  m->size = size;
+  memset(m->ptr, 0, size);
+}
+
+#define oc_rep_alloc_string(s, sz) oc_rep_arena_handle((s), (sz))
+#define oc_rep_new_int_array(a, sz)                                         \
+  oc_rep_arena_handle((a), (sz) * sizeof(int64_t))
+#define oc_rep_new_double_array(a, sz)                                      \
+  oc_rep_arena_handle((a), (sz) * sizeof(double))
+#define oc_rep_new_bool_array(a, sz)                                        \
+  oc_rep_arena_handle((a), (sz) * sizeof(bool))
+#define oc_rep_new_string_array(a, sz)                                      \
+  oc_rep_arena_handle((a), (sz) * STRING_ARRAY_ITEM_MAX_LEN)
+#else
 static struct os_mempool oc_rep_objects;
 static uint8_t oc_rep_objects_area[OS_MEMPOOL_BYTES(EST_NUM_REP_OBJECTS,
       sizeof(oc_rep_t))];
 
+#define oc_rep_alloc_string(s, sz) oc_alloc_string((s), (sz))
+#define oc_rep_new_int_array(a, sz) oc_new_int_array((a), (sz))
+#define oc_rep_new_double_array(a, sz) oc_new_double_array((a), (sz))
+#define oc_rep_new_bool_array(a, sz) oc_new_bool_array((a), (sz))
+#define oc_rep_new_string_array(a, sz) oc_new_string_array((a), (sz))
+#endif
+
 static const CborEncoder g_empty;
 static uint8_t *g_buf;
 CborEncoder g_encoder, root_map, links_array;
@@ -64,13 +120,33 @@ oc_rep_reset(void)
 static oc_rep_t *
 _alloc_rep(void)
 {
+#if MYNEWT_VAL(OC_REP_ARENA)
+    oc_rep_t *rep = mem_arena_alloc(&oc_rep_arena, sizeof(oc_rep_t));
+#else
     oc_rep_t *rep = os_memblock_get(&oc_rep_objects);
+#endif
 #ifdef DEBUG
     oc_assert(rep != NULL);
 #endif
     return rep;
 }
 
+#if MYNEWT_VAL(OC_REP_ARENA)
+void
+oc_free_rep(oc_rep_t *rep)
+{
+    if (rep == NULL) {
+        return;
+    }
+    /*
+     * The whole tree lives in the arena; one reset reclaims it.  The
+     * arena's high watermark doubles as the peak per-request usage.
+     */
+    STATS_INC(oc_rep_stats, trees);
+    oc_rep_stats.speak = oc_rep_arena.ma_hwm;
+    mem_arena_reset(&oc_rep_arena);
+}
+#else
 static void
 _free_rep(oc_rep_t *rep_value)
 {
@@ -114,6 +190,7 @@ oc_free_rep(oc_rep_t *rep)
     oc_free_string(&rep->name);
     _free_rep(rep);
 }
+#endif /* MYNEWT_VAL(OC_REP_ARENA) */
 
 /*
   An Object is a collection of key-value pairs.
@@ -141,7 +218,7 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
   /* key */
   *err |= cbor_value_calculate_string_length(value, &len);
   len++;
-  oc_alloc_string(&cur->name, len);
+  oc_rep_alloc_string(&cur->name, len);
   *err |= cbor_value_copy_text_string(value, (char *)oc_string(cur->name), &len,
                                       NULL);
   *err |= cbor_value_advance(value);
@@ -162,7 +239,7 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
   case CborByteStringType:
     *err |= cbor_value_calculate_string_length(value, &len);
     len++;
-    oc_alloc_string(&cur->value_string, len);
+    oc_rep_alloc_string(&cur->value_string, len);
     *err |= cbor_value_copy_byte_string(
       value, oc_cast(cur->value_string, uint8_t), &len, NULL);
     cur->type = BYTE_STRING;
@@ -170,7 +247,7 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
   case CborTextStringType:
     *err |= cbor_value_calculate_string_length(value, &len);
     len++;
-    oc_alloc_string(&cur->value_string, len);
+    oc_rep_alloc_string(&cur->value_string, len);
     *err |= cbor_value_copy_text_string(value, oc_string(cur->value_string),
                                         &len, NULL);
     cur->type = STRING;
@@ -202,7 +279,7 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
       switch (array.type) {
       case CborIntegerType:
         if (k == 0) {
-          oc_new_int_array(&cur->value_array, len);
+          oc_rep_new_int_array(&cur->value_array, len);
           cur->type = INT | ARRAY;
         }
         *err |=
@@ -210,7 +287,7 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
         break;
       case CborDoubleType:
         if (k == 0) {
-          oc_new_double_array(&cur->value_array, len);
+          oc_rep_new_double_array(&cur->value_array, len);
           cur->type = DOUBLE | ARRAY;
         }
         *err |=
@@ -218,7 +295,7 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
         break;
       case CborBooleanType:
         if (k == 0) {
-          oc_new_bool_array(&cur->value_array, len);
+          oc_rep_new_bool_array(&cur->value_array, len);
           cur->type = BOOL | ARRAY;
         }
         *err |=
@@ -226,7 +303,7 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
         break;
       case CborByteStringType:
         if (k == 0) {
-          oc_new_string_array(&cur->value_array, len);
+          oc_rep_new_string_array(&cur->value_array, len);
           cur->type = BYTE_STRING | ARRAY;
         }
         *err |= cbor_value_calculate_string_length(&array, &len);
@@ -237,7 +314,7 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
         break;
       case CborTextStringType:
         if (k == 0) {
-          oc_new_string_array(&cur->value_array, len);
+          oc_rep_new_string_array(&cur->value_array, len);
           cur->type = STRING | ARRAY;
         }
         *err |= cbor_value_calculate_string_length(&array, &len);
@@ -278,17 +355,14 @@ oc_parse_rep_value(CborValue *value, oc_rep_t **rep, CborError *err)
   }
 }
 
-uint16_t
-oc_parse_rep(const uint8_t *in_payload, uint16_t payload_size,
-             oc_rep_t **out_rep)
+static uint16_t
+oc_parse_rep_reader(struct cbor_decoder_reader *d, oc_rep_t **out_rep)
 {
   CborParser parser;
   CborValue root_value, cur_value, map;
   CborError err = CborNoError;
-  struct cbor_buf_reader br;
 
-  cbor_buf_reader_init(&br, in_payload, payload_size);
-  err |= cbor_parser_init(&br.r, 0, &parser, &root_value);
+  err |= cbor_parser_init(d, 0, &parser, &root_value);
   if (cbor_value_is_map(&root_value)) {
     err |= cbor_value_enter_container(&root_value, &cur_value);
     *out_rep = 0;
@@ -315,9 +389,37 @@ oc_parse_rep(const uint8_t *in_payload, uint16_t payload_size,
   return (uint16_t)err;
 }
 
+uint16_t
+oc_parse_rep(const uint8_t *in_payload, uint16_t payload_size,
+             oc_rep_t **out_rep)
+{
+  struct cbor_buf_reader br;
+
+  cbor_buf_reader_init(&br, in_payload, payload_size);
+  return oc_parse_rep_reader(&br.r, out_rep);
+}
+
+uint16_t
+oc_parse_rep_mbuf(struct os_mbuf *m, uint16_t off, uint16_t len,
+                  oc_rep_t **out_rep)
+{
+  struct CborMbufReader br;
+
+  cbor_mbuf_reader_init_len(&br, m, off, len);
+  return oc_parse_rep_reader(&br.r, out_rep);
+}
+
 void
 oc_rep_init(void)
 {
+#if MYNEWT_VAL(OC_REP_ARENA)
+    mem_arena_init(&oc_rep_arena, oc_rep_arena_buf,
+      sizeof(oc_rep_arena_buf));
+    stats_init_and_reg(STATS_HDR(oc_rep_stats),
+      STATS_SIZE_INIT_PARMS(oc_rep_stats, STATS_SIZE_32),
+      STATS_NAME_INIT_PARMS(oc_rep_stats), "oc_rep");
+#else
     os_mempool_init(&oc_rep_objects, EST_NUM_REP_OBJECTS,
       sizeof(oc_rep_t), oc_rep_objects_area, "oc_rep_o");
+#endif
 }
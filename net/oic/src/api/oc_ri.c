@@ -20,6 +20,9 @@
 
 #include <os/os_callout.h>
 #include <os/os_mempool.h>
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+#include <os/os_cputime.h>
+#endif
 
 #include "util/oc_list.h"
 
@@ -51,7 +54,24 @@ static struct os_mempool oc_resources;
 static uint8_t oc_resource_area[OS_MEMPOOL_BYTES(MAX_APP_RESOURCES,
       sizeof(oc_resource_t))];
 
+/*
+ * Hash index over registered resource URIs (leading '/' excluded), so
+ * request routing stays flat as the resource count grows.  Buckets are
+ * chained through oc_resource_s->uri_hash_next.
+ */
+#define OC_URI_HASH_SIZE 8
+static oc_resource_t *oc_uri_hash[OC_URI_HASH_SIZE];
+
 static void periodic_observe_handler(struct os_event *ev);
+static void deferred_notify_handler(struct os_event *ev);
+
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+STATS_NAME_START(oc_res_stats)
+    STATS_NAME(oc_res_stats, requests)
+    STATS_NAME(oc_res_stats, errors)
+    STATS_NAME(oc_res_stats, handler_us)
+STATS_NAME_END(oc_res_stats)
+#endif
 #endif /* OC_SERVER */
 
 #ifdef OC_CLIENT
@@ -201,15 +221,32 @@ stop_processes(void)
 }
 
 #ifdef OC_SERVER
+static uint8_t
+oc_ri_uri_hash(const char *s, size_t len)
+{
+  uint8_t h = 0;
+
+  while (len--) {
+    h = (h * 31) + (uint8_t)*s++;
+  }
+  return h & (OC_URI_HASH_SIZE - 1);
+}
+
 oc_resource_t *
 oc_ri_get_app_resource_by_uri(const char *uri)
 {
-  oc_resource_t *res = oc_ri_get_app_resources();
-  while (res != NULL) {
-    if (oc_string_len(res->uri) == strlen(uri) &&
-        strncmp(uri, oc_string(res->uri), strlen(uri)) == 0)
+  oc_resource_t *res;
+  size_t len = strlen(uri);
+
+  if (len > 0 && uri[0] == '/') {
+    uri++;
+    len--;
+  }
+  for (res = oc_uri_hash[oc_ri_uri_hash(uri, len)]; res != NULL;
+       res = res->uri_hash_next) {
+    if (oc_string_len(res->uri) == len + 1 &&
+        strncmp(uri, oc_string(res->uri) + 1, len) == 0)
       return res;
-    res = res->next;
   }
   return res;
 }
@@ -223,6 +260,7 @@ oc_ri_init(void)
 
 #ifdef OC_SERVER
   oc_list_init(app_resources);
+  memset(oc_uri_hash, 0, sizeof(oc_uri_hash));
   os_mempool_init(&oc_resources, MAX_APP_RESOURCES, sizeof(oc_resource_t),
     oc_resource_area, "oc_res");
   oc_list_init(observe_callbacks);
@@ -257,6 +295,8 @@ oc_ri_alloc_resource(void)
     if (resource) {
         os_callout_init(&resource->callout, oc_evq_get(),
           periodic_observe_handler, resource);
+        os_callout_init(&resource->notify_callout, oc_evq_get(),
+          deferred_notify_handler, resource);
     }
     return resource;
 }
@@ -264,12 +304,26 @@ oc_ri_alloc_resource(void)
 void
 oc_ri_delete_resource(oc_resource_t *resource)
 {
+    oc_resource_t **cur;
+    uint8_t hash;
+
+    hash = oc_ri_uri_hash(oc_string(resource->uri) + 1,
+      oc_string_len(resource->uri) - 1);
+    for (cur = &oc_uri_hash[hash]; *cur != NULL;
+      cur = &(*cur)->uri_hash_next) {
+        if (*cur == resource) {
+            *cur = resource->uri_hash_next;
+            break;
+        }
+    }
+    oc_list_remove(app_resources, resource);
     os_memblock_put(&oc_resources, resource);
 }
 
 bool
 oc_ri_add_resource(oc_resource_t *resource)
 {
+    uint8_t hash;
     bool valid = true;
 
     if (!resource->get_handler && !resource->put_handler &&
@@ -282,6 +336,16 @@ oc_ri_add_resource(oc_resource_t *resource)
     }
     if (valid) {
         oc_list_add(app_resources, resource);
+        hash = oc_ri_uri_hash(oc_string(resource->uri) + 1,
+          oc_string_len(resource->uri) - 1);
+        resource->uri_hash_next = oc_uri_hash[hash];
+        oc_uri_hash[hash] = resource;
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+        stats_init_and_reg(STATS_HDR(resource->stats),
+          STATS_SIZE_INIT_PARMS(resource->stats, STATS_SIZE_32),
+          STATS_NAME_INIT_PARMS(oc_res_stats),
+          oc_string(resource->uri));
+#endif
     }
 
     return valid;
@@ -303,6 +367,49 @@ periodic_observe_handler(struct os_event *ev)
     }
 }
 
+/* fires at the end of a hold-off with coalesced updates to report */
+static void
+deferred_notify_handler(struct os_event *ev)
+{
+    struct oc_resource_s *resource;
+
+    resource = ev->ev_arg;
+
+    resource->notify_last = os_time_get();
+    coap_notify_observers(resource, NULL, NULL);
+}
+
+int
+oc_ri_notify_observers(oc_resource_t *resource)
+{
+    os_time_t now;
+    os_time_t elapsed;
+
+    if (!resource) {
+        return coap_notify_observers(resource, NULL, NULL);
+    }
+    if (resource->notify_filter &&
+      !resource->notify_filter(resource, resource->notify_filter_arg)) {
+        /* change below the app's reporting threshold */
+        return resource->num_observers;
+    }
+    if (resource->notify_min_interval == 0) {
+        return coap_notify_observers(resource, NULL, NULL);
+    }
+    now = os_time_get();
+    elapsed = now - resource->notify_last;
+    if (elapsed >= resource->notify_min_interval) {
+        resource->notify_last = now;
+        return coap_notify_observers(resource, NULL, NULL);
+    }
+    /* inside the hold-off; fold this update into one deferred notification */
+    if (!os_callout_queued(&resource->notify_callout)) {
+        os_callout_reset(&resource->notify_callout,
+          resource->notify_min_interval - elapsed);
+    }
+    return resource->num_observers;
+}
+
 #endif
 
 oc_interface_mask_t
@@ -462,11 +569,11 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
   }
 
 #ifdef OC_SERVER
-  /* Check against list of declared application resources.
+  /* Check the URI index of declared application resources.
    */
   if (!cur_resource && !bad_request) {
-    for (resource = oc_ri_get_app_resources(); resource;
-         resource = resource->next) {
+    for (resource = oc_uri_hash[oc_ri_uri_hash(uri_path, uri_path_len)];
+         resource; resource = resource->uri_hash_next) {
       if (oc_string_len(resource->uri) == (uri_path_len + 1) &&
           strncmp((const char *)oc_string(resource->uri) + 1, uri_path,
                   uri_path_len) == 0) {
@@ -520,6 +627,9 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
              * based on the request method. If the resource has not
              * implemented that method, then return a 4.05 response.
              */
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+      uint32_t handler_ts = os_cputime_get32();
+#endif
       if (method == OC_GET && cur_resource->get_handler) {
         cur_resource->get_handler(&request_obj, interface);
       } else if (method == OC_POST && cur_resource->post_handler) {
@@ -531,6 +641,11 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
       } else {
         method_impl = false;
       }
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+      STATS_INC(cur_resource->stats, requests);
+      STATS_INCN(cur_resource->stats, handler_us,
+        os_cputime_ticks_to_usecs(os_cputime_get32() - handler_ts));
+#endif
     }
   }
 
@@ -546,6 +661,11 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
     /* Return a 4.00 response */
     response_buffer.code = oc_status_code(OC_STATUS_BAD_REQUEST);
     success = false;
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+    if (cur_resource) {
+      STATS_INC(cur_resource->stats, errors);
+    }
+#endif
   } else if (!cur_resource) {
     LOG("ocri: Could not find resource\n");
     /* Return a 4.04 response if the requested resource was not found */
@@ -560,6 +680,9 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
     response_buffer.response_length = 0;
     response_buffer.code = oc_status_code(OC_STATUS_METHOD_NOT_ALLOWED);
     success = false;
+#if MYNEWT_VAL(OC_RESOURCE_STATS)
+    STATS_INC(cur_resource->stats, errors);
+#endif
   }
 #ifdef OC_SECURITY
   else if (!authorized) {
@@ -656,7 +779,7 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
      */
     if ((method == OC_PUT || method == OC_POST) &&
         response_buffer.code < oc_status_code(OC_STATUS_BAD_REQUEST))
-      coap_notify_observers(cur_resource, NULL, NULL);
+      oc_ri_notify_observers(cur_resource);
 #endif
     if (response_buffer.response_length) {
       coap_set_payload(response, response_buffer.buffer,
@@ -694,6 +817,19 @@ oc_ri_remove_client_cb_by_mid(uint16_t mid)
     free_client_cb(cb);
 }
 
+oc_client_cb_t *
+oc_ri_get_client_cb_by_token(uint8_t *token, uint8_t token_len)
+{
+  oc_client_cb_t *cb = (oc_client_cb_t *)oc_list_head(client_cbs);
+  while (cb != NULL) {
+    if (cb->token_len == token_len &&
+        memcmp(cb->token, token, token_len) == 0)
+      break;
+    cb = cb->next;
+  }
+  return cb;
+}
+
 bool
 oc_ri_send_rst(oc_endpoint_t *endpoint, uint8_t *token, uint8_t token_len,
                uint16_t mid)
@@ -108,6 +108,11 @@ oc_new_resource(const char *uri, uint8_t num_resource_types, int device)
   resource->observe_period_seconds = 0;
   resource->properties = OC_ACTIVE;
   resource->num_observers = 0;
+  resource->uri_hash_next = NULL;
+  resource->notify_min_interval = 0;
+  resource->notify_last = 0;
+  resource->notify_filter = NULL;
+  resource->notify_filter_arg = NULL;
   resource->device = device;
   return resource;
 }
@@ -158,6 +163,20 @@ oc_resource_set_periodic_observable(oc_resource_t *resource, uint16_t seconds)
   resource->observe_period_seconds = seconds;
 }
 
+void
+oc_resource_set_notify_min_interval(oc_resource_t *resource, uint32_t ticks)
+{
+  resource->notify_min_interval = ticks;
+}
+
+void
+oc_resource_set_notify_filter(oc_resource_t *resource,
+                              oc_notify_filter_t filter, void *arg)
+{
+  resource->notify_filter = filter;
+  resource->notify_filter_arg = arg;
+}
+
 void
 oc_deactivate_resource(oc_resource_t *resource)
 {
@@ -277,6 +296,6 @@ oc_send_separate_response(oc_separate_response_t *handle,
 int
 oc_notify_observers(oc_resource_t *resource)
 {
-  return coap_notify_observers(resource, NULL, NULL);
+  return oc_ri_notify_observers(resource);
 }
 #endif /* OC_SERVER */
@@ -0,0 +1,393 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <syscfg/syscfg.h>
+
+#if MYNEWT_VAL(OC_BLOCK_TRANSFER)
+
+#include <string.h>
+
+#include <os/os.h>
+
+#include "blockwise.h"
+#include "transactions.h"
+
+#ifdef OC_CLIENT
+#include "oc_client_state.h"
+#endif
+
+/* transfers which stall longer than this give their slot back */
+#define COAP_BLOCK_AGE_TICKS    (10 * OS_TICKS_PER_SEC)
+
+#define COAP_BLOCK_SRV_RX1      1   /* server: Block1 request reassembly */
+#define COAP_BLOCK_SRV_TX2      2   /* server: cached Block2 response */
+#define COAP_BLOCK_CLI_RX2      3   /* client: Block2 response reassembly */
+
+struct coap_block_state {
+    uint8_t bs_dir;                 /* COAP_BLOCK_*, 0 when free */
+    uint8_t bs_token_len;
+    uint8_t bs_token[COAP_TOKEN_LEN];
+    uint16_t bs_fmt;                /* content-format of cached response */
+    uint32_t bs_urihash;
+    uint32_t bs_len;                /* bytes accumulated/cached in bs_buf */
+    os_time_t bs_stamp;
+    oc_endpoint_t bs_endpoint;
+    uint8_t bs_buf[MYNEWT_VAL(OC_BLOCK_BUF_SIZE)];
+};
+
+static struct coap_block_state coap_block_states[MYNEWT_VAL(OC_BLOCK_STATES)];
+
+static uint32_t
+coap_block_urihash(coap_packet_t *pkt)
+{
+    uint32_t hash = 5381;
+    size_t i;
+
+    for (i = 0; i < pkt->uri_path_len; i++) {
+        hash = (hash << 5) + hash + (uint8_t)pkt->uri_path[i];
+    }
+    return hash ^ pkt->uri_path_len;
+}
+
+static struct coap_block_state *
+coap_block_find(uint8_t dir, oc_endpoint_t *endpoint, uint32_t urihash,
+                uint8_t *token, uint8_t token_len)
+{
+    struct coap_block_state *bs;
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(OC_BLOCK_STATES); i++) {
+        bs = &coap_block_states[i];
+        if (bs->bs_dir != dir) {
+            continue;
+        }
+        if (memcmp(&bs->bs_endpoint, endpoint, sizeof(oc_endpoint_t)) != 0) {
+            continue;
+        }
+        if (token) {
+            if (bs->bs_token_len != token_len ||
+                memcmp(bs->bs_token, token, token_len) != 0) {
+                continue;
+            }
+        } else if (bs->bs_urihash != urihash) {
+            continue;
+        }
+        return bs;
+    }
+    return NULL;
+}
+
+static struct coap_block_state *
+coap_block_alloc(uint8_t dir, oc_endpoint_t *endpoint, uint32_t urihash,
+                 uint8_t *token, uint8_t token_len)
+{
+    struct coap_block_state *bs;
+    os_time_t now;
+    int i;
+
+    now = os_time_get();
+    for (i = 0; i < MYNEWT_VAL(OC_BLOCK_STATES); i++) {
+        bs = &coap_block_states[i];
+        if (bs->bs_dir &&
+            OS_TIME_TICK_GT(now, bs->bs_stamp + COAP_BLOCK_AGE_TICKS)) {
+            /* reclaim stalled transfer */
+            bs->bs_dir = 0;
+        }
+        if (!bs->bs_dir) {
+            bs->bs_dir = dir;
+            bs->bs_urihash = urihash;
+            bs->bs_token_len = token_len;
+            if (token_len) {
+                memcpy(bs->bs_token, token, token_len);
+            }
+            bs->bs_len = 0;
+            bs->bs_stamp = now;
+            memcpy(&bs->bs_endpoint, endpoint, sizeof(oc_endpoint_t));
+            return bs;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Slot contents stay untouched until the slot is handed out again, and
+ * the engine serializes into the transaction before processing another
+ * message; payload pointers into bs_buf therefore survive release.
+ */
+static void
+coap_block_release(struct coap_block_state *bs)
+{
+    bs->bs_dir = 0;
+}
+
+#ifdef OC_SERVER
+int
+coap_block1_rx(coap_packet_t *req, coap_packet_t *rsp,
+               oc_endpoint_t *endpoint)
+{
+    struct coap_block_state *bs;
+    uint32_t num = 0;
+    uint8_t more = 0;
+    uint16_t size = 0;
+    uint32_t offset = 0;
+    uint32_t urihash;
+
+    coap_get_header_block1(req, &num, &more, &size, &offset);
+    LOG("\tBlock1: block %u%s @ %u\n", (unsigned int)num, more ? "+" : "",
+        (unsigned int)offset);
+
+    urihash = coap_block_urihash(req);
+    bs = coap_block_find(COAP_BLOCK_SRV_RX1, endpoint, urihash, NULL, 0);
+    if (!bs && num == 0) {
+        bs = coap_block_alloc(COAP_BLOCK_SRV_RX1, endpoint, urihash, NULL, 0);
+    }
+    if (!bs) {
+        return COAP_BLOCK_ERR;
+    }
+    if (offset + req->payload_len > sizeof(bs->bs_buf)) {
+        coap_block_release(bs);
+        return COAP_BLOCK_ERR;
+    }
+    memcpy(bs->bs_buf + offset, req->payload, req->payload_len);
+    bs->bs_len = MAX(bs->bs_len, offset + req->payload_len);
+    bs->bs_stamp = os_time_get();
+
+    coap_set_header_block1(rsp, num, more, size);
+    if (more) {
+        rsp->code = CONTINUE_2_31;
+        return COAP_BLOCK_MORE;
+    }
+    /* hand the assembled body to the resource handler in one piece */
+    req->payload = bs->bs_buf;
+    req->payload_len = bs->bs_len;
+    return COAP_BLOCK_DONE;
+}
+
+void
+coap_block1_done(coap_packet_t *req, oc_endpoint_t *endpoint)
+{
+    struct coap_block_state *bs;
+
+    bs = coap_block_find(COAP_BLOCK_SRV_RX1, endpoint,
+                         coap_block_urihash(req), NULL, 0);
+    if (bs) {
+        coap_block_release(bs);
+    }
+}
+
+uint8_t *
+coap_block2_tx_start(oc_endpoint_t *endpoint, coap_packet_t *req,
+                     uint16_t *buf_size)
+{
+    struct coap_block_state *bs;
+    uint32_t urihash;
+
+    urihash = coap_block_urihash(req);
+    bs = coap_block_find(COAP_BLOCK_SRV_TX2, endpoint, urihash, NULL, 0);
+    if (bs) {
+        /* fresh block-0 request; re-render below */
+        coap_block_release(bs);
+    }
+    bs = coap_block_alloc(COAP_BLOCK_SRV_TX2, endpoint, urihash, NULL, 0);
+    if (!bs) {
+        return NULL;
+    }
+    *buf_size = MIN(sizeof(bs->bs_buf), 0xffff);
+    return bs->bs_buf;
+}
+
+static struct coap_block_state *
+coap_block2_tx_find_buf(uint8_t *buf)
+{
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(OC_BLOCK_STATES); i++) {
+        if (coap_block_states[i].bs_buf == buf &&
+            coap_block_states[i].bs_dir == COAP_BLOCK_SRV_TX2) {
+            return &coap_block_states[i];
+        }
+    }
+    return NULL;
+}
+
+void
+coap_block2_tx_commit(uint8_t *buf, coap_packet_t *rsp, uint16_t block_size)
+{
+    struct coap_block_state *bs;
+
+    bs = coap_block2_tx_find_buf(buf);
+    if (!bs) {
+        return;
+    }
+    /*
+     * Only a multi-block success response is worth keeping; anything
+     * that fits in one block is already fully served.
+     */
+    if (rsp->code >= BAD_REQUEST_4_00 || rsp->payload != bs->bs_buf ||
+        rsp->payload_len <= block_size) {
+        coap_block_release(bs);
+        return;
+    }
+    bs->bs_len = rsp->payload_len;
+    bs->bs_fmt = rsp->content_format;
+    bs->bs_stamp = os_time_get();
+}
+
+void
+coap_block2_tx_drop(uint8_t *buf)
+{
+    struct coap_block_state *bs;
+
+    bs = coap_block2_tx_find_buf(buf);
+    if (bs) {
+        coap_block_release(bs);
+    }
+}
+
+int
+coap_block2_tx_next(coap_packet_t *req, coap_packet_t *rsp,
+                    oc_endpoint_t *endpoint, uint32_t block_num,
+                    uint16_t block_size)
+{
+    struct coap_block_state *bs;
+    uint32_t offset;
+    uint8_t more;
+
+    bs = coap_block_find(COAP_BLOCK_SRV_TX2, endpoint,
+                         coap_block_urihash(req), NULL, 0);
+    if (!bs || !bs->bs_len) {
+        return 0;
+    }
+    offset = block_num * block_size;
+    if (offset >= bs->bs_len) {
+        /* past the end; let the regular path answer */
+        coap_block_release(bs);
+        return 0;
+    }
+    LOG("\tBlock2: block %u served from cache\n", (unsigned int)block_num);
+    more = bs->bs_len - offset > block_size;
+    coap_set_header_content_format(rsp, bs->bs_fmt);
+    coap_set_header_block2(rsp, block_num, more, block_size);
+    coap_set_payload(rsp, bs->bs_buf + offset,
+                     MIN(bs->bs_len - offset, block_size));
+    if (more) {
+        bs->bs_stamp = os_time_get();
+    } else {
+        coap_block_release(bs);
+    }
+    return 1;
+}
+#endif /* OC_SERVER */
+
+#ifdef OC_CLIENT
+/*
+ * Re-issue the original request for the next block.  Sent before the
+ * current block is handed upward, so the request is in flight while
+ * this block is processed.
+ */
+static int
+coap_block2_client_next(oc_client_cb_t *cb, oc_endpoint_t *endpoint,
+                        uint32_t num, uint16_t size)
+{
+    coap_packet_t req[1];
+    coap_transaction_t *t;
+
+    cb->mid = coap_get_mid();
+    t = coap_new_transaction(cb->mid, endpoint);
+    if (!t) {
+        return -1;
+    }
+    coap_init_message(req, COAP_TYPE_CON, cb->method, cb->mid);
+    coap_set_header_accept(req, APPLICATION_CBOR);
+    coap_set_token(req, cb->token, cb->token_len);
+    coap_set_header_uri_path(req, oc_string(cb->uri));
+    coap_set_header_block2(req, num, 0, size);
+    t->message->length = coap_serialize_message(req, t->message->data);
+    if (!t->message->length) {
+        coap_clear_transaction(t);
+        return -1;
+    }
+    coap_send_transaction(t);
+    return 0;
+}
+
+int
+coap_block2_client_rx(coap_packet_t *rsp, oc_endpoint_t *endpoint)
+{
+    struct coap_block_state *bs;
+    oc_client_cb_t *cb;
+    uint32_t num = 0;
+    uint8_t more = 0;
+    uint16_t size = 0;
+    uint32_t offset = 0;
+
+    coap_get_header_block2(rsp, &num, &more, &size, &offset);
+    if (num == 0 && !more) {
+        /* single-block body; nothing to assemble */
+        return COAP_BLOCK_NONE;
+    }
+    bs = coap_block_find(COAP_BLOCK_CLI_RX2, endpoint, 0, rsp->token,
+                         rsp->token_len);
+    if (!bs) {
+        if (num != 0) {
+            /* mid-transfer with no state; deliver what we have */
+            return COAP_BLOCK_NONE;
+        }
+        bs = coap_block_alloc(COAP_BLOCK_CLI_RX2, endpoint, 0, rsp->token,
+                              rsp->token_len);
+        if (!bs) {
+            return COAP_BLOCK_ERR;
+        }
+    }
+    if (offset + rsp->payload_len > sizeof(bs->bs_buf)) {
+        coap_block_release(bs);
+        return COAP_BLOCK_ERR;
+    }
+    memcpy(bs->bs_buf + offset, rsp->payload, rsp->payload_len);
+    bs->bs_len = MAX(bs->bs_len, offset + rsp->payload_len);
+    bs->bs_stamp = os_time_get();
+
+    if (more) {
+        cb = oc_ri_get_client_cb_by_token(rsp->token, rsp->token_len);
+        if (!cb || coap_block2_client_next(cb, endpoint, num + 1, size)) {
+            coap_block_release(bs);
+            return COAP_BLOCK_ERR;
+        }
+        LOG("\tBlock2: requested block %u\n", (unsigned int)num + 1);
+        return COAP_BLOCK_MORE;
+    }
+    rsp->payload = bs->bs_buf;
+    rsp->payload_len = bs->bs_len;
+    return COAP_BLOCK_DONE;
+}
+
+void
+coap_block2_client_done(coap_packet_t *rsp, oc_endpoint_t *endpoint)
+{
+    struct coap_block_state *bs;
+
+    bs = coap_block_find(COAP_BLOCK_CLI_RX2, endpoint, 0, rsp->token,
+                         rsp->token_len);
+    if (bs) {
+        coap_block_release(bs);
+    }
+}
+#endif /* OC_CLIENT */
+
+#endif /* MYNEWT_VAL(OC_BLOCK_TRANSFER) */
@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef BLOCKWISE_H
+#define BLOCKWISE_H
+
+#include <syscfg/syscfg.h>
+
+#if MYNEWT_VAL(OC_BLOCK_TRANSFER)
+
+#include "coap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * RFC7959 block-wise transfer state for the engine.  A small pool of
+ * reassembly/response buffers is shared between Block1 request
+ * reassembly, the Block2 response cache and client-side Block2
+ * reassembly; each transfer in flight pins one slot for its duration.
+ */
+
+/* return values for the _rx routines below */
+#define COAP_BLOCK_NONE  0  /* message is not (or no longer) block-wise */
+#define COAP_BLOCK_MORE  1  /* absorbed; more blocks outstanding */
+#define COAP_BLOCK_DONE  2  /* complete; payload now spans the full body */
+#define COAP_BLOCK_ERR   (-1) /* body too large or no state available */
+
+#ifdef OC_SERVER
+/*
+ * Reassemble a Block1 request body.  COAP_BLOCK_MORE means rsp has been
+ * turned into a 2.31 Continue and the resource handler must not run yet;
+ * COAP_BLOCK_DONE rewrites req's payload to the assembled body and echoes
+ * the final Block1 option into rsp.
+ */
+int coap_block1_rx(coap_packet_t *req, coap_packet_t *rsp,
+                   oc_endpoint_t *endpoint);
+
+/* Release the reassembled body once the handler has run. */
+void coap_block1_done(coap_packet_t *req, oc_endpoint_t *endpoint);
+
+/*
+ * Block2 response cache: the handler renders the representation once into
+ * a slot at block 0 and later blocks are served from it without invoking
+ * the handler again, so follow-up block requests only cost the slice copy.
+ */
+
+/* Buffer for the block-0 render, or NULL if no slot is free. */
+uint8_t *coap_block2_tx_start(oc_endpoint_t *endpoint, coap_packet_t *req,
+                              uint16_t *buf_size);
+
+/*
+ * Record (or drop) the rendered representation after the handler ran.
+ * Keeps the slot only when the body actually spans multiple blocks.
+ */
+void coap_block2_tx_commit(uint8_t *buf, coap_packet_t *rsp,
+                           uint16_t block_size);
+
+/* Discard an uncommitted block-0 render (handler error paths). */
+void coap_block2_tx_drop(uint8_t *buf);
+
+/*
+ * Serve block_num of a cached representation into rsp.  Returns 1 when
+ * served (handler must be skipped), 0 on cache miss.
+ */
+int coap_block2_tx_next(coap_packet_t *req, coap_packet_t *rsp,
+                        oc_endpoint_t *endpoint, uint32_t block_num,
+                        uint16_t block_size);
+#endif /* OC_SERVER */
+
+#ifdef OC_CLIENT
+/*
+ * Accumulate a Block2 response and keep the transfer moving: when more
+ * blocks remain the request for the next one is sent before returning,
+ * so it is in flight while this block is processed.  COAP_BLOCK_DONE
+ * rewrites rsp's payload to the assembled body; the caller must invoke
+ * the client callback and then release with coap_block2_client_done().
+ */
+int coap_block2_client_rx(coap_packet_t *rsp, oc_endpoint_t *endpoint);
+void coap_block2_client_done(coap_packet_t *rsp, oc_endpoint_t *endpoint);
+#endif /* OC_CLIENT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MYNEWT_VAL(OC_BLOCK_TRANSFER) */
+
+#endif /* BLOCKWISE_H */
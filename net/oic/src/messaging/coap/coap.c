@@ -34,6 +34,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <os/os_mbuf.h>
+
 #include "coap.h"
 #include "transactions.h"
 
@@ -410,34 +412,16 @@ coap_send_message(oc_message_t *message)
   oc_send_message(message);
 }
 /*---------------------------------------------------------------------------*/
-coap_status_t
-coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
+/*
+ * Copies the token and walks the options of a contiguous header region.
+ * Shared by the flat-buffer and mbuf parse entry points.  On success
+ * *payload_off holds the offset just past the payload marker, or 0 when
+ * the message carries no payload.
+ */
+static coap_status_t
+coap_parse_token_options(coap_packet_t *coap_pkt, uint8_t *data,
+                         uint16_t data_len, uint16_t *payload_off)
 {
-  coap_packet_t *const coap_pkt = (coap_packet_t *)packet;
-  /* initialize packet */
-  memset(coap_pkt, 0, sizeof(coap_packet_t));
-  /* pointer to packet bytes */
-  coap_pkt->buffer = data;
-  /* parse header fields */
-  coap_pkt->version = (COAP_HEADER_VERSION_MASK & coap_pkt->buffer[0]) >>
-                      COAP_HEADER_VERSION_POSITION;
-  coap_pkt->type =
-    (COAP_HEADER_TYPE_MASK & coap_pkt->buffer[0]) >> COAP_HEADER_TYPE_POSITION;
-  coap_pkt->token_len = (COAP_HEADER_TOKEN_LEN_MASK & coap_pkt->buffer[0]) >>
-                        COAP_HEADER_TOKEN_LEN_POSITION;
-  coap_pkt->code = coap_pkt->buffer[1];
-  coap_pkt->mid = coap_pkt->buffer[2] << 8 | coap_pkt->buffer[3];
-
-  if (coap_pkt->version != 1) {
-    coap_error_message = "CoAP version must be 1";
-    return BAD_REQUEST_4_00;
-  }
-
-  if (coap_pkt->token_len > COAP_TOKEN_LEN) {
-    coap_error_message = "Token Length must not be more than 8";
-    return BAD_REQUEST_4_00;
-  }
-
   uint8_t *current_option = data + COAP_HEADER_LEN;
 
   memcpy(coap_pkt->token, current_option, coap_pkt->token_len);
@@ -459,17 +443,8 @@ coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
     /* payload marker 0xFF, currently only checking for 0xF* because rest is
      * reserved */
     if ((current_option[0] & 0xF0) == 0xF0) {
-      coap_pkt->payload = ++current_option;
-      coap_pkt->payload_len = data_len - (coap_pkt->payload - data);
-
-      /* also for receiving, the Erbium upper bound is MAX_PAYLOAD_SIZE */
-      if (coap_pkt->payload_len > MAX_PAYLOAD_SIZE) {
-        coap_pkt->payload_len = MAX_PAYLOAD_SIZE;
-        /* null-terminate payload */
-      }
-      coap_pkt->payload[coap_pkt->payload_len] = '\0';
-
-      break;
+      *payload_off = ++current_option - data;
+      return NO_ERROR;
     }
 
     option_delta = current_option[0] >> 4;
@@ -671,10 +646,226 @@ coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
     }
     current_option += option_length;
   } /* for */
+
+  *payload_off = 0;
+  return NO_ERROR;
+}
+/*---------------------------------------------------------------------------*/
+/* parses and validates the 4-byte fixed header */
+static coap_status_t
+coap_parse_header(coap_packet_t *coap_pkt, const uint8_t *hdr)
+{
+  coap_pkt->version =
+    (COAP_HEADER_VERSION_MASK & hdr[0]) >> COAP_HEADER_VERSION_POSITION;
+  coap_pkt->type =
+    (COAP_HEADER_TYPE_MASK & hdr[0]) >> COAP_HEADER_TYPE_POSITION;
+  coap_pkt->token_len =
+    (COAP_HEADER_TOKEN_LEN_MASK & hdr[0]) >> COAP_HEADER_TOKEN_LEN_POSITION;
+  coap_pkt->code = hdr[1];
+  coap_pkt->mid = hdr[2] << 8 | hdr[3];
+
+  if (coap_pkt->version != 1) {
+    coap_error_message = "CoAP version must be 1";
+    return BAD_REQUEST_4_00;
+  }
+
+  if (coap_pkt->token_len > COAP_TOKEN_LEN) {
+    coap_error_message = "Token Length must not be more than 8";
+    return BAD_REQUEST_4_00;
+  }
+
+  return NO_ERROR;
+}
+/*---------------------------------------------------------------------------*/
+coap_status_t
+coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
+{
+  coap_packet_t *const coap_pkt = (coap_packet_t *)packet;
+  uint16_t payload_off;
+  coap_status_t status;
+
+  /* initialize packet */
+  memset(coap_pkt, 0, sizeof(coap_packet_t));
+  /* pointer to packet bytes */
+  coap_pkt->buffer = data;
+  /* parse header fields */
+  status = coap_parse_header(coap_pkt, data);
+  if (status != NO_ERROR) {
+    return status;
+  }
+
+  status = coap_parse_token_options(coap_pkt, data, data_len, &payload_off);
+  if (status != NO_ERROR) {
+    return status;
+  }
+
+  if (payload_off) {
+    coap_pkt->payload = data + payload_off;
+    coap_pkt->payload_len = data_len - payload_off;
+
+    /* also for receiving, the Erbium upper bound is MAX_PAYLOAD_SIZE */
+    if (coap_pkt->payload_len > MAX_PAYLOAD_SIZE) {
+      coap_pkt->payload_len = MAX_PAYLOAD_SIZE;
+      /* null-terminate payload */
+    }
+    coap_pkt->payload[coap_pkt->payload_len] = '\0';
+  }
   LOG("-Done parsing-------\n");
 
   return NO_ERROR;
 }
+/*---------------------------------------------------------------------------*/
+/*
+ * First pass over an mbuf chain: walks just the option skeleton
+ * (delta/length nibbles and their extended bytes) through an iterator
+ * to find where the header region ends, without touching option
+ * values.  *region_len covers everything up to and including the
+ * payload marker when *has_payload is set.
+ */
+static coap_status_t
+coap_mbuf_region(struct os_mbuf *m, uint16_t total, uint8_t token_len,
+                 uint16_t *region_len, int *has_payload)
+{
+  struct os_mbuf_iter it;
+  uint16_t off;
+  unsigned int option_length;
+  uint8_t b;
+  uint8_t ext;
+
+  *has_payload = 0;
+  off = COAP_HEADER_LEN + token_len;
+  if (off >= total) {
+    *region_len = total;
+    return NO_ERROR;
+  }
+  if (os_mbuf_iter_init(&it, m, off)) {
+    return BAD_REQUEST_4_00;
+  }
+
+#define COAP_MBUF_GETC(dst)                                                   \
+  do {                                                                        \
+    const uint8_t *_p;                                                        \
+    if (os_mbuf_iter_peek(&it, &_p) == 0) {                                   \
+      coap_error_message = "Truncated option header";                         \
+      return BAD_REQUEST_4_00;                                                \
+    }                                                                         \
+    (dst) = *_p;                                                              \
+    os_mbuf_iter_advance(&it, 1);                                             \
+    off++;                                                                    \
+  } while (0)
+
+  while (off < total) {
+    COAP_MBUF_GETC(b);
+    if ((b & 0xF0) == 0xF0) {
+      *has_payload = 1;
+      break;
+    }
+    option_length = b & 0x0F;
+    if ((b >> 4) == 13) {
+      COAP_MBUF_GETC(ext);
+    } else if ((b >> 4) == 14) {
+      COAP_MBUF_GETC(ext);
+      COAP_MBUF_GETC(ext);
+    }
+    if (option_length == 13) {
+      COAP_MBUF_GETC(ext);
+      option_length = 13 + ext;
+    } else if (option_length == 14) {
+      COAP_MBUF_GETC(ext);
+      option_length = 269 + (ext << 8);
+      COAP_MBUF_GETC(ext);
+      option_length += ext;
+    }
+    if (os_mbuf_iter_advance(&it, option_length) != option_length) {
+      coap_error_message = "Truncated option value";
+      return BAD_REQUEST_4_00;
+    }
+    off += option_length;
+  }
+
+#undef COAP_MBUF_GETC
+
+  *region_len = off;
+  return NO_ERROR;
+}
+/*---------------------------------------------------------------------------*/
+coap_status_t
+coap_parse_message_mbuf(void *packet, struct os_mbuf **mp)
+{
+  coap_packet_t *const coap_pkt = (coap_packet_t *)packet;
+  struct os_mbuf *m = *mp;
+  struct os_mbuf *om;
+  uint8_t hdr[COAP_HEADER_LEN];
+  uint16_t total;
+  uint16_t region;
+  uint16_t payload_off;
+  uint16_t foff;
+  int has_payload;
+  coap_status_t status;
+
+  memset(coap_pkt, 0, sizeof(coap_packet_t));
+
+  total = OS_MBUF_PKTLEN(m);
+  if (total < COAP_HEADER_LEN ||
+      os_mbuf_copydata(m, 0, COAP_HEADER_LEN, hdr)) {
+    coap_error_message = "Truncated header";
+    return BAD_REQUEST_4_00;
+  }
+  status = coap_parse_header(coap_pkt, hdr);
+  if (status != NO_ERROR) {
+    return status;
+  }
+  if (COAP_HEADER_LEN + coap_pkt->token_len > total) {
+    coap_error_message = "Truncated token";
+    return BAD_REQUEST_4_00;
+  }
+
+  status = coap_mbuf_region(m, total, coap_pkt->token_len, &region,
+                            &has_payload);
+  if (status != NO_ERROR) {
+    return status;
+  }
+
+  /*
+   * Options rarely straddle a fragment boundary; when they do, stitch
+   * the header region together so the shared option parser (which
+   * stores pointers into it) can run in place.  os_mbuf_pullup() frees
+   * the chain on failure.
+   */
+  if (m->om_len < region) {
+    m = os_mbuf_pullup(m, region);
+    if (m == NULL) {
+      *mp = NULL;
+      coap_error_message = "Could not stitch header region";
+      return INTERNAL_SERVER_ERROR_5_00;
+    }
+    *mp = m;
+  }
+
+  coap_pkt->buffer = m->om_data;
+  status = coap_parse_token_options(coap_pkt, m->om_data, region,
+                                    &payload_off);
+  if (status != NO_ERROR) {
+    return status;
+  }
+
+  if (has_payload) {
+    coap_pkt->payload_len = total - region;
+    if (coap_pkt->payload_len > MAX_PAYLOAD_SIZE) {
+      coap_pkt->payload_len = MAX_PAYLOAD_SIZE;
+    }
+    coap_pkt->payload_m = m;
+    coap_pkt->payload_off = region;
+    /* direct pointer only when the payload sits within one fragment */
+    om = os_mbuf_off(m, region, &foff);
+    if (om != NULL && om->om_len - foff >= coap_pkt->payload_len) {
+      coap_pkt->payload = om->om_data + foff;
+    }
+  }
+  LOG("-Done parsing (mbuf)-------\n");
+
+  return NO_ERROR;
+}
 #if 0
 int
 coap_get_query_variable(void *packet, const char *name, const char **output)
@@ -39,6 +39,8 @@
 #include <stddef.h> /* for size_t */
 #include <stdint.h>
 
+struct os_mbuf;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -149,6 +151,15 @@ typedef struct
 
   uint16_t payload_len;
   uint8_t *payload;
+
+  /*
+   * Payload location when the message was parsed straight from an mbuf
+   * chain; 'payload' above is only set when the bytes are contiguous
+   * within one fragment.  CBOR payloads can be decoded from here with
+   * cbor_mbuf_reader without flattening.
+   */
+  struct os_mbuf *payload_m;
+  uint16_t payload_off;
 } coap_packet_t;
 
 /* option format serialization */
@@ -208,6 +219,16 @@ void coap_send_message(oc_message_t *message);
 coap_status_t coap_parse_message(void *request, uint8_t *data,
                                  uint16_t data_len);
 
+/*
+ * Like coap_parse_message(), but consumes an mbuf chain without
+ * flattening it first.  Header and options are read in place; if they
+ * straddle a fragment boundary the chain is pulled up around them,
+ * which may replace the head (hence **mp).  On pull-up failure the
+ * chain is freed and *mp set to NULL.  The payload stays in the chain;
+ * see payload_m/payload_off in coap_packet_t.
+ */
+coap_status_t coap_parse_message_mbuf(void *request, struct os_mbuf **mp);
+
 int coap_get_query_variable(void *packet, const char *name,
                             const char **output);
 int coap_get_post_variable(void *packet, const char *name, const char **output);
@@ -37,6 +37,7 @@
 #include <string.h>
 
 /* OIC Stack headers */
+#include "blockwise.h"
 #include "oc_buffer.h"
 #include "oc_ri.h"
 
@@ -144,11 +145,60 @@ coap_receive(oc_message_t *msg)
           new_offset = block_offset;
         }
 
+#if MYNEWT_VAL(OC_BLOCK_TRANSFER)
+        int block_served = 0;
+        uint8_t *block_buf = NULL;
+        uint16_t block_buf_size = 0;
+
+        /* reassemble a Block1 request body before it reaches the handler */
+        if (IS_OPTION(message, COAP_OPTION_BLOCK1)) {
+          switch (coap_block1_rx(message, response, &msg->endpoint)) {
+          case COAP_BLOCK_MORE:
+            /* interim 2.31 Continue; handler runs on the final block */
+            block_served = 1;
+            break;
+          case COAP_BLOCK_ERR:
+            response->code = REQUEST_ENTITY_TOO_LARGE_4_13;
+            coap_set_payload(response, "RequestTooLarge", 15);
+            block_served = 1;
+            break;
+          default: /* COAP_BLOCK_DONE: payload now spans the full body */
+            break;
+          }
+        }
+
+        /* serve follow-up Block2 requests from the cached representation */
+        if (!block_served && IS_OPTION(message, COAP_OPTION_BLOCK2)) {
+          if (block_num > 0 &&
+              coap_block2_tx_next(message, response, &msg->endpoint,
+                                  block_num, block_size)) {
+            block_served = 1;
+          } else if (block_num == 0) {
+            /*
+             * Render the whole representation once, into a cache slot
+             * instead of the single-block transaction buffer; blocks
+             * after this one are then ready before they are asked for.
+             */
+            block_buf = coap_block2_tx_start(&msg->endpoint, message,
+                                             &block_buf_size);
+          }
+        }
+
+        /* invoke resource handler in RI layer */
+        if (!block_served &&
+            oc_ri_invoke_coap_entity_handler(
+              message, response,
+              block_buf ? block_buf
+                        : transaction->message->data + COAP_MAX_HEADER_SIZE,
+              block_buf ? block_buf_size : block_size,
+              &new_offset, &msg->endpoint)) {
+#else
         /* invoke resource handler in RI layer */
         if (oc_ri_invoke_coap_entity_handler(
               message, response,
               transaction->message->data + COAP_MAX_HEADER_SIZE, block_size,
               &new_offset, &msg->endpoint)) {
+#endif
 
           if (erbium_status_code == NO_ERROR) {
 
@@ -172,6 +222,13 @@ coap_receive(oc_message_t *msg)
               if (new_offset == block_offset) {
                 LOG("\tBlockwise: unaware resource with payload length %u/%u\n",
                     response->payload_len, block_size);
+#if MYNEWT_VAL(OC_BLOCK_TRANSFER)
+                if (block_buf) {
+                  /* keep the render for later blocks when it spans several */
+                  coap_block2_tx_commit(block_buf, response, block_size);
+                  block_buf = NULL;
+                }
+#endif
                 if (block_offset >= response->payload_len) {
                   LOG("\t\t: block_offset >= response->payload_len\n");
 
@@ -218,6 +275,16 @@ coap_receive(oc_message_t *msg)
           /* successful service callback */
           /* serialize response */
         }
+#if MYNEWT_VAL(OC_BLOCK_TRANSFER)
+        if (block_buf) {
+          /* handler failed or the resource slices its own blocks */
+          coap_block2_tx_drop(block_buf);
+        }
+        if (!block_served && IS_OPTION(message, COAP_OPTION_BLOCK1)) {
+          /* reassembled body consumed by the handler */
+          coap_block1_done(message, &msg->endpoint);
+        }
+#endif
         if (erbium_status_code == NO_ERROR) {
           if ((transaction->message->length = coap_serialize_message(
                  response, transaction->message->data)) == 0) {
@@ -251,7 +318,27 @@ coap_receive(oc_message_t *msg)
 
 #ifdef OC_CLIENT // ACKs and RSTs sent to oc_ri.. RSTs cleared, ACKs sent to
                  // client
+#if MYNEWT_VAL(OC_BLOCK_TRANSFER)
+      if (IS_OPTION(message, COAP_OPTION_BLOCK2)) {
+        switch (coap_block2_client_rx(message, &msg->endpoint)) {
+        case COAP_BLOCK_MORE:
+          /* next block already requested; deliver once assembled */
+          break;
+        case COAP_BLOCK_DONE:
+          /* payload rewritten to span the whole body */
+          oc_ri_invoke_client_cb(message, &msg->endpoint);
+          coap_block2_client_done(message, &msg->endpoint);
+          break;
+        default: /* not (or no longer) block-wise; deliver as-is */
+          oc_ri_invoke_client_cb(message, &msg->endpoint);
+          break;
+        }
+      } else {
+        oc_ri_invoke_client_cb(message, &msg->endpoint);
+      }
+#else
       oc_ri_invoke_client_cb(message, &msg->endpoint);
+#endif
 #endif
 
     } /* request or response */
@@ -54,6 +54,50 @@ static struct os_mempool coap_observers;
 static uint8_t coap_observer_area[OS_MEMPOOL_BYTES(COAP_MAX_OBSERVERS,
       sizeof(coap_observer_t))];
 
+/*
+ * Token-keyed hash buckets over the observers, so per-message token
+ * matching stays flat as the observer count grows.  The list remains
+ * the iteration order for notification and endpoint-wide removal.
+ */
+#define COAP_OBSERVER_HASH_SIZE 8
+static coap_observer_t *observer_hash[COAP_OBSERVER_HASH_SIZE];
+
+static int
+coap_observer_hash(const uint8_t *token, size_t token_len)
+{
+    uint8_t h = 0;
+    size_t i;
+
+    for (i = 0; i < token_len; i++) {
+        h ^= token[i];
+    }
+    return h & (COAP_OBSERVER_HASH_SIZE - 1);
+}
+
+static void
+coap_observer_hash_insert(coap_observer_t *o)
+{
+    int b;
+
+    b = coap_observer_hash(o->token, o->token_len);
+    o->hash_next = observer_hash[b];
+    observer_hash[b] = o;
+}
+
+static void
+coap_observer_hash_remove(coap_observer_t *o)
+{
+    coap_observer_t **op;
+
+    for (op = &observer_hash[coap_observer_hash(o->token, o->token_len)]; *op;
+         op = &(*op)->hash_next) {
+        if (*op == o) {
+            *op = o->hash_next;
+            return;
+        }
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -85,6 +129,7 @@ add_observer(oc_resource_t *resource, oc_endpoint_t *endpoint,
           oc_list_length(observers_list) + 1, COAP_MAX_OBSERVERS, o->url,
           o->token[0], o->token[1]);
         oc_list_add(observers_list, o);
+        coap_observer_hash_insert(o);
         return dup;
     }
     return -1;
@@ -98,6 +143,7 @@ coap_remove_observer(coap_observer_t *o)
     LOG("Removing observer for /%s [0x%02X%02X]\n", o->url, o->token[0],
       o->token[1]);
     oc_list_remove(observers_list, o);
+    coap_observer_hash_remove(o);
     os_memblock_put(&coap_observers, o);
 }
 /*---------------------------------------------------------------------------*/
@@ -129,7 +175,7 @@ coap_remove_observer_by_token(oc_endpoint_t *endpoint, uint8_t *token,
                               size_t token_len)
 {
     int removed = 0;
-    coap_observer_t *obs = (coap_observer_t *)oc_list_head(observers_list);
+    coap_observer_t *obs = observer_hash[coap_observer_hash(token, token_len)];
     LOG("Unregistering observers for request token 0x%02X%02X\n", token[0],
       token[1]);
     while (obs) {
@@ -141,7 +187,7 @@ coap_remove_observer_by_token(oc_endpoint_t *endpoint, uint8_t *token,
             removed++;
             break;
         }
-        obs = obs->next;
+        obs = obs->hash_next;
     }
     LOG("Removed %d observers\n", removed);
     return removed;
@@ -50,6 +50,7 @@ extern "C" {
 typedef struct coap_observer
 {
   struct coap_observer *next; /* for LIST */
+  struct coap_observer *hash_next; /* for token hash bucket */
 
   oc_resource_t *resource;
 
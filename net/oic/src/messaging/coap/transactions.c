@@ -57,8 +57,46 @@ static uint8_t oc_transaction_area[OS_MEMPOOL_BYTES(COAP_MAX_OPEN_TRANSACTIONS,
 
 OC_LIST(transactions_list);
 
+/*
+ * MID-keyed hash buckets over the same transactions, so the per-packet
+ * lookup in coap_get_transaction_by_mid stays flat as the open
+ * transaction count grows.  The list remains the iteration order.
+ */
+#define COAP_TRANSACTION_HASH_SIZE 8
+static coap_transaction_t *transaction_hash[COAP_TRANSACTION_HASH_SIZE];
+
 static void coap_transaction_retrans(struct os_event *ev);
 
+static inline int
+coap_transaction_hash(uint16_t mid)
+{
+    return mid & (COAP_TRANSACTION_HASH_SIZE - 1);
+}
+
+static void
+coap_transaction_hash_insert(coap_transaction_t *t)
+{
+    int b;
+
+    b = coap_transaction_hash(t->mid);
+    t->hash_next = transaction_hash[b];
+    transaction_hash[b] = t;
+}
+
+static void
+coap_transaction_hash_remove(coap_transaction_t *t)
+{
+    coap_transaction_t **tp;
+
+    for (tp = &transaction_hash[coap_transaction_hash(t->mid)]; *tp;
+         tp = &(*tp)->hash_next) {
+        if (*tp == t) {
+            *tp = t->hash_next;
+            return;
+        }
+    }
+}
+
 void
 coap_transaction_init(void)
 {
@@ -88,6 +126,7 @@ coap_new_transaction(uint16_t mid, oc_endpoint_t *endpoint)
               coap_transaction_retrans, t);
             /* list itself makes sure same element is not added twice */
             oc_list_add(transactions_list, t);
+            coap_transaction_hash_insert(t);
         } else {
             os_memblock_put(&oc_transaction_memb, t);
             t = NULL;
@@ -172,6 +211,7 @@ coap_clear_transaction(coap_transaction_t *t)
         os_callout_stop(&t->retrans_timer);
         oc_message_unref(t->message);
         oc_list_remove(transactions_list, t);
+        coap_transaction_hash_remove(t);
         os_memblock_put(&oc_transaction_memb, t);
   }
 }
@@ -179,10 +219,10 @@ coap_clear_transaction(coap_transaction_t *t)
 coap_transaction_t *
 coap_get_transaction_by_mid(uint16_t mid)
 {
-  coap_transaction_t *t = NULL;
+  coap_transaction_t *t;
 
-  for (t = (coap_transaction_t *)oc_list_head(transactions_list); t;
-       t = t->next) {
+  for (t = transaction_hash[coap_transaction_hash(mid)]; t;
+       t = t->hash_next) {
     if (t->mid == mid) {
       LOG("Found transaction for MID %u: %p\n", t->mid, t);
       return t;
@@ -57,6 +57,7 @@ extern "C" {
 typedef struct coap_transaction
 {
   struct coap_transaction *next; /* for LIST */
+  struct coap_transaction *hash_next; /* for MID hash bucket */
 
   uint16_t mid;
   uint8_t retrans_counter;
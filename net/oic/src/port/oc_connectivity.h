@@ -70,6 +70,9 @@ typedef struct oc_message_s
   oc_endpoint_t endpoint;
   size_t length;
   uint8_t ref_count;
+#if MYNEWT_VAL(OC_RX_CLASSES)
+  uint32_t queued_at;   /* os time tick of RX enqueue, for latency stats */
+#endif
   uint8_t data[MAX_PAYLOAD_SIZE];
 } oc_message_t;
 
@@ -26,6 +26,10 @@
 #include "oc_pstat.h"
 #include "oc_svr.h"
 
+#if MYNEWT_VAL(OC_SESS_CACHE)
+#include "oc_sess.h"
+#endif
+
 OC_PROCESS(oc_dtls_handler, "DTLS Process");
 OC_MEMB(dtls_peers_s, oc_sec_dtls_peer_t, MAX_DTLS_PEERS);
 OC_LIST(dtls_peers);
@@ -96,6 +100,18 @@ oc_sec_dtls_add_peer(oc_endpoint_t *endpoint)
       peer->connected = false;
       oc_list_add(dtls_peers, peer);
 
+#if MYNEWT_VAL(OC_SESS_CACHE)
+      {
+        struct oc_sec_sess *sess = oc_sec_sess_lookup(endpoint);
+        if (sess) {
+          /* rejoining node; restore its identity ahead of the handshake */
+          memcpy(&peer->uuid, &sess->uuid, sizeof(peer->uuid));
+          oc_sec_sess_resumed();
+        }
+      }
+      oc_sec_sess_hs_start();
+#endif
+
       oc_ri_add_timed_event_callback_seconds(
         &peer->session.addr, oc_sec_dtls_inactive, DTLS_INACTIVITY_TIMEOUT);
     }
@@ -223,8 +239,24 @@ oc_sec_dtls_get_owner_psk(struct dtls_context_t *ctx, const session_t *session,
     if (cred != NULL && peer != NULL) {
       memcpy(&peer->uuid, (oc_uuid_t *)desc, 16);
       memcpy(result, cred->key, 16);
+#if MYNEWT_VAL(OC_SESS_CACHE)
+      oc_sec_sess_save((oc_endpoint_t *)&session->addr, &peer->uuid,
+                       cred->key);
+#endif
       return 16;
     }
+#if MYNEWT_VAL(OC_SESS_CACHE)
+    /* cred store miss; fall back to the persisted session binding */
+    if (peer != NULL) {
+      struct oc_sec_sess *sess =
+        oc_sec_sess_lookup((oc_endpoint_t *)&session->addr);
+      if (sess != NULL) {
+        memcpy(&peer->uuid, &sess->uuid, 16);
+        memcpy(result, sess->key, 16);
+        return 16;
+      }
+    }
+#endif
     return 0;
   } break;
   default:
@@ -240,12 +272,20 @@ oc_sec_dtls_events(struct dtls_context_t *ctx, session_t *session,
   oc_sec_dtls_peer_t *peer = oc_sec_dtls_get_peer(&session->addr);
   if (peer && level == 0 && code == DTLS_EVENT_CONNECTED) {
     peer->connected = true;
+#if MYNEWT_VAL(OC_SESS_CACHE)
+    oc_sec_sess_hs_done();
+#endif
     oc_message_t *m = oc_list_pop(peer->send_queue);
     while (m != NULL) {
       oc_sec_dtls_send_message(m);
       m = oc_list_pop(peer->send_queue);
     }
   } else if (level == 2) {
+#if MYNEWT_VAL(OC_SESS_CACHE)
+    if (peer && !peer->connected) {
+      oc_sec_sess_hs_fail();
+    }
+#endif
     oc_sec_dtls_close_finish(&session->addr);
   }
   return 0;
@@ -299,6 +339,9 @@ oc_sec_dtls_recv_message(oc_message_t *message)
 void
 oc_sec_dtls_init_context(void)
 {
+#if MYNEWT_VAL(OC_SESS_CACHE)
+  oc_sec_sess_init();
+#endif
   dtls_init();
   ocf_dtls_context = dtls_new_context(NULL);
 
@@ -0,0 +1,226 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "config.h"
+
+#if defined(OC_SECURITY) && MYNEWT_VAL(OC_SESS_CACHE)
+
+#include <string.h>
+#include <stdio.h>
+
+#include <os/os_mempool.h>
+
+#include <config/config.h>
+#include <stats/stats.h>
+
+#include "oc_sess.h"
+#include "util/oc_list.h"
+
+/* on-flash record: endpoint + peer identity + owner PSK */
+struct oc_sess_rec {
+    oc_endpoint_t endpoint;
+    uint8_t uuid[16];
+    uint8_t key[16];
+};
+
+#define OC_SESS_VAL_LEN (4 * ((sizeof(struct oc_sess_rec) + 2) / 3) + 1)
+
+static struct os_mempool oc_sess_pool;
+static os_membuf_t oc_sess_area[OS_MEMPOOL_SIZE(MYNEWT_VAL(OC_SESS_CACHE_SIZE),
+                                                sizeof(struct oc_sec_sess))];
+OC_LIST(oc_sess_lru);   /* most recently used first */
+
+STATS_SECT_START(oc_sess_stats)
+    STATS_SECT_ENTRY(hs_start)
+    STATS_SECT_ENTRY(hs_done)
+    STATS_SECT_ENTRY(hs_fail)
+    STATS_SECT_ENTRY(resumed)
+    STATS_SECT_ENTRY(evicted)
+    STATS_SECT_ENTRY(loaded)
+STATS_SECT_END
+
+STATS_NAME_START(oc_sess_stats)
+    STATS_NAME(oc_sess_stats, hs_start)
+    STATS_NAME(oc_sess_stats, hs_done)
+    STATS_NAME(oc_sess_stats, hs_fail)
+    STATS_NAME(oc_sess_stats, resumed)
+    STATS_NAME(oc_sess_stats, evicted)
+    STATS_NAME(oc_sess_stats, loaded)
+STATS_NAME_END(oc_sess_stats)
+
+static STATS_SECT_DECL(oc_sess_stats) oc_sess_stats;
+
+struct oc_sec_sess *
+oc_sec_sess_lookup(oc_endpoint_t *endpoint)
+{
+    struct oc_sec_sess *s = oc_list_head(oc_sess_lru);
+
+    while (s != NULL) {
+        if (memcmp(&s->endpoint, endpoint, sizeof(oc_endpoint_t)) == 0) {
+            break;
+        }
+        s = oc_list_item_next(s);
+    }
+    return s;
+}
+
+static void
+oc_sess_persist(void)
+{
+    struct oc_sess_rec rec;
+    struct oc_sec_sess *s;
+    char name[16];
+    char val[OC_SESS_VAL_LEN];
+    int i;
+
+    i = 0;
+    for (s = oc_list_head(oc_sess_lru); s; s = oc_list_item_next(s), i++) {
+        memcpy(&rec.endpoint, &s->endpoint, sizeof(oc_endpoint_t));
+        memcpy(rec.uuid, s->uuid.id, sizeof(rec.uuid));
+        memcpy(rec.key, s->key, sizeof(rec.key));
+        snprintf(name, sizeof(name), "oc_sess/%d", i);
+        if (conf_str_from_bytes(&rec, sizeof(rec), val, sizeof(val))) {
+            conf_save_one(name, val);
+        }
+    }
+}
+
+void
+oc_sec_sess_save(oc_endpoint_t *endpoint, oc_uuid_t *uuid, const uint8_t *key)
+{
+    struct oc_sec_sess *s;
+
+    s = oc_sec_sess_lookup(endpoint);
+    if (!s) {
+        s = os_memblock_get(&oc_sess_pool);
+        if (!s) {
+            /* evict the least recently used binding */
+            s = oc_list_chop(oc_sess_lru);
+            if (!s) {
+                return;
+            }
+            STATS_INC(oc_sess_stats, evicted);
+        }
+        memcpy(&s->endpoint, endpoint, sizeof(oc_endpoint_t));
+    } else {
+        oc_list_remove(oc_sess_lru, s);
+    }
+    memcpy(&s->uuid, uuid, sizeof(oc_uuid_t));
+    memcpy(s->key, key, sizeof(s->key));
+    oc_list_push(oc_sess_lru, s);
+    oc_sess_persist();
+}
+
+void
+oc_sec_sess_hs_start(void)
+{
+    STATS_INC(oc_sess_stats, hs_start);
+}
+
+void
+oc_sec_sess_hs_done(void)
+{
+    STATS_INC(oc_sess_stats, hs_done);
+}
+
+void
+oc_sec_sess_hs_fail(void)
+{
+    STATS_INC(oc_sess_stats, hs_fail);
+}
+
+void
+oc_sec_sess_resumed(void)
+{
+    STATS_INC(oc_sess_stats, resumed);
+}
+
+static int
+oc_sess_conf_set(int argc, char **argv, char *val)
+{
+    struct oc_sess_rec rec;
+    struct oc_sec_sess *s;
+    int len;
+
+    if (argc != 1) {
+        return OS_ENOENT;
+    }
+    len = sizeof(rec);
+    if (conf_bytes_from_str(val, &rec, &len) || len != sizeof(rec)) {
+        return OS_EINVAL;
+    }
+    s = oc_sec_sess_lookup(&rec.endpoint);
+    if (!s) {
+        s = os_memblock_get(&oc_sess_pool);
+        if (!s) {
+            return 0;
+        }
+        oc_list_add(oc_sess_lru, s);
+    }
+    memcpy(&s->endpoint, &rec.endpoint, sizeof(oc_endpoint_t));
+    memcpy(s->uuid.id, rec.uuid, sizeof(rec.uuid));
+    memcpy(s->key, rec.key, sizeof(rec.key));
+    STATS_INC(oc_sess_stats, loaded);
+    return 0;
+}
+
+static int
+oc_sess_conf_export(void (*export_func)(char *name, char *val),
+                    enum conf_export_tgt tgt)
+{
+    struct oc_sess_rec rec;
+    struct oc_sec_sess *s;
+    char name[16];
+    char val[OC_SESS_VAL_LEN];
+    int i;
+
+    i = 0;
+    for (s = oc_list_head(oc_sess_lru); s; s = oc_list_item_next(s), i++) {
+        memcpy(&rec.endpoint, &s->endpoint, sizeof(oc_endpoint_t));
+        memcpy(rec.uuid, s->uuid.id, sizeof(rec.uuid));
+        memcpy(rec.key, s->key, sizeof(rec.key));
+        snprintf(name, sizeof(name), "oc_sess/%d", i);
+        if (conf_str_from_bytes(&rec, sizeof(rec), val, sizeof(val))) {
+            export_func(name, val);
+        }
+    }
+    return 0;
+}
+
+static struct conf_handler oc_sess_conf = {
+    .ch_name = "oc_sess",
+    .ch_get = NULL,
+    .ch_set = oc_sess_conf_set,
+    .ch_commit = NULL,
+    .ch_export = oc_sess_conf_export
+};
+
+void
+oc_sec_sess_init(void)
+{
+    oc_list_init(oc_sess_lru);
+    os_mempool_init(&oc_sess_pool, MYNEWT_VAL(OC_SESS_CACHE_SIZE),
+      sizeof(struct oc_sec_sess), oc_sess_area, "oc_sess");
+    conf_register(&oc_sess_conf);
+    stats_init_and_reg(STATS_HDR(oc_sess_stats),
+      STATS_SIZE_INIT_PARMS(oc_sess_stats, STATS_SIZE_32),
+      STATS_NAME_INIT_PARMS(oc_sess_stats), "oc_sess");
+}
+
+#endif /* OC_SECURITY && MYNEWT_VAL(OC_SESS_CACHE) */
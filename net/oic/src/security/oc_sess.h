@@ -0,0 +1,57 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef OC_SESS_H_
+#define OC_SESS_H_
+
+#include "oc_uuid.h"
+#include "port/oc_connectivity.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bounded LRU cache binding a peer endpoint to its identity and owner
+ * PSK, persisted through sys/config so rejoining nodes pick up their
+ * session state across reboots instead of starting from scratch.
+ */
+struct oc_sec_sess {
+    struct oc_sec_sess *next;
+    oc_endpoint_t endpoint;
+    oc_uuid_t uuid;
+    uint8_t key[16];
+};
+
+void oc_sec_sess_init(void);
+struct oc_sec_sess *oc_sec_sess_lookup(oc_endpoint_t *endpoint);
+void oc_sec_sess_save(oc_endpoint_t *endpoint, oc_uuid_t *uuid,
+                      const uint8_t *key);
+
+/* handshake-stage accounting, exposed in the oc_sess stats group */
+void oc_sec_sess_hs_start(void);
+void oc_sec_sess_hs_done(void);
+void oc_sec_sess_hs_fail(void);
+void oc_sec_sess_resumed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OC_SESS_H_ */
@@ -21,6 +21,7 @@
 
 #include <os/queue.h>
 #include <stdint.h>
+#include "syscfg/syscfg.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,6 +56,9 @@ enum conf_export_tgt {
 struct conf_handler {
     SLIST_ENTRY(conf_handler) ch_list;
     char *ch_name;
+#if MYNEWT_VAL(CONFIG_NAME_HASH)
+    uint32_t ch_name_hash;	/* filled in by conf_register() */
+#endif
     char *(*ch_get)(int argc, char **argv, char *val, int val_len_max);
     int (*ch_set)(int argc, char **argv, char *val);
     int (*ch_commit)(void);
@@ -89,6 +93,19 @@ char *conf_str_from_value(enum conf_type type, void *vp, char *buf,
 #define CONF_STR_FROM_BYTES_LEN(len) (((len) * 4 / 3) + 4)
 char *conf_str_from_bytes(void *vp, int vp_len, char *buf, int buf_len);
 
+/*
+ * Compact binary value codec; 1 byte of conf_type tag followed by the
+ * value as little-endian bytes (strings and byte arrays raw, without
+ * NUL).  For config stores which persist values without the ASCII
+ * round-trip through conf_str_from_value()/conf_value_from_str().
+ */
+int conf_bin_from_value(enum conf_type type, void *vp, uint8_t *buf,
+  int buf_len);
+int conf_bin_from_bytes(void *vp, int vp_len, uint8_t *buf, int buf_len);
+int conf_value_from_bin(uint8_t *buf, int buf_len, enum conf_type type,
+  void *vp, int maxlen);
+int conf_bytes_from_bin(uint8_t *buf, int buf_len, void *vp, int *len);
+
 #define CONF_VALUE_SET(str, type, val)                                  \
     conf_value_from_str((str), (type), &(val), sizeof(val))
 
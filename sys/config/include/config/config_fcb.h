@@ -25,9 +25,29 @@
 extern "C" {
 #endif
 
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+/*
+ * Latest-value index entry; tracks where the live version of one config
+ * name lives in flash.
+ */
+struct conf_fcb_live {
+    uint32_t cfl_name_hash;
+    struct flash_area *cfl_area;
+    uint32_t cfl_elem_off;
+    uint32_t cfl_data_off;
+    uint16_t cfl_data_len;
+};
+#endif
+
 struct conf_fcb {
     struct conf_store cf_store;
     struct fcb cf_fcb;
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+    struct conf_fcb_live cf_live[MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX_SLOTS)];
+    uint8_t cf_live_cnt;
+    uint8_t cf_live_valid;	/* index built by conf_fcb_src() */
+    uint8_t cf_live_full;	/* more names than slots; index disabled */
+#endif
 };
 
 extern int conf_fcb_src(struct conf_fcb *cf);
@@ -58,9 +58,26 @@ conf_init(void)
     conf_cmd_inited = 1;
 }
 
+#if MYNEWT_VAL(CONFIG_NAME_HASH)
+static uint32_t
+conf_name_hash(const char *name)
+{
+    uint32_t hash;
+
+    hash = 5381;
+    while (*name) {
+        hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+    return hash;
+}
+#endif
+
 int
 conf_register(struct conf_handler *handler)
 {
+#if MYNEWT_VAL(CONFIG_NAME_HASH)
+    handler->ch_name_hash = conf_name_hash(handler->ch_name);
+#endif
     SLIST_INSERT_HEAD(&conf_handlers, handler, ch_list);
     return 0;
 }
@@ -72,12 +89,22 @@ struct conf_handler *
 conf_handler_lookup(char *name)
 {
     struct conf_handler *ch;
+#if MYNEWT_VAL(CONFIG_NAME_HASH)
+    uint32_t hash;
 
+    hash = conf_name_hash(name);
+    SLIST_FOREACH(ch, &conf_handlers, ch_list) {
+        if (ch->ch_name_hash == hash && !strcmp(name, ch->ch_name)) {
+            return ch;
+        }
+    }
+#else
     SLIST_FOREACH(ch, &conf_handlers, ch_list) {
         if (!strcmp(name, ch->ch_name)) {
             return ch;
         }
     }
+#endif
     return NULL;
 }
 
@@ -227,6 +254,142 @@ conf_str_from_bytes(void *vp, int vp_len, char *buf, int buf_len)
     return buf;
 }
 
+int
+conf_bin_from_value(enum conf_type type, void *vp, uint8_t *buf, int buf_len)
+{
+    int64_t val;
+    int len;
+    int i;
+
+    switch (type) {
+    case CONF_BOOL:
+        val = *(bool *)vp;
+        len = 1;
+        break;
+    case CONF_INT8:
+        val = *(int8_t *)vp;
+        len = 1;
+        break;
+    case CONF_INT16:
+        val = *(int16_t *)vp;
+        len = 2;
+        break;
+    case CONF_INT32:
+        val = *(int32_t *)vp;
+        len = 4;
+        break;
+    case CONF_INT64:
+        val = *(int64_t *)vp;
+        len = 8;
+        break;
+    case CONF_STRING:
+        len = strlen(vp);
+        if (len + 1 > buf_len) {
+            return -1;
+        }
+        buf[0] = type;
+        memcpy(buf + 1, vp, len);
+        return len + 1;
+    default:
+        return -1;
+    }
+    if (len + 1 > buf_len) {
+        return -1;
+    }
+    buf[0] = type;
+    for (i = 0; i < len; i++) {
+        buf[1 + i] = (val >> (8 * i)) & 0xff;
+    }
+    return len + 1;
+}
+
+int
+conf_bin_from_bytes(void *vp, int vp_len, uint8_t *buf, int buf_len)
+{
+    if (vp_len + 1 > buf_len) {
+        return -1;
+    }
+    buf[0] = CONF_BYTES;
+    memcpy(buf + 1, vp, vp_len);
+    return vp_len + 1;
+}
+
+int
+conf_value_from_bin(uint8_t *buf, int buf_len, enum conf_type type, void *vp,
+  int maxlen)
+{
+    uint64_t val;
+    int len;
+    int i;
+
+    if (buf_len < 1 || buf[0] != type) {
+        goto err;
+    }
+    switch (type) {
+    case CONF_BOOL:
+        if (buf_len != 2 || buf[1] > 1) {
+            goto err;
+        }
+        *(bool *)vp = buf[1];
+        break;
+    case CONF_INT8:
+        if (buf_len != 2) {
+            goto err;
+        }
+        *(int8_t *)vp = (int8_t)buf[1];
+        break;
+    case CONF_INT16:
+    case CONF_INT32:
+    case CONF_INT64:
+        if (type == CONF_INT16) {
+            len = 2;
+        } else if (type == CONF_INT32) {
+            len = 4;
+        } else {
+            len = 8;
+        }
+        if (buf_len != len + 1) {
+            goto err;
+        }
+        val = 0;
+        for (i = len - 1; i >= 0; i--) {
+            val = (val << 8) | buf[1 + i];
+        }
+        if (type == CONF_INT16) {
+            *(int16_t *)vp = (int16_t)val;
+        } else if (type == CONF_INT32) {
+            *(int32_t *)vp = (int32_t)val;
+        } else {
+            *(int64_t *)vp = (int64_t)val;
+        }
+        break;
+    case CONF_STRING:
+        len = buf_len - 1;
+        if (len + 1 > maxlen) {
+            goto err;
+        }
+        memcpy(vp, buf + 1, len);
+        ((char *)vp)[len] = '\0';
+        break;
+    default:
+        goto err;
+    }
+    return 0;
+err:
+    return OS_INVALID_PARM;
+}
+
+int
+conf_bytes_from_bin(uint8_t *buf, int buf_len, void *vp, int *len)
+{
+    if (buf_len < 1 || buf[0] != CONF_BYTES || buf_len - 1 > *len) {
+        return OS_INVALID_PARM;
+    }
+    memcpy(vp, buf + 1, buf_len - 1);
+    *len = buf_len - 1;
+    return 0;
+}
+
 int
 conf_set_value(char *name, char *val_str)
 {
@@ -46,6 +46,137 @@ static struct conf_store_itf conf_fcb_itf = {
     .csi_save = conf_fcb_save,
 };
 
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+#define CONF_FCB_LIVE_SLOTS	MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX_SLOTS)
+
+static uint32_t
+conf_fcb_name_hash(const char *name)
+{
+    uint32_t hash;
+
+    hash = 5381;
+    while (*name) {
+        hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+    return hash;
+}
+
+static struct conf_fcb_live *
+conf_fcb_live_find(struct conf_fcb *cf, uint32_t hash)
+{
+    int i;
+
+    for (i = 0; i < cf->cf_live_cnt; i++) {
+        if (cf->cf_live[i].cfl_name_hash == hash) {
+            return &cf->cf_live[i];
+        }
+    }
+    return NULL;
+}
+
+static void
+conf_fcb_live_fill(struct conf_fcb_live *cfl, struct fcb_entry *loc)
+{
+    cfl->cfl_area = loc->fe_area;
+    cfl->cfl_elem_off = loc->fe_elem_off;
+    cfl->cfl_data_off = loc->fe_data_off;
+    cfl->cfl_data_len = loc->fe_data_len;
+}
+
+static int
+conf_fcb_live_read(struct conf_fcb_live *cfl, char *buf, int buf_len,
+  char **name, char **val)
+{
+    int rc;
+    int len;
+
+    len = cfl->cfl_data_len;
+    if (len >= buf_len) {
+        len = buf_len - 1;
+    }
+    rc = flash_area_read(cfl->cfl_area, cfl->cfl_data_off, buf, len);
+    if (rc) {
+        return rc;
+    }
+    buf[len] = '\0';
+    return conf_line_parse(buf, name, val);
+}
+
+static void
+conf_fcb_live_upsert(struct conf_fcb *cf, const char *name,
+  struct fcb_entry *loc)
+{
+    char buf[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    struct conf_fcb_live *cfl;
+    uint32_t hash;
+    char *oname;
+    char *oval;
+
+    if (!cf->cf_live_valid || cf->cf_live_full) {
+        return;
+    }
+    hash = conf_fcb_name_hash(name);
+    cfl = conf_fcb_live_find(cf, hash);
+    if (cfl) {
+        /*
+         * Guard against hash collisions; only take over a slot if the
+         * entry it points at carries the same name.
+         */
+        if (conf_fcb_live_read(cfl, buf, sizeof(buf), &oname, &oval) ||
+            strcmp(oname, name)) {
+            cf->cf_live_full = 1;
+            return;
+        }
+    } else {
+        if (cf->cf_live_cnt >= CONF_FCB_LIVE_SLOTS) {
+            cf->cf_live_full = 1;
+            return;
+        }
+        cfl = &cf->cf_live[cf->cf_live_cnt++];
+        cfl->cfl_name_hash = hash;
+    }
+    conf_fcb_live_fill(cfl, loc);
+}
+
+static int
+conf_fcb_live_build_cb(struct fcb_entry *loc, void *arg)
+{
+    struct conf_fcb *cf = (struct conf_fcb *)arg;
+    char buf[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    char *name;
+    char *val;
+    int len;
+    int rc;
+
+    len = loc->fe_data_len;
+    if (len >= sizeof(buf)) {
+        len = sizeof(buf) - 1;
+    }
+    rc = flash_area_read(loc->fe_area, loc->fe_data_off, buf, len);
+    if (rc) {
+        return 0;
+    }
+    buf[len] = '\0';
+
+    rc = conf_line_parse(buf, &name, &val);
+    if (rc) {
+        return 0;
+    }
+    conf_fcb_live_upsert(cf, name, loc);
+    return 0;
+}
+
+static void
+conf_fcb_live_build(struct conf_fcb *cf)
+{
+    memset(cf->cf_live, 0, sizeof(cf->cf_live));
+    cf->cf_live_cnt = 0;
+    cf->cf_live_full = 0;
+    cf->cf_live_valid = 1;
+    fcb_walk(&cf->cf_fcb, 0, conf_fcb_live_build_cb, cf);
+}
+#endif /* MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX) */
+
 int
 conf_fcb_src(struct conf_fcb *cf)
 {
@@ -73,6 +204,10 @@ conf_fcb_src(struct conf_fcb *cf)
         }
     }
 
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+    conf_fcb_live_build(cf);
+#endif
+
     cf->cf_store.cs_itf = &conf_fcb_itf;
     conf_src_register(&cf->cf_store);
 
@@ -125,6 +260,27 @@ conf_fcb_load(struct conf_store *cs, load_cb cb, void *cb_arg)
     struct conf_fcb *cf = (struct conf_fcb *)cs;
     struct conf_fcb_load_cb_arg arg;
     int rc;
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+    char buf[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    char *name;
+    char *val;
+    int i;
+
+    /*
+     * Serve each live value straight from its indexed location instead
+     * of replaying the whole write history.
+     */
+    if (cf->cf_live_valid && !cf->cf_live_full) {
+        for (i = 0; i < cf->cf_live_cnt; i++) {
+            if (conf_fcb_live_read(&cf->cf_live[i], buf, sizeof(buf),
+                                   &name, &val)) {
+                continue;
+            }
+            cb(name, val, cb_arg);
+        }
+        return OS_OK;
+    }
+#endif
 
     arg.cb = cb;
     arg.cb_arg = cb_arg;
@@ -160,6 +316,9 @@ conf_fcb_compress(struct conf_fcb *cf)
     char *name1, *val1;
     char *name2, *val2;
     int copy;
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+    struct conf_fcb_live *cfl;
+#endif
 
     rc = fcb_append_to_scratch(&cf->cf_fcb);
     if (rc) {
@@ -176,16 +335,31 @@ conf_fcb_compress(struct conf_fcb *cf)
         if (rc) {
             continue;
         }
-        loc2 = loc1;
-        copy = 1;
-        while (fcb_getnext(&cf->cf_fcb, &loc2) == 0) {
-            rc = conf_fcb_var_read(&loc2, buf2, &name2, &val2);
-            if (rc) {
-                continue;
-            }
-            if (!strcmp(name1, name2)) {
-                copy = 0;
-                break;
+        copy = -1;
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+        cfl = NULL;
+        if (cf->cf_live_valid && !cf->cf_live_full) {
+            /*
+             * The index already knows whether this entry holds the
+             * latest value for its name.
+             */
+            cfl = conf_fcb_live_find(cf, conf_fcb_name_hash(name1));
+            copy = (cfl && cfl->cfl_area == loc1.fe_area &&
+                    cfl->cfl_elem_off == loc1.fe_elem_off);
+        }
+#endif
+        if (copy < 0) {
+            loc2 = loc1;
+            copy = 1;
+            while (fcb_getnext(&cf->cf_fcb, &loc2) == 0) {
+                rc = conf_fcb_var_read(&loc2, buf2, &name2, &val2);
+                if (rc) {
+                    continue;
+                }
+                if (!strcmp(name1, name2)) {
+                    copy = 0;
+                    break;
+                }
             }
         }
         if (!copy) {
@@ -210,6 +384,11 @@ conf_fcb_compress(struct conf_fcb *cf)
             continue;
         }
         fcb_append_finish(&cf->cf_fcb, &loc2);
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+        if (cfl) {
+            conf_fcb_live_fill(cfl, &loc2);
+        }
+#endif
     }
     rc = fcb_rotate(&cf->cf_fcb);
     if (rc) {
@@ -219,14 +398,14 @@ conf_fcb_compress(struct conf_fcb *cf)
 }
 
 static int
-conf_fcb_append(struct conf_fcb *cf, char *buf, int len)
+conf_fcb_append(struct conf_fcb *cf, char *buf, int len,
+  struct fcb_entry *loc)
 {
     int rc;
     int i;
-    struct fcb_entry loc;
 
     for (i = 0; i < 10; i++) {
-        rc = fcb_append(&cf->cf_fcb, len, &loc);
+        rc = fcb_append(&cf->cf_fcb, len, loc);
         if (rc != FCB_ERR_NOSPACE) {
             break;
         }
@@ -235,11 +414,11 @@ conf_fcb_append(struct conf_fcb *cf, char *buf, int len)
     if (rc) {
         return OS_EINVAL;
     }
-    rc = flash_area_write(loc.fe_area, loc.fe_data_off, buf, len);
+    rc = flash_area_write(loc->fe_area, loc->fe_data_off, buf, len);
     if (rc) {
         return OS_EINVAL;
     }
-    fcb_append_finish(&cf->cf_fcb, &loc);
+    fcb_append_finish(&cf->cf_fcb, loc);
     return OS_OK;
 }
 
@@ -248,7 +427,9 @@ conf_fcb_save(struct conf_store *cs, const char *name, const char *value)
 {
     struct conf_fcb *cf = (struct conf_fcb *)cs;
     char buf[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    struct fcb_entry loc;
     int len;
+    int rc;
 
     if (!name) {
         return OS_INVALID_PARM;
@@ -258,7 +439,13 @@ conf_fcb_save(struct conf_store *cs, const char *name, const char *value)
     if (len < 0 || len + 2 > sizeof(buf)) {
         return OS_INVALID_PARM;
     }
-    return conf_fcb_append(cf, buf, len);
+    rc = conf_fcb_append(cf, buf, len, &loc);
+#if MYNEWT_VAL(CONFIG_FCB_LIVE_INDEX)
+    if (rc == OS_OK) {
+        conf_fcb_live_upsert(cf, name, &loc);
+    }
+#endif
+    return rc;
 }
 
 #endif
@@ -305,6 +305,7 @@ TEST_CASE_DECL(config_test_insert)
 TEST_CASE_DECL(config_test_getset_unknown)
 TEST_CASE_DECL(config_test_getset_int)
 TEST_CASE_DECL(config_test_getset_bytes)
+TEST_CASE_DECL(config_test_codec)
 TEST_CASE_DECL(config_test_commit)
 TEST_CASE_DECL(config_test_empty_fcb)
 TEST_CASE_DECL(config_test_save_1_fcb)
@@ -325,6 +326,7 @@ TEST_SUITE(config_test_all)
     config_test_getset_unknown();
     config_test_getset_int();
     config_test_getset_bytes();
+    config_test_codec();
 
     config_test_commit();
 
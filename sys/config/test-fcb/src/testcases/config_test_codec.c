@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "conf_test_fcb.h"
+
+TEST_CASE(config_test_codec)
+{
+    uint8_t bin[CONF_MAX_VAL_LEN];
+    char str[32];
+    char orig[32];
+    char bytes[32];
+    int8_t v8, o8;
+    int16_t v16, o16;
+    int32_t cv32, co32;
+    int64_t v64, o64;
+    bool vb, ob;
+    int tmp;
+    int len;
+    int rc;
+    int i;
+
+    o8 = -42;
+    len = conf_bin_from_value(CONF_INT8, &o8, bin, sizeof(bin));
+    TEST_ASSERT(len == 2);
+    rc = conf_value_from_bin(bin, len, CONF_INT8, &v8, sizeof(v8));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(v8 == o8);
+
+    o16 = -12345;
+    len = conf_bin_from_value(CONF_INT16, &o16, bin, sizeof(bin));
+    TEST_ASSERT(len == 3);
+    rc = conf_value_from_bin(bin, len, CONF_INT16, &v16, sizeof(v16));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(v16 == o16);
+
+    co32 = -123456789;
+    len = conf_bin_from_value(CONF_INT32, &co32, bin, sizeof(bin));
+    TEST_ASSERT(len == 5);
+    rc = conf_value_from_bin(bin, len, CONF_INT32, &cv32, sizeof(cv32));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cv32 == co32);
+
+    o64 = -1234567890123LL;
+    len = conf_bin_from_value(CONF_INT64, &o64, bin, sizeof(bin));
+    TEST_ASSERT(len == 9);
+    rc = conf_value_from_bin(bin, len, CONF_INT64, &v64, sizeof(v64));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(v64 == o64);
+
+    ob = true;
+    len = conf_bin_from_value(CONF_BOOL, &ob, bin, sizeof(bin));
+    TEST_ASSERT(len == 2);
+    rc = conf_value_from_bin(bin, len, CONF_BOOL, &vb, sizeof(vb));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(vb == ob);
+
+    strcpy(orig, "codec test");
+    len = conf_bin_from_value(CONF_STRING, orig, bin, sizeof(bin));
+    TEST_ASSERT(len == strlen(orig) + 1);
+    rc = conf_value_from_bin(bin, len, CONF_STRING, str, sizeof(str));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(!strcmp(str, orig));
+
+    for (i = 0; i < sizeof(orig); i++) {
+        orig[i] = i + 3;
+    }
+    len = conf_bin_from_bytes(orig, sizeof(orig), bin, sizeof(bin));
+    TEST_ASSERT(len == sizeof(orig) + 1);
+    tmp = sizeof(bytes);
+    rc = conf_bytes_from_bin(bin, len, bytes, &tmp);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(tmp == sizeof(orig));
+    TEST_ASSERT(!memcmp(orig, bytes, sizeof(orig)));
+
+    /*
+     * Type tag mismatch and truncated input must be rejected.
+     */
+    len = conf_bin_from_value(CONF_INT16, &o16, bin, sizeof(bin));
+    rc = conf_value_from_bin(bin, len, CONF_INT32, &cv32, sizeof(cv32));
+    TEST_ASSERT(rc != 0);
+    rc = conf_value_from_bin(bin, len - 1, CONF_INT16, &v16, sizeof(v16));
+    TEST_ASSERT(rc != 0);
+}
@@ -20,6 +20,7 @@
 #define __CONSOLE_H__
 
 #include <stdarg.h>
+#include "syscfg/syscfg.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,6 +35,39 @@ int console_read(char *str, int cnt, int *newline);
 void console_blocking_mode(void);
 void console_echo(int on);
 
+#if MYNEWT_VAL(CONSOLE_RX_DEFER)
+struct os_eventq;
+
+/*
+ * Deferred RX: received bytes are staged at interrupt time and line
+ * editing/echo run from this event queue (default event queue unless
+ * overridden before console_init()).
+ */
+void console_rx_evq_set(struct os_eventq *evq);
+
+/*
+ * Raw mode hands staged bytes straight to the reader with no line
+ * editing or echo; for protocol transports layered on the console.
+ * The rx_cb passed to console_init() then fires at task level and
+ * console_read_raw() drains whole frames in bulk.
+ */
+void console_raw_mode(int on);
+int console_read_raw(char *str, int cnt);
+#endif
+
+#if MYNEWT_VAL(CONSOLE_MUX)
+/*
+ * Queues a channel-tagged frame (channels 1-255; channel 0 is the
+ * unframed interactive stream) for transmission.  Frames only go out
+ * while the interactive stream is idle, so bulk channels never starve
+ * the shell.  Non-blocking; data is split into frames of at most
+ * CONSOLE_MUX_FRAME_SZ bytes and the number of bytes queued is
+ * returned, which may be short if the mux buffer is full.  The wire
+ * format the PC-side demux needs is described in the package README.
+ */
+int console_mux_write(int chan, const void *data, int len);
+#endif
+
 void console_printf(const char *fmt, ...)
     __attribute__ ((format (printf, 1, 2)));;
 
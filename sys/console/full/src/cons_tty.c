@@ -44,6 +44,8 @@ int console_is_midline;
 #define CONSOLE_RIGHT           'C'     /* esc-[-C moving right */
 #define CONSOLE_DOWN            'B'     /* esc-[-B moving down */
 
+#define CONSOLE_MUX_SOH         0x01    /* frame delimiter when muxing */
+
 #define CONSOLE_HEAD_INC(cr)    (((cr)->cr_head + 1) & ((cr)->cr_size - 1))
 #define CONSOLE_TAIL_INC(cr)    (((cr)->cr_tail + 1) & ((cr)->cr_size - 1))
 
@@ -72,6 +74,15 @@ struct console_tty {
     console_write_char ct_write_char;
     uint8_t ct_echo_off:1;
     uint8_t ct_esc_seq:2;
+#if MYNEWT_VAL(CONSOLE_RX_DEFER)
+    uint8_t ct_rx_raw_mode:1;
+
+    struct console_ring ct_rx_raw;
+    /* must be after console_ring */
+    uint8_t ct_rx_raw_buf[MYNEWT_VAL(CONSOLE_RX_BUF_SIZE)];
+
+    struct os_event ct_rx_ev;
+#endif
 } console_tty;
 
 #if MYNEWT_VAL(CONSOLE_HIST_ENABLE)
@@ -112,6 +123,7 @@ console_pull_char_head(struct console_ring *cr)
     }
 }
 
+#if !MYNEWT_VAL(CONSOLE_NON_BLOCKING)
 static void
 console_queue_char(char ch)
 {
@@ -131,6 +143,145 @@ console_queue_char(char ch)
     console_add_char(&ct->ct_tx, ch);
     OS_EXIT_CRITICAL(sr);
 }
+#endif
+
+#if MYNEWT_VAL(CONSOLE_NON_BLOCKING)
+static int console_buf_space(struct console_ring *cr);
+
+/* Characters dropped from the TX ring since the last marker. */
+static uint32_t console_tx_dropped;
+
+/*
+ * If characters were dropped and the ring now has room, queue a
+ * "[+N dropped]" marker before any further output.  Called with
+ * interrupts disabled.
+ */
+static void
+console_drop_marker(struct console_tty *ct)
+{
+    char buf[16];
+    char num[10];
+    int len;
+    int i;
+    uint32_t n;
+
+    n = console_tx_dropped;
+    i = 0;
+    do {
+        num[i++] = '0' + n % 10;
+        n /= 10;
+    } while (n);
+
+    len = 0;
+    buf[len++] = '[';
+    buf[len++] = '+';
+    while (i > 0) {
+        buf[len++] = num[--i];
+    }
+    buf[len++] = ' ';
+    buf[len++] = 'd';
+    buf[len++] = 'r';
+    buf[len++] = 'o';
+    buf[len++] = 'p';
+    buf[len++] = 'p';
+    buf[len++] = 'e';
+    buf[len++] = 'd';
+    buf[len++] = ']';
+
+    if (console_buf_space(&ct->ct_tx) < len + 1) {
+        /*
+         * Not yet; try again on a later write.
+         */
+        return;
+    }
+    for (i = 0; i < len; i++) {
+        console_add_char(&ct->ct_tx, buf[i]);
+    }
+    console_tx_dropped = 0;
+}
+
+/*
+ * Like console_queue_char(), except a full TX ring sheds its oldest
+ * character instead of stalling the writer.
+ */
+static void
+console_queue_char_nb(char ch)
+{
+    struct console_tty *ct = &console_tty;
+    int sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (console_tx_dropped) {
+        console_drop_marker(ct);
+    }
+    if (CONSOLE_HEAD_INC(&ct->ct_tx) == ct->ct_tx.cr_tail) {
+        console_pull_char(&ct->ct_tx);
+        console_tx_dropped++;
+    }
+    console_add_char(&ct->ct_tx, ch);
+    OS_EXIT_CRITICAL(sr);
+}
+#endif
+
+#if MYNEWT_VAL(CONSOLE_MUX)
+static int console_buf_space(struct console_ring *cr);
+
+/*
+ * Framed TX multiplexing.  The interactive stream stays channel 0 and
+ * goes out unframed through the regular TX ring; bulk writers queue
+ * channel-tagged frames here and the TX interrupt drains them only
+ * while the interactive ring is empty.  A frame in progress always
+ * finishes, so the demux on the other end can rely on frames being
+ * contiguous, and interactive output is delayed by at most one frame.
+ * See the package README for the wire format.
+ */
+static struct console_ring console_mux_tx;
+static uint8_t console_mux_tx_buf[MYNEWT_VAL(CONSOLE_MUX_BUF_SIZE)];
+
+/* Header+payload bytes left of the frame currently on the wire. */
+static uint16_t console_mux_frame_rem;
+
+int
+console_mux_write(int chan, const void *data, int len)
+{
+    struct console_tty *ct = &console_tty;
+    const uint8_t *p = data;
+    int chunk;
+    int queued;
+    int sr;
+    int i;
+
+    if (chan < 1 || chan > 255 || !ct->ct_dev) {
+        return -1;
+    }
+
+    queued = 0;
+    while (len > 0) {
+        chunk = len;
+        if (chunk > MYNEWT_VAL(CONSOLE_MUX_FRAME_SZ)) {
+            chunk = MYNEWT_VAL(CONSOLE_MUX_FRAME_SZ);
+        }
+        OS_ENTER_CRITICAL(sr);
+        if (console_buf_space(&console_mux_tx) < chunk + 2) {
+            OS_EXIT_CRITICAL(sr);
+            break;
+        }
+        console_add_char(&console_mux_tx, chan);
+        console_add_char(&console_mux_tx, chunk);
+        for (i = 0; i < chunk; i++) {
+            console_add_char(&console_mux_tx, p[i]);
+        }
+        OS_EXIT_CRITICAL(sr);
+        p += chunk;
+        len -= chunk;
+        queued += chunk;
+    }
+    if (queued > 0) {
+        uart_start_tx(ct->ct_dev);
+    }
+    return queued;
+}
+#endif
 
 #if MYNEWT_VAL(CONSOLE_HIST_ENABLE)
 static void
@@ -283,6 +434,17 @@ console_file_write(void *arg, const char *str, size_t cnt)
         if (str[i] == '\n') {
             ct->ct_write_char('\r');
         }
+#if MYNEWT_VAL(CONSOLE_MUX)
+        if (str[i] == CONSOLE_MUX_SOH) {
+            /*
+             * Escape a literal SOH in the interactive stream so the
+             * demux does not mistake it for a frame start.
+             */
+            ct->ct_write_char(CONSOLE_MUX_SOH);
+            ct->ct_write_char('\0');
+            continue;
+        }
+#endif
         ct->ct_write_char(str[i]);
     }
     if (cnt > 0) {
@@ -346,7 +508,30 @@ console_tx_char(void *arg)
     struct console_tty *ct = (struct console_tty *)arg;
     struct console_ring *cr = &ct->ct_tx;
 
+#if MYNEWT_VAL(CONSOLE_MUX)
+    if (console_mux_frame_rem > 0) {
+        /*
+         * Finish the frame on the wire before anything else; the demux
+         * relies on frames being contiguous.
+         */
+        console_mux_frame_rem--;
+        return console_pull_char(&console_mux_tx);
+    }
+#endif
     if (cr->cr_head == cr->cr_tail) {
+#if MYNEWT_VAL(CONSOLE_MUX)
+        /*
+         * Interactive stream is idle; start the next queued bulk
+         * frame, if any.  The channel and length bytes are next in
+         * the mux ring, behind the SOH emitted here.
+         */
+        if (console_mux_tx.cr_head != console_mux_tx.cr_tail) {
+            console_mux_frame_rem = 2 +
+                console_mux_tx.cr_buf[(console_mux_tx.cr_tail + 1) &
+                                      (console_mux_tx.cr_size - 1)];
+            return CONSOLE_MUX_SOH;
+        }
+#endif
         /*
          * No more data.
          */
@@ -507,6 +692,111 @@ out:
     return 0;
 }
 
+#if MYNEWT_VAL(CONSOLE_RX_DEFER)
+static struct os_eventq *console_rx_evq;
+
+void
+console_rx_evq_set(struct os_eventq *evq)
+{
+    console_rx_evq = evq;
+}
+
+/*
+ * Line editing and echo for bytes staged by console_rx_char_defer().
+ * Runs at task level from the RX event queue.
+ */
+static void
+console_rx_ev_cb(struct os_event *ev)
+{
+    struct console_tty *ct = &console_tty;
+    struct console_ring *raw = &ct->ct_rx_raw;
+    int sr;
+    uint8_t ch;
+
+    if (ct->ct_rx_raw_mode) {
+        /*
+         * Raw mode; the consumer bulk-reads the staging ring itself.
+         */
+        if (ct->ct_rx_cb) {
+            ct->ct_rx_cb();
+        }
+        return;
+    }
+    while (1) {
+        OS_ENTER_CRITICAL(sr);
+        if (raw->cr_head == raw->cr_tail) {
+            OS_EXIT_CRITICAL(sr);
+            break;
+        }
+        ch = console_pull_char(raw);
+        OS_EXIT_CRITICAL(sr);
+        console_rx_char(ct, ch);
+    }
+    uart_start_rx(ct->ct_dev);
+}
+
+/*
+ * Interrupt-time RX handler when deferral is on; just stages the byte
+ * and wakes the processing task.
+ */
+static int
+console_rx_char_defer(void *arg, uint8_t data)
+{
+    struct console_tty *ct = (struct console_tty *)arg;
+    struct console_ring *raw = &ct->ct_rx_raw;
+
+    if (CONSOLE_HEAD_INC(raw) == raw->cr_tail) {
+        /*
+         * Staging ring full. Processing task must drain this.
+         */
+        os_eventq_put(console_rx_evq, &ct->ct_rx_ev);
+        return -1;
+    }
+    console_add_char(raw, data);
+    os_eventq_put(console_rx_evq, &ct->ct_rx_ev);
+    return 0;
+}
+
+void
+console_raw_mode(int on)
+{
+    struct console_tty *ct = &console_tty;
+
+    ct->ct_rx_raw_mode = (on != 0);
+}
+
+int
+console_read_raw(char *str, int cnt)
+{
+    struct console_tty *ct = &console_tty;
+    struct console_ring *raw = &ct->ct_rx_raw;
+    int sr;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < cnt; i++) {
+        if (raw->cr_head == raw->cr_tail) {
+            break;
+        }
+
+        if ((i & (CONSOLE_RX_CHUNK - 1)) == (CONSOLE_RX_CHUNK - 1)) {
+            /*
+             * Make a break from blocking interrupts during the copy.
+             */
+            OS_EXIT_CRITICAL(sr);
+            OS_ENTER_CRITICAL(sr);
+        }
+
+        *str++ = console_pull_char(raw);
+    }
+    OS_EXIT_CRITICAL(sr);
+    if (i > 0) {
+        uart_start_rx(ct->ct_dev);
+    }
+    return i;
+}
+#endif
+
 int
 console_is_init(void)
 {
@@ -531,7 +821,11 @@ console_init(console_rx_cb rx_cb)
         .uc_parity = UART_PARITY_NONE,
         .uc_flow_ctl = MYNEWT_VAL(CONSOLE_FLOW_CONTROL),
         .uc_tx_char = console_tx_char,
+#if MYNEWT_VAL(CONSOLE_RX_DEFER)
+        .uc_rx_char = console_rx_char_defer,
+#else
         .uc_rx_char = console_rx_char,
+#endif
         .uc_cb_arg = ct
     };
 
@@ -541,7 +835,24 @@ console_init(console_rx_cb rx_cb)
         ct->ct_tx.cr_buf = ct->ct_tx_buf;
         ct->ct_rx.cr_size = MYNEWT_VAL(CONSOLE_RX_BUF_SIZE);
         ct->ct_rx.cr_buf = ct->ct_rx_buf;
+#if MYNEWT_VAL(CONSOLE_MUX)
+        console_mux_tx.cr_size = MYNEWT_VAL(CONSOLE_MUX_BUF_SIZE);
+        console_mux_tx.cr_buf = console_mux_tx_buf;
+        assert(is_power_of_two(MYNEWT_VAL(CONSOLE_MUX_BUF_SIZE)));
+#endif
+#if MYNEWT_VAL(CONSOLE_RX_DEFER)
+        ct->ct_rx_raw.cr_size = MYNEWT_VAL(CONSOLE_RX_BUF_SIZE);
+        ct->ct_rx_raw.cr_buf = ct->ct_rx_raw_buf;
+        ct->ct_rx_ev.ev_cb = console_rx_ev_cb;
+        if (!console_rx_evq) {
+            console_rx_evq = os_eventq_dflt_get();
+        }
+#endif
+#if MYNEWT_VAL(CONSOLE_NON_BLOCKING)
+        ct->ct_write_char = console_queue_char_nb;
+#else
         ct->ct_write_char = console_queue_char;
+#endif
 
         ct->ct_dev = (struct uart_dev *)os_dev_open(CONSOLE_UART,
           OS_TIMEOUT_NEVER, &uc);
@@ -27,6 +27,7 @@ extern "C" {
 #include <inttypes.h>
 
 #define COREDUMP_MAGIC              0x690c47c3
+#define COREDUMP_COMP_MAGIC         0x690c47c4  /* LZSS-compressed corefile */
 
 /*
  * Coredump TLV types.
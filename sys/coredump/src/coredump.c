@@ -22,69 +22,249 @@
 #include "syscfg/syscfg.h"
 #include "sysflash/sysflash.h"
 #include "hal/hal_bsp.h"
+#include "hal/hal_watchdog.h"
 #include "flash_map/flash_map.h"
 #include "bootutil/image.h"
 #include "imgmgr/imgmgr.h"
 #include "coredump/coredump.h"
+#if MYNEWT_VAL(COREDUMP_COMPRESS)
+#include "lzss/lzss.h"
+#endif
+#if MYNEWT_VAL(COREDUMP_MINIDUMP)
+#include "os/os.h"
+#include "stats/stats.h"
+#endif
 
 uint8_t coredump_disabled;
 
+#if MYNEWT_VAL(COREDUMP_COMPRESS)
+/*
+ * RAM is compressed in chunks this big, with a watchdog tickle in
+ * between.
+ */
+#define COREDUMP_COMPRESS_CHUNK     512
+
+struct coredump_comp_state {
+    const struct flash_area *ccs_fa;
+    uint32_t ccs_off;           /* next write offset in flash */
+    int ccs_err;
+};
+
+static struct coredump_comp_state coredump_comp_state;
+static struct lzss_encoder coredump_lzss;
+
+static int
+coredump_comp_out(void *arg, const uint8_t *data, int len)
+{
+    struct coredump_comp_state *ccs = (struct coredump_comp_state *)arg;
+    int rc;
+
+    if (ccs->ccs_off + len > ccs->ccs_fa->fa_size) {
+        ccs->ccs_err = -1;
+        return -1;
+    }
+    rc = flash_area_write(ccs->ccs_fa, ccs->ccs_off, data, len);
+    if (rc) {
+        ccs->ccs_err = rc;
+        return rc;
+    }
+    ccs->ccs_off += len;
+    return 0;
+}
+#endif
+
 static void
 dump_core_tlv(const struct flash_area *fa, uint32_t *off,
   struct coredump_tlv *tlv, void *data)
 {
+#if MYNEWT_VAL(COREDUMP_COMPRESS)
+    uint8_t *u = (uint8_t *)data;
+    int blk;
+    int len;
+
+    /*
+     * *off tracks the pre-compression byte count; the flash write
+     * position lives in coredump_comp_state.
+     */
+    lzss_enc_input(&coredump_lzss, tlv, sizeof(*tlv));
+    *off += sizeof(*tlv);
+
+    len = tlv->ct_len;
+    while (len > 0) {
+        blk = len;
+        if (blk > COREDUMP_COMPRESS_CHUNK) {
+            blk = COREDUMP_COMPRESS_CHUNK;
+        }
+        lzss_enc_input(&coredump_lzss, u, blk);
+        u += blk;
+        len -= blk;
+        hal_watchdog_tickle();
+    }
+    *off += tlv->ct_len;
+#else
     flash_area_write(fa, *off, tlv, sizeof(*tlv));
     *off += sizeof(*tlv);
 
     flash_area_write(fa, *off, data, tlv->ct_len);
     *off += tlv->ct_len;
+    hal_watchdog_tickle();
+#endif
 }
 
-void
-coredump_dump(void *regs, int regs_sz)
+#if MYNEWT_VAL(COREDUMP_MINIDUMP)
+
+/*
+ * All ports lay out struct coredump_regs as r0-r12, sp, lr, pc, psr;
+ * word 13 is the stack pointer at the time of the fault.
+ */
+#define COREDUMP_REGS_SP_WORD       13
+
+static int
+minidump_stats_size(struct stats_hdr *hdr, void *arg)
+{
+    uint32_t *szp = (uint32_t *)arg;
+
+    *szp += sizeof(struct coredump_tlv) + sizeof(*hdr) +
+      hdr->s_size * hdr->s_cnt;
+    return 0;
+}
+
+struct minidump_stats_arg {
+    const struct flash_area *fa;
+    uint32_t *off;
+};
+
+static int
+minidump_stats_dump(struct stats_hdr *hdr, void *arg)
+{
+    struct minidump_stats_arg *msa = (struct minidump_stats_arg *)arg;
+    struct coredump_tlv tlv;
+
+    tlv.ct_type = COREDUMP_TLV_MEM;
+    tlv._pad = 0;
+    tlv.ct_len = sizeof(*hdr) + hdr->s_size * hdr->s_cnt;
+    tlv.ct_off = (uint32_t)hdr;
+    dump_core_tlv(msa->fa, msa->off, &tlv, hdr);
+    return 0;
+}
+
+/*
+ * Picks the slice of the faulting task's stack to save: up to
+ * COREDUMP_MINIDUMP_STACK_SIZE bytes starting at the faulting SP,
+ * clipped at the stack top when SP falls within the current task's
+ * stack.  Returns the slice length; 0 when SP can't be trusted.
+ */
+static uint32_t
+minidump_stack_region(void *regs, int regs_sz, uint32_t *startp)
+{
+    struct os_task *t;
+    uint32_t sp;
+    uint32_t end;
+
+    if (regs_sz < (COREDUMP_REGS_SP_WORD + 1) * sizeof(uint32_t)) {
+        return 0;
+    }
+    sp = ((uint32_t *)regs)[COREDUMP_REGS_SP_WORD];
+    if (sp == 0 || (sp & 3)) {
+        return 0;
+    }
+    end = sp + MYNEWT_VAL(COREDUMP_MINIDUMP_STACK_SIZE);
+    t = os_sched_get_current_task();
+    if (t != NULL &&
+        sp >= (uint32_t)(t->t_stacktop - t->t_stacksize) &&
+        sp < (uint32_t)t->t_stacktop &&
+        end > (uint32_t)t->t_stacktop) {
+        end = (uint32_t)t->t_stacktop;
+    }
+    *startp = sp;
+    return end - sp;
+}
+
+static void
+coredump_minidump(const struct flash_area *fa, void *regs, int regs_sz)
 {
     struct coredump_header hdr;
     struct coredump_tlv tlv;
-    const struct flash_area *fa;
     struct image_version ver;
-    const struct hal_bsp_mem_dump *mem, *cur;
-    int area_cnt, i;
+    struct minidump_stats_arg msa;
     uint8_t hash[IMGMGR_HASH_LEN];
+    uint32_t stack_start;
+    uint32_t stack_sz;
+    uint32_t need;
     uint32_t off;
-    uint32_t area_off, area_end;
-    int slot;
 
-    if (coredump_disabled) {
+    stack_sz = minidump_stack_region(regs, regs_sz, &stack_start);
+
+    /*
+     * Erase only what the minidump can occupy; this, and skipping the
+     * RAM areas, is what bounds the on-fault cost to a few
+     * milliseconds instead of a full image slot's worth of flash work.
+     */
+    need = sizeof(hdr) + 2 * sizeof(tlv) + regs_sz + IMGMGR_HASH_LEN;
+    need += sizeof(tlv) + stack_sz;
+    stats_group_walk(minidump_stats_size, &need);
+    if (need > fa->fa_size) {
         return;
     }
-    if (flash_area_open(MYNEWT_VAL(COREDUMP_FLASH_AREA), &fa)) {
+    if (flash_area_erase(fa, 0, need)) {
         return;
     }
 
-    if (flash_area_read(fa, 0, &hdr, sizeof(hdr))) {
-        return;
-    }
-    if (hdr.ch_magic == COREDUMP_MAGIC) {
-        /*
-         * Don't override corefile.
-         */
-        return;
+    off = sizeof(hdr);
+
+    tlv.ct_type = COREDUMP_TLV_REGS;
+    tlv._pad = 0;
+    tlv.ct_len = regs_sz;
+    tlv.ct_off = 0;
+    dump_core_tlv(fa, &off, &tlv, regs);
+
+    if (imgr_read_info(boot_current_slot, &ver, hash, NULL) == 0) {
+        tlv.ct_type = COREDUMP_TLV_IMAGE;
+        tlv.ct_len = IMGMGR_HASH_LEN;
+        dump_core_tlv(fa, &off, &tlv, hash);
     }
 
-    /* Don't overwrite an image that has any flags set (pending, active, or
-     * confirmed).
-     */
-    slot = flash_area_id_to_image_slot(MYNEWT_VAL(COREDUMP_FLASH_AREA));
-    if (slot != -1) {
-        if (imgmgr_state_slot_in_use(slot)) {
-            return;
-        }
+    if (stack_sz != 0) {
+        tlv.ct_type = COREDUMP_TLV_MEM;
+        tlv.ct_len = stack_sz;
+        tlv.ct_off = stack_start;
+        dump_core_tlv(fa, &off, &tlv, (void *)stack_start);
     }
 
+    msa.fa = fa;
+    msa.off = &off;
+    stats_group_walk(minidump_stats_dump, &msa);
+
+    hdr.ch_magic = COREDUMP_MAGIC;
+    hdr.ch_size = off;
+    flash_area_write(fa, 0, &hdr, sizeof(hdr));
+}
+
+#else /* !MYNEWT_VAL(COREDUMP_MINIDUMP) */
+
+static void
+coredump_full(const struct flash_area *fa, void *regs, int regs_sz)
+{
+    struct coredump_header hdr;
+    struct coredump_tlv tlv;
+    struct image_version ver;
+    const struct hal_bsp_mem_dump *mem, *cur;
+    int area_cnt, i;
+    uint8_t hash[IMGMGR_HASH_LEN];
+    uint32_t off;
+    uint32_t area_off, area_end;
+
     if (flash_area_erase(fa, 0, fa->fa_size)) {
         return;
     }
 
+#if MYNEWT_VAL(COREDUMP_COMPRESS)
+    coredump_comp_state.ccs_fa = fa;
+    coredump_comp_state.ccs_off = sizeof(hdr);
+    coredump_comp_state.ccs_err = 0;
+    lzss_enc_init(&coredump_lzss, coredump_comp_out, &coredump_comp_state);
+#endif
+
     /*
      * First put in data, followed by the header.
      */
@@ -120,8 +300,66 @@ coredump_dump(void *regs, int regs_sz)
             area_off += tlv.ct_len;
         }
     }
+#if MYNEWT_VAL(COREDUMP_COMPRESS)
+    if (lzss_enc_flush(&coredump_lzss) || coredump_comp_state.ccs_err) {
+        /*
+         * Leave the magic unwritten; a truncated corefile must not
+         * look valid.
+         */
+        return;
+    }
+    /*
+     * ch_size is the pre-compression size; the reader decompresses
+     * until it has produced this many bytes.
+     */
+    hdr.ch_magic = COREDUMP_COMP_MAGIC;
+#else
     hdr.ch_magic = COREDUMP_MAGIC;
+#endif
     hdr.ch_size = off;
 
     flash_area_write(fa, 0, &hdr, sizeof(hdr));
 }
+
+#endif /* MYNEWT_VAL(COREDUMP_MINIDUMP) */
+
+void
+coredump_dump(void *regs, int regs_sz)
+{
+    struct coredump_header hdr;
+    const struct flash_area *fa;
+    int slot;
+
+    if (coredump_disabled) {
+        return;
+    }
+    if (flash_area_open(MYNEWT_VAL(COREDUMP_FLASH_AREA), &fa)) {
+        return;
+    }
+
+    if (flash_area_read(fa, 0, &hdr, sizeof(hdr))) {
+        return;
+    }
+    if (hdr.ch_magic == COREDUMP_MAGIC || hdr.ch_magic == COREDUMP_COMP_MAGIC) {
+        /*
+         * Don't override corefile.
+         */
+        return;
+    }
+
+    /* Don't overwrite an image that has any flags set (pending, active, or
+     * confirmed).
+     */
+    slot = flash_area_id_to_image_slot(MYNEWT_VAL(COREDUMP_FLASH_AREA));
+    if (slot != -1) {
+        if (imgmgr_state_slot_in_use(slot)) {
+            return;
+        }
+    }
+
+#if MYNEWT_VAL(COREDUMP_MINIDUMP)
+    coredump_minidump(fa, regs, regs_sz);
+#else
+    coredump_full(fa, regs, regs_sz);
+#endif
+}
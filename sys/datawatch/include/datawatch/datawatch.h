@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _SYS_DATAWATCH_H_
+#define _SYS_DATAWATCH_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Non-halting data watchpoints.  Comparator slots are armed on an
+ * address range; a matching access raises the debug monitor exception,
+ * which records the faulting pc, the running task and the cputime into
+ * the hit table and the os_trace ring and then resumes execution, so
+ * rare cross-task stomps can be caught on a live device.
+ *
+ * Backed by the DWT comparators on Cortex-M parts with a debug
+ * monitor; on other architectures arming returns SYS_ENODEV.
+ */
+
+/* watch loads, stores, or both */
+#define DATAWATCH_ACCESS_READ   0x01
+#define DATAWATCH_ACCESS_WRITE  0x02
+#define DATAWATCH_ACCESS_RW     (DATAWATCH_ACCESS_READ | DATAWATCH_ACCESS_WRITE)
+
+struct datawatch_hit {
+    uint32_t dh_count;      /* hits since the slot was armed */
+    uint32_t dh_pc;         /* pc of the most recent hit */
+    uint32_t dh_cputime;    /* cputime of the most recent hit */
+    uint8_t dh_task_prio;   /* priority of the task that hit */
+};
+
+/** Number of comparator slots the hardware provides. */
+int datawatch_num_slots(void);
+
+/**
+ * Arm a slot on [addr, addr + size); size must be a power of two and
+ * addr aligned to it.  Re-arming an in-use slot resets its hit state.
+ */
+int datawatch_set(int slot, uintptr_t addr, uint32_t size, uint8_t access);
+
+/** Disarm a slot; its hit state remains readable until re-armed. */
+int datawatch_clear(int slot);
+
+/**
+ * Read back a slot's configuration and hit state.  Output pointers may
+ * be NULL.  Returns SYS_EINVAL for an out-of-range slot.
+ */
+int datawatch_get(int slot, uintptr_t *addr, uint32_t *size,
+                  uint8_t *access, struct datawatch_hit *hit);
+
+void datawatch_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SYS_DATAWATCH_H_ */
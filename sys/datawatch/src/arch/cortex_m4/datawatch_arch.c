@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+
+#include "defs/error.h"
+
+#include "datawatch/datawatch.h"
+#include "../../datawatch_priv.h"
+
+/*
+ * ARMv7-M DWT comparators, reported through the debug monitor
+ * exception rather than a halting debug event, so no probe needs to be
+ * attached.  Register layout is architectural (ARMv7-M ARM C1.8).
+ */
+#define DWT_CTRL        (*(volatile uint32_t *)0xe0001000UL)
+#define DWT_COMP(n)     (*(volatile uint32_t *)(0xe0001020UL + (n) * 0x10))
+#define DWT_MASK(n)     (*(volatile uint32_t *)(0xe0001024UL + (n) * 0x10))
+#define DWT_FUNC(n)     (*(volatile uint32_t *)(0xe0001028UL + (n) * 0x10))
+#define SCB_DFSR        (*(volatile uint32_t *)0xe000ed30UL)
+#define SCB_DEMCR       (*(volatile uint32_t *)0xe000edfcUL)
+
+#define DEMCR_TRCENA    (1UL << 24)
+#define DEMCR_MON_EN    (1UL << 16)
+#define DFSR_DWTTRAP    (1UL << 2)
+
+#define DWT_FUNC_MATCHED    (1UL << 24)
+#define DWT_FUNC_WATCH_R    0x5
+#define DWT_FUNC_WATCH_W    0x6
+#define DWT_FUNC_WATCH_RW   0x7
+
+int
+datawatch_arch_num_comp(void)
+{
+    return (DWT_CTRL >> 28) & 0xf;
+}
+
+int
+datawatch_arch_set(int slot, uintptr_t addr, uint32_t mask_bits,
+                   uint8_t access)
+{
+    uint32_t func;
+
+    switch (access) {
+    case DATAWATCH_ACCESS_READ:
+        func = DWT_FUNC_WATCH_R;
+        break;
+    case DATAWATCH_ACCESS_WRITE:
+        func = DWT_FUNC_WATCH_W;
+        break;
+    case DATAWATCH_ACCESS_RW:
+        func = DWT_FUNC_WATCH_RW;
+        break;
+    default:
+        return SYS_EINVAL;
+    }
+
+    SCB_DEMCR |= DEMCR_TRCENA | DEMCR_MON_EN;
+
+    DWT_FUNC(slot) = 0;
+    DWT_COMP(slot) = addr;
+    DWT_MASK(slot) = mask_bits;
+    DWT_FUNC(slot) = func;
+    return 0;
+}
+
+int
+datawatch_arch_clear(int slot)
+{
+    DWT_FUNC(slot) = 0;
+    return 0;
+}
+
+/* r0 points at the stacked exception frame; frame[6] is the pc */
+void
+datawatch_monitor(uint32_t *frame)
+{
+    int num;
+    int i;
+
+    if (!(SCB_DFSR & DFSR_DWTTRAP)) {
+        return;
+    }
+    SCB_DFSR = DFSR_DWTTRAP;    /* write-one-to-clear */
+
+    num = datawatch_arch_num_comp();
+    if (num > DATAWATCH_MAX_SLOTS) {
+        num = DATAWATCH_MAX_SLOTS;
+    }
+    for (i = 0; i < num; i++) {
+        /* MATCHED clears on read */
+        if (DWT_FUNC(i) & DWT_FUNC_MATCHED) {
+            datawatch_hit_record(i, frame[6]);
+        }
+    }
+}
+
+void __attribute__((naked))
+DebugMon_Handler(void)
+{
+    __asm volatile (
+        "tst    lr, #4          \n"
+        "ite    eq              \n"
+        "mrseq  r0, msp         \n"
+        "mrsne  r0, psp         \n"
+        "b      datawatch_monitor\n"
+    );
+}
+
+/* nRF5 SDK startup files name the vector differently */
+void DebugMonitor_Handler(void) __attribute__((alias("DebugMon_Handler")));
@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "os/os_trace.h"
+#include "defs/error.h"
+
+#include "datawatch/datawatch.h"
+#include "datawatch_priv.h"
+
+struct datawatch_slot {
+    uintptr_t dws_addr;
+    uint32_t dws_size;
+    uint8_t dws_access;
+    uint8_t dws_armed;
+    struct datawatch_hit dws_hit;
+};
+
+static struct datawatch_slot datawatch_slots[DATAWATCH_MAX_SLOTS];
+
+/* stubs for architectures without a comparator backend */
+int __attribute__((weak))
+datawatch_arch_num_comp(void)
+{
+    return 0;
+}
+
+int __attribute__((weak))
+datawatch_arch_set(int slot, uintptr_t addr, uint32_t mask_bits,
+                   uint8_t access)
+{
+    return SYS_ENODEV;
+}
+
+int __attribute__((weak))
+datawatch_arch_clear(int slot)
+{
+    return SYS_ENODEV;
+}
+
+int
+datawatch_num_slots(void)
+{
+    int n;
+
+    n = datawatch_arch_num_comp();
+    if (n > DATAWATCH_MAX_SLOTS) {
+        n = DATAWATCH_MAX_SLOTS;
+    }
+    return n;
+}
+
+int
+datawatch_set(int slot, uintptr_t addr, uint32_t size, uint8_t access)
+{
+    struct datawatch_slot *dws;
+    uint32_t mask_bits;
+    int rc;
+
+    if (slot < 0 || slot >= datawatch_num_slots()) {
+        return SYS_EINVAL;
+    }
+    if (size == 0 || (size & (size - 1)) || (addr & (size - 1))) {
+        return SYS_EINVAL;
+    }
+    for (mask_bits = 0; (1UL << mask_bits) < size; mask_bits++) {
+        ;
+    }
+    rc = datawatch_arch_set(slot, addr, mask_bits, access);
+    if (rc) {
+        return rc;
+    }
+    dws = &datawatch_slots[slot];
+    dws->dws_addr = addr;
+    dws->dws_size = size;
+    dws->dws_access = access;
+    dws->dws_armed = 1;
+    memset(&dws->dws_hit, 0, sizeof(dws->dws_hit));
+    return 0;
+}
+
+int
+datawatch_clear(int slot)
+{
+    int rc;
+
+    if (slot < 0 || slot >= datawatch_num_slots()) {
+        return SYS_EINVAL;
+    }
+    rc = datawatch_arch_clear(slot);
+    if (rc) {
+        return rc;
+    }
+    datawatch_slots[slot].dws_armed = 0;
+    return 0;
+}
+
+int
+datawatch_get(int slot, uintptr_t *addr, uint32_t *size, uint8_t *access,
+              struct datawatch_hit *hit)
+{
+    struct datawatch_slot *dws;
+
+    if (slot < 0 || slot >= DATAWATCH_MAX_SLOTS) {
+        return SYS_EINVAL;
+    }
+    dws = &datawatch_slots[slot];
+    if (addr) {
+        *addr = dws->dws_addr;
+    }
+    if (size) {
+        *size = dws->dws_size;
+    }
+    if (access) {
+        *access = dws->dws_armed ? dws->dws_access : 0;
+    }
+    if (hit) {
+        *hit = dws->dws_hit;
+    }
+    return 0;
+}
+
+/*
+ * Runs in the debug monitor exception, above every task and most ISRs;
+ * touches only the hit table and the trace ring and returns, after
+ * which the interrupted instruction stream continues.
+ */
+void
+datawatch_hit_record(int slot, uint32_t pc)
+{
+    struct datawatch_slot *dws;
+    struct os_task *t;
+    uint8_t prio;
+
+    if (slot < 0 || slot >= DATAWATCH_MAX_SLOTS) {
+        return;
+    }
+    t = os_sched_get_current_task();
+    prio = t ? t->t_prio : 0xff;
+
+    dws = &datawatch_slots[slot];
+    dws->dws_hit.dh_count++;
+    dws->dws_hit.dh_pc = pc;
+    dws->dws_hit.dh_cputime = os_cputime_get32();
+    dws->dws_hit.dh_task_prio = prio;
+
+    OS_TRACE_EVENT(OS_TRACE_ID_DATAWATCH, ((uint32_t)slot << 8) | prio);
+}
+
+void
+datawatch_init(void)
+{
+#if MYNEWT_VAL(DATAWATCH_CLI)
+    datawatch_cli_init();
+#endif
+}
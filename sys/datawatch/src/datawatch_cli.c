@@ -0,0 +1,130 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(DATAWATCH_CLI)
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <shell/shell.h>
+#include <console/console.h>
+
+#include "datawatch/datawatch.h"
+#include "datawatch_priv.h"
+
+static int datawatch_cli_cmd(int argc, char **argv);
+
+static struct shell_cmd datawatch_cli_struct = {
+    .sc_cmd = "dwatch",
+    .sc_cmd_func = datawatch_cli_cmd
+};
+
+static const char *
+datawatch_cli_access_str(uint8_t access)
+{
+    switch (access) {
+    case DATAWATCH_ACCESS_READ:
+        return "r";
+    case DATAWATCH_ACCESS_WRITE:
+        return "w";
+    case DATAWATCH_ACCESS_RW:
+        return "rw";
+    default:
+        return "-";
+    }
+}
+
+static void
+datawatch_cli_list(void)
+{
+    struct datawatch_hit hit;
+    uintptr_t addr;
+    uint32_t size;
+    uint8_t access;
+    int num;
+    int i;
+
+    num = datawatch_num_slots();
+    if (num == 0) {
+        console_printf("no comparators on this target\n");
+        return;
+    }
+    console_printf("slot  addr       size acc     hits last-pc    prio  cputime\n");
+    for (i = 0; i < num; i++) {
+        datawatch_get(i, &addr, &size, &access, &hit);
+        console_printf("%4d 0x%08lx %5lu %3s %8lu 0x%08lx %5u %8lu\n",
+          i, (unsigned long)addr, (unsigned long)size,
+          datawatch_cli_access_str(access), (unsigned long)hit.dh_count,
+          (unsigned long)hit.dh_pc, hit.dh_task_prio,
+          (unsigned long)hit.dh_cputime);
+    }
+}
+
+static int
+datawatch_cli_cmd(int argc, char **argv)
+{
+    uintptr_t addr;
+    uint32_t size;
+    uint8_t access;
+    int slot;
+    int rc;
+
+    if (argc < 2) {
+        datawatch_cli_list();
+        return 0;
+    }
+    if (!strcmp(argv[1], "set") && argc >= 5) {
+        slot = (int)strtoul(argv[2], NULL, 0);
+        addr = (uintptr_t)strtoul(argv[3], NULL, 0);
+        size = (uint32_t)strtoul(argv[4], NULL, 0);
+        access = DATAWATCH_ACCESS_WRITE;
+        if (argc > 5) {
+            if (!strcmp(argv[5], "r")) {
+                access = DATAWATCH_ACCESS_READ;
+            } else if (!strcmp(argv[5], "rw")) {
+                access = DATAWATCH_ACCESS_RW;
+            }
+        }
+        rc = datawatch_set(slot, addr, size, access);
+        if (rc) {
+            console_printf("arm failed: %d\n", rc);
+        }
+    } else if (!strcmp(argv[1], "clear") && argc >= 3) {
+        slot = (int)strtoul(argv[2], NULL, 0);
+        rc = datawatch_clear(slot);
+        if (rc) {
+            console_printf("clear failed: %d\n", rc);
+        }
+    } else {
+        console_printf("dwatch [set <slot> <addr> <pow2-size> [r|w|rw]] "
+                       "[clear <slot>]\n");
+    }
+    return 0;
+}
+
+void
+datawatch_cli_init(void)
+{
+    shell_cmd_register(&datawatch_cli_struct);
+}
+
+#endif /* MYNEWT_VAL(DATAWATCH_CLI) */
@@ -0,0 +1,50 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _DATAWATCH_PRIV_H_
+#define _DATAWATCH_PRIV_H_
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* comparator slots tracked; hardware may expose fewer */
+#define DATAWATCH_MAX_SLOTS     4
+
+/*
+ * Architecture backend.  Weak no-op defaults in datawatch.c report
+ * zero comparators; the cortex_m4 backend overrides them with the DWT.
+ */
+int datawatch_arch_num_comp(void);
+int datawatch_arch_set(int slot, uintptr_t addr, uint32_t mask_bits,
+                       uint8_t access);
+int datawatch_arch_clear(int slot);
+
+/* called from the debug monitor exception on a comparator match */
+void datawatch_hit_record(int slot, uint32_t pc);
+
+void datawatch_cli_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DATAWATCH_PRIV_H_ */
@@ -76,6 +76,34 @@ int flash_area_write(const struct flash_area *, uint32_t off, const void *src,
   uint32_t len);
 int flash_area_erase(const struct flash_area *, uint32_t off, uint32_t len);
 
+/*
+ * One fragment of a vectored read or write.
+ */
+struct flash_area_iovec {
+    void *fai_base;
+    uint32_t fai_len;
+};
+
+/*
+ * Vectored read/write covering the contiguous flash range starting at
+ * 'off'; fragment i follows fragment i-1 in flash.  Adjacent small
+ * fragments are coalesced through a bounce buffer into as few hardware
+ * operations as write alignment allows, so e.g. an fcb header+data
+ * pair costs one driver call instead of two.
+ */
+int flash_area_readv(const struct flash_area *, uint32_t off,
+  const struct flash_area_iovec *iov, int iovcnt);
+int flash_area_writev(const struct flash_area *, uint32_t off,
+  const struct flash_area_iovec *iov, int iovcnt);
+
+/*
+ * Queue an erase on the asynchronous flash worker (HAL_FLASH_ASYNC)
+ * and return without waiting for it; falls back to a synchronous
+ * erase when the worker is not compiled in.
+ */
+int flash_area_erase_async(const struct flash_area *, uint32_t off,
+  uint32_t len);
+
 /*
  * Alignment restriction for flash writes.
  */
@@ -30,10 +30,82 @@
 #include "hal/hal_flash_int.h"
 #include "mfg/mfg.h"
 #include "flash_map/flash_map.h"
+#if MYNEWT_VAL(HAL_FLASH_ASYNC)
+#include "hal/hal_flash_async.h"
+#endif
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+#include <stdio.h>
+#include "os/os_cputime.h"
+#include "stats/stats.h"
+#endif
 
 const struct flash_area *flash_map;
 int flash_map_entries;
 
+/* Bounce buffer used to coalesce vectored operations */
+#define FLASH_AREA_VEC_BUF_SZ   64
+
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+STATS_SECT_START(flash_area_stats)
+    STATS_SECT_ENTRY(reads)
+    STATS_SECT_ENTRY(writes)
+    STATS_SECT_ENTRY(erases)
+    STATS_SECT_ENTRY(read_ticks)
+    STATS_SECT_ENTRY(write_ticks)
+    STATS_SECT_ENTRY(erase_ticks)
+STATS_SECT_END
+
+STATS_NAME_START(flash_area_stats)
+    STATS_NAME(flash_area_stats, reads)
+    STATS_NAME(flash_area_stats, writes)
+    STATS_NAME(flash_area_stats, erases)
+    STATS_NAME(flash_area_stats, read_ticks)
+    STATS_NAME(flash_area_stats, write_ticks)
+    STATS_NAME(flash_area_stats, erase_ticks)
+STATS_NAME_END(flash_area_stats)
+
+static STATS_SECT_DECL(flash_area_stats)
+    flash_area_stats[MYNEWT_VAL(FLASH_MAP_MAX_AREAS)];
+static char flash_area_stats_names[MYNEWT_VAL(FLASH_MAP_MAX_AREAS)][8];
+
+/*
+ * Map an area back to its stats group; areas live in the flash_map
+ * array, so the index is recovered from the pointer.
+ */
+static STATS_SECT_DECL(flash_area_stats) *
+flash_area_stats_get(const struct flash_area *fa)
+{
+    int idx;
+
+    idx = fa - flash_map;
+    if (idx < 0 || idx >= flash_map_entries ||
+        idx >= MYNEWT_VAL(FLASH_MAP_MAX_AREAS)) {
+        return NULL;
+    }
+    return &flash_area_stats[idx];
+}
+
+static void
+flash_area_stats_reg(void)
+{
+    int cnt;
+    int i;
+
+    cnt = flash_map_entries;
+    if (cnt > MYNEWT_VAL(FLASH_MAP_MAX_AREAS)) {
+        cnt = MYNEWT_VAL(FLASH_MAP_MAX_AREAS);
+    }
+    for (i = 0; i < cnt; i++) {
+        snprintf(flash_area_stats_names[i],
+          sizeof(flash_area_stats_names[i]), "fa%u", flash_map[i].fa_id);
+        stats_init_and_reg(STATS_HDR(flash_area_stats[i]),
+          STATS_SIZE_INIT_PARMS(flash_area_stats[i], STATS_SIZE_32),
+          STATS_NAME_INIT_PARMS(flash_area_stats),
+          flash_area_stats_names[i]);
+    }
+}
+#endif
+
 int
 flash_area_open(uint8_t id, const struct flash_area **fap)
 {
@@ -99,30 +171,255 @@ int
 flash_area_read(const struct flash_area *fa, uint32_t off, void *dst,
     uint32_t len)
 {
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    STATS_SECT_DECL(flash_area_stats) *st;
+    uint32_t ticks;
+#endif
+    int rc;
+
     if (off > fa->fa_size || off + len > fa->fa_size) {
         return -1;
     }
-    return hal_flash_read(fa->fa_device_id, fa->fa_off + off, dst, len);
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    ticks = os_cputime_get32();
+#endif
+    rc = hal_flash_read(fa->fa_device_id, fa->fa_off + off, dst, len);
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    st = flash_area_stats_get(fa);
+    if (st) {
+        STATS_INC(*st, reads);
+        STATS_INCN(*st, read_ticks, os_cputime_get32() - ticks);
+    }
+#endif
+    return rc;
 }
 
 int
 flash_area_write(const struct flash_area *fa, uint32_t off, const void *src,
     uint32_t len)
 {
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    STATS_SECT_DECL(flash_area_stats) *st;
+    uint32_t ticks;
+#endif
+    int rc;
+
     if (off > fa->fa_size || off + len > fa->fa_size) {
         return -1;
     }
-    return hal_flash_write(fa->fa_device_id, fa->fa_off + off,
-                           (void *)src, len);
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    ticks = os_cputime_get32();
+#endif
+    rc = hal_flash_write(fa->fa_device_id, fa->fa_off + off,
+                         (void *)src, len);
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    st = flash_area_stats_get(fa);
+    if (st) {
+        STATS_INC(*st, writes);
+        STATS_INCN(*st, write_ticks, os_cputime_get32() - ticks);
+    }
+#endif
+    return rc;
 }
 
 int
 flash_area_erase(const struct flash_area *fa, uint32_t off, uint32_t len)
 {
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    STATS_SECT_DECL(flash_area_stats) *st;
+    uint32_t ticks;
+#endif
+    int rc;
+
     if (off > fa->fa_size || off + len > fa->fa_size) {
         return -1;
     }
-    return hal_flash_erase(fa->fa_device_id, fa->fa_off + off, len);
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    ticks = os_cputime_get32();
+#endif
+    rc = hal_flash_erase(fa->fa_device_id, fa->fa_off + off, len);
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    st = flash_area_stats_get(fa);
+    if (st) {
+        STATS_INC(*st, erases);
+        STATS_INCN(*st, erase_ticks, os_cputime_get32() - ticks);
+    }
+#endif
+    return rc;
+}
+
+int
+flash_area_readv(const struct flash_area *fa, uint32_t off,
+    const struct flash_area_iovec *iov, int iovcnt)
+{
+    uint8_t buf[FLASH_AREA_VEC_BUF_SZ];
+    uint32_t total;
+    uint32_t chunk;
+    uint32_t fill;
+    uint32_t win_off;
+    uint32_t win_len;
+    uint32_t rem;
+    uint32_t len;
+    uint8_t *dst;
+    int rc;
+    int i;
+
+    total = 0;
+    for (i = 0; i < iovcnt; i++) {
+        total += iov[i].fai_len;
+    }
+    if (off > fa->fa_size || off + total > fa->fa_size) {
+        return -1;
+    }
+
+    /*
+     * Serve small fragments from a bounce window filled with one read
+     * per FLASH_AREA_VEC_BUF_SZ bytes; fragments at least a window
+     * long are read straight into place.
+     */
+    rem = total;
+    win_off = 0;
+    win_len = 0;
+    for (i = 0; i < iovcnt; i++) {
+        dst = iov[i].fai_base;
+        len = iov[i].fai_len;
+        while (len > 0) {
+            if (win_len == 0) {
+                if (len >= sizeof(buf)) {
+                    rc = flash_area_read(fa, off, dst, len);
+                    if (rc != 0) {
+                        return rc;
+                    }
+                    off += len;
+                    rem -= len;
+                    len = 0;
+                    continue;
+                }
+                fill = rem;
+                if (fill > sizeof(buf)) {
+                    fill = sizeof(buf);
+                }
+                rc = flash_area_read(fa, off, buf, fill);
+                if (rc != 0) {
+                    return rc;
+                }
+                win_off = 0;
+                win_len = fill;
+                off += fill;
+                rem -= fill;
+            }
+            chunk = win_len;
+            if (chunk > len) {
+                chunk = len;
+            }
+            memcpy(dst, buf + win_off, chunk);
+            win_off += chunk;
+            win_len -= chunk;
+            dst += chunk;
+            len -= chunk;
+        }
+    }
+    return 0;
+}
+
+int
+flash_area_writev(const struct flash_area *fa, uint32_t off,
+    const struct flash_area_iovec *iov, int iovcnt)
+{
+    uint8_t buf[FLASH_AREA_VEC_BUF_SZ];
+    uint32_t buffered;
+    uint32_t total;
+    uint32_t chunk;
+    uint32_t len;
+    uint8_t align;
+    const uint8_t *src;
+    int rc;
+    int i;
+
+    total = 0;
+    for (i = 0; i < iovcnt; i++) {
+        total += iov[i].fai_len;
+    }
+    if (off > fa->fa_size || off + total > fa->fa_size) {
+        return -1;
+    }
+
+    align = flash_area_align(fa);
+
+    /*
+     * Adjacent fragments accumulate in the bounce buffer and are
+     * flushed in buffer-sized (hence aligned) chunks; a fragment at
+     * least a buffer long is written straight from the caller's
+     * memory, up to its last alignment boundary.
+     */
+    buffered = 0;
+    for (i = 0; i < iovcnt; i++) {
+        src = iov[i].fai_base;
+        len = iov[i].fai_len;
+        while (len > 0) {
+            if (buffered == 0 && len >= sizeof(buf)) {
+                chunk = len - (len & (align - 1));
+                rc = flash_area_write(fa, off, src, chunk);
+                if (rc != 0) {
+                    return rc;
+                }
+                off += chunk;
+                src += chunk;
+                len -= chunk;
+                continue;
+            }
+            chunk = sizeof(buf) - buffered;
+            if (chunk > len) {
+                chunk = len;
+            }
+            memcpy(buf + buffered, src, chunk);
+            buffered += chunk;
+            src += chunk;
+            len -= chunk;
+            if (buffered == sizeof(buf)) {
+                rc = flash_area_write(fa, off, buf, buffered);
+                if (rc != 0) {
+                    return rc;
+                }
+                off += buffered;
+                buffered = 0;
+            }
+        }
+    }
+    if (buffered > 0) {
+        /* The tail carries whatever (mis)alignment the caller's total
+         * had; the driver applies the same rules as a direct write. */
+        rc = flash_area_write(fa, off, buf, buffered);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+int
+flash_area_erase_async(const struct flash_area *fa, uint32_t off,
+    uint32_t len)
+{
+#if MYNEWT_VAL(HAL_FLASH_ASYNC)
+    if (off > fa->fa_size || off + len > fa->fa_size) {
+        return -1;
+    }
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    {
+        STATS_SECT_DECL(flash_area_stats) *st;
+
+        st = flash_area_stats_get(fa);
+        if (st) {
+            STATS_INC(*st, erases);
+        }
+    }
+#endif
+    return hal_flash_async_erase(fa->fa_device_id, fa->fa_off + off, len,
+                                 NULL, NULL);
+#else
+    return flash_area_erase(fa, off, len);
+#endif
 }
 
 uint8_t
@@ -265,4 +562,8 @@ flash_map_init(void)
         flash_map = mfg_areas;
         flash_map_entries = num_areas;
     }
+
+#if MYNEWT_VAL(FLASH_MAP_STATS)
+    flash_area_stats_reg();
+#endif
 }
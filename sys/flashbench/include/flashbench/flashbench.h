@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __SYS_FLASHBENCH_H__
+#define __SYS_FLASHBENCH_H__
+
+#include <inttypes.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Flash I/O latency and wear telemetry.
+ *
+ * Hooks the hal_flash observer (HAL_FLASH_OBSERVE) and sorts every
+ * read, write and sector erase into per-flash-area latency buckets in
+ * the "flashbench_fa<id>" stats groups.  Sector erase counts of the
+ * tracked flash device are accumulated in RAM and can be persisted in
+ * a reserved FCB so cumulative wear survives reboots.  Standardized
+ * read/write/erase sweeps are available programmatically and, with
+ * FLASHBENCH_CLI, via the "flashbench" shell command.
+ */
+
+/** Latency summary for one operation type of a sweep. */
+struct flashbench_lat {
+    uint32_t fl_count;
+    uint32_t fl_min_us;
+    uint32_t fl_max_us;
+    uint32_t fl_total_us;
+};
+
+/** Result of a flashbench_sweep() run. */
+struct flashbench_sweep_result {
+    struct flashbench_lat fsr_erase;
+    struct flashbench_lat fsr_write;
+    struct flashbench_lat fsr_read;
+};
+
+/* Chunk size sweeps read and write at a time. */
+#define FLASHBENCH_SWEEP_CHUNK      256
+
+void flashbench_init(void);
+
+/**
+ * Runs a standardized sweep over the specified flash map area: every
+ * sector is erased, then the whole area is written and read back in
+ * FLASHBENCH_SWEEP_CHUNK-byte chunks, each operation timed
+ * individually.  DESTRUCTIVE: the area's previous contents are lost.
+ *
+ * @param area_id               Flash map identifier of the area to sweep.
+ * @param res                   On success, filled with the latency
+ *                                  summaries.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int flashbench_sweep(int area_id, struct flashbench_sweep_result *res);
+
+/** Returns the number of wear-counted sectors. */
+int flashbench_wear_sector_cnt(void);
+
+/** Returns the cumulative erase count of the specified sector. */
+uint32_t flashbench_wear_get(int sector);
+
+/**
+ * Persists the wear counters to the reserved FCB.  Returns 0 on
+ * success; nonzero on failure or if no FCB area is configured.
+ */
+int flashbench_wear_save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SYS_FLASHBENCH_H__ */
@@ -0,0 +1,527 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "hal/hal_bsp.h"
+#include "hal/hal_flash.h"
+#include "hal/hal_flash_int.h"
+#include "flash_map/flash_map.h"
+#include "stats/stats.h"
+#include "fcb/fcb.h"
+
+#include "flashbench/flashbench.h"
+#include "flashbench_priv.h"
+
+/*
+ * Latency histograms, one stats group per monitored flash map area.
+ * Reads and writes bucket at 100us/1ms/10ms; erases, being orders of
+ * magnitude slower, at 10ms/100ms.
+ */
+STATS_SECT_START(flashbench_stats)
+    STATS_SECT_ENTRY(read_u100us)
+    STATS_SECT_ENTRY(read_u1ms)
+    STATS_SECT_ENTRY(read_u10ms)
+    STATS_SECT_ENTRY(read_o10ms)
+    STATS_SECT_ENTRY(read_max_us)
+    STATS_SECT_ENTRY(write_u100us)
+    STATS_SECT_ENTRY(write_u1ms)
+    STATS_SECT_ENTRY(write_u10ms)
+    STATS_SECT_ENTRY(write_o10ms)
+    STATS_SECT_ENTRY(write_max_us)
+    STATS_SECT_ENTRY(erase_u10ms)
+    STATS_SECT_ENTRY(erase_u100ms)
+    STATS_SECT_ENTRY(erase_o100ms)
+    STATS_SECT_ENTRY(erase_max_us)
+    STATS_SECT_ENTRY(errs)
+STATS_SECT_END
+
+STATS_NAME_START(flashbench_stats)
+    STATS_NAME(flashbench_stats, read_u100us)
+    STATS_NAME(flashbench_stats, read_u1ms)
+    STATS_NAME(flashbench_stats, read_u10ms)
+    STATS_NAME(flashbench_stats, read_o10ms)
+    STATS_NAME(flashbench_stats, read_max_us)
+    STATS_NAME(flashbench_stats, write_u100us)
+    STATS_NAME(flashbench_stats, write_u1ms)
+    STATS_NAME(flashbench_stats, write_u10ms)
+    STATS_NAME(flashbench_stats, write_o10ms)
+    STATS_NAME(flashbench_stats, write_max_us)
+    STATS_NAME(flashbench_stats, erase_u10ms)
+    STATS_NAME(flashbench_stats, erase_u100ms)
+    STATS_NAME(flashbench_stats, erase_o100ms)
+    STATS_NAME(flashbench_stats, erase_max_us)
+    STATS_NAME(flashbench_stats, errs)
+STATS_NAME_END(flashbench_stats)
+
+static STATS_SECT_DECL(flashbench_stats)
+    flashbench_area_stats[MYNEWT_VAL(FLASHBENCH_MAX_AREAS)];
+static char flashbench_area_names[MYNEWT_VAL(FLASHBENCH_MAX_AREAS)][16];
+static int flashbench_num_areas;
+
+/* Cumulative sector erase counters of the tracked flash device. */
+static uint32_t flashbench_wear[MYNEWT_VAL(FLASHBENCH_WEAR_MAX_SECTORS)];
+static int flashbench_wear_sectors;
+
+#if MYNEWT_VAL(FLASHBENCH_WEAR_FCB_FLASH_AREA) >= 0
+#define FLASHBENCH_FCB_MAGIC        0x46424e43  /* "FBNC" */
+#define FLASHBENCH_FCB_MAX_SECTORS  8
+
+static struct fcb flashbench_fcb;
+static struct flash_area
+    flashbench_fcb_sectors[FLASHBENCH_FCB_MAX_SECTORS];
+static uint8_t flashbench_fcb_ok;
+
+/* Nonzero while a save is writing; its own flash traffic must not
+ * retrigger another save.
+ */
+static uint8_t flashbench_wear_saving;
+
+#if MYNEWT_VAL(FLASHBENCH_WEAR_SAVE_ITVL)
+static uint32_t flashbench_wear_unsaved;
+
+static void flashbench_save_ev_cb(struct os_event *ev);
+
+static struct os_event flashbench_save_ev = {
+    .ev_cb = flashbench_save_ev_cb,
+};
+#endif
+#endif
+
+/**
+ * Maps a flash operation back to the flash map area it touched, or NULL
+ * if the address falls outside the monitored areas.
+ */
+static STATS_SECT_DECL(flashbench_stats) *
+flashbench_area_find(uint8_t flash_id, uint32_t address)
+{
+    const struct flash_area *fa;
+    int i;
+
+    for (i = 0; i < flashbench_num_areas; i++) {
+        fa = &flash_map[i];
+        if (fa->fa_device_id == flash_id && address >= fa->fa_off &&
+            address < fa->fa_off + fa->fa_size) {
+
+            return &flashbench_area_stats[i];
+        }
+    }
+    return NULL;
+}
+
+static void
+flashbench_bucket(STATS_SECT_DECL(flashbench_stats) *st, int op,
+                  uint32_t usecs)
+{
+    switch (op) {
+    case HAL_FLASH_OP_READ:
+        if (usecs < 100) {
+            STATS_INC(*st, read_u100us);
+        } else if (usecs < 1000) {
+            STATS_INC(*st, read_u1ms);
+        } else if (usecs < 10000) {
+            STATS_INC(*st, read_u10ms);
+        } else {
+            STATS_INC(*st, read_o10ms);
+        }
+        if (usecs > st->STATS_SECT_VAR(read_max_us)) {
+            st->STATS_SECT_VAR(read_max_us) = usecs;
+        }
+        break;
+    case HAL_FLASH_OP_WRITE:
+        if (usecs < 100) {
+            STATS_INC(*st, write_u100us);
+        } else if (usecs < 1000) {
+            STATS_INC(*st, write_u1ms);
+        } else if (usecs < 10000) {
+            STATS_INC(*st, write_u10ms);
+        } else {
+            STATS_INC(*st, write_o10ms);
+        }
+        if (usecs > st->STATS_SECT_VAR(write_max_us)) {
+            st->STATS_SECT_VAR(write_max_us) = usecs;
+        }
+        break;
+    case HAL_FLASH_OP_ERASE:
+        if (usecs < 10000) {
+            STATS_INC(*st, erase_u10ms);
+        } else if (usecs < 100000) {
+            STATS_INC(*st, erase_u100ms);
+        } else {
+            STATS_INC(*st, erase_o100ms);
+        }
+        if (usecs > st->STATS_SECT_VAR(erase_max_us)) {
+            st->STATS_SECT_VAR(erase_max_us) = usecs;
+        }
+        break;
+    }
+}
+
+/**
+ * Returns the sector index of the tracked flash device containing the
+ * specified address, or -1 if it lies beyond the wear-counted range.
+ */
+static int
+flashbench_sector_for(uint32_t address)
+{
+    const struct hal_flash *hf;
+    uint32_t start;
+    uint32_t size;
+    int i;
+
+    hf = hal_bsp_flash_dev(MYNEWT_VAL(FLASHBENCH_WEAR_FLASH_ID));
+    if (!hf) {
+        return -1;
+    }
+    for (i = 0; i < flashbench_wear_sectors; i++) {
+        if (hf->hf_itf->hff_sector_info(i, &start, &size)) {
+            return -1;
+        }
+        if (address >= start && address < start + size) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void
+flashbench_wear_erase(uint32_t address)
+{
+    int sector;
+
+    sector = flashbench_sector_for(address);
+    if (sector < 0) {
+        return;
+    }
+    flashbench_wear[sector]++;
+
+#if MYNEWT_VAL(FLASHBENCH_WEAR_FCB_FLASH_AREA) >= 0 && \
+    MYNEWT_VAL(FLASHBENCH_WEAR_SAVE_ITVL)
+    if (!flashbench_wear_saving) {
+        flashbench_wear_unsaved++;
+        if (flashbench_wear_unsaved >= MYNEWT_VAL(FLASHBENCH_WEAR_SAVE_ITVL)) {
+            flashbench_wear_unsaved = 0;
+            /* Persist from the default event queue; the flash caller
+             * may not tolerate the extra write latency here.
+             */
+            os_eventq_put(os_eventq_dflt_get(), &flashbench_save_ev);
+        }
+    }
+#endif
+}
+
+static void
+flashbench_obs(uint8_t flash_id, int op, uint32_t address, uint32_t num_bytes,
+               uint32_t ticks, int rc, void *arg)
+{
+    STATS_SECT_DECL(flashbench_stats) *st;
+
+    st = flashbench_area_find(flash_id, address);
+    if (st) {
+        if (rc != 0) {
+            STATS_INC(*st, errs);
+        } else {
+            flashbench_bucket(st, op, os_cputime_ticks_to_usecs(ticks));
+        }
+    }
+
+    if (op == HAL_FLASH_OP_ERASE && rc == 0 &&
+        flash_id == MYNEWT_VAL(FLASHBENCH_WEAR_FLASH_ID)) {
+
+        flashbench_wear_erase(address);
+    }
+}
+
+int
+flashbench_wear_sector_cnt(void)
+{
+    return flashbench_wear_sectors;
+}
+
+uint32_t
+flashbench_wear_get(int sector)
+{
+    if (sector < 0 || sector >= flashbench_wear_sectors) {
+        return 0;
+    }
+    return flashbench_wear[sector];
+}
+
+#if MYNEWT_VAL(FLASHBENCH_WEAR_FCB_FLASH_AREA) >= 0
+/**
+ * Restores the wear counters from the newest FCB element.  Older
+ * elements are skipped; only the last snapshot matters.
+ */
+static void
+flashbench_wear_load(void)
+{
+    struct fcb_entry loc;
+    struct fcb_entry last;
+    uint32_t len;
+    int found;
+
+    memset(&loc, 0, sizeof loc);
+    found = 0;
+    while (fcb_getnext(&flashbench_fcb, &loc) == 0) {
+        last = loc;
+        found = 1;
+    }
+    if (!found) {
+        return;
+    }
+
+    len = last.fe_data_len;
+    if (len > sizeof flashbench_wear) {
+        len = sizeof flashbench_wear;
+    }
+    flash_area_read(last.fe_area, last.fe_data_off, flashbench_wear, len);
+}
+
+int
+flashbench_wear_save(void)
+{
+    struct fcb_entry loc;
+    uint16_t len;
+    int rc;
+
+    if (!flashbench_fcb_ok) {
+        return -1;
+    }
+
+    len = flashbench_wear_sectors * sizeof(uint32_t);
+
+    flashbench_wear_saving = 1;
+    rc = fcb_append(&flashbench_fcb, len, &loc);
+    if (rc == FCB_ERR_NOSPACE) {
+        rc = fcb_rotate(&flashbench_fcb);
+        if (rc == 0) {
+            rc = fcb_append(&flashbench_fcb, len, &loc);
+        }
+    }
+    if (rc == 0) {
+        rc = flash_area_write(loc.fe_area, loc.fe_data_off, flashbench_wear,
+                              len);
+    }
+    if (rc == 0) {
+        rc = fcb_append_finish(&flashbench_fcb, &loc);
+    }
+    flashbench_wear_saving = 0;
+
+    return rc;
+}
+
+#if MYNEWT_VAL(FLASHBENCH_WEAR_SAVE_ITVL)
+static void
+flashbench_save_ev_cb(struct os_event *ev)
+{
+    flashbench_wear_save();
+}
+#endif
+
+static void
+flashbench_fcb_setup(void)
+{
+    int cnt;
+    int rc;
+
+    /* Two passes: size check first, flash_area_to_sectors() does not
+     * honor a capacity limit.
+     */
+    rc = flash_area_to_sectors(MYNEWT_VAL(FLASHBENCH_WEAR_FCB_FLASH_AREA),
+                               &cnt, NULL);
+    if (rc != 0 || cnt == 0 || cnt > FLASHBENCH_FCB_MAX_SECTORS) {
+        return;
+    }
+    rc = flash_area_to_sectors(MYNEWT_VAL(FLASHBENCH_WEAR_FCB_FLASH_AREA),
+                               &cnt, flashbench_fcb_sectors);
+    if (rc != 0) {
+        return;
+    }
+
+    flashbench_fcb.f_magic = FLASHBENCH_FCB_MAGIC;
+    flashbench_fcb.f_version = 0;
+    flashbench_fcb.f_sector_cnt = cnt;
+    flashbench_fcb.f_scratch_cnt = 0;
+    flashbench_fcb.f_sectors = flashbench_fcb_sectors;
+    rc = fcb_init(&flashbench_fcb);
+    if (rc == FCB_ERR_MAGIC) {
+        /* First boot with this area; start it fresh. */
+        rc = fcb_clear(&flashbench_fcb);
+    }
+    if (rc != 0) {
+        return;
+    }
+
+    flashbench_fcb_ok = 1;
+    flashbench_wear_load();
+}
+#else
+int
+flashbench_wear_save(void)
+{
+    return -1;
+}
+#endif
+
+void
+flashbench_init(void)
+{
+    const struct hal_flash *hf;
+    int cnt;
+    int i;
+    int rc;
+
+    cnt = flash_map_entries;
+    if (cnt > MYNEWT_VAL(FLASHBENCH_MAX_AREAS)) {
+        cnt = MYNEWT_VAL(FLASHBENCH_MAX_AREAS);
+    }
+    for (i = 0; i < cnt; i++) {
+        snprintf(flashbench_area_names[i],
+          sizeof(flashbench_area_names[i]), "flashbench_fa%u",
+          flash_map[i].fa_id);
+        rc = stats_init_and_reg(STATS_HDR(flashbench_area_stats[i]),
+          STATS_SIZE_INIT_PARMS(flashbench_area_stats[i], STATS_SIZE_32),
+          STATS_NAME_INIT_PARMS(flashbench_stats),
+          flashbench_area_names[i]);
+        SYSINIT_PANIC_ASSERT(rc == 0);
+    }
+    flashbench_num_areas = cnt;
+
+    hf = hal_bsp_flash_dev(MYNEWT_VAL(FLASHBENCH_WEAR_FLASH_ID));
+    if (hf) {
+        flashbench_wear_sectors = hf->hf_sector_cnt;
+        if (flashbench_wear_sectors >
+            MYNEWT_VAL(FLASHBENCH_WEAR_MAX_SECTORS)) {
+
+            flashbench_wear_sectors = MYNEWT_VAL(FLASHBENCH_WEAR_MAX_SECTORS);
+        }
+    }
+
+#if MYNEWT_VAL(FLASHBENCH_WEAR_FCB_FLASH_AREA) >= 0
+    flashbench_fcb_setup();
+#endif
+
+    rc = hal_flash_obs_register(flashbench_obs, NULL);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+#if MYNEWT_VAL(FLASHBENCH_CLI)
+    rc = flashbench_cli_register();
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+}
+
+static void
+flashbench_lat_add(struct flashbench_lat *fl, uint32_t usecs)
+{
+    if (fl->fl_count == 0 || usecs < fl->fl_min_us) {
+        fl->fl_min_us = usecs;
+    }
+    if (usecs > fl->fl_max_us) {
+        fl->fl_max_us = usecs;
+    }
+    fl->fl_total_us += usecs;
+    fl->fl_count++;
+}
+
+int
+flashbench_sweep(int area_id, struct flashbench_sweep_result *res)
+{
+    static uint8_t buf[FLASHBENCH_SWEEP_CHUNK];
+    const struct flash_area *fa;
+    const struct hal_flash *hf;
+    uint32_t start;
+    uint32_t size;
+    uint32_t t0;
+    uint32_t off;
+    uint32_t blk;
+    int rc;
+    int i;
+
+    memset(res, 0, sizeof *res);
+
+    rc = flash_area_open(area_id, &fa);
+    if (rc != 0) {
+        return rc;
+    }
+    hf = hal_bsp_flash_dev(fa->fa_device_id);
+    if (!hf) {
+        return -1;
+    }
+
+    /* Pass 1: erase every sector of the area individually. */
+    for (i = 0; i < hf->hf_sector_cnt; i++) {
+        if (hf->hf_itf->hff_sector_info(i, &start, &size)) {
+            return -1;
+        }
+        if (start < fa->fa_off || start >= fa->fa_off + fa->fa_size) {
+            continue;
+        }
+        t0 = os_cputime_get32();
+        rc = hal_flash_erase_sector(fa->fa_device_id, start);
+        if (rc != 0) {
+            return rc;
+        }
+        flashbench_lat_add(&res->fsr_erase,
+                           os_cputime_ticks_to_usecs(os_cputime_get32() -
+                                                     t0));
+    }
+
+    /* Pass 2: write the whole area in chunks. */
+    for (i = 0; i < sizeof buf; i++) {
+        buf[i] = i;
+    }
+    for (off = 0; off < fa->fa_size; off += blk) {
+        blk = fa->fa_size - off;
+        if (blk > sizeof buf) {
+            blk = sizeof buf;
+        }
+        t0 = os_cputime_get32();
+        rc = flash_area_write(fa, off, buf, blk);
+        if (rc != 0) {
+            return rc;
+        }
+        flashbench_lat_add(&res->fsr_write,
+                           os_cputime_ticks_to_usecs(os_cputime_get32() -
+                                                     t0));
+    }
+
+    /* Pass 3: read it all back. */
+    for (off = 0; off < fa->fa_size; off += blk) {
+        blk = fa->fa_size - off;
+        if (blk > sizeof buf) {
+            blk = sizeof buf;
+        }
+        t0 = os_cputime_get32();
+        rc = flash_area_read(fa, off, buf, blk);
+        if (rc != 0) {
+            return rc;
+        }
+        flashbench_lat_add(&res->fsr_read,
+                           os_cputime_ticks_to_usecs(os_cputime_get32() -
+                                                     t0));
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(FLASHBENCH_CLI)
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <shell/shell.h>
+#include <console/console.h>
+
+#include "flashbench/flashbench.h"
+#include "flashbench_priv.h"
+
+static int flashbench_cli_cmd(int argc, char **argv);
+
+static struct shell_cmd flashbench_cli_struct = {
+    .sc_cmd = "flashbench",
+    .sc_cmd_func = flashbench_cli_cmd
+};
+
+static void
+flashbench_cli_lat(const char *op, const struct flashbench_lat *fl)
+{
+    console_printf("%6s %6lu %8lu %8lu %8lu\n", op,
+      (unsigned long)fl->fl_count,
+      (unsigned long)fl->fl_min_us,
+      fl->fl_count ? (unsigned long)(fl->fl_total_us / fl->fl_count) : 0,
+      (unsigned long)fl->fl_max_us);
+}
+
+static int
+flashbench_cli_sweep(int argc, char **argv)
+{
+    struct flashbench_sweep_result res;
+    int area_id;
+    int rc;
+
+    if (argc < 1) {
+        console_printf("flashbench sweep <flash-area-id>\n");
+        return 0;
+    }
+    area_id = atoi(argv[0]);
+
+    console_printf("sweeping flash area %d (destructive)\n", area_id);
+    rc = flashbench_sweep(area_id, &res);
+    if (rc != 0) {
+        console_printf("sweep failed; rc=%d\n", rc);
+        return 0;
+    }
+
+    console_printf("%6s %6s %8s %8s %8s\n",
+      "op", "count", "min_us", "avg_us", "max_us");
+    flashbench_cli_lat("erase", &res.fsr_erase);
+    flashbench_cli_lat("write", &res.fsr_write);
+    flashbench_cli_lat("read", &res.fsr_read);
+    return 0;
+}
+
+static int
+flashbench_cli_wear(int argc, char **argv)
+{
+    uint32_t count;
+    int cnt;
+    int rc;
+    int i;
+
+    if (argc >= 1 && !strcmp(argv[0], "save")) {
+        rc = flashbench_wear_save();
+        console_printf("wear save %s; rc=%d\n",
+          rc == 0 ? "complete" : "failed", rc);
+        return 0;
+    }
+
+    cnt = flashbench_wear_sector_cnt();
+    console_printf("%6s %8s\n", "sector", "erases");
+    for (i = 0; i < cnt; i++) {
+        count = flashbench_wear_get(i);
+        if (count == 0) {
+            continue;
+        }
+        console_printf("%6d %8lu\n", i, (unsigned long)count);
+    }
+    return 0;
+}
+
+static int
+flashbench_cli_cmd(int argc, char **argv)
+{
+    if (argc >= 2 && !strcmp(argv[1], "sweep")) {
+        return flashbench_cli_sweep(argc - 2, argv + 2);
+    }
+    if (argc >= 2 && !strcmp(argv[1], "wear")) {
+        return flashbench_cli_wear(argc - 2, argv + 2);
+    }
+
+    console_printf("flashbench sweep <flash-area-id> | wear [save]\n");
+    return 0;
+}
+
+int
+flashbench_cli_register(void)
+{
+    return shell_cmd_register(&flashbench_cli_struct);
+}
+
+#endif /* MYNEWT_VAL(FLASHBENCH_CLI) */
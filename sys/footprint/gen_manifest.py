@@ -0,0 +1,104 @@
+#!/usr/bin/env python
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#  http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+
+"""Generate the sys/footprint manifest from a newt build tree.
+
+Sums the sections of each per-package archive under the target's bin
+directory and emits footprint_manifest.c, which the application adds to
+its sources so the manifest is compiled into the image (overriding the
+weak zero-entry default in sys/footprint).  Rerun after "newt build";
+typically wired in as a build step:
+
+    gen_manifest.py bin/targets/<target>/app [budgets-file] > \\
+        apps/<app>/src/footprint_manifest.c
+
+The optional budgets file has one "pkg-name flash-bytes ram-bytes"
+line per budgeted package (0 = unchecked).
+"""
+
+from __future__ import print_function
+
+import os
+import subprocess
+import sys
+
+SIZE_TOOL = os.environ.get("FOOTPRINT_SIZE", "arm-none-eabi-size")
+
+
+def archive_sizes(path):
+    """Sum (text, data, bss) over every member of archive 'path'."""
+    out = subprocess.check_output([SIZE_TOOL, path]).decode()
+    text = data = bss = 0
+    for line in out.splitlines()[1:]:
+        fields = line.split()
+        if len(fields) < 3 or not fields[0].isdigit():
+            continue
+        text += int(fields[0])
+        data += int(fields[1])
+        bss += int(fields[2])
+    return text, data, bss
+
+
+def read_budgets(path):
+    budgets = {}
+    with open(path) as fp:
+        for line in fp:
+            fields = line.split()
+            if len(fields) == 3 and not fields[0].startswith("#"):
+                budgets[fields[0]] = (int(fields[1]), int(fields[2]))
+    return budgets
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("usage: %s <app-bin-dir> [budgets-file]\n" %
+                         sys.argv[0])
+        return 1
+    bin_dir = sys.argv[1]
+    budgets = read_budgets(sys.argv[2]) if len(sys.argv) > 2 else {}
+
+    pkgs = []
+    for root, dirs, files in os.walk(bin_dir):
+        for f in sorted(files):
+            if not f.endswith(".a"):
+                continue
+            # newt mirrors the package path under the bin directory
+            name = os.path.relpath(root, bin_dir)
+            text, data, bss = archive_sizes(os.path.join(root, f))
+            flash_b, ram_b = budgets.get(name, (0, 0))
+            pkgs.append((name, text, data, bss, flash_b, ram_b))
+    pkgs.sort(key=lambda p: p[1] + p[2], reverse=True)
+
+    print("/* Generated by sys/footprint/gen_manifest.py; do not edit. */")
+    print()
+    print('#include "footprint/footprint.h"')
+    print()
+    print("const struct footprint_pkg footprint_manifest[] = {")
+    for name, text, data, bss, flash_b, ram_b in pkgs:
+        print('    { "%s", %u, %u, %u, %u, %u },' %
+              (name, text, data, bss, flash_b, ram_b))
+    print("};")
+    print()
+    print("const int footprint_manifest_cnt = %d;" % len(pkgs))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _SYS_FOOTPRINT_H_
+#define _SYS_FOOTPRINT_H_
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * On-device footprint introspection.  A flash-resident manifest of
+ * per-package text/data/bss sizes, generated at build time by
+ * gen_manifest.py from the per-package archives and compiled into the
+ * application, is queryable over newtmgr and the shell; per-package
+ * and whole-image budgets turn a size regression into a first-boot
+ * failure instead of a hand-run nm diff weeks later.
+ *
+ * Without a generated manifest the weak default (zero entries) links
+ * in and only the image totals, taken from the linker script's section
+ * boundary symbols, are available.
+ */
+
+/** One package's contribution to the image, plus its budgets. */
+struct footprint_pkg {
+    const char *fp_name;
+    uint32_t fp_text;
+    uint32_t fp_data;
+    uint32_t fp_bss;
+    uint32_t fp_flash_budget;   /* ceiling on text + data; 0 = unchecked */
+    uint32_t fp_ram_budget;     /* ceiling on data + bss; 0 = unchecked */
+};
+
+/** Whole-image section totals, from the linker's boundary symbols. */
+struct footprint_totals {
+    uint32_t ft_text;
+    uint32_t ft_data;
+    uint32_t ft_bss;
+};
+
+/** Number of entries in the generated manifest; 0 when not generated. */
+int footprint_pkg_count(void);
+
+/** Manifest entry by index; NULL when idx is out of range. */
+const struct footprint_pkg *footprint_pkg_get(int idx);
+
+/**
+ * Whole-image totals.  Returns SYS_ENODEV on targets whose linker
+ * script does not export the section boundary symbols (e.g. sim).
+ */
+int footprint_image_get(struct footprint_totals *totals);
+
+/**
+ * Check every configured budget; returns the number of violations.
+ * Manifest entries are checked against their own budgets, the image
+ * totals against FOOTPRINT_IMAGE_FLASH_BUDGET / _RAM_BUDGET.
+ */
+int footprint_check(void);
+
+void footprint_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SYS_FOOTPRINT_H_ */
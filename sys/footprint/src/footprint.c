@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stddef.h>
+
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "defs/error.h"
+
+#include "footprint/footprint.h"
+#include "footprint_priv.h"
+
+/*
+ * Weak fallback manifest; a build that runs gen_manifest.py compiles
+ * the generated footprint_manifest.c into the app and these are
+ * overridden.
+ */
+const struct footprint_pkg footprint_manifest[]
+    __attribute__((weak)) = {
+    { NULL, 0, 0, 0, 0, 0 }
+};
+const int footprint_manifest_cnt __attribute__((weak)) = 0;
+
+/*
+ * Section boundary symbols from the ARM linker scripts (nrf52.ld and
+ * kin); weak so the package links on targets (sim) whose scripts do
+ * not export them, where their address resolves to 0.
+ */
+extern uint8_t __isr_vector_start[] __attribute__((weak));
+extern uint8_t __etext[] __attribute__((weak));
+extern uint8_t __data_start__[] __attribute__((weak));
+extern uint8_t __data_end__[] __attribute__((weak));
+extern uint8_t __bss_start__[] __attribute__((weak));
+extern uint8_t __bss_end__[] __attribute__((weak));
+
+int
+footprint_pkg_count(void)
+{
+    return footprint_manifest_cnt;
+}
+
+const struct footprint_pkg *
+footprint_pkg_get(int idx)
+{
+    if (idx < 0 || idx >= footprint_manifest_cnt) {
+        return NULL;
+    }
+    return &footprint_manifest[idx];
+}
+
+int
+footprint_image_get(struct footprint_totals *totals)
+{
+    if (__etext == NULL) {
+        return SYS_ENODEV;
+    }
+    totals->ft_text = (uint32_t)(__etext - __isr_vector_start);
+    totals->ft_data = (uint32_t)(__data_end__ - __data_start__);
+    totals->ft_bss = (uint32_t)(__bss_end__ - __bss_start__);
+    return 0;
+}
+
+int
+footprint_check(void)
+{
+    const struct footprint_pkg *fp;
+    struct footprint_totals totals;
+    int violations;
+    int i;
+
+    violations = 0;
+    for (i = 0; i < footprint_manifest_cnt; i++) {
+        fp = &footprint_manifest[i];
+        if (fp->fp_flash_budget != 0 &&
+            fp->fp_text + fp->fp_data > fp->fp_flash_budget) {
+            violations++;
+        }
+        if (fp->fp_ram_budget != 0 &&
+            fp->fp_data + fp->fp_bss > fp->fp_ram_budget) {
+            violations++;
+        }
+    }
+
+    if ((MYNEWT_VAL(FOOTPRINT_IMAGE_FLASH_BUDGET) != 0 ||
+         MYNEWT_VAL(FOOTPRINT_IMAGE_RAM_BUDGET) != 0) &&
+        footprint_image_get(&totals) == 0) {
+        if (MYNEWT_VAL(FOOTPRINT_IMAGE_FLASH_BUDGET) != 0 &&
+            totals.ft_text + totals.ft_data >
+            MYNEWT_VAL(FOOTPRINT_IMAGE_FLASH_BUDGET)) {
+            violations++;
+        }
+        if (MYNEWT_VAL(FOOTPRINT_IMAGE_RAM_BUDGET) != 0 &&
+            totals.ft_data + totals.ft_bss >
+            MYNEWT_VAL(FOOTPRINT_IMAGE_RAM_BUDGET)) {
+            violations++;
+        }
+    }
+    return violations;
+}
+
+void
+footprint_init(void)
+{
+    int rc;
+
+#if MYNEWT_VAL(FOOTPRINT_BUDGET_ASSERT)
+    SYSINIT_PANIC_ASSERT(footprint_check() == 0);
+#endif
+
+#if MYNEWT_VAL(FOOTPRINT_NEWTMGR)
+    rc = footprint_nmgr_register_group();
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+#if MYNEWT_VAL(FOOTPRINT_CLI)
+    footprint_cli_init();
+#endif
+
+    (void)rc;
+}
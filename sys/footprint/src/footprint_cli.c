@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(FOOTPRINT_CLI)
+
+#include <inttypes.h>
+
+#include <shell/shell.h>
+#include <console/console.h>
+
+#include "footprint/footprint.h"
+#include "footprint_priv.h"
+
+static int footprint_cli_cmd(int argc, char **argv);
+
+static struct shell_cmd footprint_cli_struct = {
+    .sc_cmd = "footprint",
+    .sc_cmd_func = footprint_cli_cmd
+};
+
+static int
+footprint_cli_cmd(int argc, char **argv)
+{
+    const struct footprint_pkg *fp;
+    struct footprint_totals totals;
+    int over;
+    int i;
+
+    if (footprint_image_get(&totals) == 0) {
+        console_printf("image: text %lu data %lu bss %lu\n",
+          (unsigned long)totals.ft_text, (unsigned long)totals.ft_data,
+          (unsigned long)totals.ft_bss);
+    }
+
+    if (footprint_pkg_count() == 0) {
+        console_printf("no manifest in this image\n");
+        return 0;
+    }
+
+    console_printf("%-32s %7s %6s %6s\n", "package", "text", "data", "bss");
+    for (i = 0; (fp = footprint_pkg_get(i)) != NULL; i++) {
+        console_printf("%-32s %7lu %6lu %6lu%s\n", fp->fp_name,
+          (unsigned long)fp->fp_text, (unsigned long)fp->fp_data,
+          (unsigned long)fp->fp_bss,
+          (fp->fp_flash_budget != 0 &&
+           fp->fp_text + fp->fp_data > fp->fp_flash_budget) ||
+          (fp->fp_ram_budget != 0 &&
+           fp->fp_data + fp->fp_bss > fp->fp_ram_budget) ?
+          " OVER BUDGET" : "");
+    }
+
+    over = footprint_check();
+    if (over != 0) {
+        console_printf("%d budget violation(s)\n", over);
+    }
+    return 0;
+}
+
+void
+footprint_cli_init(void)
+{
+    shell_cmd_register(&footprint_cli_struct);
+}
+
+#endif /* MYNEWT_VAL(FOOTPRINT_CLI) */
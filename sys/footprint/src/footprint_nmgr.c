@@ -0,0 +1,164 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(FOOTPRINT_NEWTMGR)
+
+#include "mgmt/mgmt.h"
+#include "cborattr/cborattr.h"
+
+#include "footprint/footprint.h"
+#include "footprint_priv.h"
+
+static int footprint_nmgr_image(struct mgmt_cbuf *cb);
+static int footprint_nmgr_pkg(struct mgmt_cbuf *cb);
+static struct mgmt_group footprint_nmgr_group;
+
+/* ORDER MATTERS HERE.
+ * Each element represents the command ID, referenced from newtmgr.
+ */
+static struct mgmt_handler footprint_nmgr_group_handlers[] = {
+    [FOOTPRINT_NMGR_OP_IMAGE] = {footprint_nmgr_image, NULL},
+    [FOOTPRINT_NMGR_OP_PKG] = {footprint_nmgr_pkg, NULL}
+};
+
+/**
+ * Newtmgr footprint image handler; returns the whole-image section
+ * totals, the manifest entry count, and the budget violation count.
+ */
+static int
+footprint_nmgr_image(struct mgmt_cbuf *cb)
+{
+    struct footprint_totals totals;
+    int rc;
+    CborError g_err = CborNoError;
+    CborEncoder *penc = &cb->encoder;
+    CborEncoder rsp;
+
+    memset(&totals, 0, sizeof totals);
+    rc = footprint_image_get(&totals);
+
+    g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
+    if (rc == 0) {
+        g_err |= cbor_encode_text_stringz(&rsp, "text");
+        g_err |= cbor_encode_uint(&rsp, totals.ft_text);
+        g_err |= cbor_encode_text_stringz(&rsp, "data");
+        g_err |= cbor_encode_uint(&rsp, totals.ft_data);
+        g_err |= cbor_encode_text_stringz(&rsp, "bss");
+        g_err |= cbor_encode_uint(&rsp, totals.ft_bss);
+    }
+    g_err |= cbor_encode_text_stringz(&rsp, "pkgs");
+    g_err |= cbor_encode_uint(&rsp, footprint_pkg_count());
+    g_err |= cbor_encode_text_stringz(&rsp, "over");
+    g_err |= cbor_encode_uint(&rsp, footprint_check());
+    g_err |= cbor_encode_text_stringz(&rsp, "rc");
+    g_err |= cbor_encode_int(&rsp, MGMT_ERR_EOK);
+    g_err |= cbor_encoder_close_container(penc, &rsp);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return 0;
+}
+
+/**
+ * Newtmgr footprint package handler; returns the manifest entry at the
+ * requested index, for the client to pull the whole manifest by
+ * walking "off" until ENOENT.
+ */
+static int
+footprint_nmgr_pkg(struct mgmt_cbuf *cb)
+{
+    const struct footprint_pkg *fp;
+    unsigned long long off;
+    int rc;
+    CborError g_err = CborNoError;
+    CborEncoder *penc = &cb->encoder;
+    CborEncoder rsp;
+
+    const struct cbor_attr_t attr[2] = {
+        [0] = {
+            .attribute = "off",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &off
+        },
+        [1] = {
+            .attribute = NULL
+        }
+    };
+
+    off = 0;
+    rc = cbor_read_object(&cb->it, attr);
+    if (rc) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    fp = footprint_pkg_get(off);
+    if (fp == NULL) {
+        mgmt_cbuf_setoerr(cb, MGMT_ERR_ENOENT);
+        return 0;
+    }
+
+    g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&rsp, "off");
+    g_err |= cbor_encode_uint(&rsp, off);
+    g_err |= cbor_encode_text_stringz(&rsp, "name");
+    g_err |= cbor_encode_text_stringz(&rsp, fp->fp_name);
+    g_err |= cbor_encode_text_stringz(&rsp, "text");
+    g_err |= cbor_encode_uint(&rsp, fp->fp_text);
+    g_err |= cbor_encode_text_stringz(&rsp, "data");
+    g_err |= cbor_encode_uint(&rsp, fp->fp_data);
+    g_err |= cbor_encode_text_stringz(&rsp, "bss");
+    g_err |= cbor_encode_uint(&rsp, fp->fp_bss);
+    if (fp->fp_flash_budget != 0) {
+        g_err |= cbor_encode_text_stringz(&rsp, "flash_budget");
+        g_err |= cbor_encode_uint(&rsp, fp->fp_flash_budget);
+    }
+    if (fp->fp_ram_budget != 0) {
+        g_err |= cbor_encode_text_stringz(&rsp, "ram_budget");
+        g_err |= cbor_encode_uint(&rsp, fp->fp_ram_budget);
+    }
+    g_err |= cbor_encode_text_stringz(&rsp, "rc");
+    g_err |= cbor_encode_int(&rsp, MGMT_ERR_EOK);
+    g_err |= cbor_encoder_close_container(penc, &rsp);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return 0;
+}
+
+/**
+ * Register nmgr group handlers.
+ * @return 0 on success; non-zero on failure
+ */
+int
+footprint_nmgr_register_group(void)
+{
+    MGMT_GROUP_SET_HANDLERS(&footprint_nmgr_group,
+                            footprint_nmgr_group_handlers);
+    footprint_nmgr_group.mg_group_id = MGMT_GROUP_ID_FOOTPRINT;
+
+    return mgmt_group_register(&footprint_nmgr_group);
+}
+
+#endif /* MYNEWT_VAL(FOOTPRINT_NEWTMGR) */
@@ -0,0 +1,45 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _FOOTPRINT_PRIV_H_
+#define _FOOTPRINT_PRIV_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Command IDs within the footprint newtmgr group. */
+#define FOOTPRINT_NMGR_OP_IMAGE     0
+#define FOOTPRINT_NMGR_OP_PKG       1
+
+/*
+ * The generated manifest (gen_manifest.py); weak zero-entry defaults
+ * are in footprint.c so images without the generation step still link.
+ */
+extern const struct footprint_pkg footprint_manifest[];
+extern const int footprint_manifest_cnt;
+
+int footprint_nmgr_register_group(void);
+void footprint_cli_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FOOTPRINT_PRIV_H_ */
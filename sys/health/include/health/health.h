@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __SYS_HEALTH_H__
+#define __SYS_HEALTH_H__
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct os_eventq;
+
+/**
+ * On-device health telemetry aggregator.
+ *
+ * Periodically snapshots mempool low watermarks, task stack usage,
+ * registered event queue depths and watched stats groups into compact
+ * binary records in a dedicated FCB ring.  The ring survives reboots
+ * and can be pulled over newtmgr for post-incident reconstruction of
+ * the device's resource timeline.
+ *
+ * Names are not stored in the records; each entry carries a CRC16 of
+ * its name instead.  The newtmgr "names" command returns the live
+ * name-to-hash mapping for decoding.
+ */
+
+#define HEALTH_REC_VER          0
+
+/** Snapshot record header; sections follow back to back. */
+struct health_rec_hdr {
+    uint8_t hrh_ver;
+    uint8_t hrh_pad;
+    uint16_t hrh_seq;
+    uint32_t hrh_time;          /* Seconds since boot. */
+} __attribute__((packed));
+
+/** Section header; hsh_cnt fixed-size entries follow. */
+struct health_sec_hdr {
+    uint8_t hsh_type;
+    uint8_t hsh_cnt;
+} __attribute__((packed));
+
+#define HEALTH_SEC_MEMPOOL      1
+#define HEALTH_SEC_TASK         2
+#define HEALTH_SEC_EVQ          3
+#define HEALTH_SEC_STAT         4
+
+struct health_ent_mempool {
+    uint16_t hem_name;          /* crc16_ccitt of the pool name. */
+    uint16_t hem_min_free;
+    uint16_t hem_num_free;
+} __attribute__((packed));
+
+struct health_ent_task {
+    uint16_t het_name;
+    uint16_t het_stkusage;      /* High watermark, in os_stack_t units. */
+} __attribute__((packed));
+
+struct health_ent_evq {
+    uint16_t heq_name;
+    uint16_t heq_depth;         /* Events queued at snapshot time. */
+} __attribute__((packed));
+
+struct health_ent_stat {
+    uint16_t hes_name;          /* crc16_ccitt over "<group>.<entry>". */
+    uint32_t hes_val;
+} __attribute__((packed));
+
+/** Upper bound on an encoded snapshot record. */
+#define HEALTH_REC_MAX_LEN                                              \
+    (sizeof (struct health_rec_hdr) +                                   \
+     4 * sizeof (struct health_sec_hdr) +                               \
+     (3 + MYNEWT_VAL(HEALTH_MAX_STAT_GROUPS)) *                         \
+         MYNEWT_VAL(HEALTH_MAX_ENTRIES) * 6)
+
+/**
+ * Takes one snapshot and appends it to the ring, rotating out the
+ * oldest records if the ring is full.  Not reentrant; call it from a
+ * single task (the automatic timer runs it on the default event queue).
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int health_snapshot(void);
+
+/**
+ * Registers an event queue for depth monitoring.
+ *
+ * @param evq                   The queue to watch.
+ * @param name                  Name used for hash resolution; must
+ *                                  remain valid indefinitely.
+ *
+ * @return                      0 on success; OS_ENOMEM if the table
+ *                                  is full.
+ */
+int health_evq_register(struct os_eventq *evq, const char *name);
+
+/**
+ * Adds a stats group to the set included in each snapshot.  The group
+ * is looked up by name at snapshot time, so it need not be registered
+ * yet; an absent group contributes no entries.
+ *
+ * @return                      0 on success; OS_ENOMEM if the table
+ *                                  is full.
+ */
+int health_stats_watch(const char *group_name);
+
+/**
+ * Reads the idx'th oldest record from the ring.
+ *
+ * @param idx                   Record index; 0 is the oldest.
+ * @param buf                   Destination buffer.
+ * @param max_len               Size of buf.
+ * @param out_len               On success, the record length.
+ *
+ * @return                      0 on success; OS_ENOENT if idx is past
+ *                                  the end of the ring.
+ */
+int health_rec_read(int idx, void *buf, int max_len, int *out_len);
+
+/** Erases all records from the ring. */
+int health_clear(void);
+
+/** Reports each known name and its hash to fn. */
+typedef void health_name_fn(const char *name, uint16_t hash, void *arg);
+void health_name_walk(health_name_fn *fn, void *arg);
+
+void health_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SYS_HEALTH_H__ */
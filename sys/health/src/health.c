@@ -0,0 +1,489 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "os/os.h"
+#include "flash_map/flash_map.h"
+#include "fcb/fcb.h"
+#include "stats/stats.h"
+#include "crc/crc16.h"
+
+#include "health/health.h"
+#include "health_priv.h"
+
+#define HEALTH_FCB_MAGIC        0x48544c54
+#define HEALTH_FCB_MAX_SECTORS  8
+
+static struct fcb health_fcb;
+static struct flash_area health_fcb_sectors[HEALTH_FCB_MAX_SECTORS];
+static uint8_t health_fcb_ok;
+
+static uint16_t health_seq;
+
+static struct {
+    struct os_eventq *he_evq;
+    const char *he_name;
+} health_evqs[MYNEWT_VAL(HEALTH_MAX_EVQS)];
+static int health_evq_cnt;
+
+static const char *health_stat_groups[MYNEWT_VAL(HEALTH_MAX_STAT_GROUPS)];
+static int health_stat_group_cnt;
+
+static uint8_t health_rec_buf[HEALTH_REC_MAX_LEN];
+
+#if MYNEWT_VAL(HEALTH_ITVL_SECS) > 0
+static struct os_callout health_co;
+#endif
+
+/*
+ * Record encoder; sections are built in place in health_rec_buf with
+ * the current section's entry count patched as entries are appended.
+ */
+struct health_enc {
+    uint8_t *he_buf;
+    int he_off;
+    int he_max;
+    int he_cnt_off;
+};
+
+static uint16_t
+health_name_hash(const char *name)
+{
+    return crc16_ccitt(0, name, strlen(name));
+}
+
+static uint16_t
+health_stat_hash(const char *group, const char *entry)
+{
+    uint16_t crc;
+
+    crc = crc16_ccitt(0, group, strlen(group));
+    crc = crc16_ccitt(crc, ".", 1);
+    return crc16_ccitt(crc, entry, strlen(entry));
+}
+
+static int
+health_enc_append(struct health_enc *enc, const void *data, int len)
+{
+    if (enc->he_off + len > enc->he_max) {
+        return OS_ENOMEM;
+    }
+    memcpy(enc->he_buf + enc->he_off, data, len);
+    enc->he_off += len;
+    return 0;
+}
+
+static int
+health_sec_start(struct health_enc *enc, uint8_t type)
+{
+    struct health_sec_hdr hdr;
+    int rc;
+
+    hdr.hsh_type = type;
+    hdr.hsh_cnt = 0;
+
+    rc = health_enc_append(enc, &hdr, sizeof hdr);
+    if (rc != 0) {
+        return rc;
+    }
+    enc->he_cnt_off = enc->he_off - 1;
+    return 0;
+}
+
+static void
+health_sec_entry(struct health_enc *enc, const void *data, int len)
+{
+    if (enc->he_buf[enc->he_cnt_off] >= MYNEWT_VAL(HEALTH_MAX_ENTRIES)) {
+        return;
+    }
+    if (health_enc_append(enc, data, len) != 0) {
+        return;
+    }
+    enc->he_buf[enc->he_cnt_off]++;
+}
+
+static uint16_t
+health_evq_depth(struct os_eventq *evq)
+{
+    struct os_event *ev;
+    uint16_t depth;
+    os_sr_t sr;
+
+    depth = 0;
+    OS_ENTER_CRITICAL(sr);
+    STAILQ_FOREACH(ev, &evq->evq_list, ev_next) {
+        depth++;
+    }
+    OS_EXIT_CRITICAL(sr);
+    return depth;
+}
+
+static int
+health_stat_walk_cb(struct stats_hdr *hdr, void *arg, char *name,
+                    uint16_t off)
+{
+    struct health_enc *enc = arg;
+    struct health_ent_stat ent;
+    void *addr;
+
+    addr = (uint8_t *)hdr + off;
+
+    ent.hes_name = health_stat_hash(hdr->s_name, name);
+    switch (hdr->s_size) {
+    case sizeof (uint16_t):
+        ent.hes_val = *(uint16_t *)addr;
+        break;
+    case sizeof (uint32_t):
+        ent.hes_val = *(uint32_t *)addr;
+        break;
+    case sizeof (uint64_t):
+        ent.hes_val = (uint32_t)*(uint64_t *)addr;
+        break;
+    default:
+        return 0;
+    }
+
+    health_sec_entry(enc, &ent, sizeof ent);
+    return 0;
+}
+
+static int
+health_rec_build(struct health_enc *enc)
+{
+    struct health_ent_mempool hem;
+    struct health_ent_task het;
+    struct health_ent_evq heq;
+    struct health_rec_hdr hdr;
+    struct os_mempool_info omi;
+    struct os_task_info oti;
+    struct os_mempool *mp;
+    struct os_task *task;
+    struct stats_hdr *shdr;
+    int rc;
+    int i;
+
+    hdr.hrh_ver = HEALTH_REC_VER;
+    hdr.hrh_pad = 0;
+    hdr.hrh_seq = health_seq;
+    hdr.hrh_time = os_time_get() / OS_TICKS_PER_SEC;
+    rc = health_enc_append(enc, &hdr, sizeof hdr);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = health_sec_start(enc, HEALTH_SEC_MEMPOOL);
+    if (rc != 0) {
+        return rc;
+    }
+    mp = NULL;
+    while (1) {
+        mp = os_mempool_info_get_next(mp, &omi);
+        if (mp == NULL) {
+            break;
+        }
+        hem.hem_name = health_name_hash(omi.omi_name);
+        hem.hem_min_free = omi.omi_min_free;
+        hem.hem_num_free = omi.omi_num_free;
+        health_sec_entry(enc, &hem, sizeof hem);
+    }
+
+    rc = health_sec_start(enc, HEALTH_SEC_TASK);
+    if (rc != 0) {
+        return rc;
+    }
+    task = NULL;
+    while (1) {
+        task = os_task_info_get_next(task, &oti);
+        if (task == NULL) {
+            break;
+        }
+        het.het_name = health_name_hash(oti.oti_name);
+        het.het_stkusage = oti.oti_stkusage;
+        health_sec_entry(enc, &het, sizeof het);
+    }
+
+    rc = health_sec_start(enc, HEALTH_SEC_EVQ);
+    if (rc != 0) {
+        return rc;
+    }
+    for (i = 0; i < health_evq_cnt; i++) {
+        heq.heq_name = health_name_hash(health_evqs[i].he_name);
+        heq.heq_depth = health_evq_depth(health_evqs[i].he_evq);
+        health_sec_entry(enc, &heq, sizeof heq);
+    }
+
+    rc = health_sec_start(enc, HEALTH_SEC_STAT);
+    if (rc != 0) {
+        return rc;
+    }
+    for (i = 0; i < health_stat_group_cnt; i++) {
+        shdr = stats_group_find((char *)health_stat_groups[i]);
+        if (shdr == NULL) {
+            continue;
+        }
+        stats_walk(shdr, health_stat_walk_cb, enc);
+    }
+
+    return 0;
+}
+
+int
+health_snapshot(void)
+{
+    struct fcb_entry loc;
+    struct health_enc enc;
+    int rc;
+
+    if (!health_fcb_ok) {
+        return OS_ENOENT;
+    }
+
+    enc.he_buf = health_rec_buf;
+    enc.he_off = 0;
+    enc.he_max = sizeof health_rec_buf;
+    rc = health_rec_build(&enc);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = fcb_append(&health_fcb, enc.he_off, &loc);
+    if (rc == FCB_ERR_NOSPACE) {
+        rc = fcb_rotate(&health_fcb);
+        if (rc != 0) {
+            return rc;
+        }
+        rc = fcb_append(&health_fcb, enc.he_off, &loc);
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = flash_area_write(loc.fe_area, loc.fe_data_off, health_rec_buf,
+                          enc.he_off);
+    if (rc != 0) {
+        return rc;
+    }
+    rc = fcb_append_finish(&health_fcb, &loc);
+    if (rc != 0) {
+        return rc;
+    }
+
+    health_seq++;
+    return 0;
+}
+
+int
+health_evq_register(struct os_eventq *evq, const char *name)
+{
+    if (health_evq_cnt >= MYNEWT_VAL(HEALTH_MAX_EVQS)) {
+        return OS_ENOMEM;
+    }
+    health_evqs[health_evq_cnt].he_evq = evq;
+    health_evqs[health_evq_cnt].he_name = name;
+    health_evq_cnt++;
+    return 0;
+}
+
+int
+health_stats_watch(const char *group_name)
+{
+    if (health_stat_group_cnt >= MYNEWT_VAL(HEALTH_MAX_STAT_GROUPS)) {
+        return OS_ENOMEM;
+    }
+    health_stat_groups[health_stat_group_cnt] = group_name;
+    health_stat_group_cnt++;
+    return 0;
+}
+
+int
+health_rec_read(int idx, void *buf, int max_len, int *out_len)
+{
+    struct fcb_entry loc;
+    int rc;
+    int i;
+
+    if (!health_fcb_ok) {
+        return OS_ENOENT;
+    }
+
+    memset(&loc, 0, sizeof loc);
+    for (i = 0; i <= idx; i++) {
+        rc = fcb_getnext(&health_fcb, &loc);
+        if (rc != 0) {
+            return OS_ENOENT;
+        }
+    }
+
+    if (loc.fe_data_len > max_len) {
+        return OS_ENOMEM;
+    }
+    rc = flash_area_read(loc.fe_area, loc.fe_data_off, buf, loc.fe_data_len);
+    if (rc != 0) {
+        return rc;
+    }
+
+    *out_len = loc.fe_data_len;
+    return 0;
+}
+
+int
+health_clear(void)
+{
+    if (!health_fcb_ok) {
+        return OS_ENOENT;
+    }
+    return fcb_clear(&health_fcb);
+}
+
+void
+health_name_walk(health_name_fn *fn, void *arg)
+{
+    struct os_mempool_info omi;
+    struct os_task_info oti;
+    struct os_mempool *mp;
+    struct os_task *task;
+    struct stats_hdr *shdr;
+    char name[64];
+    int i;
+    int j;
+
+    mp = NULL;
+    while (1) {
+        mp = os_mempool_info_get_next(mp, &omi);
+        if (mp == NULL) {
+            break;
+        }
+        fn(omi.omi_name, health_name_hash(omi.omi_name), arg);
+    }
+
+    task = NULL;
+    while (1) {
+        task = os_task_info_get_next(task, &oti);
+        if (task == NULL) {
+            break;
+        }
+        fn(oti.oti_name, health_name_hash(oti.oti_name), arg);
+    }
+
+    for (i = 0; i < health_evq_cnt; i++) {
+        fn(health_evqs[i].he_name,
+           health_name_hash(health_evqs[i].he_name), arg);
+    }
+
+    for (i = 0; i < health_stat_group_cnt; i++) {
+        shdr = stats_group_find((char *)health_stat_groups[i]);
+        if (shdr == NULL) {
+            continue;
+        }
+#if MYNEWT_VAL(STATS_NAMES)
+        for (j = 0; j < shdr->s_map_cnt; j++) {
+            snprintf(name, sizeof name, "%s.%s", shdr->s_name,
+                     shdr->s_map[j].snm_name);
+            fn(name, health_stat_hash(shdr->s_name,
+                                      shdr->s_map[j].snm_name), arg);
+        }
+#else
+        /* Matches the "s%d" fallback names stats_walk() generates. */
+        for (j = 0; j < shdr->s_cnt; j++) {
+            char ent[12];
+
+            snprintf(ent, sizeof ent, "s%d", j);
+            snprintf(name, sizeof name, "%s.%s", shdr->s_name, ent);
+            fn(name, health_stat_hash(shdr->s_name, ent), arg);
+        }
+#endif
+    }
+}
+
+static void
+health_fcb_setup(void)
+{
+    int cnt;
+    int rc;
+
+    /* Two passes: size check first, flash_area_to_sectors() does not
+     * honor a capacity limit.
+     */
+    rc = flash_area_to_sectors(MYNEWT_VAL(HEALTH_FLASH_AREA), &cnt, NULL);
+    if (rc != 0 || cnt == 0 || cnt > HEALTH_FCB_MAX_SECTORS) {
+        return;
+    }
+    rc = flash_area_to_sectors(MYNEWT_VAL(HEALTH_FLASH_AREA), &cnt,
+                               health_fcb_sectors);
+    if (rc != 0) {
+        return;
+    }
+
+    health_fcb.f_magic = HEALTH_FCB_MAGIC;
+    health_fcb.f_version = 0;
+    health_fcb.f_sector_cnt = cnt;
+    health_fcb.f_scratch_cnt = 0;
+    health_fcb.f_sectors = health_fcb_sectors;
+    rc = fcb_init(&health_fcb);
+    if (rc == FCB_ERR_MAGIC) {
+        /* First boot with this area; start it fresh. */
+        rc = fcb_clear(&health_fcb);
+    }
+    if (rc != 0) {
+        return;
+    }
+
+    health_fcb_ok = 1;
+}
+
+#if MYNEWT_VAL(HEALTH_ITVL_SECS) > 0
+static void
+health_timer_cb(struct os_event *ev)
+{
+    health_snapshot();
+    os_callout_reset(&health_co,
+                     MYNEWT_VAL(HEALTH_ITVL_SECS) * OS_TICKS_PER_SEC);
+}
+#endif
+
+void
+health_init(void)
+{
+    int rc;
+
+    (void)rc;
+
+    health_fcb_setup();
+
+#if MYNEWT_VAL(HEALTH_BLE_STATS)
+    health_stats_watch("ble_gap");
+    health_stats_watch("ble_hs");
+#endif
+
+#if MYNEWT_VAL(HEALTH_NEWTMGR)
+    rc = health_nmgr_register_group();
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
+#if MYNEWT_VAL(HEALTH_ITVL_SECS) > 0
+    os_callout_init(&health_co, os_eventq_dflt_get(), health_timer_cb, NULL);
+    os_callout_reset(&health_co,
+                     MYNEWT_VAL(HEALTH_ITVL_SECS) * OS_TICKS_PER_SEC);
+#endif
+}
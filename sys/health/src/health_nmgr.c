@@ -0,0 +1,173 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <os/os.h>
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(HEALTH_NEWTMGR)
+
+#include "mgmt/mgmt.h"
+#include "cborattr/cborattr.h"
+
+#include "health/health.h"
+#include "health_priv.h"
+
+static int health_nmgr_read(struct mgmt_cbuf *cb);
+static int health_nmgr_clear(struct mgmt_cbuf *cb);
+static int health_nmgr_names(struct mgmt_cbuf *cb);
+static struct mgmt_group health_nmgr_group;
+
+/* ORDER MATTERS HERE.
+ * Each element represents the command ID, referenced from newtmgr.
+ */
+static struct mgmt_handler health_nmgr_group_handlers[] = {
+    [HEALTH_NMGR_OP_READ] = {health_nmgr_read, NULL},
+    [HEALTH_NMGR_OP_CLEAR] = {NULL, health_nmgr_clear},
+    [HEALTH_NMGR_OP_NAMES] = {health_nmgr_names, NULL}
+};
+
+static uint8_t health_nmgr_buf[HEALTH_REC_MAX_LEN];
+
+/**
+ * Newtmgr health record read handler; returns the record at the
+ * requested index (0 is the oldest) as a raw byte string, for the
+ * client to pull the whole ring by walking "off" until ENOENT.
+ */
+static int
+health_nmgr_read(struct mgmt_cbuf *cb)
+{
+    unsigned long long off;
+    int rec_len;
+    int rc;
+    CborError g_err = CborNoError;
+    CborEncoder *penc = &cb->encoder;
+    CborEncoder rsp;
+
+    const struct cbor_attr_t attr[2] = {
+        [0] = {
+            .attribute = "off",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &off
+        },
+        [1] = {
+            .attribute = NULL
+        }
+    };
+
+    off = 0;
+    rc = cbor_read_object(&cb->it, attr);
+    if (rc) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    rc = health_rec_read(off, health_nmgr_buf, sizeof health_nmgr_buf,
+                         &rec_len);
+    if (rc != 0) {
+        mgmt_cbuf_setoerr(cb, MGMT_ERR_ENOENT);
+        return 0;
+    }
+
+    g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&rsp, "off");
+    g_err |= cbor_encode_uint(&rsp, off);
+    g_err |= cbor_encode_text_stringz(&rsp, "data");
+    g_err |= cbor_encode_byte_string(&rsp, health_nmgr_buf, rec_len);
+    g_err |= cbor_encode_text_stringz(&rsp, "rc");
+    g_err |= cbor_encode_int(&rsp, MGMT_ERR_EOK);
+    g_err |= cbor_encoder_close_container(penc, &rsp);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return 0;
+}
+
+/**
+ * Newtmgr health clear handler; erases the snapshot ring.
+ */
+static int
+health_nmgr_clear(struct mgmt_cbuf *cb)
+{
+    int rc;
+
+    rc = health_clear();
+    if (rc != 0) {
+        rc = MGMT_ERR_EUNKNOWN;
+    }
+    mgmt_cbuf_setoerr(cb, rc);
+    return 0;
+}
+
+static void
+health_nmgr_name_cb(const char *name, uint16_t hash, void *arg)
+{
+    CborEncoder *names = arg;
+    CborError g_err = CborNoError;
+
+    g_err |= cbor_encode_text_stringz(names, name);
+    g_err |= cbor_encode_uint(names, hash);
+    (void)g_err;
+}
+
+/**
+ * Newtmgr health names handler; returns the live name-to-hash mapping
+ * used to decode record entries.  Clients should pull this once and
+ * cache it.
+ */
+static int
+health_nmgr_names(struct mgmt_cbuf *cb)
+{
+    CborError g_err = CborNoError;
+    CborEncoder *penc = &cb->encoder;
+    CborEncoder rsp, names;
+
+    g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&rsp, "rc");
+    g_err |= cbor_encode_int(&rsp, MGMT_ERR_EOK);
+
+    g_err |= cbor_encode_text_stringz(&rsp, "name_map");
+    g_err |= cbor_encoder_create_map(&rsp, &names, CborIndefiniteLength);
+
+    health_name_walk(health_nmgr_name_cb, &names);
+
+    g_err |= cbor_encoder_close_container(&rsp, &names);
+    g_err |= cbor_encoder_close_container(penc, &rsp);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return 0;
+}
+
+/**
+ * Register nmgr group handlers.
+ * @return 0 on success; non-zero on failure
+ */
+int
+health_nmgr_register_group(void)
+{
+    MGMT_GROUP_SET_HANDLERS(&health_nmgr_group, health_nmgr_group_handlers);
+    health_nmgr_group.mg_group_id = MGMT_GROUP_ID_HEALTH;
+
+    return mgmt_group_register(&health_nmgr_group);
+}
+
+#endif /* MYNEWT_VAL(HEALTH_NEWTMGR) */
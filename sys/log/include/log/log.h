@@ -56,6 +56,13 @@ typedef int (*lh_flush_func_t)(struct log *);
  * of entries that are specified while erasing
  */
 typedef int (*lh_rtr_erase_func_t)(struct log *, void *arg);
+/*
+ * This function pointer points to a function that walks the log starting
+ * near the specified timestamp instead of from the beginning; entries
+ * preceding the timestamp may still be delivered to the walk function.
+ */
+typedef int (*lh_walk_from_ts_func_t)(struct log *,
+        log_walk_func_t walk_func, void *arg, int64_t ts);
 
 #define LOG_TYPE_STREAM  (0)
 #define LOG_TYPE_MEMORY  (1)
@@ -68,6 +75,7 @@ struct log_handler {
     lh_walk_func_t log_walk;
     lh_flush_func_t log_flush;
     lh_rtr_erase_func_t log_rtr_erase;
+    lh_walk_from_ts_func_t log_walk_from_ts;
 };
 
 struct log_entry_hdr {
@@ -131,37 +139,79 @@ struct log_entry_hdr {
 
 #define LOG_NAME_MAX_LEN    (64)
 
+/*
+ * When deferred-format mode is enabled, the level macros store the format
+ * string's address and the raw argument words instead of rendering the
+ * message at the call site; see log_printf_defer().
+ */
+#if MYNEWT_VAL(LOG_DEFER_FORMAT)
+#define LOG_PRINTF_FN   log_printf_defer
+#else
+#define LOG_PRINTF_FN   log_printf
+#endif
+
+/*
+ * Per-module runtime filtering.  The check runs before the log arguments are
+ * marshaled, so suppressed messages cost a table lookup rather than a
+ * rendered entry; see log_module_filter_set().
+ */
+#if MYNEWT_VAL(LOG_MODULE_FILTER)
+#define LOG_MODULE_CHECK(__mod, __lvl) log_module_check(__mod, __lvl)
+#else
+#define LOG_MODULE_CHECK(__mod, __lvl) 1
+#endif
+
 #if MYNEWT_VAL(LOG_LEVEL) <= LOG_LEVEL_DEBUG
-#define LOG_DEBUG(__l, __mod, __msg, ...) log_printf(__l, __mod, \
-        LOG_LEVEL_DEBUG, __msg, ##__VA_ARGS__)
+#define LOG_DEBUG(__l, __mod, __msg, ...) do {                          \
+        if (LOG_MODULE_CHECK(__mod, LOG_LEVEL_DEBUG)) {                 \
+            LOG_PRINTF_FN(__l, __mod, LOG_LEVEL_DEBUG, __msg,           \
+                    ##__VA_ARGS__);                                     \
+        }                                                               \
+    } while (0)
 #else
 #define LOG_DEBUG(__l, __mod, ...) IGNORE(__VA_ARGS__)
 #endif
 
 #if MYNEWT_VAL(LOG_LEVEL) <= LOG_LEVEL_INFO
-#define LOG_INFO(__l, __mod, __msg, ...) log_printf(__l, __mod, \
-        LOG_LEVEL_INFO, __msg, ##__VA_ARGS__)
+#define LOG_INFO(__l, __mod, __msg, ...) do {                           \
+        if (LOG_MODULE_CHECK(__mod, LOG_LEVEL_INFO)) {                  \
+            LOG_PRINTF_FN(__l, __mod, LOG_LEVEL_INFO, __msg,            \
+                    ##__VA_ARGS__);                                     \
+        }                                                               \
+    } while (0)
 #else
 #define LOG_INFO(__l, __mod, ...) IGNORE(__VA_ARGS__)
 #endif
 
 #if MYNEWT_VAL(LOG_LEVEL) <= LOG_LEVEL_WARN
-#define LOG_WARN(__l, __mod, __msg, ...) log_printf(__l, __mod, \
-        LOG_LEVEL_WARN, __msg, ##__VA_ARGS__)
+#define LOG_WARN(__l, __mod, __msg, ...) do {                           \
+        if (LOG_MODULE_CHECK(__mod, LOG_LEVEL_WARN)) {                  \
+            LOG_PRINTF_FN(__l, __mod, LOG_LEVEL_WARN, __msg,            \
+                    ##__VA_ARGS__);                                     \
+        }                                                               \
+    } while (0)
 #else
 #define LOG_WARN(__l, __mod, ...) IGNORE(__VA_ARGS__)
 #endif
 
 #if MYNEWT_VAL(LOG_LEVEL) <= LOG_LEVEL_ERROR
-#define LOG_ERROR(__l, __mod, __msg, ...) log_printf(__l, __mod, \
-        LOG_LEVEL_ERROR, __msg, ##__VA_ARGS__)
+#define LOG_ERROR(__l, __mod, __msg, ...) do {                          \
+        if (LOG_MODULE_CHECK(__mod, LOG_LEVEL_ERROR)) {                 \
+            LOG_PRINTF_FN(__l, __mod, LOG_LEVEL_ERROR, __msg,           \
+                    ##__VA_ARGS__);                                     \
+        }                                                               \
+    } while (0)
 #else
 #define LOG_ERROR(__l, __mod, ...) IGNORE(__VA_ARGS__)
 #endif
 
 #if MYNEWT_VAL(LOG_LEVEL) <= LOG_LEVEL_CRITICAL
-#define LOG_CRITICAL(__l, __mod, __msg, ...) log_printf(__l, __mod, \
-        LOG_LEVEL_CRITICAL, __msg, ##__VA_ARGS__)
+#define LOG_CRITICAL(__l, __mod, __msg, ...) do {                       \
+        if (LOG_MODULE_CHECK(__mod, LOG_LEVEL_CRITICAL)) {              \
+            LOG_PRINTF_FN(__l, __mod, LOG_LEVEL_CRITICAL, __msg,        \
+                    ##__VA_ARGS__);                                     \
+        }                                                               \
+    } while (0)
 #else
 #define LOG_CRITICAL(__l, __mod, ...) IGNORE(__VA_ARGS__)
 #endif
@@ -199,10 +249,62 @@ int log_append(struct log *, uint16_t, uint16_t, void *, uint16_t);
 
 #define LOG_PRINTF_MAX_ENTRY_LEN (128)
 void log_printf(struct log *log, uint16_t, uint16_t, char *, ...);
+
+#if MYNEWT_VAL(LOG_DEFER_FORMAT)
+/*
+ * Deferred-format log entries.  The entry body stores the address of the
+ * format string (which must be a string literal, so that it remains valid in
+ * the text section) and the argument values as raw machine words; the
+ * message is rendered when the log is read.  The leading byte distinguishes
+ * such entries from regular text entries, which always start with a
+ * printable character.  64-bit and floating point arguments are not
+ * supported, and %s arguments must point at persistent strings.
+ */
+#define LOG_DEFER_ENTRY_MAGIC    0x01
+#define LOG_DEFER_MAX_ARGS       4
+
+struct log_defer_body {
+    uint8_t ldb_magic;
+    uint8_t ldb_argc;
+    uintptr_t ldb_fmt;
+    uintptr_t ldb_args[LOG_DEFER_MAX_ARGS];
+}__attribute__((__packed__));
+
+void log_printf_defer(struct log *log, uint16_t, uint16_t, const char *, ...);
+int log_defer_format(const void *body, uint16_t body_len, char *buf,
+        int buf_len);
+#endif
+
+#if MYNEWT_VAL(LOG_MODULE_FILTER)
+/*
+ * Per-module filter entry.  A module without an entry is logged unfiltered;
+ * a registered entry enforces a minimum level and, when lmf_rate is nonzero,
+ * a token bucket that drops messages in excess of lmf_rate per second
+ * (bursts up to lmf_burst).
+ */
+struct log_module_filter {
+    uint8_t lmf_in_use;
+    uint8_t lmf_module;
+    uint8_t lmf_min_level;
+    uint16_t lmf_rate;          /* Tokens added per second; 0 disables */
+    uint16_t lmf_burst;         /* Bucket capacity */
+    uint16_t lmf_tokens;
+    uint32_t lmf_last_refill;   /* OS time of the last token refill */
+    uint32_t lmf_dropped;
+};
+
+int log_module_filter_set(uint8_t module, uint8_t min_level, uint16_t rate,
+        uint16_t burst);
+int log_module_filter_clear(uint8_t module);
+uint32_t log_module_filter_dropped(uint8_t module);
+int log_module_check(uint8_t module, uint8_t level);
+#endif
 int log_read(struct log *log, void *dptr, void *buf, uint16_t off,
         uint16_t len);
 int log_walk(struct log *log, log_walk_func_t walk_func,
         void *arg);
+int log_walk_from_ts(struct log *log, log_walk_func_t walk_func,
+        void *arg, int64_t ts);
 int log_flush(struct log *log);
 int log_rtr_erase(struct log *log, void *arg);
 
@@ -0,0 +1,475 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "os/os.h"
+#include "host/ble_hs.h"
+#include "log/log.h"
+#include "tinycbor/cbor.h"
+#include "tinycbor/cbor_buf_writer.h"
+#include "tinycbor/cbor_buf_reader.h"
+#include "tinycbor/cbor_cnt_writer.h"
+#include "cborattr/cborattr.h"
+#if MYNEWT_VAL(LOG_SHIPPER_PERSIST)
+#include "config/config.h"
+#endif
+
+/*
+ * Push-mode log delivery.  A client enables shipping by writing its
+ * cursor (the highest entry index it has durably consumed) to the
+ * control characteristic; from then on the shipper watches the global
+ * append index, batches everything newer into maximal-MTU CBOR frames
+ * and pushes them as notifications from the data characteristic,
+ * pausing after LOG_SHIPPER_WINDOW unacknowledged frames.  Any control
+ * write resets the window and restarts delivery from the written
+ * cursor, so a client that missed a frame just re-writes the last index
+ * it has and gets redelivery.  Compared with polling via log_nmgr this
+ * removes empty polls entirely and amortizes the per-frame framing over
+ * a whole batch of entries.
+ */
+
+/* {4C9A2D78-6E3F-4B21-9D05-8A11C35EF624} */
+static const uint8_t log_shipper_svc_uuid[16] = {
+    0x24, 0xf6, 0x5e, 0xc3, 0x11, 0x8a, 0x05, 0x9d,
+    0x21, 0x4b, 0x3f, 0x6e, 0x78, 0x2d, 0x9a, 0x4c
+};
+
+/* {4C9A2D79-6E3F-4B21-9D05-8A11C35EF624} */
+static const uint8_t log_shipper_chr_data_uuid[16] = {
+    0x24, 0xf6, 0x5e, 0xc3, 0x11, 0x8a, 0x05, 0x9d,
+    0x21, 0x4b, 0x3f, 0x6e, 0x79, 0x2d, 0x9a, 0x4c
+};
+
+/* {4C9A2D7A-6E3F-4B21-9D05-8A11C35EF624} */
+static const uint8_t log_shipper_chr_ctrl_uuid[16] = {
+    0x24, 0xf6, 0x5e, 0xc3, 0x11, 0x8a, 0x05, 0x9d,
+    0x21, 0x4b, 0x3f, 0x6e, 0x7a, 0x2d, 0x9a, 0x4c
+};
+
+static uint16_t log_shipper_data_handle;
+static uint16_t log_shipper_ctrl_handle;
+
+static struct os_callout log_shipper_co;
+
+static uint16_t log_shipper_conn_handle;
+static uint8_t log_shipper_active;
+
+/*
+ * Cursors are (timestamp, index) pairs, matching the ordering log_nmgr
+ * reads use; the raw entry index alone wraps too quickly to be
+ * meaningful on its own.  The acked cursor is what the client has
+ * confirmed; the ship cursor additionally covers frames in flight.
+ */
+static int64_t log_shipper_acked_ts;
+static uint16_t log_shipper_acked_idx;
+static int64_t log_shipper_ship_ts;
+static uint16_t log_shipper_ship_idx;
+
+/* Frames sent since the last acknowledgment. */
+static uint8_t log_shipper_inflight;
+
+struct log_shipper_walk_arg {
+    CborEncoder *lswa_enc;      /* open "entries" array to encode into */
+    int lswa_budget;            /* frame bytes remaining */
+    int64_t lswa_top_ts;        /* newest entry encoded so far */
+    uint16_t lswa_top_idx;
+    int lswa_count;             /* entries encoded so far */
+};
+
+static int
+log_shipper_gatt_access(uint16_t conn_handle, uint16_t attr_handle,
+                        struct ble_gatt_access_ctxt *ctxt, void *arg);
+
+static const struct ble_gatt_svc_def log_shipper_svcs[] = {
+    {
+        /* Service: log shipper */
+        .type = BLE_GATT_SVC_TYPE_PRIMARY,
+        .uuid128 = (void *)log_shipper_svc_uuid,
+        .characteristics = (struct ble_gatt_chr_def[]) { {
+            /* Characteristic: shipped log frames */
+            .uuid128 = (void *)log_shipper_chr_data_uuid,
+            .access_cb = log_shipper_gatt_access,
+            .flags = BLE_GATT_CHR_F_NOTIFY,
+            .val_handle = &log_shipper_data_handle,
+        }, {
+            /* Characteristic: cursor acknowledgment */
+            .uuid128 = (void *)log_shipper_chr_ctrl_uuid,
+            .access_cb = log_shipper_gatt_access,
+            .flags = BLE_GATT_CHR_F_WRITE_NO_RSP | BLE_GATT_CHR_F_WRITE,
+            .val_handle = &log_shipper_ctrl_handle,
+        }, {
+            0, /* No more characteristics in this service */
+        } },
+    },
+
+    {
+        0, /* No more services */
+    },
+};
+
+#if MYNEWT_VAL(LOG_SHIPPER_PERSIST)
+static int
+log_shipper_conf_set(int argc, char **argv, char *val)
+{
+    if (argc != 1) {
+        return OS_ENOENT;
+    }
+    if (!strcmp(argv[0], "ts")) {
+        CONF_VALUE_SET(val, CONF_INT64, log_shipper_acked_ts);
+        log_shipper_ship_ts = log_shipper_acked_ts;
+        return 0;
+    }
+    if (!strcmp(argv[0], "cur")) {
+        CONF_VALUE_SET(val, CONF_INT16, log_shipper_acked_idx);
+        log_shipper_ship_idx = log_shipper_acked_idx;
+        return 0;
+    }
+    return OS_ENOENT;
+}
+
+static int
+log_shipper_conf_export(void (*export_func)(char *name, char *val),
+                        enum conf_export_tgt tgt)
+{
+    char buf[24];
+
+    conf_str_from_value(CONF_INT64, &log_shipper_acked_ts, buf, sizeof(buf));
+    export_func("lsh/ts", buf);
+    conf_str_from_value(CONF_INT16, &log_shipper_acked_idx, buf, sizeof(buf));
+    export_func("lsh/cur", buf);
+    return 0;
+}
+
+static struct conf_handler log_shipper_conf = {
+    .ch_name = "lsh",
+    .ch_get = NULL,
+    .ch_set = log_shipper_conf_set,
+    .ch_commit = NULL,
+    .ch_export = log_shipper_conf_export
+};
+
+static void
+log_shipper_cursor_save(void)
+{
+    char buf[24];
+
+    conf_str_from_value(CONF_INT64, &log_shipper_acked_ts, buf, sizeof(buf));
+    conf_save_one("lsh/ts", buf);
+    conf_str_from_value(CONF_INT16, &log_shipper_acked_idx, buf, sizeof(buf));
+    conf_save_one("lsh/cur", buf);
+}
+#else
+#define log_shipper_cursor_save()
+#endif
+
+/**
+ * Encodes one log entry into the frame being built; mirrors the entry
+ * layout used by log_nmgr reads.  Returns nonzero to stop the walk once
+ * the frame is full.
+ */
+static int
+log_shipper_encode_entry(struct log *log, void *arg, void *dptr, uint16_t len)
+{
+    struct log_shipper_walk_arg *wa = (struct log_shipper_walk_arg *)arg;
+    struct log_entry_hdr ueh;
+    char data[128];
+    int dlen;
+    int rc;
+    CborError g_err = CborNoError;
+    struct CborCntWriter cnt_writer;
+    CborEncoder cnt_encoder;
+    CborEncoder entry;
+
+    rc = log_read(log, dptr, &ueh, 0, sizeof(ueh));
+    if (rc != sizeof(ueh)) {
+        return 0;
+    }
+
+    if (ueh.ue_ts < log_shipper_ship_ts ||
+        (ueh.ue_ts == log_shipper_ship_ts &&
+         ueh.ue_index <= log_shipper_ship_idx)) {
+        /* Already shipped. */
+        return 0;
+    }
+
+    dlen = min(len - sizeof(ueh), sizeof(data) - 1);
+    rc = log_read(log, dptr, data, sizeof(ueh), dlen);
+    if (rc < 0) {
+        return 0;
+    }
+    data[rc] = 0;
+
+#if MYNEWT_VAL(LOG_DEFER_FORMAT)
+    {
+        char rendered[sizeof(data)];
+
+        if (log_defer_format(data, rc, rendered, sizeof(rendered)) >= 0) {
+            memcpy(data, rendered, sizeof(data));
+        }
+    }
+#endif
+
+    /* Count the encoding first so a partial entry never lands in the
+     * frame.  NOTE This code should exactly match what is below.
+     */
+    cbor_cnt_writer_init(&cnt_writer);
+    cbor_encoder_init(&cnt_encoder, &cnt_writer.enc, 0);
+    g_err |= cbor_encoder_create_map(&cnt_encoder, &entry,
+                                     CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&entry, "msg");
+    g_err |= cbor_encode_text_stringz(&entry, data);
+    g_err |= cbor_encode_text_stringz(&entry, "ts");
+    g_err |= cbor_encode_int(&entry, ueh.ue_ts);
+    g_err |= cbor_encode_text_stringz(&entry, "level");
+    g_err |= cbor_encode_uint(&entry, ueh.ue_level);
+    g_err |= cbor_encode_text_stringz(&entry, "index");
+    g_err |= cbor_encode_uint(&entry, ueh.ue_index);
+    g_err |= cbor_encode_text_stringz(&entry, "module");
+    g_err |= cbor_encode_uint(&entry, ueh.ue_module);
+    g_err |= cbor_encoder_close_container(&cnt_encoder, &entry);
+
+    if (cbor_encode_bytes_written(&cnt_encoder) > wa->lswa_budget) {
+        return OS_ENOMEM;
+    }
+
+    g_err |= cbor_encoder_create_map(wa->lswa_enc, &entry,
+                                     CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&entry, "msg");
+    g_err |= cbor_encode_text_stringz(&entry, data);
+    g_err |= cbor_encode_text_stringz(&entry, "ts");
+    g_err |= cbor_encode_int(&entry, ueh.ue_ts);
+    g_err |= cbor_encode_text_stringz(&entry, "level");
+    g_err |= cbor_encode_uint(&entry, ueh.ue_level);
+    g_err |= cbor_encode_text_stringz(&entry, "index");
+    g_err |= cbor_encode_uint(&entry, ueh.ue_index);
+    g_err |= cbor_encode_text_stringz(&entry, "module");
+    g_err |= cbor_encode_uint(&entry, ueh.ue_module);
+    g_err |= cbor_encoder_close_container(wa->lswa_enc, &entry);
+
+    if (g_err) {
+        return OS_ENOMEM;
+    }
+
+    wa->lswa_budget -= cbor_encode_bytes_written(&cnt_encoder);
+    if (ueh.ue_ts > wa->lswa_top_ts ||
+        (ueh.ue_ts == wa->lswa_top_ts && ueh.ue_index > wa->lswa_top_idx)) {
+        wa->lswa_top_ts = ueh.ue_ts;
+        wa->lswa_top_idx = ueh.ue_index;
+    }
+    wa->lswa_count++;
+    return 0;
+}
+
+/**
+ * Builds and pushes one frame of new entries, then re-arms the tick.
+ * Transmit buffer exhaustion leaves the cursor untouched; the same
+ * entries are re-walked on the next tick.
+ */
+static void
+log_shipper_tick(struct os_event *ev)
+{
+    uint8_t buf[MYNEWT_VAL(LOG_SHIPPER_FRAME_SZ)];
+    struct CborBufWriter writer;
+    struct log_shipper_walk_arg wa;
+    CborEncoder enc;
+    CborEncoder map;
+    CborEncoder entries;
+    struct os_mbuf *om;
+    struct log *log;
+    uint16_t mtu;
+    int frame_sz;
+    int used;
+    int rc;
+
+    if (!log_shipper_active) {
+        return;
+    }
+    if (log_shipper_inflight >= MYNEWT_VAL(LOG_SHIPPER_WINDOW)) {
+        goto rearm;
+    }
+
+    mtu = ble_att_mtu(log_shipper_conn_handle);
+    if (mtu == 0) {
+        /* Connection is gone; wait for the next control write. */
+        log_shipper_active = 0;
+        return;
+    }
+
+    frame_sz = mtu - 3;
+    if (frame_sz > sizeof(buf)) {
+        frame_sz = sizeof(buf);
+    }
+
+    cbor_buf_writer_init(&writer, buf, frame_sz);
+    cbor_encoder_init(&enc, &writer.enc, 0);
+    cbor_encoder_create_map(&enc, &map, CborIndefiniteLength);
+    cbor_encode_text_stringz(&map, "entries");
+    cbor_encoder_create_array(&map, &entries, CborIndefiniteLength);
+
+    wa.lswa_enc = &entries;
+    /* Leave room for the container terminators. */
+    wa.lswa_budget = frame_sz - (int)cbor_buf_writer_buffer_size(&writer, buf)
+                     - 2;
+    wa.lswa_top_ts = log_shipper_ship_ts;
+    wa.lswa_top_idx = log_shipper_ship_idx;
+    wa.lswa_count = 0;
+
+    for (log = log_list_get_next(NULL); log != NULL;
+         log = log_list_get_next(log)) {
+
+        if (log->l_log->log_type != LOG_TYPE_STORAGE) {
+            continue;
+        }
+        log_walk(log, log_shipper_encode_entry, &wa);
+    }
+
+    cbor_encoder_close_container(&map, &entries);
+    cbor_encoder_close_container(&enc, &map);
+
+    if (wa.lswa_count == 0) {
+        /* Nothing new. */
+        goto rearm;
+    }
+
+    used = cbor_buf_writer_buffer_size(&writer, buf);
+    om = os_msys_get_pkthdr(used, 0);
+    if (om == NULL || os_mbuf_append(om, buf, used)) {
+        os_mbuf_free_chain(om);
+        goto rearm;
+    }
+
+    rc = ble_gattc_notify_custom(log_shipper_conn_handle,
+                                 log_shipper_data_handle, om);
+    if (rc == 0) {
+        log_shipper_ship_ts = wa.lswa_top_ts;
+        log_shipper_ship_idx = wa.lswa_top_idx;
+        log_shipper_inflight++;
+    } else if (rc != BLE_HS_ENOMEM) {
+        /* Peer disconnected or notifications disabled; go quiet until
+         * the client writes its cursor again.
+         */
+        log_shipper_active = 0;
+        return;
+    }
+
+rearm:
+    os_callout_reset(&log_shipper_co,
+                     (MYNEWT_VAL(LOG_SHIPPER_ITVL_MS) * OS_TICKS_PER_SEC) /
+                     1000);
+}
+
+/**
+ * Handles a cursor write: {"ts": <timestamp>, "cur": <entry index>} of
+ * the newest entry the client has durably consumed.  Restarts delivery
+ * from the written cursor, so re-writing an old cursor forces
+ * redelivery of anything newer.
+ */
+static int
+log_shipper_ctrl_write(uint16_t conn_handle, struct os_mbuf *om)
+{
+    uint8_t buf[32];
+    struct cbor_buf_reader reader;
+    CborParser parser;
+    CborValue value;
+    long long unsigned int cur = ULLONG_MAX;
+    long long int ts = 0;
+    const struct cbor_attr_t attrs[3] = {
+        [0] = {
+            .attribute = "cur",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &cur,
+            .nodefault = true
+        },
+        [1] = {
+            .attribute = "ts",
+            .type = CborAttrIntegerType,
+            .addr.integer = &ts,
+        },
+        [2] = { 0 },
+    };
+    uint16_t len;
+    int rc;
+
+    len = OS_MBUF_PKTLEN(om);
+    if (len > sizeof(buf)) {
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    rc = os_mbuf_copydata(om, 0, len, buf);
+    if (rc != 0) {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
+    cbor_buf_reader_init(&reader, buf, len);
+    rc = cbor_parser_init(&reader.r, 0, &parser, &value);
+    if (rc != 0 || cbor_read_object(&value, attrs) != 0 ||
+        cur == ULLONG_MAX) {
+
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
+    log_shipper_conn_handle = conn_handle;
+    log_shipper_acked_ts = ts;
+    log_shipper_acked_idx = cur;
+    log_shipper_ship_ts = ts;
+    log_shipper_ship_idx = cur;
+    log_shipper_inflight = 0;
+    log_shipper_active = 1;
+    log_shipper_cursor_save();
+
+    os_callout_reset(&log_shipper_co, 0);
+    return 0;
+}
+
+static int
+log_shipper_gatt_access(uint16_t conn_handle, uint16_t attr_handle,
+                        struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    switch (ctxt->op) {
+    case BLE_GATT_ACCESS_OP_WRITE_CHR:
+        return log_shipper_ctrl_write(conn_handle, ctxt->om);
+
+    default:
+        assert(0);
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+}
+
+void
+log_shipper_pkg_init(void)
+{
+    int rc;
+
+    rc = ble_gatts_count_cfg(log_shipper_svcs);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+    rc = ble_gatts_add_svcs(log_shipper_svcs);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+#if MYNEWT_VAL(LOG_SHIPPER_PERSIST)
+    rc = conf_register(&log_shipper_conf);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
+    os_callout_init(&log_shipper_co, os_eventq_dflt_get(), log_shipper_tick,
+                    NULL);
+}
@@ -204,6 +204,56 @@ err:
     return (rc);
 }
 
+struct log_walk_from_ts_arg {
+    log_walk_func_t lwta_func;
+    void *lwta_arg;
+    int64_t lwta_ts;
+};
+
+static int
+log_walk_from_ts_fn(struct log *log, void *arg, void *dptr, uint16_t len)
+{
+    struct log_walk_from_ts_arg *lwta;
+    struct log_entry_hdr ueh;
+    int rc;
+
+    lwta = (struct log_walk_from_ts_arg *)arg;
+
+    rc = log_read(log, dptr, &ueh, 0, sizeof(ueh));
+    if (rc != sizeof(ueh)) {
+        return -1;
+    }
+    if (ueh.ue_ts < lwta->lwta_ts) {
+        return 0;
+    }
+
+    return lwta->lwta_func(log, lwta->lwta_arg, dptr, len);
+}
+
+/**
+ * Walks the specified log, invoking the walk function only for entries with
+ * a timestamp at or after the specified one.  Handlers which keep a
+ * timestamp index start the walk near the requested time, making the cost
+ * proportional to the matching entries; others fall back to a full scan
+ * with the older entries filtered out.
+ */
+int
+log_walk_from_ts(struct log *log, log_walk_func_t walk_func, void *arg,
+        int64_t ts)
+{
+    struct log_walk_from_ts_arg lwta;
+
+    lwta.lwta_func = walk_func;
+    lwta.lwta_arg = arg;
+    lwta.lwta_ts = ts;
+
+    if (log->l_log->log_walk_from_ts != NULL) {
+        return log->l_log->log_walk_from_ts(log, log_walk_from_ts_fn,
+                                            &lwta, ts);
+    }
+    return log_walk(log, log_walk_from_ts_fn, &lwta);
+}
+
 int
 log_read(struct log *log, void *dptr, void *buf, uint16_t off,
         uint16_t len)
@@ -0,0 +1,200 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+/* This whole file is conditionally compiled based on whether the
+ * log package is configured for deferred-format entries
+ * (MYNEWT_VAL(LOG_DEFER_FORMAT)).
+ */
+
+#if MYNEWT_VAL(LOG_DEFER_FORMAT)
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "os/os.h"
+#include "log/log.h"
+
+/*
+ * Counts the printf conversions in a format string; "%%" does not consume
+ * an argument.
+ */
+static int
+log_defer_count_args(const char *fmt)
+{
+    int argc;
+
+    argc = 0;
+    while ((fmt = strchr(fmt, '%')) != NULL) {
+        fmt++;
+        if (*fmt == '\0') {
+            break;
+        }
+        if (*fmt == '%') {
+            fmt++;
+        } else {
+            argc++;
+        }
+    }
+
+    return argc;
+}
+
+/**
+ * Logs a message without rendering it.  Only the format string's address and
+ * the argument values are stored, which makes the call a few flash writes
+ * instead of a printf; log_defer_format() performs the formatting when the
+ * log is read.  The format string must be a string literal.
+ */
+void
+log_printf_defer(struct log *log, uint16_t module, uint16_t level,
+        const char *msg, ...)
+{
+    uint8_t buf[LOG_ENTRY_HDR_SIZE + sizeof (struct log_defer_body)];
+    struct log_defer_body *body;
+    va_list args;
+    int argc;
+    int len;
+    int i;
+
+    body = (struct log_defer_body *) &buf[LOG_ENTRY_HDR_SIZE];
+    body->ldb_magic = LOG_DEFER_ENTRY_MAGIC;
+    body->ldb_fmt = (uintptr_t) msg;
+
+    argc = log_defer_count_args(msg);
+    if (argc > LOG_DEFER_MAX_ARGS) {
+        argc = LOG_DEFER_MAX_ARGS;
+    }
+    body->ldb_argc = argc;
+
+    va_start(args, msg);
+    for (i = 0; i < argc; i++) {
+        body->ldb_args[i] = va_arg(args, uintptr_t);
+    }
+    va_end(args);
+
+    len = offsetof(struct log_defer_body, ldb_args) +
+          argc * sizeof (body->ldb_args[0]);
+    log_append(log, module, level, buf, len);
+}
+
+/**
+ * Renders a deferred-format entry body into a string.  Length modifiers are
+ * dropped from conversion specifications and each stored word is passed with
+ * the width the conversion implies.
+ *
+ * @param body              The entry body, as read from the log (without the
+ *                              log entry header).
+ * @param body_len          The number of bytes in the body.
+ * @param buf               The destination buffer for the rendered string.
+ * @param buf_len           The size of the destination buffer.
+ *
+ * @return                  The length of the rendered string on success;
+ *                          -1 if the body is not a deferred-format entry.
+ */
+int
+log_defer_format(const void *body, uint16_t body_len, char *buf, int buf_len)
+{
+    const struct log_defer_body *ldb;
+    const char *fmt;
+    char conv[16];
+    uintptr_t arg;
+    int arg_idx;
+    int off;
+    int ci;
+    int rc;
+
+    ldb = (const struct log_defer_body *) body;
+    if (body_len < offsetof(struct log_defer_body, ldb_args) ||
+        ldb->ldb_magic != LOG_DEFER_ENTRY_MAGIC) {
+
+        return -1;
+    }
+
+    fmt = (const char *) ldb->ldb_fmt;
+    arg_idx = 0;
+    off = 0;
+
+    while (*fmt != '\0' && off < buf_len - 1) {
+        if (*fmt != '%') {
+            buf[off++] = *fmt++;
+            continue;
+        }
+        fmt++;
+        if (*fmt == '%') {
+            buf[off++] = '%';
+            fmt++;
+            continue;
+        }
+
+        /* Copy the conversion specification, dropping length modifiers. */
+        ci = 0;
+        conv[ci++] = '%';
+        while (*fmt != '\0' && strchr("diouxXcsp", *fmt) == NULL) {
+            if (strchr("lhjzt", *fmt) == NULL && ci < (int)sizeof(conv) - 2) {
+                conv[ci++] = *fmt;
+            }
+            fmt++;
+        }
+        if (*fmt == '\0') {
+            break;
+        }
+        conv[ci++] = *fmt;
+        conv[ci] = '\0';
+
+        if (arg_idx < ldb->ldb_argc) {
+            arg = ldb->ldb_args[arg_idx++];
+        } else {
+            arg = 0;
+        }
+
+        switch (*fmt++) {
+        case 's':
+            rc = snprintf(buf + off, buf_len - off, conv,
+                          arg ? (char *) arg : "(null)");
+            break;
+        case 'p':
+            rc = snprintf(buf + off, buf_len - off, conv, (void *) arg);
+            break;
+        case 'd':
+        case 'i':
+        case 'c':
+            rc = snprintf(buf + off, buf_len - off, conv, (int) arg);
+            break;
+        default:
+            rc = snprintf(buf + off, buf_len - off, conv, (unsigned int) arg);
+            break;
+        }
+        if (rc < 0) {
+            return -1;
+        }
+        if (rc > buf_len - 1 - off) {
+            rc = buf_len - 1 - off;
+        }
+        off += rc;
+    }
+
+    buf[off] = '\0';
+    return off;
+}
+
+#endif
@@ -32,12 +32,82 @@
 
 static struct flash_area sector;
 
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+/**
+ * Records every fl_ts_stride-th appended entry's timestamp and flash
+ * location.  When all slots are in use, every other sample is dropped and
+ * the stride doubles, so the index stays within its fixed footprint.
+ */
+static void
+log_fcb_ts_index_sample(struct fcb_log *fcb_log, const void *buf,
+                        struct fcb_entry *loc)
+{
+    const struct log_entry_hdr *ue;
+    struct fcb_log_ts_slot *slot;
+    int i;
+
+    if (fcb_log->fl_ts_stride == 0) {
+        fcb_log->fl_ts_stride = MYNEWT_VAL(LOG_FCB_TS_INDEX_STRIDE);
+    }
+
+    if (fcb_log->fl_ts_pending != 0) {
+        fcb_log->fl_ts_pending--;
+        return;
+    }
+    fcb_log->fl_ts_pending = fcb_log->fl_ts_stride - 1;
+
+    if (fcb_log->fl_ts_cnt == MYNEWT_VAL(LOG_FCB_TS_INDEX_SLOTS)) {
+        for (i = 1; i < fcb_log->fl_ts_cnt / 2; i++) {
+            fcb_log->fl_ts_slots[i] = fcb_log->fl_ts_slots[2 * i];
+        }
+        fcb_log->fl_ts_cnt /= 2;
+        fcb_log->fl_ts_stride *= 2;
+    }
+
+    ue = (const struct log_entry_hdr *)buf;
+    slot = &fcb_log->fl_ts_slots[fcb_log->fl_ts_cnt++];
+    slot->lts_ts = ue->ue_ts;
+    slot->lts_area = loc->fe_area;
+    slot->lts_elem_off = loc->fe_elem_off;
+}
+
+/**
+ * Drops the index samples pointing into the specified flash area; called
+ * when the area gets rotated out and erased.
+ */
+static void
+log_fcb_ts_index_purge(struct fcb_log *fcb_log, const struct flash_area *fap)
+{
+    int src;
+    int dst;
+
+    dst = 0;
+    for (src = 0; src < fcb_log->fl_ts_cnt; src++) {
+        if (fcb_log->fl_ts_slots[src].lts_area != fap) {
+            fcb_log->fl_ts_slots[dst++] = fcb_log->fl_ts_slots[src];
+        }
+    }
+    fcb_log->fl_ts_cnt = dst;
+}
+
+static void
+log_fcb_ts_index_reset(struct fcb_log *fcb_log)
+{
+    fcb_log->fl_ts_cnt = 0;
+    fcb_log->fl_ts_stride = 0;
+    fcb_log->fl_ts_pending = 0;
+}
+#endif
+
 static int
 log_fcb_append(struct log *log, void *buf, int len)
 {
     struct fcb *fcb;
     struct fcb_entry loc;
     struct fcb_log *fcb_log;
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+    struct flash_area *old_oldest;
+#endif
     int rc;
 
     fcb_log = (struct fcb_log *)log->l_arg;
@@ -61,10 +131,16 @@ log_fcb_append(struct log *log, void *buf, int len)
             continue;
         }
 
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+        old_oldest = fcb->f_oldest;
+#endif
         rc = fcb_rotate(fcb);
         if (rc) {
             goto err;
         }
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+        log_fcb_ts_index_purge(fcb_log, old_oldest);
+#endif
     }
 
     rc = flash_area_write(loc.fe_area, loc.fe_data_off, buf, len);
@@ -73,6 +149,11 @@ log_fcb_append(struct log *log, void *buf, int len)
     }
 
     rc = fcb_append_finish(fcb, &loc);
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+    if (rc == 0 && len >= LOG_ENTRY_HDR_SIZE) {
+        log_fcb_ts_index_sample(fcb_log, buf, &loc);
+    }
+#endif
 
 err:
     return (rc);
@@ -119,9 +200,53 @@ log_fcb_walk(struct log *log, log_walk_func_t walk_func, void *arg)
     return (rc);
 }
 
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+/**
+ * Walks the log starting from the newest indexed entry older than the
+ * specified timestamp; entries between the sample and the requested time
+ * are still delivered, so the walk function is expected to filter on the
+ * entry timestamp (log_walk_from_ts() does).
+ */
+static int
+log_fcb_walk_from_ts(struct log *log, log_walk_func_t walk_func, void *arg,
+                     int64_t ts)
+{
+    struct fcb_log *fcb_log;
+    struct fcb *fcb;
+    struct fcb_entry loc;
+    int rc;
+    int i;
+
+    rc = 0;
+    fcb_log = (struct fcb_log *)log->l_arg;
+    fcb = &fcb_log->fl_fcb;
+
+    memset(&loc, 0, sizeof(loc));
+
+    for (i = fcb_log->fl_ts_cnt - 1; i >= 0; i--) {
+        if (fcb_log->fl_ts_slots[i].lts_ts < ts) {
+            loc.fe_area = fcb_log->fl_ts_slots[i].lts_area;
+            loc.fe_elem_off = fcb_log->fl_ts_slots[i].lts_elem_off;
+            break;
+        }
+    }
+
+    while (fcb_getnext(fcb, &loc) == 0) {
+        rc = walk_func(log, arg, (void *) &loc, loc.fe_data_len);
+        if (rc) {
+            break;
+        }
+    }
+    return (rc);
+}
+#endif
+
 static int
 log_fcb_flush(struct log *log)
 {
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+    log_fcb_ts_index_reset((struct fcb_log *)log->l_arg);
+#endif
     return fcb_clear(&((struct fcb_log *)log->l_arg)->fl_fcb);
 }
 
@@ -132,13 +257,13 @@ log_fcb_flush(struct log *log)
  */
 static int
 log_fcb_copy_entry(struct log *log, struct fcb_entry *entry,
-                   struct fcb *dst_fcb)
+                   struct fcb_log *dst_fcb_log)
 {
     struct log_entry_hdr ueh;
     char data[LOG_PRINTF_MAX_ENTRY_LEN + sizeof(ueh)];
     int dlen;
     int rc;
-    struct fcb *fcb_tmp;
+    void *arg_tmp;
 
     rc = log_fcb_read(log, entry, &ueh, 0, sizeof(ueh));
     if (rc != sizeof(ueh)) {
@@ -154,11 +279,11 @@ log_fcb_copy_entry(struct log *log, struct fcb_entry *entry,
     data[rc] = '\0';
 
     /* Changing the fcb to be logged to be dst fcb */
-    fcb_tmp = &((struct fcb_log *)log->l_arg)->fl_fcb;
+    arg_tmp = log->l_arg;
 
-    log->l_arg = dst_fcb;
+    log->l_arg = dst_fcb_log;
     rc = log_fcb_append(log, data, dlen);
-    log->l_arg = fcb_tmp;
+    log->l_arg = arg_tmp;
     if (rc) {
         goto err;
     }
@@ -173,8 +298,8 @@ err:
  * @return 0 on success; non-zero on error
  */
 static int
-log_fcb_copy(struct log *log, struct fcb *src_fcb, struct fcb *dst_fcb,
-             uint32_t offset)
+log_fcb_copy(struct log *log, struct fcb *src_fcb,
+             struct fcb_log *dst_fcb_log, uint32_t offset)
 {
     struct fcb_entry entry;
     int rc;
@@ -186,7 +311,7 @@ log_fcb_copy(struct log *log, struct fcb *src_fcb, struct fcb *dst_fcb,
         if (entry.fe_elem_off < offset) {
             continue;
         }
-        rc = log_fcb_copy_entry(log, &entry, dst_fcb);
+        rc = log_fcb_copy_entry(log, &entry, dst_fcb_log);
         if (rc) {
             break;
         }
@@ -205,7 +330,8 @@ static int
 log_fcb_rtr_erase(struct log *log, void *arg)
 {
     struct fcb_log *fcb_log;
-    struct fcb fcb_scratch;
+    struct fcb_log fcb_scratch_log;
+    struct fcb *fcb_scratch;
     struct fcb *fcb;
     const struct flash_area *ptr;
     uint32_t offset;
@@ -221,19 +347,20 @@ log_fcb_rtr_erase(struct log *log, void *arg)
     fcb_log = (struct fcb_log *)arg;
     fcb = (struct fcb *)fcb_log;
 
-    memset(&fcb_scratch, 0, sizeof(fcb_scratch));
+    memset(&fcb_scratch_log, 0, sizeof(fcb_scratch_log));
+    fcb_scratch = &fcb_scratch_log.fl_fcb;
 
     if (flash_area_open(FLASH_AREA_IMAGE_SCRATCH, &ptr)) {
         goto err;
     }
     sector = *ptr;
-    fcb_scratch.f_sectors = &sector;
-    fcb_scratch.f_sector_cnt = 1;
-    fcb_scratch.f_magic = 0x7EADBADF;
-    fcb_scratch.f_version = g_log_info.li_version;
+    fcb_scratch->f_sectors = &sector;
+    fcb_scratch->f_sector_cnt = 1;
+    fcb_scratch->f_magic = 0x7EADBADF;
+    fcb_scratch->f_version = g_log_info.li_version;
 
     flash_area_erase(&sector, 0, sector.fa_size);
-    rc = fcb_init(&fcb_scratch);
+    rc = fcb_init(fcb_scratch);
     if (rc) {
         goto err;
     }
@@ -245,7 +372,7 @@ log_fcb_rtr_erase(struct log *log, void *arg)
     }
 
     /* Copy to scratch */
-    rc = log_fcb_copy(log, fcb, &fcb_scratch, offset);
+    rc = log_fcb_copy(log, fcb, &fcb_scratch_log, offset);
     if (rc) {
         goto err;
     }
@@ -257,7 +384,7 @@ log_fcb_rtr_erase(struct log *log, void *arg)
     }
 
     /* Copy back from scratch */
-    rc = log_fcb_copy(log, &fcb_scratch, fcb, 0);
+    rc = log_fcb_copy(log, fcb_scratch, fcb_log, 0);
 
 err:
     return (rc);
@@ -270,6 +397,9 @@ const struct log_handler log_fcb_handler = {
     .log_walk = log_fcb_walk,
     .log_flush = log_fcb_flush,
     .log_rtr_erase = log_fcb_rtr_erase,
+#if MYNEWT_VAL(LOG_FCB_TS_INDEX)
+    .log_walk_from_ts = log_fcb_walk_from_ts,
+#endif
 };
 
 #endif
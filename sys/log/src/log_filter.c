@@ -0,0 +1,222 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+/* This whole file is conditionally compiled based on whether the
+ * log package is configured for per-module filtering
+ * (MYNEWT_VAL(LOG_MODULE_FILTER)).
+ */
+
+#if MYNEWT_VAL(LOG_MODULE_FILTER)
+
+#include "os/os.h"
+#include "log/log.h"
+
+static struct log_module_filter
+    log_module_filters[MYNEWT_VAL(LOG_MODULE_FILTER_SLOTS)];
+
+static struct log_module_filter *
+log_module_filter_find(uint8_t module)
+{
+    struct log_module_filter *lmf;
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(LOG_MODULE_FILTER_SLOTS); i++) {
+        lmf = &log_module_filters[i];
+        if (lmf->lmf_in_use && lmf->lmf_module == module) {
+            return lmf;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Installs or updates the filter for the specified log module.
+ *
+ * @param module            The log module ID to filter.
+ * @param min_level         Messages below this level are dropped.
+ * @param rate              Maximum sustained messages per second; 0 disables
+ *                              rate limiting for this module.
+ * @param burst             Number of messages the module may emit in a burst
+ *                              before the rate limit takes hold.
+ *
+ * @return                  0 on success; -1 if all filter slots are in use.
+ */
+int
+log_module_filter_set(uint8_t module, uint8_t min_level, uint16_t rate,
+        uint16_t burst)
+{
+    struct log_module_filter *lmf;
+    os_sr_t sr;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+
+    lmf = log_module_filter_find(module);
+    if (lmf == NULL) {
+        for (i = 0; i < MYNEWT_VAL(LOG_MODULE_FILTER_SLOTS); i++) {
+            if (!log_module_filters[i].lmf_in_use) {
+                lmf = &log_module_filters[i];
+                break;
+            }
+        }
+    }
+    if (lmf == NULL) {
+        OS_EXIT_CRITICAL(sr);
+        return -1;
+    }
+
+    lmf->lmf_module = module;
+    lmf->lmf_min_level = min_level;
+    lmf->lmf_rate = rate;
+    lmf->lmf_burst = burst;
+    lmf->lmf_tokens = burst;
+    lmf->lmf_last_refill = os_time_get();
+    lmf->lmf_dropped = 0;
+    lmf->lmf_in_use = 1;
+
+    OS_EXIT_CRITICAL(sr);
+
+    return 0;
+}
+
+/**
+ * Removes the filter for the specified log module; its messages are logged
+ * unfiltered again.
+ *
+ * @return                  0 on success; -1 if no filter was installed.
+ */
+int
+log_module_filter_clear(uint8_t module)
+{
+    struct log_module_filter *lmf;
+    os_sr_t sr;
+    int rc;
+
+    OS_ENTER_CRITICAL(sr);
+
+    lmf = log_module_filter_find(module);
+    if (lmf != NULL) {
+        lmf->lmf_in_use = 0;
+        rc = 0;
+    } else {
+        rc = -1;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
+    return rc;
+}
+
+/**
+ * Retrieves the number of messages the rate limiter has dropped for the
+ * specified module; 0 if no filter is installed.
+ */
+uint32_t
+log_module_filter_dropped(uint8_t module)
+{
+    struct log_module_filter *lmf;
+    uint32_t dropped;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+
+    lmf = log_module_filter_find(module);
+    if (lmf != NULL) {
+        dropped = lmf->lmf_dropped;
+    } else {
+        dropped = 0;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
+    return dropped;
+}
+
+/**
+ * Indicates whether a message of the specified level may currently be logged
+ * for the specified module.  The LOG_DEBUG/... macros call this before
+ * marshaling their arguments; a dropped message consumes neither CPU for
+ * formatting nor flash bandwidth.
+ *
+ * @return                  1 if the message should be logged; 0 if it should
+ *                              be dropped.
+ */
+int
+log_module_check(uint8_t module, uint8_t level)
+{
+    struct log_module_filter *lmf;
+    uint32_t elapsed;
+    uint32_t refill;
+    os_sr_t sr;
+    int rc;
+
+    OS_ENTER_CRITICAL(sr);
+
+    lmf = log_module_filter_find(module);
+    if (lmf == NULL) {
+        rc = 1;
+        goto done;
+    }
+
+    if (level < lmf->lmf_min_level) {
+        rc = 0;
+        goto done;
+    }
+
+    if (lmf->lmf_rate == 0) {
+        rc = 1;
+        goto done;
+    }
+
+    /* Refill the token bucket with whole tokens; the time that only bought a
+     * fraction of a token remains accounted to lmf_last_refill.
+     */
+    elapsed = os_time_get() - lmf->lmf_last_refill;
+    if (elapsed > UINT16_MAX) {
+        elapsed = UINT16_MAX;
+    }
+    refill = elapsed * lmf->lmf_rate / OS_TICKS_PER_SEC;
+    if (refill > 0) {
+        if (refill >= (uint32_t)lmf->lmf_burst - lmf->lmf_tokens) {
+            lmf->lmf_tokens = lmf->lmf_burst;
+            lmf->lmf_last_refill = os_time_get();
+        } else {
+            lmf->lmf_tokens += refill;
+            lmf->lmf_last_refill += refill * OS_TICKS_PER_SEC / lmf->lmf_rate;
+        }
+    }
+
+    if (lmf->lmf_tokens == 0) {
+        lmf->lmf_dropped++;
+        rc = 0;
+        goto done;
+    }
+    lmf->lmf_tokens--;
+    rc = 1;
+
+done:
+    OS_EXIT_CRITICAL(sr);
+
+    return rc;
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "mgmt/mgmt.h"
 #include "cborattr/cborattr.h"
 #include "tinycbor/cbor_cnt_writer.h"
+#include "tinycbor/cbor_skeleton.h"
 #include "log/log.h"
 
 /* Source code is only included if the newtmgr library is enabled.  Otherwise
@@ -42,6 +43,16 @@ static int log_nmgr_level_list(struct mgmt_cbuf *njb);
 static int log_nmgr_logs_list(struct mgmt_cbuf *njb);
 static struct mgmt_group log_nmgr_group;
 
+/* Precompiled skeleton of the per-entry response map; every entry has
+ * the same keys, so their encoded bytes are computed once at register
+ * time and spliced per entry.
+ */
+static const char * const log_nmgr_entry_keys[] = {
+    "msg", "ts", "level", "index", "module"
+};
+static struct cbor_skeleton log_nmgr_entry_skel;
+static uint8_t log_nmgr_entry_skel_buf[32];
+
 
 /* ORDER MATTERS HERE.
  * Each element represents the command ID, referenced from newtmgr.
@@ -104,24 +115,33 @@ log_nmgr_encode_entry(struct log *log, void *arg, void *dptr, uint16_t len)
     }
     data[rc] = 0;
 
+#if MYNEWT_VAL(LOG_DEFER_FORMAT)
+    {
+        char rendered[sizeof(data)];
+
+        if (log_defer_format(data, rc, rendered, sizeof(rendered)) >= 0) {
+            memcpy(data, rendered, sizeof(data));
+        }
+    }
+#endif
+
     /*calculate whether this would fit */
     /* create a counting encoder for cbor */
     cbor_cnt_writer_init(&cnt_writer);
     cbor_encoder_init(&cnt_encoder, &cnt_writer.enc, 0);
 
     /* NOTE This code should exactly match what is below */
-    g_err |= cbor_encoder_create_map(&cnt_encoder, &rsp, CborIndefiniteLength);
-    g_err |= cbor_encode_text_stringz(&rsp, "msg");
+    g_err |= cbor_skeleton_begin(&cnt_encoder, &rsp, &log_nmgr_entry_skel);
     g_err |= cbor_encode_text_stringz(&rsp, data);
-    g_err |= cbor_encode_text_stringz(&rsp, "ts");
+    g_err |= cbor_skeleton_key(&rsp, &log_nmgr_entry_skel, 1);
     g_err |= cbor_encode_int(&rsp, ueh.ue_ts);
-    g_err |= cbor_encode_text_stringz(&rsp, "level");
+    g_err |= cbor_skeleton_key(&rsp, &log_nmgr_entry_skel, 2);
     g_err |= cbor_encode_uint(&rsp, ueh.ue_level);
-    g_err |= cbor_encode_text_stringz(&rsp, "index");
+    g_err |= cbor_skeleton_key(&rsp, &log_nmgr_entry_skel, 3);
     g_err |= cbor_encode_uint(&rsp,  ueh.ue_index);
-    g_err |= cbor_encode_text_stringz(&rsp, "module");
+    g_err |= cbor_skeleton_key(&rsp, &log_nmgr_entry_skel, 4);
     g_err |= cbor_encode_uint(&rsp,  ueh.ue_module);
-    g_err |= cbor_encoder_close_container(&cnt_encoder, &rsp);
+    g_err |= cbor_skeleton_end(&cnt_encoder, &rsp);
     rsp_len = encode_off->rsp_len;
     rsp_len += cbor_encode_bytes_written(&cnt_encoder);
     if (rsp_len > 400) {
@@ -130,18 +150,17 @@ log_nmgr_encode_entry(struct log *log, void *arg, void *dptr, uint16_t len)
     }
     encode_off->rsp_len = rsp_len;
 
-    g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
-    g_err |= cbor_encode_text_stringz(&rsp, "msg");
+    g_err |= cbor_skeleton_begin(penc, &rsp, &log_nmgr_entry_skel);
     g_err |= cbor_encode_text_stringz(&rsp, data);
-    g_err |= cbor_encode_text_stringz(&rsp, "ts");
+    g_err |= cbor_skeleton_key(&rsp, &log_nmgr_entry_skel, 1);
     g_err |= cbor_encode_int(&rsp, ueh.ue_ts);
-    g_err |= cbor_encode_text_stringz(&rsp, "level");
+    g_err |= cbor_skeleton_key(&rsp, &log_nmgr_entry_skel, 2);
     g_err |= cbor_encode_uint(&rsp, ueh.ue_level);
-    g_err |= cbor_encode_text_stringz(&rsp, "index");
+    g_err |= cbor_skeleton_key(&rsp, &log_nmgr_entry_skel, 3);
     g_err |= cbor_encode_uint(&rsp,  ueh.ue_index);
-    g_err |= cbor_encode_text_stringz(&rsp, "module");
+    g_err |= cbor_skeleton_key(&rsp, &log_nmgr_entry_skel, 4);
     g_err |= cbor_encode_uint(&rsp,  ueh.ue_module);
-    g_err |= cbor_encoder_close_container(penc, &rsp);
+    g_err |= cbor_skeleton_end(penc, &rsp);
 
     if (g_err) {
         return MGMT_ERR_ENOMEM;
@@ -511,6 +530,15 @@ log_nmgr_register_group(void)
     MGMT_GROUP_SET_HANDLERS(&log_nmgr_group, log_nmgr_group_handlers);
     log_nmgr_group.mg_group_id = MGMT_GROUP_ID_LOGS;
 
+    rc = cbor_skeleton_build(&log_nmgr_entry_skel, log_nmgr_entry_skel_buf,
+                             sizeof(log_nmgr_entry_skel_buf),
+                             log_nmgr_entry_keys,
+                             sizeof(log_nmgr_entry_keys) /
+                             sizeof(log_nmgr_entry_keys[0]));
+    if (rc) {
+        goto err;
+    }
+
     rc = mgmt_group_register(&log_nmgr_group);
     if (rc) {
         goto err;
@@ -55,6 +55,16 @@ shell_log_dump_entry(struct log *log, void *arg, void *dptr, uint16_t len)
     }
     data[rc] = 0;
 
+#if MYNEWT_VAL(LOG_DEFER_FORMAT)
+    {
+        char rendered[sizeof(data)];
+
+        if (log_defer_format(data, rc, rendered, sizeof(rendered)) >= 0) {
+            memcpy(data, rendered, sizeof(data));
+        }
+    }
+#endif
+
     /* XXX: This is evil.  newlib printf does not like 64-bit
      * values, and this causes memory to be overwritten.  Cast to a
      * unsigned 32-bit value for now.
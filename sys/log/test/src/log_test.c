@@ -84,6 +84,9 @@ TEST_CASE_DECL(log_setup_fcb)
 TEST_CASE_DECL(log_append_fcb)
 TEST_CASE_DECL(log_walk_fcb)
 TEST_CASE_DECL(log_flush_fcb)
+TEST_CASE_DECL(log_append_defer)
+TEST_CASE_DECL(log_module_filter)
+TEST_CASE_DECL(log_walk_ts)
 
 TEST_SUITE(log_test_all)
 {
@@ -91,6 +94,9 @@ TEST_SUITE(log_test_all)
     log_append_fcb();
     log_walk_fcb();
     log_flush_fcb();
+    log_append_defer();
+    log_module_filter();
+    log_walk_ts();
 }
 
 #if MYNEWT_VAL(SELFTEST)
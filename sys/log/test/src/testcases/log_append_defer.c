@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "log_test.h"
+
+static int log_test_defer_walked;
+
+static int
+log_test_walk_defer(struct log *log, void *arg, void *dptr, uint16_t len)
+{
+    struct log_entry_hdr ueh;
+    char body[128];
+    char rendered[128];
+    int dlen;
+    int rc;
+
+    rc = log_read(log, dptr, &ueh, 0, sizeof(ueh));
+    TEST_ASSERT(rc == sizeof(ueh));
+
+    dlen = len - sizeof(ueh);
+    TEST_ASSERT(dlen < sizeof(body));
+
+    rc = log_read(log, dptr, body, sizeof(ueh), dlen);
+    TEST_ASSERT(rc == dlen);
+
+    /* The entry body is much smaller than the rendered message. */
+    TEST_ASSERT(dlen <= sizeof(struct log_defer_body));
+
+    rc = log_defer_format(body, dlen, rendered, sizeof(rendered));
+    TEST_ASSERT(rc >= 0);
+    TEST_ASSERT(strcmp(rendered, "defer 42 abc 2a 100%") == 0);
+
+    log_test_defer_walked++;
+
+    return 0;
+}
+
+TEST_CASE(log_append_defer)
+{
+    int rc;
+
+    log_printf_defer(&my_log, 0, 0, "defer %d %s %x %u%%",
+                     42, "abc", 42, 100);
+
+    rc = log_walk(&my_log, log_test_walk_defer, NULL);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(log_test_defer_walked == 1);
+
+    rc = log_flush(&my_log);
+    TEST_ASSERT(rc == 0);
+}
@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "log_test.h"
+
+TEST_CASE(log_module_filter)
+{
+    int rc;
+
+    /* A module without a filter is logged unfiltered. */
+    TEST_ASSERT(log_module_check(LOG_MODULE_TEST, LOG_LEVEL_DEBUG) == 1);
+
+    /* Minimum level INFO; at most 1 msg/sec with a burst of 2. */
+    rc = log_module_filter_set(LOG_MODULE_TEST, LOG_LEVEL_INFO, 1, 2);
+    TEST_ASSERT(rc == 0);
+
+    /* Below the module's minimum level. */
+    TEST_ASSERT(log_module_check(LOG_MODULE_TEST, LOG_LEVEL_DEBUG) == 0);
+
+    /* The burst allows two messages; the third is dropped. */
+    TEST_ASSERT(log_module_check(LOG_MODULE_TEST, LOG_LEVEL_INFO) == 1);
+    TEST_ASSERT(log_module_check(LOG_MODULE_TEST, LOG_LEVEL_ERROR) == 1);
+    TEST_ASSERT(log_module_check(LOG_MODULE_TEST, LOG_LEVEL_ERROR) == 0);
+    TEST_ASSERT(log_module_filter_dropped(LOG_MODULE_TEST) == 1);
+
+    /* One second's worth of ticks buys exactly one more token. */
+    os_time_advance(OS_TICKS_PER_SEC);
+    TEST_ASSERT(log_module_check(LOG_MODULE_TEST, LOG_LEVEL_ERROR) == 1);
+    TEST_ASSERT(log_module_check(LOG_MODULE_TEST, LOG_LEVEL_ERROR) == 0);
+
+    /* Other modules are unaffected. */
+    TEST_ASSERT(log_module_check(LOG_MODULE_DEFAULT, LOG_LEVEL_DEBUG) == 1);
+
+    rc = log_module_filter_clear(LOG_MODULE_TEST);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(log_module_check(LOG_MODULE_TEST, LOG_LEVEL_DEBUG) == 1);
+}
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "log_test.h"
+
+#define LOG_TS_TEST_ENTRIES     40
+
+static int64_t log_ts_test_tss[LOG_TS_TEST_ENTRIES];
+static int log_ts_test_cnt;
+
+static int
+log_ts_test_walk(struct log *log, void *arg, void *dptr, uint16_t len)
+{
+    struct log_entry_hdr ueh;
+    int rc;
+
+    rc = log_read(log, dptr, &ueh, 0, sizeof(ueh));
+    TEST_ASSERT(rc == sizeof(ueh));
+
+    TEST_ASSERT(log_ts_test_cnt < LOG_TS_TEST_ENTRIES);
+    log_ts_test_tss[log_ts_test_cnt++] = ueh.ue_ts;
+
+    return 0;
+}
+
+TEST_CASE(log_walk_ts)
+{
+    int64_t all_tss[LOG_TS_TEST_ENTRIES];
+    int rc;
+    int i;
+
+    /* Each entry gets a distinct timestamp from the advancing OS time. */
+    for (i = 0; i < LOG_TS_TEST_ENTRIES; i++) {
+        log_printf(&my_log, 0, 0, "ts entry %d", i);
+        os_time_advance(OS_TICKS_PER_SEC);
+    }
+
+    log_ts_test_cnt = 0;
+    rc = log_walk(&my_log, log_ts_test_walk, NULL);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(log_ts_test_cnt == LOG_TS_TEST_ENTRIES);
+    memcpy(all_tss, log_ts_test_tss, sizeof(all_tss));
+    for (i = 1; i < LOG_TS_TEST_ENTRIES; i++) {
+        TEST_ASSERT(all_tss[i] > all_tss[i - 1]);
+    }
+
+    /* Walking from an entry's timestamp delivers it and everything newer. */
+    log_ts_test_cnt = 0;
+    rc = log_walk_from_ts(&my_log, log_ts_test_walk, NULL, all_tss[30]);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(log_ts_test_cnt == LOG_TS_TEST_ENTRIES - 30);
+    for (i = 0; i < log_ts_test_cnt; i++) {
+        TEST_ASSERT(log_ts_test_tss[i] == all_tss[30 + i]);
+    }
+
+    /* Timestamp 0 precedes everything. */
+    log_ts_test_cnt = 0;
+    rc = log_walk_from_ts(&my_log, log_ts_test_walk, NULL, 0);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(log_ts_test_cnt == LOG_TS_TEST_ENTRIES);
+
+    /* A timestamp past the newest entry matches nothing. */
+    log_ts_test_cnt = 0;
+    rc = log_walk_from_ts(&my_log, log_ts_test_walk, NULL,
+                          all_tss[LOG_TS_TEST_ENTRIES - 1] + 1);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(log_ts_test_cnt == 0);
+
+    rc = log_flush(&my_log);
+    TEST_ASSERT(rc == 0);
+}
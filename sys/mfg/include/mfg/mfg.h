@@ -47,6 +47,8 @@ struct mfg_meta_flash_area {
 int mfg_next_tlv(struct mfg_meta_tlv *tlv, uint32_t *off);
 int mfg_next_tlv_with_type(struct mfg_meta_tlv *tlv, uint32_t *off,
                            uint8_t type);
+int mfg_find(uint8_t type, struct mfg_meta_tlv *tlv, uint32_t *off);
+const void *mfg_tlv_data_ptr(const struct mfg_meta_tlv *tlv, uint32_t off);
 int mfg_read_tlv_flash_area(const struct mfg_meta_tlv *tlv, uint32_t off,
                             struct mfg_meta_flash_area *out_mfa);
 int mfg_read_tlv_hash(const struct mfg_meta_tlv *tlv, uint32_t off,
@@ -76,6 +76,20 @@ struct {
     uint32_t size;
 } mfg_state;
 
+/*
+ * RAM index of the meta region, built once at init, so per-type lookups
+ * are a table read instead of a TLV-by-TLV flash scan.
+ */
+struct mfg_index_entry {
+    uint8_t type;
+    uint8_t size;
+    uint32_t off;
+};
+
+static struct mfg_index_entry mfg_index[MYNEWT_VAL(MFG_INDEX_MAX_ENTRIES)];
+static uint8_t mfg_index_cnt;
+static uint8_t mfg_index_complete;
+
 struct mfg_meta_header {
     uint8_t version;
     uint8_t pad8;
@@ -292,6 +306,123 @@ done:
     return rc;
 }
 
+/**
+ * Retrieves the first TLV of the specified type via the RAM index built at
+ * init time.  Unlike mfg_next_tlv_with_type(), this does not scan the meta
+ * region in flash; when the region held more TLVs than the index could hold
+ * (MFG_INDEX_MAX_ENTRIES), lookups of unindexed types fall back to a scan.
+ *
+ * @param type                  The type of TLV to retrieve; one of the
+ *                                  MFG_META_TLV_TYPE_[...] constants.
+ * @param tlv (out)             On success, the requested TLV header gets
+ *                                  written here.
+ * @param off (out)             On success, the flash-area-offset of the
+ *                                  retrieved TLV header.
+ *
+ * @return                      0 if a TLV header was successfully retrieved;
+ *                              MFG_EDONE if the region contains no TLV of the
+ *                                  specified type;
+ *                              Other MFG error code on failure.
+ */
+int
+mfg_find(uint8_t type, struct mfg_meta_tlv *tlv, uint32_t *off)
+{
+    int i;
+
+    if (!mfg_state.valid) {
+        return MFG_EUNINIT;
+    }
+
+    for (i = 0; i < mfg_index_cnt; i++) {
+        if (mfg_index[i].type == type) {
+            tlv->type = mfg_index[i].type;
+            tlv->size = mfg_index[i].size;
+            *off = mfg_index[i].off;
+            return 0;
+        }
+    }
+
+    if (!mfg_index_complete) {
+        /* The region holds more TLVs than the index; a match may exist
+         * beyond the indexed portion.
+         */
+        *off = 0;
+        return mfg_next_tlv_with_type(tlv, off, type);
+    }
+
+    return MFG_EDONE;
+}
+
+/**
+ * Retrieves a pointer to a TLV's data in memory-mapped flash, for zero-copy
+ * reads of calibration data.  Only valid when MFG_MMAP_READ is enabled and
+ * the boot loader area resides on memory-mapped internal flash; returns NULL
+ * otherwise, in which case the caller should fall back to a flash read.
+ *
+ * @param tlv                   The header of the TLV to access.
+ * @param off                   The flash-area-offset of the TLV header.
+ *
+ * @return                      Pointer to "TLV size" bytes of data on
+ *                                  success; NULL if the data cannot be
+ *                                  directly addressed.
+ */
+const void *
+mfg_tlv_data_ptr(const struct mfg_meta_tlv *tlv, uint32_t off)
+{
+    (void)tlv;
+
+#if MYNEWT_VAL(MFG_MMAP_READ)
+    {
+        const struct flash_area *fap;
+        const void *ptr;
+        int rc;
+
+        rc = flash_area_open(FLASH_AREA_BOOTLOADER, &fap);
+        if (rc != 0) {
+            return NULL;
+        }
+
+        ptr = NULL;
+        if (fap->fa_device_id == 0) {
+            /* Internal flash; hal flash offsets are CPU addresses. */
+            ptr = (const void *)(uintptr_t)
+                (fap->fa_off + off + MFG_META_TLV_SZ);
+        }
+
+        flash_area_close(fap);
+        return ptr;
+    }
+#else
+    (void)off;
+    return NULL;
+#endif
+}
+
+/**
+ * Populates the RAM TLV index by walking the meta region once.
+ */
+static void
+mfg_index_build(void)
+{
+    struct mfg_meta_tlv tlv;
+    uint32_t off;
+
+    mfg_index_cnt = 0;
+    mfg_index_complete = 1;
+
+    off = 0;
+    while (mfg_next_tlv(&tlv, &off) == 0) {
+        if (mfg_index_cnt >= MYNEWT_VAL(MFG_INDEX_MAX_ENTRIES)) {
+            mfg_index_complete = 0;
+            break;
+        }
+        mfg_index[mfg_index_cnt].type = tlv.type;
+        mfg_index[mfg_index_cnt].size = tlv.size;
+        mfg_index[mfg_index_cnt].off = off;
+        mfg_index_cnt++;
+    }
+}
+
 /**
  * Locates the manufacturing meta region in flash.  This function must be
  * called before any TLVs can be read.  No-op if this function has already
@@ -340,6 +471,8 @@ mfg_init(void)
     mfg_state.off = fap->fa_size - ftr.size;
     mfg_state.size = ftr.size;
 
+    mfg_index_build();
+
     rc = 0;
 
 done:
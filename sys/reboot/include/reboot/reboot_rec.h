@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef __REBOOT_REC_H__
+#define __REBOOT_REC_H__
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary per-boot session records, written to a dedicated FCB ring
+ * (REBOOT_REC syscfg setting).  Unlike the ASCII reboot log, records
+ * have a fixed layout so fleet tooling and on-device crash-loop
+ * detection work on structured fields instead of scraped strings.
+ * The last REBOOT_REC_MAX_ENTRIES records are mirrored in RAM at init,
+ * so reads are O(1) and need no flash access.
+ */
+
+#define REBOOT_REC_VERSION          1
+
+#define REBOOT_REC_TASK_NAME_LEN    12
+#define REBOOT_REC_HASH_LEN         8
+
+/* Values for rr_fault[] indices */
+#define REBOOT_REC_FAULT_PC         0
+#define REBOOT_REC_FAULT_LR         1
+#define REBOOT_REC_FAULT_PSR        2
+#define REBOOT_REC_FAULT_STATUS     3
+#define REBOOT_REC_FAULT_REGS       4
+
+struct reboot_rec {
+    uint8_t rr_version;
+    uint8_t rr_reason;          /* SOFT_REBOOT/HARD_REBOOT/GEN_CORE */
+    uint16_t rr_session;        /* per-boot session number (reboot_cnt) */
+    uint32_t rr_uptime;         /* session uptime in seconds; 0 if unknown */
+    uint32_t rr_fault[REBOOT_REC_FAULT_REGS];   /* pc/lr/psr/fault status */
+    char rr_task[REBOOT_REC_TASK_NAME_LEN];     /* task at fault, if known */
+    uint8_t rr_img_hash[REBOOT_REC_HASH_LEN];   /* truncated image hash */
+} __attribute__((packed));
+
+/*
+ * Appends a record for the current session.  Uptime and session number
+ * are filled in automatically; 'fault_regs' (REBOOT_REC_FAULT_REGS
+ * words) and 'task_name' may be NULL when not applicable, e.g. for a
+ * record written at boot for a preceding hard reset.
+ */
+int reboot_rec_write(int reason, const uint32_t *fault_regs,
+                     const char *task_name);
+
+/*
+ * Reads a record from the RAM mirror; idx 0 is the most recent
+ * session.  Returns OS_ENOENT past the end.
+ */
+int reboot_rec_read(int idx, struct reboot_rec *out);
+
+/* Number of records available through reboot_rec_read(). */
+int reboot_rec_count(void);
+
+/*
+ * Returns 1 if the last 'n' sessions all ended in a non-soft reset
+ * with an uptime below 'max_uptime' seconds - i.e. the device is crash
+ * looping; 0 otherwise.
+ */
+int reboot_rec_crash_loop(int n, uint32_t max_uptime);
+
+/* Erases the record ring (flash and RAM mirror). */
+int reboot_rec_clear(void);
+
+void reboot_rec_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REBOOT_REC_H__ */
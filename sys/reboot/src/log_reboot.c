@@ -31,6 +31,7 @@
 #include "config/config.h"
 #include "config/config_file.h"
 #include "reboot/log_reboot.h"
+#include "reboot/reboot_rec.h"
 #include "bsp/bsp.h"
 #include "flash_map/flash_map.h"
 
@@ -185,10 +186,24 @@ log_reboot(int reason)
                  " img:%u.%u.%u.%u", REBOOT_REASON_STR(reason), reboot_tmp_cnt,
                  ver.iv_major, ver.iv_minor, ver.iv_revision,
                  (unsigned int)ver.iv_build_num);
+#if MYNEWT_VAL(REBOOT_REC)
+    /* Mirror the reboot as a binary session record */
+    reboot_rec_write(reason, NULL, NULL);
+#endif
 err:
     return (rc);
 }
 
+/**
+ * Per-boot session number for the binary session records; tracks the
+ * persisted reboot counter.
+ */
+uint16_t
+reboot_rec_session_get(void)
+{
+    return reboot_cnt;
+}
+
 static char *
 reboot_cnt_get(int argc, char **argv, char *buf, int max_len)
 {
@@ -247,4 +262,16 @@ log_reboot_pkg_init(void)
     rc = reboot_init_handler(type, MYNEWT_VAL(REBOOT_LOG_ENTRY_COUNT));
     SYSINIT_PANIC_ASSERT(rc == 0);
 #endif
+
+#if MYNEWT_VAL(REBOOT_REC)
+    reboot_rec_init();
+#if MYNEWT_VAL(REBOOT_REC_NEWTMGR)
+    {
+        extern int reboot_nmgr_register_group(void);
+
+        rc = reboot_nmgr_register_group();
+        SYSINIT_PANIC_ASSERT(rc == 0);
+    }
+#endif
+#endif
 }
@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(REBOOT_REC_NEWTMGR)
+
+#include "os/os.h"
+#include "mgmt/mgmt.h"
+#include "cborattr/cborattr.h"
+
+#include "reboot/reboot_rec.h"
+
+#define REBOOT_NMGR_OP_READ     0
+#define REBOOT_NMGR_OP_CLEAR    1
+
+static int reboot_nmgr_read(struct mgmt_cbuf *cb);
+static int reboot_nmgr_clear(struct mgmt_cbuf *cb);
+static struct mgmt_group reboot_nmgr_group;
+
+/* ORDER MATTERS HERE.
+ * Each element represents the command ID, referenced from newtmgr.
+ */
+static struct mgmt_handler reboot_nmgr_group_handlers[] = {
+    [REBOOT_NMGR_OP_READ] = {reboot_nmgr_read, NULL},
+    [REBOOT_NMGR_OP_CLEAR] = {NULL, reboot_nmgr_clear}
+};
+
+/**
+ * Newtmgr session record read handler; returns the record at the
+ * requested index (0 is the most recent session) as structured
+ * fields, for the client to pull the whole ring by walking "off"
+ * until ENOENT.
+ */
+static int
+reboot_nmgr_read(struct mgmt_cbuf *cb)
+{
+    unsigned long long off;
+    struct reboot_rec rec;
+    size_t task_len;
+    int rc;
+    CborError g_err = CborNoError;
+    CborEncoder *penc = &cb->encoder;
+    CborEncoder rsp, fault;
+    int i;
+
+    const struct cbor_attr_t attr[2] = {
+        [0] = {
+            .attribute = "off",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &off
+        },
+        [1] = {
+            .attribute = NULL
+        }
+    };
+
+    off = 0;
+    rc = cbor_read_object(&cb->it, attr);
+    if (rc) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    rc = reboot_rec_read(off, &rec);
+    if (rc != 0) {
+        mgmt_cbuf_setoerr(cb, MGMT_ERR_ENOENT);
+        return 0;
+    }
+
+    task_len = strnlen(rec.rr_task, sizeof(rec.rr_task));
+
+    g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&rsp, "off");
+    g_err |= cbor_encode_uint(&rsp, off);
+    g_err |= cbor_encode_text_stringz(&rsp, "session");
+    g_err |= cbor_encode_uint(&rsp, rec.rr_session);
+    g_err |= cbor_encode_text_stringz(&rsp, "reason");
+    g_err |= cbor_encode_uint(&rsp, rec.rr_reason);
+    g_err |= cbor_encode_text_stringz(&rsp, "uptime");
+    g_err |= cbor_encode_uint(&rsp, rec.rr_uptime);
+    g_err |= cbor_encode_text_stringz(&rsp, "fault");
+    g_err |= cbor_encoder_create_array(&rsp, &fault, REBOOT_REC_FAULT_REGS);
+    for (i = 0; i < REBOOT_REC_FAULT_REGS; i++) {
+        g_err |= cbor_encode_uint(&fault, rec.rr_fault[i]);
+    }
+    g_err |= cbor_encoder_close_container(&rsp, &fault);
+    g_err |= cbor_encode_text_stringz(&rsp, "task");
+    g_err |= cbor_encode_text_string(&rsp, rec.rr_task, task_len);
+    g_err |= cbor_encode_text_stringz(&rsp, "hash");
+    g_err |= cbor_encode_byte_string(&rsp, rec.rr_img_hash,
+                                     sizeof(rec.rr_img_hash));
+    g_err |= cbor_encode_text_stringz(&rsp, "rc");
+    g_err |= cbor_encode_int(&rsp, MGMT_ERR_EOK);
+    g_err |= cbor_encoder_close_container(penc, &rsp);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return 0;
+}
+
+/**
+ * Newtmgr session record clear handler; erases the record ring.
+ */
+static int
+reboot_nmgr_clear(struct mgmt_cbuf *cb)
+{
+    int rc;
+
+    rc = reboot_rec_clear();
+    if (rc != 0) {
+        rc = MGMT_ERR_EUNKNOWN;
+    }
+    mgmt_cbuf_setoerr(cb, rc);
+    return 0;
+}
+
+/**
+ * Register nmgr group handlers.
+ * @return 0 on success; non-zero on failure
+ */
+int
+reboot_nmgr_register_group(void)
+{
+    MGMT_GROUP_SET_HANDLERS(&reboot_nmgr_group, reboot_nmgr_group_handlers);
+    reboot_nmgr_group.mg_group_id = MGMT_GROUP_ID_REBOOT;
+
+    return mgmt_group_register(&reboot_nmgr_group);
+}
+
+#endif /* MYNEWT_VAL(REBOOT_REC_NEWTMGR) */
@@ -0,0 +1,226 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(REBOOT_REC)
+
+#include "os/os.h"
+#include "flash_map/flash_map.h"
+#include "fcb/fcb.h"
+#include "bootutil/image.h"
+#include "imgmgr/imgmgr.h"
+#include "reboot/log_reboot.h"
+#include "reboot/reboot_rec.h"
+
+#define REBOOT_REC_FCB_MAGIC        0x5245424f
+#define REBOOT_REC_FCB_MAX_SECTORS  4
+
+static struct fcb reboot_rec_fcb;
+static struct flash_area reboot_rec_fcb_sectors[REBOOT_REC_FCB_MAX_SECTORS];
+static uint8_t reboot_rec_fcb_ok;
+
+/*
+ * RAM mirror of the newest records; [0] is the most recent.  Filled
+ * from flash once at init so per-read cost is a memcpy.
+ */
+static struct reboot_rec reboot_rec_cache[MYNEWT_VAL(REBOOT_REC_MAX_ENTRIES)];
+static uint8_t reboot_rec_cache_cnt;
+
+extern uint16_t reboot_rec_session_get(void);
+
+static void
+reboot_rec_cache_put(const struct reboot_rec *rec)
+{
+    int n;
+
+    n = reboot_rec_cache_cnt;
+    if (n == MYNEWT_VAL(REBOOT_REC_MAX_ENTRIES)) {
+        n--;
+    }
+    memmove(&reboot_rec_cache[1], &reboot_rec_cache[0],
+            n * sizeof(struct reboot_rec));
+    reboot_rec_cache[0] = *rec;
+    if (reboot_rec_cache_cnt < MYNEWT_VAL(REBOOT_REC_MAX_ENTRIES)) {
+        reboot_rec_cache_cnt++;
+    }
+}
+
+int
+reboot_rec_write(int reason, const uint32_t *fault_regs,
+                 const char *task_name)
+{
+    struct reboot_rec rec;
+    struct fcb_entry loc;
+    struct image_version ver;
+    uint8_t hash[IMGMGR_HASH_LEN];
+    int rc;
+
+    if (!reboot_rec_fcb_ok) {
+        return OS_ENOENT;
+    }
+
+    memset(&rec, 0, sizeof(rec));
+    rec.rr_version = REBOOT_REC_VERSION;
+    rec.rr_reason = reason;
+    rec.rr_session = reboot_rec_session_get();
+    rec.rr_uptime = os_time_get() / OS_TICKS_PER_SEC;
+    if (fault_regs != NULL) {
+        memcpy(rec.rr_fault, fault_regs, sizeof(rec.rr_fault));
+    }
+    if (task_name != NULL) {
+        strncpy(rec.rr_task, task_name, sizeof(rec.rr_task) - 1);
+    }
+    if (imgr_read_info(boot_current_slot, &ver, hash, NULL) == 0) {
+        memcpy(rec.rr_img_hash, hash, sizeof(rec.rr_img_hash));
+    }
+
+    rc = fcb_append(&reboot_rec_fcb, sizeof(rec), &loc);
+    if (rc == FCB_ERR_NOSPACE) {
+        rc = fcb_rotate(&reboot_rec_fcb);
+        if (rc != 0) {
+            return rc;
+        }
+        rc = fcb_append(&reboot_rec_fcb, sizeof(rec), &loc);
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = flash_area_write(loc.fe_area, loc.fe_data_off, &rec, sizeof(rec));
+    if (rc != 0) {
+        return rc;
+    }
+    rc = fcb_append_finish(&reboot_rec_fcb, &loc);
+    if (rc != 0) {
+        return rc;
+    }
+
+    reboot_rec_cache_put(&rec);
+    return 0;
+}
+
+int
+reboot_rec_read(int idx, struct reboot_rec *out)
+{
+    if (idx < 0 || idx >= reboot_rec_cache_cnt) {
+        return OS_ENOENT;
+    }
+    *out = reboot_rec_cache[idx];
+    return 0;
+}
+
+int
+reboot_rec_count(void)
+{
+    return reboot_rec_cache_cnt;
+}
+
+int
+reboot_rec_crash_loop(int n, uint32_t max_uptime)
+{
+    int i;
+
+    if (n <= 0 || n > reboot_rec_cache_cnt) {
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        if (reboot_rec_cache[i].rr_reason == SOFT_REBOOT ||
+            reboot_rec_cache[i].rr_uptime >= max_uptime) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int
+reboot_rec_clear(void)
+{
+    if (!reboot_rec_fcb_ok) {
+        return OS_ENOENT;
+    }
+    reboot_rec_cache_cnt = 0;
+    return fcb_clear(&reboot_rec_fcb);
+}
+
+/*
+ * Loads the newest records from flash into the RAM mirror.  The FCB
+ * walks oldest first; run through all entries keeping the last N.
+ */
+static void
+reboot_rec_cache_load(void)
+{
+    struct fcb_entry loc;
+    struct reboot_rec rec;
+    int rc;
+
+    memset(&loc, 0, sizeof(loc));
+    while (fcb_getnext(&reboot_rec_fcb, &loc) == 0) {
+        if (loc.fe_data_len != sizeof(rec)) {
+            continue;
+        }
+        rc = flash_area_read(loc.fe_area, loc.fe_data_off, &rec,
+                             sizeof(rec));
+        if (rc != 0 || rec.rr_version != REBOOT_REC_VERSION) {
+            continue;
+        }
+        reboot_rec_cache_put(&rec);
+    }
+}
+
+void
+reboot_rec_init(void)
+{
+    int cnt;
+    int rc;
+
+    /* Two passes: size check first, flash_area_to_sectors() does not
+     * honor a capacity limit.
+     */
+    rc = flash_area_to_sectors(MYNEWT_VAL(REBOOT_REC_FLASH_AREA), &cnt, NULL);
+    if (rc != 0 || cnt == 0 || cnt > REBOOT_REC_FCB_MAX_SECTORS) {
+        return;
+    }
+    rc = flash_area_to_sectors(MYNEWT_VAL(REBOOT_REC_FLASH_AREA), &cnt,
+                               reboot_rec_fcb_sectors);
+    if (rc != 0) {
+        return;
+    }
+
+    reboot_rec_fcb.f_magic = REBOOT_REC_FCB_MAGIC;
+    reboot_rec_fcb.f_version = 0;
+    reboot_rec_fcb.f_sector_cnt = cnt;
+    reboot_rec_fcb.f_scratch_cnt = 0;
+    reboot_rec_fcb.f_sectors = reboot_rec_fcb_sectors;
+    rc = fcb_init(&reboot_rec_fcb);
+    if (rc == FCB_ERR_MAGIC) {
+        /* First boot with this area; start it fresh. */
+        rc = fcb_clear(&reboot_rec_fcb);
+    }
+    if (rc != 0) {
+        return;
+    }
+
+    reboot_rec_fcb_ok = 1;
+    reboot_rec_cache_load();
+}
+
+#endif /* MYNEWT_VAL(REBOOT_REC) */
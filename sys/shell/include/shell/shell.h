@@ -20,6 +20,7 @@
 #define __SHELL_H__
 
 #include <os/os.h>
+#include "syscfg/syscfg.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,9 +32,21 @@ typedef int (*shell_cmd_func_t)(int argc, char **argv);
 struct shell_cmd {
     char *sc_cmd;
     shell_cmd_func_t sc_cmd_func;
+    uint8_t sc_flags;
+#if MYNEWT_VAL(SHELL_CMD_HASH)
+    struct shell_cmd *sc_hash_next;     /* maintained by shell_cmd_register */
+#endif
     STAILQ_ENTRY(shell_cmd) sc_next;
 };
 
+/*
+ * Run this command as a detached job on the shell job task instead of
+ * inline on the shell task, so a slow command does not freeze the
+ * console.  Requires SHELL_JOBS; ignored (the command runs inline)
+ * otherwise.
+ */
+#define SHELL_CMD_F_ASYNC       0x01
+
 int shell_cmd_register(struct shell_cmd *sc);
 
 #define SHELL_NLIP_PKT_START1 (6)
@@ -73,6 +73,18 @@ static struct shell_cmd g_shell_os_date_cmd = {
     .sc_cmd = "date",
     .sc_cmd_func = shell_os_date_cmd
 };
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+static struct shell_cmd g_shell_os_mempool_trace_cmd = {
+    .sc_cmd = "mempool_trace",
+    .sc_cmd_func = shell_os_mempool_trace_cmd
+};
+#endif
+#if MYNEWT_VAL(SYSINIT_TIMING)
+static struct shell_cmd g_shell_sysinit_cmd = {
+    .sc_cmd = "sysinit",
+    .sc_cmd_func = shell_sysinit_timing_cmd
+};
+#endif
 
 static struct os_event shell_console_rdy_ev = {
     .ev_cb = shell_event_console_rdy,
@@ -90,6 +102,91 @@ static STAILQ_HEAD(, shell_cmd) g_shell_cmd_list =
 static struct os_mbuf *g_nlip_mbuf;
 static uint16_t g_nlip_expected_len;
 
+#if MYNEWT_VAL(SHELL_CMD_HASH)
+/*
+ * Command dispatch buckets; chains are maintained by
+ * shell_cmd_register() under the command list lock.
+ */
+static struct shell_cmd *g_shell_cmd_hash[MYNEWT_VAL(SHELL_CMD_HASH_SIZE)];
+
+static uint32_t
+shell_cmd_hash_fn(const char *name)
+{
+    uint32_t hash;
+
+    hash = 5381;
+    while (*name) {
+        hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+    return hash;
+}
+#endif
+
+#if MYNEWT_VAL(SHELL_JOBS)
+/*
+ * A single detached job slot.  The command line is copied out of
+ * shell_line so the shell task can keep reading the console while the
+ * job runs; output goes through the console as usual.
+ */
+struct shell_job {
+    struct os_event sj_ev;
+    struct shell_cmd *sj_cmd;
+    int sj_argc;
+    char *sj_argv[SHELL_MAX_ARGS];
+    char sj_line[MYNEWT_VAL(SHELL_MAX_INPUT_LEN)];
+    volatile uint8_t sj_busy;
+};
+
+static struct shell_job g_shell_job;
+static struct os_eventq g_shell_job_evq;
+static struct os_task g_shell_job_task;
+static os_stack_t g_shell_job_stack[OS_STACK_ALIGN(MYNEWT_VAL(SHELL_JOB_STACK_SIZE))];
+
+static void
+shell_job_ev(struct os_event *ev)
+{
+    struct shell_job *sj = (struct shell_job *)ev->ev_arg;
+
+    sj->sj_cmd->sc_cmd_func(sj->sj_argc, sj->sj_argv);
+    sj->sj_busy = 0;
+}
+
+/*
+ * Queue cmd for the job task.  argv points into shell_line; relocate
+ * the tokens into the job's own copy of the line.
+ */
+static int
+shell_job_start(struct shell_cmd *sc, int argc, char **argv)
+{
+    struct shell_job *sj = &g_shell_job;
+    int i;
+
+    if (sj->sj_busy) {
+        return -1;
+    }
+    sj->sj_busy = 1;
+
+    memcpy(sj->sj_line, shell_line, sizeof(sj->sj_line));
+    for (i = 0; i < argc; i++) {
+        sj->sj_argv[i] = sj->sj_line + (argv[i] - shell_line);
+    }
+    sj->sj_argv[argc] = NULL;
+    sj->sj_argc = argc;
+    sj->sj_cmd = sc;
+
+    os_eventq_put(&g_shell_job_evq, &sj->sj_ev);
+    return 0;
+}
+
+static void
+shell_job_task_func(void *arg)
+{
+    while (1) {
+        os_eventq_run(&g_shell_job_evq);
+    }
+}
+#endif
+
 static struct os_eventq *
 shell_evq_get(void)
 {
@@ -152,6 +249,17 @@ shell_cmd_register(struct shell_cmd *sc)
 
     STAILQ_INSERT_TAIL(&g_shell_cmd_list, sc, sc_next);
 
+#if MYNEWT_VAL(SHELL_CMD_HASH)
+    {
+        uint32_t idx;
+
+        idx = shell_cmd_hash_fn(sc->sc_cmd) &
+          (MYNEWT_VAL(SHELL_CMD_HASH_SIZE) - 1);
+        sc->sc_hash_next = g_shell_cmd_hash[idx];
+        g_shell_cmd_hash[idx] = sc;
+    }
+#endif
+
     rc = shell_cmd_list_unlock();
     if (rc != 0) {
         goto err;
@@ -173,11 +281,22 @@ shell_cmd(char *cmd, char **argv, int argc)
         goto err;
     }
 
+#if MYNEWT_VAL(SHELL_CMD_HASH)
+    for (sc = g_shell_cmd_hash[shell_cmd_hash_fn(cmd) &
+           (MYNEWT_VAL(SHELL_CMD_HASH_SIZE) - 1)];
+         sc;
+         sc = sc->sc_hash_next) {
+        if (!strcmp(sc->sc_cmd, cmd)) {
+            break;
+        }
+    }
+#else
     STAILQ_FOREACH(sc, &g_shell_cmd_list, sc_next) {
         if (!strcmp(sc->sc_cmd, cmd)) {
             break;
         }
     }
+#endif
 
     rc = shell_cmd_list_unlock();
     if (rc != 0) {
@@ -185,6 +304,16 @@ shell_cmd(char *cmd, char **argv, int argc)
     }
 
     if (sc) {
+#if MYNEWT_VAL(SHELL_JOBS)
+        if (sc->sc_flags & SHELL_CMD_F_ASYNC) {
+            if (shell_job_start(sc, argc, argv) == 0) {
+                return (0);
+            }
+            /*
+             * Job slot busy; fall through and run inline.
+             */
+        }
+#endif
         sc->sc_cmd_func(argc, argv);
     } else {
         console_printf("Unknown command %s\n", cmd);
@@ -527,13 +656,9 @@ shell_help_cmd(int argc, char **argv)
     return (0);
 }
 
-void
-shell_init(void)
+static void
+shell_init_impl(void)
 {
-#if !MYNEWT_VAL(SHELL_TASK)
-    return;
-#endif
-
     int rc;
 
     free(shell_line);
@@ -547,6 +672,16 @@ shell_init(void)
     rc = os_mutex_init(&g_shell_cmd_list_lock);
     SYSINIT_PANIC_ASSERT(rc == 0);
 
+#if MYNEWT_VAL(SHELL_JOBS)
+    g_shell_job.sj_ev.ev_cb = shell_job_ev;
+    g_shell_job.sj_ev.ev_arg = &g_shell_job;
+    os_eventq_init(&g_shell_job_evq);
+    rc = os_task_init(&g_shell_job_task, "shell_job", shell_job_task_func,
+      NULL, MYNEWT_VAL(SHELL_JOB_TASK_PRIO), OS_WAIT_FOREVER,
+      g_shell_job_stack, OS_STACK_ALIGN(MYNEWT_VAL(SHELL_JOB_STACK_SIZE)));
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
     rc = shell_cmd_register(&g_shell_echo_cmd);
     SYSINIT_PANIC_ASSERT(rc == 0);
 
@@ -565,6 +700,38 @@ shell_init(void)
     rc = shell_cmd_register(&g_shell_os_date_cmd);
     SYSINIT_PANIC_ASSERT(rc == 0);
 
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+    rc = shell_cmd_register(&g_shell_os_mempool_trace_cmd);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
+#if MYNEWT_VAL(SYSINIT_TIMING)
+    rc = shell_cmd_register(&g_shell_sysinit_cmd);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
     os_mqueue_init(&g_shell_nlip_mq, shell_event_data_in, NULL);
     console_init(shell_console_rx_cb);
 }
+
+void
+shell_init(void)
+{
+#if !MYNEWT_VAL(SHELL_TASK)
+    return;
+#endif
+
+#if MYNEWT_VAL(SHELL_DEFER_INIT)
+    int rc;
+
+    /*
+     * The shell is not on the startup critical path; park its init
+     * behind the app-ready barrier so radio-up latency is not paid
+     * for command registration and console setup.
+     */
+    rc = sysinit_defer(shell_init_impl);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#else
+    shell_init_impl();
+#endif
+}
@@ -24,6 +24,7 @@
 
 #include "console/console.h"
 #include "shell/shell.h"
+#include "sysinit/sysinit.h"
 #include "shell_priv.h"
 
 #include <assert.h>
@@ -47,9 +48,15 @@ shell_os_tasks_display_cmd(int argc, char **argv)
 
     console_printf("Tasks: \n");
     prev_task = NULL;
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+    console_printf("%8s %3s %3s %8s %8s %8s %8s %8s %8s %3s %10s %8s\n",
+      "task", "pri", "tid", "runtime", "csw", "stksz", "stkuse",
+      "lcheck", "ncheck", "flg", "cputime", "maxlat");
+#else
     console_printf("%8s %3s %3s %8s %8s %8s %8s %8s %8s %3s\n",
       "task", "pri", "tid", "runtime", "csw", "stksz", "stkuse",
       "lcheck", "ncheck", "flg");
+#endif
     while (1) {
         prev_task = os_task_info_get_next(prev_task, &oti);
         if (prev_task == NULL) {
@@ -64,12 +71,24 @@ shell_os_tasks_display_cmd(int argc, char **argv)
             }
         }
 
+#if MYNEWT_VAL(OS_TASK_CPUTIME)
+        console_printf("%8s %3u %3u %8lu %8lu %8u %8u %8lu %8lu %3x "
+                "%10lu %8lu\n",
+                oti.oti_name, oti.oti_prio, oti.oti_taskid,
+                (unsigned long)oti.oti_runtime, (unsigned long)oti.oti_cswcnt,
+                oti.oti_stksize, oti.oti_stkusage,
+                (unsigned long)oti.oti_last_checkin,
+                (unsigned long)oti.oti_next_checkin, oti.oti_flags,
+                (unsigned long)oti.oti_cputime,
+                (unsigned long)oti.oti_max_sched_latency);
+#else
         console_printf("%8s %3u %3u %8lu %8lu %8u %8u %8lu %8lu %3x\n",
                 oti.oti_name, oti.oti_prio, oti.oti_taskid,
                 (unsigned long)oti.oti_runtime, (unsigned long)oti.oti_cswcnt,
                 oti.oti_stksize, oti.oti_stkusage,
                 (unsigned long)oti.oti_last_checkin,
                 (unsigned long)oti.oti_next_checkin, oti.oti_flags);
+#endif
 
     }
 
@@ -111,9 +130,10 @@ shell_os_mpool_display_cmd(int argc, char **argv)
             }
         }
 
-        console_printf("  %s (blksize: %d, nblocks: %d, nfree: %d)\n",
+        console_printf("  %s (blksize: %d, nblocks: %d, nfree: %d, "
+                "minfree: %d)\n",
                 omi.omi_name, omi.omi_block_size, omi.omi_num_blocks,
-                omi.omi_num_free);
+                omi.omi_num_free, omi.omi_min_free);
     }
 
     if (name && !found) {
@@ -124,6 +144,83 @@ shell_os_mpool_display_cmd(int argc, char **argv)
     return (0);
 }
 
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+
+#define SHELL_MEMPOOL_TRACE_MAX_OWNERS  32
+
+struct shell_mempool_trace_owner {
+    const struct os_mempool *smto_pool;
+    uintptr_t smto_pc;
+    uint32_t smto_count;
+};
+
+struct shell_mempool_trace_ctx {
+    struct shell_mempool_trace_owner owners[SHELL_MEMPOOL_TRACE_MAX_OWNERS];
+    int num_owners;
+    int truncated;
+};
+
+static int
+shell_os_mempool_trace_walk(const struct os_mempool_trace_entry *omt,
+                            void *arg)
+{
+    struct shell_mempool_trace_ctx *ctx;
+    int i;
+
+    ctx = arg;
+    for (i = 0; i < ctx->num_owners; i++) {
+        if (ctx->owners[i].smto_pool == omt->omt_pool &&
+            ctx->owners[i].smto_pc == omt->omt_pc) {
+
+            ctx->owners[i].smto_count++;
+            return 0;
+        }
+    }
+
+    if (ctx->num_owners >= SHELL_MEMPOOL_TRACE_MAX_OWNERS) {
+        ctx->truncated = 1;
+        return 0;
+    }
+
+    ctx->owners[ctx->num_owners].smto_pool = omt->omt_pool;
+    ctx->owners[ctx->num_owners].smto_pc = omt->omt_pc;
+    ctx->owners[ctx->num_owners].smto_count = 1;
+    ctx->num_owners++;
+
+    return 0;
+}
+
+int
+shell_os_mempool_trace_cmd(int argc, char **argv)
+{
+    static struct shell_mempool_trace_ctx ctx;
+    uint32_t overflows;
+    int i;
+
+    memset(&ctx, 0, sizeof(ctx));
+    os_mempool_trace_walk(shell_os_mempool_trace_walk, &ctx);
+
+    console_printf("Outstanding blocks by owner:\n");
+    console_printf("%16s %10s %6s\n", "pool", "pc", "count");
+    for (i = 0; i < ctx.num_owners; i++) {
+        console_printf("%16s 0x%08lx %6lu\n", ctx.owners[i].smto_pool->name,
+                (unsigned long)ctx.owners[i].smto_pc,
+                (unsigned long)ctx.owners[i].smto_count);
+    }
+    if (ctx.truncated) {
+        console_printf("(more owners than %d; output truncated)\n",
+                SHELL_MEMPOOL_TRACE_MAX_OWNERS);
+    }
+    overflows = os_mempool_trace_overflows();
+    if (overflows != 0) {
+        console_printf("untracked allocations: %lu\n",
+                (unsigned long)overflows);
+    }
+
+    return (0);
+}
+#endif
+
 int
 shell_os_date_cmd(int argc, char **argv)
 {
@@ -155,3 +252,22 @@ shell_os_date_cmd(int argc, char **argv)
 
     return (rc);
 }
+
+#if MYNEWT_VAL(SYSINIT_TIMING)
+int
+shell_sysinit_timing_cmd(int argc, char **argv)
+{
+    const struct sysinit_timing_entry *entries;
+    int cnt;
+    int i;
+
+    cnt = sysinit_timing_get(&entries);
+    console_printf("%24s %10s\n", "step", "cputime");
+    for (i = 0; i < cnt; i++) {
+        console_printf("%24s %10lu\n", entries[i].ste_name,
+          (unsigned long)entries[i].ste_ticks);
+    }
+
+    return (0);
+}
+#endif
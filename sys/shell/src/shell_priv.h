@@ -26,7 +26,13 @@ extern "C" {
 
 int shell_os_tasks_display_cmd(int argc, char **argv);
 int shell_os_mpool_display_cmd(int argc, char **argv);
+#if MYNEWT_VAL(OS_MEMPOOL_TRACE)
+int shell_os_mempool_trace_cmd(int argc, char **argv);
+#endif
 int shell_os_date_cmd(int argc, char **argv);
+#if MYNEWT_VAL(SYSINIT_TIMING)
+int shell_sysinit_timing_cmd(int argc, char **argv);
+#endif
 
 #ifdef __cplusplus
 }
@@ -71,15 +71,72 @@ STATS_SECT_DECL(__name) {                   \
     (__size),                                                               \
     ((sizeof (__sectvarname)) - sizeof (struct stats_hdr)) / (__size)
 
+#if MYNEWT_VAL(STATS_ATOMIC)
+
+/*
+ * Lock-free statistics updates.  The increments are single atomic
+ * read-modify-write operations, so counters shared between ISRs and tasks
+ * stay correct without masking interrupts around every STATS_INC.
+ *
+ * 64-bit entries are incremented as two 32-bit halves with a manual carry,
+ * since 8-byte atomics are not lock-free on 32-bit MCUs.  A reader can
+ * transiently observe the low word wrapped before the carry lands; the
+ * counter itself never loses updates.
+ */
+typedef uint32_t stats_word_t __attribute__((may_alias));
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define STATS_WORD_LO   1
+#define STATS_WORD_HI   0
+#else
+#define STATS_WORD_LO   0
+#define STATS_WORD_HI   1
+#endif
+
+#define STATS_INC(__sectvarname, __var)                                     \
+    ((void)__atomic_fetch_add(&(__sectvarname).STATS_SECT_VAR(__var), 1,    \
+                              __ATOMIC_RELAXED))
+
+#define STATS_INCN(__sectvarname, __var, __n)                               \
+    ((void)__atomic_fetch_add(&(__sectvarname).STATS_SECT_VAR(__var),       \
+                              (__n), __ATOMIC_RELAXED))
+
+#define STATS_INCN64(__sectvarname, __var, __n) do {                        \
+    stats_word_t *__sw =                                                    \
+        (stats_word_t *)&(__sectvarname).STATS_SECT_VAR(__var);             \
+    uint32_t __so = __atomic_fetch_add(&__sw[STATS_WORD_LO],                \
+                                       (uint32_t)(__n), __ATOMIC_RELAXED);  \
+    if ((uint32_t)(__so + (uint32_t)(__n)) < __so) {                        \
+        __atomic_fetch_add(&__sw[STATS_WORD_HI], 1, __ATOMIC_RELAXED);      \
+    }                                                                       \
+} while (0)
+
+#define STATS_CLEAR(__sectvarname, __var)                                   \
+    ((void)__atomic_store_n(&(__sectvarname).STATS_SECT_VAR(__var), 0,      \
+                            __ATOMIC_RELAXED))
+
+#else /* MYNEWT_VAL(STATS_ATOMIC) */
+
 #define STATS_INC(__sectvarname, __var)        \
     ((__sectvarname).STATS_SECT_VAR(__var)++)
 
 #define STATS_INCN(__sectvarname, __var, __n)  \
     ((__sectvarname).STATS_SECT_VAR(__var) += (__n))
 
+#define STATS_INCN64(__sectvarname, __var, __n)  \
+    ((__sectvarname).STATS_SECT_VAR(__var) += (__n))
+
 #define STATS_CLEAR(__sectvarname, __var)        \
     ((__sectvarname).STATS_SECT_VAR(__var) = 0)
 
+#endif /* MYNEWT_VAL(STATS_ATOMIC) */
+
+/* 64-bit counters (STATS_SECT_ENTRY64) for values that wrap 32 bits, e.g.
+ * byte counts; with STATS_ATOMIC these remain lock-free on 32-bit MCUs.
+ */
+#define STATS_INC64(__sectvarname, __var) \
+    STATS_INCN64(__sectvarname, __var, 1)
+
 #if MYNEWT_VAL(STATS_NAMES)
 
 #define STATS_NAME_MAP_NAME(__sectname) g_stats_map_ ## __sectname
@@ -27,6 +27,7 @@
 #include "os/os.h"
 #include "mgmt/mgmt.h"
 #include "cborattr/cborattr.h"
+#include "tinycbor/cbor_skeleton.h"
 #include "stats/stats.h"
 
 /* Source code is only included if the newtmgr library is enabled.  Otherwise
@@ -34,20 +35,46 @@
  */
 static int stats_nmgr_read(struct mgmt_cbuf *cb);
 static int stats_nmgr_list(struct mgmt_cbuf *cb);
+#if MYNEWT_VAL(STATS_NEWTMGR_BULK)
+static int stats_nmgr_bulk(struct mgmt_cbuf *cb);
+#endif
 
 static struct mgmt_group shell_nmgr_group;
 
+/* Precompiled skeleton of the read response map; its keys are the same
+ * for every request, so their encoded bytes are computed once at
+ * register time and spliced per response.
+ */
+static const char * const stats_nmgr_rsp_keys[] = {
+    "rc", "name", "group", "fields"
+};
+static struct cbor_skeleton stats_nmgr_rsp_skel;
+static uint8_t stats_nmgr_rsp_skel_buf[24];
+
 #define STATS_NMGR_ID_READ  (0)
 #define STATS_NMGR_ID_LIST  (1)
+#define STATS_NMGR_ID_BULK  (2)
 
 /* ORDER MATTERS HERE.
  * Each element represents the command ID, referenced from newtmgr.
  */
 static struct mgmt_handler shell_nmgr_group_handlers[] = {
     [STATS_NMGR_ID_READ] = {stats_nmgr_read, stats_nmgr_read},
-    [STATS_NMGR_ID_LIST] = {stats_nmgr_list, stats_nmgr_list}
+    [STATS_NMGR_ID_LIST] = {stats_nmgr_list, stats_nmgr_list},
+#if MYNEWT_VAL(STATS_NEWTMGR_BULK)
+    [STATS_NMGR_ID_BULK] = {stats_nmgr_bulk, stats_nmgr_bulk}
+#endif
 };
 
+#if MYNEWT_VAL(STATS_NEWTMGR_BULK)
+/* Snapshot of every registered counter, laid out as the concatenation of
+ * the groups in registration order.  Used to compute delta responses.
+ */
+static uint8_t *stats_nmgr_snap;
+static uint32_t stats_nmgr_snap_len;
+static uint32_t stats_nmgr_seq;
+#endif
+
 static int
 stats_nmgr_walk_func(struct stats_hdr *hdr, void *arg, char *sname,
         uint16_t stat_off)
@@ -110,17 +137,16 @@ stats_nmgr_read(struct mgmt_cbuf *cb)
         goto err;
     }
 
-    g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
-    g_err |= cbor_encode_text_stringz(&rsp, "rc");
+    g_err |= cbor_skeleton_begin(penc, &rsp, &stats_nmgr_rsp_skel);
     g_err |= cbor_encode_int(&rsp, MGMT_ERR_EOK);
 
-    g_err |= cbor_encode_text_stringz(&rsp, "name");
+    g_err |= cbor_skeleton_key(&rsp, &stats_nmgr_rsp_skel, 1);
     g_err |= cbor_encode_text_stringz(&rsp, stats_name);
 
-    g_err |= cbor_encode_text_stringz(&rsp, "group");
+    g_err |= cbor_skeleton_key(&rsp, &stats_nmgr_rsp_skel, 2);
     g_err |= cbor_encode_text_string(&rsp, "sys", sizeof("sys")-1);
 
-    g_err |= cbor_encode_text_stringz(&rsp, "fields");
+    g_err |= cbor_skeleton_key(&rsp, &stats_nmgr_rsp_skel, 3);
 
     g_err |= cbor_encoder_create_map(&rsp, &stats, CborIndefiniteLength);
 
@@ -139,6 +165,137 @@ err:
     return (0);
 }
 
+#if MYNEWT_VAL(STATS_NEWTMGR_BULK)
+
+struct stats_nmgr_bulk_arg {
+    CborEncoder *snba_groups;   /* "groups" container */
+    CborEncoder *snba_group;    /* map of the group being encoded */
+    uint8_t *snba_snap;         /* cursor into the counter snapshot */
+    int snba_delta;             /* encode only counters that changed */
+    CborError snba_err;
+};
+
+static int
+stats_nmgr_bulk_size_func(struct stats_hdr *hdr, void *arg)
+{
+    *(uint32_t *) arg += hdr->s_size * hdr->s_cnt;
+
+    return (0);
+}
+
+static int
+stats_nmgr_bulk_walk_func(struct stats_hdr *hdr, void *arg, char *sname,
+        uint16_t stat_off)
+{
+    struct stats_nmgr_bulk_arg *snba = (struct stats_nmgr_bulk_arg *) arg;
+    void *stat_val;
+    uint8_t *snap;
+
+    stat_val = (uint8_t *)hdr + stat_off;
+    snap = snba->snba_snap;
+    snba->snba_snap += hdr->s_size;
+
+    if (snba->snba_delta && !memcmp(snap, stat_val, hdr->s_size)) {
+        return (0);
+    }
+    memcpy(snap, stat_val, hdr->s_size);
+
+    snba->snba_err |= stats_nmgr_walk_func(hdr, snba->snba_group, sname,
+                                           stat_off);
+    return (0);
+}
+
+static int
+stats_nmgr_bulk_group_func(struct stats_hdr *hdr, void *arg)
+{
+    struct stats_nmgr_bulk_arg *snba = (struct stats_nmgr_bulk_arg *) arg;
+    CborEncoder group;
+
+    snba->snba_err |= cbor_encode_text_stringz(snba->snba_groups,
+                                               hdr->s_name);
+    snba->snba_err |= cbor_encoder_create_map(snba->snba_groups, &group,
+                                              CborIndefiniteLength);
+    snba->snba_group = &group;
+    stats_walk(hdr, stats_nmgr_bulk_walk_func, snba);
+    snba->snba_err |= cbor_encoder_close_container(snba->snba_groups, &group);
+
+    return (0);
+}
+
+/**
+ * Snapshot all registered stat groups in a single response.  If the
+ * request echoes the sequence number from the previous response, only
+ * counters that changed since then are encoded.  An absent or stale
+ * sequence number yields a full dump.
+ */
+static int
+stats_nmgr_bulk(struct mgmt_cbuf *cb)
+{
+    struct stats_nmgr_bulk_arg snba;
+    long long unsigned int seq;
+    uint32_t snap_len;
+    int delta;
+    struct cbor_attr_t attrs[] = {
+        { "seq", CborAttrUnsignedIntegerType, .addr.uinteger = &seq,
+            .nodefault = true },
+        { NULL },
+    };
+    CborError g_err = CborNoError;
+    CborEncoder *penc = &cb->encoder;
+    CborEncoder rsp, groups;
+
+    /* Pre-load a mismatching value; an absent "seq" requests a full dump. */
+    seq = stats_nmgr_seq + 1;
+    if (cbor_read_object(&cb->it, attrs) != 0) {
+        mgmt_cbuf_setoerr(cb, MGMT_ERR_EINVAL);
+        return (0);
+    }
+
+    snap_len = 0;
+    stats_group_walk(stats_nmgr_bulk_size_func, &snap_len);
+
+    delta = (stats_nmgr_snap != NULL && snap_len == stats_nmgr_snap_len &&
+             seq == stats_nmgr_seq);
+    if (stats_nmgr_snap == NULL || snap_len != stats_nmgr_snap_len) {
+        /* First request, or a group registered since the last one. */
+        os_free(stats_nmgr_snap);
+        stats_nmgr_snap = os_malloc(snap_len);
+        stats_nmgr_snap_len = snap_len;
+        if (stats_nmgr_snap == NULL) {
+            stats_nmgr_snap_len = 0;
+            return (MGMT_ERR_ENOMEM);
+        }
+    }
+
+    stats_nmgr_seq++;
+
+    g_err |= cbor_encoder_create_map(penc, &rsp, CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&rsp, "rc");
+    g_err |= cbor_encode_int(&rsp, MGMT_ERR_EOK);
+    g_err |= cbor_encode_text_stringz(&rsp, "seq");
+    g_err |= cbor_encode_uint(&rsp, stats_nmgr_seq);
+    g_err |= cbor_encode_text_stringz(&rsp, "groups");
+    g_err |= cbor_encoder_create_map(&rsp, &groups, CborIndefiniteLength);
+
+    snba.snba_groups = &groups;
+    snba.snba_group = NULL;
+    snba.snba_snap = stats_nmgr_snap;
+    snba.snba_delta = delta;
+    snba.snba_err = CborNoError;
+    stats_group_walk(stats_nmgr_bulk_group_func, &snba);
+    g_err |= snba.snba_err;
+
+    g_err |= cbor_encoder_close_container(&rsp, &groups);
+    g_err |= cbor_encoder_close_container(penc, &rsp);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return (0);
+}
+
+#endif /* MYNEWT_VAL(STATS_NEWTMGR_BULK) */
+
 static int
 stats_nmgr_list(struct mgmt_cbuf *cb)
 {
@@ -172,6 +329,15 @@ stats_nmgr_register_group(void)
     MGMT_GROUP_SET_HANDLERS(&shell_nmgr_group, shell_nmgr_group_handlers);
     shell_nmgr_group.mg_group_id = MGMT_GROUP_ID_STATS;
 
+    rc = cbor_skeleton_build(&stats_nmgr_rsp_skel, stats_nmgr_rsp_skel_buf,
+                             sizeof(stats_nmgr_rsp_skel_buf),
+                             stats_nmgr_rsp_keys,
+                             sizeof(stats_nmgr_rsp_keys) /
+                             sizeof(stats_nmgr_rsp_keys[0]));
+    if (rc != 0) {
+        goto err;
+    }
+
     rc = mgmt_group_register(&shell_nmgr_group);
     if (rc != 0) {
         goto err;
@@ -48,6 +48,82 @@ void MYNEWT_VAL(SYSINIT_PANIC_FN)(const char *file, int line);
     }                               \
 } while (0)
 
+#if MYNEWT_VAL(SYSINIT_TIMING)
+#include <inttypes.h>
+
+/** Time attributed to one initialization step. */
+struct sysinit_timing_entry {
+    const char *ste_name;
+    uint32_t ste_ticks;     /* os_cputime ticks since the previous mark */
+};
+
+/* Restart timing capture; typically the first statement of main() */
+void sysinit_timing_reset(void);
+/*
+ * Close out the step named 'name': records the cputime spent since
+ * the previous mark (or reset).  'name' must point at storage that
+ * outlives the table, e.g. a string literal.
+ */
+void sysinit_timing_mark(const char *name);
+/* Fetch the retained table; returns the number of entries */
+int sysinit_timing_get(const struct sysinit_timing_entry **entries);
+
+#define SYSINIT_TIMING_RESET()      sysinit_timing_reset()
+#define SYSINIT_TIMING_MARK(name)   sysinit_timing_mark(name)
+#else
+#define SYSINIT_TIMING_RESET()
+#define SYSINIT_TIMING_MARK(name)
+#endif
+
+/*
+ * Deferred initialization barrier.  An init function whose service is
+ * not on the application's critical startup path hands its real work
+ * to sysinit_defer(); the application calls sysinit_app_ready() once
+ * its latency-critical services are up, which runs the deferred
+ * functions in registration order.  Functions deferred after the
+ * barrier has been released run immediately.
+ */
+typedef void sysinit_deferred_fn(void);
+
+int sysinit_defer(sysinit_deferred_fn *fn);
+void sysinit_app_ready(void);
+int sysinit_app_is_ready(void);
+
+/*
+ * Split-phase initialization.  An init function whose hardware needs
+ * wall-clock time to become ready (flash identification, radio
+ * calibration, oscillator ramp) starts the operation and returns; the
+ * finish function, which waits for and completes it, runs when the
+ * first dependent package joins.  Init functions between start and
+ * join overlap the hardware's ramp, so cold boot approaches the
+ * critical-path time instead of the serial sum; ordering is strict
+ * only where a join declares it.
+ */
+typedef void sysinit_async_fn(void);
+
+struct sysinit_async {
+    sysinit_async_fn *sa_finish;
+    const char *sa_name;
+    uint8_t sa_state;
+};
+
+/*
+ * Run 'start' now and park 'finish' in 'sa'.  Returns -1 when the
+ * pending-async table is full, in which case both phases have run
+ * before return and joins are no-ops.
+ */
+int sysinit_async_start(struct sysinit_async *sa, sysinit_async_fn *start,
+                        sysinit_async_fn *finish, const char *name);
+
+/*
+ * Declare a dependency on 'sa': runs its finish function if it has not
+ * run yet.  Joining an idle or already-joined async is a no-op.
+ */
+void sysinit_async_join(struct sysinit_async *sa);
+
+/* Join every async still pending, in start order. */
+void sysinit_async_join_all(void);
+
 
 #if MYNEWT_VAL(SPLIT_LOADER)
 
@@ -0,0 +1,208 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+
+#if MYNEWT_VAL(SYSINIT_TIMING)
+
+#include "os/os_cputime.h"
+
+static struct sysinit_timing_entry
+    sysinit_timing_entries[MYNEWT_VAL(SYSINIT_TIMING_MAX_ENTRIES)];
+static int sysinit_timing_cnt;
+static uint32_t sysinit_timing_prev;
+
+void
+sysinit_timing_reset(void)
+{
+    sysinit_timing_cnt = 0;
+    sysinit_timing_prev = os_cputime_get32();
+}
+
+void
+sysinit_timing_mark(const char *name)
+{
+    struct sysinit_timing_entry *entry;
+    uint32_t now;
+
+    now = os_cputime_get32();
+    if (sysinit_timing_cnt < MYNEWT_VAL(SYSINIT_TIMING_MAX_ENTRIES)) {
+        entry = &sysinit_timing_entries[sysinit_timing_cnt++];
+        entry->ste_name = name;
+        entry->ste_ticks = now - sysinit_timing_prev;
+    }
+    sysinit_timing_prev = now;
+}
+
+int
+sysinit_timing_get(const struct sysinit_timing_entry **entries)
+{
+    *entries = sysinit_timing_entries;
+    return sysinit_timing_cnt;
+}
+
+#endif /* MYNEWT_VAL(SYSINIT_TIMING) */
+
+/*
+ * Deferred initialization.  Packages whose services are not needed
+ * for the application's critical startup path (log shipping, shell)
+ * register their real init work here from their init function; the
+ * application releases the barrier with sysinit_app_ready() once its
+ * latency-critical services (e.g. advertising) are up.
+ */
+
+#if MYNEWT_VAL(SYSINIT_DEFER_WORKQ)
+#include "os/os_workq.h"
+#endif
+
+static sysinit_deferred_fn *sysinit_deferred_fns[MYNEWT_VAL(SYSINIT_DEFER_MAX)];
+static int sysinit_deferred_cnt;
+static uint8_t sysinit_app_ready_flag;
+
+/*
+ * Split-phase initialization.  Asyncs in flight are tracked so that
+ * join_all can settle whatever no dependent package claimed; the
+ * sysinit_async structures themselves live in the owning packages.
+ */
+#define SYSINIT_ASYNC_IDLE      0
+#define SYSINIT_ASYNC_STARTED   1
+#define SYSINIT_ASYNC_DONE      2
+
+static struct sysinit_async *sysinit_asyncs[MYNEWT_VAL(SYSINIT_ASYNC_MAX)];
+static int sysinit_async_cnt;
+
+int
+sysinit_async_start(struct sysinit_async *sa, sysinit_async_fn *start,
+                    sysinit_async_fn *finish, const char *name)
+{
+    sa->sa_finish = finish;
+    sa->sa_name = name;
+
+    if (sysinit_async_cnt >= MYNEWT_VAL(SYSINIT_ASYNC_MAX)) {
+        /* no room to park the finish phase; run serially as before */
+        sa->sa_state = SYSINIT_ASYNC_DONE;
+        start();
+        finish();
+#if MYNEWT_VAL(SYSINIT_TIMING)
+        sysinit_timing_mark(name);
+#endif
+        return -1;
+    }
+    sysinit_asyncs[sysinit_async_cnt++] = sa;
+    sa->sa_state = SYSINIT_ASYNC_STARTED;
+    start();
+    return 0;
+}
+
+void
+sysinit_async_join(struct sysinit_async *sa)
+{
+    if (sa->sa_state != SYSINIT_ASYNC_STARTED) {
+        return;
+    }
+    sa->sa_state = SYSINIT_ASYNC_DONE;
+    sa->sa_finish();
+#if MYNEWT_VAL(SYSINIT_TIMING)
+    sysinit_timing_mark(sa->sa_name);
+#endif
+}
+
+void
+sysinit_async_join_all(void)
+{
+    int i;
+
+    for (i = 0; i < sysinit_async_cnt; i++) {
+        sysinit_async_join(sysinit_asyncs[i]);
+    }
+    sysinit_async_cnt = 0;
+}
+
+int
+sysinit_defer(sysinit_deferred_fn *fn)
+{
+    if (sysinit_app_ready_flag) {
+        /* Barrier already released; run at once */
+        fn();
+        return 0;
+    }
+    if (sysinit_deferred_cnt >= MYNEWT_VAL(SYSINIT_DEFER_MAX)) {
+        return -1;
+    }
+    sysinit_deferred_fns[sysinit_deferred_cnt++] = fn;
+    return 0;
+}
+
+#if MYNEWT_VAL(SYSINIT_DEFER_WORKQ)
+static void
+sysinit_defer_workq_ev(struct os_event *ev)
+{
+    sysinit_deferred_fn *fn;
+
+    fn = (sysinit_deferred_fn *)ev->ev_arg;
+    fn();
+#if MYNEWT_VAL(SYSINIT_TIMING)
+    sysinit_timing_mark("deferred");
+#endif
+}
+
+static struct os_event
+    sysinit_defer_workq_evs[MYNEWT_VAL(SYSINIT_DEFER_MAX)];
+#endif
+
+void
+sysinit_app_ready(void)
+{
+    int i;
+
+    if (sysinit_app_ready_flag) {
+        return;
+    }
+    sysinit_app_ready_flag = 1;
+
+    /* any async nobody depended on completes before services start */
+    sysinit_async_join_all();
+
+    /* Registration order is sysinit stage order; preserve it */
+    for (i = 0; i < sysinit_deferred_cnt; i++) {
+#if MYNEWT_VAL(SYSINIT_DEFER_WORKQ)
+        /*
+         * Run behind whatever latency-critical work shares the queue;
+         * lane FIFO order preserves registration order.
+         */
+        sysinit_defer_workq_evs[i].ev_cb = sysinit_defer_workq_ev;
+        sysinit_defer_workq_evs[i].ev_arg = sysinit_deferred_fns[i];
+        os_workq_put(MYNEWT_VAL(SYSINIT_DEFER_WORKQ_LANE),
+                     &sysinit_defer_workq_evs[i]);
+#else
+        sysinit_deferred_fns[i]();
+#if MYNEWT_VAL(SYSINIT_TIMING)
+        sysinit_timing_mark("deferred");
+#endif
+#endif
+    }
+    sysinit_deferred_cnt = 0;
+}
+
+int
+sysinit_app_is_ready(void)
+{
+    return sysinit_app_ready_flag;
+}
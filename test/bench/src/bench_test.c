@@ -0,0 +1,50 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench_test.h"
+#include "os/os_cputime.h"
+
+BENCH_CASE_DECL(bench_mempool_get_put)
+BENCH_CASE_DECL(bench_mbuf_append_copydata)
+BENCH_CASE_DECL(bench_crc16_ccitt)
+BENCH_CASE_DECL(bench_cbor_parse)
+
+BENCH_SUITE(bench_suite)
+{
+    bench_mempool_get_put();
+    bench_mbuf_append_copydata();
+    bench_crc16_ccitt();
+    bench_cbor_parse();
+}
+
+#if MYNEWT_VAL(SELFTEST)
+
+int
+main(int argc, char **argv)
+{
+    ts_config.ts_print_results = 1;
+    tu_init();
+
+    os_cputime_init(MYNEWT_VAL(OS_CPUTIME_FREQ));
+
+    bench_suite();
+
+    return tu_any_failed;
+}
+
+#endif
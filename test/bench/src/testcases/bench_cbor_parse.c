@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "tinycbor/cbor.h"
+#include "tinycbor/cbor_buf_reader.h"
+#include "bench_test.h"
+
+/* {"name": "x", "value": 42} */
+static const uint8_t bench_cbor_msg[] = {
+    0xa2,
+    0x64, 'n', 'a', 'm', 'e',
+    0x61, 'x',
+    0x65, 'v', 'a', 'l', 'u', 'e',
+    0x18, 0x2a,
+};
+
+/* Parse and walk a small map, the shape of every newtmgr/oic request */
+BENCH_CASE(bench_cbor_parse)
+{
+    struct cbor_buf_reader reader;
+    CborParser parser;
+    CborValue value;
+    CborValue elem;
+    CborError err;
+    uint32_t i;
+
+    for (i = 0; i < bench_niter; i++) {
+        cbor_buf_reader_init(&reader, bench_cbor_msg,
+                             sizeof(bench_cbor_msg));
+        err = cbor_parser_init(&reader.r, 0, &parser, &value);
+        assert(err == CborNoError);
+        assert(cbor_value_is_map(&value));
+        err = cbor_value_enter_container(&value, &elem);
+        assert(err == CborNoError);
+        while (cbor_value_is_valid(&elem)) {
+            err = cbor_value_advance(&elem);
+            assert(err == CborNoError);
+        }
+    }
+}
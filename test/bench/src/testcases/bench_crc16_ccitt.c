@@ -0,0 +1,39 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "crc/crc16.h"
+#include "bench_test.h"
+
+#define BENCH_CRC16_BUF_SIZE    256
+
+/* A flash-page-sized crc, the unit nffs and fcb checksum at a time */
+BENCH_CASE(bench_crc16_ccitt)
+{
+    static uint8_t buf[BENCH_CRC16_BUF_SIZE];
+    volatile uint16_t crc;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = i;
+    }
+
+    for (i = 0; i < bench_niter; i++) {
+        crc = crc16_ccitt(CRC16_INITIAL_CRC, buf, sizeof(buf));
+    }
+    (void)crc;
+}
@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench_test.h"
+
+#define BENCH_MBUF_NBUFS        8
+#define BENCH_MBUF_BUF_SIZE     (sizeof(struct os_mbuf) + 128)
+#define BENCH_MBUF_DATA_LEN     64
+
+static struct os_mempool bench_mbuf_mempool;
+static struct os_mbuf_pool bench_mbuf_pool;
+static os_membuf_t bench_mbuf_data[
+    OS_MEMPOOL_SIZE(BENCH_MBUF_NBUFS, BENCH_MBUF_BUF_SIZE)];
+static int bench_mbuf_inited;
+
+/* Alloc, append a payload, copy it back out, free: the rx/tx round trip */
+BENCH_CASE(bench_mbuf_append_copydata)
+{
+    uint8_t payload[BENCH_MBUF_DATA_LEN];
+    uint8_t out[BENCH_MBUF_DATA_LEN];
+    struct os_mbuf *om;
+    uint32_t i;
+    int rc;
+
+    if (!bench_mbuf_inited) {
+        rc = os_mempool_init(&bench_mbuf_mempool, BENCH_MBUF_NBUFS,
+                             BENCH_MBUF_BUF_SIZE, bench_mbuf_data,
+                             "bench_mbuf");
+        assert(rc == OS_OK);
+        rc = os_mbuf_pool_init(&bench_mbuf_pool, &bench_mbuf_mempool,
+                               BENCH_MBUF_BUF_SIZE, BENCH_MBUF_NBUFS);
+        assert(rc == 0);
+        bench_mbuf_inited = 1;
+    }
+
+    memset(payload, 0xa5, sizeof(payload));
+
+    for (i = 0; i < bench_niter; i++) {
+        om = os_mbuf_get(&bench_mbuf_pool, 0);
+        assert(om != NULL);
+        rc = os_mbuf_append(om, payload, sizeof(payload));
+        assert(rc == 0);
+        rc = os_mbuf_copydata(om, 0, sizeof(out), out);
+        assert(rc == 0);
+        os_mbuf_free_chain(om);
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench_test.h"
+
+#define BENCH_MEMPOOL_NBLOCKS       16
+#define BENCH_MEMPOOL_BLOCK_SIZE    32
+
+static struct os_mempool bench_mempool;
+static os_membuf_t bench_mempool_data[
+    OS_MEMPOOL_SIZE(BENCH_MEMPOOL_NBLOCKS, BENCH_MEMPOOL_BLOCK_SIZE)];
+static int bench_mempool_inited;
+
+/* The alloc/free pair every pool consumer pays, per packet or event */
+BENCH_CASE(bench_mempool_get_put)
+{
+    uint32_t i;
+    void *block;
+    int rc;
+
+    if (!bench_mempool_inited) {
+        rc = os_mempool_init(&bench_mempool, BENCH_MEMPOOL_NBLOCKS,
+                             BENCH_MEMPOOL_BLOCK_SIZE, bench_mempool_data,
+                             "bench_pool");
+        assert(rc == OS_OK);
+        bench_mempool_inited = 1;
+    }
+
+    for (i = 0; i < bench_niter; i++) {
+        block = os_memblock_get(&bench_mempool);
+        os_memblock_put(&bench_mempool, block);
+    }
+}
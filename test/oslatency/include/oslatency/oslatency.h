@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __OSLATENCY_H__
+#define __OSLATENCY_H__
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Scheduler wakeup latency and jitter harness.
+ *
+ * Measures actual-vs-requested wakeup time of os_time_delay() and
+ * os_callout with os_cputime while calibrated loads run in the
+ * background: spinning tasks filling the ready queue, callouts
+ * hammering the tick handler, and an optional hal_timer ISR storm.
+ * Intended to qualify a BSP/MCU port's tick and context switch path
+ * before deployment; run it from a task with a priority above the
+ * configured load task priority.
+ */
+
+/** One load/measurement configuration. */
+struct oslatency_cfg {
+    /** Number of spinning load tasks (up to OSLATENCY_MAX_BUSY_TASKS). */
+    uint8_t olc_busy_tasks;
+
+    /** Number of self-rearming load callouts (up to OSLATENCY_MAX_CALLOUTS). */
+    uint8_t olc_callouts;
+
+    /** ISR storm period in microseconds; 0 disables the storm. */
+    uint32_t olc_isr_usecs;
+
+    /** Number of wakeups to measure (up to OSLATENCY_MAX_SAMPLES). */
+    uint16_t olc_samples;
+
+    /** Requested sleep per sample, in os time ticks. */
+    uint8_t olc_delay_ticks;
+};
+
+/** Jitter summary; all values are actual minus requested, microseconds. */
+struct oslatency_result {
+    uint16_t olr_samples;
+    int32_t olr_min_us;
+    int32_t olr_p50_us;
+    int32_t olr_p90_us;
+    int32_t olr_p99_us;
+    int32_t olr_max_us;
+};
+
+/**
+ * Measures os_time_delay() wakeup jitter under the specified load.
+ * Blocks for roughly olc_samples * olc_delay_ticks ticks.
+ *
+ * @return                      0 on success; nonzero on invalid config.
+ */
+int oslatency_delay_run(const struct oslatency_cfg *cfg,
+                        struct oslatency_result *res);
+
+/**
+ * Measures os_callout expiry jitter under the specified load.  The
+ * callout is serviced from a private event queue drained by the
+ * calling task, so the figure includes event queue dispatch.
+ *
+ * @return                      0 on success; nonzero on invalid config.
+ */
+int oslatency_callout_run(const struct oslatency_cfg *cfg,
+                          struct oslatency_result *res);
+
+void oslatency_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSLATENCY_H__ */
@@ -0,0 +1,304 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "hal/hal_timer.h"
+
+#include "oslatency/oslatency.h"
+#include "oslatency_priv.h"
+
+static int32_t oslatency_samples[MYNEWT_VAL(OSLATENCY_MAX_SAMPLES)];
+
+/*
+ * Spinning load tasks.  Created lazily on the first run that asks for
+ * busy load and parked on a semaphore between runs; tasks cannot be
+ * torn down again, so the pool is permanent once used.
+ */
+static struct os_task
+    oslatency_busy_tasks[MYNEWT_VAL(OSLATENCY_MAX_BUSY_TASKS)];
+static os_stack_t
+    oslatency_busy_stacks[MYNEWT_VAL(OSLATENCY_MAX_BUSY_TASKS)]
+                         [MYNEWT_VAL(OSLATENCY_BUSY_STACK_SIZE)];
+static char oslatency_busy_names[MYNEWT_VAL(OSLATENCY_MAX_BUSY_TASKS)][8];
+static struct os_sem oslatency_busy_sem;
+static volatile uint8_t oslatency_busy_on;
+static uint8_t oslatency_busy_created;
+
+/* Load callouts; each rearms itself every tick on the default evq. */
+static struct os_callout
+    oslatency_load_cos[MYNEWT_VAL(OSLATENCY_MAX_CALLOUTS)];
+static volatile uint8_t oslatency_load_on;
+
+/* ISR storm timer. */
+static struct hal_timer oslatency_isr_tmr;
+static uint32_t oslatency_isr_ticks;
+static volatile uint8_t oslatency_isr_on;
+static uint8_t oslatency_isr_inited;
+
+/* Measurement callout state. */
+static struct os_eventq oslatency_evq;
+static struct os_callout oslatency_meas_co;
+static uint32_t oslatency_meas_t0;
+static uint32_t oslatency_meas_expected_us;
+static int32_t oslatency_meas_delta;
+static uint8_t oslatency_evq_inited;
+
+static void
+oslatency_busy_handler(void *arg)
+{
+    while (1) {
+        os_sem_pend(&oslatency_busy_sem, OS_TIMEOUT_NEVER);
+        while (oslatency_busy_on) {
+            /* Spin; we only get the CPU when the harness sleeps. */
+        }
+    }
+}
+
+static void
+oslatency_load_co_cb(struct os_event *ev)
+{
+    struct os_callout *co;
+
+    if (oslatency_load_on) {
+        co = (struct os_callout *)ev;
+        os_callout_reset(co, 1);
+    }
+}
+
+static void
+oslatency_isr_cb(void *arg)
+{
+    if (oslatency_isr_on) {
+        hal_timer_start(&oslatency_isr_tmr, oslatency_isr_ticks);
+    }
+}
+
+static uint32_t
+oslatency_ticks_to_us(uint32_t os_ticks)
+{
+    return (uint32_t)((uint64_t)os_ticks * 1000000 / OS_TICKS_PER_SEC);
+}
+
+static int
+oslatency_load_start(const struct oslatency_cfg *cfg)
+{
+    int i;
+    int rc;
+
+    if (cfg->olc_busy_tasks > MYNEWT_VAL(OSLATENCY_MAX_BUSY_TASKS) ||
+        cfg->olc_callouts > MYNEWT_VAL(OSLATENCY_MAX_CALLOUTS) ||
+        cfg->olc_samples == 0 ||
+        cfg->olc_samples > MYNEWT_VAL(OSLATENCY_MAX_SAMPLES) ||
+        cfg->olc_delay_ticks == 0) {
+
+        return OS_EINVAL;
+    }
+
+    if (cfg->olc_busy_tasks > 0 && !oslatency_busy_created) {
+        os_sem_init(&oslatency_busy_sem, 0);
+        for (i = 0; i < MYNEWT_VAL(OSLATENCY_MAX_BUSY_TASKS); i++) {
+            snprintf(oslatency_busy_names[i],
+              sizeof(oslatency_busy_names[i]), "oslat%d", i);
+            rc = os_task_init(&oslatency_busy_tasks[i],
+              oslatency_busy_names[i], oslatency_busy_handler, NULL,
+              MYNEWT_VAL(OSLATENCY_BUSY_TASK_PRIO) + i, OS_WAIT_FOREVER,
+              oslatency_busy_stacks[i],
+              MYNEWT_VAL(OSLATENCY_BUSY_STACK_SIZE));
+            if (rc != 0) {
+                return rc;
+            }
+        }
+        oslatency_busy_created = 1;
+    }
+
+    oslatency_busy_on = 1;
+    for (i = 0; i < cfg->olc_busy_tasks; i++) {
+        os_sem_release(&oslatency_busy_sem);
+    }
+
+    oslatency_load_on = 1;
+    for (i = 0; i < cfg->olc_callouts; i++) {
+        os_callout_init(&oslatency_load_cos[i], os_eventq_dflt_get(),
+          oslatency_load_co_cb, NULL);
+        os_callout_reset(&oslatency_load_cos[i], 1);
+    }
+
+    if (cfg->olc_isr_usecs != 0) {
+        if (!oslatency_isr_inited) {
+            rc = hal_timer_config(MYNEWT_VAL(OSLATENCY_TIMER_NUM),
+              MYNEWT_VAL(OSLATENCY_TIMER_FREQ));
+            if (rc != 0) {
+                return rc;
+            }
+            hal_timer_set_cb(MYNEWT_VAL(OSLATENCY_TIMER_NUM),
+              &oslatency_isr_tmr, oslatency_isr_cb, NULL);
+            oslatency_isr_inited = 1;
+        }
+        oslatency_isr_ticks =
+            (uint32_t)((uint64_t)cfg->olc_isr_usecs *
+                       MYNEWT_VAL(OSLATENCY_TIMER_FREQ) / 1000000);
+        if (oslatency_isr_ticks == 0) {
+            oslatency_isr_ticks = 1;
+        }
+        oslatency_isr_on = 1;
+        hal_timer_start(&oslatency_isr_tmr, oslatency_isr_ticks);
+    }
+
+    return 0;
+}
+
+static void
+oslatency_load_stop(const struct oslatency_cfg *cfg)
+{
+    int i;
+
+    if (cfg->olc_isr_usecs != 0) {
+        oslatency_isr_on = 0;
+        hal_timer_stop(&oslatency_isr_tmr);
+    }
+
+    oslatency_load_on = 0;
+    for (i = 0; i < cfg->olc_callouts; i++) {
+        os_callout_stop(&oslatency_load_cos[i]);
+    }
+
+    /* The spinners drop back onto the semaphore on their own. */
+    oslatency_busy_on = 0;
+}
+
+static void
+oslatency_summarize(int cnt, struct oslatency_result *res)
+{
+    int32_t v;
+    int i;
+    int j;
+
+    /* Insertion sort; the sample buffer is small. */
+    for (i = 1; i < cnt; i++) {
+        v = oslatency_samples[i];
+        for (j = i - 1; j >= 0 && oslatency_samples[j] > v; j--) {
+            oslatency_samples[j + 1] = oslatency_samples[j];
+        }
+        oslatency_samples[j + 1] = v;
+    }
+
+    res->olr_samples = cnt;
+    res->olr_min_us = oslatency_samples[0];
+    res->olr_p50_us = oslatency_samples[cnt / 2];
+    res->olr_p90_us = oslatency_samples[(cnt * 9) / 10];
+    res->olr_p99_us = oslatency_samples[(cnt * 99) / 100];
+    res->olr_max_us = oslatency_samples[cnt - 1];
+}
+
+int
+oslatency_delay_run(const struct oslatency_cfg *cfg,
+                    struct oslatency_result *res)
+{
+    uint32_t expected_us;
+    uint32_t t0;
+    int rc;
+    int i;
+
+    rc = oslatency_load_start(cfg);
+    if (rc != 0) {
+        return rc;
+    }
+
+    expected_us = oslatency_ticks_to_us(cfg->olc_delay_ticks);
+
+    /* Align to a tick edge so the samples measure timer accuracy, not
+     * the phase of the call within the current tick.
+     */
+    os_time_delay(1);
+
+    for (i = 0; i < cfg->olc_samples; i++) {
+        t0 = os_cputime_get32();
+        os_time_delay(cfg->olc_delay_ticks);
+        oslatency_samples[i] =
+            (int32_t)(os_cputime_ticks_to_usecs(os_cputime_get32() - t0) -
+                      expected_us);
+    }
+
+    oslatency_load_stop(cfg);
+    oslatency_summarize(cfg->olc_samples, res);
+    return 0;
+}
+
+static void
+oslatency_meas_co_cb(struct os_event *ev)
+{
+    oslatency_meas_delta =
+        (int32_t)(os_cputime_ticks_to_usecs(os_cputime_get32() -
+                                            oslatency_meas_t0) -
+                  oslatency_meas_expected_us);
+}
+
+int
+oslatency_callout_run(const struct oslatency_cfg *cfg,
+                      struct oslatency_result *res)
+{
+    int rc;
+    int i;
+
+    rc = oslatency_load_start(cfg);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (!oslatency_evq_inited) {
+        os_eventq_init(&oslatency_evq);
+        oslatency_evq_inited = 1;
+    }
+    os_callout_init(&oslatency_meas_co, &oslatency_evq,
+      oslatency_meas_co_cb, NULL);
+    oslatency_meas_expected_us = oslatency_ticks_to_us(cfg->olc_delay_ticks);
+
+    os_time_delay(1);
+
+    for (i = 0; i < cfg->olc_samples; i++) {
+        oslatency_meas_t0 = os_cputime_get32();
+        os_callout_reset(&oslatency_meas_co, cfg->olc_delay_ticks);
+
+        /* Blocks until the callout's event is dispatched. */
+        os_eventq_run(&oslatency_evq);
+        oslatency_samples[i] = oslatency_meas_delta;
+    }
+
+    oslatency_load_stop(cfg);
+    oslatency_summarize(cfg->olc_samples, res);
+    return 0;
+}
+
+void
+oslatency_init(void)
+{
+#if MYNEWT_VAL(OSLATENCY_CLI)
+    int rc;
+
+    rc = oslatency_cli_register();
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+}
@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(OSLATENCY_CLI)
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <os/os.h>
+#include <console/console.h>
+#include <shell/shell.h>
+
+#include "oslatency/oslatency.h"
+#include "oslatency_priv.h"
+
+static int oslatency_cli_cmd(int argc, char **argv);
+
+static struct shell_cmd oslatency_cmd_struct = {
+    .sc_cmd = "oslat",
+    .sc_cmd_func = oslatency_cli_cmd
+};
+
+static int
+oslatency_cli_cmd(int argc, char **argv)
+{
+    struct oslatency_result res;
+    struct oslatency_cfg cfg;
+    int callout;
+    int rc;
+
+    if (argc < 2 ||
+        (strcmp(argv[1], "delay") && strcmp(argv[1], "callout"))) {
+
+        console_printf("Usage: oslat <delay|callout> [busy-tasks] "
+                       "[callouts] [isr-usecs] [samples] [delay-ticks]\n");
+        return 0;
+    }
+    callout = !strcmp(argv[1], "callout");
+
+    memset(&cfg, 0, sizeof cfg);
+    cfg.olc_samples = 64;
+    cfg.olc_delay_ticks = 2;
+    if (argc > 2) {
+        cfg.olc_busy_tasks = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        cfg.olc_callouts = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        cfg.olc_isr_usecs = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        cfg.olc_samples = atoi(argv[5]);
+    }
+    if (argc > 6) {
+        cfg.olc_delay_ticks = atoi(argv[6]);
+    }
+
+    if (callout) {
+        rc = oslatency_callout_run(&cfg, &res);
+    } else {
+        rc = oslatency_delay_run(&cfg, &res);
+    }
+    if (rc != 0) {
+        console_printf("oslat failed; rc=%d\n", rc);
+        return 0;
+    }
+
+    console_printf("oslat: kind=%s busy=%u callouts=%u isr_us=%lu "
+                   "ticks=%u samples=%u min=%ld p50=%ld p90=%ld p99=%ld "
+                   "max=%ld\n",
+                   argv[1], cfg.olc_busy_tasks, cfg.olc_callouts,
+                   (unsigned long)cfg.olc_isr_usecs, cfg.olc_delay_ticks,
+                   res.olr_samples,
+                   (long)res.olr_min_us, (long)res.olr_p50_us,
+                   (long)res.olr_p90_us, (long)res.olr_p99_us,
+                   (long)res.olr_max_us);
+    return 0;
+}
+
+int
+oslatency_cli_register(void)
+{
+    return shell_cmd_register(&oslatency_cmd_struct);
+}
+
+#endif /* MYNEWT_VAL(OSLATENCY_CLI) */
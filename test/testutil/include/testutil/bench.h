@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_TESTUTIL_BENCH_
+#define H_TESTUTIL_BENCH_
+
+#include <inttypes.h>
+#include "testutil/testutil.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Microbenchmark harness companion to the unit test macros.  A bench
+ * case is a function body that performs 'bench_niter' iterations of
+ * the measured operation; the harness warms it up, grows the
+ * iteration count until one sample spans TU_BENCH_MIN_SAMPLE_USECS of
+ * os_cputime (so timer granularity does not dominate), then takes
+ * TU_BENCH_NUM_SAMPLES samples and reports min/median/p99 cputime
+ * ticks per iteration.  os_cputime must be running; results go to the
+ * console when ts_print_results is set and are also retrievable with
+ * tu_bench_last_result() for programmatic thresholds.
+ */
+
+#ifndef TU_BENCH_NUM_SAMPLES
+#define TU_BENCH_NUM_SAMPLES        32
+#endif
+
+#ifndef TU_BENCH_MIN_SAMPLE_USECS
+#define TU_BENCH_MIN_SAMPLE_USECS   1000
+#endif
+
+typedef void tu_bench_fn_t(uint32_t bench_niter, void *bench_arg);
+
+struct tu_bench_result {
+    const char *tbr_name;
+    uint32_t tbr_iters;         /* iterations per sample, after calibration */
+    uint32_t tbr_min;           /* cputime ticks per iteration */
+    uint32_t tbr_median;
+    uint32_t tbr_p99;
+};
+
+void tu_bench_run(const char *name, tu_bench_fn_t *fn, void *arg);
+const struct tu_bench_result *tu_bench_last_result(void);
+
+#define BENCH_SUITE(suite_name) TEST_SUITE(suite_name)
+
+#define BENCH_CASE_DECL(case_name)                            \
+    int case_name(void);
+
+/*
+ * Benchmark definition.  The body runs 'bench_niter' iterations of
+ * the measured operation; one-time setup should be guarded so its
+ * cost amortizes away under calibration.
+ */
+#define BENCH_CASE(case_name)                                 \
+    static void BENCH_CASE_##case_name(uint32_t bench_niter,  \
+                                       void *bench_arg);      \
+                                                              \
+    int                                                       \
+    case_name(void)                                           \
+    {                                                         \
+        tu_bench_run(#case_name, BENCH_CASE_##case_name,      \
+                     NULL);                                   \
+        return 0;                                             \
+    }                                                         \
+                                                              \
+    static void                                               \
+    BENCH_CASE_##case_name(uint32_t bench_niter, void *bench_arg)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_TESTUTIL_BENCH_ */
@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+
+#include "os/os.h"
+#include "os/os_cputime.h"
+#include "testutil/bench.h"
+#include "testutil_priv.h"
+
+/* Calibration stops growing the iteration count here even if the
+ * cputime source appears stuck, so a dead timer cannot hang a run.
+ */
+#define TU_BENCH_MAX_ITERS          (1UL << 20)
+
+static struct tu_bench_result tu_bench_result;
+
+static uint32_t
+tu_bench_sample(tu_bench_fn_t *fn, void *arg, uint32_t niter)
+{
+    uint32_t start;
+
+    start = os_cputime_get32();
+    fn(niter, arg);
+    return os_cputime_get32() - start;
+}
+
+void
+tu_bench_run(const char *name, tu_bench_fn_t *fn, void *arg)
+{
+    uint32_t samples[TU_BENCH_NUM_SAMPLES];
+    uint32_t min_ticks;
+    uint32_t elapsed;
+    uint32_t niter;
+    uint32_t tmp;
+    int i;
+    int j;
+
+    /*
+     * Warmup doubles as calibration: grow the iteration count until a
+     * single sample spans enough cputime that timer granularity is
+     * noise.
+     */
+    min_ticks = os_cputime_usecs_to_ticks(TU_BENCH_MIN_SAMPLE_USECS);
+    niter = 1;
+    while (1) {
+        elapsed = tu_bench_sample(fn, arg, niter);
+        if (elapsed >= min_ticks || niter >= TU_BENCH_MAX_ITERS) {
+            break;
+        }
+        niter *= 2;
+    }
+
+    for (i = 0; i < TU_BENCH_NUM_SAMPLES; i++) {
+        samples[i] = tu_bench_sample(fn, arg, niter) / niter;
+    }
+
+    /* Insertion sort; the sample count is small */
+    for (i = 1; i < TU_BENCH_NUM_SAMPLES; i++) {
+        tmp = samples[i];
+        for (j = i - 1; j >= 0 && samples[j] > tmp; j--) {
+            samples[j + 1] = samples[j];
+        }
+        samples[j + 1] = tmp;
+    }
+
+    tu_bench_result.tbr_name = name;
+    tu_bench_result.tbr_iters = niter;
+    tu_bench_result.tbr_min = samples[0];
+    tu_bench_result.tbr_median = samples[TU_BENCH_NUM_SAMPLES / 2];
+    tu_bench_result.tbr_p99 =
+        samples[(TU_BENCH_NUM_SAMPLES * 99) / 100];
+
+    if (ts_config.ts_print_results) {
+        printf("[bench] %s: min=%lu median=%lu p99=%lu "
+               "(cputime ticks/iter, %lu iters/sample)\n",
+               name,
+               (unsigned long)tu_bench_result.tbr_min,
+               (unsigned long)tu_bench_result.tbr_median,
+               (unsigned long)tu_bench_result.tbr_p99,
+               (unsigned long)niter);
+    }
+}
+
+const struct tu_bench_result *
+tu_bench_last_result(void)
+{
+    return &tu_bench_result;
+}
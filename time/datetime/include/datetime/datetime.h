@@ -51,6 +51,21 @@ int datetime_format(const struct os_timeval *utctime,
 int datetime_parse(const char *input, struct os_timeval *utctime,
     struct os_timezone *tz);
 
+/*
+ * Write the time specified by 'utctime' and 'tz' into 'output' in the
+ * same RFC 3339 format as datetime_format(), but specialized for
+ * append-to-buffer use: returns the number of characters written
+ * (excluding the terminator) so the caller can continue appending at
+ * 'output' + rc.  The civil date decomposition is cached and only
+ * recomputed when the day or timezone offset changes, so intra-day
+ * calls cost a handful of arithmetic ops.
+ *
+ * Returns -1 if the time is invalid or 'olen' is too small for the
+ * formatted string.
+ */
+int datetime_append_iso8601(char *output, int olen,
+    const struct os_timeval *utctime, const struct os_timezone *tz);
+
 #ifdef __cplusplus
 }
 #endif
@@ -57,6 +57,7 @@
  *    from: src/sys/i386/isa/clock.c,v 1.176 2001/09/04
  */
 
+#include <os/os.h>
 #include <os/os_time.h>
 
 #include <stdio.h>
@@ -362,68 +363,135 @@ err:
     return (-1);
 }
 
+/*
+ * Cache of the most recently decomposed civil date.  Log timestamping
+ * formats thousands of datetimes per session, nearly all within the
+ * same day; the year/month loops in timeval_to_clocktime() only need
+ * to rerun when the day (or the applied timezone offset) changes, and
+ * intra-day timestamps reduce to a few divisions on the remainder
+ * seconds.
+ */
+static struct {
+    int64_t day;        /* day number since the epoch, offset applied */
+    int tz_off;         /* applied timezone offset, in seconds */
+    int valid;
+    char prefix[10];    /* "YYYY-MM-DD" (no terminator) */
+} datetime_day_cache;
+
+static char *
+datetime_put2(char *cp, int val)
+{
+    cp[0] = '0' + val / 10;
+    cp[1] = '0' + val % 10;
+    return (cp + 2);
+}
+
 int
-datetime_format(const struct os_timeval *tv, const struct os_timezone *tz,
-    char *ostr, int olen)
+datetime_append_iso8601(char *ostr, int olen, const struct os_timeval *tv,
+    const struct os_timezone *tz)
 {
     char *cp;
-    int rc, rlen, minswest;
+    int need, minswest;
     int off_hour, off_min, sign;
+    int tz_off, rsec, val;
+    int64_t secs, day;
     struct clocktime ct;
+    os_sr_t sr;
 
-    rc = timeval_to_clocktime(tv, tz, &ct);
-    if (rc != 0) {
-        goto err;
+    secs = tv->tv_sec;
+    tz_off = 0;
+    minswest = 0;
+    if (tz != NULL) {
+        minswest = tz->tz_minuteswest;
+        if (tz->tz_dsttime) {
+            minswest -= 60;
+        }
+        tz_off = -minswest * 60;
     }
+    secs += tz_off;
 
-    cp = ostr;
-    rlen = olen;
-
-    rc = snprintf(cp, rlen, "%04d-%02d-%02dT%02d:%02d:%02d",
-        ct.year, ct.mon, ct.day, ct.hour, ct.min, ct.sec);
-    cp += rc;
-    rlen -= rc;
-    if (rc < 0 || rlen <= 0) {
-        goto err;
+    if (secs < 0 || tv->tv_usec < 0 || tv->tv_usec > 999999) {
+        return (-1);
     }
 
-    if (ct.usec != 0) {
-        rc = snprintf(cp, rlen, ".%06d", ct.usec);
-        cp += rc;
-        rlen -= rc;
-        if (rc < 0 || rlen <= 0) {
-            goto err;
-        }
+    need = 19 + 1;                  /* date 'T' time + terminator */
+    if (tv->tv_usec != 0) {
+        need += 7;
+    }
+    if (minswest != 0) {
+        need += 6;
+    }
+    if (olen < need) {
+        return (-1);
     }
 
-    if (tz != NULL) {
-        minswest = tz->tz_minuteswest;
-        if (tz->tz_dsttime) {
-            minswest -= 60;
+    day = secs / SECDAY;
+    rsec = secs % SECDAY;
+
+    OS_ENTER_CRITICAL(sr);
+    if (!datetime_day_cache.valid || datetime_day_cache.day != day ||
+        datetime_day_cache.tz_off != tz_off) {
+        if (timeval_to_clocktime(tv, tz, &ct) != 0) {
+            OS_EXIT_CRITICAL(sr);
+            return (-1);
         }
-    } else {
-        minswest = 0;
+        val = ct.year;
+        datetime_day_cache.prefix[0] = '0' + val / 1000;
+        datetime_day_cache.prefix[1] = '0' + val / 100 % 10;
+        datetime_put2(&datetime_day_cache.prefix[2], val % 100);
+        datetime_day_cache.prefix[4] = '-';
+        datetime_put2(&datetime_day_cache.prefix[5], ct.mon);
+        datetime_day_cache.prefix[7] = '-';
+        datetime_put2(&datetime_day_cache.prefix[8], ct.day);
+        datetime_day_cache.day = day;
+        datetime_day_cache.tz_off = tz_off;
+        datetime_day_cache.valid = 1;
     }
-
-    if (minswest < 0) {
-        sign = '+';
-        minswest = -minswest;
-    } else {
-        sign = '-';
+    memcpy(ostr, datetime_day_cache.prefix,
+           sizeof(datetime_day_cache.prefix));
+    OS_EXIT_CRITICAL(sr);
+
+    cp = ostr + sizeof(datetime_day_cache.prefix);
+    *cp++ = 'T';
+    cp = datetime_put2(cp, rsec / 3600);
+    *cp++ = ':';
+    cp = datetime_put2(cp, rsec % 3600 / 60);
+    *cp++ = ':';
+    cp = datetime_put2(cp, rsec % 60);
+
+    if (tv->tv_usec != 0) {
+        *cp++ = '.';
+        val = tv->tv_usec;
+        cp = datetime_put2(cp, val / 10000);
+        cp = datetime_put2(cp, val / 100 % 100);
+        cp = datetime_put2(cp, val % 100);
     }
 
-    off_hour = minswest / 60;
-    off_min = minswest % 60;
-    if (off_hour || off_min) {
-        rc = snprintf(cp, rlen, "%c%02d:%02d", sign, off_hour, off_min);
-        cp += rc;
-        rlen -= rc;
-        if (rc < 0 || rlen <= 0) {
-            goto err;
+    if (minswest != 0) {
+        if (minswest < 0) {
+            sign = '+';
+            minswest = -minswest;
+        } else {
+            sign = '-';
         }
+        off_hour = minswest / 60;
+        off_min = minswest % 60;
+        *cp++ = sign;
+        cp = datetime_put2(cp, off_hour);
+        *cp++ = ':';
+        cp = datetime_put2(cp, off_min);
     }
-    return (0);
+    *cp = '\0';
 
-err:
-    return (-1);
+    return (cp - ostr);
+}
+
+int
+datetime_format(const struct os_timeval *tv, const struct os_timezone *tz,
+    char *ostr, int olen)
+{
+    int rc;
+
+    rc = datetime_append_iso8601(ostr, olen, tv, tz);
+    return (rc < 0 ? -1 : 0);
 }
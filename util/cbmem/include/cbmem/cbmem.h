@@ -38,6 +38,12 @@ struct cbmem {
     uint8_t *c_buf;
     uint8_t *c_buf_end;
     uint8_t *c_buf_cur_end;
+    /* Fixed record size, or 0 for variable-length entries with headers.
+     * In fixed-record mode no cbmem_entry_hdr precedes the data; the
+     * entry pointers handed out by the iterator and walk callbacks point
+     * directly at the records.
+     */
+    uint16_t c_rec_size;
 };
 
 struct cbmem_iter {
@@ -57,10 +63,16 @@ typedef int (*cbmem_walk_func_t)(struct cbmem *, struct cbmem_entry_hdr *,
 int cbmem_lock_acquire(struct cbmem *cbmem);
 int cbmem_lock_release(struct cbmem *cbmem);
 int cbmem_init(struct cbmem *cbmem, void *buf, uint32_t buf_len);
+int cbmem_init_fixed(struct cbmem *cbmem, void *buf, uint32_t buf_len,
+        uint16_t rec_size);
 int cbmem_append(struct cbmem *cbmem, void *data, uint16_t len);
+int cbmem_append_batch(struct cbmem *cbmem, void *data, uint16_t len,
+        int nrecs);
 void cbmem_iter_start(struct cbmem *cbmem, struct cbmem_iter *iter);
-struct cbmem_entry_hdr *cbmem_iter_next(struct cbmem *cbmem, 
+struct cbmem_entry_hdr *cbmem_iter_next(struct cbmem *cbmem,
         struct cbmem_iter *iter);
+int cbmem_iter_run(struct cbmem *cbmem, struct cbmem_iter *iter, void **run,
+        uint32_t *run_len);
 int cbmem_read(struct cbmem *cbmem, struct cbmem_entry_hdr *hdr, void *buf, 
         uint16_t off, uint16_t len);
 int cbmem_walk(struct cbmem *cbmem, cbmem_walk_func_t walk_func, void *arg);
@@ -35,6 +35,29 @@ cbmem_init(struct cbmem *cbmem, void *buf, uint32_t buf_len)
     return (0);
 }
 
+/**
+ * Initialize a cbmem in fixed-record mode.  Records are 'rec_size' bytes
+ * each and are stored back to back with no per-entry header, so a record
+ * append is a single memcpy and the buffer holds buf_len / rec_size
+ * records.  Entry pointers handed to cbmem_read(), the iterator and walk
+ * callbacks point directly at record data.
+ */
+int
+cbmem_init_fixed(struct cbmem *cbmem, void *buf, uint32_t buf_len,
+        uint16_t rec_size)
+{
+    if (rec_size == 0 || rec_size > buf_len) {
+        return (-1);
+    }
+
+    cbmem_init(cbmem, buf, buf_len);
+    cbmem->c_rec_size = rec_size;
+    /* Truncate to a whole number of records; the ring wraps here. */
+    cbmem->c_buf_cur_end = cbmem->c_buf + (buf_len / rec_size) * rec_size;
+
+    return (0);
+}
+
 int
 cbmem_lock_acquire(struct cbmem *cbmem)
 {
@@ -74,18 +97,56 @@ err:
 }
 
 
-int
-cbmem_append(struct cbmem *cbmem, void *data, uint16_t len)
+/*
+ * Append one fixed-size record.  Caller holds the cbmem lock.
+ */
+static int
+cbmem_append_rec(struct cbmem *cbmem, void *data, uint16_t len)
+{
+    uint8_t *dst;
+
+    if (len != cbmem->c_rec_size) {
+        return (-1);
+    }
+
+    if (cbmem->c_entry_end) {
+        dst = (uint8_t *) cbmem->c_entry_end + cbmem->c_rec_size;
+        if (dst >= cbmem->c_buf_cur_end) {
+            dst = cbmem->c_buf;
+        }
+    } else {
+        dst = cbmem->c_buf;
+    }
+
+    /* Overwrite-oldest: push the start past the record being clobbered */
+    if (cbmem->c_entry_end && dst == (uint8_t *) cbmem->c_entry_start) {
+        cbmem->c_entry_start = (struct cbmem_entry_hdr *)
+            ((uint8_t *) cbmem->c_entry_start + cbmem->c_rec_size);
+        if ((uint8_t *) cbmem->c_entry_start >= cbmem->c_buf_cur_end) {
+            cbmem->c_entry_start = (struct cbmem_entry_hdr *) cbmem->c_buf;
+        }
+    }
+
+    memcpy(dst, data, len);
+
+    cbmem->c_entry_end = (struct cbmem_entry_hdr *) dst;
+    if (!cbmem->c_entry_start) {
+        cbmem->c_entry_start = (struct cbmem_entry_hdr *) dst;
+    }
+
+    return (0);
+}
+
+/*
+ * Append one variable-length entry, with header.  Caller holds the cbmem
+ * lock.
+ */
+static int
+cbmem_append_entry(struct cbmem *cbmem, void *data, uint16_t len)
 {
     struct cbmem_entry_hdr *dst;
     uint8_t *start;
     uint8_t *end;
-    int rc;
-
-    rc = cbmem_lock_acquire(cbmem);
-    if (rc != 0) {
-        goto err;
-    }
 
     if (cbmem->c_entry_end) {
         dst = CBMEM_ENTRY_NEXT(cbmem->c_entry_end);
@@ -133,6 +194,72 @@ cbmem_append(struct cbmem *cbmem, void *data, uint16_t len)
         cbmem->c_entry_start = dst;
     }
 
+    return (0);
+}
+
+int
+cbmem_append(struct cbmem *cbmem, void *data, uint16_t len)
+{
+    int rc;
+
+    rc = cbmem_lock_acquire(cbmem);
+    if (rc != 0) {
+        goto err;
+    }
+
+    if (cbmem->c_rec_size) {
+        rc = cbmem_append_rec(cbmem, data, len);
+    } else {
+        rc = cbmem_append_entry(cbmem, data, len);
+    }
+    if (rc != 0) {
+        cbmem_lock_release(cbmem);
+        goto err;
+    }
+
+    rc = cbmem_lock_release(cbmem);
+    if (rc != 0) {
+        goto err;
+    }
+
+    return (0);
+err:
+    return (-1);
+}
+
+/**
+ * Append 'nrecs' back-to-back records of 'len' bytes each under a single
+ * lock acquisition, for high-rate producers where per-record locking
+ * dominates.  In fixed-record mode 'len' must equal the record size.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int
+cbmem_append_batch(struct cbmem *cbmem, void *data, uint16_t len, int nrecs)
+{
+    uint8_t *src;
+    int rc;
+    int i;
+
+    rc = cbmem_lock_acquire(cbmem);
+    if (rc != 0) {
+        goto err;
+    }
+
+    src = data;
+    for (i = 0; i < nrecs; i++) {
+        if (cbmem->c_rec_size) {
+            rc = cbmem_append_rec(cbmem, src, len);
+        } else {
+            rc = cbmem_append_entry(cbmem, src, len);
+        }
+        if (rc != 0) {
+            cbmem_lock_release(cbmem);
+            goto err;
+        }
+        src += len;
+    }
+
     rc = cbmem_lock_release(cbmem);
     if (rc != 0) {
         goto err;
@@ -155,6 +282,25 @@ struct cbmem_entry_hdr *
 cbmem_iter_next(struct cbmem *cbmem, struct cbmem_iter *iter)
 {
     struct cbmem_entry_hdr *hdr;
+    uint8_t *next;
+
+    if (cbmem->c_rec_size) {
+        hdr = iter->ci_cur;
+        if (!hdr) {
+            goto err;
+        }
+
+        if (hdr == iter->ci_end) {
+            iter->ci_cur = NULL;
+        } else {
+            next = (uint8_t *) hdr + cbmem->c_rec_size;
+            if (next >= cbmem->c_buf_cur_end) {
+                next = cbmem->c_buf;
+            }
+            iter->ci_cur = (struct cbmem_entry_hdr *) next;
+        }
+        return (hdr);
+    }
 
     if (iter->ci_start > iter->ci_end) {
         hdr = iter->ci_cur;
@@ -181,6 +327,56 @@ err:
     return (hdr);
 }
 
+/**
+ * Hand back the next contiguous run of log memory, for bulk export (e.g.
+ * DMA-out over a UART) without per-entry iteration.  A log occupies at
+ * most two contiguous regions, so after cbmem_iter_start() this returns
+ * each in oldest-first order and then -1.  In variable-entry mode the
+ * runs include the entry headers.  The caller must hold the cbmem lock
+ * (cbmem_lock_acquire()) until it is done with the returned memory.
+ *
+ * @param cbmem The cbmem to export from
+ * @param iter Iterator initialized with cbmem_iter_start()
+ * @param run On success, points to the start of the run
+ * @param run_len On success, the run's length in bytes
+ *
+ * @return 0 when a run is returned, -1 when the log is exhausted.
+ */
+int
+cbmem_iter_run(struct cbmem *cbmem, struct cbmem_iter *iter, void **run,
+        uint32_t *run_len)
+{
+    uint8_t *cur;
+    uint8_t *limit;
+    uint8_t *end_edge;
+
+    cur = (uint8_t *) iter->ci_cur;
+    if (!cur || !iter->ci_end) {
+        return (-1);
+    }
+
+    /* One past the newest entry */
+    if (cbmem->c_rec_size) {
+        end_edge = (uint8_t *) iter->ci_end + cbmem->c_rec_size;
+    } else {
+        end_edge = (uint8_t *) CBMEM_ENTRY_NEXT(iter->ci_end);
+    }
+
+    if (cur > (uint8_t *) iter->ci_end) {
+        /* Wrapped: this run covers the older, high half of the buffer */
+        limit = cbmem->c_buf_cur_end;
+        iter->ci_cur = (struct cbmem_entry_hdr *) cbmem->c_buf;
+    } else {
+        limit = end_edge;
+        iter->ci_cur = NULL;
+    }
+
+    *run = cur;
+    *run_len = limit - cur;
+
+    return (0);
+}
+
 int
 cbmem_flush(struct cbmem *cbmem)
 {
@@ -193,7 +389,12 @@ cbmem_flush(struct cbmem *cbmem)
 
     cbmem->c_entry_start = NULL;
     cbmem->c_entry_end = NULL;
-    cbmem->c_buf_cur_end = NULL;
+    /* The fixed-record wrap point is a property of the geometry, not of
+     * the contents; keep it across a flush.
+     */
+    if (!cbmem->c_rec_size) {
+        cbmem->c_buf_cur_end = NULL;
+    }
 
     rc = cbmem_lock_release(cbmem);
     if (rc != 0) {
@@ -217,19 +418,34 @@ cbmem_read(struct cbmem *cbmem, struct cbmem_entry_hdr *hdr, void *buf,
     }
 
     /* Only read the maximum number of bytes, if we exceed that,
-     * truncate the read.
+     * truncate the read.  Fixed-mode records carry no header; the entry
+     * pointer addresses the data itself.
      */
-    if (off + len > hdr->ceh_len) {
-        len = hdr->ceh_len - off;
-    }
+    if (cbmem->c_rec_size) {
+        if (off + len > cbmem->c_rec_size) {
+            len = cbmem->c_rec_size - off;
+        }
 
-    if (off > hdr->ceh_len) {
-        rc = -1;
-        cbmem_lock_release(cbmem);
-        goto err;
-    }
+        if (off > cbmem->c_rec_size) {
+            rc = -1;
+            cbmem_lock_release(cbmem);
+            goto err;
+        }
+
+        memcpy(buf, (uint8_t *) hdr + off, len);
+    } else {
+        if (off + len > hdr->ceh_len) {
+            len = hdr->ceh_len - off;
+        }
 
-    memcpy(buf, (uint8_t *) hdr + sizeof(*hdr) + off, len);
+        if (off > hdr->ceh_len) {
+            rc = -1;
+            cbmem_lock_release(cbmem);
+            goto err;
+        }
+
+        memcpy(buf, (uint8_t *) hdr + sizeof(*hdr) + off, len);
+    }
 
     rc = cbmem_lock_release(cbmem);
     if (rc != 0) {
@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "cbmem_test.h"
+
+#define CBMEM4_REC_SIZE     8
+#define CBMEM4_NUM_RECS     8
+
+/* Fixed-record mode: no per-entry headers, batch appends, run export. */
+TEST_CASE(cbmem_test_case_4)
+{
+    uint8_t buf[CBMEM4_REC_SIZE * CBMEM4_NUM_RECS];
+    uint8_t recs[CBMEM4_REC_SIZE * 4];
+    uint8_t rec[CBMEM4_REC_SIZE];
+    struct cbmem_entry_hdr *hdr;
+    struct cbmem_iter iter;
+    struct cbmem cbmem4;
+    uint32_t run_len;
+    uint32_t total;
+    void *run;
+    int expected;
+    int rc;
+    int i;
+
+    rc = cbmem_init_fixed(&cbmem4, buf, sizeof(buf), CBMEM4_REC_SIZE);
+    TEST_ASSERT_FATAL(rc == 0, "cbmem_init_fixed() failed, rc = %d", rc);
+
+    /* Wrong-size records must be rejected */
+    rc = cbmem_append(&cbmem4, rec, CBMEM4_REC_SIZE - 1);
+    TEST_ASSERT(rc != 0, "undersized append unexpectedly succeeded");
+
+    /* Overfill by two records; 0 and 1 get overwritten. */
+    for (i = 0; i < CBMEM4_NUM_RECS - 2; i++) {
+        memset(rec, i, sizeof(rec));
+        rc = cbmem_append(&cbmem4, rec, sizeof(rec));
+        TEST_ASSERT_FATAL(rc == 0, "could not append record %d", i);
+    }
+    for (; i < CBMEM4_NUM_RECS + 2; i++) {
+        memset(&recs[(i - (CBMEM4_NUM_RECS - 2)) * CBMEM4_REC_SIZE], i,
+                CBMEM4_REC_SIZE);
+    }
+    rc = cbmem_append_batch(&cbmem4, recs, CBMEM4_REC_SIZE, 4);
+    TEST_ASSERT_FATAL(rc == 0, "could not batch append, rc = %d", rc);
+
+    /* Oldest surviving record is 2; newest is 9. */
+    expected = 2;
+    cbmem_iter_start(&cbmem4, &iter);
+    while ((hdr = cbmem_iter_next(&cbmem4, &iter)) != NULL) {
+        rc = cbmem_read(&cbmem4, hdr, rec, 0, sizeof(rec));
+        TEST_ASSERT_FATAL(rc == sizeof(rec), "short read, rc = %d", rc);
+        TEST_ASSERT_FATAL(rec[0] == expected && rec[7] == expected,
+                "record %d contains %d", expected, rec[0]);
+        expected++;
+    }
+    TEST_ASSERT_FATAL(expected == CBMEM4_NUM_RECS + 2,
+            "iterated %d records", expected - 2);
+
+    /* The wrapped log must export as exactly two contiguous runs whose
+     * concatenation is records 2..9 in order.
+     */
+    expected = 2;
+    total = 0;
+    cbmem_iter_start(&cbmem4, &iter);
+    for (i = 0; cbmem_iter_run(&cbmem4, &iter, &run, &run_len) == 0; i++) {
+        TEST_ASSERT_FATAL(run_len % CBMEM4_REC_SIZE == 0,
+                "ragged run length %u", (unsigned) run_len);
+        while (run_len > 0) {
+            TEST_ASSERT_FATAL(*(uint8_t *) run == expected,
+                    "run data %d != %d", *(uint8_t *) run, expected);
+            run = (uint8_t *) run + CBMEM4_REC_SIZE;
+            run_len -= CBMEM4_REC_SIZE;
+            total += CBMEM4_REC_SIZE;
+            expected++;
+        }
+    }
+    TEST_ASSERT_FATAL(i == 2, "expected 2 runs, got %d", i);
+    TEST_ASSERT_FATAL(total == sizeof(buf), "runs covered %u bytes",
+            (unsigned) total);
+}
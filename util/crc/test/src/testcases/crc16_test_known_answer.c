@@ -0,0 +1,33 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "crc_test.h"
+
+TEST_CASE(crc16_test_known_answer)
+{
+    uint16_t crc;
+
+    /* CRC16/CCITT-FALSE check value for "123456789" */
+    crc = crc16_ccitt(0xFFFF, "123456789", 9);
+    TEST_ASSERT(crc == 0x29B1, "crc16 check value 0x%04x != 0x29B1", crc);
+
+    /* Zero-length buffer must leave the seed untouched */
+    crc = crc16_ccitt(0x1234, "", 0);
+    TEST_ASSERT(crc == 0x1234, "zero-length crc16 changed seed to 0x%04x",
+                crc);
+}
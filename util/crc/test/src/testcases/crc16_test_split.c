@@ -0,0 +1,49 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "crc_test.h"
+
+#define CRC16_SPLIT_BUF_SZ      67
+
+/*
+ * Computing a crc in two chunks must match the one-shot result for any
+ * split point.  This exercises every leading/trailing remainder length of
+ * the slice-by-8 variant, so it also proves the sliced tables agree with
+ * the byte-at-a-time implementation (nffs and fcb feed crc16_ccitt
+ * incrementally this way on restore).
+ */
+TEST_CASE(crc16_test_split)
+{
+    uint8_t buf[CRC16_SPLIT_BUF_SZ];
+    uint16_t whole;
+    uint16_t split;
+    int i;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (i * 7) ^ (i >> 3);
+    }
+
+    whole = crc16_ccitt(CRC16_INITIAL_CRC, buf, sizeof(buf));
+
+    for (i = 0; i <= sizeof(buf); i++) {
+        split = crc16_ccitt(CRC16_INITIAL_CRC, buf, i);
+        split = crc16_ccitt(split, buf + i, sizeof(buf) - i);
+        TEST_ASSERT(split == whole,
+                    "split at %d: 0x%04x != 0x%04x", i, split, whole);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef __UTIL_LZSS_H__
+#define __UTIL_LZSS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Streaming LZSS codec with a small fixed RAM footprint, meant for
+ * places like the coredump write path where data must be compressed as
+ * it goes by.  The stream is a sequence of groups: one flag byte
+ * followed by eight items, LSB first.  A clear flag bit means the item
+ * is one literal byte; a set bit means a two byte back-reference of
+ * (offset - 1, length - LZSS_MIN_MATCH) into the last LZSS_WINDOW_SIZE
+ * bytes of output.  Matches may overlap the bytes they produce.
+ */
+#define LZSS_WINDOW_SIZE    256
+#define LZSS_MIN_MATCH      3
+#define LZSS_MAX_MATCH      (LZSS_MIN_MATCH + 255)
+
+/*
+ * Called with bytes as they are produced.  Return 0 to continue;
+ * non-zero aborts the operation and is passed back to the caller.
+ */
+typedef int (*lzss_output_fn)(void *arg, const uint8_t *data, int len);
+
+struct lzss_encoder {
+    lzss_output_fn le_out;
+    void *le_arg;
+    uint32_t le_pos;                    /* bytes consumed from input */
+    uint8_t le_window[LZSS_WINDOW_SIZE];
+    uint8_t le_ahead[LZSS_MAX_MATCH];   /* lookahead not yet encoded */
+    uint16_t le_ahead_len;
+    uint8_t le_group[1 + 2 * 8];        /* flag byte plus 8 items */
+    uint8_t le_group_len;               /* item bytes in le_group */
+    uint8_t le_group_items;
+};
+
+struct lzss_decoder {
+    lzss_output_fn ld_out;
+    void *ld_arg;
+    uint32_t ld_pos;                    /* bytes produced */
+    uint8_t ld_window[LZSS_WINDOW_SIZE];
+    uint8_t ld_flags;
+    uint8_t ld_nflags;
+    uint8_t ld_half;                    /* first byte of a match item */
+    uint8_t ld_have_half;
+};
+
+void lzss_enc_init(struct lzss_encoder *le, lzss_output_fn out_func,
+  void *arg);
+int lzss_enc_input(struct lzss_encoder *le, const void *data, int len);
+int lzss_enc_flush(struct lzss_encoder *le);
+
+void lzss_dec_init(struct lzss_decoder *ld, lzss_output_fn out_func,
+  void *arg);
+int lzss_dec_input(struct lzss_decoder *ld, const void *data, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_LZSS_H__ */
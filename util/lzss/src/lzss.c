@@ -0,0 +1,236 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "lzss/lzss.h"
+
+void
+lzss_enc_init(struct lzss_encoder *le, lzss_output_fn out_func, void *arg)
+{
+    memset(le, 0, sizeof(*le));
+    le->le_out = out_func;
+    le->le_arg = arg;
+}
+
+static int
+lzss_enc_group_flush(struct lzss_encoder *le)
+{
+    int rc;
+
+    if (le->le_group_items == 0) {
+        return 0;
+    }
+    rc = le->le_out(le->le_arg, le->le_group, le->le_group_len + 1);
+    le->le_group[0] = 0;
+    le->le_group_len = 0;
+    le->le_group_items = 0;
+    return rc;
+}
+
+static int
+lzss_enc_item(struct lzss_encoder *le, int is_match, uint8_t b1, uint8_t b2)
+{
+    if (is_match) {
+        le->le_group[0] |= 1 << le->le_group_items;
+        le->le_group[1 + le->le_group_len++] = b1;
+        le->le_group[1 + le->le_group_len++] = b2;
+    } else {
+        le->le_group[1 + le->le_group_len++] = b1;
+    }
+    le->le_group_items++;
+    if (le->le_group_items >= 8) {
+        return lzss_enc_group_flush(le);
+    }
+    return 0;
+}
+
+/*
+ * History byte at stream position p; positions at or past le_pos refer
+ * into the lookahead, which makes overlapping matches work.
+ */
+static uint8_t
+lzss_enc_byte_at(struct lzss_encoder *le, uint32_t p)
+{
+    if (p < le->le_pos) {
+        return le->le_window[p % LZSS_WINDOW_SIZE];
+    }
+    return le->le_ahead[p - le->le_pos];
+}
+
+static void
+lzss_enc_consume(struct lzss_encoder *le, int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++) {
+        le->le_window[(le->le_pos + i) % LZSS_WINDOW_SIZE] = le->le_ahead[i];
+    }
+    le->le_pos += len;
+    le->le_ahead_len -= len;
+    memmove(le->le_ahead, le->le_ahead + len, le->le_ahead_len);
+}
+
+/*
+ * Encode one item (longest match, or a literal) from the front of the
+ * lookahead.
+ */
+static int
+lzss_enc_emit(struct lzss_encoder *le)
+{
+    uint32_t max_off;
+    uint32_t d;
+    int best_len;
+    int best_off;
+    int l;
+    int rc;
+
+    best_len = 0;
+    best_off = 0;
+    max_off = le->le_pos;
+    if (max_off > LZSS_WINDOW_SIZE) {
+        max_off = LZSS_WINDOW_SIZE;
+    }
+    for (d = 1; d <= max_off; d++) {
+        l = 0;
+        while (l < le->le_ahead_len &&
+               le->le_ahead[l] == lzss_enc_byte_at(le, le->le_pos - d + l)) {
+            l++;
+        }
+        if (l > best_len) {
+            best_len = l;
+            best_off = d;
+            if (best_len >= le->le_ahead_len) {
+                break;
+            }
+        }
+    }
+    if (best_len >= LZSS_MIN_MATCH) {
+        rc = lzss_enc_item(le, 1, best_off - 1, best_len - LZSS_MIN_MATCH);
+        if (rc) {
+            return rc;
+        }
+        lzss_enc_consume(le, best_len);
+    } else {
+        rc = lzss_enc_item(le, 0, le->le_ahead[0], 0);
+        if (rc) {
+            return rc;
+        }
+        lzss_enc_consume(le, 1);
+    }
+    return 0;
+}
+
+int
+lzss_enc_input(struct lzss_encoder *le, const void *data, int len)
+{
+    const uint8_t *u = (const uint8_t *)data;
+    int take;
+    int rc;
+
+    while (len > 0) {
+        take = sizeof(le->le_ahead) - le->le_ahead_len;
+        if (take > len) {
+            take = len;
+        }
+        memcpy(le->le_ahead + le->le_ahead_len, u, take);
+        le->le_ahead_len += take;
+        u += take;
+        len -= take;
+
+        while (le->le_ahead_len == sizeof(le->le_ahead)) {
+            rc = lzss_enc_emit(le);
+            if (rc) {
+                return rc;
+            }
+        }
+    }
+    return 0;
+}
+
+int
+lzss_enc_flush(struct lzss_encoder *le)
+{
+    int rc;
+
+    while (le->le_ahead_len > 0) {
+        rc = lzss_enc_emit(le);
+        if (rc) {
+            return rc;
+        }
+    }
+    return lzss_enc_group_flush(le);
+}
+
+void
+lzss_dec_init(struct lzss_decoder *ld, lzss_output_fn out_func, void *arg)
+{
+    memset(ld, 0, sizeof(*ld));
+    ld->ld_out = out_func;
+    ld->ld_arg = arg;
+}
+
+int
+lzss_dec_input(struct lzss_decoder *ld, const void *data, int len)
+{
+    const uint8_t *u = (const uint8_t *)data;
+    uint8_t buf[LZSS_MAX_MATCH];
+    uint32_t src;
+    uint8_t b;
+    int mlen;
+    int rc;
+    int i;
+
+    while (len > 0) {
+        b = *u++;
+        len--;
+
+        if (ld->ld_nflags == 0) {
+            ld->ld_flags = b;
+            ld->ld_nflags = 8;
+            continue;
+        }
+        if (ld->ld_flags & 1) {
+            if (!ld->ld_have_half) {
+                ld->ld_half = b;
+                ld->ld_have_half = 1;
+                continue;
+            }
+            ld->ld_have_half = 0;
+            mlen = b + LZSS_MIN_MATCH;
+            src = ld->ld_pos - (ld->ld_half + 1);
+            for (i = 0; i < mlen; i++) {
+                buf[i] = ld->ld_window[(src + i) % LZSS_WINDOW_SIZE];
+                ld->ld_window[(ld->ld_pos + i) % LZSS_WINDOW_SIZE] = buf[i];
+            }
+            ld->ld_pos += mlen;
+            rc = ld->ld_out(ld->ld_arg, buf, mlen);
+        } else {
+            ld->ld_window[ld->ld_pos % LZSS_WINDOW_SIZE] = b;
+            ld->ld_pos++;
+            rc = ld->ld_out(ld->ld_arg, &b, 1);
+        }
+        if (rc) {
+            return rc;
+        }
+        ld->ld_flags >>= 1;
+        ld->ld_nflags--;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "lzss_test.h"
+
+uint8_t lzss_test_comp[LZSS_TEST_BUF_SZ * 2];
+int lzss_test_comp_len;
+uint8_t lzss_test_plain[LZSS_TEST_BUF_SZ];
+int lzss_test_plain_len;
+
+int
+lzss_test_comp_out(void *arg, const uint8_t *data, int len)
+{
+    TEST_ASSERT_FATAL(lzss_test_comp_len + len <= sizeof(lzss_test_comp));
+    memcpy(lzss_test_comp + lzss_test_comp_len, data, len);
+    lzss_test_comp_len += len;
+    return 0;
+}
+
+int
+lzss_test_plain_out(void *arg, const uint8_t *data, int len)
+{
+    TEST_ASSERT_FATAL(lzss_test_plain_len + len <= sizeof(lzss_test_plain));
+    memcpy(lzss_test_plain + lzss_test_plain_len, data, len);
+    lzss_test_plain_len += len;
+    return 0;
+}
+
+/*
+ * Compress data in chunk_sz pieces, decompress the result in chunk_sz
+ * pieces, and check the output matches the input.
+ */
+void
+lzss_test_roundtrip(const uint8_t *data, int len, int chunk_sz)
+{
+    struct lzss_encoder enc;
+    struct lzss_decoder dec;
+    int off;
+    int blk;
+    int rc;
+
+    lzss_test_comp_len = 0;
+    lzss_test_plain_len = 0;
+
+    lzss_enc_init(&enc, lzss_test_comp_out, NULL);
+    for (off = 0; off < len; off += blk) {
+        blk = len - off;
+        if (blk > chunk_sz) {
+            blk = chunk_sz;
+        }
+        rc = lzss_enc_input(&enc, data + off, blk);
+        TEST_ASSERT(rc == 0);
+    }
+    rc = lzss_enc_flush(&enc);
+    TEST_ASSERT(rc == 0);
+
+    lzss_dec_init(&dec, lzss_test_plain_out, NULL);
+    for (off = 0; off < lzss_test_comp_len; off += blk) {
+        blk = lzss_test_comp_len - off;
+        if (blk > chunk_sz) {
+            blk = chunk_sz;
+        }
+        rc = lzss_dec_input(&dec, lzss_test_comp + off, blk);
+        TEST_ASSERT(rc == 0);
+    }
+
+    TEST_ASSERT(lzss_test_plain_len == len);
+    TEST_ASSERT(!memcmp(lzss_test_plain, data, len));
+}
+
+TEST_CASE_DECL(lzss_test_compressible)
+TEST_CASE_DECL(lzss_test_incompressible)
+
+TEST_SUITE(lzss_test_suite)
+{
+    lzss_test_compressible();
+    lzss_test_incompressible();
+}
+
+#if MYNEWT_VAL(SELFTEST)
+
+int
+main(int argc, char **argv)
+{
+    ts_config.ts_print_results = 1;
+    tu_init();
+
+    lzss_test_suite();
+
+    return tu_any_failed;
+}
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _LZSS_TEST_H
+#define _LZSS_TEST_H
+
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "testutil/testutil.h"
+#include "lzss/lzss.h"
+
+#define LZSS_TEST_BUF_SZ    4096
+
+extern uint8_t lzss_test_comp[];
+extern int lzss_test_comp_len;
+extern uint8_t lzss_test_plain[];
+extern int lzss_test_plain_len;
+
+int lzss_test_comp_out(void *arg, const uint8_t *data, int len);
+int lzss_test_plain_out(void *arg, const uint8_t *data, int len);
+void lzss_test_roundtrip(const uint8_t *data, int len, int chunk_sz);
+
+#endif /* _LZSS_TEST_H */
@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "lzss_test.h"
+
+TEST_CASE(lzss_test_compressible)
+{
+    uint8_t data[LZSS_TEST_BUF_SZ];
+    int i;
+
+    /*
+     * All zeroes, like unused RAM in a core dump; must shrink a lot.
+     */
+    memset(data, 0, sizeof(data));
+    lzss_test_roundtrip(data, sizeof(data), 512);
+    TEST_ASSERT(lzss_test_comp_len < sizeof(data) / 10);
+
+    /*
+     * Repeating text, fed in awkward chunk sizes.
+     */
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = "the quick brown fox "[i % 20];
+    }
+    lzss_test_roundtrip(data, sizeof(data), 7);
+    TEST_ASSERT(lzss_test_comp_len < sizeof(data) / 2);
+
+    /*
+     * Short inputs, including ones below the minimum match length.
+     */
+    for (i = 1; i < 32; i++) {
+        lzss_test_roundtrip(data, i, 3);
+    }
+}
@@ -0,0 +1,41 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "lzss_test.h"
+
+TEST_CASE(lzss_test_incompressible)
+{
+    uint8_t data[LZSS_TEST_BUF_SZ];
+    uint32_t seed;
+    int i;
+
+    /*
+     * Pseudo-random data; the stream may grow (one flag bit per
+     * literal) but must still round-trip, and the worst-case expansion
+     * is bounded by 9/8.
+     */
+    seed = 0x12345678;
+    for (i = 0; i < sizeof(data); i++) {
+        seed = seed * 1664525 + 1013904223;
+        data[i] = seed >> 24;
+    }
+    lzss_test_roundtrip(data, sizeof(data), 512);
+    TEST_ASSERT(lzss_test_comp_len <= sizeof(data) + sizeof(data) / 8 + 2);
+
+    lzss_test_roundtrip(data, sizeof(data), 1);
+}
@@ -20,6 +20,8 @@
 #ifndef H_UTIL_MEM_
 #define H_UTIL_MEM_
 
+#include <inttypes.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -27,6 +29,27 @@ extern "C" {
 struct os_mempool;
 struct os_mbuf_pool;
 
+/**
+ * A region-based scratch allocator.  Allocations are aligned bumps of an
+ * offset into a caller-provided region and are never freed individually;
+ * mem_arena_reset() reclaims everything at once in O(1).  Intended for
+ * transient parse/decode scratch (e.g. cborattr, oc_rep) that would
+ * otherwise be sized into every task stack.  Not protected by a lock;
+ * an arena belongs to a single task.
+ */
+struct mem_arena {
+    uint8_t *ma_buf;
+    uint32_t ma_size;
+    /** Offset of the next free byte */
+    uint32_t ma_off;
+    /** High watermark of ma_off since init, for sizing the region */
+    uint32_t ma_hwm;
+};
+
+int mem_arena_init(struct mem_arena *arena, void *buf, uint32_t size);
+void *mem_arena_alloc(struct mem_arena *arena, uint32_t size);
+void mem_arena_reset(struct mem_arena *arena);
+
 int mem_malloc_mempool(struct os_mempool *mempool, int num_blocks,
                        int block_size, char *name, void **out_buf);
 
@@ -164,3 +164,71 @@ mem_init_mbuf_pool(void *mem, struct os_mempool *mempool,
 
     return 0;
 }
+
+/**
+ * Initializes an arena over a caller-provided region.
+ *
+ * @param arena                 The arena to initialize.
+ * @param buf                   The backing region.
+ * @param size                  The size of the backing region, in bytes.
+ *
+ * @return                      0 on success; OS_EINVAL if buf is NULL.
+ */
+int
+mem_arena_init(struct mem_arena *arena, void *buf, uint32_t size)
+{
+    if (buf == NULL) {
+        return OS_EINVAL;
+    }
+
+    arena->ma_buf = buf;
+    arena->ma_size = size;
+    arena->ma_off = 0;
+    arena->ma_hwm = 0;
+
+    return 0;
+}
+
+/**
+ * Allocates a block of scratch memory from an arena.  The block is
+ * aligned to OS_ALIGNMENT and remains valid until the next
+ * mem_arena_reset().  There is no per-block free.
+ *
+ * @param arena                 The arena to allocate from.
+ * @param size                  The number of bytes to allocate.
+ *
+ * @return                      The allocated block, or NULL if the arena
+ *                                  is exhausted.
+ */
+void *
+mem_arena_alloc(struct mem_arena *arena, uint32_t size)
+{
+    uint32_t off;
+    void *block;
+
+    off = OS_ALIGN(arena->ma_off, OS_ALIGNMENT);
+    if (size > arena->ma_size || off > arena->ma_size - size) {
+        return NULL;
+    }
+
+    block = arena->ma_buf + off;
+    arena->ma_off = off + size;
+    if (arena->ma_off > arena->ma_hwm) {
+        arena->ma_hwm = arena->ma_off;
+    }
+
+    return block;
+}
+
+/**
+ * Releases every allocation made from an arena since the last reset, in
+ * constant time.  The high watermark (ma_hwm) is preserved so callers
+ * can size the backing region from a worst-case run.
+ *
+ * @param arena                 The arena to reset.
+ */
+void
+mem_arena_reset(struct mem_arena *arena)
+{
+    arena->ma_off = 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _UTIL_RINGBUF_H
+#define _UTIL_RINGBUF_H
+
+#include <inttypes.h>
+#include "os/os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Byte ring buffer over a power-of-two, caller-owned storage area.
+ *
+ * Indices run free and are reduced modulo the size on access, so the
+ * full capacity is usable and emptiness/fullness need no extra flag.
+ * In the default SPSC arrangement one producer (task or ISR) and one
+ * consumer may run concurrently without masking interrupts: the
+ * producer only writes rb_head, the consumer only writes rb_tail,
+ * and each index is published after its data.  RINGBUF_F_MPSC
+ * serializes producers with a critical section instead; the consumer
+ * side stays lock-free.
+ *
+ * The reserve/commit calls expose the ring's contiguous regions
+ * directly, so a DMA engine can fill or drain the ring in place with
+ * no staging copy.  They assume one reservation outstanding per side
+ * at a time, so they are SPSC-only on the side that uses them.
+ */
+
+/** Multiple producers; puts serialize with a critical section. */
+#define RINGBUF_F_MPSC          (0x01)
+/** Maintain a semaphore so consumers can block in ringbuf_get_wait(). */
+#define RINGBUF_F_BLOCKING      (0x02)
+
+struct ringbuf {
+    /* Producer side */
+    volatile uint32_t rb_head;
+    /*
+     * Consumer side; kept apart from rb_head so a multicore port can
+     * pad them into separate cache lines without an API change.
+     */
+    volatile uint32_t rb_tail;
+    uint8_t *rb_buf;
+    uint32_t rb_mask;           /* size - 1 */
+    uint8_t rb_flags;
+    struct os_sem rb_sem;       /* signalled per put when BLOCKING */
+};
+
+/*
+ * Wire up 'rb' around 'buf' of 'size' bytes; size must be a power of
+ * two.  Returns OS_OK or OS_INVALID_PARM.
+ */
+int ringbuf_init(struct ringbuf *rb, void *buf, uint32_t size,
+                 uint8_t flags);
+
+/** Bytes currently stored. */
+static inline uint32_t
+ringbuf_used(const struct ringbuf *rb)
+{
+    return rb->rb_head - rb->rb_tail;
+}
+
+/** Bytes of free space. */
+static inline uint32_t
+ringbuf_free(const struct ringbuf *rb)
+{
+    return rb->rb_mask + 1 - ringbuf_used(rb);
+}
+
+/* Copy in up to 'len' bytes; returns the number actually stored. */
+int ringbuf_put(struct ringbuf *rb, const void *data, uint32_t len);
+
+/* Copy out up to 'len' bytes; returns the number actually read. */
+int ringbuf_get(struct ringbuf *rb, void *data, uint32_t len);
+
+/*
+ * As ringbuf_get(), but block up to 'timo' ticks for data when the
+ * ring runs empty before 'len' bytes are read.  Requires
+ * RINGBUF_F_BLOCKING; only one task may wait at a time.
+ */
+int ringbuf_get_wait(struct ringbuf *rb, void *data, uint32_t len,
+                     os_time_t timo);
+
+/*
+ * Producer reserve/commit: returns the largest contiguous free region
+ * and its length in *len (0 when full).  Fill it (e.g. by DMA), then
+ * publish with ringbuf_put_commit().
+ */
+uint8_t *ringbuf_put_reserve(struct ringbuf *rb, uint32_t *len);
+void ringbuf_put_commit(struct ringbuf *rb, uint32_t len);
+
+/*
+ * Consumer reserve/commit: returns the largest contiguous stored
+ * region and its length in *len (0 when empty).  Consume from it,
+ * then release with ringbuf_get_commit(); a partial commit keeps the
+ * remainder stored.
+ */
+const uint8_t *ringbuf_get_reserve(struct ringbuf *rb, uint32_t *len);
+void ringbuf_get_commit(struct ringbuf *rb, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _UTIL_RINGBUF_H */
@@ -0,0 +1,218 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "ringbuf/ringbuf.h"
+
+/* Indices are published only after their data; see header. */
+#define RINGBUF_BARRIER()       __asm__ volatile ("" ::: "memory")
+
+int
+ringbuf_init(struct ringbuf *rb, void *buf, uint32_t size, uint8_t flags)
+{
+    int rc;
+
+    if (rb == NULL || buf == NULL || size == 0 ||
+        (size & (size - 1)) != 0) {
+
+        return OS_INVALID_PARM;
+    }
+
+    rb->rb_buf = buf;
+    rb->rb_mask = size - 1;
+    rb->rb_head = 0;
+    rb->rb_tail = 0;
+    rb->rb_flags = flags;
+    if (flags & RINGBUF_F_BLOCKING) {
+        rc = os_sem_init(&rb->rb_sem, 0);
+        if (rc != OS_OK) {
+            return rc;
+        }
+    }
+
+    return OS_OK;
+}
+
+/*
+ * Copy 'len' bytes to offset 'idx' (unmasked), splitting across the
+ * wrap point when needed.  The caller has verified the space.
+ */
+static void
+ringbuf_copy_in(struct ringbuf *rb, uint32_t idx, const uint8_t *data,
+                uint32_t len)
+{
+    uint32_t off;
+    uint32_t contig;
+
+    off = idx & rb->rb_mask;
+    contig = rb->rb_mask + 1 - off;
+    if (contig > len) {
+        contig = len;
+    }
+    memcpy(rb->rb_buf + off, data, contig);
+    memcpy(rb->rb_buf, data + contig, len - contig);
+}
+
+static void
+ringbuf_copy_out(struct ringbuf *rb, uint32_t idx, uint8_t *data,
+                 uint32_t len)
+{
+    uint32_t off;
+    uint32_t contig;
+
+    off = idx & rb->rb_mask;
+    contig = rb->rb_mask + 1 - off;
+    if (contig > len) {
+        contig = len;
+    }
+    memcpy(data, rb->rb_buf + off, contig);
+    memcpy(data + contig, rb->rb_buf, len - contig);
+}
+
+int
+ringbuf_put(struct ringbuf *rb, const void *data, uint32_t len)
+{
+    uint32_t head;
+    uint32_t space;
+    os_sr_t sr;
+
+    if (rb->rb_flags & RINGBUF_F_MPSC) {
+        OS_ENTER_CRITICAL(sr);
+    }
+
+    head = rb->rb_head;
+    space = rb->rb_mask + 1 - (head - rb->rb_tail);
+    if (len > space) {
+        len = space;
+    }
+    ringbuf_copy_in(rb, head, data, len);
+    RINGBUF_BARRIER();
+    rb->rb_head = head + len;
+
+    if (rb->rb_flags & RINGBUF_F_MPSC) {
+        OS_EXIT_CRITICAL(sr);
+    }
+
+    if ((rb->rb_flags & RINGBUF_F_BLOCKING) && len > 0) {
+        os_sem_release(&rb->rb_sem);
+    }
+
+    return len;
+}
+
+int
+ringbuf_get(struct ringbuf *rb, void *data, uint32_t len)
+{
+    uint32_t tail;
+    uint32_t used;
+
+    tail = rb->rb_tail;
+    used = rb->rb_head - tail;
+    if (len > used) {
+        len = used;
+    }
+    ringbuf_copy_out(rb, tail, data, len);
+    RINGBUF_BARRIER();
+    rb->rb_tail = tail + len;
+
+    return len;
+}
+
+int
+ringbuf_get_wait(struct ringbuf *rb, void *data, uint32_t len,
+                 os_time_t timo)
+{
+    uint32_t off;
+    int rc;
+
+    assert(rb->rb_flags & RINGBUF_F_BLOCKING);
+
+    off = 0;
+    while (1) {
+        off += ringbuf_get(rb, (uint8_t *)data + off, len - off);
+        if (off == len) {
+            break;
+        }
+        /*
+         * The semaphore over-counts (one token per put, regardless of
+         * how much each pend consumed); surplus tokens just cause a
+         * re-check above.
+         */
+        rc = os_sem_pend(&rb->rb_sem, timo);
+        if (rc != OS_OK) {
+            break;
+        }
+    }
+
+    return off;
+}
+
+uint8_t *
+ringbuf_put_reserve(struct ringbuf *rb, uint32_t *len)
+{
+    uint32_t head;
+    uint32_t space;
+    uint32_t contig;
+
+    head = rb->rb_head;
+    space = rb->rb_mask + 1 - (head - rb->rb_tail);
+    contig = rb->rb_mask + 1 - (head & rb->rb_mask);
+    if (contig > space) {
+        contig = space;
+    }
+    *len = contig;
+
+    return rb->rb_buf + (head & rb->rb_mask);
+}
+
+void
+ringbuf_put_commit(struct ringbuf *rb, uint32_t len)
+{
+    RINGBUF_BARRIER();
+    rb->rb_head += len;
+    if ((rb->rb_flags & RINGBUF_F_BLOCKING) && len > 0) {
+        os_sem_release(&rb->rb_sem);
+    }
+}
+
+const uint8_t *
+ringbuf_get_reserve(struct ringbuf *rb, uint32_t *len)
+{
+    uint32_t tail;
+    uint32_t used;
+    uint32_t contig;
+
+    tail = rb->rb_tail;
+    used = rb->rb_head - tail;
+    contig = rb->rb_mask + 1 - (tail & rb->rb_mask);
+    if (contig > used) {
+        contig = used;
+    }
+    *len = contig;
+
+    return rb->rb_buf + (tail & rb->rb_mask);
+}
+
+void
+ringbuf_get_commit(struct ringbuf *rb, uint32_t len)
+{
+    RINGBUF_BARRIER();
+    rb->rb_tail += len;
+}